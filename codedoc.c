@@ -11,16 +11,29 @@
 
 #include <mxml.h>
 #include <stdbool.h>
+#include "jobs.h"
 #include "mmd.h"
 #include "zipc.h"
+#include "stats.h"
+#include "probes.h"
 #include <time.h>
+#include <fcntl.h>
 #include <sys/stat.h>
+#include <zlib.h>
+#ifdef HAVE_PTHREAD_H
+#  include <pthread.h>
+#endif /* HAVE_PTHREAD_H */
 #ifdef _WIN32
 #  define gmtime_r(t,tm) gmtime_s(tm,t)
 #  define localtime_r(t,tm) localtime_s(tm,t)
+#  include <direct.h>
+#  define mkdir(d,p) _mkdir(d)
+#  define realpath(p,r) _fullpath(r,p,0)
 #else
 #  include <dirent.h>
 #  include <unistd.h>
+#  include <sys/mman.h>
+#  include <sys/wait.h>
 #endif /* _WIN32 */
 
 
@@ -85,6 +98,136 @@ enum
 };
 
 
+/*
+ * Tree walk events...
+ */
+
+enum
+{
+  WALK_ENTER,				/* Entering a node, before its children */
+  WALK_EXIT				/* Leaving a node, after its children */
+};
+
+
+/*
+ * Batch manifest values...
+ */
+
+enum
+{
+  BATCH_AUTHOR,				/* Author */
+  BATCH_BODY,				/* Body file */
+  BATCH_COPYRIGHT,			/* Copyright */
+  BATCH_COVERIMAGE,			/* Cover image file */
+  BATCH_CSS,				/* CSS stylesheet file */
+  BATCH_CSS_OUT,			/* Directory for shared CSS stylesheet */
+  BATCH_DOCVERSION,			/* Documentation set version */
+  BATCH_FOOTER,				/* Footer file */
+  BATCH_HEADER,				/* Header file */
+  BATCH_LANGUAGE,			/* Language */
+  BATCH_NAME,				/* Name of manpage */
+  BATCH_OUTPUT,				/* Output file */
+  BATCH_SECTION,			/* Section/keywords of documentation */
+  BATCH_TITLE,				/* Title of documentation */
+  BATCH_MAX				/* Number of values */
+};
+
+static const char * const batch_keys[BATCH_MAX] =
+{					/* Manifest keys for values */
+  "author",
+  "body",
+  "copyright",
+  "coverimage",
+  "css",
+  "css-out",
+  "docversion",
+  "footer",
+  "header",
+  "language",
+  "name",
+  "output",
+  "section",
+  "title"
+};
+
+
+/*
+ * Command-line options that take an argument...
+ */
+
+static const char * const option_args[] =
+{					/* Options followed by a value */
+  "--assemble",
+  "--author",
+  "--batch",
+  "--body",
+  "--copyright",
+  "--coverimage",
+  "--css",
+  "--css-out",
+  "--docversion",
+  "--epub",
+  "--footer",
+  "--header",
+  "--jobs",
+  "--language",
+  "--lookup",
+  "--man",
+  "--max-memory",
+  "--section",
+  "--shard",
+  "--stdin-name",
+  "--store",
+  "--title"
+};
+
+
+/*
+ * Decompression of gzip-compressed inputs...
+ */
+
+#define GUNZIP_BUFFERS		4	/* Number of decompressed buffers */
+#define GUNZIP_SIZE		(64 * 1024)
+					/* Size of each decompressed buffer */
+
+#define FILEBUF_EGZCORRUPT	-1	/* Corrupt gzip data (not an `errno` value) */
+#define FILEBUF_EGZTRUNC	-2	/* Truncated gzip data (not an `errno` value) */
+
+
+/*
+ * Input prefetch limits...
+ */
+
+#define PREFETCH_MAX_BYTES	(64 * 1024 * 1024)
+					/* Maximum bytes read ahead of the scanner */
+#define PREFETCH_MAX_FILES	16	/* Maximum files read ahead of the scanner */
+
+
+/*
+ * Speculative scanning of large source files...
+ */
+
+#define SCAN_CHUNK_SIZE		(256 * 1024)
+					/* Target size of speculatively scanned chunks */
+#define SCAN_MAX_NAMESPACES	32	/* Maximum nested namespaces when splitting */
+
+enum
+{
+  SCAN_QUEUED,				/* Waiting for a scanning thread */
+  SCAN_RUNNING,				/* Being scanned */
+  SCAN_DONE,				/* Scanned */
+  SCAN_SKIPPED				/* Not needed by the serial scan */
+};
+
+
+/*
+ * Parallel loading of large XML documentation files...
+ */
+
+#define XMLDOC_CHUNK_SIZE	(1024 * 1024)
+					/* Target size of parallel-parsed chunks */
+
+
 /*
  * Special symbols...
  */
@@ -125,6 +268,24 @@ static const char * const reserved_words[] =	/* Reserved words */
 };
 
 
+/*
+ * Element and attribute names in codedoc.xsd, for loading XML files...
+ */
+
+static const char * const xmldoc_attrs[] =	/* Attribute names */
+{
+  "default", "direction", "name", "parent", "scope", "xmlns", "xmlns:xsi",
+  "xsi:schemaLocation"
+};
+
+static const char * const xmldoc_elements[] =	/* Element names */
+{
+  "argument", "class", "codedoc", "constant", "description", "enumeration",
+  "function", "namespace", "returnvalue", "seealso", "struct", "type",
+  "typedef", "union", "variable"
+};
+
+
 /*
  * Local types...
  */
@@ -132,12 +293,256 @@ static const char * const reserved_words[] =	/* Reserved words */
 typedef struct
 {
   const char	*filename;		/* Filename */
-  FILE		*fp;			/* File pointer */
+  char		*buffer;		/* File contents */
+  const char	*bufptr,		/* Pointer into contents */
+		*bufend;		/* End of contents */
   int		ch,			/* Saved character */
 		line,			/* Current line number */
 		column;			/* Current column */
+  bool		capture;		/* Capture @body@ comments instead of loading them? */
+  size_t	num_bodytext,		/* Number of captured @body@ comments */
+		alloc_bodytext;		/* Allocated @body@ comments */
+  char		**bodytext;		/* Captured @body@ comments */
+  mxml_node_t	*garbage;		/* Dump node for nodes we want to delete */
+  struct scan_split_s *split;		/* Speculatively scanned chunks or `NULL` */
+  bool		complete,		/* Did the scan end between declarations? */
+		order_dependent;	/* Did the scan depend on earlier declarations? */
 } filebuf_t;
 
+typedef struct
+{
+  const char	*start,			/* Start of chunk */
+		*end;			/* End of chunk */
+  int		line,			/* Line number at start of chunk */
+		depth;			/* Namespace/extern nesting at start of chunk */
+  char		*nsname;		/* Namespace name or `NULL` */
+  int		status;			/* Scan status (`SCAN_xxx`) */
+  bool		valid;			/* Can the serial scan use the results? */
+  filebuf_t	file;			/* File buffer for chunk */
+  mxml_node_t	*tree;			/* Declarations in chunk */
+  struct scan_split_s *split;		/* Speculatively scanned chunks */
+  jobs_task_t	*task;			/* Scanning task */
+} scan_chunk_t;
+
+typedef struct scan_split_s		/* Speculatively scanned chunks of a file */
+{
+#ifdef HAVE_PTHREAD_H
+  pthread_mutex_t mutex;		/* Mutex for chunk status */
+  pthread_cond_t cond;			/* Condition for chunk status changes */
+#endif /* HAVE_PTHREAD_H */
+  size_t	num_chunks,		/* Number of chunks */
+		alloc_chunks,		/* Allocated chunks */
+		current,		/* Next chunk for the serial scan */
+		num_grafted;		/* Number of chunks grafted */
+  const char	*next;			/* Start of next chunk for the serial scan */
+  scan_chunk_t	*chunks;		/* Chunks */
+} scan_split_t;
+
+typedef struct
+{
+  mxml_node_t	*tree;			/* Declaration tree */
+  const char	*nsname;		/* Namespace name */
+  bool		nsalloc;		/* Was the namespace name allocated? */
+  int		state,			/* Parser state */
+		braces,			/* Number of braces active */
+		parens,			/* Number of active parenthesis */
+		tree_is_scu,		/* Is the tree a struct, class, or union? */
+		nskeyword;		/* Namespace keyword seen? */
+  const char	*scope;			/* Variable/function scope */
+  mxml_node_t	*comment,		/* <comment> node */
+		*constant,		/* <constant> node */
+		*enumeration,		/* <enumeration> node */
+		*function,		/* <function> node */
+		*fstructclass,		/* function struct/class node */
+		*structclass,		/* <struct> or <class> node */
+		*typedefnode,		/* <typedef> node */
+		*variable,		/* <variable> or <argument> node */
+		*returnvalue,		/* <returnvalue> node */
+		*type,			/* <type> node */
+		*description,		/* <description> node */
+		*child;			/* First child node */
+} scan_scope_t;
+
+#define filebuf_byte(f)	((f)->bufptr < (f)->bufend ? *(f)->bufptr++ & 255 : EOF)
+					/* Get the next byte from a file buffer */
+
+typedef struct
+{
+#ifdef HAVE_PTHREAD_H
+  pthread_mutex_t mutex;		/* Mutex for buffers */
+  pthread_cond_t cond;			/* Condition for buffer changes */
+  pthread_t	thread;			/* Decompression thread */
+  bool		threaded;		/* Is the decompression thread running? */
+#endif /* HAVE_PTHREAD_H */
+  gzFile	gz;			/* Input file */
+  bool		cancel,			/* Stop decompressing? */
+		eof,			/* Has the end of the file been reached? */
+		error;			/* Did decompression fail? */
+  size_t	count,			/* Number of full buffers */
+		next_fill,		/* Next buffer for the thread */
+		next_read,		/* Next buffer for the parser */
+		offset,			/* Offset in next buffer for the parser */
+		lengths[GUNZIP_BUFFERS];/* Length of each buffer */
+  char		buffers[GUNZIP_BUFFERS][GUNZIP_SIZE];
+					/* Decompressed data */
+} gunzip_t;
+
+typedef struct
+{
+  const char	*filename;		/* Filename */
+  char		*buffer;		/* File contents */
+  size_t	length;			/* Length of contents */
+  int		error;			/* `errno` or `FILEBUF_EGZ` value from read or 0 */
+  bool		done;			/* Has the file been read? */
+} prefetch_file_t;
+
+typedef struct
+{
+#ifdef HAVE_PTHREAD_H
+  pthread_mutex_t mutex;		/* Mutex for queue */
+  pthread_cond_t cond;			/* Condition for queue changes */
+  pthread_t	thread;			/* Reader thread */
+#endif /* HAVE_PTHREAD_H */
+  bool		cancel;			/* Stop reading? */
+  size_t	num_files,		/* Number of files */
+		next_get,		/* Next file for the scanner */
+		bytes;			/* Bytes read but not yet scanned */
+  prefetch_file_t *files;		/* Files */
+} prefetch_t;
+
+typedef struct batch_target_s		/* Batch target */
+{
+  struct batch_target_s	*next;		/* Next target for the same inputs */
+  int			line,		/* Line number in manifest */
+			mode;		/* Output mode */
+  char			*values[BATCH_MAX];
+					/* Values */
+} batch_target_t;
+
+typedef struct batch_node_s		/* Batch input tree node */
+{
+  char			*filename;	/* Input file or `NULL` for the root */
+  struct batch_node_s	*parent,	/* Parent node */
+			*child,		/* First child node */
+			*last_child,	/* Last child node */
+			*next;		/* Next sibling node */
+  batch_target_t	*targets;	/* Targets whose last input is this node */
+  size_t		num_bodytext;	/* Number of @body@ comments */
+  char			**bodytext;	/* @body@ comments */
+} batch_node_t;
+
+typedef struct
+{
+  char		*filename,		/* Filename */
+		*buffer;		/* File contents */
+  size_t	length;			/* Length of contents */
+} batch_file_t;
+
+typedef struct
+{
+  bool		minify,			/* Minify HTML/XHTML output? */
+		progressive,		/* Defer HTML symbol details? */
+		rsyncable,		/* Use rsync-friendly compression? */
+		release;		/* Use maximum compression? */
+  batch_node_t	root;			/* Root of input tree */
+  size_t	num_files,		/* Number of cached files */
+		alloc_files;		/* Allocated cached files */
+  batch_file_t	*files;			/* Cached files, sorted by name */
+  size_t	num_pids,		/* Number of render processes */
+		alloc_pids;		/* Allocated render processes */
+  int		*pids;			/* Render processes */
+  bool		failed;			/* Did a target fail? */
+} batch_t;
+
+typedef struct
+{
+  char		*filename;		/* Filename */
+  time_t	mtime;			/* Modification time of file */
+  int		width,			/* Intrinsic width or 0 if unknown */
+		height;			/* Intrinsic height or 0 if unknown */
+} image_t;
+
+typedef struct
+{
+  size_t	num_images,		/* Number of images */
+		alloc_images;		/* Allocated images */
+  image_t	*images;		/* Images, sorted by filename */
+} images_t;
+
+typedef struct
+{
+  bool		links;			/* Link type names and mark reserved words? */
+  const char	*void_end;		/* End of void elements (">" or " />") */
+  void		(*write_block)(FILE *out, mmd_t *parent, int mode);
+					/* Write a markdown block */
+  void		(*write_string)(FILE *out, const char *s, const char *end);
+					/* Write a quoted string */
+} renderer_t;
+
+typedef struct
+{
+  char		*kind,			/* Kind of symbol */
+		*name,			/* Name of symbol */
+		*data;			/* Rendered HTML */
+  size_t	length,			/* Length of rendered HTML */
+		seq;			/* Load order */
+  bool		used;			/* Has the symbol been written? */
+} shard_entry_t;
+
+typedef struct
+{
+  size_t	num_entries,		/* Number of entries */
+		alloc_entries;		/* Allocated entries */
+  shard_entry_t	*entries;		/* Entries, sorted by kind, name, and load order */
+} shard_t;
+
+typedef struct spill_record_s
+{
+  struct spill_record_s *next;		/* Next record */
+  long		offset;			/* Offset of XML in spill file */
+  size_t	length;			/* Length of XML */
+} spill_record_t;
+
+typedef struct
+{
+  size_t	max_memory,		/* Maximum memory for symbols or 0 for no limit */
+		estimate,		/* Estimated memory at last check */
+		scanned;		/* Bytes scanned since last check */
+  FILE		*fp;			/* Spill file */
+  spill_record_t *records;		/* Records for spilled symbols */
+} spill_t;
+
+typedef struct
+{
+  const char	*name,			/* Name of symbol */
+		*kind;			/* Kind of symbol */
+  size_t	offset,			/* Offset of record in XML file */
+		length;			/* Length of record */
+} index_entry_t;
+
+typedef struct
+{
+  char		*name;			/* Version name */
+  unsigned long long manifest;		/* Hash of version manifest */
+} store_version_t;
+
+typedef struct
+{
+  const char	*dir;			/* Store directory */
+  size_t	num_versions,		/* Number of versions */
+		alloc_versions;		/* Allocated versions */
+  store_version_t *versions;		/* Versions, in release order */
+} store_t;
+
+typedef struct
+{
+  const char	*kind,			/* Kind of symbol */
+		*name;			/* Name of symbol */
+  size_t	version,		/* Index of version */
+		seq;			/* Load order */
+  unsigned long long hash;		/* Hash of symbol */
+} store_symbol_t;
+
 typedef struct
 {
   char	buffer[65536],			/* String buffer */
@@ -158,6 +563,48 @@ typedef struct
   toc_entry_t	*entries;		/* Entries */
 } toc_t;
 
+typedef struct
+{
+  mmd_t		*node;			/* Heading node */
+  char		*anchor,		/* Unique anchor */
+		*title;			/* Heading title */
+} anchor_t;
+
+typedef struct
+{
+  size_t	num_anchors,		/* Number of anchors */
+		num_buckets;		/* Number of hash buckets (power of 2) */
+  anchor_t	*names,			/* Anchors hashed by anchor */
+		*nodes,			/* Anchors hashed by heading node */
+		*titles;		/* First anchor for each title, hashed by title */
+} anchors_t;
+
+typedef struct types_s			/**** Names of linked types ****/
+{
+  mxml_node_t	*doc;			/* Documentation tree */
+  int		mode;			/* Output mode for public types */
+  size_t	num_all,		/* Number of types */
+		num_pub;		/* Number of public types */
+  const char	**all,			/* Sorted names of types */
+		**pub;			/* Sorted names of public types */
+} types_t;
+
+typedef struct
+{
+  const char	*start,			/* Start of chunk */
+		*end;			/* End of chunk */
+  mxml_node_t	*tree;			/* Elements in chunk */
+  bool		valid;			/* Was the chunk parsed? */
+  jobs_task_t	*task;			/* Parsing task */
+} xmldoc_chunk_t;
+
+typedef struct
+{
+  size_t	num_chunks,		/* Number of chunks */
+		alloc_chunks;		/* Allocated chunks */
+  xmldoc_chunk_t *chunks;		/* Chunks, in file order */
+} xmldoc_t;
+
 
 /*
  * Emulate safe string functions as needed...
@@ -197,64 +644,185 @@ static size_t codedoc_strlcpy(char *dst, const char *src, size_t dstsize)
  */
 
 static mxml_node_t	*Garbage;	/* Dump node for nodes we want to delete */
+static anchors_t	Anchors;	/* Anchors for markdown headings while rendering */
+static images_t		Images;		/* Intrinsic sizes of local images */
+static types_t		Types;		/* Names of linked types while rendering */
 
 
 /*
  * Local functions...
  */
 
+static void		add_body_text(filebuf_t *file, mmd_t **body, const char *text);
 static void		add_file_toc(toc_t *toc, const char *filename, mmd_t *file);
 static void		add_toc(toc_t *toc, int level, const char *anchor, const char *title);
-static mxml_node_t	*add_variable(mxml_node_t *parent, const char *name, mxml_node_t *type);
-static toc_t		*build_toc(mxml_node_t *doc, const char *bodyfile, mmd_t *body, const char *footerfile, int mode);
+static mxml_node_t	*add_variable(filebuf_t *file, mxml_node_t *parent, const char *name, mxml_node_t *type);
+static const char	*anchors_find(anchors_t *anchors, const char *title);
+static void		anchors_free(anchors_t *anchors);
+static const char	*anchors_get(anchors_t *anchors, mmd_t *heading);
+static void		anchors_load(anchors_t *anchors, mmd_t *doc);
+static mmd_t		*batch_body(mmd_t *body, batch_node_t *node);
+static batch_node_t	*batch_child(batch_node_t *parent, const char *filename);
+static void		batch_delete(batch_node_t *node);
+static const char	*batch_get_file(batch_t *batch, const char *filename, size_t *length);
+static bool		batch_load(batch_t *batch, const char *manifest, const char *defaults[]);
+static void		batch_render(batch_t *batch, batch_target_t *target, batch_node_t *node, mxml_node_t *codedoc);
+static bool		batch_run(const char *manifest, const char *defaults[], bool minify, bool progressive, bool rsyncable, bool release);
+static bool		batch_scan(batch_t *batch, batch_node_t *node, mxml_node_t *doc, mxml_node_t *codedoc);
+static void		batch_wait(batch_t *batch, bool all);
+static bool		batch_write(batch_t *batch, batch_target_t *target, batch_node_t *node, mxml_node_t *codedoc);
+static toc_t		*build_toc(mxml_node_t *doc, const char *bodyfile, mmd_t *body, const char *footerfile, mmd_t *footer, int mode);
 static void		clear_whitespace(mxml_node_t *node);
+static void		copy_node(mxml_node_t *parent, mxml_node_t *node);
+static void		filebuf_close(filebuf_t *file);
 static int		filebuf_getc(filebuf_t *file);
-static int		filebuf_open(filebuf_t *file, const char *filename);
+static int		filebuf_inflate(char **buffer, size_t *length);
+static int		filebuf_open(filebuf_t *file, const char *filename, prefetch_t *pf);
+static void		filebuf_open_buffer(filebuf_t *file, const char *filename, const char *buffer, size_t length);
+static int		filebuf_read(const char *filename, char **buffer, size_t *length);
+static int		filebuf_read_fp(FILE *fp, size_t alloc, char **buffer, size_t *length);
+static const char	*filebuf_strerror(int error);
 static void		filebuf_ungetc(filebuf_t *file, int ch);
 static mxml_node_t	*find_public(mxml_node_t *node, mxml_node_t *top, const char *element, const char *name, int mode);
 static void		free_toc(toc_t *toc);
 static char		*get_comment_info(mxml_node_t *description);
+static const char	*get_default(const char *value, mmd_t *body, const char *keyword, const char *defvalue);
 static char		*get_iso_date(time_t t);
 static mxml_node_t	*get_nth_child(mxml_node_t *node, int idx);
 static const char	*get_nth_text(mxml_node_t *node, int idx, bool *whitespace);
+static char		*get_relative_path(const char *from, const char *to, char *buffer, size_t bufsize);
 static char		*get_text(mxml_node_t *node, char *buffer, int buflen);
+static void		gunzip_close(gunzip_t *g);
+static bool		gunzip_error(gunzip_t *g);
+static gunzip_t		*gunzip_open(const char *filename);
+static size_t		gunzip_read(gunzip_t *g, char *buffer, size_t bytes);
+#ifdef HAVE_PTHREAD_H
+static void		*gunzip_thread(gunzip_t *g);
+#endif /* HAVE_PTHREAD_H */
+static size_t		gzip_write(gzFile gz, const void *buffer, size_t bytes);
 static void		highlight_c_string(FILE *fp, const char *s, int *histate);
 static void		highlight_css_string(FILE *fp, const char *s, int *histate);
 static void		highlight_htmlxml_string(FILE *fp, const char *s, int *histate);
 static void		highlight_string(FILE *fp, const char *start, const char *end, const char *class_name);
 static char		*html_gets(FILE *fp, char *fragment, size_t fragsize);
 static void		html_unescape(char *s);
+static bool		image_read(const char *filename, int *width, int *height);
+static bool		image_size(const char *filename, int *width, int *height);
+static int		index_compare(index_entry_t *a, index_entry_t *b);
+static bool		is_linked_type(mxml_node_t *doc, const char *name, bool pub, int mode);
 static bool		is_markdown(const char *filename);
 static bool		is_reserved(const char *word);
-static const char	*markdown_anchor(const char *text);
+static bool		is_xml(const char *filename);
+static mxml_node_t	*lookup_symbol(const char *xmlfile, mxml_node_t *doc, const char *name, mxml_node_t **codedoc);
+static char		*markdown_anchor(const char *text, char *buffer, size_t bufsize);
+static mmd_t		*markdown_load(mmd_t *root, const char *filename);
 static void		markdown_write_block(FILE *out, mmd_t *parent, int mode);
-static void		markdown_write_leaf(FILE *out, mmd_t *node, int mode);
+static void		markdown_write_block_html(FILE *out, mmd_t *parent, int mode);
+static void		markdown_write_block_man(FILE *out, mmd_t *parent, int mode);
+static void		markdown_write_leaf_html(FILE *out, mmd_t *node, int mode);
+static void		markdown_write_leaf_man(FILE *out, mmd_t *node, int mode);
+static size_t		minify_css(char *s);
+static void		minify_html(FILE *in, FILE *out);
 static mxml_node_t	*new_documentation(mxml_node_t **codedoc);
+static bool		prefetch_get(prefetch_t *pf, const char *filename, char **buffer, size_t *length, int *error);
+static prefetch_t	*prefetch_start(int num_args, char *args[]);
+static void		prefetch_stop(prefetch_t *pf);
+#ifdef HAVE_PTHREAD_H
+static void		*prefetch_thread(prefetch_t *pf);
+#endif /* HAVE_PTHREAD_H */
 static int		reserved_compare(const char **a, const char **b);
 static void		safe_strcpy(char *dst, const char *src);
+#ifdef HAVE_PTHREAD_H
+static void		scan_chunk_task(scan_chunk_t *chunk);
+#endif /* HAVE_PTHREAD_H */
 static int		scan_file(filebuf_t *file, mxml_node_t *doc, const char *nsname, mmd_t **body);
-static void		sort_node(mxml_node_t *tree, mxml_node_t *func);
+static void		scan_graft(filebuf_t *file, mxml_node_t *tree, const char *nsname, mmd_t **body, bool pending);
+static int		scan_source(filebuf_t *file, mxml_node_t *doc, mmd_t **body);
+static scan_split_t	*scan_split_start(filebuf_t *file);
+static void		scan_split_stop(scan_split_t *split);
+static bool		scan_stdin(mxml_node_t *doc, const char *name, mmd_t **body);
+static shard_entry_t	*shard_add(shard_t *shard, const char *kind, const char *name, size_t length);
+static int		shard_compare(shard_entry_t *a, shard_entry_t *b);
+static void		shard_free(shard_t *shard);
+static bool		shard_load(shard_t *shard, const char *filename);
+static void		sort_node(filebuf_t *file, mxml_node_t *tree, mxml_node_t *func);
+static bool		spill_check(spill_t *spill, mxml_node_t *codedoc, size_t bytes);
+static size_t		spill_estimate(mxml_node_t *node);
+static void		spill_free(spill_t *spill);
+static bool		spill_save(spill_t *spill, mxml_node_t *doc, mxml_node_t *codedoc, mxml_options_t *options, const char *xmlfile);
+static bool		spill_tree(spill_t *spill, mxml_node_t *codedoc);
+static FILE		*start_details(FILE *out, FILE *details);
+static bool		store_add(store_t *store, mxml_node_t *codedoc, const char *version);
+static void		store_close(store_t *store);
+static int		store_compare(store_symbol_t *a, store_symbol_t *b);
+static char		*store_get(store_t *store, const char *subdir, unsigned long long hash, size_t *length);
+static unsigned long long store_hash(unsigned long long hash, const void *data, size_t length);
+static mxml_node_t	*store_load(store_t *store, const char *version, mxml_node_t **codedoc);
+static bool		store_open(store_t *store, const char *dir, bool create);
+static bool		store_put(store_t *store, const char *subdir, unsigned long long hash, const char *data, size_t length, bool verify);
+static void		store_render(store_t *store, mxml_node_t *doc, bool progressive, shard_t *shard);
 static int		stringbuf_append(stringbuf_t *buffer, int ch);
 static void		stringbuf_clear(stringbuf_t *buffer);
 static char		*stringbuf_get(stringbuf_t *buffer);
 static int		stringbuf_getlast(stringbuf_t *buffer);
 static size_t		stringbuf_length(stringbuf_t *buffer);
 static mxml_type_t	type_cb(void *cbdata, mxml_node_t *node);
+static void		types_free(types_t *types);
+static void		types_load(types_t *types, mxml_node_t *doc, int mode);
 static void		update_comment(mxml_node_t *parent, mxml_node_t *comment);
 static void		usage(const char *option);
+static mxml_node_t	*walk_next(mxml_node_t *node, mxml_node_t *top, int *walk);
+static void		write_css(FILE *out, int mode, const char *cssfile);
+static void		write_css_file(const char *cssdir, const char *docdir, int mode, const char *cssfile, bool minify, char *href, size_t hrefsize);
 static void		write_description(FILE *out, int mode, mxml_node_t *description, const char *element, int summary);
+static void		write_details(FILE *out, FILE *details, const char *name);
 static void		write_element(FILE *out, mxml_node_t *doc, mxml_node_t *element, int mode);
-static void		write_epub(const char *epubfile, const char *section, const char *title, const char *author, const char *language, const char *copyright, const char *docversion, const char *cssfile, const char *coverimage, const char *headerfile, const char *bodyfile, mmd_t *body, mxml_node_t *doc, const char *footerfile);
+static void		write_enumeration(FILE *out, int mode, mxml_node_t *doc, mxml_node_t *scut, FILE *details);
+static void		write_epub(const char *epubfile, const char *section, const char *title, const char *author, const char *language, const char *copyright, const char *docversion, const char *cssfile, const char *coverimage, const char *headerfile, const char *bodyfile, mmd_t *body, mxml_node_t *doc, const char *footerfile, bool minify, bool rsyncable, bool release);
 static void		write_file(FILE *out, const char *file, int mode);
-static void		write_function(FILE *out, int mode, mxml_node_t *doc, mxml_node_t *function, int level);
-static void		write_html(const char *section, const char *title, const char *author, const char *language, const char *copyright, const char *docversion, const char *cssfile, const char *coverimage, const char *headerfile, const char *bodyfile, mmd_t *body, mxml_node_t *doc, const char *footerfile);
-static void		write_html_body(FILE *out, int mode, const char *bodyfile, mmd_t *body, mxml_node_t *doc);
-static void		write_html_head(FILE *out, int mode, const char *section, const char *title, const char *author, const char *language, const char *copyright, const char *docversion, const char *cssfile);
+static void		write_function(FILE *out, int mode, mxml_node_t *doc, mxml_node_t *function, int level, FILE *details);
+static void		write_html(const char *section, const char *title, const char *author, const char *language, const char *copyright, const char *docversion, const char *cssfile, const char *cssdir, const char *docdir, const char *coverimage, const char *headerfile, const char *bodyfile, mmd_t *body, mxml_node_t *doc, const char *footerfile, bool minify, bool progressive, shard_t *shard);
+static void		write_html_body(FILE *out, int mode, const char *bodyfile, mmd_t *body, mxml_node_t *doc, FILE *details, shard_t *shard);
+static void		write_html_head(FILE *out, int mode, const char *section, const char *title, const char *author, const char *language, const char *copyright, const char *docversion, const char *cssfile, const char *cssdir, const char *docdir, bool minify);
 static void		write_html_toc(FILE *out, const char *title, toc_t *toc, const char  *filename, const char  *target);
+static bool		write_index(const char *xmlfile, mxml_node_t *codedoc);
 static void		write_man(const char *man_name, const char *section, const char *title, const char *author, const char *copyright, const char *headerfile, const char *bodyfile, mmd_t *body, mxml_node_t *doc, const char *footerfile);
-static void		write_scu(FILE *out, int mode, mxml_node_t *doc, mxml_node_t *scut);
+static void		write_matrix(store_t *store, const char *section, const char *title, const char *author, const char *language, const char *copyright, const char *docversion, const char *cssfile, const char *cssdir, const char *docdir, bool minify);
+static void		write_scu(FILE *out, int mode, mxml_node_t *doc, mxml_node_t *scut, FILE *details);
+static void		write_shard(mxml_node_t *doc, int index, int count, bool progressive);
 static void		write_string(FILE *out, const char *s, int mode, int len);
+static void		write_string_html(FILE *out, const char *s, const char *end);
+static void		write_string_man(FILE *out, const char *s, const char *end);
+static void		write_symbol(FILE *out, int mode, mxml_node_t *doc, mxml_node_t *node, FILE *details, shard_t *shard);
+static void		write_typedef(FILE *out, int mode, mxml_node_t *doc, mxml_node_t *scut, FILE *details);
+static void		write_variable(FILE *out, int mode, mxml_node_t *doc, mxml_node_t *arg, FILE *details);
 static const char	*ws_cb(void *cbdata, mxml_node_t *node, mxml_ws_t where);
+static const char	*xmldoc_copy(const char *ptr, const char *end, char **bufptr);
+static mxml_node_t	*xmldoc_load(const char *filename);
+static const char	*xmldoc_name(const char *name, size_t namelen, const char * const *names, size_t num_names);
+static mxml_node_t	*xmldoc_parse(const char *ptr, const char *end, mxml_node_t *parent);
+static const char	*xmldoc_skip(const char *ptr, const char *end);
+static bool		xmldoc_split(xmldoc_t *xmldoc, const char *content, const char *close);
+static const char	*xmldoc_tag(const char *ptr, const char *end, mxml_node_t *parent, char *buffer, mxml_node_t **element);
+static void		xmldoc_task(xmldoc_chunk_t *chunk);
+
+
+/*
+ * Output format backends, indexed by output mode...
+ */
+
+static const renderer_t renderers[] =
+{
+  { false, NULL, NULL, NULL },		/* OUTPUT_NONE */
+  { true, ">", markdown_write_block_html, write_string_html },
+					/* OUTPUT_HTML */
+  { false, " />", markdown_write_block_html, write_string_html },
+					/* OUTPUT_XML */
+  { false, NULL, markdown_write_block_man, write_string_man },
+					/* OUTPUT_MAN */
+  { true, " />", markdown_write_block_html, write_string_html }
+					/* OUTPUT_EPUB */
+};
 
 
 /*
@@ -267,19 +835,24 @@ main(int  argc,				/* I - Number of command-line args */
 {
   int		ret = 1;		/* Exit status */
   int		i;			/* Looping var */
-  int		len;			/* Length of argument */
   filebuf_t	file;			/* File to read */
-  mxml_options_t *options = NULL;	/* Load/save options */
+  int		scanned;		/* Result of scanning file */
+  prefetch_t	*prefetch = NULL;	/* Source file prefetch */
+  bool		prefetched = false;	/* Started prefetching source files? */
+  mxml_options_t *options = NULL;	/* Save options */
   mxml_node_t	*doc = NULL;		/* XML documentation tree */
   mxml_node_t	*codedoc = NULL;	/* codedoc node */
   const char	*author = NULL,		/* Author */
+		*batchfile = NULL,	/* Batch manifest */
 		*language = NULL,	/* Language */
               	*copyright = NULL,	/* Copyright */
 		*cssfile = NULL,	/* CSS stylesheet file */
+		*cssdir = NULL,		/* Directory for shared CSS stylesheet */
 		*docversion = NULL,	/* Documentation set version */
                 *epubfile = NULL,	/* EPUB filename */
 		*footerfile = NULL,	/* Footer file */
 		*headerfile = NULL,	/* Header file */
+		*lookup = NULL,		/* Symbol to look up */
 		*bodyfile = NULL,	/* Body file */
                 *coverimage = NULL,	/* Cover image file */
 		*name = NULL,		/* Name of manpage */
@@ -289,6 +862,20 @@ main(int  argc,				/* I - Number of command-line args */
   mmd_t		*body = NULL;		/* Body markdown file, if any */
   int		mode = OUTPUT_HTML;	/* Output mode */
   bool		update = false;		/* Updated XML file */
+  bool		indexxml = false;	/* Write index for XML file? */
+  bool		minify = false;		/* Minify HTML/XHTML output? */
+  bool		progressive = false;	/* Defer HTML symbol details? */
+  bool		rsyncable = false;	/* Use rsync-friendly compression? */
+  bool		release = false;	/* Use maximum compression? */
+  int		shard_index = 0,	/* Shard to render (1-N) */
+		shard_count = 0;	/* Number of shards */
+  shard_t	shard;			/* Symbols from other shards */
+  char		shard_sep;		/* Separator in shard argument */
+  const char	*storedir = NULL;	/* Versioned documentation store */
+  store_t	store;			/* Store index */
+  bool		matrix = false;		/* Write since/removed matrix? */
+  spill_t	spill;			/* Symbols spilled to disk */
+  char		*units;			/* Units of memory limit */
 
 
  /*
@@ -297,6 +884,16 @@ main(int  argc,				/* I - Number of command-line args */
 
   Garbage = mxmlNewElement(/*parent*/NULL, "garbage");
 
+  memset(&shard, 0, sizeof(shard));
+  memset(&store, 0, sizeof(store));
+  memset(&spill, 0, sizeof(spill));
+
+ /*
+  * Get the default job limits, including any make jobserver...
+  */
+
+  jobsInit();
+
  /*
   * Check arguments...
   */
@@ -320,6 +917,19 @@ main(int  argc,				/* I - Number of command-line args */
       puts(VERSION);
       return (0);
     }
+    else if (!strcmp(argv[i], "--assemble"))
+    {
+     /*
+      * Load symbols rendered by a --shard run...
+      */
+
+      i ++;
+      if (i >= argc)
+        usage(NULL);
+
+      if (!shard_load(&shard, argv[i]))
+        goto done;
+    }
     else if (!strcmp(argv[i], "--author") && !author)
     {
      /*
@@ -332,6 +942,18 @@ main(int  argc,				/* I - Number of command-line args */
       else
         usage(NULL);
     }
+    else if (!strcmp(argv[i], "--batch") && !batchfile)
+    {
+     /*
+      * Set batch manifest...
+      */
+
+      i ++;
+      if (i < argc)
+        batchfile = argv[i];
+      else
+        usage(NULL);
+    }
     else if (!strcmp(argv[i], "--body") && !bodyfile)
     {
      /*
@@ -345,7 +967,14 @@ main(int  argc,				/* I - Number of command-line args */
         usage(NULL);
 
       if (is_markdown(bodyfile))
-        body = mmdLoad(body, bodyfile);
+      {
+        stats_phase_t phase = statsSetPhase(STATS_PHASE_LOAD);
+					/* Previous phase */
+
+        body = markdown_load(body, bodyfile);
+
+        statsSetPhase(phase);
+      }
     }
     else if (!strcmp(argv[i], "--copyright") && !copyright)
     {
@@ -383,6 +1012,18 @@ main(int  argc,				/* I - Number of command-line args */
       else
         usage(NULL);
     }
+    else if (!strcmp(argv[i], "--css-out") && !cssdir)
+    {
+     /*
+      * Set directory for shared CSS stylesheet...
+      */
+
+      i ++;
+      if (i < argc)
+        cssdir = argv[i];
+      else
+        usage(NULL);
+    }
     else if (!strcmp(argv[i], "--docversion") && !docversion)
     {
      /*
@@ -433,6 +1074,26 @@ main(int  argc,				/* I - Number of command-line args */
       else
         usage(NULL);
     }
+    else if (!strcmp(argv[i], "--index"))
+    {
+     /*
+      * Write a symbol index for the XML file...
+      */
+
+      indexxml = true;
+    }
+    else if (!strcmp(argv[i], "--jobs"))
+    {
+     /*
+      * Set maximum number of jobs...
+      */
+
+      i ++;
+      if (i < argc && atoi(argv[i]) > 0)
+        jobsSetMax(atoi(argv[i]));
+      else
+        usage(NULL);
+    }
     else if (!strcmp(argv[i], "--language") && !language)
     {
      /*
@@ -445,6 +1106,18 @@ main(int  argc,				/* I - Number of command-line args */
       else
         usage(NULL);
     }
+    else if (!strcmp(argv[i], "--lookup") && !lookup)
+    {
+     /*
+      * Show the documentation for a symbol...
+      */
+
+      i ++;
+      if (i < argc)
+        lookup = argv[i];
+      else
+        usage(NULL);
+    }
     else if (!strcmp(argv[i], "--man") && !name)
     {
      /*
@@ -460,10 +1133,69 @@ main(int  argc,				/* I - Number of command-line args */
       else
         usage(NULL);
     }
+    else if (!strcmp(argv[i], "--matrix"))
+    {
+     /*
+      * Write since/removed matrix for a store...
+      */
+
+      matrix = true;
+    }
+    else if (!strcmp(argv[i], "--max-memory"))
+    {
+     /*
+      * Set maximum memory for scanned symbols...
+      */
+
+      i ++;
+      if (i >= argc || (spill.max_memory = strtoul(argv[i], &units, 10)) == 0)
+        usage(NULL);
+
+      if (!strcasecmp(units, "k"))
+        spill.max_memory *= 1024;
+      else if (!strcasecmp(units, "m"))
+        spill.max_memory *= 1024 * 1024;
+      else if (!strcasecmp(units, "g"))
+        spill.max_memory *= 1024 * 1024 * 1024;
+      else if (*units)
+        usage(NULL);
+    }
+    else if (!strcmp(argv[i], "--minify"))
+    {
+     /*
+      * Minify HTML/XHTML output...
+      */
+
+      minify = true;
+    }
     else if (!strcmp(argv[i], "--no-output"))
     {
       mode = OUTPUT_NONE;
     }
+    else if (!strcmp(argv[i], "--progressive"))
+    {
+     /*
+      * Defer symbol details in HTML output...
+      */
+
+      progressive = true;
+    }
+    else if (!strcmp(argv[i], "--release"))
+    {
+     /*
+      * Use maximum compression for release builds...
+      */
+
+      release = true;
+    }
+    else if (!strcmp(argv[i], "--rsyncable"))
+    {
+     /*
+      * Use rsync-friendly compression...
+      */
+
+      rsyncable = true;
+    }
     else if (!strcmp(argv[i], "--section") && !section)
     {
      /*
@@ -476,52 +1208,105 @@ main(int  argc,				/* I - Number of command-line args */
       else
         usage(NULL);
     }
-    else if (!strcmp(argv[i], "--title") && !title)
+    else if (!strcmp(argv[i], "--shard") && !shard_count)
     {
      /*
-      * Set title...
+      * Render one shard of the symbols...
       */
 
       i ++;
-      if (i < argc)
-        title = argv[i];
-      else
+      if (i >= argc || sscanf(argv[i], "%d%c%d", &shard_index, &shard_sep, &shard_count) != 3 || shard_sep != '/' || shard_count < 1 || shard_index < 1 || shard_index > shard_count)
         usage(NULL);
     }
-    else if (argv[i][0] == '-')
+    else if (!strcmp(argv[i], "--stats"))
     {
      /*
-      * Unknown/bad option...
+      * Report timing and allocation statistics at exit...
       */
 
-      usage(argv[i]);
+      statsStart();
     }
-    else
+    else if (!strcmp(argv[i], "--stdin-name") || !strcmp(argv[i], "-"))
     {
      /*
-      * Process XML or source file...
+      * Scan source files from the standard input...
       */
 
-      len = (int)strlen(argv[i]);
-      if (len > 4 && !strcmp(argv[i] + len - 4, ".xml"))
-      {
-       /*
-        * Set XML file...
-	*/
+      const char *stdin_name = "-";	/* Name of source file */
+
+      if (argv[i][1])
+      {
+        i ++;
+        if (i < argc)
+          stdin_name = argv[i];
+        else
+          usage(NULL);
+      }
+
+      update = true;
+
+      statsSetPhase(STATS_PHASE_SCAN);
+
+      if (!doc)
+        doc = new_documentation(&codedoc);
+
+      if (!scan_stdin(codedoc, stdin_name, &body))
+        goto done;
+    }
+    else if (!strcmp(argv[i], "--store") && !storedir)
+    {
+     /*
+      * Set versioned documentation store...
+      */
+
+      i ++;
+      if (i < argc)
+        storedir = argv[i];
+      else
+        usage(NULL);
+    }
+    else if (!strcmp(argv[i], "--title") && !title)
+    {
+     /*
+      * Set title...
+      */
+
+      i ++;
+      if (i < argc)
+        title = argv[i];
+      else
+        usage(NULL);
+    }
+    else if (argv[i][0] == '-')
+    {
+     /*
+      * Unknown/bad option...
+      */
+
+      usage(argv[i]);
+    }
+    else
+    {
+     /*
+      * Process XML or source file...
+      */
+
+      if (is_xml(argv[i]))
+      {
+       /*
+        * Set XML file...
+	*/
 
         if (xmlfile)
 	  usage(NULL);
 
         xmlfile = argv[i];
 
-        if (!doc)
+        if (!doc && !lookup)
 	{
-	  if (!options)
-            options = mxmlOptionsNew();
+	  statsSetPhase(STATS_PHASE_LOAD);
 
-          mxmlOptionsSetTypeCallback(options, type_cb, /*cbdata*/NULL);
-
-          doc = mxmlLoadFilename(/*top*/NULL, options, argv[i]);
+          doc = xmldoc_load(argv[i]);
 
 	  if (!doc)
 	  {
@@ -550,32 +1335,158 @@ main(int  argc,				/* I - Number of command-line args */
 
         update = true;
 
+	statsSetPhase(STATS_PHASE_SCAN);
+
 	if (!doc)
 	  doc = new_documentation(&codedoc);
 
-        if (!filebuf_open(&file, argv[i]))
+        if (!prefetched)
         {
+         /*
+          * Start reading the following source files in the background...
+          */
+
+          prefetch   = prefetch_start(argc - i, argv + i);
+          prefetched = true;
+        }
+
+        if (!filebuf_open(&file, argv[i], prefetch))
           goto done;
-	}
-	else if (!scan_file(&file, codedoc, NULL, &body))
-	{
-	  fclose(file.fp);
-          goto done;
-	}
-	else
-	{
-	  fclose(file.fp);
-	}
+
+	CODEDOC_PROBE2(scan__start, file.filename, (size_t)(file.bufend - file.buffer));
+
+	scanned = scan_source(&file, codedoc, &body);
+
+	CODEDOC_PROBE3(scan__done, file.filename, (size_t)(file.bufend - file.buffer), scanned);
+
+	if (scanned && spill.max_memory && !spill_check(&spill, codedoc, (size_t)(file.bufend - file.buffer)))
+	  scanned = 0;
+
+	filebuf_close(&file);
+
+	if (!scanned)
+	  goto done;
       }
     }
   }
 
+  prefetch_stop(prefetch);
+  prefetch = NULL;
+
+  if ((shard_count || shard.num_entries) && (batchfile || mode != OUTPUT_HTML))
+  {
+    fputs("codedoc: The --assemble and --shard options can only be used for HTML output.\n", stderr);
+    goto done;
+  }
+  else if (shard_count && shard.num_entries)
+  {
+    fputs("codedoc: The --assemble and --shard options cannot be used together.\n", stderr);
+    goto done;
+  }
+
+  if (storedir && (batchfile || shard_count || shard.num_entries))
+  {
+    fputs("codedoc: The --store option cannot be used with --assemble, --batch, or --shard.\n", stderr);
+    goto done;
+  }
+  else if (matrix && (!storedir || mode != OUTPUT_HTML))
+  {
+    fputs("codedoc: The --matrix option requires --store and HTML output.\n", stderr);
+    goto done;
+  }
+
+  if (spill.max_memory && (mode != OUTPUT_NONE || !xmlfile || indexxml || storedir))
+  {
+    fputs("codedoc: The --max-memory option requires --no-output and an XML file, and cannot be used with --index or --store.\n", stderr);
+    goto done;
+  }
+
+  if ((indexxml || lookup) && !xmlfile)
+  {
+    fputs("codedoc: The --index and --lookup options require an XML file.\n", stderr);
+    goto done;
+  }
+  else if (indexxml && strrchr(xmlfile, '.') && !strcmp(strrchr(xmlfile, '.'), ".gz"))
+  {
+    fputs("codedoc: The --index option cannot be used with a compressed XML file.\n", stderr);
+    goto done;
+  }
+
+  if (lookup)
+  {
+   /*
+    * Show the man page for a single symbol, using the index when possible...
+    */
+
+    mxml_node_t *symdoc;		/* Documentation for symbol */
+
+    if (update || batchfile || shard_count || shard.num_entries || storedir || mode != OUTPUT_HTML)
+    {
+      fputs("codedoc: The --lookup option cannot be used with --assemble, --batch, --epub, --man, --no-output, --shard, --store, or source files.\n", stderr);
+      goto done;
+    }
+
+    if ((symdoc = lookup_symbol(xmlfile, doc, lookup, &codedoc)) == NULL)
+      goto done;
+
+    mxmlDelete(doc);
+
+    doc  = symdoc;
+    mode = OUTPUT_MAN;
+    name = lookup;
+  }
+
+  if (batchfile)
+  {
+   /*
+    * Generate the documentation listed in a batch manifest, using the other
+    * command-line options as defaults...
+    */
+
+    const char *defaults[BATCH_MAX];	/* Default values */
+
+    if (update || xmlfile || mode != OUTPUT_HTML)
+    {
+      fputs("codedoc: The --batch option cannot be used with --epub, --man, --no-output, or input files.\n", stderr);
+      goto done;
+    }
+
+    if (body)
+      mmdFree(body);
+
+    memset(defaults, 0, sizeof(defaults));
+
+    defaults[BATCH_AUTHOR]     = author;
+    defaults[BATCH_BODY]       = bodyfile;
+    defaults[BATCH_COPYRIGHT]  = copyright;
+    defaults[BATCH_COVERIMAGE] = coverimage;
+    defaults[BATCH_CSS]        = cssfile;
+    defaults[BATCH_CSS_OUT]    = cssdir;
+    defaults[BATCH_DOCVERSION] = docversion;
+    defaults[BATCH_FOOTER]     = footerfile;
+    defaults[BATCH_HEADER]     = headerfile;
+    defaults[BATCH_LANGUAGE]   = language;
+    defaults[BATCH_SECTION]    = section;
+    defaults[BATCH_TITLE]      = title;
+
+    if (batch_run(batchfile, defaults, minify, progressive, rsyncable, release))
+      ret = 0;
+
+    goto done;
+  }
+
   if (update && xmlfile)
   {
+    const char	*ext = strrchr(xmlfile, '.');
+					/* Extension of XML file */
+    gzFile	gz;			/* Compressed XML file */
+    bool	saved;			/* Was the XML file saved? */
+
    /*
     * Save the updated XML documentation file...
     */
 
+    statsSetPhase(STATS_PHASE_SAVE);
 
     if (!options)
       options = mxmlOptionsNew();
@@ -584,49 +1495,76 @@ main(int  argc,				/* I - Number of command-line args */
     mxmlOptionsSetWrapMargin(options, 0);
 
    /*
-    * Write over the existing XML file...
+    * Write over the existing XML file, compressing it if the filename ends
+    * with ".gz"...
     */
 
-    if (!mxmlSaveFilename(doc, options, xmlfile))
+    if (spill.records)
+    {
+      saved = spill_save(&spill, doc, codedoc, options, xmlfile);
+    }
+    else if (ext && !strcmp(ext, ".gz"))
+    {
+      if ((gz = gzopen(xmlfile, "wb")) != NULL)
+      {
+        saved = mxmlSaveIO(doc, options, (mxml_io_cb_t)gzip_write, gz);
+
+        if (gzclose(gz) != Z_OK)
+          saved = false;
+      }
+      else
+        saved = false;
+    }
+    else
+      saved = mxmlSaveFilename(doc, options, xmlfile);
+
+    if (!saved)
     {
       fprintf(stderr, "codedoc: Unable to write the XML documentation file \"%s\": %s\n", xmlfile, strerror(errno));
       goto done;
     }
   }
 
+  if (indexxml && !lookup && !write_index(xmlfile, codedoc))
+    goto done;
+
  /*
   * Collect the default metadata values, if present.
   */
 
-  if (!title)
-    title = mmdGetMetadata(body, "title");
-  if (!title)
-    title = "Documentation";
+  title      = get_default(title, body, "title", "Documentation");
+  author     = get_default(author, body, "author", "Unknown");
+  language   = get_default(language, body, "language", "en-US");
+  copyright  = get_default(copyright, body, "copyright", "Unknown");
+  docversion = get_default(docversion, body, "version", "0.0");
 
-  if (!author)
-    author = mmdGetMetadata(body, "author");
-  if (!author)
-    author = "Unknown";
-
-  if (!language)
-    language = mmdGetMetadata(body, "language");
-  if (!language)
-    language = "en-US";
+  if (storedir)
+  {
+   /*
+    * Add the documentation to the store as the current version, or load the
+    * current version from the store when there is no other input...
+    */
 
-  if (!copyright)
-    copyright = mmdGetMetadata(body, "copyright");
-  if (!copyright)
-    copyright = "Unknown";
+    if (!store_open(&store, storedir, doc != NULL))
+      goto done;
 
-  if (!docversion)
-    docversion = mmdGetMetadata(body, "version");
-  if (!docversion)
-    docversion = "0.0";
+    if (doc)
+    {
+      if (!store_add(&store, codedoc, docversion))
+        goto done;
+    }
+    else if (!matrix && (doc = store_load(&store, docversion, &codedoc)) == NULL)
+    {
+      goto done;
+    }
+  }
 
  /*
   * Write output...
   */
 
+  statsSetPhase(STATS_PHASE_RENDER);
+
   switch (mode)
   {
     case OUTPUT_EPUB :
@@ -634,7 +1572,7 @@ main(int  argc,				/* I - Number of command-line args */
         * Write EPUB (XHTML) documentation...
         */
 
-        write_epub(epubfile, section, title, author, language, copyright, docversion, cssfile, coverimage, headerfile, bodyfile, body, codedoc, footerfile);
+        write_epub(epubfile, section, title, author, language, copyright, docversion, cssfile, coverimage, headerfile, bodyfile, body, codedoc, footerfile, minify, rsyncable, release);
         break;
 
     case OUTPUT_HTML :
@@ -642,7 +1580,21 @@ main(int  argc,				/* I - Number of command-line args */
         * Write HTML documentation...
         */
 
-        write_html(section, title, author, language, copyright, docversion, cssfile, coverimage, headerfile, bodyfile, body, codedoc, footerfile);
+        if (matrix)
+        {
+          write_matrix(&store, section, title, author, language, copyright, docversion, cssfile, cssdir, ".", minify);
+        }
+        else if (shard_count)
+        {
+          write_shard(codedoc, shard_index, shard_count, progressive);
+        }
+        else
+        {
+          if (storedir)
+            store_render(&store, codedoc, progressive, &shard);
+
+          write_html(section, title, author, language, copyright, docversion, cssfile, cssdir, ".", coverimage, headerfile, bodyfile, body, codedoc, footerfile, minify, progressive, &shard);
+        }
         break;
 
     case OUTPUT_MAN :
@@ -665,6 +1617,10 @@ main(int  argc,				/* I - Number of command-line args */
 
   done:
 
+  prefetch_stop(prefetch);
+  shard_free(&shard);
+  spill_free(&spill);
+  store_close(&store);
   mxmlOptionsDelete(options);
   mxmlDelete(doc);
   mxmlDelete(Garbage);
@@ -673,6 +1629,49 @@ main(int  argc,				/* I - Number of command-line args */
 }
 
 
+/*
+ * 'add_body_text()' - Append @body@ comment text to the body.
+ *
+ * When the file buffer is capturing, the text is saved in the file buffer so
+ * it can be added to a body later.
+ */
+
+static void
+add_body_text(filebuf_t  *file,		/* I  - File buffer */
+              mmd_t      **body,	/* IO - Body markdown text */
+              const char *text)		/* I  - Comment text */
+{
+  if (file->capture)
+  {
+    if (file->num_bodytext >= file->alloc_bodytext)
+    {
+      char	**temp;			/* New array */
+
+      if ((temp = realloc(file->bodytext, (file->alloc_bodytext + 8) * sizeof(char *))) == NULL)
+      {
+        fputs("codedoc: Unable to allocate memory for body text.\n", stderr);
+        exit(1);
+      }
+
+      file->bodytext       = temp;
+      file->alloc_bodytext += 8;
+    }
+
+    if ((file->bodytext[file->num_bodytext] = strdup(text)) == NULL)
+    {
+      fputs("codedoc: Unable to allocate memory for body text.\n", stderr);
+      exit(1);
+    }
+
+    file->num_bodytext ++;
+  }
+  else
+  {
+    *body = mmdLoadString(*body, text);
+  }
+}
+
+
 /*
  * 'add_file_toc()' - Add TOC entries from a file.
  */
@@ -688,13 +1687,12 @@ add_file_toc(toc_t      *toc,		/* I - Table-of-contents */
   if (file)
   {
     mmd_t	*node,			/* Current node */
-		*tnode,			/* Title node */
-		*next;			/* Next node */
+		*tnode;			/* Title node */
     mmd_type_t	type;			/* Node type */
     char	title[1024],		/* Heading title */
 		*ptr;			/* Pointer into title */
 
-    for (node = mmdGetFirstChild(file); node; node = next)
+    for (node = mmdGetFirstChild(file); node; node = mmdGetNextSibling(node))
     {
       type = mmdGetType(node);
 
@@ -711,17 +1709,7 @@ add_file_toc(toc_t      *toc,		/* I - Table-of-contents */
           ptr += strlen(ptr);
         }
 
-        add_toc(toc, type - MMD_TYPE_HEADING_1 + 1, markdown_anchor(title), title);
-      }
-
-      if ((next = mmdGetNextSibling(node)) == NULL)
-      {
-        next = mmdGetParent(node);
-
-        while (next && mmdGetNextSibling(next) == NULL)
-          next = mmdGetParent(next);
-
-        next = mmdGetNextSibling(next);
+        add_toc(toc, type - MMD_TYPE_HEADING_1 + 1, anchors_get(&Anchors, node), title);
       }
     }
   }
@@ -873,7 +1861,8 @@ add_toc(toc_t      *toc,		/* I - Table-of-contents */
  */
 
 static mxml_node_t *			/* O - New variable/argument */
-add_variable(mxml_node_t *parent,	/* I - Parent node */
+add_variable(filebuf_t   *file,		/* I - File buffer */
+             mxml_node_t *parent,	/* I - Parent node */
              const char  *name,		/* I - "argument" or "variable" */
              mxml_node_t *type)		/* I - Type nodes */
 {
@@ -929,7 +1918,7 @@ add_variable(mxml_node_t *parent,	/* I - Parent node */
       strlcpy(bufptr, string, sizeof(buffer) - (size_t)(bufptr - buffer));
 
       next = mxmlGetNextSibling(node);
-      mxmlAdd(Garbage, MXML_ADD_AFTER, NULL, node);
+      mxmlAdd(file->garbage, MXML_ADD_AFTER, NULL, node);
       node = next;
     }
 
@@ -965,7 +1954,7 @@ add_variable(mxml_node_t *parent,	/* I - Parent node */
       strlcpy(bufptr, string, sizeof(buffer) - (size_t)(bufptr - buffer));
 
       next = mxmlGetNextSibling(node);
-      mxmlAdd(Garbage, MXML_ADD_AFTER, NULL, node);
+      mxmlAdd(file->garbage, MXML_ADD_AFTER, NULL, node);
       node = next;
     }
   }
@@ -976,7 +1965,7 @@ add_variable(mxml_node_t *parent,	/* I - Parent node */
     */
 
     strlcpy(buffer, string, sizeof(buffer));
-    mxmlAdd(Garbage, MXML_ADD_AFTER, NULL, mxmlGetLastChild(type));
+    mxmlAdd(file->garbage, MXML_ADD_AFTER, NULL, mxmlGetLastChild(type));
   }
 
  /*
@@ -1000,6097 +1989,9826 @@ add_variable(mxml_node_t *parent,	/* I - Parent node */
 
 
 /*
- * 'build_toc()' - Build a table-of-contents...
+ * 'anchors_find()' - Find the anchor for a heading title.
+ *
+ * This is used for "@" links, which go to the first heading with the given
+ * title.
  */
 
-static toc_t *				/* O - Table of contents */
-build_toc(mxml_node_t *doc,		/* I - Documentation */
-          const char  *bodyfile,	/* I - Body file */
-          mmd_t       *body,		/* I - Markdown body */
-          const char  *footerfile,	/* I - Footer file */
-          int         mode)             /* I - Output mode */
+static const char *			/* O - HTML anchor or `NULL` if not found */
+anchors_find(anchors_t  *anchors,	/* I - Anchors */
+             const char *title)		/* I - Heading title */
 {
-  toc_t		*toc;			/* Array of headings */
-  mxml_node_t	*function,		/* Current function */
-		*scut,			/* Struct/class/union/typedef */
-		*arg;			/* Current argument */
-  const char	*name;			/* Name of function/type */
+  size_t	mask,			/* Hash mask */
+		bucket;			/* Current bucket */
 
 
- /*
-  * Make a new table-of-contents...
-  */
-
-  if ((toc = calloc(1, sizeof(toc_t))) == NULL)
+  if (!anchors->num_buckets || !title)
     return (NULL);
 
- /*
-  * Scan the body file for headings...
-  */
+  mask = anchors->num_buckets - 1;
 
-  add_file_toc(toc, bodyfile, body);
+  for (bucket = store_hash(0xcbf29ce484222325ULL, title, strlen(title)) & mask; anchors->titles[bucket].title; bucket = (bucket + 1) & mask)
+  {
+    if (!strcmp(anchors->titles[bucket].title, title))
+      return (anchors->titles[bucket].anchor);
+  }
 
- /*
-  * Next the classes...
-  */
+  return (NULL);
+}
 
-  if ((scut = find_public(doc, doc, "class", NULL, mode)) != NULL)
-  {
-    add_toc(toc, 1, "CLASSES", "Classes");
 
-    while (scut)
-    {
-      name = mxmlElementGetAttr(scut, "name");
-      scut = find_public(scut, doc, "class", NULL, mode);
-      add_toc(toc, 2, name, name);
-    }
+/*
+ * 'anchors_free()' - Free the anchors for markdown headings.
+ */
+
+static void
+anchors_free(anchors_t *anchors)	/* I - Anchors */
+{
+  size_t	i;			/* Looping var */
+
+
+  for (i = 0; i < anchors->num_buckets; i ++)
+  {
+    free(anchors->names[i].anchor);
+    free(anchors->names[i].title);
   }
 
+  free(anchors->names);
+  free(anchors->nodes);
+  free(anchors->titles);
+
+  memset(anchors, 0, sizeof(anchors_t));
+}
+
+
+/*
+ * 'anchors_get()' - Get the unique anchor for a markdown heading.
+ *
+ * The anchor is generated from the heading text the first time a heading is
+ * seen.  Headings with the same text get "-2", "-3", etc. appended so that
+ * every anchor in the document is unique.
+ */
+
+static const char *			/* O - HTML anchor */
+anchors_get(anchors_t *anchors,		/* I - Anchors */
+            mmd_t     *heading)		/* I - Heading node */
+{
+  size_t	i,			/* Looping var */
+		mask,			/* Hash mask */
+		bucket;			/* Current bucket */
+  anchor_t	*names,			/* New anchors hashed by anchor */
+		*nodes,			/* New anchors hashed by heading node */
+		*titles;		/* New anchors hashed by title */
+  mmd_t		*node;			/* Current text node */
+  const char	*text;			/* Text of current node */
+  char		anchor[1024],		/* Anchor string */
+		*ptr,			/* Pointer into anchor */
+		title[1024],		/* Title string */
+		*tptr;			/* Pointer into title */
+  size_t	length;			/* Length of base anchor */
+  int		count;			/* Duplicate count */
+
+
  /*
-  * Functions...
+  * See if we already have an anchor for this heading...
   */
 
-  if ((function = find_public(doc, doc, "function", NULL, mode)) != NULL)
+  if (anchors->num_buckets > 0)
   {
-    add_toc(toc, 1, "FUNCTIONS", "Functions");
+    mask = anchors->num_buckets - 1;
 
-    while (function)
+    for (bucket = store_hash(0xcbf29ce484222325ULL, &heading, sizeof(heading)) & mask; anchors->nodes[bucket].node; bucket = (bucket + 1) & mask)
     {
-      name     = mxmlElementGetAttr(function, "name");
-      function = find_public(function, doc, "function", NULL, mode);
-      add_toc(toc, 2, name, name);
+      if (anchors->nodes[bucket].node == heading)
+        return (anchors->nodes[bucket].anchor);
     }
   }
 
  /*
-  * Data types...
+  * No, grow the hash tables as needed...
   */
 
-  if ((scut = find_public(doc, doc, "typedef", NULL, mode)) != NULL)
+  if ((anchors->num_anchors + 1) * 2 > anchors->num_buckets)
   {
-    add_toc(toc, 1, "TYPES", "Data Types");
+    size_t num_buckets = anchors->num_buckets ? 2 * anchors->num_buckets : 64;
+					/* New number of buckets */
 
-    while (scut)
+    if ((names = calloc(num_buckets, sizeof(anchor_t))) == NULL || (nodes = calloc(num_buckets, sizeof(anchor_t))) == NULL || (titles = calloc(num_buckets, sizeof(anchor_t))) == NULL)
     {
-      name = mxmlElementGetAttr(scut, "name");
-      scut = find_public(scut, doc, "typedef", NULL, mode);
-      add_toc(toc, 2, name, name);
+      fputs("codedoc: Unable to allocate memory for heading anchors.\n", stderr);
+      exit(1);
     }
-  }
 
- /*
-  * Structures...
-  */
+    for (i = 0, mask = num_buckets - 1; i < anchors->num_buckets; i ++)
+    {
+      if (anchors->names[i].anchor)
+      {
+        for (bucket = store_hash(0xcbf29ce484222325ULL, anchors->names[i].anchor, strlen(anchors->names[i].anchor)) & mask; names[bucket].anchor; bucket = (bucket + 1) & mask);
 
-  if ((scut = find_public(doc, doc, "struct", NULL, mode)) != NULL)
-  {
-    add_toc(toc, 1, "STRUCTURES", "Structures");
+        names[bucket] = anchors->names[i];
+      }
 
-    while (scut)
-    {
-      name = mxmlElementGetAttr(scut, "name");
-      scut = find_public(scut, doc, "struct", NULL, mode);
-      add_toc(toc, 2, name, name);
+      if (anchors->nodes[i].node)
+      {
+        for (bucket = store_hash(0xcbf29ce484222325ULL, &anchors->nodes[i].node, sizeof(mmd_t *)) & mask; nodes[bucket].node; bucket = (bucket + 1) & mask);
+
+        nodes[bucket] = anchors->nodes[i];
+      }
+
+      if (anchors->titles[i].title)
+      {
+        for (bucket = store_hash(0xcbf29ce484222325ULL, anchors->titles[i].title, strlen(anchors->titles[i].title)) & mask; titles[bucket].title; bucket = (bucket + 1) & mask);
+
+        titles[bucket] = anchors->titles[i];
+      }
     }
+
+    free(anchors->names);
+    free(anchors->nodes);
+    free(anchors->titles);
+
+    anchors->names       = names;
+    anchors->nodes       = nodes;
+    anchors->titles      = titles;
+    anchors->num_buckets = num_buckets;
   }
 
  /*
-  * Unions...
+  * Build the anchor and title from the heading text...
   */
 
-  if ((scut = find_public(doc, doc, "union", NULL, mode)) != NULL)
+  for (node = mmdGetFirstChild(heading), ptr = anchor; node && ptr < (anchor + sizeof(anchor) - 1); node = mmdGetNextSibling(node))
   {
-    add_toc(toc, 1, "UNIONS", "Unions");
+    if (mmdGetWhitespace(node))
+      *ptr++ = '-';
 
-    while (scut)
-    {
-      name = mxmlElementGetAttr(scut, "name");
-      scut = find_public(scut, doc, "union", NULL, mode);
-      add_toc(toc, 2, name, name);
-    }
+    markdown_anchor(mmdGetText(node), ptr, sizeof(anchor) - (size_t)(ptr - anchor));
+    ptr += strlen(ptr);
   }
 
- /*
-  * Globals variables...
-  */
+  *ptr   = '\0';
+  length = (size_t)(ptr - anchor);
 
-  if ((arg = find_public(doc, doc, "variable", NULL, mode)) != NULL)
+  for (node = mmdGetFirstChild(heading), tptr = title; node && tptr < (title + sizeof(title) - 1); node = mmdGetNextSibling(node))
   {
-    add_toc(toc, 1, "VARIABLES", "Variables");
+    if (mmdGetWhitespace(node) && tptr > title)
+      *tptr++ = ' ';
 
-    while (arg)
+    if ((text = mmdGetText(node)) != NULL)
     {
-      name = mxmlElementGetAttr(arg, "name");
-      arg = find_public(arg, doc, "variable", NULL, mode);
-      add_toc(toc, 2, name, name);
+      strlcpy(tptr, text, sizeof(title) - (size_t)(tptr - title));
+      tptr += strlen(tptr);
     }
   }
 
+  *tptr = '\0';
+
  /*
-  * Enumerations/constants...
+  * Then make it unique...
   */
 
-  if ((scut = find_public(doc, doc, "enumeration", NULL, mode)) != NULL)
+  mask = anchors->num_buckets - 1;
+
+  for (count = 1;; count ++)
   {
-    add_toc(toc, 1, "ENUMERATIONS", "Enumerations");
+    if (count > 1)
+    {
+      if (length > sizeof(anchor) - 12)
+        length = sizeof(anchor) - 12;
 
-    while (scut)
+      snprintf(anchor + length, sizeof(anchor) - length, "-%d", count);
+    }
+
+    for (bucket = store_hash(0xcbf29ce484222325ULL, anchor, strlen(anchor)) & mask; anchors->names[bucket].anchor; bucket = (bucket + 1) & mask)
     {
-      name = mxmlElementGetAttr(scut, "name");
-      scut = find_public(scut, doc, "enumeration", NULL, mode);
-      add_toc(toc, 2, name, name);
+      if (!strcmp(anchors->names[bucket].anchor, anchor))
+        break;
     }
+
+    if (!anchors->names[bucket].anchor)
+      break;
+  }
+
+  if ((anchors->names[bucket].anchor = strdup(anchor)) == NULL || (anchors->names[bucket].title = strdup(title)) == NULL)
+  {
+    fputs("codedoc: Unable to allocate memory for heading anchors.\n", stderr);
+    exit(1);
   }
 
+  anchors->names[bucket].node = heading;
+
+  for (i = store_hash(0xcbf29ce484222325ULL, &heading, sizeof(heading)) & mask; anchors->nodes[i].node; i = (i + 1) & mask);
+
+  anchors->nodes[i] = anchors->names[bucket];
+  anchors->num_anchors ++;
+
  /*
-  * Scan the footer file for headings...
+  * "@" links go to the first heading with a given title...
   */
 
-  if (footerfile)
+  if (!anchors_find(anchors, title))
   {
-    mmd_t *mmd = NULL;
+    for (i = store_hash(0xcbf29ce484222325ULL, title, strlen(title)) & mask; anchors->titles[i].title; i = (i + 1) & mask);
 
-    if (is_markdown(footerfile))
-      mmd = mmdLoad(NULL, footerfile);
-
-    add_file_toc(toc, footerfile, mmd);
-
-    mmdFree(mmd);
+    anchors->titles[i] = anchors->names[bucket];
   }
 
-  return (toc);
+  return (anchors->names[bucket].anchor);
 }
 
 
 /*
- * 'clear_whitespace()' - Clear the whitespace value of a text node.
+ * 'anchors_load()' - Generate the anchors for the headings in a markdown
+ *                    document.
+ *
+ * Anchors are generated in document order, so the first heading with a given
+ * title gets the plain anchor and is the target of "@" links to that title.
  */
 
 static void
-clear_whitespace(mxml_node_t *node)	/* I - Node */
+anchors_load(anchors_t *anchors,	/* I - Anchors */
+             mmd_t     *doc)		/* I - Markdown document or `NULL` */
 {
-  mxmlSetText(node, false, mxmlGetText(node, NULL));
+  mmd_t		*node;			/* Current node */
+  mmd_walk_t	walk;			/* Walk event for current node */
+  mmd_type_t	type;			/* Node type */
+
+
+  for (node = doc, walk = MMD_WALK_ENTER; node; node = mmdWalkNext(node, doc, &walk))
+  {
+    type = mmdGetType(node);
+
+    if (walk == MMD_WALK_ENTER && type >= MMD_TYPE_HEADING_1 && type <= MMD_TYPE_HEADING_6)
+    {
+      anchors_get(anchors, node);
+      walk = MMD_WALK_EXIT;
+    }
+  }
 }
 
 
 /*
- * 'epub_ws_cb()' - Whitespace callback for EPUB.
+ * 'batch_body()' - Add the @body@ comments from the inputs leading to a batch
+ *                  input tree node.
  */
 
-static const char *			/* O - Whitespace string or NULL for none */
-epub_ws_cb(void        *cbdata,		/* I - Callback data (not used) */
-           mxml_node_t *node,		/* I - Element node */
-           mxml_ws_t   where)		/* I - Where value */
+static mmd_t *				/* O - Body markdown */
+batch_body(mmd_t        *body,		/* I - Body markdown */
+           batch_node_t *node)		/* I - Input tree node */
 {
-  mxml_node_t	*temp;			/* Temporary node pointer */
-  int		depth;			/* Depth of node */
-  static const char *spaces = "                                        ";
-					/* Whitespace (40 spaces) for indent */
+  size_t	i;			/* Looping var */
 
-  (void)cbdata;
 
-  switch (where)
-  {
-    case MXML_WS_BEFORE_CLOSE :
-        if ((temp = mxmlGetFirstChild(node)) != NULL && mxmlGetType(temp) != MXML_TYPE_ELEMENT)
-          return (NULL);
+  if (node->parent)
+    body = batch_body(body, node->parent);
 
-	for (depth = -4; node; node = mxmlGetParent(node), depth += 2)
-	  ;				// Count the depth
+  for (i = 0; i < node->num_bodytext; i ++)
+    body = mmdLoadString(body, node->bodytext[i]);
 
-	if (depth > 40)
-	  return (spaces);
-	else if (depth < 2)
-	  return (NULL);
-	else
-	  return (spaces + 40 - depth);
+  return (body);
+}
 
-    case MXML_WS_AFTER_CLOSE :
-	return ("\n");
 
-    case MXML_WS_BEFORE_OPEN :
-	for (depth = -4; node; node = mxmlGetParent(node), depth += 2)
-	  ;				// Count the depth
+/*
+ * 'batch_child()' - Find or add a child node in the batch input tree.
+ */
 
-	if (depth > 40)
-	  return (spaces);
-	else if (depth < 2)
-	  return (NULL);
-	else
-	  return (spaces + 40 - depth);
+static batch_node_t *			/* O - Child node or `NULL` on error */
+batch_child(batch_node_t *parent,	/* I - Parent node */
+            const char   *filename)	/* I - Input file */
+{
+  batch_node_t	*child;			/* Child node */
 
-    default :
-    case MXML_WS_AFTER_OPEN :
-        if ((temp = mxmlGetFirstChild(node)) != NULL && mxmlGetType(temp) != MXML_TYPE_ELEMENT)
-          return (NULL);
 
-        return ("\n");
+  for (child = parent->child; child; child = child->next)
+  {
+    if (!strcmp(child->filename, filename))
+      return (child);
+  }
+
+  if ((child = calloc(1, sizeof(batch_node_t))) == NULL)
+    return (NULL);
+
+  if ((child->filename = strdup(filename)) == NULL)
+  {
+    free(child);
+    return (NULL);
   }
+
+  child->parent = parent;
+
+  if (parent->last_child)
+    parent->last_child->next = child;
+  else
+    parent->child = child;
+
+  parent->last_child = child;
+
+  return (child);
 }
 
 
 /*
- * 'filebuf_getc()' - Get a UTF-8 character from a file, tracking the line and
- *                    column.
+ * 'batch_delete()' - Free the children and targets of a batch input tree node.
  */
 
-static int				/* O - Character or EOF */
-filebuf_getc(filebuf_t *file)		/* I - File buffer */
+static void
+batch_delete(batch_node_t *node)	/* I - Node */
 {
-  int	ch;				/* Current character */
+  size_t		i;		/* Looping var */
+  batch_node_t		*child,		/* Current child */
+			*next_child;	/* Next child */
+  batch_target_t	*target,	/* Current target */
+			*next_target;	/* Next target */
 
 
-  if (file->ch)
+  for (child = node->child; child; child = next_child)
   {
-    if (file->ch > 0x100)
-    {
-      ch       = (file->ch >> 8) & 255;
-      file->ch = file->ch & 255;
-    }
-    else
-    {
-      ch       = file->ch;
-      file->ch = 0;
-    }
+    next_child = child->next;
 
-    return (ch);
+    batch_delete(child);
+    free(child->filename);
+    free(child);
   }
 
-  if ((ch = getc(file->fp)) == EOF)
-    return (EOF);
-
-  if (ch & 0x80)
+  for (target = node->targets; target; target = next_target)
   {
-    if ((ch & 0xe0) == 0xc0)
-    {
-      int ch2 = getc(file->fp);
+    next_target = target->next;
 
-      if ((ch2 & 0xc0) != 0x80)
-        goto bad_utf8;
+    for (i = 0; i < BATCH_MAX; i ++)
+      free(target->values[i]);
 
-      ch = ((ch & 0x1f) << 6) | (ch2 & 0x3f);
-    }
-    else if ((ch & 0xf0) == 0xe0)
-    {
-      int ch2 = getc(file->fp);
-      int ch3 = getc(file->fp);
+    free(target);
+  }
 
-      if ((ch2 & 0xc0) != 0x80 || (ch3 & 0xc0) != 0x80)
-        goto bad_utf8;
+  for (i = 0; i < node->num_bodytext; i ++)
+    free(node->bodytext[i]);
 
-      ch = ((ch & 0x0f) << 12) | ((ch2 & 0x3f) << 6) | (ch3 & 0x3f);
-    }
-    else if ((ch & 0xf8) == 0xf0)
-    {
-      int ch2 = getc(file->fp);
-      int ch3 = getc(file->fp);
-      int ch4 = getc(file->fp);
+  free(node->bodytext);
 
-      if ((ch2 & 0xc0) != 0x80 || (ch3 & 0xc0) != 0x80 || (ch4 & 0xc0) != 0x80)
-        goto bad_utf8;
+  node->child        = NULL;
+  node->last_child   = NULL;
+  node->targets      = NULL;
+  node->num_bodytext = 0;
+  node->bodytext     = NULL;
+}
 
-      ch = ((ch & 0x07) << 18) | ((ch2 & 0x3f) << 12) | ((ch3 & 0x3f) << 6) | (ch4 & 0x3f);
-    }
-    else
-      goto bad_utf8;
-  }
 
-  if (ch == 0x7f || ch < 0x07 || ch == 0x08 || (ch > 0x0d && ch < ' '))
-  {
-    fprintf(stderr, "%s:%d(%d) Illegal control character found.\n", file->filename, file->line, file->column);
-    exit(1);
-  }
+/*
+ * 'batch_get_file()' - Get the contents of an input file, reading it once.
+ */
 
-  if (ch == 0x09)
-  {
-   /*
-    * Tab...  Traditional tabs are 8 columns...
-    */
+static const char *			/* O - File contents or `NULL` on error */
+batch_get_file(batch_t    *batch,	/* I - Batch */
+               const char *filename,	/* I - Filename */
+               size_t     *length)	/* O - Length of contents */
+{
+  size_t	left,			/* Left side of search */
+		right,			/* Right side of search */
+		current;		/* Current entry */
+  int		result;			/* Result of comparison */
+  batch_file_t	*bfile;			/* Cached file */
+  int		error;			/* `errno` value */
 
-    file->column = ((file->column + 7) & ~7) + 1;
-  }
-  else if (ch == 0x0a || ch == 0x0c)
-  {
-   /*
-    * Line feed and form feed...
-    */
 
-    file->line ++;
-    file->column = 1;
-  }
-  else if (ch == 0x0b)
+ /*
+  * Look for the file in the (sorted) cache...
+  */
+
+  for (left = 0, right = batch->num_files; left < right;)
   {
-   /*
-    * Vertical tab...
-    */
+    current = (left + right) / 2;
 
-    file->line ++;
+    if ((result = strcmp(filename, batch->files[current].filename)) == 0)
+    {
+      *length = batch->files[current].length;
+      return (batch->files[current].buffer);
+    }
+    else if (result < 0)
+      right = current;
+    else
+      left = current + 1;
   }
-  else if (ch == 0x0d)
+
+ /*
+  * Not cached, read it and insert it at the right place...
+  */
+
+  if (batch->num_files >= batch->alloc_files)
   {
-   /*
-    * Carriage return...
-    */
+    if ((bfile = realloc(batch->files, (batch->alloc_files + 64) * sizeof(batch_file_t))) == NULL)
+    {
+      fputs("codedoc: Unable to allocate memory for input files.\n", stderr);
+      return (NULL);
+    }
 
-    file->column = 1;
+    batch->files       = bfile;
+    batch->alloc_files += 64;
   }
-  else
-    file->column ++;
 
-  return (ch);
+  bfile = batch->files + left;
 
- /*
-  * If we get here, the UTF-8 sequence is bad...
-  */
+  if (left < batch->num_files)
+    memmove(bfile + 1, bfile, (batch->num_files - left) * sizeof(batch_file_t));
 
-  bad_utf8:
+  if ((error = filebuf_read(filename, &bfile->buffer, &bfile->length)) != 0 || (bfile->filename = strdup(filename)) == NULL)
+  {
+    fprintf(stderr, "%s: %s\n", filename, filebuf_strerror(error ? error : errno));
 
-  fprintf(stderr, "%s:%d(%d) Illegal UTF-8 sequence found.\n", file->filename, file->line, file->column);
-  exit(1);
-}
+    free(bfile->buffer);
 
+    if (left < batch->num_files)
+      memmove(bfile, bfile + 1, (batch->num_files - left) * sizeof(batch_file_t));
 
-/*
- * 'filebuf_open()' - Open a file.
- */
+    return (NULL);
+  }
 
-static int				/* O - 1 on success, 0 on failure */
-filebuf_open(filebuf_t  *file,		/* I - File buffer */
-             const char *filename)	/* I - Filename to open */
-{
-  file->filename = filename;
-  file->fp       = fopen(filename, "rb");
-  file->ch       = 0;
-  file->line     = 1;
-  file->column   = 1;
+  batch->num_files ++;
 
-  if (!file->fp)
-    perror(filename);
+  *length = bfile->length;
 
-  return (file->fp != NULL);
+  return (bfile->buffer);
 }
 
 
 /*
- * 'filebuf_ungetc()' - Save the previous character read from a file.
+ * 'batch_load()' - Load a batch manifest.
+ *
+ * A manifest is a series of targets separated by blank lines.  Each line of a
+ * target is a "key: value" pair - "inputs" lists source files separated by
+ * whitespace and may be repeated, "format" is "epub", "html", or "man" (the
+ * default comes from the output file extension), and the remaining keys match
+ * the command-line options of the same name.  Lines starting with "#" are
+ * comments.
  */
 
-static void
-filebuf_ungetc(filebuf_t *file,		/* I - File buffer */
-               int       ch)		/* I - Character to save */
+static bool				/* O - `true` on success, `false` on error */
+batch_load(batch_t    *batch,		/* I - Batch */
+           const char *manifest,	/* I - Manifest file */
+           const char *defaults[])	/* I - Default values */
 {
-  file->ch = ch;
-}
+  bool			ret = false;	/* Return value */
+  FILE			*fp;		/* Manifest file */
+  char			line[16384],	/* Line from file */
+			*key,		/* Key */
+			*value,		/* Value */
+			*ptr;		/* Pointer into line */
+  int			linenum = 0;	/* Line number */
+  size_t		i;		/* Looping var */
+  batch_target_t	*target = NULL;	/* Current target */
+  batch_node_t		*node = NULL;	/* Input tree node for current target */
+
+
+  if ((fp = fopen(manifest, "r")) == NULL)
+  {
+    fprintf(stderr, "codedoc: Unable to open batch manifest \"%s\": %s\n", manifest, strerror(errno));
+    return (false);
+  }
 
+  do
+  {
+    if (fgets(line, sizeof(line), fp))
+    {
+      linenum ++;
 
-/*
- * 'find_public()' - Find a public function, type, etc.
- */
+      for (ptr = line + strlen(line); ptr > line && isspace(ptr[-1] & 255); ptr --);
+      *ptr = '\0';
 
-static mxml_node_t *			/* I - Found node or NULL */
-find_public(mxml_node_t *node,		/* I - Current node */
-            mxml_node_t *top,		/* I - Top node */
-            const char  *element,	/* I - Element */
-            const char  *name,		/* I - Name */
-            int         mode)           /* I - Output mode */
-{
-  mxml_node_t	*description,		/* Description node */
-		*comment;		/* Comment node */
+      for (key = line; isspace(*key & 255); key ++);
+    }
+    else
+    {
+      key = NULL;
+    }
 
+    if (!key || !*key)
+    {
+     /*
+      * End of target...
+      */
 
-  for (node = mxmlFindElement(node, top, element, name ? "name" : NULL, name, node == top ? MXML_DESCEND_FIRST : MXML_DESCEND_NONE);
-       node;
-       node = mxmlFindElement(node, top, element, name ? "name" : NULL, name, MXML_DESCEND_NONE))
-  {
-   /*
-    * Get the description for this node...
-    */
+      if (!target)
+        continue;
 
-    description = mxmlFindElement(node, node, "description", NULL, NULL, MXML_DESCEND_FIRST);
+      if (!target->values[BATCH_OUTPUT])
+      {
+        fprintf(stderr, "codedoc: %s:%d: Missing output for target.\n", manifest, target->line);
+        goto error;
+      }
 
-   /*
-    * A missing or empty description signals a private node...
-    */
+      if (target->mode == OUTPUT_NONE)
+      {
+        if ((ptr = strrchr(target->values[BATCH_OUTPUT], '.')) == NULL)
+          ptr = "";
+
+        if (!strcmp(ptr, ".epub"))
+          target->mode = OUTPUT_EPUB;
+        else if (!strcmp(ptr, ".htm") || !strcmp(ptr, ".html"))
+          target->mode = OUTPUT_HTML;
+        else if (isdigit(ptr[1] & 255))
+          target->mode = OUTPUT_MAN;
+        else
+        {
+          fprintf(stderr, "codedoc: %s:%d: Unable to determine the format of \"%s\".\n", manifest, target->line, target->values[BATCH_OUTPUT]);
+          goto error;
+        }
+      }
 
-    if (!description)
+      if (target->mode == OUTPUT_MAN && !target->values[BATCH_NAME])
+      {
+       /*
+        * Default man page name is the output filename without the extension...
+        */
+
+        char	name[1024];		/* Name of manpage */
+
+        if ((ptr = strrchr(target->values[BATCH_OUTPUT], '/')) != NULL)
+          strlcpy(name, ptr + 1, sizeof(name));
+        else
+          strlcpy(name, target->values[BATCH_OUTPUT], sizeof(name));
+
+        if ((ptr = strrchr(name, '.')) != NULL && ptr > name)
+          *ptr = '\0';
+
+        target->values[BATCH_NAME] = strdup(name);
+      }
+
+      target->next  = node->targets;
+      node->targets = target;
+      target        = NULL;
       continue;
+    }
+    else if (*key == '#')
+    {
+      continue;
+    }
 
    /*
-    * Look for @private@ or @exclude format@ in the comment text...
+    * Split "key: value"...
     */
 
-    for (comment = mxmlGetFirstChild(description); comment; comment = mxmlGetNextSibling(comment))
+    if ((value = strchr(key, ':')) == NULL)
     {
-      const char *s = mxmlGetType(comment) == MXML_TYPE_TEXT ? mxmlGetText(comment, NULL) : mxmlGetOpaque(comment);
-      const char *exclude;
+      fprintf(stderr, "codedoc: %s:%d: Missing \":\" after key.\n", manifest, linenum);
+      goto error;
+    }
 
-     /*
-      * Skip anything marked private...
-      */
+    for (ptr = value; ptr > key && isspace(ptr[-1] & 255); ptr --);
+    *ptr = '\0';
 
-      if (strstr(s, "@private@"))
-        break;
+    for (value ++; isspace(*value & 255); value ++);
 
+    if (!target)
+    {
      /*
-      * Skip items excluded for certain formats...
+      * Start a new target with the command-line values...
       */
 
-      if ((exclude = strstr(s, "@exclude ")) != NULL)
+      if ((target = calloc(1, sizeof(batch_target_t))) == NULL)
       {
-        exclude += 9;
+        fputs("codedoc: Unable to allocate memory for batch target.\n", stderr);
+        goto error;
+      }
 
-        if (!strncmp(exclude, "all@", 4))
-        {
-          break;
-        }
-        else
-        {
-          while (*exclude != '@')
-          {
-            if (!strncmp(exclude, "docset", 6))
-            {
-              /* Legacy, no longer supported */
-              exclude += 6;
-            }
-            else if (!strncmp(exclude, "epub", 4))
-            {
-              if (mode == OUTPUT_EPUB)
-                break;
-              exclude += 4;
-            }
-            else if (!strncmp(exclude, "html", 4))
-            {
-              if (mode == OUTPUT_HTML)
-                break;
-              exclude += 4;
-            }
-            else if (!strncmp(exclude, "man", 3))
-            {
-              if (mode == OUTPUT_MAN)
-                break;
-              exclude += 3;
-            }
-            else if (!strncmp(exclude, "tokens", 6))
-            {
-              /* Legacy, no longer supported */
-              exclude += 6;
-            }
-            else if (!strncmp(exclude, "xml", 3))
-            {
-              if (mode == OUTPUT_XML)
-                break;
-              exclude += 3;
-            }
-            else
-              break;
+      target->line = linenum;
+      target->mode = OUTPUT_NONE;
+      node         = &batch->root;
 
-            if (*exclude == ',')
-              exclude ++;
-            else if (*exclude != '@')
-              break;
-          }
+      for (i = 0; i < BATCH_MAX; i ++)
+      {
+        if (defaults[i])
+          target->values[i] = strdup(defaults[i]);
+      }
+    }
 
-          if (*exclude != '@')
-            break;
+    if (!strcmp(key, "inputs"))
+    {
+      for (ptr = strtok(value, " \t"); ptr; ptr = strtok(NULL, " \t"))
+      {
+        if ((node = batch_child(node, ptr)) == NULL)
+        {
+	  fputs("codedoc: Unable to allocate memory for batch inputs.\n", stderr);
+	  goto error;
         }
       }
     }
-
-    if (!comment)
+    else if (!strcmp(key, "format"))
     {
-     /*
-      * No @private@, so return this node...
-      */
+      if (!strcmp(value, "epub"))
+        target->mode = OUTPUT_EPUB;
+      else if (!strcmp(value, "html"))
+        target->mode = OUTPUT_HTML;
+      else if (!strcmp(value, "man"))
+        target->mode = OUTPUT_MAN;
+      else
+      {
+        fprintf(stderr, "codedoc: %s:%d: Unknown format \"%s\".\n", manifest, linenum, value);
+        goto error;
+      }
+    }
+    else
+    {
+      for (i = 0; i < BATCH_MAX; i ++)
+      {
+        if (!strcmp(key, batch_keys[i]))
+          break;
+      }
 
-      return (node);
+      if (i >= BATCH_MAX)
+      {
+        fprintf(stderr, "codedoc: %s:%d: Unknown key \"%s\".\n", manifest, linenum, key);
+        goto error;
+      }
+
+      free(target->values[i]);
+      target->values[i] = strdup(value);
     }
   }
+  while (key);
 
- /*
-  * If we get here, there are no (more) public nodes...
-  */
+  ret = true;
 
-  return (NULL);
-}
+  error:
 
+  if (target)
+  {
+    for (i = 0; i < BATCH_MAX; i ++)
+      free(target->values[i]);
 
-/*
- * 'free_toc()' - Free a table-of-contents.
- */
+    free(target);
+  }
 
-static void
-free_toc(toc_t *toc)			/* I - Table of contents */
-{
-  free(toc->entries);
-  free(toc);
+  fclose(fp);
+
+  return (ret);
 }
 
 
 /*
- * 'get_comment_info()' - Get info from comment.
+ * 'batch_render()' - Render a batch target, in a child process when possible.
  */
 
-static char *				/* O - Info from comment */
-get_comment_info(
-    mxml_node_t *description)		/* I - Description node */
+static void
+batch_render(batch_t        *batch,	/* I - Batch */
+             batch_target_t *target,	/* I - Target */
+             batch_node_t   *node,	/* I - Input tree node */
+             mxml_node_t    *codedoc)	/* I - codedoc node */
 {
-  char		text[10240],		/* Description text */
-		since[255],		/* @since value */
-		*ptr;			/* Pointer into text */
-  static char	info[1024];		/* Info string */
+  statsSetPhase(STATS_PHASE_RENDER);
 
+#ifndef _WIN32
+  batch_wait(batch, false);
 
-  if (!description)
-    return ("");
+  if (jobsAcquire())
+  {
+   /*
+    * Render in a child process, which gets its own copy of the current
+    * documentation tree while we continue scanning...
+    */
 
-  get_text(description, text, sizeof(text));
+    pid_t	pid;			/* Child process ID */
+    int		*pids;			/* New process array */
 
-  for (ptr = strchr(text, '@'); ptr; ptr = strchr(ptr + 1, '@'))
-  {
-    if (!strncmp(ptr, "@deprecated@", 12))
-      return ("<span class=\"info\">&#160;DEPRECATED&#160;</span>");
-    else if (!strncmp(ptr, "@since ", 7))
+    if (batch->num_pids >= batch->alloc_pids)
     {
-      strlcpy(since, ptr + 7, sizeof(since));
+      if ((pids = realloc(batch->pids, (batch->alloc_pids + 16) * sizeof(int))) != NULL)
+      {
+        batch->pids       = pids;
+        batch->alloc_pids += 16;
+      }
+    }
 
-      if ((ptr = strchr(since, '@')) != NULL)
-        *ptr = '\0';
+    fflush(stdout);
+    fflush(stderr);
 
-      snprintf(info, sizeof(info), "<span class=\"info\">&#160;%s&#160;</span>", since);
-      return (info);
+    if (batch->num_pids < batch->alloc_pids && (pid = fork()) >= 0)
+    {
+      if (pid == 0)
+      {
+        bool ok;			/* Did the target render? */
+
+        jobsChild();
+        statsChild();
+
+        ok = batch_write(batch, target, node, codedoc);
+
+        fflush(stdout);
+        _exit(ok ? 0 : 1);
+      }
+
+      batch->pids[batch->num_pids ++] = (int)pid;
+      return;
     }
+
+    jobsRelease();
   }
+#endif /* !_WIN32 */
 
-  return ("");
+  if (!batch_write(batch, target, node, codedoc))
+    batch->failed = true;
 }
 
 
 /*
- * 'get_iso_date()' - Get an ISO-formatted date/time string.
+ * 'batch_run()' - Generate documentation for all targets in a batch manifest.
+ *
+ * Targets are organized into a tree of their input files, in order, so any
+ * sequence of inputs that starts several targets is scanned once.  Scanning
+ * is done in order because declarations in one file update those found in
+ * earlier files, so the tree is copied only where targets' inputs diverge.
+ * Each input file is read only once.
  */
 
-static char *				/* O - ISO date/time string */
-get_iso_date(time_t t)			/* I - Time value */
+static bool				/* O - `true` on success, `false` on error */
+batch_run(const char *manifest,		/* I - Manifest file */
+          const char *defaults[],	/* I - Default values */
+          bool       minify,		/* I - Minify HTML/XHTML output? */
+          bool       progressive,	/* I - Defer HTML symbol details? */
+          bool       rsyncable,		/* I - Use rsync-friendly compression? */
+          bool       release)		/* I - Use maximum compression? */
 {
-  struct tm	date;			/* UTC date/time */
-  static char	buffer[100];		/* String buffer */
+  bool		ret = false;		/* Return value */
+  batch_t	batch;			/* Batch */
+  mxml_node_t	*doc,			/* Documentation tree */
+		*codedoc;		/* codedoc node */
+  size_t	i;			/* Looping var */
 
 
-  gmtime_r(&t, &date);
+  memset(&batch, 0, sizeof(batch));
+  batch.minify      = minify;
+  batch.progressive = progressive;
+  batch.rsyncable   = rsyncable;
+  batch.release     = release;
 
-  snprintf(buffer, sizeof(buffer), "%04d-%02d-%02dT%02d:%02d:%02dZ", date.tm_year + 1900, date.tm_mon + 1, date.tm_mday, date.tm_hour, date.tm_min, date.tm_sec);
+  statsSetPhase(STATS_PHASE_LOAD);
 
-  return (buffer);
-}
+  if (batch_load(&batch, manifest, defaults))
+  {
+    doc = new_documentation(&codedoc);
+    ret = batch_scan(&batch, &batch.root, doc, codedoc);
 
+    batch_wait(&batch, true);
 
-/*
- * 'get_nth_child()' - Get the Nth child node.
- */
+    if (batch.failed)
+      ret = false;
 
-static mxml_node_t *			/* O - Child node or NULL */
-get_nth_child(mxml_node_t *node,	/* I - Parent node */
-              int         idx)		/* I - Child node index (negative to index from end) */
-{
-  if (idx < 0)
-  {
-    for (node = mxmlGetLastChild(node); node && idx < -1; idx ++)
-      node = mxmlGetPrevSibling(node);
+    mxmlDelete(doc);
   }
-  else
+
+  batch_delete(&batch.root);
+
+  for (i = 0; i < batch.num_files; i ++)
   {
-    for (node = mxmlGetFirstChild(node); node && idx > 0; idx --)
-      node = mxmlGetNextSibling(node);
+    free(batch.files[i].filename);
+    free(batch.files[i].buffer);
   }
 
-  return (node);
+  free(batch.files);
+  free(batch.pids);
+
+  return (ret);
 }
 
 
 /*
- * 'get_nth_text()' - Get the text string from the Nth child node.
+ * 'batch_scan()' - Scan the inputs below a batch input tree node and render
+ *                  the targets that use them.
  */
 
-static const char *			/* O - String value or NULL */
-get_nth_text(mxml_node_t *node,		/* I - Parent node */
-             int         idx,		/* I - Child node index (negative to index from end) */
-             bool        *whitespace)	/* O - Whitespace value (NULL for don't care) */
+static bool				/* O - `true` on success, `false` on error */
+batch_scan(batch_t      *batch,		/* I - Batch */
+           batch_node_t *node,		/* I - Input tree node */
+           mxml_node_t  *doc,		/* I - Documentation tree for node */
+           mxml_node_t  *codedoc)	/* I - codedoc node for node */
 {
-  return (mxmlGetText(get_nth_child(node, idx), whitespace));
-}
+  batch_target_t *target;		/* Current target */
+  batch_node_t	*child;			/* Current child */
+  mxml_node_t	*cdoc,			/* Documentation tree for child */
+		*ccodedoc,		/* codedoc node for child */
+		*temp;			/* Current node */
+  filebuf_t	file;			/* File to scan */
+  const char	*data;			/* File contents */
+  size_t	length;			/* Length of contents */
+  mmd_t		*body = NULL;		/* Body (unused, @body@ text is captured) */
+  bool		ret;			/* Return value */
 
 
-/*
- * 'get_text()' - Get the text for a node.
- */
+ /*
+  * Render any targets whose inputs end here...
+  */
 
-static char *				/* O - Text in node */
-get_text(mxml_node_t *node,		/* I - Node to get */
-         char        *buffer,		/* I - Buffer */
-	 int         buflen)		/* I - Size of buffer */
-{
-  char		*ptr,			/* Pointer into buffer */
-		*end;			/* End of buffer */
-  size_t	len;			/* Length of node */
-  mxml_node_t	*current;		/* Current node */
+  for (target = node->targets; target; target = target->next)
+    batch_render(batch, target, node, codedoc);
 
+ /*
+  * Then scan each following input, copying the tree if other inputs also
+  * follow this node...
+  */
 
-  ptr = buffer;
-  end = buffer + buflen - 1;
-
-  for (current = mxmlGetFirstChild(node); current && ptr < end; current = mxmlGetNextSibling(current))
+  for (child = node->child; child; child = child->next)
   {
-    mxml_type_t type = mxmlGetType(current);
-
-    if (type == MXML_TYPE_TEXT)
-    {
-      bool whitespace;
-      const char *string = mxmlGetText(current, &whitespace);
+    statsSetPhase(STATS_PHASE_SCAN);
 
-      if (whitespace)
-        *ptr++ = ' ';
+    if ((data = batch_get_file(batch, child->filename, &length)) == NULL)
+      return (false);
 
-      len = strlen(string);
-      if (len > (size_t)(end - ptr))
-        len = (size_t)(end - ptr);
+    if (child->next)
+    {
+      cdoc = new_documentation(&ccodedoc);
 
-      memcpy(ptr, string, len);
-      ptr += len;
+      for (temp = mxmlGetFirstChild(codedoc); temp; temp = mxmlGetNextSibling(temp))
+        copy_node(ccodedoc, temp);
     }
-    else if (type == MXML_TYPE_OPAQUE)
+    else
     {
-      const char *opaque = mxmlGetOpaque(current);
+      cdoc     = doc;
+      ccodedoc = codedoc;
+    }
 
-      len = strlen(opaque);
-      if (len > (size_t)(end - ptr))
-        len = (size_t)(end - ptr);
+    filebuf_open_buffer(&file, child->filename, data, length);
+    file.capture = true;
 
-      memcpy(ptr, opaque, len);
-      ptr += len;
-    }
-  }
+    CODEDOC_PROBE2(scan__start, file.filename, length);
 
-  *ptr = '\0';
+    ret = scan_source(&file, ccodedoc, &body) != 0;
 
-  return (buffer);
+    CODEDOC_PROBE3(scan__done, file.filename, length, ret);
+
+    child->num_bodytext = file.num_bodytext;
+    child->bodytext     = file.bodytext;
+    file.num_bodytext   = 0;
+    file.bodytext       = NULL;
+
+    filebuf_close(&file);
+
+    if (ret)
+      ret = batch_scan(batch, child, cdoc, ccodedoc);
+
+    if (cdoc != doc)
+      mxmlDelete(cdoc);
+
+    if (!ret)
+      return (false);
+  }
+
+  return (true);
 }
 
 
 /*
- * 'highlight_c_string()' - Output a string of C code, highlighting it as needed.
+ * 'batch_wait()' - Wait for render processes to finish.
  */
 
 static void
-highlight_c_string(FILE       *fp,	/* I  - Output file */
-                   const char *s,	/* I  - String */
-                   int        *histate)	/* IO - Highlighting state */
+batch_wait(batch_t *batch,		/* I - Batch */
+           bool    all)			/* I - Wait for all processes? */
 {
-  const char	*start = s,		/* Start of code to highlight */
-		*class_name = (*histate == HIGHLIGHT_COMMENT) ? "comment" : NULL;
-					/* Class name for current fragment */
-  char		keyword[32],		/* Current keyword */
-		*keyptr = keyword;	/* Pointer into keyword */
+#ifndef _WIN32
+  size_t	i = 0;			/* Looping var */
+  pid_t		pid;			/* Process ID */
+  int		status;			/* Exit status */
 
 
-  if (*histate == HIGHLIGHT_COMMENT)
+  while (i < batch->num_pids)
   {
-    if ((s = strstr(start, "*/")) != NULL)
-    {
-     /*
-      * Comment ends on this line...
-      */
-
-      s += 2;
-
-      fputs("<span class=\"comment\">", fp);
-      write_string(fp, start, OUTPUT_HTML, s - start);
-      fputs("</span>", fp);
-
-      start      = s;
-      *histate   = HIGHLIGHT_NONE;
-      class_name = NULL;
-    }
-    else if (*start)
+    if ((pid = waitpid((pid_t)batch->pids[i], &status, all ? 0 : WNOHANG)) == 0)
     {
-     /*
-      * Comment continues beyond the current line...
-      */
-
-      s = start + strlen(start) - 1;
+      i ++;
+      continue;
     }
-    else
+    else if (pid < 0 && errno == EINTR)
     {
-      goto done;
+      continue;
     }
-  }
-  else if (*s == '#')
-  {
-   /*
-    * Preprocessor directive...
-    */
-
-    while (*s && *s != '\n')
-    {
-      if (!strncmp(s, "/*", 2) || !strncmp(s, "//", 2))
-        break;
 
-      s ++;
-    }
+    if (pid < 0 || !WIFEXITED(status) || WEXITSTATUS(status))
+      batch->failed = true;
 
-    fputs("<span class=\"directive\">", fp);
-    write_string(fp, start, OUTPUT_HTML, s - start);
-    fputs("</span>", fp);
+    jobsRelease();
 
-    start = s;
+    batch->pids[i] = batch->pids[-- batch->num_pids];
   }
 
-  while (*s && *s != '\n')
-  {
-    if (!strncmp(s, "/*", 2))
-    {
-     /*
-      * Start of a block comment...
-      */
-
-      if (s > start)
-      {
-       /*
-        * Output current fragment...
-        */
+#else
+  (void)batch;
+  (void)all;
+#endif /* !_WIN32 */
+}
 
-	if (class_name)
-	{
-	  fprintf(fp, "<span class=\"%s\">", class_name);
-	  write_string(fp, start, OUTPUT_HTML, s - start);
-	  fputs("</span>", fp);
-	}
-	else
-	{
-	  write_string(fp, start, OUTPUT_HTML, s - start);
-	}
 
-	start = s;
-      }
+/*
+ * 'batch_write()' - Write the documentation for a batch target.
+ */
 
-     /*
-      * At this point, "start" points to the start of the comment...
-      */
+static bool				/* O - `true` on success, `false` on error */
+batch_write(batch_t        *batch,	/* I - Batch */
+            batch_target_t *target,	/* I - Target */
+            batch_node_t   *node,	/* I - Input tree node */
+            mxml_node_t    *codedoc)	/* I - codedoc node */
+{
+  char		**values = target->values;
+					/* Target values */
+  mmd_t		*body = NULL;		/* Body markdown */
+  int		fd,			/* Output file */
+		saved;			/* Saved standard output */
+  const char	*title,			/* Title of documentation */
+		*author,		/* Author */
+		*language,		/* Language */
+		*copyright,		/* Copyright */
+		*docversion;		/* Documentation set version */
+  char		docdir[1024],		/* Directory containing the output */
+		*docptr;		/* Pointer into directory */
 
-      if ((s = strstr(start, "*/")) != NULL)
-      {
-       /*
-        * Comment ends on the current line...
-        */
 
-        s += 2;
+ /*
+  * Load the body file followed by any @body@ comments from the inputs...
+  */
 
-	fputs("<span class=\"comment\">", fp);
-	write_string(fp, start, OUTPUT_HTML, s - start);
-	fputs("</span>", fp);
+  if (values[BATCH_BODY] && is_markdown(values[BATCH_BODY]))
+    body = markdown_load(NULL, values[BATCH_BODY]);
 
-	start      = s;
-	*histate   = HIGHLIGHT_NONE;
-	class_name = NULL;
-      }
-      else
-      {
-       /*
-        * Comment continues to the next line...
-        */
+  body = batch_body(body, node);
 
-	s          = start + strlen(start) - 1;
-	*histate   = HIGHLIGHT_COMMENT;
-	class_name = "comment";
-	break;
-      }
-    }
-    else if (!strncmp(s, "//", 2))
-    {
-     /*
-      * Start of C++ comment...
-      */
+ /*
+  * Collect the default metadata values...
+  */
 
-      if (s > start)
-      {
-       /*
-        * Output current fragment...
-        */
+  title      = get_default(values[BATCH_TITLE], body, "title", "Documentation");
+  author     = get_default(values[BATCH_AUTHOR], body, "author", "Unknown");
+  language   = get_default(values[BATCH_LANGUAGE], body, "language", "en-US");
+  copyright  = get_default(values[BATCH_COPYRIGHT], body, "copyright", "Unknown");
+  docversion = get_default(values[BATCH_DOCVERSION], body, "version", "0.0");
 
-	if (class_name)
-	{
-	  fprintf(fp, "<span class=\"%s\">", class_name);
-	  write_string(fp, start, OUTPUT_HTML, s - start);
-	  fputs("</span>", fp);
-	}
-	else
-	{
-	  write_string(fp, start, OUTPUT_HTML, s - start);
-	}
+ /*
+  * Write output...
+  */
 
-	start = s;
-      }
+  if (target->mode == OUTPUT_EPUB)
+  {
+    write_epub(values[BATCH_OUTPUT], values[BATCH_SECTION], title, author, language, copyright, docversion, values[BATCH_CSS], values[BATCH_COVERIMAGE], values[BATCH_HEADER], values[BATCH_BODY], body, codedoc, values[BATCH_FOOTER], batch->minify, batch->rsyncable, batch->release);
+  }
+  else
+  {
+   /*
+    * HTML and man output go to the standard output, so redirect it to the
+    * output file...
+    */
 
-      s          = start + strlen(start) - 1;
-      *histate   = HIGHLIGHT_COMMENT1;
-      class_name = "comment";
-      break;
-    }
-    else if (*s == '\"' || *s == '\'')
+    if ((fd = open(values[BATCH_OUTPUT], O_WRONLY | O_CREAT | O_TRUNC, 0666)) < 0)
     {
-     /*
-      * String/character constant...
-      */
+      fprintf(stderr, "codedoc: Unable to create \"%s\": %s\n", values[BATCH_OUTPUT], strerror(errno));
+      if (body)
+        mmdFree(body);
 
-      if (s > start)
-      {
-       /*
-        * Output current fragment...
-        */
+      return (false);
+    }
 
-	if (class_name)
-	{
-	  fprintf(fp, "<span class=\"%s\">", class_name);
-	  write_string(fp, start, OUTPUT_HTML, s - start);
-	  fputs("</span>", fp);
-	}
-	else
-	{
-	  write_string(fp, start, OUTPUT_HTML, s - start);
-	}
+    fflush(stdout);
+    saved = dup(1);
+    dup2(fd, 1);
+    close(fd);
 
-	start = s;
-      }
+    strlcpy(docdir, values[BATCH_OUTPUT], sizeof(docdir));
+    if ((docptr = strrchr(docdir, '/')) == NULL)
+      strlcpy(docdir, ".", sizeof(docdir));
+    else if (docptr == docdir)
+      docptr[1] = '\0';
+    else
+      *docptr = '\0';
 
-      for (s = start + 1; *s && *s != *start; s ++)
-      {
-        if (*s == '\\' && s[1])
-          s ++;
-      }
+    if (target->mode == OUTPUT_MAN)
+      write_man(values[BATCH_NAME], values[BATCH_SECTION], title, author, copyright, values[BATCH_HEADER], values[BATCH_BODY], body, codedoc, values[BATCH_FOOTER]);
+    else
+      write_html(values[BATCH_SECTION], title, author, language, copyright, docversion, values[BATCH_CSS], values[BATCH_CSS_OUT], docdir, values[BATCH_COVERIMAGE], values[BATCH_HEADER], values[BATCH_BODY], body, codedoc, values[BATCH_FOOTER], batch->minify, batch->progressive, NULL);
 
-      if (*s == *start)
-        s ++;
+    fflush(stdout);
+    dup2(saved, 1);
+    close(saved);
+  }
 
-      fputs("<span class=\"string\">", fp);
-      write_string(fp, start, OUTPUT_HTML, s - start);
-      fputs("</span>", fp);
+  if (body)
+    mmdFree(body);
 
-      start = s;
-    }
-    else
-    {
-      if (isalnum(*s & 255) || *s == '_' || *s == '.')
-      {
-       /*
-        * Number or keyword...
-        */
+  return (true);
+}
 
-	if (*histate == HIGHLIGHT_NONE)
-	{
-	  if (s > start && *histate == HIGHLIGHT_NONE)
-	  {
-	   /*
-	    * End current fragment...
-	    */
 
-	    write_string(fp, start, OUTPUT_HTML, s - start);
-	    start = s;
-	  }
+/*
+ * 'build_toc()' - Build a table-of-contents...
+ */
 
-	  if (isdigit(*s & 255) || (*s == '.' && isdigit(s[1] & 255)))
-	  {
-	    *histate   = HIGHLIGHT_NUMBER;
-	    class_name = "number";
-	  }
-	  else
-	  {
-	    *histate = HIGHLIGHT_RESERVED;
-	  }
-	}
+static toc_t *				/* O - Table of contents */
+build_toc(mxml_node_t *doc,		/* I - Documentation */
+          const char  *bodyfile,	/* I - Body file */
+          mmd_t       *body,		/* I - Markdown body */
+          const char  *footerfile,	/* I - Footer file */
+          mmd_t       *footer,		/* I - Markdown footer */
+          int         mode)             /* I - Output mode */
+{
+  toc_t		*toc;			/* Array of headings */
+  mxml_node_t	*function,		/* Current function */
+		*scut,			/* Struct/class/union/typedef */
+		*arg;			/* Current argument */
+  const char	*name;			/* Name of function/type */
 
-        if (*histate == HIGHLIGHT_RESERVED && keyptr < (keyword + sizeof(keyword) - 1))
-          *keyptr++ = *s;
-      }
-      else if (*histate == HIGHLIGHT_NUMBER)
-      {
-       /*
-        * End of number...
-        */
 
-	fprintf(fp, "<span class=\"%s\">", class_name);
-	write_string(fp, start, OUTPUT_HTML, s - start);
-	fputs("</span>", fp);
+ /*
+  * Make a new table-of-contents...
+  */
 
-	start      = s;
-	*histate   = HIGHLIGHT_NONE;
-	class_name = NULL;
-      }
-      else if (*histate == HIGHLIGHT_RESERVED)
-      {
-       /*
-        * End of reserved word?
-        */
+  if ((toc = calloc(1, sizeof(toc_t))) == NULL)
+    return (NULL);
 
-        *keyptr = '\0';
-        keyptr  = keyword;
+ /*
+  * Scan the body file for headings...
+  */
 
-        if (is_reserved(keyword))
-        {
-         /*
-          * Yes, reserved word...
-          */
+  add_file_toc(toc, bodyfile, body);
 
-	  fputs("<span class=\"reserved\">", fp);
-	  write_string(fp, start, OUTPUT_HTML, s - start);
-	  fputs("</span>", fp);
-        }
-        else
-        {
-         /*
-          * Just some other text...
-          */
+ /*
+  * Next the classes...
+  */
 
-	  write_string(fp, start, OUTPUT_HTML, s - start);
-        }
+  if ((scut = find_public(doc, doc, "class", NULL, mode)) != NULL)
+  {
+    add_toc(toc, 1, "CLASSES", "Classes");
 
-        start    = s;
-        *histate = HIGHLIGHT_NONE;
-      }
+    while (scut)
+    {
+      name = mxmlElementGetAttr(scut, "name");
+      scut = find_public(scut, doc, "class", NULL, mode);
+      add_toc(toc, 2, name, name);
+    }
+  }
 
-      s ++;
+ /*
+  * Functions...
+  */
+
+  if ((function = find_public(doc, doc, "function", NULL, mode)) != NULL)
+  {
+    add_toc(toc, 1, "FUNCTIONS", "Functions");
+
+    while (function)
+    {
+      name     = mxmlElementGetAttr(function, "name");
+      function = find_public(function, doc, "function", NULL, mode);
+      add_toc(toc, 2, name, name);
     }
   }
 
-  if (s > start)
+ /*
+  * Data types...
+  */
+
+  if ((scut = find_public(doc, doc, "typedef", NULL, mode)) != NULL)
   {
-    if (class_name)
+    add_toc(toc, 1, "TYPES", "Data Types");
+
+    while (scut)
     {
-      fprintf(fp, "<span class=\"%s\">", class_name);
-      write_string(fp, start, OUTPUT_HTML, s - start);
-      fputs("</span>", fp);
+      name = mxmlElementGetAttr(scut, "name");
+      scut = find_public(scut, doc, "typedef", NULL, mode);
+      add_toc(toc, 2, name, name);
     }
-    else if (*histate == HIGHLIGHT_RESERVED)
+  }
+
+ /*
+  * Structures...
+  */
+
+  if ((scut = find_public(doc, doc, "struct", NULL, mode)) != NULL)
+  {
+    add_toc(toc, 1, "STRUCTURES", "Structures");
+
+    while (scut)
     {
-      *keyptr = '\0';
-      keyptr  = keyword;
+      name = mxmlElementGetAttr(scut, "name");
+      scut = find_public(scut, doc, "struct", NULL, mode);
+      add_toc(toc, 2, name, name);
+    }
+  }
 
-      if (is_reserved(keyword))
-      {
-       /*
-	* Yes, reserved word...
-	*/
+ /*
+  * Unions...
+  */
 
-	fputs("<span class=\"reserved\">", fp);
-	write_string(fp, start, OUTPUT_HTML, s - start);
-	fputs("</span>", fp);
-      }
-      else
-      {
-       /*
-	* Just some other text...
-	*/
+  if ((scut = find_public(doc, doc, "union", NULL, mode)) != NULL)
+  {
+    add_toc(toc, 1, "UNIONS", "Unions");
 
-	write_string(fp, start, OUTPUT_HTML, s - start);
-      }
+    while (scut)
+    {
+      name = mxmlElementGetAttr(scut, "name");
+      scut = find_public(scut, doc, "union", NULL, mode);
+      add_toc(toc, 2, name, name);
     }
-    else
+  }
+
+ /*
+  * Globals variables...
+  */
+
+  if ((arg = find_public(doc, doc, "variable", NULL, mode)) != NULL)
+  {
+    add_toc(toc, 1, "VARIABLES", "Variables");
+
+    while (arg)
     {
-      write_string(fp, start, OUTPUT_HTML, s - start);
+      name = mxmlElementGetAttr(arg, "name");
+      arg = find_public(arg, doc, "variable", NULL, mode);
+      add_toc(toc, 2, name, name);
     }
   }
 
-  done:
+ /*
+  * Enumerations/constants...
+  */
 
-  if (*histate != HIGHLIGHT_COMMENT)
-    *histate = HIGHLIGHT_NONE;
+  if ((scut = find_public(doc, doc, "enumeration", NULL, mode)) != NULL)
+  {
+    add_toc(toc, 1, "ENUMERATIONS", "Enumerations");
 
-  putc('\n', fp);
+    while (scut)
+    {
+      name = mxmlElementGetAttr(scut, "name");
+      scut = find_public(scut, doc, "enumeration", NULL, mode);
+      add_toc(toc, 2, name, name);
+    }
+  }
+
+ /*
+  * Scan the footer file for headings...
+  */
+
+  if (footerfile)
+    add_file_toc(toc, footerfile, footer);
+
+  return (toc);
 }
 
 
 /*
- * 'highlight_css_string()' - Output a string of CSS, highlighting it as needed.
+ * 'clear_whitespace()' - Clear the whitespace value of a text node.
  */
 
 static void
-highlight_css_string(
-    FILE       *fp,			/* I  - Output file */
-    const char *s,			/* I  - String */
-    int        *histate)		/* IO - Highlighting state */
+clear_whitespace(mxml_node_t *node)	/* I - Node */
 {
-  static const char *class_names[] =	/* CSS class names for each state */
-  {
-    NULL,				/* No highlighting, plain text */
-    "comment",				/* Comment text */
-    NULL,				/* One-line comment text */
-    "directive",			/* Declaration */
-    "directive",			/* @ directive */
-    "number",				/* Number text */
-    "reserved",				/* Property name text */
-    NULL				/* String literal text */
-  };
-  const char	*start = s;		/* Start of code to highlight */
+  mxmlSetText(node, false, mxmlGetText(node, NULL));
+}
 
 
-  if (*histate == HIGHLIGHT_COMMENT)
+/*
+ * 'copy_node()' - Copy a node and its children.
+ */
+
+static void
+copy_node(mxml_node_t *parent,		/* I - Parent for copy */
+          mxml_node_t *node)		/* I - Node to copy */
+{
+  mxml_node_t	*current;		/* Current node */
+  int		walk;			/* Walk event for current node */
+  size_t	i,			/* Looping var */
+		count;			/* Number of attributes */
+  const char	*name,			/* Attribute name */
+		*value;			/* Attribute value or text */
+  bool		whitespace;		/* Leading whitespace? */
+
+
+  for (current = node, walk = WALK_ENTER; current; current = walk_next(current, node, &walk))
   {
-    if ((s = strstr(start, "*/")) != NULL)
+    if (walk == WALK_EXIT)
     {
-      // Comment ends on this line...
-      s += 2;
-
-      fputs("<span class=\"comment\">", fp);
-      write_string(fp, start, OUTPUT_HTML, s - start);
-      fputs("</span>", fp);
+     /*
+      * Done with an element, go back to the parent of its copy...
+      */
 
-      start    = s;
-      *histate = HIGHLIGHT_NONE;
+      parent = mxmlGetParent(parent);
+      continue;
     }
-    else
+
+    switch (mxmlGetType(current))
     {
-      // Comment continues beyond the current line...
-      s = start + strlen(start) - 1;
+      case MXML_TYPE_ELEMENT :
+	  parent = mxmlNewElement(parent, mxmlGetElement(current));
+
+	  for (i = 0, count = mxmlElementGetAttrCount(current); i < count; i ++)
+	  {
+	    if ((value = mxmlElementGetAttrByIndex(current, i, &name)) != NULL)
+	      mxmlElementSetAttr(parent, name, value);
+	  }
+	  continue;
+
+      case MXML_TYPE_OPAQUE :
+	  mxmlNewOpaque(parent, mxmlGetOpaque(current));
+	  break;
+
+      case MXML_TYPE_TEXT :
+	  value = mxmlGetText(current, &whitespace);
+	  mxmlNewText(parent, whitespace, value);
+	  break;
+
+      default :
+	  break;
     }
+
+    walk = WALK_EXIT;
   }
-  else if (*histate == HIGHLIGHT_DIRECTIVE)
-  {
-    for (s = start + 1; *s && *s != *start; s ++)
-    {
-      if (*s == '{' || *s == ';')
-      {
-	s ++;
-	break;
-      }
-    }
+}
 
-    fputs("<span class=\"directive\">", fp);
-    write_string(fp, start, OUTPUT_HTML, s - start);
-    fputs("</span>", fp);
 
-    start = s;
+/*
+ * 'epub_ws_cb()' - Whitespace callback for EPUB.
+ */
 
-    if (*s)
-      *histate = HIGHLIGHT_NONE;
-  }
+static const char *			/* O - Whitespace string or NULL for none */
+epub_ws_cb(void        *cbdata,		/* I - Callback data (not used) */
+           mxml_node_t *node,		/* I - Element node */
+           mxml_ws_t   where)		/* I - Where value */
+{
+  mxml_node_t	*temp;			/* Temporary node pointer */
+  int		depth;			/* Depth of node */
+  static const char *spaces = "                                        ";
+					/* Whitespace (40 spaces) for indent */
 
-  while (*s && *s != '\n')
+  (void)cbdata;
+
+  switch (where)
   {
-    if (!strncmp(s, "/*", 2))
-    {
-      // Start of a block comment...
-      if (s > start)
-      {
-        // Output current fragment...
-	if (*histate)
-	{
-	  fprintf(fp, "<span class=\"%s\">", class_names[*histate]);
-	  write_string(fp, start, OUTPUT_HTML, s - start);
-	  fputs("</span>", fp);
-	}
-	else
-	{
-	  write_string(fp, start, OUTPUT_HTML, s - start);
-	}
+    case MXML_WS_BEFORE_CLOSE :
+        if ((temp = mxmlGetFirstChild(node)) != NULL && mxmlGetType(temp) != MXML_TYPE_ELEMENT)
+          return (NULL);
 
-	start = s;
-      }
+	for (depth = -4; node; node = mxmlGetParent(node), depth += 2)
+	  ;				// Count the depth
 
-      // At this point, "start" points to the start of the comment...
-      if ((s = strstr(start, "*/")) != NULL)
-      {
-        // Comment ends on the current line...
-        s += 2;
+	if (depth > 40)
+	  return (spaces);
+	else if (depth < 2)
+	  return (NULL);
+	else
+	  return (spaces + 40 - depth);
 
-	fputs("<span class=\"comment\">", fp);
-	write_string(fp, start, OUTPUT_HTML, s - start);
-	fputs("</span>", fp);
+    case MXML_WS_AFTER_CLOSE :
+	return ("\n");
 
-	start    = s;
-	*histate = HIGHLIGHT_NONE;
-      }
-      else
-      {
-        // Comment continues to the next line...
-	s        = start + strlen(start) - 1;
-	*histate = HIGHLIGHT_COMMENT;
-	break;
-      }
-    }
-    else if (*s == '\"' || *s == '\'')
-    {
-      // String/character constant...
-      if (s > start)
-      {
-        // Output current fragment...
-	if (*histate)
-	{
-	  fprintf(fp, "<span class=\"%s\">", class_names[*histate]);
-	  write_string(fp, start, OUTPUT_HTML, s - start);
-	  fputs("</span>", fp);
-	}
+    case MXML_WS_BEFORE_OPEN :
+	for (depth = -4; node; node = mxmlGetParent(node), depth += 2)
+	  ;				// Count the depth
+
+	if (depth > 40)
+	  return (spaces);
+	else if (depth < 2)
+	  return (NULL);
 	else
-	{
-	  write_string(fp, start, OUTPUT_HTML, s - start);
-	}
+	  return (spaces + 40 - depth);
 
-	start = s;
-      }
+    default :
+    case MXML_WS_AFTER_OPEN :
+        if ((temp = mxmlGetFirstChild(node)) != NULL && mxmlGetType(temp) != MXML_TYPE_ELEMENT)
+          return (NULL);
 
-      for (s = start + 1; *s && *s != *start; s ++)
-      {
-        if (*s == '\\' && s[1])
-          s ++;
-      }
+        return ("\n");
+  }
+}
 
-      if (*s == *start)
-        s ++;
 
-      fputs("<span class=\"string\">", fp);
-      write_string(fp, start, OUTPUT_HTML, s - start);
-      fputs("</span>", fp);
+/*
+ * 'filebuf_close()' - Close a file.
+ */
 
-      start = s;
-    }
-    else if (*s == '@' && *histate == HIGHLIGHT_NONE)
-    {
-      // Start of selector
-      if (s > start)
-      {
-        // Output current fragment...
-	write_string(fp, start, OUTPUT_HTML, s - start);
+static void
+filebuf_close(filebuf_t *file)		/* I - File buffer */
+{
+  size_t	i;			/* Looping var */
 
-	start = s;
-      }
 
-      for (s = start + 1; *s && *s != *start; s ++)
-      {
-        if (*s == '{' || *s == ';')
-        {
-          s ++;
-          break;
-        }
-      }
+  free(file->buffer);
 
-      fputs("<span class=\"directive\">", fp);
-      write_string(fp, start, OUTPUT_HTML, s - start);
-      fputs("</span>", fp);
+  for (i = 0; i < file->num_bodytext; i ++)
+    free(file->bodytext[i]);
 
-      start = s;
+  free(file->bodytext);
 
-      if (!*s)
-        *histate = HIGHLIGHT_DIRECTIVE;
+  file->buffer         = NULL;
+  file->bufptr         = NULL;
+  file->bufend         = NULL;
+  file->num_bodytext   = 0;
+  file->alloc_bodytext = 0;
+  file->bodytext       = NULL;
+}
+
+
+/*
+ * 'filebuf_getc()' - Get a UTF-8 character from a file, tracking the line and
+ *                    column.
+ */
+
+static int				/* O - Character or EOF */
+filebuf_getc(filebuf_t *file)		/* I - File buffer */
+{
+  int	ch;				/* Current character */
+
+
+  if (file->ch)
+  {
+    if (file->ch > 0x100)
+    {
+      ch       = (file->ch >> 8) & 255;
+      file->ch = file->ch & 255;
     }
-    else if (*s == '{')
+    else
     {
-      s ++;
+      ch       = file->ch;
+      file->ch = 0;
+    }
 
-      if (s > start)
-      {
-        // Output current fragment...
-	if (*histate)
-	{
-	  fprintf(fp, "<span class=\"%s\">", class_names[*histate]);
-	  write_string(fp, start, OUTPUT_HTML, s - start);
-	  fputs("</span>", fp);
-	}
-	else
-	{
-	  write_string(fp, start, OUTPUT_HTML, s - start);
-	}
+    return (ch);
+  }
 
-	start = s;
-      }
+  if ((ch = filebuf_byte(file)) == EOF)
+    return (EOF);
 
-      *histate = HIGHLIGHT_RESERVED;
-    }
-    else if (*histate == HIGHLIGHT_RESERVED && *s == ':')
+  if (ch & 0x80)
+  {
+    if ((ch & 0xe0) == 0xc0)
     {
-      s ++;
+      int ch2 = filebuf_byte(file);
 
-      fprintf(fp, "<span class=\"%s\">", class_names[*histate]);
-      write_string(fp, start, OUTPUT_HTML, s - start);
-      fputs("</span>", fp);
+      if ((ch2 & 0xc0) != 0x80)
+        goto bad_utf8;
 
-      start    = s;
-      *histate = HIGHLIGHT_NUMBER;
+      ch = ((ch & 0x1f) << 6) | (ch2 & 0x3f);
     }
-    else if (*histate == HIGHLIGHT_NUMBER && *s == ';')
+    else if ((ch & 0xf0) == 0xe0)
     {
-      s ++;
+      int ch2 = filebuf_byte(file);
+      int ch3 = filebuf_byte(file);
 
-      fprintf(fp, "<span class=\"%s\">", class_names[*histate]);
-      write_string(fp, start, OUTPUT_HTML, s - start);
-      fputs("</span>", fp);
+      if ((ch2 & 0xc0) != 0x80 || (ch3 & 0xc0) != 0x80)
+        goto bad_utf8;
 
-      start    = s;
-      *histate = HIGHLIGHT_RESERVED;
+      ch = ((ch & 0x0f) << 12) | ((ch2 & 0x3f) << 6) | (ch3 & 0x3f);
     }
-    else if (*histate == HIGHLIGHT_NUMBER && (*s == '\"' || *s == '\''))
+    else if ((ch & 0xf8) == 0xf0)
     {
-      // String/character constant...
-      if (s > start)
-      {
-        // Output current fragment...
-	if (*histate)
-	{
-	  fprintf(fp, "<span class=\"%s\">", class_names[*histate]);
-	  write_string(fp, start, OUTPUT_HTML, s - start);
-	  fputs("</span>", fp);
-	}
-	else
-	{
-	  write_string(fp, start, OUTPUT_HTML, s - start);
-	}
+      int ch2 = filebuf_byte(file);
+      int ch3 = filebuf_byte(file);
+      int ch4 = filebuf_byte(file);
 
-	start = s;
-      }
+      if ((ch2 & 0xc0) != 0x80 || (ch3 & 0xc0) != 0x80 || (ch4 & 0xc0) != 0x80)
+        goto bad_utf8;
 
-      for (s = start + 1; *s && *s != *start; s ++)
-      {
-        if (*s == '\\' && s[1])
-          s ++;
-      }
+      ch = ((ch & 0x07) << 18) | ((ch2 & 0x3f) << 12) | ((ch3 & 0x3f) << 6) | (ch4 & 0x3f);
+    }
+    else
+      goto bad_utf8;
+  }
 
-      if (*s == *start)
-        s ++;
+  if (ch == 0x7f || ch < 0x07 || ch == 0x08 || (ch > 0x0d && ch < ' '))
+  {
+    fprintf(stderr, "%s:%d(%d) Illegal control character found.\n", file->filename, file->line, file->column);
+    exit(1);
+  }
 
-      fputs("<span class=\"string\">", fp);
-      write_string(fp, start, OUTPUT_HTML, s - start);
-      fputs("</span>", fp);
+  if (ch == 0x09)
+  {
+   /*
+    * Tab...  Traditional tabs are 8 columns...
+    */
 
-      start = s;
-    }
-    else if ((*histate == HIGHLIGHT_RESERVED || *histate == HIGHLIGHT_NUMBER) && *s == '}')
-    {
-      if (s > start)
-      {
-	fprintf(fp, "<span class=\"%s\">", class_names[*histate]);
-	write_string(fp, start, OUTPUT_HTML, s - start);
-	fputs("</span>", fp);
+    file->column = ((file->column + 7) & ~7) + 1;
+  }
+  else if (ch == 0x0a || ch == 0x0c)
+  {
+   /*
+    * Line feed and form feed...
+    */
 
-        start = s;
-      }
+    file->line ++;
+    file->column = 1;
+  }
+  else if (ch == 0x0b)
+  {
+   /*
+    * Vertical tab...
+    */
 
-      *histate = HIGHLIGHT_NONE;
-      s ++;
-    }
-    else if (*s == '}')
-    {
-      if (s > start)
-      {
-        // Output current fragment...
-	if (*histate)
-	{
-	  fprintf(fp, "<span class=\"%s\">", class_names[*histate]);
-	  write_string(fp, start, OUTPUT_HTML, s - start);
-	  fputs("</span>", fp);
-	}
-	else
-	{
-	  write_string(fp, start, OUTPUT_HTML, s - start);
-	}
+    file->line ++;
+  }
+  else if (ch == 0x0d)
+  {
+   /*
+    * Carriage return...
+    */
 
-	start = s;
-      }
+    file->column = 1;
+  }
+  else
+    file->column ++;
 
-      fputs("<span class=\"directive\">}</span>", fp);
+  return (ch);
 
-      s ++;
-      start    = s;
-      *histate = HIGHLIGHT_NONE;
-    }
-    else
-    {
-      s ++;
-    }
-  }
+ /*
+  * If we get here, the UTF-8 sequence is bad...
+  */
 
-  if (s > start)
-  {
-    // Output current fragment...
-    if (*histate)
-    {
-      fprintf(fp, "<span class=\"%s\">", class_names[*histate]);
-      write_string(fp, start, OUTPUT_HTML, s - start);
-      fputs("</span>", fp);
-    }
-    else
-    {
-      write_string(fp, start, OUTPUT_HTML, s - start);
-    }
-  }
+  bad_utf8:
 
-  putc('\n', fp);
+  fprintf(stderr, "%s:%d(%d) Illegal UTF-8 sequence found.\n", file->filename, file->line, file->column);
+  exit(1);
 }
 
 
 /*
- * 'highlight_htmlxml_string()' - Output a string of HTML/XML code, highlighting it as needed.
+ * 'filebuf_inflate()' - Decompress gzip-compressed file contents.
+ *
+ * The compressed contents are replaced by the decompressed contents.  Like
+ * "gunzip", concatenated gzip members are decompressed one after another and
+ * anything after the last member is ignored.
  */
 
-static void
-highlight_htmlxml_string(
-    FILE       *fp,			/* I  - Output file */
-    const char *s,			/* I  - String */
-    int        *histate)		/* IO - Highlighting state */
+static int				/* O - 0 on success, `errno` or `FILEBUF_EGZ` value on failure */
+filebuf_inflate(char   **buffer,	/* IO - File contents */
+                size_t *length)		/* IO - Length of contents */
 {
-  static const char *class_names[] =	/* CSS class names for each state */
-  {
-    NULL,				/* No highlighting, plain text */
-    "comment",				/* Comment text */
-    NULL,				/* One-line comment text */
-    "directive",			/* XML/HTML declaration */
-    "directive",			/* Preprocessor directive/processing instruction */
-    NULL,				/* Number text */
-    "reserved",				/* Reserved word text */
-    NULL				/* String literal text */
-  };
-  const char	*start = s,		/* Start of code to highlight */
-		*class_name = class_names[*histate];
-					/* Class name for current fragment */
+  z_stream	stream;			/* Decompression stream */
+  const unsigned char *in = (const unsigned char *)*buffer,
+					/* Compressed contents */
+		*inend = in + *length;	/* End of compressed contents */
+  char		*data,			/* Decompressed contents */
+		*temp;			/* New contents */
+  size_t	alloc,			/* Allocated bytes */
+		datalen = 0;		/* Decompressed bytes */
+  int		status = Z_OK;		/* Decompression status */
 
 
-  if (*histate == HIGHLIGHT_COMMENT)
-  {
-    if ((s = strstr(start, "-->")) != NULL)
-    {
-     /*
-      * Comment ends on this line...
-      */
+ /*
+  * Start with the uncompressed size (modulo 2^32) from the trailer of the last
+  * member...
+  */
 
-      s += 3;
+  if (*length >= 18)
+    alloc = (size_t)(inend[-4] | (inend[-3] << 8) | (inend[-2] << 16) | ((unsigned)inend[-1] << 24)) + 1;
+  else
+    alloc = 0;
 
-      fputs("<span class=\"comment\">", fp);
-      write_string(fp, start, OUTPUT_HTML, s - start);
-      fputs("</span>", fp);
+  if (alloc < *length)
+    alloc = 4 * *length;
 
-      start      = s;
-      *histate   = HIGHLIGHT_NONE;
-      class_name = NULL;
-    }
-    else
-    {
-     /*
-      * Comment continues beyond the current line...
-      */
+  if ((data = malloc(alloc)) == NULL)
+    return (ENOMEM);
 
-      s = start + strlen(start) - 1;
-    }
+  memset(&stream, 0, sizeof(stream));
+
+  if (inflateInit2(&stream, 16 + MAX_WBITS) != Z_OK)
+  {
+    free(data);
+    return (ENOMEM);
   }
-  else if (*histate == HIGHLIGHT_DIRECTIVE)
+
+  while (status != Z_STREAM_END)
   {
-    if ((s = strstr(start, "?>")) != NULL)
+    if (datalen >= alloc - 1)
     {
-     /*
-      * Processing instruction ends on this line...
-      */
+      if ((temp = realloc(data, 2 * alloc)) == NULL)
+      {
+        status = Z_MEM_ERROR;
+        break;
+      }
 
-      s += 2;
+      data  = temp;
+      alloc *= 2;
+    }
 
-      highlight_string(fp, start, s, class_name);
+    stream.next_in   = (Bytef *)in;
+    stream.avail_in  = (uInt)((size_t)(inend - in) > 0x40000000 ? 0x40000000 : (size_t)(inend - in));
+    stream.next_out  = (Bytef *)data + datalen;
+    stream.avail_out = (uInt)((alloc - datalen - 1) > 0x40000000 ? 0x40000000 : (alloc - datalen - 1));
 
-      start      = s;
-      *histate   = HIGHLIGHT_NONE;
-      class_name = NULL;
-    }
-    else
+    status = inflate(&stream, Z_NO_FLUSH);
+
+    in      = (const unsigned char *)stream.next_in;
+    datalen = (size_t)((char *)stream.next_out - data);
+
+    if (status == Z_STREAM_END && (inend - in) > 2 && in[0] == 0x1f && in[1] == 0x8b)
     {
      /*
-      * Processing instruction continues beyond the current line...
+      * Another member follows...
       */
 
-      s = start + strlen(start) - 1;
+      inflateReset(&stream);
+      status = Z_OK;
     }
+    else if (status == Z_BUF_ERROR && in < inend)
+      status = Z_OK;			/* Need more output space */
+    else if (status != Z_OK && status != Z_STREAM_END)
+      break;
   }
-  else if (*histate == HIGHLIGHT_RESERVED || *histate == HIGHLIGHT_DECLARATION)
+
+  inflateEnd(&stream);
+
+  if (status != Z_STREAM_END)
   {
-    if ((s = strchr(start, '>')) != NULL)
-    {
-     /*
-      * Element/declaration ends on this line...
-      */
+    free(data);
+    return (status == Z_MEM_ERROR ? ENOMEM : status == Z_BUF_ERROR ? FILEBUF_EGZTRUNC : FILEBUF_EGZCORRUPT);
+  }
 
-      s ++;
+  free(*buffer);
 
-      highlight_string(fp, start, s, class_name);
+  *buffer = data;
+  *length = datalen;
 
-      start      = s;
-      *histate   = HIGHLIGHT_NONE;
-      class_name = NULL;
-    }
-    else
-    {
-     /*
-      * Element/declaration continues beyond the current line...
-      */
+  return (0);
+}
 
-      s = start + strlen(start) - 1;
-    }
-  }
 
-  while (*s && *s != '\n')
-  {
-    if (!strncmp(s, "<!--", 4))
-    {
-     /*
-      * Start of a block comment...
-      */
+/*
+ * 'filebuf_open()' - Open a file.
+ *
+ * The file contents come from the prefetch queue when available, otherwise the
+ * file is read here.
+ */
 
-      if (s > start)
-      {
-       /*
-        * Output current fragment...
-        */
+static int				/* O - 1 on success, 0 on failure */
+filebuf_open(filebuf_t  *file,		/* I - File buffer */
+             const char *filename,	/* I - Filename to open */
+             prefetch_t *pf)		/* I - Prefetch queue or `NULL` */
+{
+  char		*buffer = NULL;		/* File contents */
+  size_t	length = 0;		/* Length of contents */
+  int		error;			/* `errno` value */
 
-	if (class_name)
-	{
-	  fprintf(fp, "<span class=\"%s\">", class_name);
-	  write_string(fp, start, OUTPUT_HTML, s - start);
-	  fputs("</span>", fp);
-	}
-	else
-	{
-	  write_string(fp, start, OUTPUT_HTML, s - start);
-	}
 
-	start = s;
-      }
+  if (!prefetch_get(pf, filename, &buffer, &length, &error))
+    error = filebuf_read(filename, &buffer, &length);
 
-     /*
-      * At this point, "start" points to the start of the comment...
-      */
+  filebuf_open_buffer(file, filename, buffer, length);
 
-      if ((s = strstr(start, "-->")) != NULL)
-      {
-       /*
-        * Comment ends on the current line...
-        */
+  if (error)
+  {
+    fprintf(stderr, "%s: %s\n", filename, filebuf_strerror(error));
+    return (0);
+  }
 
-        s += 3;
+  file->buffer = buffer;
 
-	fputs("<span class=\"comment\">", fp);
-	write_string(fp, start, OUTPUT_HTML, s - start);
-	fputs("</span>", fp);
+  return (1);
+}
 
-	start      = s;
-	*histate   = HIGHLIGHT_NONE;
-	class_name = NULL;
-      }
-      else
-      {
-       /*
-        * Comment continues to the next line...
-        */
 
-	s          = start + strlen(start) - 1;
-	*histate   = HIGHLIGHT_COMMENT;
-	class_name = "comment";
-	break;
-      }
-    }
-    else if (!strncmp(s, "<!", 2))
-    {
-     /*
-      * Start of declaration...
-      */
+/*
+ * 'filebuf_open_buffer()' - Open a file whose contents are already in memory.
+ *
+ * The buffer is not copied and must remain valid until the file is closed.
+ */
 
-      if (s > start)
-      {
-       /*
-        * Output current fragment...
-        */
+static void
+filebuf_open_buffer(filebuf_t  *file,	/* I - File buffer */
+                    const char *filename,
+					/* I - Filename */
+                    const char *buffer,	/* I - File contents */
+                    size_t     length)	/* I - Length of contents */
+{
+  file->filename = filename;
+  file->buffer   = NULL;
+  file->bufptr   = buffer;
+  file->bufend   = buffer ? buffer + length : NULL;
+  file->ch       = 0;
+  file->line     = 1;
+  file->column   = 1;
+  file->capture  = false;
 
-	if (class_name)
-	{
-	  fprintf(fp, "<span class=\"%s\">", class_name);
-	  write_string(fp, start, OUTPUT_HTML, s - start);
-	  fputs("</span>", fp);
-	}
-	else
-	{
-	  write_string(fp, start, OUTPUT_HTML, s - start);
-	}
+  file->num_bodytext   = 0;
+  file->alloc_bodytext = 0;
+  file->bodytext       = NULL;
 
-	start = s;
-      }
+  file->garbage         = Garbage;
+  file->split           = NULL;
+  file->complete        = false;
+  file->order_dependent = false;
+}
 
-      if ((s = strchr(start, '>')) != NULL)
-      {
-        s ++;
 
-        highlight_string(fp, start, s, "declaration");
+/*
+ * 'filebuf_read()' - Read the contents of a file into memory.
+ */
 
-	start      = s;
-	*histate   = HIGHLIGHT_NONE;
-	class_name = NULL;
-      }
-      else
-      {
-	s          = start + strlen(start) - 1;
-	*histate   = HIGHLIGHT_DECLARATION;
-	class_name = "declaration";
-	break;
-      }
-    }
-    else if (!strncmp(s, "<?", 2))
-    {
-     /*
-      * Start of processing instruction...
-      */
+static int				/* O - 0 on success, `errno` or `FILEBUF_EGZ` value on failure */
+filebuf_read(const char *filename,	/* I - Filename to read */
+             char       **buffer,	/* O - File contents */
+             size_t     *length)	/* O - Length of contents */
+{
+  FILE		*fp;			/* File pointer */
+  struct stat	fileinfo;		/* File information */
+  size_t	alloc;			/* Allocated bytes */
+  int		error;			/* `errno` value */
 
-      if (s > start)
-      {
-       /*
-        * Output current fragment...
-        */
 
-	if (class_name)
-	{
-	  fprintf(fp, "<span class=\"%s\">", class_name);
-	  write_string(fp, start, OUTPUT_HTML, s - start);
-	  fputs("</span>", fp);
-	}
-	else
-	{
-	  write_string(fp, start, OUTPUT_HTML, s - start);
-	}
+  *buffer = NULL;
+  *length = 0;
 
-	start = s;
-      }
+  if ((fp = fopen(filename, "rb")) == NULL)
+    return (errno);
 
-      if ((s = strstr(start, "?>")) != NULL)
-      {
-        s += 2;
+ /*
+  * Size the buffer from the file when we can, otherwise grow as needed...
+  */
 
+  if (!fstat(fileno(fp), &fileinfo) && (fileinfo.st_mode & S_IFMT) == S_IFREG && fileinfo.st_size > 0)
+    alloc = (size_t)fileinfo.st_size + 1;
+  else
+    alloc = 65536;
 
-        highlight_string(fp, start, s, "directive");
+  error = filebuf_read_fp(fp, alloc, buffer, length);
 
-	start      = s;
-	*histate   = HIGHLIGHT_NONE;
-	class_name = NULL;
-      }
-      else
-      {
-	s          = start + strlen(start) - 1;
-	*histate   = HIGHLIGHT_DIRECTIVE;
-	class_name = "directive";
-	break;
-      }
-    }
-    else if (*s == '<')
-    {
-     /*
-      * Start of element...
-      */
+  fclose(fp);
 
-      if (s > start)
-      {
-       /*
-        * Output current fragment...
-        */
+  if (!error && *length > 2 && ((*buffer)[0] & 255) == 0x1f && ((*buffer)[1] & 255) == 0x8b)
+    error = filebuf_inflate(buffer, length);
 
-	if (class_name)
-	{
-	  fprintf(fp, "<span class=\"%s\">", class_name);
-	  write_string(fp, start, OUTPUT_HTML, s - start);
-	  fputs("</span>", fp);
-	}
-	else
-	{
-	  write_string(fp, start, OUTPUT_HTML, s - start);
-	}
+  return (error);
+}
 
-	start = s;
-      }
 
-      if ((s = strchr(start, '>')) != NULL)
-      {
-        s ++;
+/*
+ * 'filebuf_read_fp()' - Read the rest of a stdio file into memory.
+ *
+ * Any existing contents in the buffer are kept and the new data is appended.
+ * The buffer is freed on error.
+ */
 
-        highlight_string(fp, start, s, "reserved");
+static int				/* O - 0 on success, `errno` value on failure */
+filebuf_read_fp(FILE   *fp,		/* I  - File pointer */
+                size_t alloc,		/* I  - Initial size of buffer */
+                char   **buffer,	/* IO - File contents */
+                size_t *length)		/* IO - Length of contents */
+{
+  char		*data,			/* File contents */
+		*temp;			/* New contents */
+  size_t	datalen = *length,	/* Bytes read */
+		bytes;			/* Bytes in this read */
+  int		error = 0;		/* `errno` value */
 
-	start      = s;
-	*histate   = HIGHLIGHT_NONE;
-	class_name = NULL;
-      }
-      else
-      {
-	s          = start + strlen(start) - 1;
-	*histate   = HIGHLIGHT_RESERVED;
-	class_name = "reserved";
-	break;
-      }
-    }
-    else
+
+  if (alloc <= datalen)
+    alloc = datalen + 65536;
+
+  if ((data = realloc(*buffer, alloc)) == NULL)
+  {
+    error = errno;
+    free(*buffer);
+    *buffer = NULL;
+    *length = 0;
+    return (error);
+  }
+
+  while ((bytes = fread(data + datalen, 1, alloc - datalen, fp)) > 0)
+  {
+    if ((datalen += bytes) < alloc)
+      continue;
+
+    if ((temp = realloc(data, 2 * alloc)) == NULL)
     {
-      s ++;
+      error = errno;
+      break;
     }
+
+    data  = temp;
+    alloc *= 2;
   }
 
-  if (s > start)
+  if (!error && ferror(fp))
+    error = errno ? errno : EIO;
+
+  if (error)
   {
-    if (class_name)
-      highlight_string(fp, start, s, class_name);
-    else
-      write_string(fp, start, OUTPUT_HTML, s - start);
+    free(data);
+    data    = NULL;
+    datalen = 0;
   }
 
-  putc('\n', fp);
+  *buffer = data;
+  *length = datalen;
+
+  return (error);
 }
 
 
 /*
- * 'highlight_string()' - Highlight quoted strings.
+ * 'filebuf_strerror()' - Return a message for an error from @link filebuf_read@.
  */
 
-static void
-highlight_string(FILE       *fp,	/* I - Output file */
-                 const char *start,	/* I - Start of substring */
-                 const char *end,	/* I - End of substring */
-                 const char *class_name)/* I - Class name for main content */
+static const char *			/* O - Error message */
+filebuf_strerror(int error)		/* I - `errno` or `FILEBUF_EGZ` value */
 {
-  const char	*ptr;			/* Pointer into substring */
-
-
-  for (ptr = start; ptr < end; ptr ++)
-  {
-    if (*ptr == '\'' || *ptr == '\"')
-    {
-      if (ptr > start)
-      {
-	fprintf(fp, "<span class=\"%s\">", class_name);
-	write_string(fp, start, OUTPUT_HTML, ptr - start);
-	fputs("</span>", fp);
-      }
-
-      start = ptr;
-
-      for (ptr ++; ptr < end && *ptr != *start; ptr ++)
-        ;				/* Loop until close quote */
-
-      if (ptr < end)
-        ptr ++;
+  if (error == FILEBUF_EGZCORRUPT)
+    return ("Corrupt gzip-compressed data");
+  else if (error == FILEBUF_EGZTRUNC)
+    return ("Truncated gzip-compressed data");
+  else
+    return (strerror(error));
+}
 
-      fputs("<span class=\"string\">", fp);
-      write_string(fp, start, OUTPUT_HTML, ptr - start);
-      fputs("</span>", fp);
 
-      start = ptr;
-    }
-  }
+/*
+ * 'filebuf_ungetc()' - Save the previous character read from a file.
+ */
 
-  if (ptr > start)
-  {
-    fprintf(fp, "<span class=\"%s\">", class_name);
-    write_string(fp, start, OUTPUT_HTML, ptr - start);
-    fputs("</span>", fp);
-  }
+static void
+filebuf_ungetc(filebuf_t *file,		/* I - File buffer */
+               int       ch)		/* I - Character to save */
+{
+  file->ch = ch;
 }
 
 
 /*
- * 'html_gets()' - Get a HTML fragment.
- *
- * Returns a HTML fragment like "<element attr='value'>", "some text", and
- * "</element>".
+ * 'find_public()' - Find a public function, type, etc.
  */
 
-static char *				/* O - Attribute or `NULL` */
-html_gets(FILE	 *fp,			/* I - File to read from */
-	  char	 *fragment,		/* I - Fragment string buffer */
-	  size_t fragsize)		/* I - Size of buffer */
+static mxml_node_t *			/* I - Found node or NULL */
+find_public(mxml_node_t *node,		/* I - Current node */
+            mxml_node_t *top,		/* I - Top node */
+            const char  *element,	/* I - Element */
+            const char  *name,		/* I - Name */
+            int         mode)           /* I - Output mode */
 {
-  int	ch;				/* Current character */
-  char	*fragptr,			/* Pointer into buffer */
-	*fragend;			/* Pointer to end of buffer */
-
-
- /*
-  * Read the fragment...
-  */
+  mxml_node_t	*description,		/* Description node */
+		*comment;		/* Comment node */
 
-  fragptr = fragment;
-  fragend = fragment + fragsize - 1;
 
-  if ((ch = getc(fp)) == EOF)
+  for (node = mxmlFindElement(node, top, element, name ? "name" : NULL, name, node == top ? MXML_DESCEND_FIRST : MXML_DESCEND_NONE);
+       node;
+       node = mxmlFindElement(node, top, element, name ? "name" : NULL, name, MXML_DESCEND_NONE))
   {
-    *fragment = '\0';
-    return (NULL);
-  }
+   /*
+    * Get the description for this node...
+    */
 
-  *fragptr++ = (char)ch;
+    description = mxmlFindElement(node, node, "description", NULL, NULL, MXML_DESCEND_FIRST);
 
-  if (ch == '<')
-  {
    /*
-    * Read element or comment...
+    * A missing or empty description signals a private node...
     */
 
-    while ((ch = getc(fp)) != EOF)
-    {
-      if (fragptr < fragend)
-	*fragptr++ = (char)ch;
-
-      if (ch == '>')
-      {
-       /*
-        * End of element/comment/processing directive...
-        */
-
-	break;
-      }
-      else if (ch == '\"' || ch == '\'')
-      {
-       /*
-	* Read quoted string...
-	*/
-
-	int quote = ch;
-
-	while ((ch = getc(fp)) != EOF)
-	{
-	  if (fragptr < fragend)
-	    *fragptr++ = (char)ch;
-
-	  if (ch == quote)
-	    break;
-	}
-      }
-    }
+    if (!description)
+      continue;
 
-    *fragptr = '\0';
-  }
-  else
-  {
    /*
-    * Read text...
+    * Look for @private@ or @exclude format@ in the comment text...
     */
 
-    while ((ch = getc(fp)) != EOF)
+    for (comment = mxmlGetFirstChild(description); comment; comment = mxmlGetNextSibling(comment))
     {
-      if (ch == '<')
-      {
-	ungetc(ch, fp);
-	break;
-      }
-      else if (fragptr < fragend)
-	*fragptr++ = (char)ch;
-    }
-
-    *fragptr = '\0';
-
-    html_unescape(fragment);
-  }
-
-  return (fragment);
-}
-
-
-/*
- * 'html_unescape()' - Replace &foo; with corresponding characters.
- */
-
-static void
-html_unescape(char *buffer)		/* I - Buffer */
-{
-  char	*inptr,				/* Current input pointer */
-	*outptr;			/* Current output pointer */
-
+      const char *s = mxmlGetType(comment) == MXML_TYPE_TEXT ? mxmlGetText(comment, NULL) : mxmlGetOpaque(comment);
+      const char *exclude;
 
- /*
-  * See if there are any escaped characters to work with...
-  */
+     /*
+      * Skip anything marked private...
+      */
 
-  if ((inptr = strchr(buffer, '&')) == NULL)
-    return;				/* Nope */
+      if (strstr(s, "@private@"))
+        break;
 
-  for (outptr = inptr; *inptr;)
-  {
-    if (*inptr == '&' && strchr(inptr + 1, ';'))
-    {
      /*
-      * Figure out what kind of escaped character we have...
+      * Skip items excluded for certain formats...
       */
 
-      inptr ++;
-      if (!strncmp(inptr, "amp;", 4))
-      {
-	inptr += 4;
-	*outptr++ = '&';
-      }
-      else if (!strncmp(inptr, "lt;", 3))
-      {
-	inptr += 3;
-	*outptr++ = '<';
-      }
-      else if (!strncmp(inptr, "gt;", 3))
-      {
-	inptr += 3;
-	*outptr++ = '>';
-      }
-      else if (!strncmp(inptr, "quot;", 5))
-      {
-	inptr += 5;
-	*outptr++ = '\"';
-      }
-      else if (!strncmp(inptr, "apos;", 5))
-      {
-	inptr += 5;
-	*outptr++ = '\'';
-      }
-      else if (*inptr == '#')
+      if ((exclude = strstr(s, "@exclude ")) != NULL)
       {
-       /*
-	* Numeric, copy character over as UTF-8...
-	*/
-
-	int ch;				/* Numeric character value */
-
-	inptr ++;
-	if (*inptr == 'x')
-	  ch = (int)strtol(inptr, NULL, 16);
-	else
-	  ch = (int)strtol(inptr, NULL, 10);
-
-	if (ch < 0x80)
-	{
-	 /*
-	  * US ASCII
-	  */
-
-	  *outptr++ = ch;
-	}
-	else if (ch < 0x800)
-	{
-	 /*
-	  * Two-byte UTF-8
-	  */
-
-	  *outptr++ = 0xc0 | (ch >> 6);
-	  *outptr++ = 0x80 | (ch & 0x3f);
-	}
-	else if (ch < 0x10000)
-	{
-	 /*
-	  * Three-byte UTF-8
-	  */
-
-	  *outptr++ = 0xe0 | (ch >> 12);
-	  *outptr++ = 0x80 | ((ch >> 6) & 0x3f);
-	  *outptr++ = 0x80 | (ch & 0x3f);
-	}
-	else
-	{
-	 /*
-	  * Four-byte UTF-8
-	  */
+        exclude += 9;
 
-	  *outptr++ = 0xf0 | (ch >> 18);
-	  *outptr++ = 0x80 | ((ch >> 12) & 0x3f);
-	  *outptr++ = 0x80 | ((ch >> 6) & 0x3f);
-	  *outptr++ = 0x80 | (ch & 0x3f);
-	}
+        if (!strncmp(exclude, "all@", 4))
+        {
+          break;
+        }
+        else
+        {
+          while (*exclude != '@')
+          {
+            if (!strncmp(exclude, "docset", 6))
+            {
+              /* Legacy, no longer supported */
+              exclude += 6;
+            }
+            else if (!strncmp(exclude, "epub", 4))
+            {
+              if (mode == OUTPUT_EPUB)
+                break;
+              exclude += 4;
+            }
+            else if (!strncmp(exclude, "html", 4))
+            {
+              if (mode == OUTPUT_HTML)
+                break;
+              exclude += 4;
+            }
+            else if (!strncmp(exclude, "man", 3))
+            {
+              if (mode == OUTPUT_MAN)
+                break;
+              exclude += 3;
+            }
+            else if (!strncmp(exclude, "tokens", 6))
+            {
+              /* Legacy, no longer supported */
+              exclude += 6;
+            }
+            else if (!strncmp(exclude, "xml", 3))
+            {
+              if (mode == OUTPUT_XML)
+                break;
+              exclude += 3;
+            }
+            else
+              break;
 
-	inptr = strchr(inptr, ';') + 1;
-      }
-      else
-      {
-       /*
-	* Something else not supported by XML...
-	*/
+            if (*exclude == ',')
+              exclude ++;
+            else if (*exclude != '@')
+              break;
+          }
 
-	*outptr++ = '&';
+          if (*exclude != '@')
+            break;
+        }
       }
     }
-    else
+
+    if (!comment)
     {
      /*
-      * Copy literal...
+      * No @private@, so return this node...
       */
 
-      *outptr++ = *inptr++;
+      return (node);
     }
   }
 
-  *outptr = '\0';
+ /*
+  * If we get here, there are no (more) public nodes...
+  */
+
+  return (NULL);
 }
 
 
 /*
- * 'is_markdown()' - Determine whether a file is markdown text.
+ * 'free_toc()' - Free a table-of-contents.
  */
 
-static bool				/* O - `true` if markdown, `false` otherwise */
-is_markdown(const char *filename)	/* I - File to check */
+static void
+free_toc(toc_t *toc)			/* I - Table of contents */
 {
-  const char	*ext = filename ? strstr(filename, ".md") : NULL;
-					/* Pointer to extension */
-
-  return (ext && !ext[3]);
+  free(toc->entries);
+  free(toc);
 }
 
 
 /*
- * 'is_reserved()' - Determine whether a word is a C/C++ reserved word.
+ * 'get_comment_info()' - Get info from comment.
  */
 
-static bool				/* O - `true` if reserved, `false` otherwise */
-is_reserved(const char *word)		/* I - Word */
+static char *				/* O - Info from comment */
+get_comment_info(
+    mxml_node_t *description)		/* I - Description node */
 {
-  return (bsearch(&word, reserved_words, sizeof(reserved_words) / sizeof(reserved_words[0]), sizeof(const char *), (int (*)(const void *, const void *))reserved_compare) != NULL);
-}
-
-
-/*
- * 'markdown_anchor()' - Return the HTML anchor for a given title.
- */
-
-static const char *			/* O - HTML anchor */
-markdown_anchor(const char *text)	/* I - Title text */
-{
-  char          *bufptr;                /* Pointer into buffer */
-  static char   buffer[1024];           /* Buffer for anchor string */
+  char		text[10240],		/* Description text */
+		since[255],		/* @since value */
+		*ptr;			/* Pointer into text */
+  static char	info[1024];		/* Info string */
 
 
-  if (!text)
+  if (!description)
     return ("");
 
-  for (bufptr = buffer; *text && bufptr < (buffer + sizeof(buffer) - 1); text ++)
+  get_text(description, text, sizeof(text));
+
+  for (ptr = strchr(text, '@'); ptr; ptr = strchr(ptr + 1, '@'))
   {
-    if ((*text >= '0' && *text <= '9') || (*text >= 'a' && *text <= 'z') || (*text >= 'A' && *text <= 'Z') || *text == '.' || *text == '-')
-      *bufptr++ = (char)tolower(*text);
-    else if (*text == ' ')
-      *bufptr++ = '-';
-  }
+    if (!strncmp(ptr, "@deprecated@", 12))
+      return ("<span class=\"info\">&#160;DEPRECATED&#160;</span>");
+    else if (!strncmp(ptr, "@since ", 7))
+    {
+      strlcpy(since, ptr + 7, sizeof(since));
 
-  *bufptr = '\0';
+      if ((ptr = strchr(since, '@')) != NULL)
+        *ptr = '\0';
 
-  return (buffer);
+      snprintf(info, sizeof(info), "<span class=\"info\">&#160;%s&#160;</span>", since);
+      return (info);
+    }
+  }
+
+  return ("");
 }
 
 
 /*
- * 'markdown_write_block()' - Write a markdown block.
+ * 'get_default()' - Get a value, falling back on the body metadata and then a
+ *                   default value.
  */
 
-static void
-markdown_write_block(FILE  *out,	/* I - Output file */
-                     mmd_t *parent,	/* I - Parent node */
-                     int   mode)	/* I - Output mode */
+static const char *			/* O - Value */
+get_default(const char *value,		/* I - Value or `NULL` */
+            mmd_t      *body,		/* I - Body markdown or `NULL` */
+            const char *keyword,	/* I - Metadata keyword */
+            const char *defvalue)	/* I - Default value */
 {
-  mmd_t		*node;			/* Current child node */
-  mmd_type_t	type;			/* Node type */
-  int		histate;		/* Highlighting state */
-
-
-  type = mmdGetType(parent);
-
-  if (mode == OUTPUT_MAN)
-  {
-    switch (type)
-    {
-      case MMD_TYPE_BLOCK_QUOTE :
-          break;
+  if (!value)
+    value = mmdGetMetadata(body, keyword);
+  if (!value)
+    value = defvalue;
 
-      case MMD_TYPE_ORDERED_LIST :
-          break;
+  return (value);
+}
 
-      case MMD_TYPE_UNORDERED_LIST :
-          break;
 
-      case MMD_TYPE_LIST_ITEM :
-          fputs(".IP \\(bu 5\n", out);
-          break;
+/*
+ * 'get_iso_date()' - Get an ISO-formatted date/time string.
+ */
 
-      case MMD_TYPE_HEADING_1 :
-          fputs(".SH ", out);
-          break;
+static char *				/* O - ISO date/time string */
+get_iso_date(time_t t)			/* I - Time value */
+{
+  struct tm	date;			/* UTC date/time */
+  static char	buffer[100];		/* String buffer */
 
-      case MMD_TYPE_HEADING_2 :
-          fputs(".SS ", out);
-          break;
 
-      case MMD_TYPE_HEADING_3 :
-      case MMD_TYPE_HEADING_4 :
-      case MMD_TYPE_HEADING_5 :
-      case MMD_TYPE_HEADING_6 :
-      case MMD_TYPE_PARAGRAPH :
-          fputs(".PP\n", out);
-          break;
+  gmtime_r(&t, &date);
 
-      case MMD_TYPE_CODE_BLOCK :
-          fputs(".nf\n\n", out);
-          for (node = mmdGetFirstChild(parent); node; node = mmdGetNextSibling(node))
-          {
-            fputs("    ", out);
-            write_string(out, mmdGetText(node), mode, 0);
-          }
-          fputs(".fi\n", out);
-          return;
+  snprintf(buffer, sizeof(buffer), "%04d-%02d-%02dT%02d:%02d:%02dZ", date.tm_year + 1900, date.tm_mon + 1, date.tm_mday, date.tm_hour, date.tm_min, date.tm_sec);
 
-      case MMD_TYPE_METADATA :
-          return;
+  return (buffer);
+}
 
-      default :
-          break;
-    }
 
-    for (node = mmdGetFirstChild(parent); node; node = mmdGetNextSibling(node))
-    {
-      if (mmdIsBlock(node))
-        markdown_write_block(out, node, mode);
-      else
-        markdown_write_leaf(out, node, mode);
-    }
+/*
+ * 'get_nth_child()' - Get the Nth child node.
+ */
 
-    fputs("\n", out);
+static mxml_node_t *			/* O - Child node or NULL */
+get_nth_child(mxml_node_t *node,	/* I - Parent node */
+              int         idx)		/* I - Child node index (negative to index from end) */
+{
+  if (idx < 0)
+  {
+    for (node = mxmlGetLastChild(node); node && idx < -1; idx ++)
+      node = mxmlGetPrevSibling(node);
   }
   else
   {
-    const char	*element,		/* Enclosing element, if any */
-		*class_name = NULL;	/* Class name, if any */
-
-    switch (type)
-    {
-      case MMD_TYPE_BLOCK_QUOTE :
-          element = "blockquote";
-          break;
-
-      case MMD_TYPE_ORDERED_LIST :
-          element = "ol";
-          break;
-
-      case MMD_TYPE_UNORDERED_LIST :
-          element = "ul";
-          break;
-
-      case MMD_TYPE_LIST_ITEM :
-          element = "li";
-          break;
-
-      case MMD_TYPE_HEADING_1 :
-          element    = "h2"; /* Offset since title is H1 for codedoc output */
-          class_name = "title";
-          break;
-
-      case MMD_TYPE_HEADING_2 :
-          element    = "h3"; /* Offset since title is H1 for codedoc output */
-          class_name = "title";
-          break;
-
-      case MMD_TYPE_HEADING_3 :
-          element = "h4"; /* Offset since title is H1 for codedoc output */
-          break;
-
-      case MMD_TYPE_HEADING_4 :
-          element = "h5"; /* Offset since title is H1 for codedoc output */
-          break;
+    for (node = mxmlGetFirstChild(node); node && idx > 0; idx --)
+      node = mxmlGetNextSibling(node);
+  }
 
-      case MMD_TYPE_HEADING_5 :
-          element = "h6"; /* Offset since title is H1 for codedoc output */
-          break;
+  return (node);
+}
 
-      case MMD_TYPE_HEADING_6 :
-          element = "h6";
-          break;
 
-      case MMD_TYPE_PARAGRAPH :
-          element = "p";
-          break;
+/*
+ * 'get_nth_text()' - Get the text string from the Nth child node.
+ */
 
-      case MMD_TYPE_CODE_BLOCK :
-          if ((class_name = mmdGetExtra(parent)) != NULL)
-	    fprintf(out, "<pre><code class=\"language-%s\">", class_name);
-	  else
-	    fputs("<pre><code>", out);
+static const char *			/* O - String value or NULL */
+get_nth_text(mxml_node_t *node,		/* I - Parent node */
+             int         idx,		/* I - Child node index (negative to index from end) */
+             bool        *whitespace)	/* O - Whitespace value (NULL for don't care) */
+{
+  return (mxmlGetText(get_nth_child(node, idx), whitespace));
+}
 
-          for (node = mmdGetFirstChild(parent), histate = HIGHLIGHT_NONE; node; node = mmdGetNextSibling(node))
-          {
-            if (class_name && (!strcmp(class_name, "c") || !strcmp(class_name, "cpp")))
-              highlight_c_string(out, mmdGetText(node), &histate);
-            else if (class_name && !strcmp(class_name, "css"))
-              highlight_css_string(out, mmdGetText(node), &histate);
-            else if (class_name && (!strcmp(class_name, "html") || !strcmp(class_name, "xml")))
-              highlight_htmlxml_string(out, mmdGetText(node), &histate);
-            else
-              write_string(out, mmdGetText(node), mode, 0);
-	  }
-          fputs("</code></pre>\n", out);
-          return;
 
-      case MMD_TYPE_THEMATIC_BREAK :
-          if (mode == OUTPUT_EPUB)
-            fputs("<hr />\n", out);
-          else
-            fputs("<hr>\n", out);
-          return;
+/*
+ * 'get_relative_path()' - Get the path of a directory relative to another
+ *                         directory.
+ *
+ * Both directories must exist.  If either cannot be resolved, the "to" path
+ * is returned unchanged.
+ */
 
-      case MMD_TYPE_TABLE :
-	  element = "table";
-	  break;
+static char *				/* O - Relative path */
+get_relative_path(const char *from,	/* I - Directory to start from */
+                  const char *to,	/* I - Directory to reach */
+                  char       *buffer,	/* I - Path buffer */
+                  size_t     bufsize)	/* I - Size of path buffer */
+{
+  char		*absfrom,		/* Absolute "from" directory */
+		*absto;			/* Absolute "to" directory */
+  const char	*ptr;			/* Pointer into directories */
+  size_t	i,			/* Looping var */
+		common;			/* Length of common parent directory */
 
-      case MMD_TYPE_TABLE_HEADER :
-	  element = "thead";
-	  break;
 
-      case MMD_TYPE_TABLE_BODY :
-	  element = "tbody";
-	  break;
+  absfrom = realpath(from, NULL);
+  absto   = realpath(to, NULL);
 
-      case MMD_TYPE_TABLE_ROW :
-	  element = "tr";
-	  break;
+  if (!absfrom || !absto)
+  {
+    free(absfrom);
+    free(absto);
+    strlcpy(buffer, to, bufsize);
+    return (buffer);
+  }
 
-      case MMD_TYPE_TABLE_HEADER_CELL :
-	  element = "th";
-	  break;
+ /*
+  * Find the longest common parent directory...
+  */
 
-      case MMD_TYPE_TABLE_BODY_CELL_LEFT :
-	  element = "td";
-	  break;
+  for (i = 0, common = 0; absfrom[i] && absfrom[i] == absto[i]; i ++)
+  {
+    if (absfrom[i] == '/')
+      common = i;
+  }
 
-      case MMD_TYPE_TABLE_BODY_CELL_CENTER :
-	  element    = "td";
-	  class_name = "center";
-	  break;
+  if ((!absfrom[i] || absfrom[i] == '/') && (!absto[i] || absto[i] == '/'))
+    common = i;
 
-      case MMD_TYPE_TABLE_BODY_CELL_RIGHT :
-	  element    = "td";
-	  class_name = "right";
-	  break;
+ /*
+  * Go up once for each remaining "from" directory, then down the remaining
+  * "to" directories...
+  */
 
-      default :
-          element = NULL;
-          break;
-    }
+  *buffer = '\0';
 
-    if (type >= MMD_TYPE_HEADING_1 && type <= MMD_TYPE_HEADING_6)
-    {
-     /*
-      * Add an anchor...
-      */
+  for (ptr = absfrom + common; *ptr; ptr ++)
+  {
+    if (*ptr != '/' && (ptr == absfrom || ptr[-1] == '/'))
+      strlcat(buffer, "../", bufsize);
+  }
 
-      if (class_name)
-	fprintf(out, "<%s class=\"%s\" id=\"", element, class_name);
-      else
-	fprintf(out, "<%s id=\"", element);
-      for (node = mmdGetFirstChild(parent); node; node = mmdGetNextSibling(node))
-      {
-        if (mmdGetWhitespace(node))
-          fputc('-', out);
+  for (ptr = absto + common; *ptr == '/'; ptr ++);
 
-        fputs(markdown_anchor(mmdGetText(node)), out);
-      }
-      fputs("\">", out);
-    }
-    else if (element)
-    {
-      if (class_name)
-	fprintf(out, "<%s class=\"%s\">", element, class_name);
-      else
-	fprintf(out, "<%s>%s", element, type <= MMD_TYPE_UNORDERED_LIST ? "\n" : "");
-    }
+  if (*ptr)
+    strlcat(buffer, ptr, bufsize);
+  else if (*buffer)
+    buffer[strlen(buffer) - 1] = '\0';
+  else
+    strlcpy(buffer, ".", bufsize);
 
-    for (node = mmdGetFirstChild(parent); node; node = mmdGetNextSibling(node))
-    {
-      if (mmdIsBlock(node))
-        markdown_write_block(out, node, mode);
-      else
-        markdown_write_leaf(out, node, mode);
-    }
+  free(absfrom);
+  free(absto);
 
-    if (element)
-      fprintf(out, "</%s>\n", element);
-  }
+  return (buffer);
 }
 
 
 /*
- * 'markdown_write_leaf()' - Write an leaf markdown node.
+ * 'get_text()' - Get the text for a node.
  */
 
-static void
-markdown_write_leaf(FILE  *out,		/* I - Output file */
-                    mmd_t *node,	/* I - Node to write */
-                    int   mode)		/* I - Output mode */
+static char *				/* O - Text in node */
+get_text(mxml_node_t *node,		/* I - Node to get */
+         char        *buffer,		/* I - Buffer */
+	 int         buflen)		/* I - Size of buffer */
 {
-  mmd_type_t	type,			/* Current leaf node type */
-		prev_type,		/* Previous leaf node type */
-		next_type;		/* Next leaf node type */
-  const char	*text,			/* Text to write */
-		*url;			/* URL to write */
-  char		temp[1024],		/* Temporary string for text + width */
-		*widthspec,		/* Pointer to width specification, if any */
-		*heightspec;		/* Pointer to height specification, if any */
+  char		*ptr,			/* Pointer into buffer */
+		*end;			/* End of buffer */
+  size_t	len;			/* Length of node */
+  mxml_node_t	*current;		/* Current node */
 
 
-  type  = mmdGetType(node);
-  text  = mmdGetText(node);
-  url   = mmdGetURL(node);
+  ptr = buffer;
+  end = buffer + buflen - 1;
 
-  if (mode == OUTPUT_MAN)
+  for (current = mxmlGetFirstChild(node); current && ptr < end; current = mxmlGetNextSibling(current))
   {
-    const char *suffix = NULL;		/* Trailing string */
+    mxml_type_t type = mxmlGetType(current);
 
-    switch (type)
+    if (type == MXML_TYPE_TEXT)
     {
-      case MMD_TYPE_EMPHASIZED_TEXT :
-          if (mmdGetWhitespace(node))
-            fputc('\n', out);
-
-          fputs(".I ", out);
-          suffix = "\n";
-          break;
-
-      case MMD_TYPE_STRONG_TEXT :
-          if (mmdGetWhitespace(node))
-            fputc('\n', out);
+      bool whitespace;
+      const char *string = mxmlGetText(current, &whitespace);
 
-          fputs(".B ", out);
-          suffix = "\n";
-          break;
+      if (whitespace)
+        *ptr++ = ' ';
 
-      case MMD_TYPE_HARD_BREAK :
-          if (mmdGetWhitespace(node))
-            fputc('\n', out);
+      len = strlen(string);
+      if (len > (size_t)(end - ptr))
+        len = (size_t)(end - ptr);
 
-          fputs(".PP\n", out);
-          return;
+      memcpy(ptr, string, len);
+      ptr += len;
+    }
+    else if (type == MXML_TYPE_OPAQUE)
+    {
+      const char *opaque = mxmlGetOpaque(current);
 
-      case MMD_TYPE_SOFT_BREAK :
-      case MMD_TYPE_METADATA_TEXT :
-          return;
+      len = strlen(opaque);
+      if (len > (size_t)(end - ptr))
+        len = (size_t)(end - ptr);
 
-      default :
-          if (mmdGetWhitespace(node))
-            fputc(' ', out);
-          break;
+      memcpy(ptr, opaque, len);
+      ptr += len;
     }
+  }
 
-    write_string(out, text, mode, 0);
+  *ptr = '\0';
 
-    if (suffix)
-      fputs(suffix, out);
-  }
-  else
-  {
-    const char	*element;		/* Encoding element, if any */
+  return (buffer);
+}
 
-    if (mmdGetWhitespace(node))
-      fputc(' ', out);
 
-    switch (type)
-    {
-      case MMD_TYPE_EMPHASIZED_TEXT :
-          element = "em";
-          break;
+/*
+ * 'highlight_c_string()' - Output a string of C code, highlighting it as needed.
+ */
 
-      case MMD_TYPE_STRONG_TEXT :
-          element = "strong";
-          break;
+static void
+highlight_c_string(FILE       *fp,	/* I  - Output file */
+                   const char *s,	/* I  - String */
+                   int        *histate)	/* IO - Highlighting state */
+{
+  const char	*start = s,		/* Start of code to highlight */
+		*class_name = (*histate == HIGHLIGHT_COMMENT) ? "comment" : NULL;
+					/* Class name for current fragment */
+  char		keyword[32],		/* Current keyword */
+		*keyptr = keyword;	/* Pointer into keyword */
 
-      case MMD_TYPE_STRUCK_TEXT :
-          element = "del";
-          break;
 
-      case MMD_TYPE_LINKED_TEXT :
-          element = NULL;
-          break;
+  if (*histate == HIGHLIGHT_COMMENT)
+  {
+    if ((s = strstr(start, "*/")) != NULL)
+    {
+     /*
+      * Comment ends on this line...
+      */
 
-      case MMD_TYPE_CODE_TEXT :
-          element = "code";
-          break;
+      s += 2;
 
-      case MMD_TYPE_IMAGE :
-          fputs("<img src=\"", out);
-          if (strncmp(url, "http://", 7) && strncmp(url, "https://", 8))
-          {
-           /*
-            * Local file so strip any directory info...
-            */
+      fputs("<span class=\"comment\">", fp);
+      write_string(fp, start, OUTPUT_HTML, s - start);
+      fputs("</span>", fp);
 
-            const char	*baseurl;	/* Base name of URL */
+      start      = s;
+      *histate   = HIGHLIGHT_NONE;
+      class_name = NULL;
+    }
+    else if (*start)
+    {
+     /*
+      * Comment continues beyond the current line...
+      */
 
+      s = start + strlen(start) - 1;
+    }
+    else
+    {
+      goto done;
+    }
+  }
+  else if (*s == '#')
+  {
+   /*
+    * Preprocessor directive...
+    */
 
-            if ((baseurl = strrchr(url, '/')) != NULL)
-              baseurl ++;
-            else
-              baseurl = url;
+    while (*s && *s != '\n')
+    {
+      if (!strncmp(s, "/*", 2) || !strncmp(s, "//", 2))
+        break;
 
-	    write_string(out, baseurl, mode, 0);
-	  }
-	  else
-	  {
-	   /*
-	    * Remote URL so use as-is...
-	    */
+      s ++;
+    }
 
-	    write_string(out, url, mode, 0);
-	  }
+    fputs("<span class=\"directive\">", fp);
+    write_string(fp, start, OUTPUT_HTML, s - start);
+    fputs("</span>", fp);
 
-          strncpy(temp, text, sizeof(temp) - 1);
-          temp[sizeof(temp) - 1] = '\0';
+    start = s;
+  }
 
-          if ((widthspec = strstr(temp, "::")) != NULL)
-          {
-            *widthspec = '\0';
-            widthspec += 2;
+  while (*s && *s != '\n')
+  {
+    if (!strncmp(s, "/*", 2))
+    {
+     /*
+      * Start of a block comment...
+      */
 
-            if ((heightspec = strchr(widthspec, 'x')) != NULL)
-	      *heightspec++ = '\0';
-	  }
-	  else
-	  {
-	    heightspec = NULL;
-          }
+      if (s > start)
+      {
+       /*
+        * Output current fragment...
+        */
 
-	  if (widthspec && *widthspec)
-	    fprintf(out, "\" width=\"%s", widthspec);
-	  if (heightspec && *heightspec)
-	    fprintf(out, "\" height=\"%s", heightspec);
+	if (class_name)
+	{
+	  fprintf(fp, "<span class=\"%s\">", class_name);
+	  write_string(fp, start, OUTPUT_HTML, s - start);
+	  fputs("</span>", fp);
+	}
+	else
+	{
+	  write_string(fp, start, OUTPUT_HTML, s - start);
+	}
 
-          fputs("\" alt=\"", out);
-          write_string(out, text, mode, 0);
-          if (mode == OUTPUT_EPUB)
-            fputs("\" />", out);
-          else
-            fputs("\">", out);
-          return;
+	start = s;
+      }
 
-      case MMD_TYPE_HARD_BREAK :
-	  if (mmdGetType(mmdGetParent(node)) < MMD_TYPE_HEADING_1 || mmdGetType(mmdGetParent(node)) > MMD_TYPE_HEADING_6)
-	  {
-	    if (mode == OUTPUT_EPUB)
-	      fputs("<br />\n", out);
-	    else
-	      fputs("<br>\n", out);
-	  }
-          return;
+     /*
+      * At this point, "start" points to the start of the comment...
+      */
 
-      case MMD_TYPE_SOFT_BREAK :
-          if (mode == OUTPUT_EPUB)
-            fputs("<wbr />", out);
-          else
-            fputs("<wbr>", out);
-          return;
+      if ((s = strstr(start, "*/")) != NULL)
+      {
+       /*
+        * Comment ends on the current line...
+        */
 
-      case MMD_TYPE_METADATA_TEXT :
-          return;
+        s += 2;
 
-      default :
-          element = NULL;
-          break;
-    }
+	fputs("<span class=\"comment\">", fp);
+	write_string(fp, start, OUTPUT_HTML, s - start);
+	fputs("</span>", fp);
 
-    prev_type = mmdGetType(mmdGetPrevSibling(node));
-    next_type = mmdGetType(mmdGetNextSibling(node));
+	start      = s;
+	*histate   = HIGHLIGHT_NONE;
+	class_name = NULL;
+      }
+      else
+      {
+       /*
+        * Comment continues to the next line...
+        */
 
-    if (url)
+	s          = start + strlen(start) - 1;
+	*histate   = HIGHLIGHT_COMMENT;
+	class_name = "comment";
+	break;
+      }
+    }
+    else if (!strncmp(s, "//", 2))
     {
-      const char *prev_url = mmdGetURL(mmdGetPrevSibling(node));
-      const char *title = mmdGetExtra(node);
+     /*
+      * Start of C++ comment...
+      */
 
-      if (!prev_url || strcmp(prev_url, url))
+      if (s > start)
       {
-	if (!strcmp(url, "@"))
-	  fprintf(out, "<a href=\"#%s\"", markdown_anchor(text));
-	else if (!strcmp(url, "@@"))
-	  fprintf(out, "<a href=\"#%s\"", text);
-	else
-	  fprintf(out, "<a href=\"%s\"", url);
+       /*
+        * Output current fragment...
+        */
 
-	if (title)
+	if (class_name)
 	{
-	  fputs(" title=\"", out);
-	  write_string(out, title, mode, 0);
-	  fputs("\">", out);
+	  fprintf(fp, "<span class=\"%s\">", class_name);
+	  write_string(fp, start, OUTPUT_HTML, s - start);
+	  fputs("</span>", fp);
 	}
 	else
-	  putc('>', out);
+	{
+	  write_string(fp, start, OUTPUT_HTML, s - start);
+	}
+
+	start = s;
       }
+
+      s          = start + strlen(start) - 1;
+      *histate   = HIGHLIGHT_COMMENT1;
+      class_name = "comment";
+      break;
     }
+    else if (*s == '\"' || *s == '\'')
+    {
+     /*
+      * String/character constant...
+      */
 
-    if (element && prev_type != type)
-      fprintf(out, "<%s>", element);
+      if (s > start)
+      {
+       /*
+        * Output current fragment...
+        */
 
-    write_string(out, text, mode, 0);
+	if (class_name)
+	{
+	  fprintf(fp, "<span class=\"%s\">", class_name);
+	  write_string(fp, start, OUTPUT_HTML, s - start);
+	  fputs("</span>", fp);
+	}
+	else
+	{
+	  write_string(fp, start, OUTPUT_HTML, s - start);
+	}
 
-    if (element && next_type != type)
-      fprintf(out, "</%s>", element);
+	start = s;
+      }
 
-    if (url)
-    {
-      const char *next_url = mmdGetURL(mmdGetNextSibling(node));
+      for (s = start + 1; *s && *s != *start; s ++)
+      {
+        if (*s == '\\' && s[1])
+          s ++;
+      }
 
-      if (!next_url || strcmp(next_url, url))
-	fputs("</a>", out);
-    }
-  }
-}
+      if (*s == *start)
+        s ++;
 
+      fputs("<span class=\"string\">", fp);
+      write_string(fp, start, OUTPUT_HTML, s - start);
+      fputs("</span>", fp);
 
-/*
- * 'new_documentation()' - Create a new documentation tree.
- */
+      start = s;
+    }
+    else
+    {
+      if (isalnum(*s & 255) || *s == '_' || *s == '.')
+      {
+       /*
+        * Number or keyword...
+        */
 
-static mxml_node_t *			/* O - New documentation */
-new_documentation(mxml_node_t **codedoc)/* O - codedoc node */
-{
-  mxml_node_t	*doc;			/* New documentation */
+	if (*histate == HIGHLIGHT_NONE)
+	{
+	  if (s > start && *histate == HIGHLIGHT_NONE)
+	  {
+	   /*
+	    * End current fragment...
+	    */
 
+	    write_string(fp, start, OUTPUT_HTML, s - start);
+	    start = s;
+	  }
 
- /*
-  * Create an empty XML documentation file...
-  */
+	  if (isdigit(*s & 255) || (*s == '.' && isdigit(s[1] & 255)))
+	  {
+	    *histate   = HIGHLIGHT_NUMBER;
+	    class_name = "number";
+	  }
+	  else
+	  {
+	    *histate = HIGHLIGHT_RESERVED;
+	  }
+	}
 
-  doc = mxmlNewXML(NULL);
+        if (*histate == HIGHLIGHT_RESERVED && keyptr < (keyword + sizeof(keyword) - 1))
+          *keyptr++ = *s;
+      }
+      else if (*histate == HIGHLIGHT_NUMBER)
+      {
+       /*
+        * End of number...
+        */
 
-  *codedoc = mxmlNewElement(doc, "codedoc");
+	fprintf(fp, "<span class=\"%s\">", class_name);
+	write_string(fp, start, OUTPUT_HTML, s - start);
+	fputs("</span>", fp);
 
-  mxmlElementSetAttr(*codedoc, "xmlns", "https://www.msweet.org");
-  mxmlElementSetAttr(*codedoc, "xmlns:xsi", "http://www.w3.org/2001/XMLSchema-instance");
-  mxmlElementSetAttr(*codedoc, "xsi:schemaLocation", "https://www.msweet.org/codedoc/codedoc.xsd");
+	start      = s;
+	*histate   = HIGHLIGHT_NONE;
+	class_name = NULL;
+      }
+      else if (*histate == HIGHLIGHT_RESERVED)
+      {
+       /*
+        * End of reserved word?
+        */
 
-  return (doc);
-}
+        *keyptr = '\0';
+        keyptr  = keyword;
 
+        if (is_reserved(keyword))
+        {
+         /*
+          * Yes, reserved word...
+          */
 
-/*
- * 'reserved_compare()' - Compare two reserved words.
- */
+	  fputs("<span class=\"reserved\">", fp);
+	  write_string(fp, start, OUTPUT_HTML, s - start);
+	  fputs("</span>", fp);
+        }
+        else
+        {
+         /*
+          * Just some other text...
+          */
 
-static int				/* O - Result of comparison */
-reserved_compare(const char **a,	/* I - First word */
-		 const char **b)	/* I - Second word */
-{
-  return (strcmp(*a, *b));
-}
+	  write_string(fp, start, OUTPUT_HTML, s - start);
+        }
 
+        start    = s;
+        *histate = HIGHLIGHT_NONE;
+      }
 
-/*
- * 'safe_strcpy()' - Copy a string allowing for overlapping strings.
- */
+      s ++;
+    }
+  }
 
-static void
-safe_strcpy(char       *dst,		/* I - Destination string */
-            const char *src)		/* I - Source string */
-{
-  while (*src)
-    *dst++ = *src++;
+  if (s > start)
+  {
+    if (class_name)
+    {
+      fprintf(fp, "<span class=\"%s\">", class_name);
+      write_string(fp, start, OUTPUT_HTML, s - start);
+      fputs("</span>", fp);
+    }
+    else if (*histate == HIGHLIGHT_RESERVED)
+    {
+      *keyptr = '\0';
+      keyptr  = keyword;
 
-  *dst = '\0';
+      if (is_reserved(keyword))
+      {
+       /*
+	* Yes, reserved word...
+	*/
+
+	fputs("<span class=\"reserved\">", fp);
+	write_string(fp, start, OUTPUT_HTML, s - start);
+	fputs("</span>", fp);
+      }
+      else
+      {
+       /*
+	* Just some other text...
+	*/
+
+	write_string(fp, start, OUTPUT_HTML, s - start);
+      }
+    }
+    else
+    {
+      write_string(fp, start, OUTPUT_HTML, s - start);
+    }
+  }
+
+  done:
+
+  if (*histate != HIGHLIGHT_COMMENT)
+    *histate = HIGHLIGHT_NONE;
+
+  putc('\n', fp);
 }
 
 
 /*
- * 'scan_file()' - Scan a source file.
+ * 'highlight_css_string()' - Output a string of CSS, highlighting it as needed.
  */
 
-static int				/* O  - 1 on success, 0 on error */
-scan_file(filebuf_t   *file,		/* I  - File to scan */
-          mxml_node_t *tree,		/* I  - Function tree */
-          const char  *nsname,		/* I  - Namespace name */
-          mmd_t       **body)		/* IO - Body markdown text */
+static void
+highlight_css_string(
+    FILE       *fp,			/* I  - Output file */
+    const char *s,			/* I  - String */
+    int        *histate)		/* IO - Highlighting state */
 {
-  int		state,			/* Current parser state */
-		braces,			/* Number of braces active */
-		parens,			/* Number of active parenthesis */
-		tree_is_scu;		/* Is the tree a struct, class, or union? */
-  int		ch;			/* Current character */
-  stringbuf_t	buffer;			/* String buffer */
-  const char	*scope;			/* Current variable/function scope */
-  mxml_node_t	*comment,		/* <comment> node */
-		*constant,		/* <constant> node */
-		*enumeration,		/* <enumeration> node */
-		*function,		/* <function> node */
-		*fstructclass,		/* function struct/class node */
-		*structclass,		/* <struct> or <class> node */
-		*typedefnode,		/* <typedef> node */
-		*variable,		/* <variable> or <argument> node */
-		*returnvalue,		/* <returnvalue> node */
-		*type,			/* <type> node */
-		*description,		/* <description> node */
-		*node,			/* Current node */
-		*child,			/* First child node */
-		*next;			/* Next node */
-  bool		whitespace;		/* Current whitespace value */
-  const char	*string,		/* Current string value */
-		*next_string;		/* Next string value */
-  int		nskeyword = 0;		/* Namespace keyword seen? */
-  char		nsnamestr[1024] = "";	/* Namespace name string */
-#if DEBUG > 1
-  mxml_node_t	*temp;			/* Temporary node */
-  int		oldstate,		/* Previous state */
-		oldch;			/* Old character */
-  static const char *states[] =		/* State strings */
-		{
-		  "STATE_NONE",
-		  "STATE_PREPROCESSOR",
-		  "STATE_C_COMMENT",
-		  "STATE_CXX_COMMENT",
-		  "STATE_STRING",
-		  "STATE_CHARACTER",
-		  "STATE_IDENTIFIER"
-		};
-#endif /* DEBUG > 1 */
+  static const char *class_names[] =	/* CSS class names for each state */
+  {
+    NULL,				/* No highlighting, plain text */
+    "comment",				/* Comment text */
+    NULL,				/* One-line comment text */
+    "directive",			/* Declaration */
+    "directive",			/* @ directive */
+    "number",				/* Number text */
+    "reserved",				/* Property name text */
+    NULL				/* String literal text */
+  };
+  const char	*start = s;		/* Start of code to highlight */
 
 
-  DEBUG_printf("scan_file(file.filename=\"%s\", .fp=%p, tree=%p, nsname=\"%s\", body=%p)\n", file->filename, file->fp, tree, nsname ? nsname : "(null)", (void *)*body);
+  if (*histate == HIGHLIGHT_COMMENT)
+  {
+    if ((s = strstr(start, "*/")) != NULL)
+    {
+      // Comment ends on this line...
+      s += 2;
 
- /*
-  * Initialize the finite state machine...
-  */
+      fputs("<span class=\"comment\">", fp);
+      write_string(fp, start, OUTPUT_HTML, s - start);
+      fputs("</span>", fp);
 
-  state        = STATE_NONE;
-  braces       = 0;
-  parens       = 0;
-  comment      = mxmlNewElement(/*parent*/NULL, "temp");
-  constant     = NULL;
-  enumeration  = NULL;
-  function     = NULL;
-  variable     = NULL;
-  returnvalue  = NULL;
-  type         = NULL;
-  description  = NULL;
-  typedefnode  = NULL;
-  structclass  = NULL;
-  fstructclass = NULL;
-  tree_is_scu  = !strcmp(mxmlGetElement(tree), "class") || !strcmp(mxmlGetElement(tree), "struct") || !strcmp(mxmlGetElement(tree), "union");
+      start    = s;
+      *histate = HIGHLIGHT_NONE;
+    }
+    else
+    {
+      // Comment continues beyond the current line...
+      s = start + strlen(start) - 1;
+    }
+  }
+  else if (*histate == HIGHLIGHT_DIRECTIVE)
+  {
+    for (s = start + 1; *s && *s != *start; s ++)
+    {
+      if (*s == '{' || *s == ';')
+      {
+	s ++;
+	break;
+      }
+    }
 
-  if (!strcmp(mxmlGetElement(tree), "class"))
-    scope = "private";
-  else
-    scope = NULL;
+    fputs("<span class=\"directive\">", fp);
+    write_string(fp, start, OUTPUT_HTML, s - start);
+    fputs("</span>", fp);
 
-  stringbuf_clear(&buffer);
+    start = s;
 
- /*
-  * Read until end-of-file...
-  */
+    if (*s)
+      *histate = HIGHLIGHT_NONE;
+  }
 
-  while ((ch = filebuf_getc(file)) != EOF)
+  while (*s && *s != '\n')
   {
-#if DEBUG > 1
-    oldstate = state;
-    oldch    = ch;
-#endif /* DEBUG > 1 */
-
-    switch (state)
+    if (!strncmp(s, "/*", 2))
     {
-      case STATE_NONE :			/* No state - whitespace, etc. */
-          switch (ch)
-	  {
-	    case '/' :			/* Possible C/C++ comment */
-	        ch = filebuf_getc(file);
+      // Start of a block comment...
+      if (s > start)
+      {
+        // Output current fragment...
+	if (*histate)
+	{
+	  fprintf(fp, "<span class=\"%s\">", class_names[*histate]);
+	  write_string(fp, start, OUTPUT_HTML, s - start);
+	  fputs("</span>", fp);
+	}
+	else
+	{
+	  write_string(fp, start, OUTPUT_HTML, s - start);
+	}
 
-		stringbuf_clear(&buffer);
-
-		if (ch == '*')
-		  state = STATE_C_COMMENT;
-		else if (ch == '/')
-		{
-		  state = STATE_CXX_COMMENT;
-
-		  if ((ch = filebuf_getc(file)) != ' ')
-		    filebuf_ungetc(file, ch);
-		}
-		else
-		{
-		  filebuf_ungetc(file, ch);
-
-		  if (type)
-		  {
-                    DEBUG_puts("Identifier: <<<< / >>>\n");
+	start = s;
+      }
 
-                    ch = get_nth_text(type, -1, NULL)[0];
-		    mxmlNewText(type, isalnum(ch & 255) || ch == '_', "/");
-		  }
-		}
-		break;
+      // At this point, "start" points to the start of the comment...
+      if ((s = strstr(start, "*/")) != NULL)
+      {
+        // Comment ends on the current line...
+        s += 2;
 
-	    case '#' :			/* Preprocessor */
-	        DEBUG_puts("    #preprocessor...\n");
+	fputs("<span class=\"comment\">", fp);
+	write_string(fp, start, OUTPUT_HTML, s - start);
+	fputs("</span>", fp);
 
-	        state = STATE_PREPROCESSOR;
-	        while (mxmlGetFirstChild(comment))
-	          mxmlAdd(Garbage, MXML_ADD_AFTER, NULL, mxmlGetFirstChild(comment));
-		break;
+	start    = s;
+	*histate = HIGHLIGHT_NONE;
+      }
+      else
+      {
+        // Comment continues to the next line...
+	s        = start + strlen(start) - 1;
+	*histate = HIGHLIGHT_COMMENT;
+	break;
+      }
+    }
+    else if (*s == '\"' || *s == '\'')
+    {
+      // String/character constant...
+      if (s > start)
+      {
+        // Output current fragment...
+	if (*histate)
+	{
+	  fprintf(fp, "<span class=\"%s\">", class_names[*histate]);
+	  write_string(fp, start, OUTPUT_HTML, s - start);
+	  fputs("</span>", fp);
+	}
+	else
+	{
+	  write_string(fp, start, OUTPUT_HTML, s - start);
+	}
 
-            case '\'' :			/* Character constant */
-	        state = STATE_CHARACTER;
+	start = s;
+      }
 
-		stringbuf_clear(&buffer);
-		stringbuf_append(&buffer, ch);
-		break;
+      for (s = start + 1; *s && *s != *start; s ++)
+      {
+        if (*s == '\\' && s[1])
+          s ++;
+      }
 
-            case '\"' :			/* String constant */
-	        state = STATE_STRING;
+      if (*s == *start)
+        s ++;
 
-		stringbuf_clear(&buffer);
-		stringbuf_append(&buffer, ch);
-		break;
+      fputs("<span class=\"string\">", fp);
+      write_string(fp, start, OUTPUT_HTML, s - start);
+      fputs("</span>", fp);
 
-            case '{' :
-                if (nskeyword)
-                {
-                  if (!scan_file(file, tree, nsnamestr, body))
-		  {
-		    mxmlAdd(Garbage, MXML_ADD_AFTER, NULL, comment);
-		    return (0);
-		  }
+      start = s;
+    }
+    else if (*s == '@' && *histate == HIGHLIGHT_NONE)
+    {
+      // Start of selector
+      if (s > start)
+      {
+        // Output current fragment...
+	write_string(fp, start, OUTPUT_HTML, s - start);
 
-		  nskeyword    = 0;
-		  nsnamestr[0] = '\0';
-                  break;
-                }
+	start = s;
+      }
 
-                string      = get_nth_text(type, 0, &whitespace);
-                next_string = get_nth_text(type, 1, NULL);
+      for (s = start + 1; *s && *s != *start; s ++)
+      {
+        if (*s == '{' || *s == ';')
+        {
+          s ++;
+          break;
+        }
+      }
 
-#ifdef DEBUG
-	        DEBUG_printf("    open brace, function=%p, type=%p...\n", function, type);
-                if (type)
-                  DEBUG_printf("    type->child=\"%s\"...\n", string);
-#endif /* DEBUG */
+      fputs("<span class=\"directive\">", fp);
+      write_string(fp, start, OUTPUT_HTML, s - start);
+      fputs("</span>", fp);
 
-	        if (function)
-		{
-                  mxml_node_t *temptype = mxmlFindElement(returnvalue, returnvalue, "type", NULL, NULL, MXML_DESCEND_ALL);
+      start = s;
 
-		  DEBUG_printf("    returnvalue type=%p(%s)\n", temptype, temptype ? mxmlGetText(mxmlGetFirstChild(temptype), NULL) : "null");
+      if (!*s)
+        *histate = HIGHLIGHT_DIRECTIVE;
+    }
+    else if (*s == '{')
+    {
+      s ++;
 
-		  if (temptype && mxmlGetFirstChild(temptype) && !strcmp(mxmlGetText(mxmlGetFirstChild(temptype), NULL), "static") && !strcmp(mxmlGetElement(tree), "codedoc"))
-                  {
-                   /*
-                    * Remove static functions...
-                    */
+      if (s > start)
+      {
+        // Output current fragment...
+	if (*histate)
+	{
+	  fprintf(fp, "<span class=\"%s\">", class_names[*histate]);
+	  write_string(fp, start, OUTPUT_HTML, s - start);
+	  fputs("</span>", fp);
+	}
+	else
+	{
+	  write_string(fp, start, OUTPUT_HTML, s - start);
+	}
 
-                    DEBUG_puts("    DELETING STATIC FUNCTION\n");
+	start = s;
+      }
 
-                    mxmlAdd(Garbage, MXML_ADD_AFTER, NULL, function);
-                  }
-                  else if (fstructclass)
-		  {
-		    sort_node(fstructclass, function);
-		    fstructclass = NULL;
-		  }
-		  else
-		    sort_node(tree, function);
+      *histate = HIGHLIGHT_RESERVED;
+    }
+    else if (*histate == HIGHLIGHT_RESERVED && *s == ':')
+    {
+      s ++;
 
-		  function    = NULL;
-		  returnvalue = NULL;
-		}
-		else if (type && string && ((!strcmp(string, "typedef") && next_string && (!strcmp(next_string, "struct") || !strcmp(next_string, "union") || !strcmp(next_string, "class"))) || !strcmp(string, "union") || !strcmp(string, "struct") || !strcmp(string, "class")))
-		{
-		 /*
-		  * Start of a class or structure...
-		  */
+      fprintf(fp, "<span class=\"%s\">", class_names[*histate]);
+      write_string(fp, start, OUTPUT_HTML, s - start);
+      fputs("</span>", fp);
 
-		  if (!strcmp(string, "typedef"))
-		  {
-                    DEBUG_puts("    starting typedef...\n");
+      start    = s;
+      *histate = HIGHLIGHT_NUMBER;
+    }
+    else if (*histate == HIGHLIGHT_NUMBER && *s == ';')
+    {
+      s ++;
 
-		    typedefnode = mxmlNewElement(/*parent*/NULL, "typedef");
-		    mxmlAdd(Garbage, MXML_ADD_AFTER, NULL, mxmlGetFirstChild(type));
+      fprintf(fp, "<span class=\"%s\">", class_names[*histate]);
+      write_string(fp, start, OUTPUT_HTML, s - start);
+      fputs("</span>", fp);
 
-		    string      = next_string;
-		    next_string = get_nth_text(type, 1, NULL);
-		  }
-		  else
-		    typedefnode = NULL;
+      start    = s;
+      *histate = HIGHLIGHT_RESERVED;
+    }
+    else if (*histate == HIGHLIGHT_NUMBER && (*s == '\"' || *s == '\''))
+    {
+      // String/character constant...
+      if (s > start)
+      {
+        // Output current fragment...
+	if (*histate)
+	{
+	  fprintf(fp, "<span class=\"%s\">", class_names[*histate]);
+	  write_string(fp, start, OUTPUT_HTML, s - start);
+	  fputs("</span>", fp);
+	}
+	else
+	{
+	  write_string(fp, start, OUTPUT_HTML, s - start);
+	}
 
-		  structclass = mxmlNewElement(/*parent*/NULL, string);
+	start = s;
+      }
 
-#ifdef DEBUG
-                  DEBUG_printf("%c%s: <<<< %s >>>\n", toupper(string[0]), string + 1, next_string ? next_string : "(noname)");
+      for (s = start + 1; *s && *s != *start; s ++)
+      {
+        if (*s == '\\' && s[1])
+          s ++;
+      }
 
-                  DEBUG_puts("    type =");
-                  for (node = mxmlGetFirstChild(type); node; node = mxmlGetNextSibling(node))
-		    DEBUG_printf(" \"%s\"", mxmlGetText(node, NULL));
-		  DEBUG_puts("\n");
+      if (*s == *start)
+        s ++;
 
-                  DEBUG_printf("    scope = %s\n", scope ? scope : "(null)");
-#endif /* DEBUG */
+      fputs("<span class=\"string\">", fp);
+      write_string(fp, start, OUTPUT_HTML, s - start);
+      fputs("</span>", fp);
 
-                  if (next_string)
-		  {
-		    if (nsname)
-		    {
-		      mxmlElementSetAttrf(structclass, "name", "%s::%s", nsname, next_string);
-		      mxmlSetText(get_nth_child(type, 1), 1, mxmlElementGetAttr(structclass, "name"));
-		    }
-		    else
-		      mxmlElementSetAttr(structclass, "name", next_string);
-		    sort_node(tree, structclass);
-		  }
+      start = s;
+    }
+    else if ((*histate == HIGHLIGHT_RESERVED || *histate == HIGHLIGHT_NUMBER) && *s == '}')
+    {
+      if (s > start)
+      {
+	fprintf(fp, "<span class=\"%s\">", class_names[*histate]);
+	write_string(fp, start, OUTPUT_HTML, s - start);
+	fputs("</span>", fp);
 
-                  child = mxmlGetFirstChild(type);
+        start = s;
+      }
 
-                  if (typedefnode && child)
-                  {
-                    clear_whitespace(mxmlGetFirstChild(type));
-		  }
-                  else if (structclass && child && mxmlGetNextSibling(child) && mxmlGetNextSibling(mxmlGetNextSibling(child)))
-		  {
-		    char temp[65536], *tempptr;
+      *histate = HIGHLIGHT_NONE;
+      s ++;
+    }
+    else if (*s == '}')
+    {
+      if (s > start)
+      {
+        // Output current fragment...
+	if (*histate)
+	{
+	  fprintf(fp, "<span class=\"%s\">", class_names[*histate]);
+	  write_string(fp, start, OUTPUT_HTML, s - start);
+	  fputs("</span>", fp);
+	}
+	else
+	{
+	  write_string(fp, start, OUTPUT_HTML, s - start);
+	}
 
-		    for (tempptr = temp, node = mxmlGetNextSibling(mxmlGetNextSibling(child)); node; tempptr += strlen(temp))
-		    {
-		      string = mxmlGetText(node, &whitespace);
+	start = s;
+      }
 
-		      if (whitespace && tempptr > temp && tempptr < (temp + sizeof(temp) - 1))
-			*tempptr++ = ' ';
+      fputs("<span class=\"directive\">}</span>", fp);
 
-		      strlcpy(tempptr, string, sizeof(temp) - (size_t)(tempptr - temp));
+      s ++;
+      start    = s;
+      *histate = HIGHLIGHT_NONE;
+    }
+    else
+    {
+      s ++;
+    }
+  }
 
-		      next = mxmlGetNextSibling(node);
-		      mxmlAdd(Garbage, MXML_ADD_AFTER, NULL, node);
-		      node = next;
-		    }
+  if (s > start)
+  {
+    // Output current fragment...
+    if (*histate)
+    {
+      fprintf(fp, "<span class=\"%s\">", class_names[*histate]);
+      write_string(fp, start, OUTPUT_HTML, s - start);
+      fputs("</span>", fp);
+    }
+    else
+    {
+      write_string(fp, start, OUTPUT_HTML, s - start);
+    }
+  }
 
-		    mxmlElementSetAttr(structclass, "parent", temp);
+  putc('\n', fp);
+}
 
-		    mxmlAdd(Garbage, MXML_ADD_AFTER, NULL, type);
-		    type = NULL;
-		  }
-		  else
-		  {
-		    mxmlAdd(Garbage, MXML_ADD_AFTER, NULL, type);
-		    type = NULL;
-		  }
 
-		  if (typedefnode && mxmlGetLastChild(comment))
-		  {
-		   /*
-		    * Copy comment for typedef as well as class/struct/union...
-		    */
+/*
+ * 'highlight_htmlxml_string()' - Output a string of HTML/XML code, highlighting it as needed.
+ */
 
-		    mxmlNewOpaque(comment, mxmlGetOpaque(mxmlGetLastChild(comment)));
-		    description = mxmlNewElement(typedefnode, "description");
+static void
+highlight_htmlxml_string(
+    FILE       *fp,			/* I  - Output file */
+    const char *s,			/* I  - String */
+    int        *histate)		/* IO - Highlighting state */
+{
+  static const char *class_names[] =	/* CSS class names for each state */
+  {
+    NULL,				/* No highlighting, plain text */
+    "comment",				/* Comment text */
+    NULL,				/* One-line comment text */
+    "directive",			/* XML/HTML declaration */
+    "directive",			/* Preprocessor directive/processing instruction */
+    NULL,				/* Number text */
+    "reserved",				/* Reserved word text */
+    NULL				/* String literal text */
+  };
+  const char	*start = s,		/* Start of code to highlight */
+		*class_name = class_names[*histate];
+					/* Class name for current fragment */
 
-		    DEBUG_printf("    duplicating comment %p/%p for typedef...\n", mxmlGetLastChild(comment), mxmlGetFirstChild(comment));
 
-		    update_comment(typedefnode, mxmlGetLastChild(comment));
-		    mxmlAdd(description, MXML_ADD_AFTER, /*parent*/NULL, mxmlGetLastChild(comment));
-		  }
+  if (*histate == HIGHLIGHT_COMMENT)
+  {
+    if ((s = strstr(start, "-->")) != NULL)
+    {
+     /*
+      * Comment ends on this line...
+      */
 
-		  description = mxmlNewElement(structclass, "description");
+      s += 3;
 
-		  DEBUG_printf("    adding comment %p/%p to %s...\n", mxmlGetLastChild(comment), mxmlGetFirstChild(comment), mxmlGetElement(structclass));
+      fputs("<span class=\"comment\">", fp);
+      write_string(fp, start, OUTPUT_HTML, s - start);
+      fputs("</span>", fp);
 
-		  update_comment(structclass, mxmlGetLastChild(comment));
-		  mxmlAdd(description, MXML_ADD_AFTER, /*parent*/NULL, mxmlGetLastChild(comment));
+      start      = s;
+      *histate   = HIGHLIGHT_NONE;
+      class_name = NULL;
+    }
+    else
+    {
+     /*
+      * Comment continues beyond the current line...
+      */
 
-                  if (!scan_file(file, structclass, nsname, body))
-		  {
-		    mxmlAdd(Garbage, MXML_ADD_AFTER, NULL, comment);
-		    return (0);
-		  }
+      s = start + strlen(start) - 1;
+    }
+  }
+  else if (*histate == HIGHLIGHT_DIRECTIVE)
+  {
+    if ((s = strstr(start, "?>")) != NULL)
+    {
+     /*
+      * Processing instruction ends on this line...
+      */
 
-                  DEBUG_puts("    ended typedef...\n");
+      s += 2;
 
-                  structclass = NULL;
-                  break;
-                }
-		else if (type && string && next_string && (!strcmp(string, "enum") || (!strcmp(string, "typedef") && !strcmp(next_string, "enum"))))
-                {
-		 /*
-		  * Enumeration type...
-		  */
+      highlight_string(fp, start, s, class_name);
 
-		  if (!strcmp(string, "typedef"))
-		  {
-                    DEBUG_puts("    starting typedef...\n");
+      start      = s;
+      *histate   = HIGHLIGHT_NONE;
+      class_name = NULL;
+    }
+    else
+    {
+     /*
+      * Processing instruction continues beyond the current line...
+      */
 
-		    typedefnode = mxmlNewElement(/*parent*/NULL, "typedef");
-		    mxmlAdd(Garbage, MXML_ADD_AFTER, NULL, mxmlGetFirstChild(type));
-		    string      = next_string;
-		    next_string = get_nth_text(type, 1, NULL);
-		  }
-		  else
-		    typedefnode = NULL;
+      s = start + strlen(start) - 1;
+    }
+  }
+  else if (*histate == HIGHLIGHT_RESERVED || *histate == HIGHLIGHT_DECLARATION)
+  {
+    if ((s = strchr(start, '>')) != NULL)
+    {
+     /*
+      * Element/declaration ends on this line...
+      */
 
-		  enumeration = mxmlNewElement(/*parent*/NULL, "enumeration");
+      s ++;
 
-                  DEBUG_printf("Enumeration: <<<< %s >>>\n", next_string ? next_string : "(noname)");
+      highlight_string(fp, start, s, class_name);
 
-                  if (next_string)
-		  {
-		    if (nsname)
-		    {
-		      mxmlElementSetAttrf(enumeration, "name", "%s::%s", nsname, next_string);
-		      mxmlSetText(get_nth_child(type, 1), 1, mxmlElementGetAttr(enumeration, "name"));
-		    }
-		    else
-		      mxmlElementSetAttr(enumeration, "name", next_string);
+      start      = s;
+      *histate   = HIGHLIGHT_NONE;
+      class_name = NULL;
+    }
+    else
+    {
+     /*
+      * Element/declaration continues beyond the current line...
+      */
 
-		    sort_node(tree, enumeration);
-		  }
+      s = start + strlen(start) - 1;
+    }
+  }
 
-                  if (typedefnode && mxmlGetFirstChild(type))
-                  {
-                    clear_whitespace(mxmlGetFirstChild(type));
-		  }
-                  else
-		  {
-		    mxmlAdd(Garbage, MXML_ADD_AFTER, NULL, type);
-		    type = NULL;
-		  }
+  while (*s && *s != '\n')
+  {
+    if (!strncmp(s, "<!--", 4))
+    {
+     /*
+      * Start of a block comment...
+      */
 
-		  if (typedefnode && mxmlGetLastChild(comment))
-		  {
-		   /*
-		    * Copy comment for typedef as well as class/struct/union...
-		    */
+      if (s > start)
+      {
+       /*
+        * Output current fragment...
+        */
 
-		    mxmlNewOpaque(comment, mxmlGetOpaque(mxmlGetLastChild(comment)));
-		    description = mxmlNewElement(typedefnode, "description");
+	if (class_name)
+	{
+	  fprintf(fp, "<span class=\"%s\">", class_name);
+	  write_string(fp, start, OUTPUT_HTML, s - start);
+	  fputs("</span>", fp);
+	}
+	else
+	{
+	  write_string(fp, start, OUTPUT_HTML, s - start);
+	}
 
-		    DEBUG_printf("    duplicating comment %p/%p for typedef...\n", mxmlGetLastChild(comment), mxmlGetFirstChild(comment));
+	start = s;
+      }
 
-		    update_comment(typedefnode, mxmlGetLastChild(comment));
-		    mxmlAdd(description, MXML_ADD_AFTER, /*parent*/NULL, mxmlGetLastChild(comment));
-		  }
+     /*
+      * At this point, "start" points to the start of the comment...
+      */
 
-		  description = mxmlNewElement(enumeration, "description");
+      if ((s = strstr(start, "-->")) != NULL)
+      {
+       /*
+        * Comment ends on the current line...
+        */
 
-		  DEBUG_printf("    adding comment %p/%p to enumeration...\n", mxmlGetLastChild(comment), mxmlGetFirstChild(comment));
-
-		  update_comment(enumeration, mxmlGetLastChild(comment));
-		  mxmlAdd(description, MXML_ADD_AFTER, /*parent*/NULL, mxmlGetLastChild(comment));
-		}
-		else if (type && string && !strcmp(string, "extern"))
-                {
-                  if (!scan_file(file, tree, nsname, body))
-		  {
-		    mxmlAdd(Garbage, MXML_ADD_AFTER, NULL, comment);
-		    return (0);
-		  }
-                }
-		else if (type)
-		{
-		  mxmlAdd(Garbage, MXML_ADD_AFTER, NULL, type);
-		  type = NULL;
-		}
+        s += 3;
 
-	        braces ++;
-		function = NULL;
-		variable = NULL;
-		break;
+	fputs("<span class=\"comment\">", fp);
+	write_string(fp, start, OUTPUT_HTML, s - start);
+	fputs("</span>", fp);
 
-            case '}' :
-	        DEBUG_puts("    close brace...\n");
+	start      = s;
+	*histate   = HIGHLIGHT_NONE;
+	class_name = NULL;
+      }
+      else
+      {
+       /*
+        * Comment continues to the next line...
+        */
 
-                if (structclass)
-		  scope = NULL;
+	s          = start + strlen(start) - 1;
+	*histate   = HIGHLIGHT_COMMENT;
+	class_name = "comment";
+	break;
+      }
+    }
+    else if (!strncmp(s, "<!", 2))
+    {
+     /*
+      * Start of declaration...
+      */
 
-                if (!typedefnode)
-		  enumeration = NULL;
+      if (s > start)
+      {
+       /*
+        * Output current fragment...
+        */
 
-		constant    = NULL;
-		structclass = NULL;
+	if (class_name)
+	{
+	  fprintf(fp, "<span class=\"%s\">", class_name);
+	  write_string(fp, start, OUTPUT_HTML, s - start);
+	  fputs("</span>", fp);
+	}
+	else
+	{
+	  write_string(fp, start, OUTPUT_HTML, s - start);
+	}
 
-	        if (braces > 0)
-	        {
-		  braces --;
-		  if (braces == 0)
-		  {
-		    while (mxmlGetFirstChild(comment))
-		      mxmlAdd(Garbage, MXML_ADD_AFTER, NULL, mxmlGetFirstChild(comment));
-		  }
-		}
-		else
-		{
-		  mxmlAdd(Garbage, MXML_ADD_AFTER, NULL, comment);
-		  return (1);
-		}
-		break;
+	start = s;
+      }
 
-            case '(' :
-		if (type)
-		{
-                  DEBUG_puts("Identifier: <<<< ( >>>\n");
+      if ((s = strchr(start, '>')) != NULL)
+      {
+        s ++;
 
-		  mxmlNewText(type, 0, "(");
-		}
+        highlight_string(fp, start, s, "declaration");
 
-	        parens ++;
-		break;
+	start      = s;
+	*histate   = HIGHLIGHT_NONE;
+	class_name = NULL;
+      }
+      else
+      {
+	s          = start + strlen(start) - 1;
+	*histate   = HIGHLIGHT_DECLARATION;
+	class_name = "declaration";
+	break;
+      }
+    }
+    else if (!strncmp(s, "<?", 2))
+    {
+     /*
+      * Start of processing instruction...
+      */
 
-            case ')' :
-		if (type && parens)
-		{
-                  DEBUG_puts("Identifier: <<<< ) >>>\n");
+      if (s > start)
+      {
+       /*
+        * Output current fragment...
+        */
 
-		  mxmlNewText(type, 0, ")");
-		}
+	if (class_name)
+	{
+	  fprintf(fp, "<span class=\"%s\">", class_name);
+	  write_string(fp, start, OUTPUT_HTML, s - start);
+	  fputs("</span>", fp);
+	}
+	else
+	{
+	  write_string(fp, start, OUTPUT_HTML, s - start);
+	}
 
-                if (function && type && !parens)
-		{
-		 /*
-		  * Check for "void" argument...
-		  */
+	start = s;
+      }
 
-		  if ((child = mxmlGetFirstChild(type)) != NULL && mxmlGetNextSibling(child))
-		    variable = add_variable(function, "argument", type);
-		  else
-		    mxmlAdd(Garbage, MXML_ADD_AFTER, NULL, type);
+      if ((s = strstr(start, "?>")) != NULL)
+      {
+        s += 2;
 
-		  type = NULL;
-		}
 
-	        if (parens > 0)
-		  parens --;
-		break;
+        highlight_string(fp, start, s, "directive");
 
-	    case ';' :
-                DEBUG_puts("Identifier: <<<< ; >>>\n");
-		DEBUG_printf("    enumeration=%p, function=%p, type=%p, type->child=%p, typedefnode=%p\n", enumeration, function, type, mxmlGetFirstChild(type), typedefnode);
+	start      = s;
+	*histate   = HIGHLIGHT_NONE;
+	class_name = NULL;
+      }
+      else
+      {
+	s          = start + strlen(start) - 1;
+	*histate   = HIGHLIGHT_DIRECTIVE;
+	class_name = "directive";
+	break;
+      }
+    }
+    else if (*s == '<')
+    {
+     /*
+      * Start of element...
+      */
 
-		if (function)
-		{
-                  mxml_node_t *temptype = mxmlFindElement(returnvalue, returnvalue, "type", NULL, NULL, MXML_DESCEND_ALL);
+      if (s > start)
+      {
+       /*
+        * Output current fragment...
+        */
 
-                  DEBUG_printf("    returnvalue type=%p(%s)\n", temptype, temptype ? mxmlGetText(mxmlGetFirstChild(temptype), NULL) : "null");
+	if (class_name)
+	{
+	  fprintf(fp, "<span class=\"%s\">", class_name);
+	  write_string(fp, start, OUTPUT_HTML, s - start);
+	  fputs("</span>", fp);
+	}
+	else
+	{
+	  write_string(fp, start, OUTPUT_HTML, s - start);
+	}
 
-		  if (temptype && mxmlGetFirstChild(temptype) && !strcmp(get_nth_text(temptype, 0, NULL), "static") && !strcmp(mxmlGetElement(tree), "codedoc"))
-                  {
-                   /*
-                    * Remove static functions...
-                    */
+	start = s;
+      }
 
-                    DEBUG_puts("    DELETING STATIC FUNCTION\n");
+      if ((s = strchr(start, '>')) != NULL)
+      {
+        s ++;
 
-                    mxmlAdd(Garbage, MXML_ADD_AFTER, NULL, function);
-                  }
-                  else if (!strcmp(mxmlGetElement(tree), "class"))
-		  {
-		    DEBUG_puts("    ADDING FUNCTION TO CLASS\n");
-		    sort_node(tree, function);
-		  }
-		  else
-		    mxmlAdd(Garbage, MXML_ADD_AFTER, NULL, function);
+        highlight_string(fp, start, s, "reserved");
 
-		  function    = NULL;
-		  variable    = NULL;
-		  returnvalue = NULL;
-		}
+	start      = s;
+	*histate   = HIGHLIGHT_NONE;
+	class_name = NULL;
+      }
+      else
+      {
+	s          = start + strlen(start) - 1;
+	*histate   = HIGHLIGHT_RESERVED;
+	class_name = "reserved";
+	break;
+      }
+    }
+    else
+    {
+      s ++;
+    }
+  }
 
-		if (type)
-		{
-		 /*
-		  * See if we have a typedef...
-		  */
+  if (s > start)
+  {
+    if (class_name)
+      highlight_string(fp, start, s, class_name);
+    else
+      write_string(fp, start, OUTPUT_HTML, s - start);
+  }
 
-                  string = get_nth_text(type, 0, NULL);
-		  if (string && !strcmp(string, "typedef"))
-		  {
-		   /*
-		    * Yes, add it!
-		    */
+  putc('\n', fp);
+}
 
-		    typedefnode = mxmlNewElement(/*parent*/NULL, "typedef");
 
-		    for (node = get_nth_child(type, 1); node; node = mxmlGetNextSibling(node))
-		      if (!strcmp(mxmlGetText(node, NULL), "("))
-			break;
+/*
+ * 'highlight_string()' - Highlight quoted strings.
+ */
 
-                    if (node)
-		    {
-		      for (node = mxmlGetNextSibling(node); node; node = mxmlGetNextSibling(node))
-			if (strcmp(mxmlGetText(node, NULL), "*"))
-			  break;
-                    }
+static void
+highlight_string(FILE       *fp,	/* I - Output file */
+                 const char *start,	/* I - Start of substring */
+                 const char *end,	/* I - End of substring */
+                 const char *class_name)/* I - Class name for main content */
+{
+  const char	*ptr;			/* Pointer into substring */
 
-                    if (!node)
-		      node = mxmlGetLastChild(type);
 
-		    DEBUG_printf("    ADDING TYPEDEF FOR %p(%s)...\n", node, mxmlGetText(node, NULL));
+  for (ptr = start; ptr < end; ptr ++)
+  {
+    if (*ptr == '\'' || *ptr == '\"')
+    {
+      if (ptr > start)
+      {
+	fprintf(fp, "<span class=\"%s\">", class_name);
+	write_string(fp, start, OUTPUT_HTML, ptr - start);
+	fputs("</span>", fp);
+      }
 
-		    mxmlElementSetAttr(typedefnode, "name", mxmlGetText(node, NULL));
-		    sort_node(tree, typedefnode);
+      start = ptr;
 
-                    if (mxmlGetFirstChild(type) != node)
-		      mxmlAdd(Garbage, MXML_ADD_AFTER, NULL, mxmlGetFirstChild(type));
+      for (ptr ++; ptr < end && *ptr != *start; ptr ++)
+        ;				/* Loop until close quote */
 
-		    mxmlAdd(Garbage, MXML_ADD_AFTER, NULL, node);
-		    node = NULL;
+      if (ptr < end)
+        ptr ++;
 
-		    if (mxmlGetFirstChild(type))
-		      clear_whitespace(mxmlGetFirstChild(type));
+      fputs("<span class=\"string\">", fp);
+      write_string(fp, start, OUTPUT_HTML, ptr - start);
+      fputs("</span>", fp);
 
-		    mxmlAdd(typedefnode, MXML_ADD_AFTER, /*parent*/NULL, type);
-		    type = NULL;
-		    break;
-		  }
-		  else if (typedefnode && enumeration)
-		  {
-		   /*
-		    * Add enum typedef...
-		    */
+      start = ptr;
+    }
+  }
 
-                    node = mxmlGetFirstChild(type);
+  if (ptr > start)
+  {
+    fprintf(fp, "<span class=\"%s\">", class_name);
+    write_string(fp, start, OUTPUT_HTML, ptr - start);
+    fputs("</span>", fp);
+  }
+}
 
-		    DEBUG_printf("    ADDING TYPEDEF FOR %p(%s)...\n", node, mxmlGetText(node, NULL));
 
-		    mxmlElementSetAttr(typedefnode, "name", mxmlGetText(node, NULL));
-		    sort_node(tree, typedefnode);
-		    mxmlAdd(Garbage, MXML_ADD_AFTER, NULL, type);
+/*
+ * 'gunzip_close()' - Close an input file opened with @link gunzip_open@.
+ */
 
-		    type = mxmlNewElement(typedefnode, "type");
-                    mxmlNewText(type, 0, "enum");
-		    mxmlNewText(type, 1, mxmlElementGetAttr(enumeration, "name"));
-		    enumeration = NULL;
-		    type = NULL;
-		    break;
-		  }
+static void
+gunzip_close(gunzip_t *g)		/* I - Input file or `NULL` */
+{
+  if (!g)
+    return;
 
-		  mxmlAdd(Garbage, MXML_ADD_AFTER, NULL, type);
-		  type = NULL;
-		}
-		break;
+#ifdef HAVE_PTHREAD_H
+  if (g->threaded)
+  {
+    pthread_mutex_lock(&g->mutex);
+    g->cancel = true;
+    pthread_cond_broadcast(&g->cond);
+    pthread_mutex_unlock(&g->mutex);
 
-	    case ':' :
-		if (type)
-		{
-                  DEBUG_puts("Identifier: <<<< : >>>\n");
+    pthread_join(g->thread, NULL);
+    jobsRelease();
 
-		  mxmlNewText(type, 1, ":");
-		}
-		break;
+    pthread_cond_destroy(&g->cond);
+    pthread_mutex_destroy(&g->mutex);
+  }
+#endif /* HAVE_PTHREAD_H */
 
-	    case '*' :
-		if (type)
-		{
-                  DEBUG_puts("Identifier: <<<< * >>>\n");
+  gzclose(g->gz);
+  free(g);
+}
 
-                  ch = get_nth_text(type, -1, NULL)[0];
-		  mxmlNewText(type, isalnum(ch & 255) || ch == '_', "*");
-		}
-		break;
 
-	    case ',' :
-		if (type && !enumeration)
-		{
-                  DEBUG_puts("Identifier: <<<< , >>>\n");
+/*
+ * 'gunzip_error()' - Report whether decompressing an input file failed.
+ *
+ * Call this after @link gunzip_read@ returns 0 to tell a corrupt or truncated
+ * file from the end of the file.  Use `gzerror` for the message, which starts
+ * with the filename.
+ */
 
-		  mxmlNewText(type, 0, ",");
-		}
-		break;
+static bool				/* O - `true` on error, `false` otherwise */
+gunzip_error(gunzip_t *g)		/* I - Input file */
+{
+  bool	error;				/* Did decompression fail? */
 
-	    case '&' :
-		if (type)
-		{
-                  DEBUG_puts("Identifier: <<<< & >>>\n");
 
-		  mxmlNewText(type, 1, "&");
-		}
-		break;
+#ifdef HAVE_PTHREAD_H
+  if (g->threaded)
+  {
+    pthread_mutex_lock(&g->mutex);
+    error = g->error;
+    pthread_mutex_unlock(&g->mutex);
+  }
+  else
+#endif /* HAVE_PTHREAD_H */
+  error = g->error;
 
-	    case '+' :
-		if (type)
-		{
-                  DEBUG_puts("Identifier: <<<< + >>>\n");
+  return (error);
+}
 
-                  ch = get_nth_text(type, -1, NULL)[0];
-		  mxmlNewText(type, isalnum(ch & 255) || ch == '_', "+");
-		}
-		break;
 
-	    case '-' :
-		if (type)
-		{
-                  DEBUG_puts("Identifier: <<<< - >>>\n");
+/*
+ * 'gunzip_open()' - Open an input file that may be gzip-compressed.
+ *
+ * Uncompressed files are read as-is.  When POSIX threads are available and a
+ * job is free, a compressed file is decompressed by a background thread into
+ * a ring of `GUNZIP_BUFFERS` buffers so that decompression overlaps with
+ * parsing.  Use @link gunzip_read@ as the read callback for `mmdLoadIO` and
+ * `mxmlLoadIO`.
+ */
 
-                  ch = get_nth_text(type, -1, NULL)[0];
-		  mxmlNewText(type, isalnum(ch & 255) || ch == '_', "-");
-		}
-		break;
+static gunzip_t *			/* O - Input file or `NULL` on error */
+gunzip_open(const char *filename)	/* I - Filename */
+{
+  gzFile	gz;			/* Input file */
+  gunzip_t	*g;			/* Decompression state */
 
-	    case '=' :
-		if (type)
-		{
-                  DEBUG_puts("Identifier: <<<< = >>>\n");
 
-                  ch = get_nth_text(type, -1, NULL)[0];
-		  mxmlNewText(type, isalnum(ch & 255) || ch == '_', "=");
-		}
-		break;
+  if ((gz = gzopen(filename, "rb")) == NULL)
+    return (NULL);
 
-            default :			/* Other */
-	        if (isalnum(ch & 255) || ch == '_' || ch == '.' || ch == ':' || ch == '~')
-		{
-		  state = STATE_IDENTIFIER;
+  if ((g = calloc(1, sizeof(gunzip_t))) == NULL)
+  {
+    gzclose(gz);
+    return (NULL);
+  }
 
-		  stringbuf_clear(&buffer);
-		  stringbuf_append(&buffer, ch);
-		}
-		break;
-          }
-          break;
+  g->gz = gz;
 
-      case STATE_PREPROCESSOR :		/* Preprocessor directive */
-          if (ch == '\n')
-	    state = STATE_NONE;
-	  else if (ch == '\\')
-	    filebuf_getc(file);
-          break;
+#ifdef HAVE_PTHREAD_H
+  if (!gzdirect(gz) && jobsAcquire())
+  {
+    pthread_mutex_init(&g->mutex, NULL);
+    pthread_cond_init(&g->cond, NULL);
 
-      case STATE_C_COMMENT :		/* Inside a C comment */
-          switch (ch)
-	  {
-	    case '\n' :
-	        while ((ch = filebuf_getc(file)) != EOF)
-	        {
-		  if (ch == '*')
-		  {
-		    ch = filebuf_getc(file);
+    if (pthread_create(&g->thread, NULL, (void *(*)(void *))gunzip_thread, g))
+    {
+      jobsRelease();
+      pthread_cond_destroy(&g->cond);
+      pthread_mutex_destroy(&g->mutex);
+    }
+    else
+      g->threaded = true;
+  }
+#endif /* HAVE_PTHREAD_H */
 
-		    if (ch == '/')
-		    {
-		      char *commstr = stringbuf_get(&buffer);
+  return (g);
+}
 
-        	      if (mxmlGetFirstChild(child) != mxmlGetLastChild(comment))
-		      {
-			DEBUG_printf("    removing comment %p(%20.20s), last comment %p(%20.20s)...\n", mxmlGetFirstChild(comment), mxmlGetFirstChild(comment) ? get_nth_text(comment, 0, NULL) : "", mxmlGetLastChild(comment), mxmlGetLastChild(comment) ? get_nth_text(comment, -1, NULL) : "");
 
-			mxmlAdd(Garbage, MXML_ADD_AFTER, NULL, mxmlGetFirstChild(comment));
+/*
+ * 'gunzip_read()' - Read decompressed data from an input file.
+ */
 
-			DEBUG_printf("    new comment %p, last comment %p...\n", mxmlGetFirstChild(comment), mxmlGetLastChild(comment));
-		      }
+static size_t				/* O - Number of bytes read or 0 at the end of the file or on error */
+gunzip_read(gunzip_t *g,		/* I - Input file */
+            char     *buffer,		/* I - Buffer */
+            size_t   bytes)		/* I - Size of buffer */
+{
+  int	count,				/* Bytes read */
+	zerror;				/* zlib error */
 
-                      DEBUG_printf("    processing comment, variable=%p, constant=%p, typedefnode=%p, tree=\"%s\"\n", variable, constant, typedefnode, mxmlGetElement(tree));
 
-		      if (variable)
-		      {
-		        if (strstr(commstr, "@private@"))
-			{
-			 /*
-			  * Delete private variables...
-			  */
+#ifdef HAVE_PTHREAD_H
+  if (g->threaded)
+  {
+    size_t	length;			/* Bytes to copy */
 
-			  mxmlAdd(Garbage, MXML_ADD_AFTER, NULL, variable);
-			}
-			else
-			{
-			  description = mxmlNewElement(variable, "description");
+   /*
+    * Wait for a full buffer - the thread never touches a buffer that has not
+    * been consumed yet, so it can be copied without holding the mutex...
+    */
 
-			  DEBUG_printf("    adding comment %p/%p to variable...\n", mxmlGetLastChild(comment), mxmlGetFirstChild(comment));
+    pthread_mutex_lock(&g->mutex);
 
-			  mxmlNewOpaque(comment, commstr);
-			  update_comment(variable, mxmlNewOpaque(description, commstr));
-                        }
+    while (!g->count && !g->eof)
+      pthread_cond_wait(&g->cond, &g->mutex);
 
-			variable = NULL;
-		      }
-		      else if (constant)
-		      {
-		        if (strstr(commstr, "@private@"))
-			{
-			 /*
-			  * Delete private constants...
-			  */
+    if (!g->count)
+    {
+      pthread_mutex_unlock(&g->mutex);
+      return (0);
+    }
 
-			  mxmlAdd(Garbage, MXML_ADD_AFTER, NULL, constant);
-			}
-			else
-			{
-			  description = mxmlNewElement(constant, "description");
+    pthread_mutex_unlock(&g->mutex);
 
-			  DEBUG_printf("    adding comment %p/%p to constant...\n", mxmlGetLastChild(comment), mxmlGetFirstChild(comment));
+    if ((length = g->lengths[g->next_read] - g->offset) > bytes)
+      length = bytes;
 
-			  mxmlNewOpaque(comment, commstr);
-			  update_comment(constant, mxmlNewOpaque(description, commstr));
-			}
+    memcpy(buffer, g->buffers[g->next_read] + g->offset, length);
 
-			constant = NULL;
-		      }
-		      else if (typedefnode)
-		      {
-		        if (strstr(commstr, "@private@"))
-			{
-			 /*
-			  * Delete private typedefs...
-			  */
+    pthread_mutex_lock(&g->mutex);
 
-			  mxmlAdd(Garbage, MXML_ADD_AFTER, NULL, typedefnode);
+    if ((g->offset += length) >= g->lengths[g->next_read])
+    {
+      g->offset    = 0;
+      g->next_read = (g->next_read + 1) % GUNZIP_BUFFERS;
+      g->count --;
 
-			  if (structclass)
-			  {
-			    mxmlAdd(Garbage, MXML_ADD_AFTER, NULL, structclass);
-			    structclass = NULL;
-			  }
+      pthread_cond_broadcast(&g->cond);
+    }
 
-			  if (enumeration)
-			  {
-			    mxmlAdd(Garbage, MXML_ADD_AFTER, NULL, enumeration);
-			    enumeration = NULL;
-			  }
-			}
-			else
-			{
-			  description = mxmlNewElement(typedefnode, "description");
+    pthread_mutex_unlock(&g->mutex);
 
-			  DEBUG_printf("    adding comment %p/%p to typedef %s...\n", mxmlGetLastChild(comment), mxmlGetFirstChild(comment), mxmlElementGetAttr(typedefnode, "name"));
+    return (length);
+  }
+#endif /* HAVE_PTHREAD_H */
 
-			  mxmlNewOpaque(comment, commstr);
-			  update_comment(typedefnode, mxmlNewOpaque(description, commstr));
+  if (bytes > GUNZIP_SIZE)
+    bytes = GUNZIP_SIZE;
 
-			  if (structclass)
-			  {
-			    description = mxmlNewElement(structclass, "description");
-			    update_comment(structclass, mxmlNewOpaque(description, commstr));
-			  }
-			  else if (enumeration)
-			  {
-			    description = mxmlNewElement(enumeration, "description");
-			    update_comment(enumeration, mxmlNewOpaque(description, commstr));
-			  }
-			}
+  if ((count = gzread(g->gz, buffer, (unsigned)bytes)) <= 0)
+  {
+    gzerror(g->gz, &zerror);
 
-			typedefnode = NULL;
-		      }
-		      else if (strcmp(mxmlGetElement(tree), "codedoc") && !mxmlFindElement(tree, tree, "description", NULL, NULL, MXML_DESCEND_FIRST))
-                      {
-        		description = mxmlNewElement(tree, "description");
+    if (count < 0 || zerror != Z_OK)
+      g->error = true;
 
-			DEBUG_printf("    adding comment %p/%p to parent...\n", mxmlGetLastChild(comment), mxmlGetFirstChild(comment));
+    return (0);
+  }
 
-        		mxmlNewOpaque(comment, commstr);
-			update_comment(tree, mxmlNewOpaque(description, commstr));
-		      }
-		      else if (!strncmp(commstr, "@body@", 6))
-		      {
-		       /*
-		        * Append comment as body text...
-		        */
+  return ((size_t)count);
+}
 
-		        *body = mmdLoadString(*body, commstr + 6);
-		      }
-		      else
-		      {
-		        DEBUG_printf("    before adding comment, child=%p, last_child=%p\n", mxmlGetFirstChild(comment), mxmlGetLastChild(comment));
 
-        		mxmlNewOpaque(comment, commstr);
+#ifdef HAVE_PTHREAD_H
+/*
+ * 'gunzip_thread()' - Decompress an input file ahead of the parser.
+ */
 
-		        DEBUG_printf("    after adding comment, child=%p, last_child=%p\n", mxmlGetFirstChild(comment), mxmlGetLastChild(comment));
-                      }
+static void *				/* O - Thread exit status (unused) */
+gunzip_thread(gunzip_t *g)		/* I - Input file */
+{
+  int	count,				/* Bytes read */
+	zerror;				/* zlib error */
+  size_t fill;				/* Buffer to fill */
 
-		      DEBUG_printf("C comment: <<<< %s >>>\n", commstr);
 
-		      state = STATE_NONE;
-		      break;
-		    }
-		    else
-		    {
-		      while (ch == '*')
-		        ch = filebuf_getc(file);
+  for (;;)
+  {
+    pthread_mutex_lock(&g->mutex);
 
-		      if (ch != ' ')
-		        filebuf_ungetc(file, ch);
+    while (!g->cancel && g->count >= GUNZIP_BUFFERS)
+      pthread_cond_wait(&g->cond, &g->mutex);
 
-		      ch = EOF;
-		      break;
-		    }
-		  }
-		  else if (ch == '\n' && stringbuf_length(&buffer) > 0)
-		    stringbuf_append(&buffer, ch);
-		  else if (!isspace(ch & 255))
-		    break;
-		}
+    if (g->cancel)
+    {
+      pthread_mutex_unlock(&g->mutex);
+      break;
+    }
 
-		if (ch != EOF)
-		  filebuf_ungetc(file, ch);
+    fill = g->next_fill;
 
-                if (stringbuf_length(&buffer) > 0)
-		  stringbuf_append(&buffer, '\n');
-		break;
+    pthread_mutex_unlock(&g->mutex);
 
-	    case '/' :
-	        if (ch == '/' && stringbuf_getlast(&buffer) == '*')
-		{
-		  char *commstr = stringbuf_get(&buffer);
-		  char *commptr = commstr + strlen(commstr) - 1;
+    if ((count = gzread(g->gz, g->buffers[fill], GUNZIP_SIZE)) <= 0)
+      gzerror(g->gz, &zerror);
+    else
+      zerror = Z_OK;
 
-		  while (commptr > commstr && (commptr[-1] == '*' || isspace(commptr[-1] & 255)))
-		    commptr --;
+    pthread_mutex_lock(&g->mutex);
 
-		  *commptr = '\0';
+    if (count > 0)
+    {
+      g->lengths[fill] = (size_t)count;
+      g->next_fill     = (fill + 1) % GUNZIP_BUFFERS;
+      g->count ++;
+    }
+    else
+    {
+      g->eof   = true;
+      g->error = count < 0 || zerror != Z_OK;
+    }
 
-        	  if (mxmlGetFirstChild(comment) != mxmlGetLastChild(comment))
-		  {
-		    DEBUG_printf("    removing comment %p(%20.20s), last comment %p(%20.20s)...\n", mxmlGetFirstChild(comment), mxmlGetFirstChild(comment) ? get_nth_text(comment, 0, NULL) : "", mxmlGetLastChild(comment), mxmlGetLastChild(comment) ? get_nth_text(comment, -1, NULL) : "");
+    pthread_cond_broadcast(&g->cond);
+    pthread_mutex_unlock(&g->mutex);
 
-		    mxmlAdd(Garbage, MXML_ADD_AFTER, NULL, mxmlGetFirstChild(comment));
+    if (count <= 0)
+      break;
+  }
 
-		    DEBUG_printf("    new comment %p, last comment %p...\n", mxmlGetFirstChild(comment), mxmlGetLastChild(comment));
-		  }
+  return (NULL);
+}
+#endif /* HAVE_PTHREAD_H */
 
-                  DEBUG_printf("    processing comment, variable=%p, constant=%p, typedefnode=%p, tree=\"%s\"\n", variable, constant, typedefnode, mxmlGetElement(tree));
 
-		  if (variable)
-		  {
-		    if (strstr(commstr, "@private@"))
-		    {
-		     /*
-		      * Delete private variables...
-		      */
+/*
+ * 'gzip_write()' - Write data to a gzip-compressed file.
+ */
 
-		      mxmlAdd(Garbage, MXML_ADD_AFTER, NULL, variable);
-		    }
-		    else
-		    {
-		      description = mxmlNewElement(variable, "description");
+static size_t				/* O - Number of bytes written or 0 on error */
+gzip_write(gzFile     gz,		/* I - Output file */
+           const void *buffer,		/* I - Buffer */
+           size_t     bytes)		/* I - Number of bytes to write */
+{
+  if (gzwrite(gz, buffer, (unsigned)bytes) != (int)bytes)
+    return (0);
+  else
+    return (bytes);
+}
 
-		      DEBUG_printf("    adding comment %p/%p to variable...\n", mxmlGetLastChild(comment), mxmlGetFirstChild(comment));
 
-		      mxmlNewOpaque(comment, commstr);
-		      update_comment(variable, mxmlNewOpaque(description, commstr));
-                    }
+/*
+ * 'html_gets()' - Get a HTML fragment.
+ *
+ * Returns a HTML fragment like "<element attr='value'>", "some text", and
+ * "</element>".
+ */
 
-		    variable = NULL;
-		  }
-		  else if (constant)
-		  {
-		    if (strstr(commstr, "@private@"))
-		    {
-		     /*
-		      * Delete private constants...
-		      */
+static char *				/* O - Attribute or `NULL` */
+html_gets(FILE	 *fp,			/* I - File to read from */
+	  char	 *fragment,		/* I - Fragment string buffer */
+	  size_t fragsize)		/* I - Size of buffer */
+{
+  int	ch;				/* Current character */
+  char	*fragptr,			/* Pointer into buffer */
+	*fragend;			/* Pointer to end of buffer */
 
-		      mxmlAdd(Garbage, MXML_ADD_AFTER, NULL, constant);
-		    }
-		    else
-		    {
-		      description = mxmlNewElement(constant, "description");
 
-		      DEBUG_printf("    adding comment %p/%p to constant...\n", mxmlGetLastChild(comment), mxmlGetFirstChild(comment));
+ /*
+  * Read the fragment...
+  */
 
-		      mxmlNewOpaque(comment, commstr);
-		      update_comment(constant, mxmlNewOpaque(description, commstr));
-		    }
+  fragptr = fragment;
+  fragend = fragment + fragsize - 1;
 
-		    constant = NULL;
-		  }
-		  else if (typedefnode)
-		  {
-		    if (strstr(commstr, "@private@"))
-		    {
-		     /*
-		      * Delete private typedefs...
-		      */
+  if ((ch = getc(fp)) == EOF)
+  {
+    *fragment = '\0';
+    return (NULL);
+  }
 
-		      mxmlAdd(Garbage, MXML_ADD_AFTER, NULL, typedefnode);
+  *fragptr++ = (char)ch;
 
-		      if (structclass)
-		      {
-			mxmlAdd(Garbage, MXML_ADD_AFTER, NULL, structclass);
-			structclass = NULL;
-		      }
+  if (ch == '<')
+  {
+   /*
+    * Read element or comment...
+    */
 
-		      if (enumeration)
-		      {
-			mxmlAdd(Garbage, MXML_ADD_AFTER, NULL, enumeration);
-			enumeration = NULL;
-		      }
-		    }
-		    else
-		    {
-		      description = mxmlNewElement(typedefnode, "description");
+    while ((ch = getc(fp)) != EOF)
+    {
+      if (fragptr < fragend)
+	*fragptr++ = (char)ch;
 
-		      DEBUG_printf("    adding comment %p/%p to typedef %s...\n", mxmlGetLastChild(comment), mxmlGetFirstChild(comment), mxmlElementGetAttr(typedefnode, "name"));
+      if (ch == '>')
+      {
+       /*
+        * End of element/comment/processing directive...
+        */
 
-		      mxmlNewOpaque(comment, commstr);
-		      update_comment(typedefnode, mxmlNewOpaque(description, commstr));
+	break;
+      }
+      else if (ch == '\"' || ch == '\'')
+      {
+       /*
+	* Read quoted string...
+	*/
 
-		      if (structclass)
-		      {
-			description = mxmlNewElement(structclass, "description");
-			update_comment(structclass, mxmlNewOpaque(description, commstr));
-		      }
-		      else if (enumeration)
-		      {
-			description = mxmlNewElement(enumeration, "description");
-			update_comment(enumeration, mxmlNewOpaque(description, commstr));
-		      }
-		    }
+	int quote = ch;
 
-		    typedefnode = NULL;
-		  }
-		  else if (strcmp(mxmlGetElement(tree), "codedoc") && !mxmlFindElement(tree, tree, "description", NULL, NULL, MXML_DESCEND_FIRST))
-                  {
-        	    description = mxmlNewElement(tree, "description");
+	while ((ch = getc(fp)) != EOF)
+	{
+	  if (fragptr < fragend)
+	    *fragptr++ = (char)ch;
 
-		    DEBUG_printf("    adding comment %p/%p to parent...\n", mxmlGetLastChild(comment), mxmlGetFirstChild(comment));
+	  if (ch == quote)
+	    break;
+	}
+      }
+    }
 
-		    mxmlNewOpaque(comment, commstr);
-		    update_comment(tree, mxmlNewOpaque(description, commstr));
-		  }
-		  else
-        	    mxmlNewOpaque(comment, commstr);
+    *fragptr = '\0';
+  }
+  else
+  {
+   /*
+    * Read text...
+    */
 
-		  DEBUG_printf("C comment: <<<< %s >>>\n", commstr);
+    while ((ch = getc(fp)) != EOF)
+    {
+      if (ch == '<')
+      {
+	ungetc(ch, fp);
+	break;
+      }
+      else if (fragptr < fragend)
+	*fragptr++ = (char)ch;
+    }
 
-		  state = STATE_NONE;
-		  break;
-		}
+    *fragptr = '\0';
 
-	    default :
-	        if (ch == ' ' && stringbuf_length(&buffer) == 0)
-		  break;
+    html_unescape(fragment);
+  }
 
-		stringbuf_append(&buffer, ch);
-		break;
-          }
-          break;
+  return (fragment);
+}
 
-      case STATE_CXX_COMMENT :		/* Inside a C++ comment */
-          if (ch == '\n')
-	  {
-	    if ((ch = filebuf_getc(file)) == '/')
-	    {
-	      if ((ch = filebuf_getc(file)) == '/')
-	      {
-		stringbuf_append(&buffer, '\n');
 
-                if ((ch = filebuf_getc(file)) != ' ')
-                  filebuf_ungetc(file, ch);
-		break;
-	      }
-	      else
-	      {
-		filebuf_ungetc(file, ('/' << 8) | ch);
-	      }
-	    }
-	    else
-	      filebuf_ungetc(file, ch);
+/*
+ * 'html_unescape()' - Replace &foo; with corresponding characters.
+ */
 
-	    char *commstr = stringbuf_get(&buffer);
+static void
+html_unescape(char *buffer)		/* I - Buffer */
+{
+  char	*inptr,				/* Current input pointer */
+	*outptr;			/* Current output pointer */
 
-	    state = STATE_NONE;
 
-            if (mxmlGetFirstChild(comment) != mxmlGetLastChild(comment))
-	    {
-	      DEBUG_printf("    removing comment %p(%20.20s), last comment %p(%20.20s)...\n", mxmlGetFirstChild(comment), mxmlGetFirstChild(comment) ? get_nth_text(comment, 0, NULL) : "", mxmlGetLastChild(comment), mxmlGetLastChild(comment) ? get_nth_text(comment, -1, NULL) : "");
+ /*
+  * See if there are any escaped characters to work with...
+  */
 
-	      mxmlAdd(Garbage, MXML_ADD_AFTER, NULL, mxmlGetFirstChild(comment));
+  if ((inptr = strchr(buffer, '&')) == NULL)
+    return;				/* Nope */
 
-	      DEBUG_printf("    new comment %p, last comment %p...\n", mxmlGetFirstChild(comment), mxmlGetLastChild(comment));
-	    }
+  for (outptr = inptr; *inptr;)
+  {
+    if (*inptr == '&' && strchr(inptr + 1, ';'))
+    {
+     /*
+      * Figure out what kind of escaped character we have...
+      */
 
-	    if (variable)
-	    {
-	      if (strstr(commstr, "@private@"))
-	      {
-	       /*
-		* Delete private variables...
-		*/
+      inptr ++;
+      if (!strncmp(inptr, "amp;", 4))
+      {
+	inptr += 4;
+	*outptr++ = '&';
+      }
+      else if (!strncmp(inptr, "lt;", 3))
+      {
+	inptr += 3;
+	*outptr++ = '<';
+      }
+      else if (!strncmp(inptr, "gt;", 3))
+      {
+	inptr += 3;
+	*outptr++ = '>';
+      }
+      else if (!strncmp(inptr, "quot;", 5))
+      {
+	inptr += 5;
+	*outptr++ = '\"';
+      }
+      else if (!strncmp(inptr, "apos;", 5))
+      {
+	inptr += 5;
+	*outptr++ = '\'';
+      }
+      else if (*inptr == '#')
+      {
+       /*
+	* Numeric, copy character over as UTF-8...
+	*/
 
-		mxmlAdd(Garbage, MXML_ADD_AFTER, NULL, variable);
-	      }
-	      else
-	      {
-		description = mxmlNewElement(variable, "description");
+	int ch;				/* Numeric character value */
 
-		DEBUG_printf("    adding comment %p/%p to variable...\n", mxmlGetLastChild(comment), mxmlGetFirstChild(comment));
+	inptr ++;
+	if (*inptr == 'x')
+	  ch = (int)strtol(inptr, NULL, 16);
+	else
+	  ch = (int)strtol(inptr, NULL, 10);
 
-		mxmlNewOpaque(comment, commstr);
-		update_comment(variable, mxmlNewOpaque(description, commstr));
-              }
+	if (ch < 0x80)
+	{
+	 /*
+	  * US ASCII
+	  */
 
-	      variable = NULL;
-	    }
-	    else if (constant)
-	    {
-	      if (strstr(commstr, "@private@"))
-	      {
-	       /*
-		* Delete private constants...
-		*/
+	  *outptr++ = ch;
+	}
+	else if (ch < 0x800)
+	{
+	 /*
+	  * Two-byte UTF-8
+	  */
 
-		mxmlAdd(Garbage, MXML_ADD_AFTER, NULL, constant);
-	      }
-	      else
-	      {
-		description = mxmlNewElement(constant, "description");
+	  *outptr++ = 0xc0 | (ch >> 6);
+	  *outptr++ = 0x80 | (ch & 0x3f);
+	}
+	else if (ch < 0x10000)
+	{
+	 /*
+	  * Three-byte UTF-8
+	  */
 
-		DEBUG_printf("    adding comment %p/%p to constant...\n", mxmlGetLastChild(comment), mxmlGetFirstChild(comment));
+	  *outptr++ = 0xe0 | (ch >> 12);
+	  *outptr++ = 0x80 | ((ch >> 6) & 0x3f);
+	  *outptr++ = 0x80 | (ch & 0x3f);
+	}
+	else
+	{
+	 /*
+	  * Four-byte UTF-8
+	  */
 
-		mxmlNewOpaque(comment, commstr);
-		update_comment(constant, mxmlNewOpaque(description, commstr));
-              }
+	  *outptr++ = 0xf0 | (ch >> 18);
+	  *outptr++ = 0x80 | ((ch >> 12) & 0x3f);
+	  *outptr++ = 0x80 | ((ch >> 6) & 0x3f);
+	  *outptr++ = 0x80 | (ch & 0x3f);
+	}
 
-	      constant = NULL;
-	    }
-	    else if (typedefnode)
-	    {
-	      if (strstr(commstr, "@private@"))
-	      {
-	       /*
-		* Delete private typedefs...
-		*/
+	inptr = strchr(inptr, ';') + 1;
+      }
+      else
+      {
+       /*
+	* Something else not supported by XML...
+	*/
 
-		mxmlAdd(Garbage, MXML_ADD_AFTER, NULL, typedefnode);
+	*outptr++ = '&';
+      }
+    }
+    else
+    {
+     /*
+      * Copy literal...
+      */
 
-		if (structclass)
-		{
-		  mxmlAdd(Garbage, MXML_ADD_AFTER, NULL, structclass);
-		  structclass = NULL;
-		}
+      *outptr++ = *inptr++;
+    }
+  }
 
-		if (enumeration)
-		{
-		  mxmlAdd(Garbage, MXML_ADD_AFTER, NULL, enumeration);
-		  enumeration = NULL;
-		}
-	      }
-	      else
-	      {
-		description = mxmlNewElement(typedefnode, "description");
+  *outptr = '\0';
+}
 
-		DEBUG_printf("    adding comment %p/%p to typedef %s...\n", mxmlGetLastChild(comment), mxmlGetFirstChild(comment), mxmlElementGetAttr(typedefnode, "name"));
 
-		mxmlNewOpaque(comment, commstr);
-		update_comment(typedefnode, mxmlNewOpaque(description, commstr));
+/*
+ * 'image_read()' - Read the intrinsic size of a PNG, JPEG, GIF, or SVG image.
+ */
 
-		if (structclass)
-		{
-		  description = mxmlNewElement(structclass, "description");
-		  update_comment(structclass, mxmlNewOpaque(description, commstr));
-		}
-		else if (enumeration)
-		{
-		  description = mxmlNewElement(enumeration, "description");
-		  update_comment(enumeration, mxmlNewOpaque(description, commstr));
-		}
-              }
+static bool				/* O - `true` on success, `false` otherwise */
+image_read(const char *filename,	/* I - Image file */
+           int        *width,		/* O - Width in pixels */
+           int        *height)		/* O - Height in pixels */
+{
+  FILE		*fp;			/* Image file */
+  unsigned char	buffer[16384];		/* Header buffer */
+  size_t	bytes;			/* Bytes in buffer */
+  double	w = 0.0,		/* Width */
+		h = 0.0;		/* Height */
 
-	      typedefnode = NULL;
-	    }
-	    else if (strcmp(mxmlGetElement(tree), "codedoc") && !mxmlFindElement(tree, tree, "description", NULL, NULL, MXML_DESCEND_FIRST))
-            {
-              description = mxmlNewElement(tree, "description");
 
-	      DEBUG_printf("    adding comment %p/%p to parent...\n", mxmlGetLastChild(comment), mxmlGetFirstChild(comment));
+  if ((fp = fopen(filename, "rb")) == NULL)
+    return (false);
 
-	      mxmlNewOpaque(comment, commstr);
-	      update_comment(tree, mxmlNewOpaque(description, commstr));
-	    }
-	    else if (!strncmp(commstr, "@body@", 6))
-	    {
-	     /*
-	      * Append comment as body text...
-	      */
+  bytes         = fread(buffer, 1, sizeof(buffer) - 1, fp);
+  buffer[bytes] = '\0';
 
-	      *body = mmdLoadString(*body, commstr + 6);
-	    }
-	    else
-              mxmlNewOpaque(comment, commstr);
+  if (bytes >= 24 && !memcmp(buffer, "\211PNG\r\n\032\n", 8) && !memcmp(buffer + 12, "IHDR", 4))
+  {
+   /*
+    * PNG - IHDR chunk is always first...
+    */
 
-	    DEBUG_printf("C++ comment: <<<< %s >>>\n", commstr);
-	  }
-	  else
-	    stringbuf_append(&buffer, ch);
-          break;
+    w = (double)(((unsigned)buffer[16] << 24) | ((unsigned)buffer[17] << 16) | ((unsigned)buffer[18] << 8) | buffer[19]);
+    h = (double)(((unsigned)buffer[20] << 24) | ((unsigned)buffer[21] << 16) | ((unsigned)buffer[22] << 8) | buffer[23]);
+  }
+  else if (bytes >= 10 && (!memcmp(buffer, "GIF87a", 6) || !memcmp(buffer, "GIF89a", 6)))
+  {
+   /*
+    * GIF - logical screen size follows the signature...
+    */
 
-      case STATE_STRING :		/* Inside a string constant */
-	  stringbuf_append(&buffer, ch);
+    w = buffer[6] | (buffer[7] << 8);
+    h = buffer[8] | (buffer[9] << 8);
+  }
+  else if (bytes >= 4 && buffer[0] == 0xff && buffer[1] == 0xd8)
+  {
+   /*
+    * JPEG - walk the markers up to the SOFn segment, noting any EXIF
+    * orientation that rotates the image by 90 degrees...
+    */
 
-          if (ch == '\\')
-	    stringbuf_append(&buffer, filebuf_getc(file));
-	  else if (ch == '\"')
-	  {
-	    if (type)
-	      mxmlNewText(type, mxmlGetFirstChild(type) != NULL, stringbuf_get(&buffer));
+    long	pos = 2;		/* Position of marker */
+    int		marker,			/* Marker */
+		length;			/* Length of segment */
+    bool	rotated = false;	/* Rotated by 90 degrees? */
+    unsigned char *seg;			/* Segment data */
 
-	    state = STATE_NONE;
-	  }
-          break;
+    while (!fseek(fp, pos, SEEK_SET))
+    {
+      if (getc(fp) != 0xff)
+        break;
 
-      case STATE_CHARACTER :		/* Inside a character constant */
-	  stringbuf_append(&buffer, ch);
+      while ((marker = getc(fp)) == 0xff);
 
-          if (ch == '\\')
-	    stringbuf_append(&buffer, filebuf_getc(file));
-	  else if (ch == '\'')
-	  {
-	    if (type)
-	      mxmlNewText(type, mxmlGetFirstChild(type) != NULL, stringbuf_get(&buffer));
+      if (marker == EOF || marker == 0xd9 || marker == 0xda)
+        break;
 
-	    state = STATE_NONE;
-	  }
-          break;
+      if ((marker >= 0xd0 && marker <= 0xd7) || marker == 0x01)
+      {
+        pos = ftell(fp);
+        continue;
+      }
 
-      case STATE_IDENTIFIER :		/* Inside a keyword or identifier */
-	  if (isalnum(ch & 255) || ch == '_' || ch == '[' || ch == ']' || (ch == ',' && (parens > 1 || (type && !enumeration && !function))) || (ch == ',' && parens > 0 && typedefnode) || ch == ':' || ch == '.' || ch == '~')
-	  {
-	    stringbuf_append(&buffer, ch);
-	  }
-	  else
-	  {
-	    char *ptr, *str = stringbuf_get(&buffer);
+      if ((length = getc(fp)) == EOF)
+        break;
+      length = (length << 8) | getc(fp);
+      if (length < 2)
+        break;
 
-	    filebuf_ungetc(file, ch);
+      bytes = (size_t)length - 2;
+      if (bytes > sizeof(buffer))
+        bytes = sizeof(buffer);
+      if (fread(buffer, 1, bytes, fp) != bytes)
+        break;
 
-	    state = STATE_NONE;
+      if (marker >= 0xc0 && marker <= 0xcf && marker != 0xc4 && marker != 0xc8 && marker != 0xcc)
+      {
+        if (bytes >= 5)
+        {
+          h = (buffer[1] << 8) | buffer[2];
+          w = (buffer[3] << 8) | buffer[4];
 
-            DEBUG_printf("    braces=%d, type=%p, type->child=%p, buffer=\"%s\"\n", braces, type, type ? mxmlGetFirstChild(type) : NULL, str);
+          if (rotated)
+          {
+            double temp = w;		/* Swap width and height */
 
-            if (!braces)
-	    {
-	      if (!strcmp(str, "namespace"))
-	      {
-	        nskeyword = 1;
-	        break;
-	      }
-	      else if (nskeyword)
-	      {
-	        strlcpy(nsnamestr, str, sizeof(nsnamestr));
-	        break;
-	      }
+            w = h;
+            h = temp;
+          }
+        }
+        break;
+      }
+      else if (marker == 0xe1 && bytes >= 14 && !memcmp(buffer, "Exif\0\0", 6))
+      {
+       /*
+        * Look for the Orientation (0x0112) tag in IFD0 of the TIFF header...
+        */
 
-	      if (!type || !mxmlGetFirstChild(type))
-	      {
-		if (!strcmp(mxmlGetElement(tree), "class"))
-		{
-		  if (!strcmp(str, "public") || !strcmp(str, "public:"))
-		  {
-		    scope = "public";
+        bool	little = buffer[6] == 'I';
+					/* Little-endian TIFF data? */
+        size_t	ifd,			/* Offset of IFD0 */
+		count;			/* Number of IFD entries */
 
-		    DEBUG_puts("    scope = public\n");
-		    break;
-		  }
-		  else if (!strcmp(str, "private") || !strcmp(str, "private:"))
-		  {
-		    scope = "private";
+        seg = buffer + 6;
+        ifd = little ? (size_t)(seg[4] | (seg[5] << 8) | (seg[6] << 16) | ((unsigned)seg[7] << 24)) : (size_t)(((unsigned)seg[4] << 24) | (seg[5] << 16) | (seg[6] << 8) | seg[7]);
 
-		    DEBUG_puts("    scope = private\n");
-		    break;
-		  }
-		  else if (!strcmp(str, "protected") || !strcmp(str, "protected:"))
-		  {
-		    scope = "protected";
+        if (ifd + 2 <= bytes - 6)
+        {
+          count = little ? (size_t)(seg[ifd] | (seg[ifd + 1] << 8)) : (size_t)((seg[ifd] << 8) | seg[ifd + 1]);
 
-		    DEBUG_puts("    scope = protected\n");
-		    break;
-		  }
-		}
-	      }
+          for (seg += ifd + 2; count > 0 && seg + 12 <= buffer + bytes; count --, seg += 12)
+          {
+            if ((little && seg[0] == 0x12 && seg[1] == 0x01) || (!little && seg[0] == 0x01 && seg[1] == 0x12))
+            {
+              int orientation = little ? seg[8] : seg[9];
+					/* Orientation value */
 
-	      if (!type)
-                type = mxmlNewElement(/*parent*/NULL, "type");
+              rotated = orientation >= 5 && orientation <= 8;
+              break;
+            }
+          }
+        }
+      }
 
-              DEBUG_printf("    function=%p (%s), type->child=%p, ch='%c', parens=%d\n", function, function ? mxmlElementGetAttr(function, "name") : "null", mxmlGetFirstChild(type), ch, parens);
+      pos += 2 + length;
+    }
+  }
+  else
+  {
+   /*
+    * SVG - use the width and height of the root element or its viewBox...
+    */
 
-              if (!function && ch == '(')
-	      {
-	        if (mxmlGetFirstChild(type) && !strcmp(mxmlGetText(mxmlGetFirstChild(type), NULL), "extern"))
-		{
-		 /*
-		  * Remove external declarations...
-		  */
+    char	*ptr,			/* Pointer into header */
+		*name,			/* Attribute name */
+		*value,			/* Attribute value */
+		*end,			/* End of number */
+		quote;			/* Quote character */
+    size_t	namelen;		/* Length of attribute name */
+    double	vbw = 0.0,		/* viewBox width */
+		vbh = 0.0;		/* viewBox height */
 
-		  mxmlAdd(Garbage, MXML_ADD_AFTER, NULL, type);
-		  type = NULL;
-		  break;
-		}
+    for (ptr = (char *)buffer; (ptr = strstr(ptr, "<svg")) != NULL; ptr += 4)
+    {
+      if (isspace(ptr[4] & 255))
+        break;
+    }
 
-	        function = mxmlNewElement(/*parent*/NULL, "function");
-		if ((ptr = strchr(str, ':')) != NULL && ptr[1] == ':')
-		{
-		  char name[1024];	/* Struct/class name */
+    if (ptr)
+      ptr += 4;
 
-		  *ptr = '\0';
-		  ptr += 2;
+    while (ptr && *ptr && *ptr != '>')
+    {
+      if (isspace(*ptr & 255))
+      {
+        ptr ++;
+        continue;
+      }
 
-                  if (nsname)
-                    snprintf(name, sizeof(name), "%s::%s", nsname, str);
-                  else
-                    strlcpy(name, str, sizeof(name));
+     /*
+      * Get the next name="value" pair...
+      */
 
-                  DEBUG_printf("looking for struct or class '%s' under %p(%s)...\n", name, tree, mxmlGetElement(tree));
-		  if ((fstructclass = mxmlFindElement(tree, tree, "class", "name", name, MXML_DESCEND_FIRST)) == NULL)
-		    fstructclass = mxmlFindElement(tree, tree, "struct", "name", name, MXML_DESCEND_FIRST);
-                  DEBUG_printf("fstructclass=%p\n", fstructclass);
-		}
-		else
-		  ptr = str;
+      for (name = ptr; *ptr && *ptr != '=' && *ptr != '>' && !isspace(*ptr & 255); ptr ++);
 
-                if (nsname && !fstructclass && !tree_is_scu)
-                  mxmlElementSetAttrf(function, "name", "%s::%s", nsname, ptr);
-                else
-		  mxmlElementSetAttr(function, "name", ptr);
+      if (*ptr != '=')
+        continue;
 
-		if (scope)
-		  mxmlElementSetAttr(function, "scope", scope);
+      namelen = (size_t)(ptr - name);
+      ptr ++;
 
-                DEBUG_printf("function: %s\n", mxmlElementGetAttr(function, "name"));
-		DEBUG_printf("    scope = %s\n", scope ? scope : "(null)");
-		DEBUG_printf("    comment = %p\n", comment);
-		DEBUG_printf("    child = (%p) %s\n", mxmlGetFirstChild(comment), get_nth_text(comment, 0, NULL));
-		DEBUG_printf("    last_child = (%p) %s\n", mxmlGetLastChild(comment), get_nth_text(comment, -1, NULL));
+      if (*ptr != '\"' && *ptr != '\'')
+        break;
 
-                if (mxmlGetLastChild(type) && (strcmp(get_nth_text(type, -1, NULL), "void") || !strcmp(get_nth_text(type, 0, NULL), "static")))
-		{
-                  returnvalue = mxmlNewElement(function, "returnvalue");
+      quote = *ptr++;
+      value = ptr;
 
-		  mxmlAdd(returnvalue, MXML_ADD_AFTER, /*parent*/NULL, type);
+      if ((ptr = strchr(value, quote)) == NULL)
+        break;
 
-		  description = mxmlNewElement(returnvalue, "description");
+      *ptr++ = '\0';
 
-		  DEBUG_printf("    adding comment %p/%p to returnvalue...\n", mxmlGetLastChild(comment), mxmlGetFirstChild(comment));
+      if (namelen == 5 && !strncmp(name, "width", 5))
+      {
+       /*
+        * Only use sizes in pixels, not percentages or other units...
+        */
 
-		  update_comment(returnvalue, mxmlGetLastChild(comment));
-		  mxmlAdd(description, MXML_ADD_AFTER, /*parent*/NULL, mxmlGetLastChild(comment));
-                }
-		else
-		  mxmlAdd(Garbage, MXML_ADD_AFTER, NULL, type);
+        w = strtod(value, &end);
+        if (end == value || (*end && strcmp(end, "px")))
+          w = 0.0;
+      }
+      else if (namelen == 6 && !strncmp(name, "height", 6))
+      {
+        h = strtod(value, &end);
+        if (end == value || (*end && strcmp(end, "px")))
+          h = 0.0;
+      }
+      else if (namelen == 7 && !strncmp(name, "viewBox", 7))
+      {
+       /*
+        * viewBox="min-x min-y width height"
+        */
 
-		description = mxmlNewElement(function, "description");
+        strtod(value, &end);
+        strtod(end + strspn(end, " ,"), &end);
+        vbw = strtod(end + strspn(end, " ,"), &end);
+        vbh = strtod(end + strspn(end, " ,"), &end);
+      }
+    }
 
-		DEBUG_printf("    adding comment %p/%p to function...\n", mxmlGetLastChild(comment), mxmlGetFirstChild(comment));
+    if (w <= 0.0 || h <= 0.0)
+    {
+      w = vbw;
+      h = vbh;
+    }
+  }
 
-		update_comment(function, mxmlGetLastChild(comment));
-		mxmlAdd(description, MXML_ADD_AFTER, /*parent*/NULL, mxmlGetLastChild(comment));
+  fclose(fp);
 
-		type = NULL;
-	      }
-	      else if (function && ((ch == ')' && parens == 1) || ch == ','))
-	      {
-	       /*
-	        * Argument definition...
-		*/
+  if (w < 1.0 || h < 1.0 || w > 1000000.0 || h > 1000000.0)
+    return (false);
 
-                if (strcmp(str, "void"))
-		{
-		  const char *last_string = get_nth_text(type, -1, NULL);
+  *width  = (int)(w + 0.5);
+  *height = (int)(h + 0.5);
 
-	          mxmlNewText(type, mxmlGetFirstChild(type) != NULL && *last_string != '(' && *last_string != '*', str);
+  return (true);
+}
 
-                  DEBUG_printf("Argument: <<<< %s >>>\n", str);
 
-	          variable = add_variable(function, "argument", type);
-		}
-		else
-		  mxmlAdd(Garbage, MXML_ADD_AFTER, NULL, type);
+/*
+ * 'image_size()' - Get the intrinsic size of a local image, reading it once.
+ *
+ * Sizes are cached by filename and modification time so that an image used
+ * many times in a document is only read once.
+ */
 
-		type = NULL;
-	      }
-              else if (mxmlGetFirstChild(type) && !function && parens == 0 && (ch == ';' || ch == ','))
-	      {
-	        DEBUG_printf("    got %s, typedefnode=%p, structclass=%p\n", ch == ';' ? "semicolon" : "comma", typedefnode, structclass);
-#if DEBUG > 1
-		mxml_node_t *debugnode;
-		for (debugnode = mxmlGetFirstChild(type); debugnode; debugnode = mxmlGetNextSibling(debugnode))
-		  DEBUG_printf("    type child=%p (%s)\n", debugnode, mxmlGetText(debugnode, NULL));
-#endif // DEBUG > 1
+static bool				/* O - `true` if the size is known, `false` otherwise */
+image_size(const char *filename,	/* I - Image file */
+           int        *width,		/* O - Width in pixels */
+           int        *height)		/* O - Height in pixels */
+{
+  struct stat	fileinfo;		/* File information */
+  size_t	left,			/* Left side of search */
+		right,			/* Right side of search */
+		current;		/* Current entry */
+  int		result;			/* Result of comparison */
+  image_t	*image;			/* Cached image */
 
-	        if (typedefnode || structclass)
-	        {
-                  DEBUG_printf("Typedef/struct/class: <<<< %s >>>>\n", str);
 
-	          if (*str != '_')
-		  {
-		    if (typedefnode)
-		    {
-		      if (nsname)
-			mxmlElementSetAttrf(typedefnode, "name", "%s::%s", nsname, str);
-		      else
-			mxmlElementSetAttr(typedefnode, "name", str);
+  if (stat(filename, &fileinfo))
+    return (false);
 
-		      sort_node(tree, typedefnode);
-		    }
+ /*
+  * Look for the image in the (sorted) cache...
+  */
 
-		    if (structclass && !mxmlElementGetAttr(structclass, "name"))
-		    {
-		      DEBUG_printf("setting struct/class name to \"%s\".\n", get_nth_text(type, -1, NULL));
-		      if (nsname)
-			mxmlElementSetAttrf(structclass, "name", "%s::%s", nsname, str);
-		      else
-			mxmlElementSetAttr(structclass, "name", str);
+  for (left = 0, right = Images.num_images; left < right;)
+  {
+    current = (left + right) / 2;
 
-		      sort_node(tree, structclass);
-		      structclass = NULL;
-		    }
+    if ((result = strcmp(filename, Images.images[current].filename)) == 0)
+      break;
+    else if (result < 0)
+      right = current;
+    else
+      left = current + 1;
+  }
 
-		    if (typedefnode)
-		      mxmlAdd(typedefnode, MXML_ADD_BEFORE, /*parent*/NULL, type);
-		    else
-		      mxmlAdd(Garbage, MXML_ADD_AFTER, NULL, type);
-		  }
+  if (left < right)
+  {
+    image = Images.images + current;
 
-		  type        = NULL;
-		  typedefnode = NULL;
-		}
-		else if (mxmlGetFirstChild(type) && !strcmp(mxmlGetText(mxmlGetFirstChild(type), NULL), "typedef"))
-		{
-		 /*
-		  * Simple typedef...
-		  */
+    if (image->mtime == fileinfo.st_mtime)
+      goto done;
+  }
+  else
+  {
+   /*
+    * Not cached, insert it at the right place...
+    */
 
-                  DEBUG_printf("Simple typedef: <<<< %s >>>\n", str);
+    char	*name;			/* Copy of filename */
 
-		  typedefnode = mxmlNewElement(/*parent*/NULL, "typedef");
-		  if (nsname)
-		    mxmlElementSetAttrf(typedefnode, "name", "%s::%s", nsname, str);
-		  else
-		    mxmlElementSetAttr(typedefnode, "name", str);
-		  mxmlAdd(Garbage, MXML_ADD_AFTER, NULL, mxmlGetFirstChild(type));
+    if (Images.num_images >= Images.alloc_images)
+    {
+      if ((image = realloc(Images.images, (Images.alloc_images + 64) * sizeof(image_t))) == NULL)
+        return (false);
 
-		  sort_node(tree, typedefnode);
+      Images.images       = image;
+      Images.alloc_images += 64;
+    }
 
-		  if (mxmlGetFirstChild(type))
-		    clear_whitespace(mxmlGetFirstChild(type));
+    if ((name = strdup(filename)) == NULL)
+      return (false);
 
-		  mxmlAdd(typedefnode, MXML_ADD_AFTER, /*parent*/NULL, type);
-		  type = NULL;
-		  DEBUG_printf("    New typedefnode=%p\n", typedefnode);
-		}
-		else if (!parens)
-		{
-		 /*
-	          * Variable definition...
-		  */
+    image = Images.images + left;
 
-                  mxml_node_t *child = mxmlGetFirstChild(type);
-                  const char *string = get_nth_text(type, -1, NULL);
+    if (left < Images.num_images)
+      memmove(image + 1, image, (Images.num_images - left) * sizeof(image_t));
 
-	          if (child && !strcmp(mxmlGetText(child, NULL), "static") && !strcmp(mxmlGetElement(tree), "codedoc"))
-		  {
-		   /*
-		    * Remove static functions...
-		    */
+    Images.num_images ++;
 
-		    mxmlAdd(Garbage, MXML_ADD_AFTER, NULL, type);
-		    type = NULL;
-		    break;
-		  }
+    image->filename = name;
+  }
 
-		  if (nsname && !fstructclass && !tree_is_scu)
-		    mxmlNewTextf(type, child != NULL && *string != '(' && *string != '*', "%s::%s", nsname, str);
-		  else
-		    mxmlNewText(type, child != NULL && *string != '(' && *string != '*', str);
+ /*
+  * Read the image header...
+  */
 
-                  DEBUG_printf("Variable: <<<< %s >>>>\n", str);
-                  DEBUG_printf("    scope = %s\n", scope ? scope : "(null)");
+  image->mtime = fileinfo.st_mtime;
 
-	          variable = add_variable(/*parent*/NULL, "variable", type);
-		  type     = NULL;
+  if (!image_read(filename, &image->width, &image->height))
+    image->width = image->height = 0;
 
-		  sort_node(tree, variable);
+  done:
 
-		  if (scope)
-		    mxmlElementSetAttr(variable, "scope", scope);
-		}
-              }
-	      else
-              {
-		mxml_node_t *child = mxmlGetFirstChild(type);
-		const char *string = get_nth_text(type, -1, NULL);
+  *width  = image->width;
+  *height = image->height;
 
-                DEBUG_printf("Identifier: <<<< %s >>>>\n", str);
+  return (image->width > 0);
+}
 
-	        mxmlNewText(type, child != NULL && *string != '(' && *string != '*', str);
-	      }
-	    }
-	    else if (enumeration && !isdigit(str[0] & 255))
-	    {
-	      DEBUG_printf("Constant: <<<< %s >>>\n", str);
 
-	      constant = mxmlNewElement(/*parent*/NULL, "constant");
-	      if (nsname)
-	        mxmlElementSetAttrf(constant, "name", "%s::%s", nsname, str);
-	      else
-	        mxmlElementSetAttr(constant, "name", str);
-	      sort_node(enumeration, constant);
-	    }
-	    else if (type)
-	    {
-	      mxmlAdd(Garbage, MXML_ADD_AFTER, NULL, type);
-	      type = NULL;
-	    }
-	  }
-          break;
-    }
+/*
+ * 'index_compare()' - Compare two symbol index entries.
+ */
 
-#if DEBUG > 1
-    if (state != oldstate)
-    {
-      DEBUG_printf("    changed states from %s to %s on receipt of character '%c'...\n", states[oldstate], states[state], oldch);
-      DEBUG_printf("    variable = %p\n", variable);
-      DEBUG_printf("    typedefnode = %p\n", typedefnode);
-      if (type)
-      {
-        DEBUG_puts("    type =");
-        for (temp = mxmlGetFirstChild(type); temp; temp = mxmlGetNextSibling(temp))
-	  DEBUG_printf(" \"%s\"", mxmlGetText(temp, NULL));
-	DEBUG_puts("\n");
-      }
-    }
-#endif /* DEBUG > 1 */
+static int				/* O - Result of comparison */
+index_compare(index_entry_t *a,		/* I - First entry */
+              index_entry_t *b)		/* I - Second entry */
+{
+  int	ret;				/* Result of comparison */
+
+
+  if ((ret = strcmp(a->name, b->name)) == 0)
+  {
+    if (a->offset < b->offset)
+      ret = -1;
+    else if (a->offset > b->offset)
+      ret = 1;
   }
 
-  mxmlAdd(Garbage, MXML_ADD_AFTER, NULL, comment);
+  return (ret);
+}
+
 
- /*
-  * All done, return with no errors...
-  */
+/*
+ * 'is_linked_type()' - Determine whether a name is a type that gets a link.
+ *
+ * The names collected by @link types_load@ are used when they are for the same
+ * tree and output mode, otherwise the tree is searched.
+ */
 
-  return (1);
+static bool				/* O - `true` if linked, `false` otherwise */
+is_linked_type(mxml_node_t *doc,	/* I - Documentation tree */
+               const char  *name,	/* I - Name */
+               bool        pub,		/* I - Only public types? */
+               int         mode)	/* I - Output mode for public types */
+{
+  if (Types.doc == doc && (!pub || Types.mode == mode))
+  {
+    if (pub)
+      return (Types.num_pub > 0 && bsearch(&name, Types.pub, Types.num_pub, sizeof(const char *), (int (*)(const void *, const void *))reserved_compare) != NULL);
+    else
+      return (Types.num_all > 0 && bsearch(&name, Types.all, Types.num_all, sizeof(const char *), (int (*)(const void *, const void *))reserved_compare) != NULL);
+  }
+  else if (pub)
+    return (find_public(doc, doc, "class", name, mode) || find_public(doc, doc, "enumeration", name, mode) || find_public(doc, doc, "struct", name, mode) || find_public(doc, doc, "typedef", name, mode) || find_public(doc, doc, "union", name, mode));
+  else
+    return (mxmlFindElement(doc, doc, "class", "name", name, MXML_DESCEND_ALL) || mxmlFindElement(doc, doc, "enumeration", "name", name, MXML_DESCEND_ALL) || mxmlFindElement(doc, doc, "struct", "name", name, MXML_DESCEND_ALL) || mxmlFindElement(doc, doc, "typedef", "name", name, MXML_DESCEND_ALL) || mxmlFindElement(doc, doc, "union", "name", name, MXML_DESCEND_ALL));
 }
 
 
 /*
- * 'sort_node()' - Insert a node sorted into a tree.
+ * 'is_markdown()' - Determine whether a file is markdown text.
  */
 
-static void
-sort_node(mxml_node_t *tree,		/* I - Tree to sort into */
-          mxml_node_t *node)		/* I - Node to add */
+static bool				/* O - `true` if markdown, `false` otherwise */
+is_markdown(const char *filename)	/* I - File to check */
 {
-  mxml_node_t	*temp;			/* Current node */
-  const char	*tempname,		/* Name of current node */
-		*nodename,		/* Name of node */
-		*scope;			/* Scope */
+  const char	*ext = filename ? strstr(filename, ".md") : NULL;
+					/* Pointer to extension */
 
+  return (ext && (!ext[3] || !strcmp(ext + 3, ".gz")));
+}
 
-#if DEBUG > 1
-  DEBUG_printf("    sort_node(tree=%p, node=%p)\n", tree, node);
-#endif /* DEBUG > 1 */
 
- /*
-  * Range check input...
-  */
+/*
+ * 'is_reserved()' - Determine whether a word is a C/C++ reserved word.
+ */
+
+static bool				/* O - `true` if reserved, `false` otherwise */
+is_reserved(const char *word)		/* I - Word */
+{
+  return (bsearch(&word, reserved_words, sizeof(reserved_words) / sizeof(reserved_words[0]), sizeof(const char *), (int (*)(const void *, const void *))reserved_compare) != NULL);
+}
+
+
+/*
+ * 'is_xml()' - Determine whether a file is an XML documentation file.
+ */
+
+static bool				/* O - `true` if XML, `false` otherwise */
+is_xml(const char *filename)		/* I - File to check */
+{
+  size_t	len = strlen(filename);	/* Length of filename */
 
-  if (!tree || !node || mxmlGetParent(node) == tree)
-    return;
+
+  return ((len > 4 && !strcmp(filename + len - 4, ".xml")) || (len > 7 && !strcmp(filename + len - 7, ".xml.gz")));
+}
+
+
+/*
+ * 'lookup_symbol()' - Get the documentation for a symbol.
+ *
+ * When the XML documentation file has an up-to-date index from
+ * @link write_index@, the index is binary-searched and only the records for
+ * the symbol are read.  Otherwise the symbol is found in the full XML file or
+ * the already loaded documentation.
+ */
+
+static mxml_node_t *			/* O - Documentation for the symbol or `NULL` if not found */
+lookup_symbol(const char  *xmlfile,	/* I - XML documentation file */
+              mxml_node_t *doc,		/* I - Loaded documentation or `NULL` */
+              const char  *name,	/* I - Name of symbol */
+              mxml_node_t **codedoc)	/* O - codedoc node */
+{
+  mxml_node_t	*symdoc,		/* Documentation for symbol */
+		*top = NULL,		/* Loaded XML file */
+		*node,			/* Current symbol */
+		*next;			/* Next symbol */
+  mxml_options_t *options;		/* Load options */
+  char		idxfile[1024],		/* Index filename */
+		header[256],		/* Expected header line */
+		*data = NULL,		/* Index contents */
+		*dataend,		/* End of index */
+		*left,			/* Left side of search */
+		*right,			/* Right side of search */
+		*line,			/* Current line */
+		*lineend,		/* End of current line */
+		*record;		/* Symbol record */
+  size_t	length = 0,		/* Length of index */
+		namelen = strlen(name),	/* Length of symbol name */
+		offset,			/* Offset of record */
+		reclen;			/* Length of record */
+  struct stat	xmlinfo,		/* XML file information */
+		idxinfo;		/* Index file information */
+  FILE		*fp;			/* XML file */
+  int		found = 0;		/* Number of records found */
+#ifndef _WIN32
+  int		fd;			/* Index file descriptor */
+#endif /* !_WIN32 */
+
+
+  symdoc  = new_documentation(codedoc);
+  options = mxmlOptionsNew();
+
+  mxmlOptionsSetTypeCallback(options, type_cb, /*cbdata*/NULL);
 
  /*
-  * Get the node name...
+  * Map the index if it is newer than the XML file...
   */
 
-  if ((nodename = mxmlElementGetAttr(node, "name")) == NULL)
+  snprintf(idxfile, sizeof(idxfile), "%s.idx", xmlfile);
+
+  if (!doc && !stat(xmlfile, &xmlinfo) && !stat(idxfile, &idxinfo) && idxinfo.st_mtime >= xmlinfo.st_mtime && idxinfo.st_size > 0)
   {
-#if DEBUG > 1
-    DEBUG_puts("        nodename not found.");
-#endif /* DEBUG > 1 */
-    return;
+#ifdef _WIN32
+    if (filebuf_read(idxfile, &data, &length))
+      data = NULL;
+#else
+    if ((fd = open(idxfile, O_RDONLY)) >= 0)
+    {
+      length = (size_t)idxinfo.st_size;
+
+      if ((data = mmap(NULL, length, PROT_READ, MAP_SHARED, fd, 0)) == MAP_FAILED)
+        data = NULL;
+
+      close(fd);
+    }
+#endif /* _WIN32 */
+
+    snprintf(header, sizeof(header), "codedoc-index 1.0 %lu\n", (unsigned long)xmlinfo.st_size);
+
+    if (data && (length < strlen(header) || memcmp(data, header, strlen(header))))
+    {
+     /*
+      * Index is for another version of the XML file...
+      */
+
+#ifdef _WIN32
+      free(data);
+#else
+      munmap(data, length);
+#endif /* _WIN32 */
+
+      data = NULL;
+    }
   }
 
-  if (nodename[0] == '_')
+  if (data && (fp = fopen(xmlfile, "rb")) != NULL)
   {
-#if DEBUG > 1
-    DEBUG_puts("        nodename=private");
-#endif /* DEBUG > 1 */
-    return;				/* Hide private names */
-  }
+   /*
+    * Binary search the "NAME<tab>KIND<tab>OFFSET<tab>LENGTH" lines for the
+    * first one with the symbol name...
+    */
 
-#if DEBUG > 1
-  DEBUG_printf("        nodename=%p (\"%s\")\n", nodename, nodename);
-#endif /* DEBUG > 1 */
+    dataend = data + length;
 
- /*
-  * Delete any existing definition at this level, if one exists...
-  */
+    for (left = data + strlen(header), right = dataend; left < right;)
+    {
+      for (line = left + (right - left) / 2; line > left && line[-1] != '\n'; line --);
+
+      if ((lineend = memchr(line, '\n', (size_t)(dataend - line))) == NULL)
+        lineend = dataend;
+
+      if (strncmp(line, name, namelen) < 0)
+        left = lineend + 1;
+      else
+        right = line;
+    }
 
-  if ((temp = mxmlFindElement(tree, tree, mxmlGetElement(node), "name", nodename, MXML_DESCEND_FIRST)) != NULL)
-  {
    /*
-    * Copy the scope if needed...
+    * Then read each record for the symbol...
     */
 
-    if ((scope = mxmlElementGetAttr(temp, "scope")) != NULL &&
-        mxmlElementGetAttr(node, "scope") == NULL)
+    for (line = left; line < dataend && !strncmp(line, name, namelen) && line[namelen] == '\t'; line = lineend + 1)
     {
-      DEBUG_printf("    copying scope %s for %s\n", scope, nodename);
+      if ((lineend = memchr(line, '\n', (size_t)(dataend - line))) == NULL)
+        lineend = dataend;
 
-      mxmlElementSetAttr(node, "scope", scope);
+      if ((line = memchr(line + namelen + 1, '\t', (size_t)(lineend - line - namelen - 1))) == NULL)
+        break;
+
+      offset = (size_t)strtoul(line + 1, &line, 10);
+      reclen = (size_t)strtoul(line, NULL, 10);
+
+      if ((record = malloc(reclen + 1)) == NULL)
+      {
+        fputs("codedoc: Unable to allocate memory for symbol.\n", stderr);
+        exit(1);
+      }
+
+      if (fseek(fp, (long)offset, SEEK_SET) || fread(record, 1, reclen, fp) != reclen)
+      {
+        free(record);
+        break;
+      }
+
+      record[reclen] = '\0';
+
+      if (mxmlLoadString(*codedoc, options, record))
+        found ++;
+
+      free(record);
     }
 
-    mxmlAdd(Garbage, MXML_ADD_AFTER, NULL, temp);
+    fclose(fp);
   }
+  else if (!doc)
+  {
+   /*
+    * No index, load the whole XML file...
+    */
 
- /*
-  * Add the node into the tree at the proper place...
-  */
+    if ((top = xmldoc_load(xmlfile)) == NULL)
+      fprintf(stderr, "codedoc: Unable to read the XML documentation file \"%s\".\n", xmlfile);
 
-  for (temp = mxmlGetFirstChild(tree); temp; temp = mxmlGetNextSibling(temp))
+    doc = top;
+  }
+
+  if (doc && (doc = mxmlFindElement(doc, doc, "codedoc", NULL, NULL, MXML_DESCEND_ALL)) != NULL)
   {
-#if DEBUG > 1
-    DEBUG_printf("        temp=%p\n", temp);
-#endif /* DEBUG > 1 */
+   /*
+    * Move the symbols with the name from the loaded documentation...
+    */
 
-    if ((tempname = mxmlElementGetAttr(temp, "name")) == NULL)
-      continue;
+    for (node = mxmlFindElement(doc, doc, NULL, "name", name, MXML_DESCEND_FIRST); node; node = next)
+    {
+      next = mxmlFindElement(node, doc, NULL, "name", name, MXML_DESCEND_NONE);
 
-#if DEBUG > 1
-    DEBUG_printf("        tempname=%p (\"%s\")\n", tempname, tempname);
-#endif /* DEBUG > 1 */
+      mxmlRemove(node);
+      mxmlAdd(*codedoc, MXML_ADD_AFTER, /*child*/NULL, node);
 
-    if (strcmp(nodename, tempname) < 0)
-      break;
+      found ++;
+    }
   }
 
-  if (temp)
-  {
-#if DEBUG > 1
-    DEBUG_printf("        adding \"%s\" before \"%s\"\n", nodename, tempname);
-#endif /* DEBUG > 1 */
+#ifdef _WIN32
+  free(data);
+#else
+  if (data)
+    munmap(data, length);
+#endif /* _WIN32 */
 
-    mxmlAdd(tree, MXML_ADD_BEFORE, temp, node);
-  }
-  else
-  {
-#if DEBUG > 1
-    DEBUG_printf("        adding \"%s\" to the end\n", nodename);
-#endif /* DEBUG > 1 */
+  mxmlDelete(top);
+  mxmlOptionsDelete(options);
 
-    mxmlAdd(tree, MXML_ADD_AFTER, /*parent*/NULL, node);
+  if (!found)
+  {
+    fprintf(stderr, "codedoc: No documentation for \"%s\" in \"%s\".\n", name, xmlfile);
+    mxmlDelete(symdoc);
+    symdoc   = NULL;
+    *codedoc = NULL;
   }
+
+  return (symdoc);
 }
 
 
 /*
- * 'stringbuf_append()' - Append a Unicode character to a string buffer.
+ * 'markdown_anchor()' - Return the HTML anchor for a given title.
+ *
+ * Headings use the unique anchors from @link anchors_get@ and "@" links use
+ * @link anchors_find@ - this function only converts title text, for "@" links
+ * to titles that are not in the document.
  */
 
-static int				/* O - 1 on success, 0 on failure */
-stringbuf_append(stringbuf_t *buffer,	/* I - String buffer */
-                 int         ch)	/* I - Character */
+static char *				/* O - HTML anchor */
+markdown_anchor(const char *text,	/* I - Title text */
+                char       *buffer,	/* I - Buffer for anchor string */
+                size_t     bufsize)	/* I - Size of buffer */
 {
-  if (ch < 0x80)
-  {
-    if (buffer->bufptr < (buffer->buffer + sizeof(buffer->buffer) - 1))
-    {
-      *(buffer->bufptr)++ = (char)ch;
-      return (1);
-    }
-  }
-  else if (ch < 0x800)
-  {
-    if (buffer->bufptr < (buffer->buffer + sizeof(buffer->buffer) - 2))
-    {
-      *(buffer->bufptr)++ = (char)(0xc0 | ((ch >> 6) & 0x1f));
-      *(buffer->bufptr)++ = (char)(0x80 | (ch & 0x3f));
-      return (1);
-    }
-  }
-  else if (ch < 0x10000)
-  {
-    if (buffer->bufptr < (buffer->buffer + sizeof(buffer->buffer) - 3))
-    {
-      *(buffer->bufptr)++ = (char)(0xe0 | ((ch >> 12) & 0x0f));
-      *(buffer->bufptr)++ = (char)(0x80 | ((ch >> 6) & 0x3f));
-      *(buffer->bufptr)++ = (char)(0x80 | (ch & 0x3f));
-      return (1);
-    }
-  }
-  else
+  char          *bufptr;                /* Pointer into buffer */
+
+
+  *buffer = '\0';
+
+  if (!text)
+    return (buffer);
+
+  for (bufptr = buffer; *text && bufptr < (buffer + bufsize - 1); text ++)
   {
-    if (buffer->bufptr < (buffer->buffer + sizeof(buffer->buffer) - 4))
-    {
-      *(buffer->bufptr)++ = (char)(0xf0 | ((ch >> 18) & 0x07));
-      *(buffer->bufptr)++ = (char)(0x80 | ((ch >> 12) & 0x3f));
-      *(buffer->bufptr)++ = (char)(0x80 | ((ch >> 6) & 0x3f));
-      *(buffer->bufptr)++ = (char)(0x80 | (ch & 0x3f));
-      return (1);
-    }
+    if ((*text >= '0' && *text <= '9') || (*text >= 'a' && *text <= 'z') || (*text >= 'A' && *text <= 'Z') || *text == '.' || *text == '-')
+      *bufptr++ = (char)tolower(*text);
+    else if (*text == ' ')
+      *bufptr++ = '-';
   }
 
-  return (0);
+  *bufptr = '\0';
+
+  return (buffer);
 }
 
 
 /*
- * 'stringbuf_clear()' - Clear a string buffer.
+ * 'markdown_load()' - Load a markdown file, which may be gzip-compressed.
  */
 
-static void
-stringbuf_clear(stringbuf_t *buffer)	/* I - String buffer */
+static mmd_t *				/* O - Root node in markdown or `NULL` on error */
+markdown_load(mmd_t      *root,		/* I - Root node for document or `NULL` for a new document */
+              const char *filename)	/* I - File to load */
 {
-  buffer->bufptr = buffer->buffer;
-}
-
+  gunzip_t	*g;			/* Input file */
 
-/*
- * 'stringbuf_get()' - Get a C string of a string buffer.
- */
 
-static char *				/* O - C string */
-stringbuf_get(stringbuf_t *buffer)	/* I - String buffer */
-{
-  *(buffer->bufptr) = '\0';
+  if ((g = gunzip_open(filename)) == NULL)
+    return (NULL);
 
-  return (buffer->buffer);
-}
+  CODEDOC_PROBE1(markdown__load__start, filename);
 
+  root = mmdLoadIO(root, (mmd_iocb_t)gunzip_read, g);
 
-/*
- * 'stringbuf_getlast()' - Get the last character in a string buffer.
- */
+  CODEDOC_PROBE2(markdown__load__done, filename, root);
 
-static int				/* O - Last character or EOF */
-stringbuf_getlast(stringbuf_t *buffer)	/* I - String buffer */
-{
-  if (buffer->bufptr > buffer->buffer)
-    return (buffer->bufptr[-1]);
-  else
-    return (EOF);
-}
+  if (gunzip_error(g))
+  {
+    int zerror;				/* zlib error */
 
+    fprintf(stderr, "codedoc: %s\n", gzerror(g->gz, &zerror));
+    exit(1);
+  }
 
-/*
- * 'stringbuf_length()' - Get the length of the string buffer.
- */
+  gunzip_close(g);
 
-static size_t				/* O - Length of string buffer */
-stringbuf_length(stringbuf_t *buffer)	/* I - String buffer */
-{
-  return (buffer->bufptr - buffer->buffer);
+  return (root);
 }
 
 
 /*
- * 'type_cb()' - Set the type of child nodes.
+ * 'markdown_write_block()' - Write a markdown block.
  */
 
-static mxml_type_t			/* O - Node type */
-type_cb(void        *cbdata,		/* I - Callback data (unused) */
-        mxml_node_t *node)		/* I - Node */
+static void
+markdown_write_block(FILE  *out,	/* I - Output file */
+                     mmd_t *parent,	/* I - Parent node */
+                     int   mode)	/* I - Output mode */
 {
-  (void)cbdata;
-
-  if (mxmlGetType(node) == MXML_TYPE_ELEMENT && !strcmp(mxmlGetElement(node), "description"))
-    return (MXML_TYPE_OPAQUE);
-  else
-    return (MXML_TYPE_TEXT);
+  if (renderers[mode].write_block)
+    (renderers[mode].write_block)(out, parent, mode);
 }
 
 
 /*
- * 'update_comment()' - Update a comment node.
+ * 'markdown_write_block_html()' - Write a markdown block as HTML/XHTML.
+ *
+ * The block is walked without recursion, writing the start tag of each nested
+ * block when it is entered and the end tag when it is left.
  */
 
 static void
-update_comment(mxml_node_t *parent,	/* I - Parent node */
-               mxml_node_t *comment)	/* I - Comment node */
+markdown_write_block_html(FILE  *out,	/* I - Output file */
+                          mmd_t *parent,/* I - Parent node */
+                          int   mode)	/* I - Output mode */
 {
-  char	*s,				/* Copy of comment */
-  	*ptr;				/* Pointer into comment */
+  mmd_t		*node,			/* Current node */
+		*child;			/* Current child node */
+  mmd_walk_t	walk;			/* Walk event for current node */
+  mmd_type_t	type;			/* Node type */
+  int		histate;		/* Highlighting state */
+  const char	*element,		/* Enclosing element, if any */
+		*class_name;		/* Class name, if any */
 
 
-  DEBUG_printf("    update_comment(parent=%p, comment=%p)\n", parent, comment);
+  for (node = parent, walk = MMD_WALK_ENTER; node; node = mmdWalkNext(node, parent, &walk))
+  {
+    if (!mmdIsBlock(node))
+    {
+      markdown_write_leaf_html(out, node, mode);
+      walk = MMD_WALK_EXIT;
+      continue;
+    }
 
- /*
-  * Range check the input...
-  */
+    type       = mmdGetType(node);
+    class_name = NULL;
 
-  if (!parent || !comment)
-    return;
+    switch (type)
+    {
+      case MMD_TYPE_BLOCK_QUOTE :
+	  element = "blockquote";
+	  break;
 
- /*
-  * Convert "\/" to "/"...
-  */
+      case MMD_TYPE_ORDERED_LIST :
+	  element = "ol";
+	  break;
 
-  s = strdup(mxmlGetOpaque(comment));
+      case MMD_TYPE_UNORDERED_LIST :
+	  element = "ul";
+	  break;
 
-  for (ptr = strstr(s, "\\/"); ptr; ptr = strstr(ptr, "\\/"))
-    safe_strcpy(ptr, ptr + 1);
+      case MMD_TYPE_LIST_ITEM :
+	  element = "li";
+	  break;
 
- /*
-  * Remove leading spaces...
-  */
+      case MMD_TYPE_HEADING_1 :
+	  element    = "h2"; /* Offset since title is H1 for codedoc output */
+	  class_name = "title";
+	  break;
 
-  for (ptr = s; *ptr && isspace(*ptr & 255); ptr ++)
-    ;					// Skip leading spaces
+      case MMD_TYPE_HEADING_2 :
+	  element    = "h3"; /* Offset since title is H1 for codedoc output */
+	  class_name = "title";
+	  break;
 
-  if (ptr > s)
-    safe_strcpy(s, ptr);
+      case MMD_TYPE_HEADING_3 :
+	  element = "h4"; /* Offset since title is H1 for codedoc output */
+	  break;
 
- /*
-  * Update the comment...
-  */
+      case MMD_TYPE_HEADING_4 :
+	  element = "h5"; /* Offset since title is H1 for codedoc output */
+	  break;
 
-  ptr = s;
+      case MMD_TYPE_HEADING_5 :
+	  element = "h6"; /* Offset since title is H1 for codedoc output */
+	  break;
 
-  if (*ptr == '\'')
-  {
-   /*
-    * Convert "'name()' - description" to "description".
-    */
+      case MMD_TYPE_HEADING_6 :
+	  element = "h6";
+	  break;
 
-    DEBUG_puts("        found quote");
-    for (ptr ++; *ptr && *ptr != '\'' && *ptr != '('; ptr ++)
-      ;					// Look for end quote
+      case MMD_TYPE_PARAGRAPH :
+	  element = "p";
+	  break;
 
-    if (*ptr == '(' && ptr[1] == ')' && ptr[2] == '\'')
-    {
-      DEBUG_printf("        comment after quote: %s\n", ptr + 3);
-      ptr += 3;
-      while (isspace(*ptr & 255))
-        ptr ++;
+      case MMD_TYPE_CODE_BLOCK :
+	  if ((class_name = mmdGetExtra(node)) != NULL)
+	    fprintf(out, "<pre><code class=\"language-%s\">", class_name);
+	  else
+	    fputs("<pre><code>", out);
 
-      if (*ptr == '-')
-        ptr ++;
+	  for (child = mmdGetFirstChild(node), histate = HIGHLIGHT_NONE; child; child = mmdGetNextSibling(child))
+	  {
+	    if (class_name && (!strcmp(class_name, "c") || !strcmp(class_name, "cpp")))
+	      highlight_c_string(out, mmdGetText(child), &histate);
+	    else if (class_name && !strcmp(class_name, "css"))
+	      highlight_css_string(out, mmdGetText(child), &histate);
+	    else if (class_name && (!strcmp(class_name, "html") || !strcmp(class_name, "xml")))
+	      highlight_htmlxml_string(out, mmdGetText(child), &histate);
+	    else
+	      write_string(out, mmdGetText(child), mode, 0);
+	  }
+	  fputs("</code></pre>\n", out);
 
-      while (isspace(*ptr & 255))
-        ptr ++;
+	  walk = MMD_WALK_EXIT;
+	  continue;
 
-      safe_strcpy(s, ptr);
-    }
-  }
-  else if (!strncmp(ptr, "I ", 2) || !strncmp(ptr, "O ", 2) || !strncmp(ptr, "IO ", 3))
-  {
-   /*
-    * 'Convert "I - description", "IO - description", or "O - description"
-    * to description + direction attribute.
-    */
+      case MMD_TYPE_THEMATIC_BREAK :
+	  fprintf(out, "<hr%s\n", renderers[mode].void_end);
 
-    ptr = strchr(ptr, ' ');
-    *ptr++ = '\0';
+	  walk = MMD_WALK_EXIT;
+	  continue;
 
-    if (!strcmp(mxmlGetElement(parent), "argument"))
-      mxmlElementSetAttr(parent, "direction", s);
+      case MMD_TYPE_TABLE :
+	  element = "table";
+	  break;
 
-    while (isspace(*ptr & 255))
-      ptr ++;
+      case MMD_TYPE_TABLE_HEADER :
+	  element = "thead";
+	  break;
 
-    if (*ptr == '-')
-      ptr ++;
+      case MMD_TYPE_TABLE_BODY :
+	  element = "tbody";
+	  break;
 
-    while (isspace(*ptr & 255))
-      ptr ++;
+      case MMD_TYPE_TABLE_ROW :
+	  element = "tr";
+	  break;
 
-    safe_strcpy(s, ptr);
-  }
+      case MMD_TYPE_TABLE_HEADER_CELL :
+	  element = "th";
+	  break;
 
- /*
-  * Eliminate leading and trailing *'s...
-  */
+      case MMD_TYPE_TABLE_BODY_CELL_LEFT :
+	  element = "td";
+	  break;
 
-  for (ptr = s; *ptr == '*'; ptr ++)
-    ;					// Skip leading *
+      case MMD_TYPE_TABLE_BODY_CELL_CENTER :
+	  element    = "td";
+	  class_name = "center";
+	  break;
 
-  for (; isspace(*ptr & 255); ptr ++)
-    ;					// Skip leading whitespace
+      case MMD_TYPE_TABLE_BODY_CELL_RIGHT :
+	  element    = "td";
+	  class_name = "right";
+	  break;
 
-  if (ptr > s)
-    safe_strcpy(s, ptr);
+      default :
+	  element = NULL;
+	  break;
+    }
 
-  for (ptr = s + strlen(s) - 1; ptr > s && *ptr == '*'; ptr --)
-    *ptr = '\0';
-  for (; ptr > s && isspace(*ptr & 255); ptr --)
-    *ptr = '\0';
+    if (walk == MMD_WALK_EXIT)
+    {
+     /*
+      * Leaving the block, close the element...
+      */
 
-  DEBUG_printf("        updated comment = %s\n", s);
+      if (element)
+	fprintf(out, "</%s>\n", element);
+    }
+    else if (type >= MMD_TYPE_HEADING_1 && type <= MMD_TYPE_HEADING_6)
+    {
+     /*
+      * Add an anchor...
+      */
 
-  mxmlSetOpaque(comment, s);
-  free(s);
+      if (class_name)
+	fprintf(out, "<%s class=\"%s\" id=\"", element, class_name);
+      else
+	fprintf(out, "<%s id=\"", element);
+      fputs(anchors_get(&Anchors, node), out);
+      fputs("\">", out);
+    }
+    else if (element)
+    {
+      if (class_name)
+	fprintf(out, "<%s class=\"%s\">", element, class_name);
+      else
+	fprintf(out, "<%s>%s", element, type <= MMD_TYPE_UNORDERED_LIST ? "\n" : "");
+    }
+  }
 }
 
 
 /*
- * 'usage()' - Show program usage...
+ * 'markdown_write_block_man()' - Write a markdown block as man source.
+ *
+ * Like @link markdown_write_block_html@, the block is walked without
+ * recursion.
  */
 
 static void
-usage(const char *option)		/* I - Unknown option */
+markdown_write_block_man(FILE  *out,	/* I - Output file */
+                         mmd_t *parent,	/* I - Parent node */
+                         int   mode)	/* I - Output mode */
 {
-  if (option)
-    printf("codedoc: Bad option \"%s\".\n\n", option);
+  mmd_t		*node,			/* Current node */
+		*child;			/* Current child node */
+  mmd_walk_t	walk;			/* Walk event for current node */
 
-  puts("Usage: codedoc [options] [filename.xml] [source files] >filename.html");
-  puts("       codedoc [options] [filename.xml] [source files] --epub filename.epub");
-  puts("       codedoc [options] [filename.xml] [source files] --man name >name.3");
-  puts("");
-  puts("Options:");
-  puts("    --author \"name\"            Set author name");
-  puts("    --body filename            Set body file (markdown supported)");
-  puts("    --copyright \"text\"         Set copyright text");
-  puts("    --coverimage filename.png  Set cover image (EPUB, HTML)");
-  puts("    --css filename.css         Set CSS stylesheet file (EPUB, HTML)");
-  puts("    --docversion \"version\"     Set documentation version");
-  puts("    --epub filename.epub       Generate EPUB file");
-  puts("    --footer filename          Set footer file (markdown supported)");
-  puts("    --header filename          Set header file (markdown supported)");
-  puts("    --language ll[-LOC]        Set ISO language and locality code (EPUB, HTML)");
-  puts("    --man name                 Generate man page");
-  puts("    --no-output                Do not generate documentation file");
-  puts("    --section \"section\"        Set section name");
-  puts("    --title \"title\"            Set documentation title");
-  puts("    --version                  Show codedoc version");
 
-  exit(1);
+  for (node = parent, walk = MMD_WALK_ENTER; node; node = mmdWalkNext(node, parent, &walk))
+  {
+    if (!mmdIsBlock(node))
+    {
+      markdown_write_leaf_man(out, node, mode);
+      walk = MMD_WALK_EXIT;
+      continue;
+    }
+    else if (walk == MMD_WALK_EXIT)
+    {
+      fputs("\n", out);
+      continue;
+    }
+
+    switch (mmdGetType(node))
+    {
+      case MMD_TYPE_BLOCK_QUOTE :
+	  break;
+
+      case MMD_TYPE_ORDERED_LIST :
+	  break;
+
+      case MMD_TYPE_UNORDERED_LIST :
+	  break;
+
+      case MMD_TYPE_LIST_ITEM :
+	  fputs(".IP \\(bu 5\n", out);
+	  break;
+
+      case MMD_TYPE_HEADING_1 :
+	  fputs(".SH ", out);
+	  break;
+
+      case MMD_TYPE_HEADING_2 :
+	  fputs(".SS ", out);
+	  break;
+
+      case MMD_TYPE_HEADING_3 :
+      case MMD_TYPE_HEADING_4 :
+      case MMD_TYPE_HEADING_5 :
+      case MMD_TYPE_HEADING_6 :
+      case MMD_TYPE_PARAGRAPH :
+	  fputs(".PP\n", out);
+	  break;
+
+      case MMD_TYPE_CODE_BLOCK :
+	  fputs(".nf\n\n", out);
+	  for (child = mmdGetFirstChild(node); child; child = mmdGetNextSibling(child))
+	  {
+	    fputs("    ", out);
+	    write_string(out, mmdGetText(child), mode, 0);
+	  }
+	  fputs(".fi\n", out);
+
+	  walk = MMD_WALK_EXIT;
+	  break;
+
+      case MMD_TYPE_METADATA :
+	  walk = MMD_WALK_EXIT;
+	  break;
+
+      default :
+	  break;
+    }
+  }
 }
 
 
 /*
- * 'write_description()' - Write the description text.
+ * 'markdown_write_leaf_html()' - Write a leaf markdown node as HTML/XHTML.
  */
 
 static void
-write_description(
-    FILE        *out,			/* I - Output file */
-    int         mode,                   /* I - Output mode */
-    mxml_node_t *description,		/* I - Description node */
-    const char  *element,		/* I - HTML element, if any */
-    int         summary)		/* I - Show summary (-1 for all) */
+markdown_write_leaf_html(FILE  *out,	/* I - Output file */
+                         mmd_t *node,	/* I - Node to write */
+                         int   mode)	/* I - Output mode */
 {
-  char	text[10240],			/* Text for description */
-        *start,				/* Start of code/link */
-	*ptr;				/* Pointer into text */
-  int	col,				/* Current column */
-	list = 0,			/* In a list? */
-	bq = 0;				/* In a block quote? */
+  mmd_type_t	type,			/* Current leaf node type */
+		prev_type,		/* Previous leaf node type */
+		next_type;		/* Next leaf node type */
+  const char	*text,			/* Text to write */
+		*url,			/* URL to write */
+		*element;		/* Encoding element, if any */
+  char		temp[1024],		/* Temporary string for text + width */
+		*widthspec,		/* Pointer to width specification, if any */
+		*heightspec;		/* Pointer to height specification, if any */
 
 
-  if (!description)
-    return;
+  type  = mmdGetType(node);
+  text  = mmdGetText(node);
+  url   = mmdGetURL(node);
 
-  get_text(description, text, sizeof(text));
+  if (mmdGetWhitespace(node))
+    fputc(' ', out);
 
-  if (summary < 0)
+  switch (type)
   {
-   /*
-    * When showing everything, point to the start of the description text...
-    */
+    case MMD_TYPE_EMPHASIZED_TEXT :
+        element = "em";
+        break;
 
-    ptr = text;
-  }
-  else
-  {
-    if ((ptr = strstr(text, "\n\n")) != NULL)
-      *ptr = '\0';
+    case MMD_TYPE_STRONG_TEXT :
+        element = "strong";
+        break;
 
-    if (summary)
-      ptr = text;			/* Summary is the first paragraph */
-    else if (!ptr || !ptr[2])
-      return;				/* No long-form description */
-    else
-      ptr += 2;				/* Long-firm description after first */
-  }
+    case MMD_TYPE_STRUCK_TEXT :
+        element = "del";
+        break;
 
-  if (element && *element)
-    fprintf(out, "<%s class=\"%s\">", element, summary ? "description" : "discussion");
-  else if (!summary)
-    fputs(".PP\n", out);
+    case MMD_TYPE_LINKED_TEXT :
+        element = NULL;
+        break;
 
-  for (col = 0; *ptr; ptr ++)
-  {
-    if (col == 0 && !strncmp(ptr, "- ", 2))
-    {
-     /*
-      * Bullet list item...
-      */
+    case MMD_TYPE_CODE_TEXT :
+        element = "code";
+        break;
 
-      ptr ++;
+    case MMD_TYPE_IMAGE :
+        fputs("<img src=\"", out);
+        if (strncmp(url, "http://", 7) && strncmp(url, "https://", 8))
+        {
+         /*
+          * Local file so strip any directory info...
+          */
 
-      if (element)
-      {
-	if (!list)
-	{
-          if (!strcmp(element, "p"))
-	    fputs("</p>", out);
+          const char	*baseurl;	/* Base name of URL */
 
-	  fputs("<ul>\n", out);
-	  list = 1;
+
+          if ((baseurl = strrchr(url, '/')) != NULL)
+            baseurl ++;
+          else
+            baseurl = url;
+
+	  write_string(out, baseurl, mode, 0);
 	}
 	else
-	  fputs("</li>\n", out);
+	{
+	 /*
+	  * Remote URL so use as-is...
+	  */
 
-	fputs("<li>", out);
-      }
-      else
-      {
-        list = 1;
-        fputs(".IP \\(bu 5\n", out);
-      }
-    }
-    else if (col == 0 && !strncmp(ptr, "> ", 2))
-    {
-     /*
-      * Block quote...
-      */
+	  write_string(out, url, mode, 0);
+	}
 
-      ptr ++;
+        strncpy(temp, text, sizeof(temp) - 1);
+        temp[sizeof(temp) - 1] = '\0';
 
-      if (element)
-      {
-	if (!bq)
+        if ((widthspec = strstr(temp, "::")) != NULL)
+        {
+          *widthspec = '\0';
+          widthspec += 2;
+
+          if ((heightspec = strchr(widthspec, 'x')) != NULL)
+	    *heightspec++ = '\0';
+	}
+	else
 	{
-          if (!strcmp(element, "p"))
-	    fputs("</p>", out);
+	  heightspec = NULL;
+        }
 
-	  fputs("<blockquote>\n", out);
-	  bq = 1;
+	if (widthspec && *widthspec)
+	  fprintf(out, "\" width=\"%s", widthspec);
+	if (heightspec && *heightspec)
+	  fprintf(out, "\" height=\"%s", heightspec);
+
+        if ((!widthspec || !*widthspec) && (!heightspec || !*heightspec) && strncmp(url, "http://", 7) && strncmp(url, "https://", 8))
+        {
+         /*
+          * No size specified, use the intrinsic size of a local image so the
+          * browser or reader can lay out the page before the image loads...
+          */
+
+          char	filename[1024],		/* Image filename */
+		*sizespec;		/* Pointer to size specification, if any */
+          int	width,			/* Intrinsic width */
+		height;			/* Intrinsic height */
+
+          strlcpy(filename, url, sizeof(filename));
+          if ((sizespec = strstr(filename, " =")) != NULL)
+            *sizespec = '\0';
+
+          if (image_size(filename, &width, &height))
+            fprintf(out, "\" width=\"%d\" height=\"%d", width, height);
+        }
+
+        fputs("\" alt=\"", out);
+        write_string(out, text, mode, 0);
+        fprintf(out, "\"%s", renderers[mode].void_end);
+        return;
+
+    case MMD_TYPE_HARD_BREAK :
+	if (mmdGetType(mmdGetParent(node)) < MMD_TYPE_HEADING_1 || mmdGetType(mmdGetParent(node)) > MMD_TYPE_HEADING_6)
+	{
+	  fprintf(out, "<br%s\n", renderers[mode].void_end);
 	}
+        return;
+
+    case MMD_TYPE_SOFT_BREAK :
+        fprintf(out, "<wbr%s", renderers[mode].void_end);
+        return;
+
+    case MMD_TYPE_METADATA_TEXT :
+        return;
+
+    default :
+        element = NULL;
+        break;
+  }
+
+  prev_type = mmdGetType(mmdGetPrevSibling(node));
+  next_type = mmdGetType(mmdGetNextSibling(node));
+
+  if (url)
+  {
+    const char *prev_url = mmdGetURL(mmdGetPrevSibling(node));
+    const char *title = mmdGetExtra(node);
+    char anchor[1024];			/* Anchor for "@" links */
+
+    if (!prev_url || strcmp(prev_url, url))
+    {
+      if (!strcmp(url, "@"))
+      {
+        const char *target = anchors_find(&Anchors, text);
+					/* Heading anchor */
+
+	fprintf(out, "<a href=\"#%s\"", target ? target : markdown_anchor(text, anchor, sizeof(anchor)));
       }
+      else if (!strcmp(url, "@@"))
+	fprintf(out, "<a href=\"#%s\"", text);
       else
+	fprintf(out, "<a href=\"%s\"", url);
+
+      if (title)
       {
-        bq = 1;
-        fputs(".IP 5\n", out);
+	fputs(" title=\"", out);
+	write_string(out, title, mode, 0);
+	fputs("\">", out);
       }
+      else
+	putc('>', out);
     }
-    else if (col == 0 && !strncmp(ptr, "```\n", 4))
-    {
-     /*
-      * Code fence...
-      */
+  }
 
-      ptr += 4;
+  if (element && prev_type != type)
+    fprintf(out, "<%s>", element);
 
-      if (element)
-        fputs("<pre>\n", out);
-      else
-        fputs(".nf\n", out);
+  write_string(out, text, mode, 0);
 
-      while (*ptr && (col != 0 || (strncmp(ptr, "```\n", 4) && strcmp(ptr, "```"))))
-      {
-        if (col == 0 && !element)
-          fputs("    ", out);
+  if (element && next_type != type)
+    fprintf(out, "</%s>", element);
 
-        if (col == 0 && *ptr == '|' && ptr[1])
-          ptr ++;
+  if (url)
+  {
+    const char *next_url = mmdGetURL(mmdGetNextSibling(node));
 
-	if (*ptr == '\n')
-	  col = 0;
-	else
-	  col ++;
+    if (!next_url || strcmp(next_url, url))
+      fputs("</a>", out);
+  }
+}
 
-        if (*ptr == '\\' && ptr[1])
-          ptr ++;
 
-        if (element)
-        {
-	  if (*ptr == '&')
-	    fputs("&amp;", out);
-	  else if (*ptr == '<')
-	    fputs("&lt;", out);
-	  else if (*ptr == '>')
-	    fputs("&gt;", out);
-	  else if (*ptr == '\"')
-	    fputs("&quot;", out);
-	  else if (*ptr & 128)
-	  {
-	   /*
-	    * Convert utf-8 to Unicode constant...
-	    */
+/*
+ * 'markdown_write_leaf_man()' - Write a leaf markdown node as man source.
+ */
 
-	    int	ch;			/* Unicode character */
+static void
+markdown_write_leaf_man(FILE  *out,	/* I - Output file */
+                        mmd_t *node,	/* I - Node to write */
+                        int   mode)	/* I - Output mode */
+{
+  const char	*suffix = NULL;		/* Trailing string */
 
 
-	    ch = *ptr & 255;
+  switch (mmdGetType(node))
+  {
+    case MMD_TYPE_EMPHASIZED_TEXT :
+        if (mmdGetWhitespace(node))
+          fputc('\n', out);
 
-	    if ((ch & 0xe0) == 0xc0)
-	    {
-	      ch = ((ch & 0x1f) << 6) | (ptr[1] & 0x3f);
-	      ptr ++;
-	    }
-	    else if ((ch & 0xf0) == 0xe0)
-	    {
-	      ch = ((((ch * 0x0f) << 6) | (ptr[1] & 0x3f)) << 6) | (ptr[2] & 0x3f);
-	      ptr += 2;
-	    }
+        fputs(".I ", out);
+        suffix = "\n";
+        break;
 
-	    fprintf(out, "&#%d;", ch);
-	  }
-	  else
-	    putc(*ptr, out);
-	}
-	else
-	{
-	  if (*ptr == '\\' || ((*ptr == '.' || *ptr == '\'') && col == 0))
-	    putc('\\', out);
+    case MMD_TYPE_STRONG_TEXT :
+        if (mmdGetWhitespace(node))
+          fputc('\n', out);
 
-	  putc(*ptr, out);
-	}
+        fputs(".B ", out);
+        suffix = "\n";
+        break;
 
-	ptr ++;
-      }
+    case MMD_TYPE_HARD_BREAK :
+        if (mmdGetWhitespace(node))
+          fputc('\n', out);
 
-      if (!strncmp(ptr, "```\n", 4))
-        ptr += 3;
-      else if (!strcmp(ptr, "```"))
-        ptr += 2;
+        fputs(".PP\n", out);
+        return;
 
-      col = 0;
+    case MMD_TYPE_SOFT_BREAK :
+    case MMD_TYPE_METADATA_TEXT :
+        return;
 
-      if (element)
-        fputs("</pre>\n", out);
-      else
-        fputs("\n.fi\n", out);
+    default :
+        if (mmdGetWhitespace(node))
+          fputc(' ', out);
+        break;
+  }
+
+  write_string(out, mmdGetText(node), mode, 0);
+
+  if (suffix)
+    fputs(suffix, out);
+}
+
+
+/*
+ * 'minify_css()' - Remove comments and optional whitespace from a stylesheet.
+ *
+ * The stylesheet is minified in place.
+ */
+
+static size_t				/* O - New length of stylesheet */
+minify_css(char *s)			/* I - Stylesheet */
+{
+  char	*src,				/* Pointer into source */
+	*dst,				/* Pointer into destination */
+	quote;				/* Quote character */
+  bool	ws = false,			/* Pending whitespace? */
+	semi = false;			/* Pending semicolon? */
+
+
+  for (src = dst = s; *src;)
+  {
+    if (!strncmp(src, "/*", 2))
+    {
+     /*
+      * Skip comment...
+      */
+
+      if ((src = strstr(src + 2, "*/")) == NULL)
+        break;
+
+      src += 2;
+      ws  = true;
+      continue;
     }
-    else if (*ptr == '@' && (!strncmp(ptr + 1, "deprecated@", 11) || !strncmp(ptr + 1, "exclude ", 8) || !strncmp(ptr + 1, "since ", 6)))
+    else if (isspace(*src & 255))
     {
-      ptr ++;
-      while (*ptr && *ptr != '@')
-        ptr ++;
+      src ++;
+      ws = true;
+      continue;
+    }
 
-      if (!*ptr)
-        ptr --;
+   /*
+    * Only keep a semicolon if it isn't the last declaration in a block, and
+    * only keep whitespace that separates two tokens...
+    */
+
+    if (semi && *src != '}')
+      *dst++ = ';';
+
+    if (ws && dst > s && !strchr("{};,>:", dst[-1]) && !strchr("{};,>", *src))
+      *dst++ = ' ';
+
+    semi = false;
+    ws   = false;
+
+    if (*src == ';')
+    {
+      src ++;
+      semi = true;
     }
-    else if (!strncmp(ptr, "@code ", 6) || *ptr == '`')
+    else if (*src == '\"' || *src == '\'')
     {
-      char end = *ptr++;		/* Terminating character */
+     /*
+      * Copy quoted string...
+      */
 
-      if (end != '`')
+      quote  = *src;
+      *dst++ = *src++;
+
+      while (*src && *src != quote)
       {
-        for (ptr += 5; isspace(*ptr & 255); ptr ++)
-          ;				// Skip whitespace after @code
+        if (*src == '\\' && src[1])
+          *dst++ = *src++;
+
+        *dst++ = *src++;
       }
 
-      for (start = ptr, ptr ++; *ptr && *ptr != end; ptr ++)
-        col ++;
+      if (*src)
+        *dst++ = *src++;
+    }
+    else
+      *dst++ = *src++;
+  }
 
-      if (*ptr)
-        *ptr = '\0';
-      else
-        ptr --;
+  if (semi)
+    *dst++ = ';';
 
-      if (element && *element)
-      {
-        fputs("<code>", out);
-        for (; *start; start ++)
-        {
-          if (*start == '<')
-            fputs("&lt;", out);
-          else if (*start == '>')
-            fputs("&gt;", out);
-          else if (*start == '&')
-            fputs("&amp;", out);
-          else
-            putc(*start, out);
-        }
-        fputs("</code>", out);
-      }
-      else if (element)
-        fputs(start, out);
-      else
-        fprintf(out, "\\fB%s\\fR", start);
+  *dst = '\0';
+
+  return ((size_t)(dst - s));
+}
+
+
+/*
+ * 'minify_html()' - Copy HTML/XHTML while removing optional whitespace.
+ *
+ * Whitespace next to block elements is removed and other whitespace is
+ * collapsed to a single space.  The contents of "pre" and "script" elements
+ * are copied as-is and "style" elements are passed through @link minify_css@.
+ */
+
+static void
+minify_html(FILE *in,			/* I - Input file */
+            FILE *out)			/* I - Output file */
+{
+  int		ch;			/* Current character */
+  char		tag[32],		/* Element name */
+		name[32],		/* Element name (lowercase) */
+		*tagptr,		/* Pointer into element name */
+		*raw = NULL;		/* Raw element content */
+  size_t	i,			/* Looping var */
+		rawlen,			/* Length of raw content */
+		rawsize = 0,		/* Size of raw content buffer */
+		taglen;			/* Length of element name */
+  bool		ws = false,		/* Pending whitespace? */
+		block = true,		/* Last thing was a block element? */
+		is_block,		/* Current element is a block element? */
+		closing;		/* End tag? */
+  static const char * const blocks[] =	/* Block elements */
+  {
+    "!doctype", "?xml", "blockquote", "body", "br", "dd", "details", "div",
+    "dl", "dt", "h1", "h2", "h3", "h4", "h5", "h6", "head", "hr", "html", "li",
+    "link", "meta", "nav", "ol", "p", "pre", "script", "style", "summary",
+    "table", "tbody", "td", "template", "th", "thead", "title", "tr", "ul"
+  };
+
+
+  rewind(in);
+
+  while ((ch = getc(in)) != EOF)
+  {
+    if (isspace(ch))
+    {
+      ws = true;
+      continue;
     }
-    else if (!strncmp(ptr, "@link ", 6))
+    else if (ch != '<')
     {
-      for (ptr += 6; isspace(*ptr & 255); ptr ++)
-        ;				// Skip whitespace
+      if (ws && !block)
+        putc(' ', out);
 
-      for (start = ptr, ptr ++; *ptr && *ptr != '@'; ptr ++)
-        col ++;
+      putc(ch, out);
 
-      if (*ptr)
-        *ptr = '\0';
-      else
-        ptr --;
+      ws    = false;
+      block = false;
+      continue;
+    }
 
-      if (element && *element)
-        fprintf(out, "<a href=\"#%s\"><code>%s</code></a>", start, start);
-      else if (element)
-        fputs(start, out);
-      else
-        fprintf(out, "\\fI%s\\fR", start);
+   /*
+    * Read the element name...
+    */
+
+    if ((ch = getc(in)) == '/')
+    {
+      closing = true;
+      ch      = getc(in);
     }
-    else if (*ptr == '*' && strchr(ptr + 1, '*'))
+    else
+      closing = false;
+
+    for (tagptr = tag; ch != EOF && (isalnum(ch) || strchr("!?-:[", ch)) && tagptr < (tag + sizeof(tag) - 1); ch = getc(in))
+      *tagptr++ = (char)ch;
+
+    *tagptr = '\0';
+    taglen  = (size_t)(tagptr - tag);
+
+    for (i = 0; i <= taglen; i ++)
+      name[i] = (char)tolower(tag[i] & 255);
+
+    for (i = 0, is_block = !strncmp(name, "!--", 3); !is_block && i < (sizeof(blocks) / sizeof(blocks[0])); i ++)
+      is_block = !strcmp(name, blocks[i]);
+
+    if (ws && !block && !is_block)
+      putc(' ', out);
+
+    ws    = false;
+    block = is_block;
+
+    fputs(closing ? "</" : "<", out);
+    fputs(tag, out);
+
+    if (!strncmp(name, "!--", 3))
     {
      /*
-      * Emphasized text...
+      * Copy comment as-is...
       */
 
-      int strong = (ptr[1] == '*' && strstr(ptr + 2, "**") != NULL);
-
-      while (*ptr == '*')
-        ptr ++;
+      int dashes = 0;			/* Number of consecutive dashes */
 
-      for (start = ptr; *ptr && *ptr != '*'; ptr ++)
-        col ++;
+      for (i = 3; i < taglen && tag[i] == '-'; i ++)
+        dashes ++;
 
-      if (*ptr)
+      for (; ch != EOF; ch = getc(in))
       {
-        *ptr = '\0';
-
-        while (ptr[1] == '*')
-          ptr ++;
-      }
-      else
-        ptr --;
+        putc(ch, out);
 
-      if (element && *element)
-      {
-        if (strong)
-          fprintf(out, "<strong>%s</strong>", start);
+        if (ch == '>' && dashes >= 2)
+          break;
+        else if (ch == '-')
+          dashes ++;
         else
-          fprintf(out, "<em>%s</em>", start);
+          dashes = 0;
       }
-      else if (element)
-        fputs(start, out);
-      else if (strong)
-        fprintf(out, "\\fB%s\\fR", start);
-      else
-        fprintf(out, "\\fI%s\\fR", start);
+      continue;
     }
-    else if (*ptr == '[' && strstr(ptr + 1, "](") != NULL)
+    else
     {
      /*
-      * Link...
+      * Copy the rest of the tag, collapsing whitespace outside of quotes...
       */
 
-      char	*url = strstr(ptr + 1, "]("),
-					/* Pointer to URL */
-		*urlend = strchr(url + 1, ')');
-					/* Pointer to end of URL */
-      char	anchor[256];		/* Anchor for @ and @@ links */
+      int	quote = 0;		/* Current quote character */
+      bool	tagws = false;		/* Pending whitespace in tag? */
 
-      if (!urlend)
+      for (; ch != EOF; ch = getc(in))
       {
-        putc('[', out);
-        continue;
-      }
+        if (quote)
+        {
+          putc(ch, out);
 
-      start   = ptr + 1;
-      *url    = '\0';
-      url     += 2;
-      *urlend = '\0';
+          if (ch == quote)
+            quote = 0;
+        }
+        else if (isspace(ch))
+        {
+          tagws = true;
+        }
+        else
+        {
+          if (tagws && ch != '>')
+            putc(' ', out);
 
-      if (!strcmp(url, "@"))
-      {
-        // Support @ links to named headings...
-        snprintf(anchor, sizeof(anchor), "#%s", markdown_anchor(start));
-        url = anchor;
+          tagws = false;
+
+          putc(ch, out);
+
+          if (ch == '\"' || ch == '\'')
+            quote = ch;
+          else if (ch == '>')
+            break;
+        }
       }
-      else if (!strcmp(url, "@@"))
+    }
+
+    if (closing || (strcmp(name, "pre") && strcmp(name, "script") && strcmp(name, "style")))
+      continue;
+
+   /*
+    * Read the element content up to the end tag...
+    */
+
+    rawlen = 0;
+
+    while ((ch = getc(in)) != EOF)
+    {
+      if ((rawlen + 1) >= rawsize)
       {
-        // Support @@ links to named functions/types/etc...
-        snprintf(anchor, sizeof(anchor), "#%s", start);
-        url = anchor;
+        char *temp;			/* New buffer */
+
+        rawsize += 65536;
+
+        if ((temp = realloc(raw, rawsize)) == NULL)
+        {
+          fputs("codedoc: Unable to allocate memory for minified output.\n", stderr);
+          exit(1);
+        }
+
+        raw = temp;
       }
 
-      if (element)
-      {
-        fprintf(out, "<a href=\"%s\">", url);
-        write_string(out, start, mode, 0);
-        fputs("</a>", out);
-      }
-      else
+      raw[rawlen ++] = (char)ch;
+
+      if (rawlen >= (taglen + 2) && raw[rawlen - taglen - 2] == '<' && raw[rawlen - taglen - 1] == '/' && !strncasecmp(raw + rawlen - taglen, tag, taglen))
       {
-        fprintf(out, "\n.URL %s %s\n", url, start);
+        rawlen -= taglen + 2;
+        break;
       }
-
-      ptr = urlend;
     }
-    else if (*ptr == '<' && strchr(ptr + 1, '>') != NULL)
+
+    if (!raw)
+      break;
+
+    raw[rawlen] = '\0';
+
+    if (!strcmp(name, "style"))
+      rawlen = minify_css(raw);
+
+    fwrite(raw, 1, rawlen, out);
+
+    if (ch != EOF)
     {
      /*
-      * Autolink...
+      * Copy the end tag...
       */
 
-      char	*urlend = strchr(ptr + 1, '>');
-					/* Pointer to end of URL */
-
-      start   = ptr + 1;
-      *urlend = '\0';
+      fprintf(out, "</%s", tag);
 
-      if (element)
-      {
-        fprintf(out, "<a href=\"%s\">", start);
-        write_string(out, start, mode, 0);
-        fputs("</a>", out);
-      }
-      else
+      while ((ch = getc(in)) != EOF && ch != '>')
       {
-        fprintf(out, "\n.URL %s %s\n", start, start);
+        if (!isspace(ch))
+          putc(ch, out);
       }
 
-      ptr = urlend;
+      putc('>', out);
     }
-    else if (element)
-    {
-      if (*ptr == '\n')
-      {
-        col = 0;
-        if (bq && strncmp(ptr + 1, "> ", 2))
-        {
-          bq = 0;
-          fputs("</blockquote>",out);
-        }
-      }
-      else
-        col ++;
+  }
 
-      if (*ptr == '\\' && ptr[1])
-        ptr ++;
+  free(raw);
+}
 
-      if (*ptr == '&')
-        fputs("&amp;", out);
-      else if (*ptr == '<')
-        fputs("&lt;", out);
-      else if (*ptr == '>')
-        fputs("&gt;", out);
-      else if (*ptr == '\"')
-        fputs("&quot;", out);
-      else if (*ptr & 128)
-      {
-       /*
-        * Convert utf-8 to Unicode constant...
-        */
 
-        int	ch;			/* Unicode character */
+/*
+ * 'new_documentation()' - Create a new documentation tree.
+ */
 
-        ch = *ptr & 255;
+static mxml_node_t *			/* O - New documentation */
+new_documentation(mxml_node_t **codedoc)/* O - codedoc node */
+{
+  mxml_node_t	*doc;			/* New documentation */
 
-        if ((ch & 0xe0) == 0xc0)
-        {
-          ch = ((ch & 0x1f) << 6) | (ptr[1] & 0x3f);
-	  ptr ++;
-        }
-        else if ((ch & 0xf0) == 0xe0)
-        {
-          ch = ((((ch * 0x0f) << 6) | (ptr[1] & 0x3f)) << 6) | (ptr[2] & 0x3f);
-	  ptr += 2;
-        }
 
-        fprintf(out, "&#%d;", ch);
-      }
-      else if (*ptr == '\n' && ptr[1] == '\n' && ptr[2] && ptr[2] != '@' && strncmp(ptr + 2, "- ", 2) && strncmp(ptr + 2, "```\n", 4))
-      {
-        if (list)
-        {
-          list = 0;
-          fputs("</li>\n</ul>\n", out);
-          if (!strcmp(element, "p"))
-	    fprintf(out, "<%s class=\"%s\">", element, summary ? "description" : "discussion");
-        }
-        else if (mode == OUTPUT_EPUB)
-          fputs("<br />\n<br />\n", out);
-        else
-          fputs("<br>\n<br>\n", out);
-        ptr ++;
-      }
-      else
-        putc(*ptr, out);
-    }
-    else if (*ptr == '\n' && ptr[1] == '\n' && ptr[2] && ptr[2] != '@')
-    {
-      list = 0;
-      fputs("\n.PP\n", out);
-      ptr ++;
-      col = 0;
-    }
-    else
-    {
-      if (*ptr == '\\' && ptr[1])
-        ptr ++;
+ /*
+  * Create an empty XML documentation file...
+  */
 
-      if (*ptr == '\\' || ((*ptr == '.' || *ptr == '\'') && col == 0))
-        putc('\\', out);
+  doc = mxmlNewXML(NULL);
 
-      putc(*ptr, out);
+  *codedoc = mxmlNewElement(doc, "codedoc");
 
-      if (*ptr == '\n')
-      {
-        col = 0;
-        if (bq && strncmp(ptr + 1, "> ", 2))
-        {
-          bq = 0;
-          fputs(".PP\n", out);
-        }
-      }
-      else
-        col ++;
-    }
-  }
+  mxmlElementSetAttr(*codedoc, "xmlns", "https://www.msweet.org");
+  mxmlElementSetAttr(*codedoc, "xmlns:xsi", "http://www.w3.org/2001/XMLSchema-instance");
+  mxmlElementSetAttr(*codedoc, "xsi:schemaLocation", "https://www.msweet.org/codedoc/codedoc.xsd");
 
-  if (list)
-    fputs("</li>\n</ul>\n", out);
-  else if (bq && element)
-    fputs("</blockquote>\n", out);
-  else if (element && *element)
+  return (doc);
+}
+
+
+/*
+ * 'prefetch_get()' - Get the contents of a prefetched file.
+ *
+ * Files must be requested in command-line order - `false` is returned if the
+ * named file is not the next one in the queue, in which case the caller reads
+ * the file itself.
+ */
+
+static bool				/* O - `true` if the file was prefetched, `false` otherwise */
+prefetch_get(prefetch_t *pf,		/* I - Prefetch queue or `NULL` */
+             const char *filename,	/* I - Filename */
+             char       **buffer,	/* O - File contents */
+             size_t     *length,	/* O - Length of contents */
+             int        *error)		/* O - `errno` value from read or 0 */
+{
+#ifdef HAVE_PTHREAD_H
+  prefetch_file_t	*pfile;		/* Prefetched file */
+
+
+  if (!pf)
+    return (false);
+
+  pthread_mutex_lock(&pf->mutex);
+
+  if (pf->next_get >= pf->num_files || pf->files[pf->next_get].filename != filename)
   {
-    if (summary < 0)
-      fprintf(out, "</%s>", element);
-    else
-      fprintf(out, "</%s>\n", element);
+    pthread_mutex_unlock(&pf->mutex);
+    return (false);
   }
-  else if (!element)
-    putc('\n', out);
+
+  pfile = pf->files + pf->next_get;
+
+  while (!pfile->done)
+    pthread_cond_wait(&pf->cond, &pf->mutex);
+
+  *buffer = pfile->buffer;
+  *length = pfile->length;
+  *error  = pfile->error;
+
+  pfile->buffer = NULL;
+  pf->bytes     -= pfile->length;
+  pf->next_get ++;
+
+  pthread_cond_broadcast(&pf->cond);
+  pthread_mutex_unlock(&pf->mutex);
+
+  return (true);
+
+#else
+  (void)pf;
+  (void)filename;
+  (void)buffer;
+  (void)length;
+  (void)error;
+
+  return (false);
+#endif /* HAVE_PTHREAD_H */
 }
 
 
 /*
- * 'write_element()' - Write an element's text nodes.
+ * 'prefetch_start()' - Start reading source files in the background.
+ *
+ * The first argument is the file about to be scanned.  Options, option values,
+ * and XML files are skipped.  A background thread reads up to
+ * `PREFETCH_MAX_FILES` files or `PREFETCH_MAX_BYTES` bytes ahead of the
+ * scanner, hinting each window of upcoming files to the kernel at once so
+ * their reads can be queued together.
  */
 
-static void
-write_element(FILE        *out,		/* I - Output file */
-              mxml_node_t *doc,		/* I - Document tree */
-              mxml_node_t *element,	/* I - Element to write */
-              int         mode)		/* I - Output mode */
+static prefetch_t *			/* O - Prefetch queue or `NULL` if not used */
+prefetch_start(int  num_args,		/* I - Number of arguments */
+               char *args[])		/* I - Arguments */
 {
-  mxml_node_t	*node;			/* Current node */
-  bool		whitespace;		/* Current whitespace value */
-  const char	*string;		/* Current string value */
+#ifdef HAVE_PTHREAD_H
+  int		i;			/* Looping var */
+  size_t	j;			/* Looping var */
+  prefetch_t	*pf;			/* Prefetch queue */
 
 
-  if (!element)
-    return;
+  if ((pf = calloc(1, sizeof(prefetch_t))) == NULL)
+    return (NULL);
 
-  for (node = mxmlGetFirstChild(element); node; node = mxmlWalkNext(node, element, MXML_DESCEND_NONE))
+  if ((pf->files = calloc((size_t)num_args, sizeof(prefetch_file_t))) == NULL)
   {
-    if (mxmlGetType(node) == MXML_TYPE_TEXT)
-    {
-      string = mxmlGetText(node, &whitespace);
+    free(pf);
+    return (NULL);
+  }
 
-      if (whitespace)
-	putc(' ', out);
+  for (i = 0; i < num_args; i ++)
+  {
+    if (args[i][0] == '-')
+    {
+     /*
+      * Skip options and their values...
+      */
 
-      if ((mode == OUTPUT_HTML || mode == OUTPUT_EPUB) && (mxmlFindElement(doc, doc, "class", "name", string, MXML_DESCEND_ALL) || mxmlFindElement(doc, doc, "enumeration", "name", string, MXML_DESCEND_ALL) || mxmlFindElement(doc, doc, "struct", "name", string, MXML_DESCEND_ALL) || mxmlFindElement(doc, doc, "typedef", "name", string, MXML_DESCEND_ALL) || mxmlFindElement(doc, doc, "union", "name", string, MXML_DESCEND_ALL)))
-      {
-        fputs("<a href=\"#", out);
-        write_string(out, string, mode, 0);
-	fputs("\">", out);
-        write_string(out, string, mode, 0);
-	fputs("</a>", out);
-      }
-      else if ((mode == OUTPUT_HTML || mode == OUTPUT_EPUB) && is_reserved(string))
-      {
-        fputs("<span class=\"reserved\">", out);
-        write_string(out, string, mode, 0);
-        fputs("</span>", out);
-      }
-      else
+      for (j = 0; j < (sizeof(option_args) / sizeof(option_args[0])); j ++)
       {
-        write_string(out, string, mode, 0);
+        if (!strcmp(args[i], option_args[j]))
+        {
+          i ++;
+          break;
+        }
       }
+
+      continue;
     }
+
+    if (is_xml(args[i]))
+      continue;
+
+    pf->files[pf->num_files ++].filename = args[i];
   }
 
-  if (!strcmp(mxmlGetElement(element), "type") && (string = mxmlGetText(mxmlGetLastChild(element), NULL)) != NULL && *string != '*')
-    putc(' ', out);
+  if (pf->num_files < 2)
+  {
+   /*
+    * Nothing to overlap with the scanner...
+    */
+
+    free(pf->files);
+    free(pf);
+    return (NULL);
+  }
+
+  if (!jobsAcquire())
+  {
+   /*
+    * No spare jobs for a reader thread...
+    */
+
+    free(pf->files);
+    free(pf);
+    return (NULL);
+  }
+
+  pthread_mutex_init(&pf->mutex, NULL);
+  pthread_cond_init(&pf->cond, NULL);
+
+  if (pthread_create(&pf->thread, NULL, (void *(*)(void *))prefetch_thread, pf))
+  {
+    jobsRelease();
+    pthread_cond_destroy(&pf->cond);
+    pthread_mutex_destroy(&pf->mutex);
+    free(pf->files);
+    free(pf);
+    return (NULL);
+  }
+
+  return (pf);
+
+#else
+  (void)num_args;
+  (void)args;
+
+  return (NULL);
+#endif /* HAVE_PTHREAD_H */
 }
 
 
 /*
- * 'write_epub()' - Write documentation as an EPUB file.
+ * 'prefetch_stop()' - Stop reading source files and free any unused contents.
  */
 
 static void
-write_epub(const char  *epubfile,	/* I - EPUB file (output) */
-           const char  *section,	/* I - Section */
-           const char  *title,		/* I - Title */
-           const char  *author,		/* I - Author */
-           const char  *language,	/* I - Language */
-           const char  *copyright,	/* I - Copyright */
-           const char  *docversion,	/* I - Document version */
-           const char  *cssfile,	/* I - Stylesheet file */
-           const char  *coverimage,	/* I - Cover image file */
-           const char  *headerfile,	/* I - Header file */
-           const char  *bodyfile,	/* I - Body file */
-           mmd_t       *body,		/* I - Markdown body */
-           mxml_node_t *doc,		/* I - XML documentation */
-           const char  *footerfile)	/* I - Footer file */
+prefetch_stop(prefetch_t *pf)		/* I - Prefetch queue or `NULL` */
 {
-  int		status = 0;		/* Write status */
+#ifdef HAVE_PTHREAD_H
   size_t	i;			/* Looping var */
-  FILE		*fp;			/* Output file */
-  char		epubbase[256],		/* Base name of EPUB file (identifier) */
-		*epubptr;		/* Pointer into base name */
-  zipc_t	*epub;			/* EPUB ZIP container */
-  zipc_file_t	*epubf;			/* File in EPUB ZIP container */
-  char		xhtmlfile[1024],	/* XHTML output filename */
-		*xhtmlptr;		/* Pointer into output filename */
-  mxml_node_t	*package_opf,		/* package_opf file */
-                *package,		/* package node */
-                *metadata,		/* metadata node */
-                *manifest,		/* manifest node */
-                *spine,			/* spine node */
-                *temp;			/* Other (leaf) node */
-  char		identifier[256],	/* dc:identifier string */
-		*package_opf_string;	/* package_opf file as a string */
-  mxml_options_t *options;		/* Save options */
-  toc_t		*toc;			/* Table of contents */
-  toc_entry_t	*tentry;		/* Current table of contents */
-  int		toc_level;		/* Current table-of-contents level */
-  mmd_t		*node;			/* Current markdown node */
-  static const char *mimetype =		/* mimetype file as a string */
-		"application/epub+zip";
-  static const char *container_xml =	/* container.xml file as a string */
-		"<?xml version=\"1.0\" encoding=\"utf-8\"?>\n"
-                "<container xmlns=\"urn:oasis:names:tc:opendocument:xmlns:container\" version=\"1.0\">\n"
-                "  <rootfiles>\n"
-                "    <rootfile full-path=\"OEBPS/package.opf\" media-type=\"application/oebps-package+xml\"/>\n"
-                "  </rootfiles>\n"
-                "</container>\n";
 
 
- /*
-  * Verify we have everything we need...
-  */
+  if (!pf)
+    return;
 
-  if (coverimage && access(coverimage, R_OK))
-  {
-    fprintf(stderr, "codedoc: Unable to open cover image \"%s\": %s\n", coverimage, strerror(errno));
-    exit(1);
-  }
+  pthread_mutex_lock(&pf->mutex);
+  pf->cancel = true;
+  pthread_cond_broadcast(&pf->cond);
+  pthread_mutex_unlock(&pf->mutex);
 
- /*
-  * Write the XHTML content...
-  */
+  pthread_join(pf->thread, NULL);
+  jobsRelease();
 
-  strlcpy(xhtmlfile, epubfile, sizeof(xhtmlfile));
-  if ((xhtmlptr = strstr(xhtmlfile, ".epub")) != NULL)
-    strlcpy(xhtmlptr, ".xhtml", sizeof(xhtmlfile) - (size_t)(xhtmlptr - xhtmlfile));
-  else
-    strlcat(xhtmlfile, ".xhtml", sizeof(xhtmlfile));
+  for (i = 0; i < pf->num_files; i ++)
+    free(pf->files[i].buffer);
 
-  if ((fp = fopen(xhtmlfile, "w")) == NULL)
-  {
-    fprintf(stderr, "codedoc: Unable to create temporary XHTML file \"%s\": %s\n", xhtmlfile, strerror(errno));
-    exit (1);
-  }
+  pthread_cond_destroy(&pf->cond);
+  pthread_mutex_destroy(&pf->mutex);
 
- /*
-  * Standard header...
-  */
+  free(pf->files);
+  free(pf);
 
-  write_html_head(fp, OUTPUT_EPUB, section, title, author, language, copyright, docversion, cssfile);
+#else
+  (void)pf;
+#endif /* HAVE_PTHREAD_H */
+}
 
- /*
-  * Header...
-  */
 
-  if (headerfile)
-  {
-   /*
-    * Use custom header...
-    */
+#ifdef HAVE_PTHREAD_H
+/*
+ * 'prefetch_thread()' - Read source files ahead of the scanner.
+ */
 
-    write_file(fp, headerfile, OUTPUT_EPUB);
-  }
-  else
+static void *				/* O - Thread exit status (unused) */
+prefetch_thread(prefetch_t *pf)		/* I - Prefetch queue */
+{
+  size_t	i;			/* Looping var */
+  char		*buffer;		/* File contents */
+  size_t	length;			/* Length of contents */
+  int		error;			/* `errno` value */
+#  ifdef POSIX_FADV_WILLNEED
+  size_t	hinted = 0,		/* Number of files hinted so far */
+		window;			/* End of current window */
+#  endif /* POSIX_FADV_WILLNEED */
+
+
+  for (i = 0; i < pf->num_files; i ++)
   {
    /*
-    * Use standard header...
+    * Wait until the scanner catches up - never block on the file the scanner
+    * is waiting for, even if it is larger than the byte limit...
     */
 
-    fputs("<h1 class=\"title\">", fp);
-    write_string(fp, title, OUTPUT_EPUB, 0);
-    fputs("</h1>\n", fp);
+    pthread_mutex_lock(&pf->mutex);
 
-    if (author)
+    while (!pf->cancel && i > pf->next_get && (i >= (pf->next_get + PREFETCH_MAX_FILES) || pf->bytes >= PREFETCH_MAX_BYTES))
+      pthread_cond_wait(&pf->cond, &pf->mutex);
+
+#  ifdef POSIX_FADV_WILLNEED
+    window = pf->next_get + PREFETCH_MAX_FILES;
+#  endif /* POSIX_FADV_WILLNEED */
+
+    if (pf->cancel)
     {
-      fputs("<p>", fp);
-      write_string(fp, author, OUTPUT_EPUB, 0);
-      fputs("</p>\n", fp);
+      pthread_mutex_unlock(&pf->mutex);
+      break;
     }
 
-    if (copyright)
+    pthread_mutex_unlock(&pf->mutex);
+
+#  ifdef POSIX_FADV_WILLNEED
+   /*
+    * Hint the whole window of upcoming files so the kernel can start reading
+    * them in parallel...
+    */
+
+    if (window > pf->num_files)
+      window = pf->num_files;
+
+    for (; hinted < window; hinted ++)
     {
-      fputs("<p>", fp);
-      write_string(fp, copyright, OUTPUT_EPUB, 0);
-      fputs("</p>\n", fp);
+      int fd = open(pf->files[hinted].filename, O_RDONLY);
+					/* File descriptor */
+
+      if (fd >= 0)
+      {
+        posix_fadvise(fd, 0, 0, POSIX_FADV_WILLNEED);
+        close(fd);
+      }
     }
-  }
+#  endif /* POSIX_FADV_WILLNEED */
 
- /*
-  * Body...
-  */
+    error = filebuf_read(pf->files[i].filename, &buffer, &length);
 
-  fputs("<div class=\"body\">\n", fp);
+    pthread_mutex_lock(&pf->mutex);
 
-  write_html_body(fp, OUTPUT_EPUB, bodyfile, body, doc);
+    pf->files[i].buffer = buffer;
+    pf->files[i].length = length;
+    pf->files[i].error  = error;
+    pf->files[i].done   = true;
+    pf->bytes           += length;
 
- /*
-  * Footer...
-  */
+    pthread_cond_broadcast(&pf->cond);
+    pthread_mutex_unlock(&pf->mutex);
+  }
 
-  if (footerfile)
-  {
-   /*
-    * Use custom footer...
-    */
+  return (NULL);
+}
+#endif /* HAVE_PTHREAD_H */
 
-    write_file(fp, footerfile, OUTPUT_EPUB);
-  }
 
-  fputs("</div>\n"
-        "</body>\n"
-        "</html>\n", fp);
+/*
+ * 'reserved_compare()' - Compare two reserved words.
+ */
 
- /*
-  * Close XHTML file...
-  */
+static int				/* O - Result of comparison */
+reserved_compare(const char **a,	/* I - First word */
+		 const char **b)	/* I - Second word */
+{
+  return (strcmp(*a, *b));
+}
 
-  fclose(fp);
 
- /*
-  * Make the EPUB archive...
-  */
+/*
+ * 'safe_strcpy()' - Copy a string allowing for overlapping strings.
+ */
 
-  if ((epub = zipcOpen(epubfile, "w")) == NULL)
-  {
-    fprintf(stderr, "codedoc: Unable to create \"%s\": %s\n", epubfile, strerror(errno));
-    unlink(xhtmlfile);
-    exit(1);
-  }
+static void
+safe_strcpy(char       *dst,		/* I - Destination string */
+            const char *src)		/* I - Source string */
+{
+  while (*src)
+    *dst++ = *src++;
 
- /*
-  * Add the mimetype file...
-  */
+  *dst = '\0';
+}
 
-  status |= zipcCreateFileWithString(epub, "mimetype", mimetype);
 
- /*
-  * The META-INF/ directory...
-  */
+#ifdef HAVE_PTHREAD_H
+/*
+ * 'scan_chunk_task()' - Speculatively scan a chunk of a source file.
+ *
+ * Each chunk is scanned into its own tree as if it started a new file, and is
+ * only usable when the scan ends between declarations and did not depend on
+ * anything declared before the chunk.  Chunks the serial scan has already
+ * reached are skipped.
+ */
+
+static void
+scan_chunk_task(scan_chunk_t *chunk)	/* I - Chunk to scan */
+{
+  scan_split_t	*split = chunk->split;	/* Speculatively scanned chunks */
+  mmd_t		*body = NULL;		/* Body (unused, @body@ text is captured) */
+  int		scanned;		/* Result of scan */
 
-  status |= zipcCreateDirectory(epub, "META-INF/");
 
  /*
-  * The META-INF/container.xml file...
+  * Claim the chunk if the serial scan has not reached it yet...
   */
 
-  if ((epubf = zipcCreateFile(epub, "META-INF/container.xml", 1)) != NULL)
+  pthread_mutex_lock(&split->mutex);
+
+  if (chunk->status != SCAN_QUEUED)
   {
-    status |= zipcFilePuts(epubf, container_xml);
-    status |= zipcFileFinish(epubf);
+    pthread_mutex_unlock(&split->mutex);
+    return;
   }
-  else
-    status = -1;
 
- /*
-  * The OEBPS/ directory...
-  */
+  chunk->status = SCAN_RUNNING;
 
-  status |= zipcCreateDirectory(epub, "OEBPS/");
+  pthread_mutex_unlock(&split->mutex);
 
  /*
-  * Copy the OEBPS/body.xhtml file...
+  * Scan it...
   */
 
-  status |= zipcCopyFile(epub, "OEBPS/body.xhtml", xhtmlfile, 1, 1);
+  chunk->file.line    = chunk->line;
+  chunk->file.capture = true;
+  chunk->file.garbage = mxmlNewElement(/*parent*/NULL, "garbage");
+  chunk->tree         = mxmlNewElement(/*parent*/NULL, "codedoc");
 
-  unlink(xhtmlfile);
+  scanned = scan_file(&chunk->file, chunk->tree, chunk->nsname, &body);
 
- /*
-  * Add images...
-  */
+  pthread_mutex_lock(&split->mutex);
 
-  if (coverimage)
-    status |= zipcCopyFile(epub, "OEBPS/cover.png", coverimage, 0, 0);
+  chunk->valid  = scanned && chunk->file.complete && !chunk->file.order_dependent && chunk->file.bufptr >= chunk->file.bufend && !chunk->file.ch;
+  chunk->status = SCAN_DONE;
 
-  node = mmdGetFirstChild(body);
+  pthread_cond_broadcast(&split->cond);
+  pthread_mutex_unlock(&split->mutex);
+}
+#endif /* HAVE_PTHREAD_H */
 
-  while (node)
-  {
-    mmd_t	*next;			/* Next node */
-    const char	*url = mmdGetURL(node);	/* URL for node */
 
-    if (mmdGetType(node) == MMD_TYPE_IMAGE && url && strncmp(url, "http://", 7) && strncmp(url, "https://", 8))
-    {
-      // Image is a local file reference, strip any "#target" and copy it...
-      char	filename[1024],		/* Filename */
-		*sizespec,		/* Pointer to size specification, if any */
-		*name,			/* Base name of file */
-		oebpsname[1024];	/* Filename in EPUB file */
+/*
+ * 'scan_file()' - Scan a source file.
+ *
+ * Namespaces, classes, structures, unions, and 'extern "C"' blocks are scanned
+ * as nested scopes.  The state of the enclosing scopes is saved in a stack
+ * rather than recursing, so deeply nested code cannot overflow the C stack.
+ */
 
-      strncpy(filename, url, sizeof(filename) - 1);
-      filename[sizeof(filename) - 1] = '\0';
+static int				/* O  - 1 on success, 0 on error */
+scan_file(filebuf_t   *file,		/* I  - File to scan */
+          mxml_node_t *tree,		/* I  - Function tree */
+          const char  *nsname,		/* I  - Namespace name */
+          mmd_t       **body)		/* IO - Body markdown text */
+{
+  int		state = STATE_NONE,	/* Current parser state */
+		braces = 0,		/* Number of braces active */
+		parens = 0,		/* Number of active parenthesis */
+		tree_is_scu = 0;	/* Is the tree a struct, class, or union? */
+  int		ch;			/* Current character */
+  int		commline = 0,		/* Line where the current comment started */
+		endline = 0;		/* Line where the last top-level declaration ended */
+  stringbuf_t	buffer;			/* String buffer */
+  const char	*scope = NULL;		/* Current variable/function scope */
+  mxml_node_t	*comment = NULL,	/* <comment> node */
+		*constant = NULL,	/* <constant> node */
+		*enumeration = NULL,	/* <enumeration> node */
+		*function = NULL,	/* <function> node */
+		*fstructclass = NULL,	/* function struct/class node */
+		*structclass = NULL,	/* <struct> or <class> node */
+		*typedefnode = NULL,	/* <typedef> node */
+		*variable = NULL,	/* <variable> or <argument> node */
+		*returnvalue = NULL,	/* <returnvalue> node */
+		*type = NULL,		/* <type> node */
+		*description = NULL,	/* <description> node */
+		*node,			/* Current node */
+		*child = NULL,		/* First child node */
+		*next;			/* Next node */
+  bool		whitespace;		/* Current whitespace value */
+  const char	*string,		/* Current string value */
+		*next_string;		/* Next string value */
+  int		nskeyword = 0;		/* Namespace keyword seen? */
+  char		nsnamestr[1024] = "";	/* Namespace name string */
+  bool		nsalloc = false;	/* Was the namespace name allocated? */
+  scan_scope_t	*scopes = NULL,		/* Enclosing scopes */
+		*sc;			/* Current enclosing scope */
+  size_t	num_scopes = 0,		/* Number of enclosing scopes */
+		alloc_scopes = 0;	/* Allocated enclosing scopes */
+  mxml_node_t	*scopetree;		/* Tree for a new scope */
+  char		*scopens = NULL;	/* Namespace name for a new scope */
+  bool		endscope = false;	/* End the current scope? */
+#if DEBUG > 1
+  mxml_node_t	*temp;			/* Temporary node */
+  int		oldstate,		/* Previous state */
+		oldch;			/* Old character */
+  static const char *states[] =		/* State strings */
+		{
+		  "STATE_NONE",
+		  "STATE_PREPROCESSOR",
+		  "STATE_C_COMMENT",
+		  "STATE_CXX_COMMENT",
+		  "STATE_STRING",
+		  "STATE_CHARACTER",
+		  "STATE_IDENTIFIER"
+		};
+#endif /* DEBUG > 1 */
 
-      if ((sizespec = strstr(filename, " =")) != NULL)
-        *sizespec = '\0';
 
-      if ((name = strrchr(filename, '/')) != NULL)
-        name ++;
-      else
-        name = filename;
+  DEBUG_printf("scan_file(file.filename=\"%s\", .buffer=%p, tree=%p, nsname=\"%s\", body=%p)\n", file->filename, (void *)file->buffer, tree, nsname ? nsname : "(null)", (void *)*body);
 
-      snprintf(oebpsname, sizeof(oebpsname), "OEBPS/%s", name);
+ /*
+  * Read until end-of-file, starting with the file scope...
+  */
 
-      status |= zipcCopyFile(epub, oebpsname, filename, 0, 0);
-    }
+  scopetree = tree;
+
+  stringbuf_clear(&buffer);
 
-    if ((next = mmdGetFirstChild(node)) == NULL)
+  for (;;)
+  {
+    if (scopetree)
     {
-      if ((next = mmdGetNextSibling(node)) == NULL)
+      if (comment)
       {
-	next = mmdGetParent(node);
+       /*
+        * Save the enclosing scope...
+        */
 
-	while (next && mmdGetNextSibling(next) == NULL)
-	  next = mmdGetParent(next);
+        if (num_scopes >= alloc_scopes)
+        {
+          alloc_scopes += 16;
 
-	next = mmdGetNextSibling(next);
-      }
-    }
+          if ((sc = realloc(scopes, alloc_scopes * sizeof(scan_scope_t))) == NULL)
+          {
+            fputs("codedoc: Unable to allocate memory for scopes.\n", stderr);
+            exit(1);
+          }
 
-    node = next;
-  }
+          scopes = sc;
+        }
 
- /*
-  * Now the OEBPS/package.opf file...
-  */
+        sc = scopes + num_scopes ++;
+
+        sc->tree         = tree;
+        sc->nsname       = nsname;
+        sc->nsalloc      = nsalloc;
+        sc->state        = state;
+        sc->braces       = braces;
+        sc->parens       = parens;
+        sc->tree_is_scu  = tree_is_scu;
+        sc->nskeyword    = nskeyword;
+        sc->scope        = scope;
+        sc->comment      = comment;
+        sc->constant     = constant;
+        sc->enumeration  = enumeration;
+        sc->function     = function;
+        sc->fstructclass = fstructclass;
+        sc->structclass  = structclass;
+        sc->typedefnode  = typedefnode;
+        sc->variable     = variable;
+        sc->returnvalue  = returnvalue;
+        sc->type         = type;
+        sc->description  = description;
+        sc->child        = child;
+
+        tree    = scopetree;
+        nsalloc = scopens != NULL;
+
+        if (scopens)
+          nsname = scopens;
+      }
 
-  if ((epubptr = strrchr(epubfile, '/')) != NULL)
-    strlcpy(epubbase, epubptr + 1, sizeof(epubbase));
-  else
-    strlcpy(epubbase, epubfile, sizeof(epubbase));
-
-  if ((epubptr = strstr(epubbase, ".epub")) != NULL)
-    *epubptr = '\0';
-
-  package_opf = mxmlNewXML("1.0");
+     /*
+      * Initialize the finite state machine for the new scope...
+      */
 
-  package = mxmlNewElement(package_opf, "package");
-  mxmlElementSetAttr(package, "xmlns", "http://www.idpf.org/2007/opf");
-  mxmlElementSetAttr(package, "unique-identifier", epubbase);
-  mxmlElementSetAttr(package, "version", "3.0");
+      state        = STATE_NONE;
+      braces       = 0;
+      parens       = 0;
+      comment      = mxmlNewElement(/*parent*/NULL, "temp");
+      constant     = NULL;
+      enumeration  = NULL;
+      function     = NULL;
+      variable     = NULL;
+      returnvalue  = NULL;
+      type         = NULL;
+      description  = NULL;
+      typedefnode  = NULL;
+      structclass  = NULL;
+      fstructclass = NULL;
+      child        = NULL;
+      nskeyword    = 0;
+      tree_is_scu  = !strcmp(mxmlGetElement(tree), "class") || !strcmp(mxmlGetElement(tree), "struct") || !strcmp(mxmlGetElement(tree), "union");
+
+      if (!strcmp(mxmlGetElement(tree), "class"))
+        scope = "private";
+      else
+        scope = NULL;
 
-    metadata = mxmlNewElement(package, "metadata");
-    mxmlElementSetAttr(metadata, "xmlns:dc", "http://purl.org/dc/elements/1.1/");
-    mxmlElementSetAttr(metadata, "xmlns:opf", "http://www.idpf.org/2007/opf");
+      scopetree = NULL;
+      scopens   = NULL;
+    }
+    else if (endscope)
+    {
+     /*
+      * Restore the enclosing scope...
+      */
 
-      temp = mxmlNewElement(metadata, "dc:title");
-      mxmlNewOpaque(temp, title);
+      mxmlAdd(file->garbage, MXML_ADD_AFTER, NULL, comment);
+
+      if (nsalloc)
+        free((char *)nsname);
+
+      sc = scopes + -- num_scopes;
+
+      tree         = sc->tree;
+      nsname       = sc->nsname;
+      nsalloc      = sc->nsalloc;
+      state        = sc->state;
+      braces       = sc->braces;
+      parens       = sc->parens;
+      tree_is_scu  = sc->tree_is_scu;
+      nskeyword    = sc->nskeyword;
+      scope        = sc->scope;
+      comment      = sc->comment;
+      constant     = sc->constant;
+      enumeration  = sc->enumeration;
+      function     = sc->function;
+      fstructclass = sc->fstructclass;
+      structclass  = sc->structclass;
+      typedefnode  = sc->typedefnode;
+      variable     = sc->variable;
+      returnvalue  = sc->returnvalue;
+      type         = sc->type;
+      description  = sc->description;
+      child        = sc->child;
+
+      nsnamestr[0] = '\0';
+      endscope     = false;
+    }
+
+    if (file->split && file->bufptr >= file->split->next)
+    {
+     /*
+      * Use the speculative scan of the next chunk when nothing is pending...
+      */
 
-      temp = mxmlNewElement(metadata, "dc:creator");
-      mxmlNewOpaque(temp, author);
+      scan_graft(file, tree, nsname, body, state != STATE_NONE || braces || parens || nskeyword || scope || mxmlGetFirstChild(comment) || constant || enumeration || function || fstructclass || structclass || typedefnode || variable || returnvalue || type);
+    }
 
-      temp = mxmlNewElement(metadata, "meta");
-      mxmlElementSetAttr(temp, "property", "dcterms:modified");
-      mxmlNewOpaque(temp, get_iso_date(time(NULL)));
+    if ((ch = filebuf_getc(file)) == EOF)
+    {
+      if (!num_scopes)
+        break;
 
-      temp = mxmlNewElement(metadata, "dc:language");
-      mxmlNewOpaque(temp, language);
+      endscope = true;
+      continue;
+    }
 
-      temp = mxmlNewElement(metadata, "dc:rights");
-      mxmlNewOpaque(temp, copyright);
+#if DEBUG > 1
+    oldstate = state;
+    oldch    = ch;
+#endif /* DEBUG > 1 */
 
-      temp = mxmlNewElement(metadata, "dc:publisher");
-      mxmlNewOpaque(temp, "codedoc");
+    switch (state)
+    {
+      case STATE_NONE :			/* No state - whitespace, etc. */
+          switch (ch)
+	  {
+	    case '/' :			/* Possible C/C++ comment */
+	        ch = filebuf_getc(file);
 
-      temp = mxmlNewElement(metadata, "dc:subject");
-      mxmlNewOpaque(temp, "Programming");
+		stringbuf_clear(&buffer);
 
-      temp = mxmlNewElement(metadata, "dc:identifier");
-      mxmlElementSetAttr(temp, "id", epubbase);
-      snprintf(identifier, sizeof(identifier), "%s-%s", epubbase, docversion);
-      mxmlNewOpaque(temp, identifier);
+		if (ch == '*')
+		{
+		  state    = STATE_C_COMMENT;
+		  commline = file->line;
+		}
+		else if (ch == '/')
+		{
+		  state    = STATE_CXX_COMMENT;
+		  commline = file->line;
 
-      if (coverimage)
-      {
-        temp = mxmlNewElement(metadata, "meta");
-        mxmlElementSetAttr(temp, "name", "cover");
-        mxmlElementSetAttr(temp, "content", "cover-image");
-      }
+		  if ((ch = filebuf_getc(file)) != ' ')
+		    filebuf_ungetc(file, ch);
+		}
+		else
+		{
+		  filebuf_ungetc(file, ch);
 
-    manifest = mxmlNewElement(package, "manifest");
+		  if (type)
+		  {
+                    DEBUG_puts("Identifier: <<<< / >>>\n");
 
-      temp = mxmlNewElement(manifest, "item");
-      mxmlElementSetAttr(temp, "id", "nav");
-      mxmlElementSetAttr(temp, "href", "nav.xhtml");
-      mxmlElementSetAttr(temp, "media-type", "application/xhtml+xml");
-      mxmlElementSetAttr(temp, "properties", "nav");
+                    ch = get_nth_text(type, -1, NULL)[0];
+		    mxmlNewText(type, isalnum(ch & 255) || ch == '_', "/");
+		  }
+		}
+		break;
 
-      temp = mxmlNewElement(manifest, "item");
-      mxmlElementSetAttr(temp, "id", "body");
-      mxmlElementSetAttr(temp, "href", "body.xhtml");
-      mxmlElementSetAttr(temp, "media-type", "application/xhtml+xml");
+	    case '#' :			/* Preprocessor */
+	        DEBUG_puts("    #preprocessor...\n");
 
-      if (coverimage)
-      {
-        temp = mxmlNewElement(manifest, "item");
-        mxmlElementSetAttr(temp, "id", "cover-image");
-        mxmlElementSetAttr(temp, "href", "cover.png");
-        mxmlElementSetAttr(temp, "media-type", "image/png");
-      }
+	        state = STATE_PREPROCESSOR;
+	        while (mxmlGetFirstChild(comment))
+	          mxmlAdd(file->garbage, MXML_ADD_AFTER, NULL, mxmlGetFirstChild(comment));
+		break;
 
-    spine = mxmlNewElement(package, "spine");
+            case '\'' :			/* Character constant */
+	        state = STATE_CHARACTER;
 
-      temp = mxmlNewElement(spine, "itemref");
-      mxmlElementSetAttr(temp, "idref", "body");
+		stringbuf_clear(&buffer);
+		stringbuf_append(&buffer, ch);
+		break;
 
-  options = mxmlOptionsNew();
-  mxmlOptionsSetWhitespaceCallback(options, epub_ws_cb, /*cbdata*/NULL);
+            case '\"' :			/* String constant */
+	        state = STATE_STRING;
 
-  package_opf_string = mxmlSaveAllocString(package_opf, options);
+		stringbuf_clear(&buffer);
+		stringbuf_append(&buffer, ch);
+		break;
 
-  mxmlOptionsDelete(options);
+            case '{' :
+                if (nskeyword)
+                {
+                  if ((scopens = strdup(nsnamestr)) == NULL)
+                  {
+                    fputs("codedoc: Unable to allocate memory for namespace.\n", stderr);
+                    exit(1);
+                  }
 
-  if ((epubf = zipcCreateFile(epub, "OEBPS/package.opf", 1)) != NULL)
-  {
-    status |= zipcFilePuts(epubf, package_opf_string);
-    status |= zipcFileFinish(epubf);
-  }
-  else
-    status = -1;
+                  scopetree    = tree;
+		  nskeyword    = 0;
+		  nsnamestr[0] = '\0';
+                  break;
+                }
 
-  free(package_opf_string);
+                string      = get_nth_text(type, 0, &whitespace);
+                next_string = get_nth_text(type, 1, NULL);
 
- /*
-  * Then the OEBPS/nav.xhtml file...
-  */
+#ifdef DEBUG
+	        DEBUG_printf("    open brace, function=%p, type=%p...\n", function, type);
+                if (type)
+                  DEBUG_printf("    type->child=\"%s\"...\n", string);
+#endif /* DEBUG */
 
-  if ((epubf = zipcCreateFile(epub, "OEBPS/nav.xhtml", 1)) != NULL)
-  {
-    toc = build_toc(doc, bodyfile, body, footerfile, OUTPUT_EPUB);
+	        if (function)
+		{
+                  mxml_node_t *temptype = mxmlFindElement(returnvalue, returnvalue, "type", NULL, NULL, MXML_DESCEND_ALL);
 
-    zipcFilePrintf(epubf, "<?xml version=\"1.0\" encoding=\"utf-8\"?>\n"
-                          "<!DOCTYPE html>\n"
-                          "<html xmlns=\"http://www.w3.org/1999/xhtml\" xmlns:epub=\"http://www.idpf.org/2007/ops\">\n"
-                          "<head>\n"
-                          "<title>%s</title>\n"
-                          "<style>ol { list-style-type: none; }</style>\n"
-                          "</head>\n"
-                          "<body>\n"
-                          "<nav epub:type=\"toc\"><ol>\n", title);
+		  DEBUG_printf("    returnvalue type=%p(%s)\n", temptype, temptype ? mxmlGetText(mxmlGetFirstChild(temptype), NULL) : "null");
 
-    for (i = 0, tentry = toc->entries, toc_level = 1; i < toc->num_entries; i ++, tentry ++)
-    {
-      if (tentry->level > toc_level)
-      {
-        toc_level = tentry->level;
-      }
-      else if (tentry->level < toc_level)
-      {
-        zipcFilePuts(epubf, "</ol></li>\n");
-        toc_level = tentry->level;
-      }
+		  if (temptype && mxmlGetFirstChild(temptype) && !strcmp(mxmlGetText(mxmlGetFirstChild(temptype), NULL), "static") && !strcmp(mxmlGetElement(tree), "codedoc"))
+                  {
+                   /*
+                    * Remove static functions...
+                    */
 
-      zipcFilePrintf(epubf, "<li><a href=\"body.xhtml#%s\">%s</a>", tentry->anchor, tentry->title);
-      if ((i + 1) < toc->num_entries && tentry[1].level > toc_level)
-        zipcFilePuts(epubf, "<ol>\n");
-      else
-        zipcFilePuts(epubf, "</li>\n");
-    }
+                    DEBUG_puts("    DELETING STATIC FUNCTION\n");
 
-    if (toc_level == 2)
-      zipcFilePuts(epubf, "</ol></li>\n");
+                    mxmlAdd(file->garbage, MXML_ADD_AFTER, NULL, function);
+                  }
+                  else if (fstructclass)
+		  {
+		    sort_node(file, fstructclass, function);
+		    fstructclass = NULL;
+		  }
+		  else
+		    sort_node(file, tree, function);
 
-    zipcFilePuts(epubf, "</ol></nav>\n"
-                        "</body>\n"
-                        "</html>\n");
+		  function    = NULL;
+		  returnvalue = NULL;
+		}
+		else if (type && string && ((!strcmp(string, "typedef") && next_string && (!strcmp(next_string, "struct") || !strcmp(next_string, "union") || !strcmp(next_string, "class"))) || !strcmp(string, "union") || !strcmp(string, "struct") || !strcmp(string, "class")))
+		{
+		 /*
+		  * Start of a class or structure...
+		  */
 
-    zipcFileFinish(epubf);
-    free_toc(toc);
-  }
-  else
-    status = -1;
+		  if (!strcmp(string, "typedef"))
+		  {
+                    DEBUG_puts("    starting typedef...\n");
 
-  status |= zipcClose(epub);
+		    typedefnode = mxmlNewElement(/*parent*/NULL, "typedef");
+		    mxmlAdd(file->garbage, MXML_ADD_AFTER, NULL, mxmlGetFirstChild(type));
 
-  if (status)
-  {
-    fprintf(stderr, "codedoc: Unable to write \"%s\": %s\n", epubfile, strerror(errno));
-    exit(1);
-  }
-}
+		    string      = next_string;
+		    next_string = get_nth_text(type, 1, NULL);
+		  }
+		  else
+		    typedefnode = NULL;
 
+		  structclass = mxmlNewElement(/*parent*/NULL, string);
 
-/*
- * 'write_file()' - Copy a file to the output.
- */
+#ifdef DEBUG
+                  DEBUG_printf("%c%s: <<<< %s >>>\n", toupper(string[0]), string + 1, next_string ? next_string : "(noname)");
 
-static void
-write_file(FILE       *out,		/* I - Output file */
-           const char *file,		/* I - File to copy */
-           int        mode)		/* I - Output mode */
-{
-  if (is_markdown(file))
-  {
-   /*
-    * Convert markdown source to the output format...
-    */
+                  DEBUG_puts("    type =");
+                  for (node = mxmlGetFirstChild(type); node; node = mxmlGetNextSibling(node))
+		    DEBUG_printf(" \"%s\"", mxmlGetText(node, NULL));
+		  DEBUG_puts("\n");
 
-    mmd_t *mmd = mmdLoad(NULL, file);	/* Markdown document */
+                  DEBUG_printf("    scope = %s\n", scope ? scope : "(null)");
+#endif /* DEBUG */
 
-    if (mmd)
-    {
-      markdown_write_block(out, mmd, mode);
-      mmdFree(mmd);
-    }
-    else
-    {
-      fprintf(stderr, "codedoc: Unable to open \"%s\": %s\n", file, strerror(errno));
-      exit(1);
-    }
-  }
-  else
-  {
-   /*
-    * Copy non-markdown source...
-    */
+                  if (next_string)
+		  {
+		    if (nsname)
+		    {
+		      mxmlElementSetAttrf(structclass, "name", "%s::%s", nsname, next_string);
+		      mxmlSetText(get_nth_child(type, 1), 1, mxmlElementGetAttr(structclass, "name"));
+		    }
+		    else
+		      mxmlElementSetAttr(structclass, "name", next_string);
+		    sort_node(file, tree, structclass);
+		  }
 
-    FILE	*fp;			/* Copy file */
-    char	line[8192],		/* Line from file */
-		*ptr;			/* Pointer into line */
+                  child = mxmlGetFirstChild(type);
 
-    if ((fp = fopen(file, "r")) == NULL)
-    {
-      fprintf(stderr, "codedoc: Unable to open \"%s\": %s\n", file, strerror(errno));
-      exit(1);
-    }
+                  if (typedefnode && child)
+                  {
+                    clear_whitespace(mxmlGetFirstChild(type));
+		  }
+                  else if (structclass && child && mxmlGetNextSibling(child) && mxmlGetNextSibling(mxmlGetNextSibling(child)))
+		  {
+		    char temp[65536], *tempptr;
 
-    while (fgets(line, sizeof(line), fp))
-    {
-      if (mode == OUTPUT_EPUB)
-      {
-       /*
-	* Convert common HTML named entities to XHTML numeric entities.
-	*/
+		    for (tempptr = temp, node = mxmlGetNextSibling(mxmlGetNextSibling(child)); node; tempptr += strlen(temp))
+		    {
+		      string = mxmlGetText(node, &whitespace);
 
-	for (ptr = line; *ptr; ptr ++)
-	{
-	  if (!strncmp(ptr, "&nbsp;", 6))
-	  {
-	    ptr += 5;
-	    fputs("&#160;", out);
-	  }
-	  else if (!strncmp(ptr, "&copy;", 6))
-	  {
-	    ptr += 5;
-	    fputs("&#169;", out);
-	  }
-	  else if (!strncmp(ptr, "&reg;", 5))
-	  {
-	    ptr += 4;
-	    fputs("&#174;", out);
-	  }
-	  else if (!strncmp(ptr, "&trade;", 7))
-	  {
-	    ptr += 6;
-	    fputs("&#8482;", out);
-	  }
-	  else
-	    fputc(*ptr, out);
-	}
-      }
-      else
-      {
-       /*
-	* Copy as-is...
-	*/
+		      if (whitespace && tempptr > temp && tempptr < (temp + sizeof(temp) - 1))
+			*tempptr++ = ' ';
 
-	fputs(line, out);
-      }
-    }
+		      strlcpy(tempptr, string, sizeof(temp) - (size_t)(tempptr - temp));
 
-    fclose(fp);
-  }
-}
+		      next = mxmlGetNextSibling(node);
+		      mxmlAdd(file->garbage, MXML_ADD_AFTER, NULL, node);
+		      node = next;
+		    }
 
+		    mxmlElementSetAttr(structclass, "parent", temp);
 
-/*
- * 'write_function()' - Write documentation for a function.
- */
+		    mxmlAdd(file->garbage, MXML_ADD_AFTER, NULL, type);
+		    type = NULL;
+		  }
+		  else
+		  {
+		    mxmlAdd(file->garbage, MXML_ADD_AFTER, NULL, type);
+		    type = NULL;
+		  }
 
-static void
-write_function(FILE        *out,	/* I - Output file */
-               int         mode,	/* I - Output mode */
-               mxml_node_t *doc,	/* I - Document */
-               mxml_node_t *function,	/* I - Function */
-	       int         level)	/* I - Base heading level */
-{
-  mxml_node_t	*arg,			/* Current argument */
-		*adesc,			/* Description of argument */
-		*description,		/* Description of function */
-		*type,			/* Type for argument */
-		*node;			/* Node in description */
-  const char	*name,			/* Name of function/type */
-		*defval;		/* Default value */
-  const char	*prefix;		/* Prefix string */
-  char		*sep;			/* Newline separator */
+		  if (typedefnode && mxmlGetLastChild(comment))
+		  {
+		   /*
+		    * Copy comment for typedef as well as class/struct/union...
+		    */
 
+		    mxmlNewOpaque(comment, mxmlGetOpaque(mxmlGetLastChild(comment)));
+		    description = mxmlNewElement(typedefnode, "description");
 
-  name        = mxmlElementGetAttr(function, "name");
-  description = mxmlFindElement(function, function, "description", NULL, NULL, MXML_DESCEND_FIRST);
+		    DEBUG_printf("    duplicating comment %p/%p for typedef...\n", mxmlGetLastChild(comment), mxmlGetFirstChild(comment));
 
-  fprintf(out, "<h%d class=\"%s\">%s<a id=\"%s\">%s</a></h%d>\n", level, level == 3 ? "function" : "method", get_comment_info(description), name, name, level);
+		    update_comment(typedefnode, mxmlGetLastChild(comment));
+		    mxmlAdd(description, MXML_ADD_AFTER, /*parent*/NULL, mxmlGetLastChild(comment));
+		  }
 
-  if (description)
-    write_description(out, mode, description, "p", 1);
+		  description = mxmlNewElement(structclass, "description");
 
-  fputs("<p class=\"code\">\n", out);
+		  DEBUG_printf("    adding comment %p/%p to %s...\n", mxmlGetLastChild(comment), mxmlGetFirstChild(comment), mxmlGetElement(structclass));
 
-  arg = mxmlFindElement(function, function, "returnvalue", NULL, NULL, MXML_DESCEND_FIRST);
+		  update_comment(structclass, mxmlGetLastChild(comment));
+		  mxmlAdd(description, MXML_ADD_AFTER, /*parent*/NULL, mxmlGetLastChild(comment));
 
-  if (arg)
-    write_element(out, doc, mxmlFindElement(arg, arg, "type", NULL, NULL, MXML_DESCEND_FIRST), OUTPUT_HTML);
-  else
-    fputs("<span class=\"reserved\">void</span> ", out);
+                  scopetree   = structclass;
+                  structclass = NULL;
+                  break;
+                }
+		else if (type && string && next_string && (!strcmp(string, "enum") || (!strcmp(string, "typedef") && !strcmp(next_string, "enum"))))
+                {
+		 /*
+		  * Enumeration type...
+		  */
 
-  fputs(name, out);
-  for (arg = mxmlFindElement(function, function, "argument", NULL, NULL, MXML_DESCEND_FIRST), prefix = "("; arg; arg = mxmlFindElement(arg, function, "argument", NULL, NULL, MXML_DESCEND_NONE), prefix = ", ")
-  {
-    type = mxmlFindElement(arg, arg, "type", NULL, NULL, MXML_DESCEND_FIRST);
+		  if (!strcmp(string, "typedef"))
+		  {
+                    DEBUG_puts("    starting typedef...\n");
 
-    fputs(prefix, out);
-    if (mxmlGetFirstChild(type))
-      write_element(out, doc, type, mode);
+		    typedefnode = mxmlNewElement(/*parent*/NULL, "typedef");
+		    mxmlAdd(file->garbage, MXML_ADD_AFTER, NULL, mxmlGetFirstChild(type));
+		    string      = next_string;
+		    next_string = get_nth_text(type, 1, NULL);
+		  }
+		  else
+		    typedefnode = NULL;
 
-    fputs(mxmlElementGetAttr(arg, "name"), out);
-    if ((defval = mxmlElementGetAttr(arg, "default")) != NULL)
-    {
-      if (!strncmp(defval, "= ", 2))
-        defval += 2;
+		  enumeration = mxmlNewElement(/*parent*/NULL, "enumeration");
 
-      if (isdigit(*defval) || *defval == '-' || *defval == '.')
-        fprintf(out, " = <span class=\"number\">%s</span>", defval);
-      else if (*defval == '\'' || *defval == '\"')
-        fprintf(out, " = <span class=\"string\">%s</span>", defval);
-      else
-	fprintf(out, " = %s", defval);
-    }
-  }
+                  DEBUG_printf("Enumeration: <<<< %s >>>\n", next_string ? next_string : "(noname)");
 
-  if (!strcmp(prefix, "("))
-    fputs("(<span class=\"reserved\">void</span>);</p>\n", out);
-  else
-  {
-    fprintf(out,
-            ");</p>\n"
-	    "<h%d class=\"parameters\">Parameters</h%d>\n"
-	    "<table class=\"list\"><tbody>\n", level + 1, level + 1);
+                  if (next_string)
+		  {
+		    if (nsname)
+		    {
+		      mxmlElementSetAttrf(enumeration, "name", "%s::%s", nsname, next_string);
+		      mxmlSetText(get_nth_child(type, 1), 1, mxmlElementGetAttr(enumeration, "name"));
+		    }
+		    else
+		      mxmlElementSetAttr(enumeration, "name", next_string);
 
-    for (arg = mxmlFindElement(function, function, "argument", NULL, NULL, MXML_DESCEND_FIRST); arg; arg = mxmlFindElement(arg, function, "argument", NULL, NULL, MXML_DESCEND_NONE))
-    {
-      fprintf(out, "<tr><th>%s</th>\n", mxmlElementGetAttr(arg, "name"));
+		    sort_node(file, tree, enumeration);
+		  }
 
-      adesc = mxmlFindElement(arg, arg, "description", NULL, NULL, MXML_DESCEND_FIRST);
+                  if (typedefnode && mxmlGetFirstChild(type))
+                  {
+                    clear_whitespace(mxmlGetFirstChild(type));
+		  }
+                  else
+		  {
+		    mxmlAdd(file->garbage, MXML_ADD_AFTER, NULL, type);
+		    type = NULL;
+		  }
 
-      write_description(out, mode, adesc, "td", -1);
-      fputs("</tr>\n", out);
-    }
+		  if (typedefnode && mxmlGetLastChild(comment))
+		  {
+		   /*
+		    * Copy comment for typedef as well as class/struct/union...
+		    */
 
-    fputs("</tbody></table>\n", out);
-  }
+		    mxmlNewOpaque(comment, mxmlGetOpaque(mxmlGetLastChild(comment)));
+		    description = mxmlNewElement(typedefnode, "description");
 
-  arg = mxmlFindElement(function, function, "returnvalue", NULL, NULL, MXML_DESCEND_FIRST);
+		    DEBUG_printf("    duplicating comment %p/%p for typedef...\n", mxmlGetLastChild(comment), mxmlGetFirstChild(comment));
 
-  if (arg)
-  {
-    fprintf(out, "<h%d class=\"returnvalue\">Return Value</h%d>\n", level + 1, level + 1);
+		    update_comment(typedefnode, mxmlGetLastChild(comment));
+		    mxmlAdd(description, MXML_ADD_AFTER, /*parent*/NULL, mxmlGetLastChild(comment));
+		  }
 
-    adesc = mxmlFindElement(arg, arg, "description", NULL, NULL, MXML_DESCEND_FIRST);
+		  description = mxmlNewElement(enumeration, "description");
 
-    write_description(out, mode, adesc, "p", 1);
-    write_description(out, mode, adesc, "p", 0);
-  }
+		  DEBUG_printf("    adding comment %p/%p to enumeration...\n", mxmlGetLastChild(comment), mxmlGetFirstChild(comment));
 
-  if (description)
-  {
-    for (node = mxmlGetFirstChild(description); node; node = mxmlGetNextSibling(node))
-    {
-      const char *opaque = mxmlGetOpaque(node);
+		  update_comment(enumeration, mxmlGetLastChild(comment));
+		  mxmlAdd(description, MXML_ADD_AFTER, /*parent*/NULL, mxmlGetLastChild(comment));
+		}
+		else if (type && string && !strcmp(string, "extern"))
+                {
+                  scopetree = tree;
+                }
+		else if (type)
+		{
+		  mxmlAdd(file->garbage, MXML_ADD_AFTER, NULL, type);
+		  type = NULL;
+		}
 
-      if (opaque && (sep = strstr(opaque, "\n\n")) != NULL)
-      {
-	sep += 2;
-	if (*sep && strncmp(sep, "@since ", 7) && strncmp(sep, "@deprecated@", 12))
-	  break;
-      }
-    }
+	        braces ++;
+		function = NULL;
+		variable = NULL;
+		break;
 
-    if (node)
-    {
-      fprintf(out, "<h%d class=\"discussion\">Discussion</h%d>\n", level + 1, level + 1);
-      write_description(out, mode, description, "p", 0);
-    }
-  }
-}
+            case '}' :
+	        DEBUG_puts("    close brace...\n");
 
+                if (structclass)
+		  scope = NULL;
 
-/*
- * 'write_html()' - Write HTML documentation.
- */
+                if (!typedefnode)
+		  enumeration = NULL;
 
-static void
-write_html(const char  *section,	/* I - Section */
-	   const char  *title,		/* I - Title */
-           const char  *author,		/* I - Author's name */
-           const char  *language,	/* I - Language */
-           const char  *copyright,	/* I - Copyright string */
-	   const char  *docversion,	/* I - Documentation set version */
-	   const char  *cssfile,	/* I - Stylesheet file */
-           const char  *coverimage,	/* I - Cover image file */
-	   const char  *headerfile,	/* I - Header file */
-	   const char  *bodyfile,	/* I - Body file */
-           mmd_t       *body,		/* I - Markdown body */
-	   mxml_node_t *doc,		/* I - XML documentation */
-           const char  *footerfile)	/* I - Footer file */
-{
-  toc_t		*toc;			/* Table of contents */
+		constant    = NULL;
+		structclass = NULL;
 
+	        if (braces > 0)
+	        {
+		  braces --;
+		  if (braces == 0)
+		  {
+		    while (mxmlGetFirstChild(comment))
+		      mxmlAdd(file->garbage, MXML_ADD_AFTER, NULL, mxmlGetFirstChild(comment));
 
- /*
-  * Create the table-of-contents entries...
-  */
+		    if (!strcmp(mxmlGetElement(tree), "codedoc"))
+		      endline = file->line;
+		  }
+		}
+		else if (num_scopes)
+		{
+		  endscope = true;
+		}
+		else
+		{
+		  mxmlAdd(file->garbage, MXML_ADD_AFTER, NULL, comment);
+		  free(scopes);
+		  return (1);
+		}
+		break;
 
-  toc = build_toc(doc, bodyfile, body, footerfile, OUTPUT_HTML);
+            case '(' :
+		if (type)
+		{
+                  DEBUG_puts("Identifier: <<<< ( >>>\n");
 
- /*
-  * Standard header...
-  */
+		  mxmlNewText(type, 0, "(");
+		}
 
-  write_html_head(stdout, OUTPUT_HTML, section, title, author, language, copyright, docversion, cssfile);
+	        parens ++;
+		break;
 
-  puts("<div class=\"header\">");
+            case ')' :
+		if (type && parens)
+		{
+                  DEBUG_puts("Identifier: <<<< ) >>>\n");
 
-  if (coverimage)
-  {
-    const char	*coverbase;		/* Base name for cover image */
+		  mxmlNewText(type, 0, ")");
+		}
 
-    if ((coverbase = strrchr(coverimage, '/')) != NULL)
-      coverbase ++;
-    else
-      coverbase = coverimage;
+                if (function && type && !parens)
+		{
+		 /*
+		  * Check for "void" argument...
+		  */
 
-    fputs("<p><img class=\"title\" src=\"", stdout);
-    write_string(stdout, coverbase, OUTPUT_HTML, 0);
-    fputs("\"></p>\n", stdout);
-  }
+		  if ((child = mxmlGetFirstChild(type)) != NULL && mxmlGetNextSibling(child))
+		    variable = add_variable(file, function, "argument", type);
+		  else
+		    mxmlAdd(file->garbage, MXML_ADD_AFTER, NULL, type);
 
- /*
-  * Header...
-  */
+		  type = NULL;
+		}
 
-  if (headerfile)
-  {
-   /*
-    * Use custom header...
-    */
+	        if (parens > 0)
+		  parens --;
+		break;
 
-    write_file(stdout, headerfile, OUTPUT_HTML);
-  }
-  else
-  {
-   /*
-    * Use standard header...
-    */
+	    case ';' :
+                DEBUG_puts("Identifier: <<<< ; >>>\n");
 
-    fputs("<h1 class=\"title\">", stdout);
-    write_string(stdout, title, OUTPUT_HTML, 0);
-    fputs("</h1>\n", stdout);
+		if (!braces && !parens && !strcmp(mxmlGetElement(tree), "codedoc"))
+		{
+		 /*
+		  * The end of a top-level declaration - earlier comments and any
+		  * comment that follows on the same line don't apply to the next
+		  * declaration...
+		  */
 
-    if (author)
-    {
-      fputs("<p>", stdout);
-      write_string(stdout, author, OUTPUT_HTML, 0);
-      fputs("</p>\n", stdout);
-    }
+		  while (mxmlGetFirstChild(comment))
+		    mxmlAdd(file->garbage, MXML_ADD_AFTER, NULL, mxmlGetFirstChild(comment));
 
-    if (copyright)
-    {
-      fputs("<p>", stdout);
-      write_string(stdout, copyright, OUTPUT_HTML, 0);
-      fputs("</p>\n", stdout);
-    }
-  }
+		  endline = file->line;
+		}
+		DEBUG_printf("    enumeration=%p, function=%p, type=%p, type->child=%p, typedefnode=%p\n", enumeration, function, type, mxmlGetFirstChild(type), typedefnode);
 
-  puts("</div>");
+		if (function)
+		{
+                  mxml_node_t *temptype = mxmlFindElement(returnvalue, returnvalue, "type", NULL, NULL, MXML_DESCEND_ALL);
 
- /*
-  * Table of contents...
-  */
+                  DEBUG_printf("    returnvalue type=%p(%s)\n", temptype, temptype ? mxmlGetText(mxmlGetFirstChild(temptype), NULL) : "null");
 
-  write_html_toc(stdout, title, toc, NULL, NULL);
+		  if (temptype && mxmlGetFirstChild(temptype) && !strcmp(get_nth_text(temptype, 0, NULL), "static") && !strcmp(mxmlGetElement(tree), "codedoc"))
+                  {
+                   /*
+                    * Remove static functions...
+                    */
 
-  free_toc(toc);
+                    DEBUG_puts("    DELETING STATIC FUNCTION\n");
 
- /*
-  * Body...
-  */
+                    mxmlAdd(file->garbage, MXML_ADD_AFTER, NULL, function);
+                  }
+                  else if (!strcmp(mxmlGetElement(tree), "class"))
+		  {
+		    DEBUG_puts("    ADDING FUNCTION TO CLASS\n");
+		    sort_node(file, tree, function);
+		  }
+		  else
+		    mxmlAdd(file->garbage, MXML_ADD_AFTER, NULL, function);
 
-  puts("<div class=\"body\">");
+		  function    = NULL;
+		  variable    = NULL;
+		  returnvalue = NULL;
+		}
 
-  write_html_body(stdout, OUTPUT_HTML, bodyfile, body, doc);
+		if (type)
+		{
+		 /*
+		  * See if we have a typedef...
+		  */
 
- /*
-  * Footer...
-  */
+                  string = get_nth_text(type, 0, NULL);
+		  if (string && !strcmp(string, "typedef"))
+		  {
+		   /*
+		    * Yes, add it!
+		    */
 
-  if (footerfile)
-  {
-   /*
-    * Use custom footer...
-    */
+		    typedefnode = mxmlNewElement(/*parent*/NULL, "typedef");
 
-    puts("</div>");
-    puts("<div class=\"footer\">");
+		    for (node = get_nth_child(type, 1); node; node = mxmlGetNextSibling(node))
+		      if (!strcmp(mxmlGetText(node, NULL), "("))
+			break;
 
-    write_file(stdout, footerfile, OUTPUT_HTML);
-  }
+                    if (node)
+		    {
+		      for (node = mxmlGetNextSibling(node); node; node = mxmlGetNextSibling(node))
+			if (strcmp(mxmlGetText(node, NULL), "*"))
+			  break;
+                    }
 
-  puts("</div>\n"
-       "</body>\n"
-       "</html>");
-}
+                    if (!node)
+		      node = mxmlGetLastChild(type);
 
+		    DEBUG_printf("    ADDING TYPEDEF FOR %p(%s)...\n", node, mxmlGetText(node, NULL));
 
-/*
- * 'write_html_body()' - Write a HTML/XHTML body.
- */
+		    mxmlElementSetAttr(typedefnode, "name", mxmlGetText(node, NULL));
+		    sort_node(file, tree, typedefnode);
 
-static void
-write_html_body(
-    FILE        *out,			/* I - Output file */
-    int         mode,			/* I - HTML or EPUB/XHTML output */
-    const char  *bodyfile,		/* I - Body file */
-    mmd_t       *body,			/* I - Markdown body */
-    mxml_node_t *doc)			/* I - XML documentation */
-{
-  mxml_node_t	*function,		/* Current function */
-		*scut,			/* Struct/class/union/typedef */
-		*arg,			/* Current argument */
-		*description,		/* Description of function/var */
-		*type;			/* Type for argument */
-  const char	*name,			/* Name of function/type */
-		*defval;		/* Default value */
-  bool		whitespace;		/* Current whitespace value */
-  const char	*string;		/* Current string value */
+                    if (mxmlGetFirstChild(type) != node)
+		      mxmlAdd(file->garbage, MXML_ADD_AFTER, NULL, mxmlGetFirstChild(type));
 
+		    mxmlAdd(file->garbage, MXML_ADD_AFTER, NULL, node);
+		    node = NULL;
 
- /*
-  * Body...
-  */
+		    if (mxmlGetFirstChild(type))
+		      clear_whitespace(mxmlGetFirstChild(type));
 
-  if (body)
-    markdown_write_block(out, body, mode);
-  else if (bodyfile)
-    write_file(out, bodyfile, mode);
+		    mxmlAdd(typedefnode, MXML_ADD_AFTER, /*parent*/NULL, type);
+		    type = NULL;
+		    break;
+		  }
+		  else if (typedefnode && enumeration)
+		  {
+		   /*
+		    * Add enum typedef...
+		    */
 
- /*
-  * List of classes...
-  */
+                    node = mxmlGetFirstChild(type);
 
-  if ((scut = find_public(doc, doc, "class", NULL, mode)) != NULL)
-  {
-    fputs("<h2 class=\"title\"><a id=\"CLASSES\">Classes</a></h2>\n", out);
+		    DEBUG_printf("    ADDING TYPEDEF FOR %p(%s)...\n", node, mxmlGetText(node, NULL));
 
-    while (scut)
-    {
-      write_scu(out, mode, doc, scut);
+		    mxmlElementSetAttr(typedefnode, "name", mxmlGetText(node, NULL));
+		    sort_node(file, tree, typedefnode);
+		    mxmlAdd(file->garbage, MXML_ADD_AFTER, NULL, type);
 
-      scut = find_public(scut, doc, "class", NULL, mode);
-    }
-  }
+		    type = mxmlNewElement(typedefnode, "type");
+                    mxmlNewText(type, 0, "enum");
+		    mxmlNewText(type, 1, mxmlElementGetAttr(enumeration, "name"));
+		    enumeration = NULL;
+		    type = NULL;
+		    break;
+		  }
 
- /*
-  * List of functions...
-  */
+		  mxmlAdd(file->garbage, MXML_ADD_AFTER, NULL, type);
+		  type = NULL;
+		}
+		break;
 
-  if ((function = find_public(doc, doc, "function", NULL, mode)) != NULL)
-  {
-    fputs("<h2 class=\"title\"><a id=\"FUNCTIONS\">Functions</a></h2>\n", out);
+	    case ':' :
+		if (type)
+		{
+                  DEBUG_puts("Identifier: <<<< : >>>\n");
 
-    while (function)
-    {
-      write_function(out, mode, doc, function, 3);
-
-      function = find_public(function, doc, "function", NULL, mode);
-    }
-  }
+		  mxmlNewText(type, 1, ":");
+		}
+		break;
 
- /*
-  * List of types...
-  */
+	    case '*' :
+		if (type)
+		{
+                  DEBUG_puts("Identifier: <<<< * >>>\n");
 
-  if ((scut = find_public(doc, doc, "typedef", NULL, mode)) != NULL)
-  {
-    fputs("<h2 class=\"title\"><a id=\"TYPES\">Data Types</a></h2>\n", out);
+                  ch = get_nth_text(type, -1, NULL)[0];
+		  mxmlNewText(type, isalnum(ch & 255) || ch == '_', "*");
+		}
+		break;
 
-    while (scut)
-    {
-      name        = mxmlElementGetAttr(scut, "name");
-      description = mxmlFindElement(scut, scut, "description", NULL, NULL, MXML_DESCEND_FIRST);
-      fprintf(out, "<h3 class=\"typedef\"><a id=\"%s\">%s%s</a></h3>\n", name, get_comment_info(description), name);
+	    case ',' :
+		if (type && !enumeration)
+		{
+                  DEBUG_puts("Identifier: <<<< , >>>\n");
 
-      if (description)
-	write_description(out, mode, description, "p", 1);
+		  mxmlNewText(type, 0, ",");
+		}
+		break;
 
-      fputs("<p class=\"code\">\n"
-	    "typedef ", out);
+	    case '&' :
+		if (type)
+		{
+                  DEBUG_puts("Identifier: <<<< & >>>\n");
 
-      type = mxmlFindElement(scut, scut, "type", NULL, NULL, MXML_DESCEND_FIRST);
+		  mxmlNewText(type, 1, "&");
+		}
+		break;
 
-      for (type = mxmlGetFirstChild(type); type; type = mxmlGetNextSibling(type))
-      {
-        string = mxmlGetText(type, &whitespace);
+	    case '+' :
+		if (type)
+		{
+                  DEBUG_puts("Identifier: <<<< + >>>\n");
 
-        if (!strcmp(string, "("))
-        {
-	  break;
-	}
-	else
-	{
-	  if (whitespace)
-	    putc(' ', out);
+                  ch = get_nth_text(type, -1, NULL)[0];
+		  mxmlNewText(type, isalnum(ch & 255) || ch == '_', "+");
+		}
+		break;
 
-	  if (find_public(doc, doc, "class", string, mode) || find_public(doc, doc, "enumeration", string, mode) || find_public(doc, doc, "struct", string, mode) || find_public(doc, doc, "typedef", string, mode) || find_public(doc, doc, "union", string, mode))
-	  {
-            fputs("<a href=\"#", out);
-            write_string(out, string, OUTPUT_HTML, 0);
-	    fputs("\">", out);
-            write_string(out, string, OUTPUT_HTML, 0);
-	    fputs("</a>", out);
-	  }
-	  else
-            write_string(out, string, OUTPUT_HTML, 0);
-        }
-      }
+	    case '-' :
+		if (type)
+		{
+                  DEBUG_puts("Identifier: <<<< - >>>\n");
 
-      if (type)
-      {
-       /*
-        * Output function type...
-	*/
+                  ch = get_nth_text(type, -1, NULL)[0];
+		  mxmlNewText(type, isalnum(ch & 255) || ch == '_', "-");
+		}
+		break;
 
-        string = mxmlGetText(mxmlGetPrevSibling(type), NULL);
+	    case '=' :
+		if (type)
+		{
+                  DEBUG_puts("Identifier: <<<< = >>>\n");
 
-        if (string && *string != '*')
-	  putc(' ', out);
+                  ch = get_nth_text(type, -1, NULL)[0];
+		  mxmlNewText(type, isalnum(ch & 255) || ch == '_', "=");
+		}
+		break;
 
-        fprintf(out, "(*%s", name);
+            default :			/* Other */
+	        if (isalnum(ch & 255) || ch == '_' || ch == '.' || ch == ':' || ch == '~')
+		{
+		  state = STATE_IDENTIFIER;
 
-	for (type = mxmlGetNextSibling(mxmlGetNextSibling(type)); type; type = mxmlGetNextSibling(type))
-	{
-	  string = mxmlGetText(type, &whitespace);
+		  stringbuf_clear(&buffer);
+		  stringbuf_append(&buffer, ch);
+		}
+		break;
+          }
+          break;
 
-	  if (whitespace)
-	    putc(' ', out);
+      case STATE_PREPROCESSOR :		/* Preprocessor directive */
+          if (ch == '\n')
+	    state = STATE_NONE;
+	  else if (ch == '\\')
+	    filebuf_getc(file);
+          break;
 
-	  if (find_public(doc, doc, "class", string, mode) || find_public(doc, doc, "enumeration", string, mode) || find_public(doc, doc, "struct", string, mode) || find_public(doc, doc, "typedef", string, mode) || find_public(doc, doc, "union", string, mode))
+      case STATE_C_COMMENT :		/* Inside a C comment */
+          switch (ch)
 	  {
-            fputs("<a href=\"#", out);
-            write_string(out, string, OUTPUT_HTML, 0);
-	    fputs("\">", out);
-            write_string(out, string, OUTPUT_HTML, 0);
-	    fputs("</a>", out);
-	  }
-	  else
-            write_string(out, string, OUTPUT_HTML, 0);
-        }
+	    case '\n' :
+	        while ((ch = filebuf_getc(file)) != EOF)
+	        {
+		  if (ch == '*')
+		  {
+		    ch = filebuf_getc(file);
 
-        fputs(";\n", out);
-      }
-      else
-      {
-	type   = mxmlFindElement(scut, scut, "type", NULL, NULL, MXML_DESCEND_FIRST);
-	string = mxmlGetText(mxmlGetLastChild(type), NULL);
+		    if (ch == '/')
+		    {
+		      char *commstr = stringbuf_get(&buffer);
 
-        if (string && *string != '*')
-	  putc(' ', out);
+        	      if (mxmlGetFirstChild(child) != mxmlGetLastChild(comment))
+		      {
+			DEBUG_printf("    removing comment %p(%20.20s), last comment %p(%20.20s)...\n", mxmlGetFirstChild(comment), mxmlGetFirstChild(comment) ? get_nth_text(comment, 0, NULL) : "", mxmlGetLastChild(comment), mxmlGetLastChild(comment) ? get_nth_text(comment, -1, NULL) : "");
 
-	fprintf(out, "%s;\n", name);
-      }
+			mxmlAdd(file->garbage, MXML_ADD_AFTER, NULL, mxmlGetFirstChild(comment));
 
-      fputs("</p>\n", out);
+			DEBUG_printf("    new comment %p, last comment %p...\n", mxmlGetFirstChild(comment), mxmlGetLastChild(comment));
+		      }
 
-      scut = find_public(scut, doc, "typedef", NULL, mode);
-    }
-  }
+                      DEBUG_printf("    processing comment, variable=%p, constant=%p, typedefnode=%p, tree=\"%s\"\n", variable, constant, typedefnode, mxmlGetElement(tree));
 
- /*
-  * List of structures...
-  */
+		      if (variable)
+		      {
+		        if (strstr(commstr, "@private@"))
+			{
+			 /*
+			  * Delete private variables...
+			  */
 
-  if ((scut = find_public(doc, doc, "struct", NULL, mode)) != NULL)
-  {
-    fputs("<h2 class=\"title\"><a id=\"STRUCTURES\">Structures</a></h2>\n", out);
+			  mxmlAdd(file->garbage, MXML_ADD_AFTER, NULL, variable);
+			}
+			else
+			{
+			  description = mxmlNewElement(variable, "description");
 
-    while (scut)
-    {
-      write_scu(out, mode, doc, scut);
+			  DEBUG_printf("    adding comment %p/%p to variable...\n", mxmlGetLastChild(comment), mxmlGetFirstChild(comment));
 
-      scut = find_public(scut, doc, "struct", NULL, mode);
-    }
-  }
+			  mxmlNewOpaque(comment, commstr);
+			  update_comment(variable, mxmlNewOpaque(description, commstr));
+                        }
 
- /*
-  * List of unions...
-  */
+			variable = NULL;
+		      }
+		      else if (constant)
+		      {
+		        if (strstr(commstr, "@private@"))
+			{
+			 /*
+			  * Delete private constants...
+			  */
 
-  if ((scut = find_public(doc, doc, "union", NULL, mode)) != NULL)
-  {
-    fputs("<h2 class=\"title\"><a id=\"UNIONS\">Unions</a></h2>\n", out);
+			  mxmlAdd(file->garbage, MXML_ADD_AFTER, NULL, constant);
+			}
+			else
+			{
+			  description = mxmlNewElement(constant, "description");
 
-    while (scut)
-    {
-      write_scu(out, mode, doc, scut);
+			  DEBUG_printf("    adding comment %p/%p to constant...\n", mxmlGetLastChild(comment), mxmlGetFirstChild(comment));
 
-      scut = find_public(scut, doc, "union", NULL, mode);
-    }
-  }
+			  mxmlNewOpaque(comment, commstr);
+			  update_comment(constant, mxmlNewOpaque(description, commstr));
+			}
 
- /*
-  * Variables...
-  */
+			constant = NULL;
+		      }
+		      else if (typedefnode)
+		      {
+		        if (strstr(commstr, "@private@"))
+			{
+			 /*
+			  * Delete private typedefs...
+			  */
 
-  if ((arg = find_public(doc, doc, "variable", NULL, mode)) != NULL)
-  {
-    fputs("<h2 class=\"title\"><a id=\"VARIABLES\">Variables</a></h2>\n", out);
+			  mxmlAdd(file->garbage, MXML_ADD_AFTER, NULL, typedefnode);
 
-    while (arg)
-    {
-      name        = mxmlElementGetAttr(arg, "name");
-      description = mxmlFindElement(arg, arg, "description", NULL, NULL, MXML_DESCEND_FIRST);
-      fprintf(out, "<h3 class=\"variable\"><a id=\"%s\">%s%s</a></h3>\n", name, get_comment_info(description), name);
+			  if (structclass)
+			  {
+			    mxmlAdd(file->garbage, MXML_ADD_AFTER, NULL, structclass);
+			    structclass = NULL;
+			  }
 
-      if (description)
-	write_description(out, mode, description, "p", 1);
+			  if (enumeration)
+			  {
+			    mxmlAdd(file->garbage, MXML_ADD_AFTER, NULL, enumeration);
+			    enumeration = NULL;
+			  }
+			}
+			else
+			{
+			  description = mxmlNewElement(typedefnode, "description");
 
-      fputs("<p class=\"code\">", out);
+			  DEBUG_printf("    adding comment %p/%p to typedef %s...\n", mxmlGetLastChild(comment), mxmlGetFirstChild(comment), mxmlElementGetAttr(typedefnode, "name"));
 
-      write_element(out, doc, mxmlFindElement(arg, arg, "type", NULL, NULL, MXML_DESCEND_FIRST), OUTPUT_HTML);
-      fputs(mxmlElementGetAttr(arg, "name"), out);
-      if ((defval = mxmlElementGetAttr(arg, "default")) != NULL)
-	fprintf(out, " %s", defval);
-      fputs(";</p>\n", out);
+			  mxmlNewOpaque(comment, commstr);
+			  update_comment(typedefnode, mxmlNewOpaque(description, commstr));
 
-      arg = find_public(arg, doc, "variable", NULL, mode);
-    }
-  }
+			  if (structclass)
+			  {
+			    description = mxmlNewElement(structclass, "description");
+			    update_comment(structclass, mxmlNewOpaque(description, commstr));
+			  }
+			  else if (enumeration)
+			  {
+			    description = mxmlNewElement(enumeration, "description");
+			    update_comment(enumeration, mxmlNewOpaque(description, commstr));
+			  }
+			}
 
- /*
-  * List of enumerations...
-  */
+			typedefnode = NULL;
+		      }
+		      else if (strcmp(mxmlGetElement(tree), "codedoc") && !mxmlFindElement(tree, tree, "description", NULL, NULL, MXML_DESCEND_FIRST))
+                      {
+        		description = mxmlNewElement(tree, "description");
 
-  if ((scut = find_public(doc, doc, "enumeration", NULL, mode)) != NULL)
-  {
-    fputs("<h2 class=\"title\"><a id=\"ENUMERATIONS\">Constants</a></h2>\n", out);
+			DEBUG_printf("    adding comment %p/%p to parent...\n", mxmlGetLastChild(comment), mxmlGetFirstChild(comment));
 
-    while (scut)
-    {
-      name        = mxmlElementGetAttr(scut, "name");
-      description = mxmlFindElement(scut, scut, "description", NULL, NULL, MXML_DESCEND_FIRST);
-      fprintf(out, "<h3 class=\"enumeration\"><a id=\"%s\">%s%s</a></h3>\n", name, get_comment_info(description), name);
+        		mxmlNewOpaque(comment, commstr);
+			update_comment(tree, mxmlNewOpaque(description, commstr));
+		      }
+		      else if (!strncmp(commstr, "@body@", 6))
+		      {
+		       /*
+		        * Append comment as body text...
+		        */
 
-      if (description)
-	write_description(out, mode, description, "p", 1);
+		        add_body_text(file, body, commstr + 6);
+		      }
+		      else if (commline != endline)
+		      {
+		        DEBUG_printf("    before adding comment, child=%p, last_child=%p\n", mxmlGetFirstChild(comment), mxmlGetLastChild(comment));
 
-      fputs("<h4 class=\"constants\">Constants</h4>\n"
-            "<table class=\"list\"><tbody>\n", out);
+        		mxmlNewOpaque(comment, commstr);
 
-      for (arg = find_public(scut, scut, "constant", NULL, mode); arg; arg = find_public(arg, scut, "constant", NULL, mode))
-      {
-	description = mxmlFindElement(arg, arg, "description", NULL, NULL, MXML_DESCEND_FIRST);
-	fprintf(out, "<tr><th>%s %s</th>", mxmlElementGetAttr(arg, "name"), get_comment_info(description));
+		        DEBUG_printf("    after adding comment, child=%p, last_child=%p\n", mxmlGetFirstChild(comment), mxmlGetLastChild(comment));
+                      }
 
-	write_description(out, mode, description, "td", -1);
-        fputs("</tr>\n", out);
-      }
+		      DEBUG_printf("C comment: <<<< %s >>>\n", commstr);
 
-      fputs("</tbody></table>\n", out);
+		      state = STATE_NONE;
+		      break;
+		    }
+		    else
+		    {
+		      while (ch == '*')
+		        ch = filebuf_getc(file);
 
-      scut = find_public(scut, doc, "enumeration", NULL, mode);
-    }
-  }
-}
+		      if (ch != ' ')
+		        filebuf_ungetc(file, ch);
 
+		      ch = EOF;
+		      break;
+		    }
+		  }
+		  else if (ch == '\n' && stringbuf_length(&buffer) > 0)
+		    stringbuf_append(&buffer, ch);
+		  else if (!isspace(ch & 255))
+		    break;
+		}
 
-/*
- * 'write_html_head()' - Write the standard HTML header.
- */
+		if (ch != EOF)
+		  filebuf_ungetc(file, ch);
 
-static void
-write_html_head(FILE       *out,	/* I - Output file */
-                int        mode,	/* I - HTML or EPUB/XHTML */
-                const char *section,	/* I - Section */
-                const char *title,	/* I - Title */
-                const char *author,	/* I - Author's name */
-                const char *language,	/* I - Language */
-                const char *copyright,	/* I - Copyright string */
-                const char *docversion,	/* I - Document version string */
-		const char *cssfile)	/* I - Stylesheet */
-{
-  if (mode == OUTPUT_EPUB)
-    fprintf(out, "<?xml version=\"1.0\" encoding=\"utf-8\"?>\n"
-		 "<!DOCTYPE html>\n"
-		 "<html xmlns=\"http://www.w3.org/1999/xhtml\" xml:lang=\"%s\" "
-		 "lang=\"%s\">\n", language, language);
-  else
-    fprintf(out, "<!DOCTYPE html>\n"
-		 "<html lang=\"%s\">\n", language);
+                if (stringbuf_length(&buffer) > 0)
+		  stringbuf_append(&buffer, '\n');
+		break;
 
-  if (section)
-    fprintf(out, "<!-- SECTION: %s -->\n", section);
+	    case '/' :
+	        if (ch == '/' && stringbuf_getlast(&buffer) == '*')
+		{
+		  char *commstr = stringbuf_get(&buffer);
+		  char *commptr = commstr + strlen(commstr) - 1;
 
-  fputs("<head>\n"
-        "<title>", out);
-  write_string(out, title, mode, 0);
-  fputs("</title>\n", out);
+		  while (commptr > commstr && (commptr[-1] == '*' || isspace(commptr[-1] & 255)))
+		    commptr --;
 
-  if (mode == OUTPUT_EPUB)
-  {
-    if (section)
-      fprintf(out, "<meta name=\"keywords\" content=\"%s\" />\n", section);
+		  *commptr = '\0';
 
-    fputs("<meta name=\"generator\" content=\"codedoc v" VERSION "\" />\n"
-          "<meta name=\"author\" content=\"", out);
-    write_string(out, author, mode, 0);
-    fprintf(out, "\" />\n"
-		 "<meta name=\"language\" content=\"%s\" />\n"
-		 "<meta name=\"copyright\" content=\"", language);
-    write_string(out, copyright, mode, 0);
-    fputs("\" />\n"
-          "<meta name=\"version\" content=\"", out);
-    write_string(out, docversion, mode, 0);
-    fputs("\" />\n"
-          "<style type=\"text/css\"><![CDATA[\n", out);
-  }
-  else
-  {
-    if (section)
-      fprintf(out, "<meta name=\"keywords\" content=\"%s\">\n", section);
+        	  if (mxmlGetFirstChild(comment) != mxmlGetLastChild(comment))
+		  {
+		    DEBUG_printf("    removing comment %p(%20.20s), last comment %p(%20.20s)...\n", mxmlGetFirstChild(comment), mxmlGetFirstChild(comment) ? get_nth_text(comment, 0, NULL) : "", mxmlGetLastChild(comment), mxmlGetLastChild(comment) ? get_nth_text(comment, -1, NULL) : "");
 
-    fputs("<meta http-equiv=\"Content-Type\" content=\"text/html;charset=utf-8\">\n"
-          "<meta name=\"generator\" content=\"codedoc v" VERSION "\">\n"
-          "<meta name=\"author\" content=\"", out);
-    write_string(out, author, mode, 0);
-    fprintf(out, "\">\n"
-		 "<meta name=\"language\" content=\"%s\">\n"
-		 "<meta name=\"copyright\" content=\"", language);
-    write_string(out, copyright, mode, 0);
-    fputs("\">\n"
-          "<meta name=\"version\" content=\"", out);
-    write_string(out, docversion, mode, 0);
-    fputs("\">\n"
-          "<style type=\"text/css\"><!--\n", out);
-  }
+		    mxmlAdd(file->garbage, MXML_ADD_AFTER, NULL, mxmlGetFirstChild(comment));
 
-  if (cssfile)
-  {
-   /*
-    * Use custom stylesheet file...
-    */
+		    DEBUG_printf("    new comment %p, last comment %p...\n", mxmlGetFirstChild(comment), mxmlGetLastChild(comment));
+		  }
 
-    write_file(out, cssfile, mode);
-  }
-  else
-  {
-   /*
-    * Use standard stylesheet...
-    */
+                  DEBUG_printf("    processing comment, variable=%p, constant=%p, typedefnode=%p, tree=\"%s\"\n", variable, constant, typedefnode, mxmlGetElement(tree));
 
-    fputs("body {\n"
-          "  background: white;\n"
-          "  color: black;\n"
-          "  font-family: sans-serif;\n"
-          "  font-size: 12pt;\n"
-          "}\n"
-          "a {\n"
-          "  color: black;\n"
-          "}\n"
-          "a:link, a:visited {\n"
-          "  color: #00f;\n"
-          "}\n"
-          "a:link:hover, a:visited:hover, a:active {\n"
-          "  color: #c0c;\n"
-          "}\n"
-          "body, p, h1, h2, h3, h4, h5, h6 {\n"
-	  "  font-family: sans-serif;\n"
-	  "  line-height: 1.4;\n"
-	  "}\n"
-	  "h1, h2, h3, h4, h5, h6 {\n"
-	  "  font-weight: bold;\n"
-	  "  page-break-inside: avoid;\n"
-	  "}\n"
-	  "h1 {\n"
-	  "  font-size: 250%;\n"
-	  "  margin: 0;\n"
-	  "}\n"
-	  "h2 {\n"
-	  "  font-size: 250%;\n"
-	  "  margin-top: 1.5em;\n"
-	  "}\n"
-	  "h3 {\n"
-	  "  font-size: 200%;\n"
-	  "  margin-bottom: 0.5em;\n"
-	  "  margin-top: 1.5em;\n"
-	  "}\n"
-	  "h4 {\n"
-	  "  font-size: 150%;\n"
-	  "  margin-bottom: 0.5em;\n"
-	  "  margin-top: 1.5em;\n"
-	  "}\n"
-	  "h5 {\n"
-	  "  font-size: 125%;\n"
-	  "  margin-bottom: 0.5em;\n"
-	  "  margin-top: 1.5em;\n"
-	  "}\n"
-	  "h6 {\n"
-	  "  font-size: 110%;\n"
-	  "  margin-bottom: 0.5em;\n"
-	  "  margin-top: 1.5em;\n"
-	  "}\n"
-	  "img.title {\n"
-	  "  width: 256px;\n"
-	  "}\n"
-	  "div.header h1, div.header p {\n"
-	  "  text-align: center;\n"
-	  "}\n"
-	  "div.contents, div.body, div.footer {\n"
-	  "  page-break-before: always;\n"
-	  "}\n"
-	  ".class, .enumeration, .function, .struct, .typedef, .union {\n"
-	  "  border-bottom: solid 2px gray;\n"
-	  "}\n"
-	  ".description {\n"
-	  "  margin-top: 0.5em;\n"
-	  "}\n"
-	  ".function {\n"
-	  "  margin-bottom: 0;\n"
-	  "}\n"
-	  "blockquote {\n"
-	  "  border: solid thin gray;\n"
-	  "  box-shadow: 3px 3px 5px rgba(127,127,127,0.25);\n"
-	  "  margin: 1em 0;\n"
-	  "  padding: 10px;\n"
-	  "  page-break-inside: avoid;\n"
-          "}\n"
-          "blockquote :first-child {\n"
-          "  margin-top: 0;\n"
-          "}\n"
-          "blockquote :first-child {\n"
-          "  margin-bottom: 0;\n"
-          "}\n"
-	  "p code, li code, p.code, pre, ul.code li {\n"
-	  "  font-family: monospace;\n"
-	  "  hyphens: manual;\n"
-	  "  -webkit-hyphens: manual;\n"
-	  "}\n"
-	  "p.code, pre, ul.code li {\n"
-          "  background: rgba(127,127,127,0.25);\n"
-          "  border: thin dotted gray;\n"
-          "  padding: 10px;\n"
-	  "  page-break-inside: avoid;\n"
-	  "}\n"
-	  "pre {\n"
-	  "  white-space: pre-wrap;\n"
-	  "}\n"
-	  "a:link, a:visited {\n"
-	  "  text-decoration: none;\n"
-	  "}\n"
-	  "span.info {\n"
-	  "  background: black;\n"
-	  "  border: solid thin black;\n"
-	  "  color: white;\n"
-	  "  font-size: 80%;\n"
-	  "  font-style: italic;\n"
-	  "  font-weight: bold;\n"
-	  "  white-space: nowrap;\n"
-	  "}\n"
-	  "h1 span.info, h2 span.info, h3 span.info, h4 span.info {\n"
-	  "  border-top-left-radius: 10px;\n"
-	  "  border-top-right-radius: 10px;\n"
-	  "  float: right;\n"
-	  "  padding: 3px 6px;\n"
-	  "}\n"
-	  "ul.code, ul.contents, ul.subcontents {\n"
-	  "  list-style-type: none;\n"
-	  "  margin: 0;\n"
-	  "  padding-left: 0;\n"
-	  "}\n"
-	  "ul.code li {\n"
-	  "  margin: 0;\n"
-	  "}\n"
-	  "ul.contents > li {\n"
-	  "  margin-top: 1em;\n"
-	  "}\n"
+		  if (variable)
+		  {
+		    if (strstr(commstr, "@private@"))
+		    {
+		     /*
+		      * Delete private variables...
+		      */
+
+		      mxmlAdd(file->garbage, MXML_ADD_AFTER, NULL, variable);
+		    }
+		    else
+		    {
+		      description = mxmlNewElement(variable, "description");
+
+		      DEBUG_printf("    adding comment %p/%p to variable...\n", mxmlGetLastChild(comment), mxmlGetFirstChild(comment));
+
+		      mxmlNewOpaque(comment, commstr);
+		      update_comment(variable, mxmlNewOpaque(description, commstr));
+                    }
+
+		    variable = NULL;
+		  }
+		  else if (constant)
+		  {
+		    if (strstr(commstr, "@private@"))
+		    {
+		     /*
+		      * Delete private constants...
+		      */
+
+		      mxmlAdd(file->garbage, MXML_ADD_AFTER, NULL, constant);
+		    }
+		    else
+		    {
+		      description = mxmlNewElement(constant, "description");
+
+		      DEBUG_printf("    adding comment %p/%p to constant...\n", mxmlGetLastChild(comment), mxmlGetFirstChild(comment));
+
+		      mxmlNewOpaque(comment, commstr);
+		      update_comment(constant, mxmlNewOpaque(description, commstr));
+		    }
+
+		    constant = NULL;
+		  }
+		  else if (typedefnode)
+		  {
+		    if (strstr(commstr, "@private@"))
+		    {
+		     /*
+		      * Delete private typedefs...
+		      */
+
+		      mxmlAdd(file->garbage, MXML_ADD_AFTER, NULL, typedefnode);
+
+		      if (structclass)
+		      {
+			mxmlAdd(file->garbage, MXML_ADD_AFTER, NULL, structclass);
+			structclass = NULL;
+		      }
+
+		      if (enumeration)
+		      {
+			mxmlAdd(file->garbage, MXML_ADD_AFTER, NULL, enumeration);
+			enumeration = NULL;
+		      }
+		    }
+		    else
+		    {
+		      description = mxmlNewElement(typedefnode, "description");
+
+		      DEBUG_printf("    adding comment %p/%p to typedef %s...\n", mxmlGetLastChild(comment), mxmlGetFirstChild(comment), mxmlElementGetAttr(typedefnode, "name"));
+
+		      mxmlNewOpaque(comment, commstr);
+		      update_comment(typedefnode, mxmlNewOpaque(description, commstr));
+
+		      if (structclass)
+		      {
+			description = mxmlNewElement(structclass, "description");
+			update_comment(structclass, mxmlNewOpaque(description, commstr));
+		      }
+		      else if (enumeration)
+		      {
+			description = mxmlNewElement(enumeration, "description");
+			update_comment(enumeration, mxmlNewOpaque(description, commstr));
+		      }
+		    }
+
+		    typedefnode = NULL;
+		  }
+		  else if (strcmp(mxmlGetElement(tree), "codedoc") && !mxmlFindElement(tree, tree, "description", NULL, NULL, MXML_DESCEND_FIRST))
+                  {
+        	    description = mxmlNewElement(tree, "description");
+
+		    DEBUG_printf("    adding comment %p/%p to parent...\n", mxmlGetLastChild(comment), mxmlGetFirstChild(comment));
+
+		    mxmlNewOpaque(comment, commstr);
+		    update_comment(tree, mxmlNewOpaque(description, commstr));
+		  }
+		  else if (commline != endline)
+        	    mxmlNewOpaque(comment, commstr);
+
+		  DEBUG_printf("C comment: <<<< %s >>>\n", commstr);
+
+		  state = STATE_NONE;
+		  break;
+		}
+
+	    default :
+	        if (ch == ' ' && stringbuf_length(&buffer) == 0)
+		  break;
+
+		stringbuf_append(&buffer, ch);
+		break;
+          }
+          break;
+
+      case STATE_CXX_COMMENT :		/* Inside a C++ comment */
+          if (ch == '\n')
+	  {
+	   /*
+	    * Continue with a C++ comment on the next line, unless this comment
+	    * trails a top-level declaration...
+	    */
+
+	    if (commline != endline && (ch = filebuf_getc(file)) == '/')
+	    {
+	      if ((ch = filebuf_getc(file)) == '/')
+	      {
+		stringbuf_append(&buffer, '\n');
+
+                if ((ch = filebuf_getc(file)) != ' ')
+                  filebuf_ungetc(file, ch);
+		break;
+	      }
+	      else
+	      {
+		filebuf_ungetc(file, ('/' << 8) | ch);
+	      }
+	    }
+	    else if (commline != endline)
+	      filebuf_ungetc(file, ch);
+
+	    char *commstr = stringbuf_get(&buffer);
+
+	    state = STATE_NONE;
+
+            if (mxmlGetFirstChild(comment) != mxmlGetLastChild(comment))
+	    {
+	      DEBUG_printf("    removing comment %p(%20.20s), last comment %p(%20.20s)...\n", mxmlGetFirstChild(comment), mxmlGetFirstChild(comment) ? get_nth_text(comment, 0, NULL) : "", mxmlGetLastChild(comment), mxmlGetLastChild(comment) ? get_nth_text(comment, -1, NULL) : "");
+
+	      mxmlAdd(file->garbage, MXML_ADD_AFTER, NULL, mxmlGetFirstChild(comment));
+
+	      DEBUG_printf("    new comment %p, last comment %p...\n", mxmlGetFirstChild(comment), mxmlGetLastChild(comment));
+	    }
+
+	    if (variable)
+	    {
+	      if (strstr(commstr, "@private@"))
+	      {
+	       /*
+		* Delete private variables...
+		*/
+
+		mxmlAdd(file->garbage, MXML_ADD_AFTER, NULL, variable);
+	      }
+	      else
+	      {
+		description = mxmlNewElement(variable, "description");
+
+		DEBUG_printf("    adding comment %p/%p to variable...\n", mxmlGetLastChild(comment), mxmlGetFirstChild(comment));
+
+		mxmlNewOpaque(comment, commstr);
+		update_comment(variable, mxmlNewOpaque(description, commstr));
+              }
+
+	      variable = NULL;
+	    }
+	    else if (constant)
+	    {
+	      if (strstr(commstr, "@private@"))
+	      {
+	       /*
+		* Delete private constants...
+		*/
+
+		mxmlAdd(file->garbage, MXML_ADD_AFTER, NULL, constant);
+	      }
+	      else
+	      {
+		description = mxmlNewElement(constant, "description");
+
+		DEBUG_printf("    adding comment %p/%p to constant...\n", mxmlGetLastChild(comment), mxmlGetFirstChild(comment));
+
+		mxmlNewOpaque(comment, commstr);
+		update_comment(constant, mxmlNewOpaque(description, commstr));
+              }
+
+	      constant = NULL;
+	    }
+	    else if (typedefnode)
+	    {
+	      if (strstr(commstr, "@private@"))
+	      {
+	       /*
+		* Delete private typedefs...
+		*/
+
+		mxmlAdd(file->garbage, MXML_ADD_AFTER, NULL, typedefnode);
+
+		if (structclass)
+		{
+		  mxmlAdd(file->garbage, MXML_ADD_AFTER, NULL, structclass);
+		  structclass = NULL;
+		}
+
+		if (enumeration)
+		{
+		  mxmlAdd(file->garbage, MXML_ADD_AFTER, NULL, enumeration);
+		  enumeration = NULL;
+		}
+	      }
+	      else
+	      {
+		description = mxmlNewElement(typedefnode, "description");
+
+		DEBUG_printf("    adding comment %p/%p to typedef %s...\n", mxmlGetLastChild(comment), mxmlGetFirstChild(comment), mxmlElementGetAttr(typedefnode, "name"));
+
+		mxmlNewOpaque(comment, commstr);
+		update_comment(typedefnode, mxmlNewOpaque(description, commstr));
+
+		if (structclass)
+		{
+		  description = mxmlNewElement(structclass, "description");
+		  update_comment(structclass, mxmlNewOpaque(description, commstr));
+		}
+		else if (enumeration)
+		{
+		  description = mxmlNewElement(enumeration, "description");
+		  update_comment(enumeration, mxmlNewOpaque(description, commstr));
+		}
+              }
+
+	      typedefnode = NULL;
+	    }
+	    else if (strcmp(mxmlGetElement(tree), "codedoc") && !mxmlFindElement(tree, tree, "description", NULL, NULL, MXML_DESCEND_FIRST))
+            {
+              description = mxmlNewElement(tree, "description");
+
+	      DEBUG_printf("    adding comment %p/%p to parent...\n", mxmlGetLastChild(comment), mxmlGetFirstChild(comment));
+
+	      mxmlNewOpaque(comment, commstr);
+	      update_comment(tree, mxmlNewOpaque(description, commstr));
+	    }
+	    else if (!strncmp(commstr, "@body@", 6))
+	    {
+	     /*
+	      * Append comment as body text...
+	      */
+
+	      add_body_text(file, body, commstr + 6);
+	    }
+	    else if (commline != endline)
+              mxmlNewOpaque(comment, commstr);
+
+	    DEBUG_printf("C++ comment: <<<< %s >>>\n", commstr);
+	  }
+	  else
+	    stringbuf_append(&buffer, ch);
+          break;
+
+      case STATE_STRING :		/* Inside a string constant */
+	  stringbuf_append(&buffer, ch);
+
+          if (ch == '\\')
+	    stringbuf_append(&buffer, filebuf_getc(file));
+	  else if (ch == '\"')
+	  {
+	    if (type)
+	      mxmlNewText(type, mxmlGetFirstChild(type) != NULL, stringbuf_get(&buffer));
+
+	    state = STATE_NONE;
+	  }
+          break;
+
+      case STATE_CHARACTER :		/* Inside a character constant */
+	  stringbuf_append(&buffer, ch);
+
+          if (ch == '\\')
+	    stringbuf_append(&buffer, filebuf_getc(file));
+	  else if (ch == '\'')
+	  {
+	    if (type)
+	      mxmlNewText(type, mxmlGetFirstChild(type) != NULL, stringbuf_get(&buffer));
+
+	    state = STATE_NONE;
+	  }
+          break;
+
+      case STATE_IDENTIFIER :		/* Inside a keyword or identifier */
+	  if (isalnum(ch & 255) || ch == '_' || ch == '[' || ch == ']' || (ch == ',' && (parens > 1 || (type && !enumeration && !function))) || (ch == ',' && parens > 0 && typedefnode) || ch == ':' || ch == '.' || ch == '~')
+	  {
+	    stringbuf_append(&buffer, ch);
+	  }
+	  else
+	  {
+	    char *ptr, *str = stringbuf_get(&buffer);
+
+	    filebuf_ungetc(file, ch);
+
+	    state = STATE_NONE;
+
+            DEBUG_printf("    braces=%d, type=%p, type->child=%p, buffer=\"%s\"\n", braces, type, type ? mxmlGetFirstChild(type) : NULL, str);
+
+            if (!braces)
+	    {
+	      if (!strcmp(str, "namespace"))
+	      {
+	        nskeyword = 1;
+	        break;
+	      }
+	      else if (nskeyword)
+	      {
+	        strlcpy(nsnamestr, str, sizeof(nsnamestr));
+	        break;
+	      }
+
+	      if (!type || !mxmlGetFirstChild(type))
+	      {
+		if (!strcmp(mxmlGetElement(tree), "class"))
+		{
+		  if (!strcmp(str, "public") || !strcmp(str, "public:"))
+		  {
+		    scope = "public";
+
+		    DEBUG_puts("    scope = public\n");
+		    break;
+		  }
+		  else if (!strcmp(str, "private") || !strcmp(str, "private:"))
+		  {
+		    scope = "private";
+
+		    DEBUG_puts("    scope = private\n");
+		    break;
+		  }
+		  else if (!strcmp(str, "protected") || !strcmp(str, "protected:"))
+		  {
+		    scope = "protected";
+
+		    DEBUG_puts("    scope = protected\n");
+		    break;
+		  }
+		}
+	      }
+
+	      if (!type)
+                type = mxmlNewElement(/*parent*/NULL, "type");
+
+              DEBUG_printf("    function=%p (%s), type->child=%p, ch='%c', parens=%d\n", function, function ? mxmlElementGetAttr(function, "name") : "null", mxmlGetFirstChild(type), ch, parens);
+
+              if (!function && ch == '(')
+	      {
+	        if (mxmlGetFirstChild(type) && !strcmp(mxmlGetText(mxmlGetFirstChild(type), NULL), "extern"))
+		{
+		 /*
+		  * Remove external declarations...
+		  */
+
+		  mxmlAdd(file->garbage, MXML_ADD_AFTER, NULL, type);
+		  type = NULL;
+		  break;
+		}
+
+	        function = mxmlNewElement(/*parent*/NULL, "function");
+		if ((ptr = strchr(str, ':')) != NULL && ptr[1] == ':')
+		{
+		  char *name = str;	/* Struct/class name */
+
+		  *ptr = '\0';
+		  ptr += 2;
+
+                  if (nsname)
+                  {
+                    size_t namelen = strlen(nsname) + strlen(str) + 3;
+					/* Length of name */
+
+                    if ((name = malloc(namelen)) == NULL)
+                    {
+                      fputs("codedoc: Unable to allocate memory for class name.\n", stderr);
+                      exit(1);
+                    }
+
+                    snprintf(name, namelen, "%s::%s", nsname, str);
+                  }
+
+                  DEBUG_printf("looking for struct or class '%s' under %p(%s)...\n", name, tree, mxmlGetElement(tree));
+		  if ((fstructclass = mxmlFindElement(tree, tree, "class", "name", name, MXML_DESCEND_FIRST)) == NULL)
+		  {
+		   /*
+		    * A class declared before the scanned text would take
+		    * precedence over any struct found here...
+		    */
+
+		    file->order_dependent = true;
+		    fstructclass          = mxmlFindElement(tree, tree, "struct", "name", name, MXML_DESCEND_FIRST);
+		  }
+                  DEBUG_printf("fstructclass=%p\n", fstructclass);
+
+                  if (name != str)
+                    free(name);
+		}
+		else
+		  ptr = str;
+
+                if (nsname && !fstructclass && !tree_is_scu)
+                  mxmlElementSetAttrf(function, "name", "%s::%s", nsname, ptr);
+                else
+		  mxmlElementSetAttr(function, "name", ptr);
+
+		if (scope)
+		  mxmlElementSetAttr(function, "scope", scope);
+
+                DEBUG_printf("function: %s\n", mxmlElementGetAttr(function, "name"));
+		DEBUG_printf("    scope = %s\n", scope ? scope : "(null)");
+		DEBUG_printf("    comment = %p\n", comment);
+		DEBUG_printf("    child = (%p) %s\n", mxmlGetFirstChild(comment), get_nth_text(comment, 0, NULL));
+		DEBUG_printf("    last_child = (%p) %s\n", mxmlGetLastChild(comment), get_nth_text(comment, -1, NULL));
+
+                if (mxmlGetLastChild(type) && (strcmp(get_nth_text(type, -1, NULL), "void") || !strcmp(get_nth_text(type, 0, NULL), "static")))
+		{
+                  returnvalue = mxmlNewElement(function, "returnvalue");
+
+		  mxmlAdd(returnvalue, MXML_ADD_AFTER, /*parent*/NULL, type);
+
+		  description = mxmlNewElement(returnvalue, "description");
+
+		  DEBUG_printf("    adding comment %p/%p to returnvalue...\n", mxmlGetLastChild(comment), mxmlGetFirstChild(comment));
+
+		  update_comment(returnvalue, mxmlGetLastChild(comment));
+		  mxmlAdd(description, MXML_ADD_AFTER, /*parent*/NULL, mxmlGetLastChild(comment));
+                }
+		else
+		  mxmlAdd(file->garbage, MXML_ADD_AFTER, NULL, type);
+
+		description = mxmlNewElement(function, "description");
+
+		DEBUG_printf("    adding comment %p/%p to function...\n", mxmlGetLastChild(comment), mxmlGetFirstChild(comment));
+
+		update_comment(function, mxmlGetLastChild(comment));
+		mxmlAdd(description, MXML_ADD_AFTER, /*parent*/NULL, mxmlGetLastChild(comment));
+
+		type = NULL;
+	      }
+	      else if (function && ((ch == ')' && parens == 1) || ch == ','))
+	      {
+	       /*
+	        * Argument definition...
+		*/
+
+                if (strcmp(str, "void"))
+		{
+		  const char *last_string = get_nth_text(type, -1, NULL);
+
+	          mxmlNewText(type, mxmlGetFirstChild(type) != NULL && *last_string != '(' && *last_string != '*', str);
+
+                  DEBUG_printf("Argument: <<<< %s >>>\n", str);
+
+	          variable = add_variable(file, function, "argument", type);
+		}
+		else
+		  mxmlAdd(file->garbage, MXML_ADD_AFTER, NULL, type);
+
+		type = NULL;
+	      }
+              else if (mxmlGetFirstChild(type) && !function && parens == 0 && (ch == ';' || ch == ','))
+	      {
+	        DEBUG_printf("    got %s, typedefnode=%p, structclass=%p\n", ch == ';' ? "semicolon" : "comma", typedefnode, structclass);
+#if DEBUG > 1
+		mxml_node_t *debugnode;
+		for (debugnode = mxmlGetFirstChild(type); debugnode; debugnode = mxmlGetNextSibling(debugnode))
+		  DEBUG_printf("    type child=%p (%s)\n", debugnode, mxmlGetText(debugnode, NULL));
+#endif // DEBUG > 1
+
+	        if (typedefnode || structclass)
+	        {
+                  DEBUG_printf("Typedef/struct/class: <<<< %s >>>>\n", str);
+
+	          if (*str != '_')
+		  {
+		    if (typedefnode)
+		    {
+		      if (nsname)
+			mxmlElementSetAttrf(typedefnode, "name", "%s::%s", nsname, str);
+		      else
+			mxmlElementSetAttr(typedefnode, "name", str);
+
+		      sort_node(file, tree, typedefnode);
+		    }
+
+		    if (structclass && !mxmlElementGetAttr(structclass, "name"))
+		    {
+		      DEBUG_printf("setting struct/class name to \"%s\".\n", get_nth_text(type, -1, NULL));
+		      if (nsname)
+			mxmlElementSetAttrf(structclass, "name", "%s::%s", nsname, str);
+		      else
+			mxmlElementSetAttr(structclass, "name", str);
+
+		      sort_node(file, tree, structclass);
+		      structclass = NULL;
+		    }
+
+		    if (typedefnode)
+		      mxmlAdd(typedefnode, MXML_ADD_BEFORE, /*parent*/NULL, type);
+		    else
+		      mxmlAdd(file->garbage, MXML_ADD_AFTER, NULL, type);
+		  }
+
+		  type        = NULL;
+		  typedefnode = NULL;
+		}
+		else if (mxmlGetFirstChild(type) && !strcmp(mxmlGetText(mxmlGetFirstChild(type), NULL), "typedef"))
+		{
+		 /*
+		  * Simple typedef...
+		  */
+
+                  DEBUG_printf("Simple typedef: <<<< %s >>>\n", str);
+
+		  typedefnode = mxmlNewElement(/*parent*/NULL, "typedef");
+		  if (nsname)
+		    mxmlElementSetAttrf(typedefnode, "name", "%s::%s", nsname, str);
+		  else
+		    mxmlElementSetAttr(typedefnode, "name", str);
+		  mxmlAdd(file->garbage, MXML_ADD_AFTER, NULL, mxmlGetFirstChild(type));
+
+		  sort_node(file, tree, typedefnode);
+
+		  if (mxmlGetFirstChild(type))
+		    clear_whitespace(mxmlGetFirstChild(type));
+
+		  mxmlAdd(typedefnode, MXML_ADD_AFTER, /*parent*/NULL, type);
+		  type = NULL;
+		  DEBUG_printf("    New typedefnode=%p\n", typedefnode);
+		}
+		else if (!parens)
+		{
+		 /*
+	          * Variable definition...
+		  */
+
+                  mxml_node_t *child = mxmlGetFirstChild(type);
+                  const char *string = get_nth_text(type, -1, NULL);
+
+	          if (child && !strcmp(mxmlGetText(child, NULL), "static") && !strcmp(mxmlGetElement(tree), "codedoc"))
+		  {
+		   /*
+		    * Remove static functions...
+		    */
+
+		    mxmlAdd(file->garbage, MXML_ADD_AFTER, NULL, type);
+		    type = NULL;
+		    break;
+		  }
+
+		  if (nsname && !fstructclass && !tree_is_scu)
+		    mxmlNewTextf(type, child != NULL && *string != '(' && *string != '*', "%s::%s", nsname, str);
+		  else
+		    mxmlNewText(type, child != NULL && *string != '(' && *string != '*', str);
+
+                  DEBUG_printf("Variable: <<<< %s >>>>\n", str);
+                  DEBUG_printf("    scope = %s\n", scope ? scope : "(null)");
+
+	          variable = add_variable(file, /*parent*/NULL, "variable", type);
+		  type     = NULL;
+
+		  sort_node(file, tree, variable);
+
+		  if (scope)
+		    mxmlElementSetAttr(variable, "scope", scope);
+		}
+              }
+	      else
+              {
+		mxml_node_t *child = mxmlGetFirstChild(type);
+		const char *string = get_nth_text(type, -1, NULL);
+
+                DEBUG_printf("Identifier: <<<< %s >>>>\n", str);
+
+	        mxmlNewText(type, child != NULL && *string != '(' && *string != '*', str);
+	      }
+	    }
+	    else if (enumeration && !isdigit(str[0] & 255))
+	    {
+	      DEBUG_printf("Constant: <<<< %s >>>\n", str);
+
+	      constant = mxmlNewElement(/*parent*/NULL, "constant");
+	      if (nsname)
+	        mxmlElementSetAttrf(constant, "name", "%s::%s", nsname, str);
+	      else
+	        mxmlElementSetAttr(constant, "name", str);
+	      sort_node(file, enumeration, constant);
+	    }
+	    else if (type)
+	    {
+	      mxmlAdd(file->garbage, MXML_ADD_AFTER, NULL, type);
+	      type = NULL;
+	    }
+	  }
+          break;
+    }
+
+#if DEBUG > 1
+    if (state != oldstate)
+    {
+      DEBUG_printf("    changed states from %s to %s on receipt of character '%c'...\n", states[oldstate], states[state], oldch);
+      DEBUG_printf("    variable = %p\n", variable);
+      DEBUG_printf("    typedefnode = %p\n", typedefnode);
+      if (type)
+      {
+        DEBUG_puts("    type =");
+        for (temp = mxmlGetFirstChild(type); temp; temp = mxmlGetNextSibling(temp))
+	  DEBUG_printf(" \"%s\"", mxmlGetText(temp, NULL));
+	DEBUG_puts("\n");
+      }
+    }
+#endif /* DEBUG > 1 */
+  }
+
+ /*
+  * Note whether a declaration was still in progress at the end of the file...
+  */
+
+  file->complete = !(state != STATE_NONE || braces || parens || nskeyword || scope || mxmlGetFirstChild(comment) || constant || enumeration || function || fstructclass || structclass || typedefnode || variable || returnvalue || type);
+
+  mxmlAdd(file->garbage, MXML_ADD_AFTER, NULL, comment);
+  free(scopes);
+
+ /*
+  * All done, return with no errors...
+  */
+
+  return (1);
+}
+
+
+/*
+ * 'scan_graft()' - Use speculatively scanned chunks that the serial scan has
+ *                  reached.
+ *
+ * The declarations and @body@ text from a chunk are used in place of scanning
+ * it again when the serial scan reaches the start of the chunk with nothing
+ * pending, in the same namespace, and the chunk scan was usable.  Otherwise the
+ * serial scan simply continues through the chunk.
+ */
+
+static void
+scan_graft(filebuf_t   *file,		/* I  - File buffer */
+           mxml_node_t *tree,		/* I  - Declaration tree */
+           const char  *nsname,		/* I  - Namespace name */
+           mmd_t       **body,		/* IO - Body markdown text */
+           bool        pending)		/* I  - Is a declaration pending? */
+{
+  scan_split_t	*split = file->split;	/* Speculatively scanned chunks */
+  scan_chunk_t	*chunk;			/* Current chunk */
+  mxml_node_t	*node,			/* Current declaration */
+		*next;			/* Next declaration */
+  size_t	i;			/* Looping var */
+  bool		graft;			/* Use the chunk? */
+
+
+  while (split->current < split->num_chunks && split->chunks[split->current].start <= file->bufptr)
+  {
+    chunk = split->chunks + split->current;
+    split->current ++;
+
+    graft = !pending && chunk->start == file->bufptr && !file->ch && !strcmp(mxmlGetElement(tree), "codedoc") && (nsname && chunk->nsname ? !strcmp(nsname, chunk->nsname) : nsname == chunk->nsname);
+
+#ifdef HAVE_PTHREAD_H
+    pthread_mutex_lock(&split->mutex);
+
+    if (chunk->status == SCAN_QUEUED)
+    {
+     /*
+      * No thread has started on this chunk, so scan it here...
+      */
+
+      chunk->status = SCAN_SKIPPED;
+      graft         = false;
+    }
+    else if (graft)
+    {
+      while (chunk->status == SCAN_RUNNING)
+        pthread_cond_wait(&split->cond, &split->mutex);
+
+      graft = chunk->valid;
+    }
+
+    pthread_mutex_unlock(&split->mutex);
+#else
+    graft = false;
+#endif /* HAVE_PTHREAD_H */
+
+    if (!graft)
+      continue;
+
+    CODEDOC_PROBE2(scan__graft, file->filename, chunk->line);
+
+    split->num_grafted ++;
+
+   /*
+    * Add the chunk's declarations and @body@ text in the order they were
+    * scanned, then skip to the end of the chunk...
+    */
+
+    for (node = mxmlGetFirstChild(chunk->tree); node; node = next)
+    {
+      next = mxmlGetNextSibling(node);
+      sort_node(file, tree, node);
+    }
+
+    for (i = 0; i < chunk->file.num_bodytext; i ++)
+      add_body_text(file, body, chunk->file.bodytext[i]);
+
+    file->bufptr = chunk->end;
+    file->line   = chunk->file.line;
+    file->column = chunk->file.column;
+  }
+
+  if (split->current < split->num_chunks)
+    split->next = split->chunks[split->current].start;
+  else
+    file->split = NULL;
+}
+
+
+/*
+ * 'scan_source()' - Scan a source file, speculatively scanning large files in
+ *                   parallel.
+ */
+
+static int				/* O  - 1 on success, 0 on error */
+scan_source(filebuf_t   *file,		/* I  - File to scan */
+            mxml_node_t *tree,		/* I  - Function tree */
+            mmd_t       **body)		/* IO - Body markdown text */
+{
+  scan_split_t	*split;			/* Speculatively scanned chunks */
+  int		ret;			/* Return value */
+
+
+  split       = scan_split_start(file);
+  file->split = split;
+
+  ret = scan_file(file, tree, /*nsname*/NULL, body);
+
+  file->split = NULL;
+  scan_split_stop(split);
+
+  return (ret);
+}
+
+
+/*
+ * 'scan_split_start()' - Split a large source file into chunks and start
+ *                        scanning them in parallel.
+ *
+ * A quick pass over the file mimics the scanner's handling of comments,
+ * strings, character constants, and preprocessor lines to find line
+ * boundaries between top-level declarations, including those inside
+ * namespaces and 'extern "C"' blocks.  Chunks are roughly `SCAN_CHUNK_SIZE`
+ * bytes.  `NULL` is returned if the file is too small, contains characters
+ * the scanner would reject, or only one job is allowed.
+ */
+
+static scan_split_t *			/* O - Speculatively scanned chunks or `NULL` */
+scan_split_start(filebuf_t *file)	/* I - File to scan */
+{
+#ifdef HAVE_PTHREAD_H
+  scan_split_t	*split;			/* Speculatively scanned chunks */
+  scan_chunk_t	*chunk;			/* Current chunk */
+  const char	*ptr,			/* Pointer into file */
+		*start,			/* Start of current chunk */
+		*word;			/* Start of current word */
+  int		ch,			/* Current character */
+		count,			/* Number of UTF-8 continuation bytes */
+		line,			/* Current line */
+		endline = 0,		/* Line where the last top-level declaration ended */
+		state = STATE_NONE,	/* Current lexical state */
+		parens = 0,		/* Parenthesis nesting */
+		opaque = 0,		/* Brace nesting inside declarations */
+		depth = 0;		/* Namespace/extern nesting */
+  bool		pending = false,	/* Declaration in progress? */
+		nskeyword = false,	/* Namespace keyword seen? */
+		externkw = false;	/* Extern keyword seen? */
+  const char	*nsname = NULL,		/* Pending namespace name */
+		*nsnames[SCAN_MAX_NAMESPACES + 1];
+					/* Namespace names */
+  size_t	nslen = 0,		/* Length of pending namespace name */
+		nslens[SCAN_MAX_NAMESPACES + 1];
+					/* Lengths of namespace names */
+
+
+  if (jobsGetMax() < 2 || (file->bufend - file->bufptr) < (2 * SCAN_CHUNK_SIZE))
+    return (NULL);
+
+ /*
+  * Make sure the scanner will accept every character, since a scanning thread
+  * must not report an error the serial scan might not reach...
+  */
+
+  for (ptr = file->bufptr; ptr < file->bufend;)
+  {
+    ch = *ptr++ & 255;
+
+    if (ch & 0x80)
+    {
+      if ((ch & 0xe0) == 0xc0)
+      {
+        ch    &= 0x1f;
+        count = 1;
+      }
+      else if ((ch & 0xf0) == 0xe0)
+      {
+        ch    &= 0x0f;
+        count = 2;
+      }
+      else if ((ch & 0xf8) == 0xf0)
+      {
+        ch    &= 0x07;
+        count = 3;
+      }
+      else
+        return (NULL);
+
+      if ((file->bufend - ptr) < count)
+        return (NULL);
+
+      while (count > 0)
+      {
+        if ((*ptr & 0xc0) != 0x80)
+          return (NULL);
+
+        ch = (ch << 6) | (*ptr++ & 0x3f);
+        count --;
+      }
+    }
+
+    if (ch == 0x7f || ch < 0x07 || ch == 0x08 || (ch > 0x0d && ch < ' '))
+      return (NULL);
+  }
+
+ /*
+  * Find the chunks...
+  */
+
+  if ((split = calloc(1, sizeof(scan_split_t))) == NULL)
+    return (NULL);
+
+  nsnames[0] = NULL;
+  nslens[0]  = 0;
+  start      = file->bufptr;
+  line       = file->line;
+
+  for (ptr = file->bufptr; ptr < file->bufend;)
+  {
+    if (ptr == start)
+    {
+     /*
+      * Start a new chunk...
+      */
+
+      if (split->num_chunks >= split->alloc_chunks)
+      {
+        if ((chunk = realloc(split->chunks, (split->alloc_chunks + 16) * sizeof(scan_chunk_t))) == NULL)
+          goto error;
+
+        split->chunks       = chunk;
+        split->alloc_chunks += 16;
+      }
+
+      chunk = split->chunks + split->num_chunks;
+
+      memset(chunk, 0, sizeof(scan_chunk_t));
+
+      chunk->start = start;
+      chunk->line  = line;
+      chunk->depth = depth;
+
+      if (nsnames[depth])
+      {
+        if ((chunk->nsname = malloc(nslens[depth] + 1)) == NULL)
+          goto error;
+
+        memcpy(chunk->nsname, nsnames[depth], nslens[depth]);
+        chunk->nsname[nslens[depth]] = '\0';
+      }
+
+      split->num_chunks ++;
+    }
+
+    ch = *ptr++;
+
+    if (ch == '\n' || ch == '\f' || ch == '\v')
+      line ++;
+
+    switch (state)
+    {
+      case STATE_NONE :
+          switch (ch)
+          {
+            case '\n' :
+            case ' ' :
+            case '\t' :
+            case '\r' :
+            case '\f' :
+            case '\v' :
+                break;
+
+            case '/' :
+                if (ptr < file->bufend && (*ptr == '*' || *ptr == '/'))
+                {
+                 /*
+                  * A comment documents the next declaration unless it trails
+                  * the previous one on the same line...
+                  */
+
+                  state = *ptr++ == '*' ? STATE_C_COMMENT : STATE_CXX_COMMENT;
+
+                  if (line != endline)
+                    pending = true;
+                }
+                else
+                {
+                  pending  = true;
+                  externkw = false;
+                }
+                break;
+
+            case '#' :
+                state = STATE_PREPROCESSOR;
+                break;
+
+            case '\"' :
+                state   = STATE_STRING;
+                pending = true;
+                break;
+
+            case '\'' :
+                state    = STATE_CHARACTER;
+                pending  = true;
+                externkw = false;
+                break;
+
+            case '(' :
+                parens ++;
+                pending  = true;
+                externkw = false;
+                break;
+
+            case ')' :
+                if (parens > 0)
+                  parens --;
+                externkw = false;
+                break;
+
+            case ';' :
+                if (!opaque && !parens)
+                {
+                  pending = false;
+                  endline = line;
+                }
+                externkw = false;
+                break;
+
+            case '{' :
+                if (opaque)
+                {
+                  opaque ++;
+                }
+                else if (nskeyword || externkw)
+                {
+                 /*
+                  * Namespace or 'extern "C"' block, which the scanner handles
+                  * like a new file...
+                  */
+
+                  if (depth >= SCAN_MAX_NAMESPACES)
+                    goto done;
+
+                  depth ++;
+
+                  if (nskeyword)
+                  {
+                    nsnames[depth] = nsname ? nsname : "";
+                    nslens[depth]  = nslen;
+                  }
+                  else
+                  {
+                    nsnames[depth] = nsnames[depth - 1];
+                    nslens[depth]  = nslens[depth - 1];
+                  }
+
+                  nskeyword = false;
+                  externkw  = false;
+                  pending   = false;
+                  nsname    = NULL;
+                  nslen     = 0;
+                }
+                else
+                {
+                  opaque = 1;
+                }
+                break;
+
+            case '}' :
+                if (opaque)
+                {
+                  if (-- opaque == 0)
+                  {
+                    pending = false;
+                    endline = line;
+                  }
+                }
+                else if (depth > 0)
+                {
+                  depth --;
+                  pending = false;
+                }
+                else
+                {
+                 /*
+                  * The scanner stops at an unbalanced brace...
+                  */
+
+                  goto done;
+                }
+
+                externkw = false;
+                break;
+
+            default :
+                if (!opaque && (isalnum(ch & 255) || ch == '_' || ch == '.' || ch == ':' || ch == '~'))
+                {
+                  for (word = ptr - 1; ptr < file->bufend && (isalnum(*ptr & 255) || *ptr == '_' || *ptr == '.' || *ptr == ':' || *ptr == '~'); ptr ++);
+
+                  if ((ptr - word) == 9 && !strncmp(word, "namespace", 9))
+                  {
+                    nskeyword = true;
+                  }
+                  else if (nskeyword)
+                  {
+                    nsname = word;
+                    nslen  = (size_t)(ptr - word);
+                  }
+
+                  externkw = (ptr - word) == 6 && !strncmp(word, "extern", 6);
+                }
+                else
+                {
+                  externkw = false;
+                }
+
+                pending = true;
+                break;
+          }
+          break;
+
+      case STATE_PREPROCESSOR :
+          if (ch == '\n')
+            state = STATE_NONE;
+          else if (ch == '\\' && ptr < file->bufend && *ptr ++ == '\n')
+            line ++;
+          break;
+
+      case STATE_C_COMMENT :
+          if (ch == '*' && ptr < file->bufend && *ptr == '/')
+          {
+            ptr ++;
+            state = STATE_NONE;
+          }
+          break;
+
+      case STATE_CXX_COMMENT :
+          if (ch == '\n')
+          {
+           /*
+            * The scanner looks ahead for a C++ comment on the next line, so
+            * don't end a chunk here...
+            */
+
+            state = STATE_NONE;
+            continue;
+          }
+          break;
+
+      case STATE_STRING :
+      case STATE_CHARACTER :
+          if (ch == '\\' && ptr < file->bufend)
+          {
+            if (*ptr ++ == '\n')
+              line ++;
+          }
+          else if (ch == (state == STATE_STRING ? '\"' : '\''))
+          {
+            state = STATE_NONE;
+          }
+          break;
+    }
+
+    if (ch == '\n' && state == STATE_NONE && !pending && !nskeyword && !externkw && !opaque && !parens && (ptr - start) >= SCAN_CHUNK_SIZE && (file->bufend - ptr) >= (SCAN_CHUNK_SIZE / 2))
+    {
+     /*
+      * End the current chunk at this line.  A chunk that leaves a namespace
+      * open cannot be scanned on its own since the scanner handles each
+      * namespace with a nested scan...
+      */
+
+      chunk      = split->chunks + split->num_chunks - 1;
+      chunk->end = ptr;
+      start      = ptr;
+
+      if (chunk->depth != depth)
+        chunk->status = SCAN_SKIPPED;
+    }
+  }
+
+  done:
+
+  split->chunks[split->num_chunks - 1].end = file->bufend;
+
+  if (split->num_chunks < 2)
+    goto error;
+
+ /*
+  * Submit the scanning tasks - the serial scan starts with the first chunk...
+  */
+
+  pthread_mutex_init(&split->mutex, NULL);
+  pthread_cond_init(&split->cond, NULL);
+
+  split->chunks[0].status = SCAN_SKIPPED;
+
+  for (chunk = split->chunks; chunk < (split->chunks + split->num_chunks); chunk ++)
+  {
+    filebuf_open_buffer(&chunk->file, file->filename, chunk->start, (size_t)(chunk->end - chunk->start));
+    chunk->file.garbage = NULL;
+    chunk->split        = split;
+
+    if (chunk > split->chunks)
+      chunk->task = jobsSubmit((jobs_task_cb_t)scan_chunk_task, chunk, JOBS_PRIORITY_NORMAL, 0, NULL);
+  }
+
+  split->next = split->chunks[0].start;
+
+  return (split);
+
+ /*
+  * If we get here, we can't scan in parallel...
+  */
+
+  error:
+
+  for (chunk = split->chunks; chunk < (split->chunks + split->num_chunks); chunk ++)
+    free(chunk->nsname);
+
+  free(split->chunks);
+  free(split);
+
+  return (NULL);
+
+#else
+  (void)file;
+
+  return (NULL);
+#endif /* HAVE_PTHREAD_H */
+}
+
+
+/*
+ * 'scan_split_stop()' - Stop scanning chunks and free them.
+ */
+
+static void
+scan_split_stop(scan_split_t *split)	/* I - Speculatively scanned chunks or `NULL` */
+{
+#ifdef HAVE_PTHREAD_H
+  size_t	i;			/* Looping var */
+  scan_chunk_t	*chunk;			/* Current chunk */
+
+
+  if (!split)
+    return;
+
+ /*
+  * Cancel any chunks that have not been started and wait for the rest...
+  */
+
+  pthread_mutex_lock(&split->mutex);
+
+  for (i = 0, chunk = split->chunks; i < split->num_chunks; i ++, chunk ++)
+  {
+    if (chunk->status == SCAN_QUEUED)
+      chunk->status = SCAN_SKIPPED;
+  }
+
+  pthread_mutex_unlock(&split->mutex);
+
+  for (i = 0, chunk = split->chunks; i < split->num_chunks; i ++, chunk ++)
+    jobsWait(chunk->task);
+
+ /*
+  * Record how many of the speculatively scanned chunks were used (the first
+  * chunk is always scanned serially)...
+  */
+
+  statsAddChunks(split->num_chunks - 1, split->num_grafted);
+
+ /*
+  * Free memory...
+  */
+
+  for (i = 0, chunk = split->chunks; i < split->num_chunks; i ++, chunk ++)
+  {
+    filebuf_close(&chunk->file);
+    mxmlDelete(chunk->tree);
+    mxmlDelete(chunk->file.garbage);
+    free(chunk->nsname);
+  }
+
+  pthread_cond_destroy(&split->cond);
+  pthread_mutex_destroy(&split->mutex);
+
+  free(split->chunks);
+  free(split);
+
+#else
+  (void)split;
+#endif /* HAVE_PTHREAD_H */
+}
+
+
+/*
+ * 'scan_stdin()' - Scan source files from the standard input.
+ *
+ * The standard input contains a single source file unless it starts with the
+ * line "codedoc-sources 1.0", in which case it contains any number of source
+ * files, each consisting of a "LENGTH FILENAME" line followed by LENGTH bytes
+ * of source code.  Each file is scanned as soon as it has been read, so only
+ * one file is held in memory at a time.
+ */
+
+static bool				/* O  - `true` on success, `false` on error */
+scan_stdin(mxml_node_t *doc,		/* I  - Documentation */
+           const char  *name,		/* I  - Name of single source file */
+           mmd_t       **body)		/* IO - Body markdown text */
+{
+  filebuf_t	file;			/* File buffer */
+  char		line[1024],		/* Header or record line */
+		*filename,		/* Name of source file */
+		*data,			/* Source file contents */
+		*ptr;			/* Pointer into line */
+  size_t	length;			/* Length of source file */
+  int		error,			/* `errno` value */
+		scanned;		/* Result of scanning file */
+  bool		framed;			/* Multiple files? */
+
+
+  if (!fgets(line, sizeof(line), stdin))
+  {
+    if (!ferror(stdin))
+      return (true);
+
+    fprintf(stderr, "%s: %s\n", name, strerror(errno));
+    return (false);
+  }
+
+  framed = !strcmp(line, "codedoc-sources 1.0\n");
+
+  do
+  {
+    if (framed)
+    {
+     /*
+      * Read the next "LENGTH FILENAME" record...
+      */
+
+      if (!fgets(line, sizeof(line), stdin))
+        break;
+
+      length = (size_t)strtoul(line, &filename, 10);
+
+      if (*filename != ' ' || (ptr = strchr(filename, '\n')) == NULL)
+      {
+        fputs("codedoc: Bad record in source stream.\n", stderr);
+        return (false);
+      }
+
+      *ptr = '\0';
+      filename ++;
+
+      if ((data = malloc(length + 1)) == NULL)
+      {
+        fprintf(stderr, "codedoc: Unable to allocate memory for \"%s\".\n", filename);
+        exit(1);
+      }
+
+      if (fread(data, 1, length, stdin) != length)
+      {
+        fprintf(stderr, "codedoc: Source stream ended early in \"%s\".\n", filename);
+        free(data);
+        return (false);
+      }
+    }
+    else
+    {
+     /*
+      * Read the rest of the single source file...
+      */
+
+      filename = (char *)name;
+      length   = strlen(line);
+
+      error = 0;
+
+      if ((data = strdup(line)) == NULL || (error = filebuf_read_fp(stdin, 65536, &data, &length)) != 0)
+      {
+        fprintf(stderr, "%s: %s\n", name, strerror(error ? error : errno));
+        return (false);
+      }
+    }
+
+   /*
+    * Scan the file...
+    */
+
+    filebuf_open_buffer(&file, filename, data, length);
+    file.buffer = data;
+
+    CODEDOC_PROBE2(scan__start, filename, length);
+
+    scanned = scan_source(&file, doc, body);
+
+    CODEDOC_PROBE3(scan__done, filename, length, scanned);
+
+    filebuf_close(&file);
+
+    if (!scanned)
+      return (false);
+  }
+  while (framed);
+
+  return (true);
+}
+
+
+/*
+ * 'shard_add()' - Add a rendered symbol.
+ *
+ * The caller copies the rendered HTML to the entry's (uninitialized) data.
+ * The entries must be sorted with @link shard_compare@ once all of the symbols
+ * are added.
+ */
+
+static shard_entry_t *			/* O - New entry */
+shard_add(shard_t    *shard,		/* I - Assembled symbols */
+          const char *kind,		/* I - Kind of symbol */
+          const char *name,		/* I - Name of symbol */
+          size_t     length)		/* I - Length of rendered HTML */
+{
+  shard_entry_t	*entry;			/* New entry */
+
+
+  if (shard->num_entries >= shard->alloc_entries)
+  {
+    shard->alloc_entries += 256;
+
+    if ((entry = realloc(shard->entries, shard->alloc_entries * sizeof(shard_entry_t))) == NULL)
+    {
+      fputs("codedoc: Unable to allocate memory for shard.\n", stderr);
+      exit(1);
+    }
+
+    shard->entries = entry;
+  }
+
+  entry = shard->entries + shard->num_entries;
+
+  if ((entry->kind = strdup(kind)) == NULL || (entry->name = strdup(name)) == NULL || (entry->data = malloc(length + 1)) == NULL)
+  {
+    fputs("codedoc: Unable to allocate memory for shard.\n", stderr);
+    exit(1);
+  }
+
+  entry->length = length;
+  entry->seq    = shard->num_entries;
+  entry->used   = false;
+
+  shard->num_entries ++;
+
+  return (entry);
+}
+
+
+/*
+ * 'shard_compare()' - Compare two shard entries.
+ */
+
+static int				/* O - Result of comparison */
+shard_compare(shard_entry_t *a,		/* I - First entry */
+              shard_entry_t *b)		/* I - Second entry */
+{
+  int	ret;				/* Result of comparison */
+
+
+  if ((ret = strcmp(a->kind, b->kind)) == 0 && (ret = strcmp(a->name, b->name)) == 0)
+  {
+    if (a->seq < b->seq)
+      ret = -1;
+    else if (a->seq > b->seq)
+      ret = 1;
+  }
+
+  return (ret);
+}
+
+
+/*
+ * 'shard_free()' - Free the symbols loaded from shard files.
+ */
+
+static void
+shard_free(shard_t *shard)		/* I - Assembled symbols */
+{
+  size_t	i;			/* Looping var */
+
+
+  for (i = 0; i < shard->num_entries; i ++)
+  {
+    free(shard->entries[i].kind);
+    free(shard->entries[i].name);
+    free(shard->entries[i].data);
+  }
+
+  free(shard->entries);
+
+  memset(shard, 0, sizeof(shard_t));
+}
+
+
+/*
+ * 'shard_load()' - Load the symbols rendered by a `--shard` run.
+ *
+ * A shard file starts with the line "codedoc-shard 1.0" and is followed by a
+ * record for each symbol consisting of a "LENGTH KIND NAME" line and LENGTH
+ * bytes of rendered HTML.
+ */
+
+static bool				/* O - `true` on success, `false` on error */
+shard_load(shard_t    *shard,		/* I - Assembled symbols */
+           const char *filename)	/* I - Shard file */
+{
+  FILE		*fp;			/* Shard file */
+  char		line[1024],		/* Record line */
+		*kind,			/* Kind of symbol */
+		*name,			/* Name of symbol */
+		*ptr;			/* Pointer into line */
+  unsigned long	length;			/* Length of rendered HTML */
+  shard_entry_t	*entry;			/* New entry */
+
+
+  if ((fp = fopen(filename, "rb")) == NULL)
+  {
+    fprintf(stderr, "codedoc: Unable to open shard file \"%s\": %s\n", filename, strerror(errno));
+    return (false);
+  }
+
+  if (!fgets(line, sizeof(line), fp) || strcmp(line, "codedoc-shard 1.0\n"))
+  {
+    fprintf(stderr, "codedoc: \"%s\" is not a shard file.\n", filename);
+    fclose(fp);
+    return (false);
+  }
+
+  while (fgets(line, sizeof(line), fp))
+  {
+   /*
+    * Parse the "LENGTH KIND NAME" line...
+    */
+
+    length = strtoul(line, &kind, 10);
+
+    if (*kind != ' ' || (ptr = strchr(line, '\n')) == NULL)
+      goto bad_record;
+
+    *ptr = '\0';
+    kind ++;
+
+    if ((name = strchr(kind, ' ')) == NULL)
+      goto bad_record;
+
+    *name++ = '\0';
+
+   /*
+    * Add an entry and read the HTML...
+    */
+
+    entry = shard_add(shard, kind, name, (size_t)length);
+
+    if (fread(entry->data, 1, entry->length, fp) != entry->length)
+      goto bad_record;
+  }
+
+  fclose(fp);
+
+  qsort(shard->entries, shard->num_entries, sizeof(shard_entry_t), (int (*)(const void *, const void *))shard_compare);
+
+  return (true);
+
+ /*
+  * If we get here there was a problem with the file...
+  */
+
+  bad_record:
+
+  fprintf(stderr, "codedoc: Bad record in shard file \"%s\".\n", filename);
+  fclose(fp);
+
+  return (false);
+}
+
+
+/*
+ * 'sort_node()' - Insert a node sorted into a tree.
+ */
+
+static void
+sort_node(filebuf_t   *file,		/* I - File buffer */
+          mxml_node_t *tree,		/* I - Tree to sort into */
+          mxml_node_t *node)		/* I - Node to add */
+{
+  mxml_node_t	*temp;			/* Current node */
+  const char	*tempname,		/* Name of current node */
+		*nodename,		/* Name of node */
+		*element,		/* Element name (kind) of node */
+		*scope;			/* Scope */
+
+
+#if DEBUG > 1
+  DEBUG_printf("    sort_node(tree=%p, node=%p)\n", tree, node);
+#endif /* DEBUG > 1 */
+
+ /*
+  * Range check input...
+  */
+
+  if (!tree || !node)
+    return;
+
+  if (mxmlGetParent(node) == tree)
+  {
+   /*
+    * Already sorted, possibly under a different name...
+    */
+
+    file->order_dependent = true;
+    return;
+  }
+
+ /*
+  * Get the node name...
+  */
+
+  if ((nodename = mxmlElementGetAttr(node, "name")) == NULL)
+  {
+#if DEBUG > 1
+    DEBUG_puts("        nodename not found.");
+#endif /* DEBUG > 1 */
+    return;
+  }
+
+  element = mxmlGetElement(node);
+
+  CODEDOC_PROBE2(declaration__add, element, nodename);
+
+  if (nodename[0] == '_')
+  {
+#if DEBUG > 1
+    DEBUG_puts("        nodename=private");
+#endif /* DEBUG > 1 */
+    return;				/* Hide private names */
+  }
+
+#if DEBUG > 1
+  DEBUG_printf("        nodename=%p (\"%s\")\n", nodename, nodename);
+#endif /* DEBUG > 1 */
+
+ /*
+  * Delete any existing definition at this level, if one exists...
+  */
+
+  if ((temp = mxmlFindElement(tree, tree, element, "name", nodename, MXML_DESCEND_FIRST)) != NULL)
+  {
+   /*
+    * Copy the scope if needed...
+    */
+
+    if ((scope = mxmlElementGetAttr(temp, "scope")) != NULL &&
+        mxmlElementGetAttr(node, "scope") == NULL)
+    {
+      DEBUG_printf("    copying scope %s for %s\n", scope, nodename);
+
+      mxmlElementSetAttr(node, "scope", scope);
+    }
+
+    mxmlAdd(file->garbage, MXML_ADD_AFTER, NULL, temp);
+  }
+
+ /*
+  * Add the node into the tree at the proper place...
+  */
+
+  for (temp = mxmlGetFirstChild(tree); temp; temp = mxmlGetNextSibling(temp))
+  {
+#if DEBUG > 1
+    DEBUG_printf("        temp=%p\n", temp);
+#endif /* DEBUG > 1 */
+
+    if ((tempname = mxmlElementGetAttr(temp, "name")) == NULL)
+      continue;
+
+#if DEBUG > 1
+    DEBUG_printf("        tempname=%p (\"%s\")\n", tempname, tempname);
+#endif /* DEBUG > 1 */
+
+    if (strcmp(nodename, tempname) < 0)
+      break;
+  }
+
+  if (temp)
+  {
+#if DEBUG > 1
+    DEBUG_printf("        adding \"%s\" before \"%s\"\n", nodename, tempname);
+#endif /* DEBUG > 1 */
+
+    mxmlAdd(tree, MXML_ADD_BEFORE, temp, node);
+  }
+  else
+  {
+#if DEBUG > 1
+    DEBUG_printf("        adding \"%s\" to the end\n", nodename);
+#endif /* DEBUG > 1 */
+
+    mxmlAdd(tree, MXML_ADD_AFTER, /*parent*/NULL, node);
+  }
+
+  CODEDOC_PROBE3(sort__insert, element, nodename, temp ? tempname : NULL);
+}
+
+
+/*
+ * 'spill_check()' - Spill the scanned symbols to disk when they use too much
+ *                   memory.
+ *
+ * Walking the tree takes time, so the memory used by the symbols is only
+ * estimated again once enough source has been scanned to use a quarter of the
+ * remaining memory at 4 bytes of symbols per byte of source.
+ */
+
+static bool				/* O - `true` on success, `false` on error */
+spill_check(spill_t     *spill,		/* I - Spilled symbols */
+            mxml_node_t *codedoc,	/* I - codedoc node */
+            size_t      bytes)		/* I - Number of bytes scanned */
+{
+  spill->scanned += bytes;
+
+  if (spill->estimate < spill->max_memory && 4 * 4 * spill->scanned < spill->max_memory - spill->estimate)
+    return (true);
+
+  spill->estimate = spill_estimate(codedoc) + spill_estimate(Garbage);
+  spill->scanned  = 0;
+
+  if (spill->estimate < spill->max_memory)
+    return (true);
+
+  if (!spill_tree(spill, codedoc))
+    return (false);
+
+  spill->estimate = spill_estimate(codedoc);
+
+  return (true);
+}
+
+
+/*
+ * 'spill_estimate()' - Estimate the memory used by a tree.
+ */
+
+static size_t				/* O - Estimated number of bytes */
+spill_estimate(mxml_node_t *node)	/* I - Top node */
+{
+  size_t	bytes = 0;		/* Estimated number of bytes */
+  mxml_node_t	*current;		/* Current node */
+  const char	*name,			/* Attribute name */
+		*value;			/* Attribute value */
+  size_t	i,			/* Looping var */
+		count;			/* Number of attributes */
+
+
+  for (current = node; current; current = mxmlWalkNext(current, node, MXML_DESCEND_ALL))
+  {
+    bytes += 64;
+
+    switch (mxmlGetType(current))
+    {
+      case MXML_TYPE_ELEMENT :
+          bytes += strlen(mxmlGetElement(current)) + 1;
+
+          for (i = 0, count = mxmlElementGetAttrCount(current); i < count; i ++)
+          {
+            if ((value = mxmlElementGetAttrByIndex(current, i, &name)) != NULL)
+              bytes += strlen(name) + strlen(value) + 34;
+          }
+          break;
+
+      case MXML_TYPE_OPAQUE :
+          if ((value = mxmlGetOpaque(current)) != NULL)
+            bytes += strlen(value) + 1;
+          break;
+
+      case MXML_TYPE_TEXT :
+          if ((value = mxmlGetText(current, NULL)) != NULL)
+            bytes += strlen(value) + 1;
+          break;
+
+      default :
+          break;
+    }
+  }
+
+  return (bytes);
+}
+
+
+/*
+ * 'spill_free()' - Close the file of spilled symbols and free their records.
+ */
+
+static void
+spill_free(spill_t *spill)		/* I - Spilled symbols */
+{
+  spill_record_t *record,		/* Current record */
+		*next;			/* Next record */
+
+
+  if (spill->fp)
+    fclose(spill->fp);
+
+  for (record = spill->records; record; record = next)
+  {
+    next = record->next;
+    free(record);
+  }
+
+  spill->fp      = NULL;
+  spill->records = NULL;
+}
+
+
+/*
+ * 'spill_save()' - Save the XML documentation file with the spilled symbols.
+ *
+ * The file is written one top-level symbol at a time, copying the XML of each
+ * spilled symbol from the spill file in place of its stub, so the spilled
+ * symbols are never loaded back into memory.  The output is the same as saving
+ * the whole tree with `mxmlSaveIO`.
+ */
+
+static bool				/* O - `true` on success, `false` on error */
+spill_save(spill_t        *spill,	/* I - Spilled symbols */
+           mxml_node_t    *doc,		/* I - XML document */
+           mxml_node_t    *codedoc,	/* I - codedoc node */
+           mxml_options_t *options,	/* I - Save options */
+           const char     *xmlfile)	/* I - XML documentation file */
+{
+  bool		ret = false;		/* Return value */
+  const char	*ext = strrchr(xmlfile, '.');
+					/* Extension of XML file */
+  gzFile	gz;			/* XML file */
+  mxml_node_t	*holder,		/* Holder for symbols */
+		*marker,		/* Marker for symbols */
+		*node;			/* Current node */
+  spill_record_t *record;		/* Record for spilled symbol */
+  char		*envelope,		/* XML around the symbols */
+		*start,			/* Start of marker line */
+		*end,			/* End of marker line */
+		*data,			/* XML for symbol */
+		buffer[65536];		/* Copy buffer */
+  size_t	length,			/* Remaining length of record */
+		bytes;			/* Bytes to copy */
+
+
+ /*
+  * Save the document without the symbols, with a marker where they go...
+  */
+
+  holder = mxmlNewElement(/*parent*/NULL, "holder");
+
+  while ((node = mxmlGetFirstChild(codedoc)) != NULL)
+    mxmlAdd(holder, MXML_ADD_AFTER, /*child*/NULL, node);
+
+  marker   = mxmlNewElement(codedoc, "codedoc-spill");
+  envelope = mxmlSaveAllocString(doc, options);
+
+  mxmlDelete(marker);
+
+  while ((node = mxmlGetFirstChild(holder)) != NULL)
+    mxmlAdd(codedoc, MXML_ADD_AFTER, /*child*/NULL, node);
+
+  mxmlDelete(holder);
+
+  if (!envelope)
+  {
+    fputs("codedoc: Unable to allocate memory for XML documentation file.\n", stderr);
+    exit(1);
+  }
+
+  if ((end = strstr(envelope, "<codedoc-spill")) == NULL || (end = strchr(end, '\n')) == NULL)
+  {
+    free(envelope);
+    errno = EINVAL;
+    return (false);
+  }
+
+  for (start = end - 1; start > envelope && start[-1] != '\n'; start --);
+
+  *start = '\0';
+  end ++;
+
+ /*
+  * Write the file, compressing it if the filename ends with ".gz"...
+  */
+
+  if ((gz = gzopen(xmlfile, ext && !strcmp(ext, ".gz") ? "wb" : "wbT")) == NULL)
+  {
+    free(envelope);
+    return (false);
+  }
+
+  if (gzputs(gz, envelope) < 0)
+    goto done;
+
+  for (node = mxmlGetFirstChild(codedoc); node; node = mxmlGetNextSibling(node))
+  {
+    if ((record = (spill_record_t *)mxmlGetUserData(node)) != NULL)
+    {
+     /*
+      * Copy a spilled symbol...
+      */
+
+      if (fseek(spill->fp, record->offset, SEEK_SET))
+        goto done;
+
+      for (length = record->length; length > 0; length -= bytes)
+      {
+        if ((bytes = length) > sizeof(buffer))
+          bytes = sizeof(buffer);
+
+        if (fread(buffer, 1, bytes, spill->fp) != bytes || gzwrite(gz, buffer, (unsigned)bytes) != (int)bytes)
+          goto done;
+      }
+    }
+    else
+    {
+     /*
+      * Save a symbol in memory...
+      */
+
+      if ((data = mxmlSaveAllocString(node, options)) == NULL)
+      {
+        fputs("codedoc: Unable to allocate memory for XML documentation file.\n", stderr);
+        exit(1);
+      }
+
+      bytes = strlen(data);
+
+      if (bytes > 0 && gzwrite(gz, data, (unsigned)bytes) != (int)bytes)
+      {
+        free(data);
+        goto done;
+      }
+
+      free(data);
+    }
+  }
+
+  if (gzputs(gz, end) < 0)
+    goto done;
+
+  ret = true;
+
+  done:
+
+  if (gzclose(gz) != Z_OK)
+    ret = false;
+
+  free(envelope);
+
+  return (ret);
+}
+
+
+/*
+ * 'spill_tree()' - Spill the scanned symbols to the spill file on disk.
+ *
+ * The XML of each symbol is appended to the spill file and the symbol is
+ * replaced by a stub with the same kind, name, and scope, which keeps its
+ * place in the tree for @link sort_node@ and @link spill_save@.  Classes and
+ * structures stay in memory since later source files may add methods to them.
+ * Once the symbols are written the garbage from scanning is freed as well.
+ */
+
+static bool				/* O - `true` on success, `false` on error */
+spill_tree(spill_t     *spill,		/* I - Spilled symbols */
+           mxml_node_t *codedoc)	/* I - codedoc node */
+{
+  mxml_options_t *options;		/* Save options */
+  mxml_node_t	*node,			/* Current node */
+		*next,			/* Next node */
+		*stub;			/* Stub for spilled symbol */
+  spill_record_t *record;		/* Record for spilled symbol */
+  const char	*kind,			/* Kind of symbol */
+		*name,			/* Name of symbol */
+		*scope;			/* Scope of symbol */
+  char		*data;			/* XML for symbol */
+  long		offset;			/* Offset in spill file */
+
+
+  if (!spill->fp && (spill->fp = tmpfile()) == NULL)
+  {
+    fprintf(stderr, "codedoc: Unable to create temporary file: %s\n", strerror(errno));
+    return (false);
+  }
+
+  if (fseek(spill->fp, 0, SEEK_END) || (offset = ftell(spill->fp)) < 0)
+  {
+    fprintf(stderr, "codedoc: Unable to write temporary file: %s\n", strerror(errno));
+    return (false);
+  }
+
+  options = mxmlOptionsNew();
+
+  mxmlOptionsSetWhitespaceCallback(options, ws_cb, /*cbdata*/NULL);
+  mxmlOptionsSetWrapMargin(options, 0);
+
+  for (node = mxmlGetFirstChild(codedoc); node; node = next)
+  {
+    next = mxmlGetNextSibling(node);
+
+    if (mxmlGetType(node) != MXML_TYPE_ELEMENT || mxmlGetUserData(node) || (name = mxmlElementGetAttr(node, "name")) == NULL)
+      continue;
+
+    kind = mxmlGetElement(node);
+
+    if (!strcmp(kind, "class") || !strcmp(kind, "struct"))
+      continue;
+
+   /*
+    * Write the symbol and replace it with a stub...
+    */
+
+    if ((data = mxmlSaveAllocString(node, options)) == NULL || (record = calloc(1, sizeof(spill_record_t))) == NULL)
+    {
+      fputs("codedoc: Unable to allocate memory for spilled symbol.\n", stderr);
+      exit(1);
+    }
+
+    record->next   = spill->records;
+    record->offset = offset;
+    record->length = strlen(data);
+    spill->records = record;
+
+    fputs(data, spill->fp);
+    offset += (long)record->length;
+    free(data);
+
+    stub = mxmlNewElement(/*parent*/NULL, kind);
+
+    mxmlElementSetAttr(stub, "name", name);
+    if ((scope = mxmlElementGetAttr(node, "scope")) != NULL)
+      mxmlElementSetAttr(stub, "scope", scope);
+    mxmlSetUserData(stub, record);
+
+    mxmlAdd(codedoc, MXML_ADD_BEFORE, node, stub);
+    mxmlDelete(node);
+  }
+
+  mxmlOptionsDelete(options);
+
+ /*
+  * Free the garbage...
+  */
+
+  mxmlDelete(Garbage);
+  Garbage = mxmlNewElement(/*parent*/NULL, "garbage");
+
+  if (fflush(spill->fp) || ferror(spill->fp))
+  {
+    fprintf(stderr, "codedoc: Unable to write temporary file: %s\n", strerror(errno));
+    return (false);
+  }
+
+  return (true);
+}
+
+
+/*
+ * 'start_details()' - Start a deferred detail chunk for progressive HTML.
+ *
+ * Returns the file to write the symbol's details to - `out` when details are
+ * not deferred.  The chunk is finished with @link write_details@.
+ */
+
+static FILE *				/* O - File for details */
+start_details(FILE *out,		/* I - Output file */
+              FILE *details)		/* I - Detail file or `NULL` */
+{
+  if (!details)
+    return (out);
+
+  rewind(details);
+
+  return (details);
+}
+
+
+/*
+ * 'store_add()' - Add a version of the documentation to a store.
+ *
+ * Each top-level symbol is saved as an object named by the FNV-1a hash of its
+ * XML, so symbols that do not change between versions are only stored once.
+ * The version's manifest ("codedoc-manifest 1.0" followed by a "HASH KIND NAME"
+ * line for each symbol) is saved the same way and listed in the store's index
+ * file.  Adding an existing version replaces it.
+ */
+
+static bool				/* O - `true` on success, `false` on error */
+store_add(store_t     *store,		/* I - Store */
+          mxml_node_t *codedoc,		/* I - codedoc node */
+          const char  *version)		/* I - Version name */
+{
+  mxml_options_t *options;		/* Save options */
+  mxml_node_t	*node;			/* Current symbol */
+  const char	*kind,			/* Kind of symbol */
+		*name;			/* Name of symbol */
+  char		*data,			/* XML for symbol */
+		*manifest,		/* Manifest */
+		*ptr;			/* Pointer into manifest */
+  size_t	length,			/* Length of data */
+		mlength,		/* Length of manifest */
+		malloc_length,		/* Allocated length of manifest */
+		i;			/* Looping var */
+  unsigned long long hash;		/* Hash of data */
+  bool		ret = false;		/* Return value */
+  store_version_t *v;			/* Current version */
+  char		filename[1024],		/* Index filename */
+		tempname[1024];		/* Temporary filename */
+  FILE		*fp;			/* Index file */
+
+
+  options = mxmlOptionsNew();
+
+  mxmlOptionsSetWhitespaceCallback(options, ws_cb, /*cbdata*/NULL);
+  mxmlOptionsSetWrapMargin(options, 0);
+
+  malloc_length = 65536;
+
+  if ((manifest = malloc(malloc_length)) == NULL)
+  {
+    fputs("codedoc: Unable to allocate memory for store manifest.\n", stderr);
+    exit(1);
+  }
+
+  mlength = strlcpy(manifest, "codedoc-manifest 1.0\n", malloc_length);
+
+ /*
+  * Save each symbol...
+  */
+
+  for (node = mxmlGetFirstChild(codedoc); node; node = mxmlGetNextSibling(node))
+  {
+    if (mxmlGetType(node) != MXML_TYPE_ELEMENT)
+      continue;
+
+    if ((data = mxmlSaveAllocString(node, options)) == NULL)
+    {
+      fputs("codedoc: Unable to allocate memory for store object.\n", stderr);
+      exit(1);
+    }
+
+    length = strlen(data);
+    hash   = store_hash(0xcbf29ce484222325ULL, data, length);
+
+    if (!store_put(store, "objects", hash, data, length, true))
+    {
+      free(data);
+      goto done;
+    }
+
+    free(data);
+
+    kind = mxmlGetElement(node);
+    if ((name = mxmlElementGetAttr(node, "name")) == NULL)
+      name = "-";
+
+    length = strlen(kind) + strlen(name) + 20;
+
+    if ((mlength + length) >= malloc_length)
+    {
+      malloc_length += length + 65536;
+
+      if ((ptr = realloc(manifest, malloc_length)) == NULL)
+      {
+	fputs("codedoc: Unable to allocate memory for store manifest.\n", stderr);
+	exit(1);
+      }
+
+      manifest = ptr;
+    }
+
+    mlength += (size_t)snprintf(manifest + mlength, malloc_length - mlength, "%016llx %s %s\n", hash, kind, name);
+  }
+
+ /*
+  * Save the manifest and update the index...
+  */
+
+  hash = store_hash(0xcbf29ce484222325ULL, manifest, mlength);
+
+  if (!store_put(store, "objects", hash, manifest, mlength, true))
+    goto done;
+
+  for (i = store->num_versions, v = store->versions; i > 0; i --, v ++)
+  {
+    if (!strcmp(v->name, version))
+      break;
+  }
+
+  if (i == 0)
+  {
+    if (store->num_versions >= store->alloc_versions)
+    {
+      store->alloc_versions += 16;
+
+      if ((v = realloc(store->versions, store->alloc_versions * sizeof(store_version_t))) == NULL)
+      {
+	fputs("codedoc: Unable to allocate memory for store index.\n", stderr);
+	exit(1);
+      }
+
+      store->versions = v;
+    }
+
+    v = store->versions + store->num_versions;
+
+    if ((v->name = strdup(version)) == NULL)
+    {
+      fputs("codedoc: Unable to allocate memory for store index.\n", stderr);
+      exit(1);
+    }
+
+    store->num_versions ++;
+  }
+
+  v->manifest = hash;
+
+  snprintf(filename, sizeof(filename), "%s/index", store->dir);
+
+  if (snprintf(tempname, sizeof(tempname), "%s.%d", filename, (int)getpid()) >= (int)sizeof(tempname))
+  {
+    fprintf(stderr, "codedoc: Store directory \"%s\" is too long.\n", store->dir);
+    goto done;
+  }
+
+  if ((fp = fopen(tempname, "w")) == NULL)
+  {
+    fprintf(stderr, "codedoc: Unable to create store index \"%s\": %s\n", tempname, strerror(errno));
+    goto done;
+  }
+
+  fputs("codedoc-store 1.0\n", fp);
+
+  for (i = store->num_versions, v = store->versions; i > 0; i --, v ++)
+    fprintf(fp, "%016llx %s\n", v->manifest, v->name);
+
+  if (fclose(fp))
+  {
+    fprintf(stderr, "codedoc: Unable to write store index \"%s\": %s\n", tempname, strerror(errno));
+    unlink(tempname);
+    goto done;
+  }
+
+  if (rename(tempname, filename))
+  {
+    fprintf(stderr, "codedoc: Unable to create store index \"%s\": %s\n", filename, strerror(errno));
+    unlink(tempname);
+    goto done;
+  }
+
+  ret = true;
+
+  done:
+
+  free(manifest);
+  mxmlOptionsDelete(options);
+
+  return (ret);
+}
+
+
+/*
+ * 'store_close()' - Free the index of a store.
+ */
+
+static void
+store_close(store_t *store)		/* I - Store */
+{
+  size_t	i;			/* Looping var */
+
+
+  for (i = 0; i < store->num_versions; i ++)
+    free(store->versions[i].name);
+
+  free(store->versions);
+
+  memset(store, 0, sizeof(store_t));
+}
+
+
+/*
+ * 'store_compare()' - Compare two symbols from store manifests.
+ */
+
+static int				/* O - Result of comparison */
+store_compare(store_symbol_t *a,	/* I - First symbol */
+              store_symbol_t *b)	/* I - Second symbol */
+{
+  int	ret;				/* Result of comparison */
+
+
+  if ((ret = strcmp(a->kind, b->kind)) == 0 && (ret = strcmp(a->name, b->name)) == 0)
+  {
+    if (a->seq < b->seq)
+      ret = -1;
+    else if (a->seq > b->seq)
+      ret = 1;
+  }
+
+  return (ret);
+}
+
+
+/*
+ * 'store_get()' - Get an object or rendered fragment from a store.
+ */
+
+static char *				/* O - Data (nul-terminated) or `NULL` if not present */
+store_get(store_t            *store,	/* I - Store */
+          const char         *subdir,	/* I - "html" or "objects" */
+          unsigned long long hash,	/* I - Hash of data */
+          size_t             *length)	/* O - Length of data */
+{
+  char		filename[1024],		/* Filename */
+		*data;			/* Data */
+  FILE		*fp;			/* File */
+  long		fplength;		/* Length of file */
+
+
+  snprintf(filename, sizeof(filename), "%s/%s/%02x/%014llx", store->dir, subdir, (unsigned)(hash >> 56), hash & 0xffffffffffffffULL);
+
+  if ((fp = fopen(filename, "rb")) == NULL)
+    return (NULL);
+
+  if (fseek(fp, 0, SEEK_END) || (fplength = ftell(fp)) < 0)
+  {
+    fclose(fp);
+    return (NULL);
+  }
+
+  rewind(fp);
+
+  if ((data = malloc((size_t)fplength + 1)) == NULL)
+  {
+    fputs("codedoc: Unable to allocate memory for store object.\n", stderr);
+    exit(1);
+  }
+
+  if (fread(data, 1, (size_t)fplength, fp) != (size_t)fplength)
+  {
+    free(data);
+    fclose(fp);
+    return (NULL);
+  }
+
+  fclose(fp);
+
+  data[fplength] = '\0';
+  *length        = (size_t)fplength;
+
+  return (data);
+}
+
+
+/*
+ * 'store_hash()' - Add data to a FNV-1a hash.
+ */
+
+static unsigned long long		/* O - New hash */
+store_hash(unsigned long long hash,	/* I - Current hash */
+           const void         *data,	/* I - Data */
+           size_t             length)	/* I - Length of data */
+{
+  const unsigned char	*dataptr;	/* Pointer into data */
+
+
+  for (dataptr = (const unsigned char *)data; length > 0; length --, dataptr ++)
+  {
+    hash ^= *dataptr;
+    hash *= 0x100000001b3ULL;
+  }
+
+  return (hash);
+}
+
+
+/*
+ * 'store_load()' - Load a version of the documentation from a store.
+ */
+
+static mxml_node_t *			/* O - XML documentation or `NULL` on error */
+store_load(store_t     *store,		/* I - Store */
+           const char  *version,	/* I - Version name */
+           mxml_node_t **codedoc)	/* O - codedoc node */
+{
+  size_t	i;			/* Looping var */
+  char		*manifest,		/* Manifest */
+		*line,			/* Current line */
+		*next,			/* Next line */
+		*ptr,			/* Pointer into line */
+		*data;			/* Symbol XML */
+  size_t	length;			/* Length of data */
+  unsigned long long hash;		/* Hash of symbol */
+  mxml_options_t *options;		/* Load options */
+  mxml_node_t	*doc;			/* XML documentation */
+
+
+  for (i = 0; i < store->num_versions; i ++)
+  {
+    if (!strcmp(store->versions[i].name, version))
+      break;
+  }
+
+  if (i >= store->num_versions)
+  {
+    fprintf(stderr, "codedoc: Version \"%s\" is not in store \"%s\".\n", version, store->dir);
+    return (NULL);
+  }
+
+  if ((manifest = store_get(store, "objects", store->versions[i].manifest, &length)) == NULL || strncmp(manifest, "codedoc-manifest 1.0\n", 21))
+  {
+    fprintf(stderr, "codedoc: Missing or bad manifest for version \"%s\" in store \"%s\".\n", version, store->dir);
+    free(manifest);
+    return (NULL);
+  }
+
+  doc     = new_documentation(codedoc);
+  options = mxmlOptionsNew();
+
+  mxmlOptionsSetTypeCallback(options, type_cb, /*cbdata*/NULL);
+
+  for (line = manifest + 21; *line; line = next)
+  {
+    if ((next = strchr(line, '\n')) != NULL)
+      *next++ = '\0';
+    else
+      next = line + strlen(line);
+
+    hash = strtoull(line, &ptr, 16);
+    data = NULL;
+
+    if (*ptr != ' ' || (data = store_get(store, "objects", hash, &length)) == NULL || !mxmlLoadString(*codedoc, options, data))
+    {
+      fprintf(stderr, "codedoc: Missing or bad object \"%s\" in store \"%s\".\n", line, store->dir);
+
+      free(data);
+      mxmlDelete(doc);
+      doc      = NULL;
+      *codedoc = NULL;
+      break;
+    }
+
+    free(data);
+  }
+
+  mxmlOptionsDelete(options);
+  free(manifest);
+
+  return (doc);
+}
+
+
+/*
+ * 'store_open()' - Open a documentation store.
+ *
+ * A store is a directory containing an "index" file with the line
+ * "codedoc-store 1.0" followed by a "HASH VERSION" line for each version in
+ * release order, plus "objects" and "html" directories holding symbol records,
+ * manifests, and rendered HTML named by their hash.
+ */
+
+static bool				/* O - `true` on success, `false` on error */
+store_open(store_t    *store,		/* I - Store */
+           const char *dir,		/* I - Store directory */
+           bool       create)		/* I - Create the store if needed? */
+{
+  FILE			*fp;		/* Index file */
+  char			filename[1024],	/* Index filename */
+			line[1024],	/* Line from index */
+			*ptr,		/* Pointer into line */
+			*end;		/* End of line */
+  unsigned long long	hash;		/* Hash of manifest */
+  store_version_t	*v;		/* Current version */
+
+
+  memset(store, 0, sizeof(store_t));
+
+  store->dir = dir;
+
+  snprintf(filename, sizeof(filename), "%s/index", dir);
+
+  if ((fp = fopen(filename, "r")) == NULL)
+  {
+    if (errno == ENOENT && create)
+    {
+      if (mkdir(dir, 0777) && errno != EEXIST)
+      {
+        fprintf(stderr, "codedoc: Unable to create store \"%s\": %s\n", dir, strerror(errno));
+        return (false);
+      }
+
+      return (true);
+    }
+
+    fprintf(stderr, "codedoc: Unable to open store \"%s\": %s\n", dir, strerror(errno));
+    return (false);
+  }
+
+  if (!fgets(line, sizeof(line), fp) || strcmp(line, "codedoc-store 1.0\n"))
+  {
+    fprintf(stderr, "codedoc: \"%s\" is not a store.\n", dir);
+    fclose(fp);
+    return (false);
+  }
+
+  while (fgets(line, sizeof(line), fp))
+  {
+    hash = strtoull(line, &ptr, 16);
+
+    if (*ptr != ' ' || !ptr[1] || (end = strchr(ptr, '\n')) == NULL)
+    {
+      fprintf(stderr, "codedoc: Bad index in store \"%s\".\n", dir);
+      fclose(fp);
+      store_close(store);
+      return (false);
+    }
+
+    *end = '\0';
+
+    if (store->num_versions >= store->alloc_versions)
+    {
+      store->alloc_versions += 16;
+
+      if ((v = realloc(store->versions, store->alloc_versions * sizeof(store_version_t))) == NULL)
+      {
+	fputs("codedoc: Unable to allocate memory for store index.\n", stderr);
+	exit(1);
+      }
+
+      store->versions = v;
+    }
+
+    v = store->versions + store->num_versions;
+
+    if ((v->name = strdup(ptr + 1)) == NULL)
+    {
+      fputs("codedoc: Unable to allocate memory for store index.\n", stderr);
+      exit(1);
+    }
+
+    v->manifest = hash;
+
+    store->num_versions ++;
+  }
+
+  fclose(fp);
+
+  return (true);
+}
+
+
+/*
+ * 'store_put()' - Save an object or rendered fragment in a store.
+ *
+ * Data that is already in the store is not written again.  When `verify` is
+ * `true` the existing data is compared to catch hash collisions.
+ */
+
+static bool				/* O - `true` on success, `false` on error */
+store_put(store_t            *store,	/* I - Store */
+          const char         *subdir,	/* I - "html" or "objects" */
+          unsigned long long hash,	/* I - Hash of data */
+          const char         *data,	/* I - Data */
+          size_t             length,	/* I - Length of data */
+          bool               verify)	/* I - Compare with existing data? */
+{
+  char		dirname[1024],		/* Directory for data */
+		filename[1024],		/* Filename */
+		tempname[1024],		/* Temporary filename */
+		*existing;		/* Existing data */
+  size_t	exlength;		/* Length of existing data */
+  FILE		*fp;			/* File */
+  bool		ret = true;		/* Return value */
+
+
+  if ((existing = store_get(store, subdir, hash, &exlength)) != NULL)
+  {
+    if (verify && (exlength != length || memcmp(existing, data, length)))
+    {
+      fprintf(stderr, "codedoc: Hash collision for %s/%016llx in store \"%s\".\n", subdir, hash, store->dir);
+      ret = false;
+    }
+
+    free(existing);
+
+    return (ret);
+  }
+
+  snprintf(dirname, sizeof(dirname), "%s/%s", store->dir, subdir);
+
+  if (mkdir(dirname, 0777) && errno != EEXIST)
+  {
+    fprintf(stderr, "codedoc: Unable to create directory \"%s\": %s\n", dirname, strerror(errno));
+    return (false);
+  }
+
+  snprintf(dirname, sizeof(dirname), "%s/%s/%02x", store->dir, subdir, (unsigned)(hash >> 56));
+
+  if (mkdir(dirname, 0777) && errno != EEXIST)
+  {
+    fprintf(stderr, "codedoc: Unable to create directory \"%s\": %s\n", dirname, strerror(errno));
+    return (false);
+  }
+
+  if (snprintf(filename, sizeof(filename), "%s/%014llx", dirname, hash & 0xffffffffffffffULL) >= (int)sizeof(filename) || snprintf(tempname, sizeof(tempname), "%s.%d", filename, (int)getpid()) >= (int)sizeof(tempname))
+  {
+    fprintf(stderr, "codedoc: Store directory \"%s\" is too long.\n", store->dir);
+    return (false);
+  }
+
+  if ((fp = fopen(tempname, "wb")) == NULL)
+  {
+    fprintf(stderr, "codedoc: Unable to create \"%s\": %s\n", tempname, strerror(errno));
+    return (false);
+  }
+
+  if ((length > 0 && fwrite(data, length, 1, fp) != 1) || fclose(fp))
+  {
+    fprintf(stderr, "codedoc: Unable to write \"%s\": %s\n", tempname, strerror(errno));
+    unlink(tempname);
+    return (false);
+  }
+
+  if (rename(tempname, filename))
+  {
+    fprintf(stderr, "codedoc: Unable to create \"%s\": %s\n", filename, strerror(errno));
+    unlink(tempname);
+    return (false);
+  }
+
+  return (true);
+}
+
+
+/*
+ * 'store_render()' - Render the symbols in a documentation tree using the
+ *                    fragments cached in a store.
+ *
+ * The cache key for each symbol combines the codedoc version, the symbol's XML,
+ * the progressive option, and which of the strings in the symbol are linked
+ * types, so a fragment is reused by every version where the symbol renders
+ * the same.  The fragments are passed to @link write_html@ like symbols from
+ * `--assemble`.
+ */
+
+static void
+store_render(store_t     *store,	/* I - Store */
+             mxml_node_t *doc,		/* I - XML documentation */
+             bool        progressive,	/* I - Defer symbol details? */
+             shard_t     *shard)	/* I - Rendered symbols */
+{
+  int		i;			/* Looping var */
+  FILE		*fp,			/* Rendered symbol */
+		*details = NULL;	/* Deferred details file */
+  mxml_options_t *options;		/* Save options */
+  mxml_node_t	*node,			/* Current symbol */
+		*text;			/* Current text node */
+  const char	*name,			/* Name of symbol */
+		*string;		/* Text string */
+  size_t	length;			/* Length of data */
+  char		*data,			/* Symbol XML or HTML */
+		links;			/* Link flags for text string */
+  unsigned long long key;		/* Cache key */
+  shard_entry_t	*entry;			/* Rendered symbol */
+  static const char * const kinds[] =	/* Kinds of symbols */
+  {
+    "class",
+    "function",
+    "typedef",
+    "struct",
+    "union",
+    "variable",
+    "enumeration"
+  };
+
+
+  if ((fp = tmpfile()) == NULL || (progressive && (details = tmpfile()) == NULL))
+  {
+    fprintf(stderr, "codedoc: Unable to create temporary file: %s\n", strerror(errno));
+    exit(1);
+  }
+
+ /*
+  * Collect the names of the types that write_element and write_typedef link
+  * to...
+  */
+
+  types_load(&Types, doc, OUTPUT_HTML);
+
+ /*
+  * Render or reuse each symbol...
+  */
+
+  options = mxmlOptionsNew();
+
+  mxmlOptionsSetWhitespaceCallback(options, ws_cb, /*cbdata*/NULL);
+  mxmlOptionsSetWrapMargin(options, 0);
+
+  for (i = 0; i < (int)(sizeof(kinds) / sizeof(kinds[0])); i ++)
+  {
+    for (node = find_public(doc, doc, kinds[i], NULL, OUTPUT_HTML); node; node = find_public(node, doc, kinds[i], NULL, OUTPUT_HTML))
+    {
+      if ((name = mxmlElementGetAttr(node, "name")) == NULL)
+        continue;
+
+      if ((data = mxmlSaveAllocString(node, options)) == NULL)
+      {
+        fputs("codedoc: Unable to allocate memory for store object.\n", stderr);
+        exit(1);
+      }
+
+      key = store_hash(0xcbf29ce484222325ULL, VERSION, sizeof(VERSION));
+      key = store_hash(key, data, strlen(data));
+      key = store_hash(key, progressive ? "P" : "-", 1);
+
+      free(data);
+
+      for (text = mxmlWalkNext(node, node, MXML_DESCEND_ALL); text; text = mxmlWalkNext(text, node, MXML_DESCEND_ALL))
+      {
+        if (mxmlGetType(text) != MXML_TYPE_TEXT || (string = mxmlGetText(text, NULL)) == NULL)
+          continue;
+
+        links = '0';
+        if (is_linked_type(doc, string, false, OUTPUT_HTML))
+          links += 1;
+        if (is_linked_type(doc, string, true, OUTPUT_HTML))
+          links += 2;
+
+        key = store_hash(key, &links, 1);
+      }
+
+      if ((data = store_get(store, "html", key, &length)) == NULL)
+      {
+       /*
+        * Not cached, render the symbol...
+        */
+
+        rewind(fp);
+
+        write_symbol(fp, OUTPUT_HTML, doc, node, details, NULL);
+
+        length = (size_t)ftell(fp);
+
+        rewind(fp);
+
+        if ((data = malloc(length + 1)) == NULL)
+        {
+          fputs("codedoc: Unable to allocate memory for rendered symbol.\n", stderr);
+          exit(1);
+        }
+
+        if (fread(data, 1, length, fp) != length)
+        {
+          fprintf(stderr, "codedoc: Unable to read temporary file: %s\n", strerror(errno));
+          exit(1);
+        }
+
+        store_put(store, "html", key, data, length, false);
+      }
+
+      entry = shard_add(shard, kinds[i], name, length);
+      memcpy(entry->data, data, length);
+
+      free(data);
+    }
+  }
+
+  qsort(shard->entries, shard->num_entries, sizeof(shard_entry_t), (int (*)(const void *, const void *))shard_compare);
+
+  mxmlOptionsDelete(options);
+  types_free(&Types);
+  fclose(fp);
+
+  if (details)
+    fclose(details);
+}
+
+
+/*
+ * 'stringbuf_append()' - Append a Unicode character to a string buffer.
+ */
+
+static int				/* O - 1 on success, 0 on failure */
+stringbuf_append(stringbuf_t *buffer,	/* I - String buffer */
+                 int         ch)	/* I - Character */
+{
+  if (ch < 0x80)
+  {
+    if (buffer->bufptr < (buffer->buffer + sizeof(buffer->buffer) - 1))
+    {
+      *(buffer->bufptr)++ = (char)ch;
+      return (1);
+    }
+  }
+  else if (ch < 0x800)
+  {
+    if (buffer->bufptr < (buffer->buffer + sizeof(buffer->buffer) - 2))
+    {
+      *(buffer->bufptr)++ = (char)(0xc0 | ((ch >> 6) & 0x1f));
+      *(buffer->bufptr)++ = (char)(0x80 | (ch & 0x3f));
+      return (1);
+    }
+  }
+  else if (ch < 0x10000)
+  {
+    if (buffer->bufptr < (buffer->buffer + sizeof(buffer->buffer) - 3))
+    {
+      *(buffer->bufptr)++ = (char)(0xe0 | ((ch >> 12) & 0x0f));
+      *(buffer->bufptr)++ = (char)(0x80 | ((ch >> 6) & 0x3f));
+      *(buffer->bufptr)++ = (char)(0x80 | (ch & 0x3f));
+      return (1);
+    }
+  }
+  else
+  {
+    if (buffer->bufptr < (buffer->buffer + sizeof(buffer->buffer) - 4))
+    {
+      *(buffer->bufptr)++ = (char)(0xf0 | ((ch >> 18) & 0x07));
+      *(buffer->bufptr)++ = (char)(0x80 | ((ch >> 12) & 0x3f));
+      *(buffer->bufptr)++ = (char)(0x80 | ((ch >> 6) & 0x3f));
+      *(buffer->bufptr)++ = (char)(0x80 | (ch & 0x3f));
+      return (1);
+    }
+  }
+
+  return (0);
+}
+
+
+/*
+ * 'stringbuf_clear()' - Clear a string buffer.
+ */
+
+static void
+stringbuf_clear(stringbuf_t *buffer)	/* I - String buffer */
+{
+  buffer->bufptr = buffer->buffer;
+}
+
+
+/*
+ * 'stringbuf_get()' - Get a C string of a string buffer.
+ */
+
+static char *				/* O - C string */
+stringbuf_get(stringbuf_t *buffer)	/* I - String buffer */
+{
+  *(buffer->bufptr) = '\0';
+
+  return (buffer->buffer);
+}
+
+
+/*
+ * 'stringbuf_getlast()' - Get the last character in a string buffer.
+ */
+
+static int				/* O - Last character or EOF */
+stringbuf_getlast(stringbuf_t *buffer)	/* I - String buffer */
+{
+  if (buffer->bufptr > buffer->buffer)
+    return (buffer->bufptr[-1]);
+  else
+    return (EOF);
+}
+
+
+/*
+ * 'stringbuf_length()' - Get the length of the string buffer.
+ */
+
+static size_t				/* O - Length of string buffer */
+stringbuf_length(stringbuf_t *buffer)	/* I - String buffer */
+{
+  return (buffer->bufptr - buffer->buffer);
+}
+
+
+/*
+ * 'type_cb()' - Set the type of child nodes.
+ */
+
+static mxml_type_t			/* O - Node type */
+type_cb(void        *cbdata,		/* I - Callback data (unused) */
+        mxml_node_t *node)		/* I - Node */
+{
+  (void)cbdata;
+
+  if (mxmlGetType(node) == MXML_TYPE_ELEMENT && !strcmp(mxmlGetElement(node), "description"))
+    return (MXML_TYPE_OPAQUE);
+  else
+    return (MXML_TYPE_TEXT);
+}
+
+
+/*
+ * 'types_free()' - Free the names of linked types.
+ */
+
+static void
+types_free(types_t *types)		/* I - Names of types */
+{
+  free(types->all);
+  free(types->pub);
+
+  memset(types, 0, sizeof(types_t));
+}
+
+
+/*
+ * 'types_load()' - Collect the sorted names of the types that are linked in
+ *                  a documentation tree.
+ *
+ * Looking up each word of a type or declaration in the tree is linear in the
+ * number of symbols, so the writers collect the names once and use
+ * @link is_linked_type@ instead.  The names are only valid until the tree is
+ * changed.
+ */
+
+static void
+types_load(types_t     *types,		/* I - Names of types */
+           mxml_node_t *doc,		/* I - Documentation tree */
+           int         mode)		/* I - Output mode for public types */
+{
+  int		i;			/* Looping var */
+  mxml_node_t	*node;			/* Current node */
+  const char	*name;			/* Name of type */
+  size_t	alloc_names = 0;	/* Allocated names */
+  static const char * const kinds[] =	/* Kinds of linked types */
+  {
+    "class",
+    "enumeration",
+    "struct",
+    "typedef",
+    "union"
+  };
+
+
+  types_free(types);
+
+  types->doc  = doc;
+  types->mode = mode;
+
+  for (i = 0; i < (int)(sizeof(kinds) / sizeof(kinds[0])); i ++)
+  {
+    for (node = mxmlFindElement(doc, doc, kinds[i], NULL, NULL, MXML_DESCEND_ALL); node; node = mxmlFindElement(node, doc, kinds[i], NULL, NULL, MXML_DESCEND_ALL))
+    {
+      if ((name = mxmlElementGetAttr(node, "name")) == NULL)
+        continue;
+
+      if (types->num_all >= alloc_names)
+      {
+        alloc_names += 1024;
+
+        if ((types->all = realloc(types->all, alloc_names * sizeof(const char *))) == NULL || (types->pub = realloc(types->pub, alloc_names * sizeof(const char *))) == NULL)
+        {
+          fputs("codedoc: Unable to allocate memory for type names.\n", stderr);
+          exit(1);
+        }
+      }
+
+      types->all[types->num_all ++] = name;
+    }
+
+    for (node = find_public(doc, doc, kinds[i], NULL, mode); node; node = find_public(node, doc, kinds[i], NULL, mode))
+    {
+      if ((name = mxmlElementGetAttr(node, "name")) != NULL)
+        types->pub[types->num_pub ++] = name;
+    }
+  }
+
+  if (types->num_all > 1)
+    qsort(types->all, types->num_all, sizeof(const char *), (int (*)(const void *, const void *))reserved_compare);
+  if (types->num_pub > 1)
+    qsort(types->pub, types->num_pub, sizeof(const char *), (int (*)(const void *, const void *))reserved_compare);
+}
+
+
+/*
+ * 'update_comment()' - Update a comment node.
+ */
+
+static void
+update_comment(mxml_node_t *parent,	/* I - Parent node */
+               mxml_node_t *comment)	/* I - Comment node */
+{
+  char	*s,				/* Copy of comment */
+  	*ptr;				/* Pointer into comment */
+
+
+  DEBUG_printf("    update_comment(parent=%p, comment=%p)\n", parent, comment);
+
+ /*
+  * Range check the input...
+  */
+
+  if (!parent || !comment)
+    return;
+
+ /*
+  * Convert "\/" to "/"...
+  */
+
+  s = strdup(mxmlGetOpaque(comment));
+
+  for (ptr = strstr(s, "\\/"); ptr; ptr = strstr(ptr, "\\/"))
+    safe_strcpy(ptr, ptr + 1);
+
+ /*
+  * Remove leading spaces...
+  */
+
+  for (ptr = s; *ptr && isspace(*ptr & 255); ptr ++)
+    ;					// Skip leading spaces
+
+  if (ptr > s)
+    safe_strcpy(s, ptr);
+
+ /*
+  * Update the comment...
+  */
+
+  ptr = s;
+
+  if (*ptr == '\'')
+  {
+   /*
+    * Convert "'name()' - description" to "description".
+    */
+
+    DEBUG_puts("        found quote");
+    for (ptr ++; *ptr && *ptr != '\'' && *ptr != '('; ptr ++)
+      ;					// Look for end quote
+
+    if (*ptr == '(' && ptr[1] == ')' && ptr[2] == '\'')
+    {
+      DEBUG_printf("        comment after quote: %s\n", ptr + 3);
+      ptr += 3;
+      while (isspace(*ptr & 255))
+        ptr ++;
+
+      if (*ptr == '-')
+        ptr ++;
+
+      while (isspace(*ptr & 255))
+        ptr ++;
+
+      safe_strcpy(s, ptr);
+    }
+  }
+  else if (!strncmp(ptr, "I ", 2) || !strncmp(ptr, "O ", 2) || !strncmp(ptr, "IO ", 3))
+  {
+   /*
+    * 'Convert "I - description", "IO - description", or "O - description"
+    * to description + direction attribute.
+    */
+
+    ptr = strchr(ptr, ' ');
+    *ptr++ = '\0';
+
+    if (!strcmp(mxmlGetElement(parent), "argument"))
+      mxmlElementSetAttr(parent, "direction", s);
+
+    while (isspace(*ptr & 255))
+      ptr ++;
+
+    if (*ptr == '-')
+      ptr ++;
+
+    while (isspace(*ptr & 255))
+      ptr ++;
+
+    safe_strcpy(s, ptr);
+  }
+
+ /*
+  * Eliminate leading and trailing *'s...
+  */
+
+  for (ptr = s; *ptr == '*'; ptr ++)
+    ;					// Skip leading *
+
+  for (; isspace(*ptr & 255); ptr ++)
+    ;					// Skip leading whitespace
+
+  if (ptr > s)
+    safe_strcpy(s, ptr);
+
+  for (ptr = s + strlen(s) - 1; ptr > s && *ptr == '*'; ptr --)
+    *ptr = '\0';
+  for (; ptr > s && isspace(*ptr & 255); ptr --)
+    *ptr = '\0';
+
+  DEBUG_printf("        updated comment = %s\n", s);
+
+  mxmlSetOpaque(comment, s);
+  free(s);
+}
+
+
+/*
+ * 'usage()' - Show program usage...
+ */
+
+static void
+usage(const char *option)		/* I - Unknown option */
+{
+  if (option)
+    printf("codedoc: Bad option \"%s\".\n\n", option);
+
+  puts("Usage: codedoc [options] [filename.xml] [source files] >filename.html");
+  puts("       codedoc [options] [filename.xml] [source files] --epub filename.epub");
+  puts("       codedoc [options] [filename.xml] [source files] --man name >name.3");
+  puts("");
+  puts("Options:");
+  puts("    --assemble filename        Use symbols rendered by --shard (HTML)");
+  puts("    --author \"name\"            Set author name");
+  puts("    --batch manifest           Generate the documentation listed in a manifest");
+  puts("    --body filename            Set body file (markdown supported)");
+  puts("    --copyright \"text\"         Set copyright text");
+  puts("    --coverimage filename.png  Set cover image (EPUB, HTML)");
+  puts("    --css filename.css         Set CSS stylesheet file (EPUB, HTML)");
+  puts("    --css-out directory        Write shared CSS stylesheet to directory (HTML)");
+  puts("    --docversion \"version\"     Set documentation version");
+  puts("    --epub filename.epub       Generate EPUB file");
+  puts("    --footer filename          Set footer file (markdown supported)");
+  puts("    --header filename          Set header file (markdown supported)");
+  puts("    --index                    Write a symbol index for the XML file");
+  puts("    --jobs N                   Set maximum number of parallel jobs");
+  puts("    --language ll[-LOC]        Set ISO language and locality code (EPUB, HTML)");
+  puts("    --lookup name              Show the man page for a symbol in the XML file");
+  puts("    --man name                 Generate man page");
+  puts("    --matrix                   Show when symbols changed in --store (HTML)");
+  puts("    --max-memory SIZE          Set maximum memory for scanned symbols (XML)");
+  puts("    --minify                   Remove optional whitespace (EPUB, HTML)");
+  puts("    --no-output                Do not generate documentation file");
+  puts("    --progressive              Load symbol details on demand (HTML)");
+  puts("    --release                  Use maximum compression (EPUB)");
+  puts("    --rsyncable                Make compressed output rsync-friendly (EPUB)");
+  puts("    --section \"section\"        Set section name");
+  puts("    --shard N/COUNT            Render one shard of the symbols (HTML)");
+  puts("    --stats                    Show timing and allocation statistics");
+  puts("    --stdin-name filename      Scan source file(s) from the standard input");
+  puts("    --store directory          Add to or render from a versioned store (HTML)");
+  puts("    --title \"title\"            Set documentation title");
+  puts("    --version                  Show codedoc version");
+
+  exit(1);
+}
+
+
+/*
+ * 'walk_next()' - Return the next node in a walk of a documentation tree.
+ *
+ * This is the XML counterpart of `mmdWalkNext`: each node is returned once with
+ * "walk" set to `WALK_ENTER` before its children and once with `WALK_EXIT`
+ * after them, without recursion.  Set "walk" to `WALK_EXIT` to skip the
+ * children of the current node.
+ */
+
+static mxml_node_t *			/* O - Next node or `NULL` at the end */
+walk_next(mxml_node_t *node,		/* I - Current node */
+          mxml_node_t *top,		/* I - Top node */
+          int         *walk)		/* IO - Walk event for current/next node */
+{
+  mxml_node_t	*next;			/* Next node */
+
+
+  if (*walk == WALK_ENTER)
+  {
+    if ((next = mxmlGetFirstChild(node)) != NULL)
+      return (next);
+
+    *walk = WALK_EXIT;
+    return (node);
+  }
+
+  if (node == top)
+    return (NULL);
+
+  if ((next = mxmlGetNextSibling(node)) != NULL)
+  {
+    *walk = WALK_ENTER;
+    return (next);
+  }
+
+  return (mxmlGetParent(node));
+}
+
+
+/*
+ * 'write_css()' - Write the stylesheet.
+ */
+
+static void
+write_css(FILE       *out,		/* I - Output file */
+          int        mode,		/* I - HTML or EPUB/XHTML */
+          const char *cssfile)		/* I - Stylesheet file or `NULL` for default */
+{
+  if (cssfile)
+  {
+   /*
+    * Use custom stylesheet file...
+    */
+
+    write_file(out, cssfile, mode);
+  }
+  else
+  {
+   /*
+    * Use standard stylesheet...
+    */
+
+    fputs("body {\n"
+          "  background: white;\n"
+          "  color: black;\n"
+          "  font-family: sans-serif;\n"
+          "  font-size: 12pt;\n"
+          "}\n"
+          "a {\n"
+          "  color: black;\n"
+          "}\n"
+          "a:link, a:visited {\n"
+          "  color: #00f;\n"
+          "}\n"
+          "a:link:hover, a:visited:hover, a:active {\n"
+          "  color: #c0c;\n"
+          "}\n"
+          "body, p, h1, h2, h3, h4, h5, h6 {\n"
+	  "  font-family: sans-serif;\n"
+	  "  line-height: 1.4;\n"
+	  "}\n"
+	  "h1, h2, h3, h4, h5, h6 {\n"
+	  "  font-weight: bold;\n"
+	  "  page-break-inside: avoid;\n"
+	  "}\n"
+	  "h1 {\n"
+	  "  font-size: 250%;\n"
+	  "  margin: 0;\n"
+	  "}\n"
+	  "h2 {\n"
+	  "  font-size: 250%;\n"
+	  "  margin-top: 1.5em;\n"
+	  "}\n"
+	  "h3 {\n"
+	  "  font-size: 200%;\n"
+	  "  margin-bottom: 0.5em;\n"
+	  "  margin-top: 1.5em;\n"
+	  "}\n"
+	  "h4 {\n"
+	  "  font-size: 150%;\n"
+	  "  margin-bottom: 0.5em;\n"
+	  "  margin-top: 1.5em;\n"
+	  "}\n"
+	  "h5 {\n"
+	  "  font-size: 125%;\n"
+	  "  margin-bottom: 0.5em;\n"
+	  "  margin-top: 1.5em;\n"
+	  "}\n"
+	  "h6 {\n"
+	  "  font-size: 110%;\n"
+	  "  margin-bottom: 0.5em;\n"
+	  "  margin-top: 1.5em;\n"
+	  "}\n"
+	  "img.title {\n"
+	  "  width: 256px;\n"
+	  "}\n"
+	  "div.header h1, div.header p {\n"
+	  "  text-align: center;\n"
+	  "}\n"
+	  "div.contents, div.body, div.footer {\n"
+	  "  page-break-before: always;\n"
+	  "}\n"
+	  ".class, .enumeration, .function, .struct, .typedef, .union {\n"
+	  "  border-bottom: solid 2px gray;\n"
+	  "}\n"
+	  ".description {\n"
+	  "  margin-top: 0.5em;\n"
+	  "}\n"
+	  ".function {\n"
+	  "  margin-bottom: 0;\n"
+	  "}\n"
+	  "blockquote {\n"
+	  "  border: solid thin gray;\n"
+	  "  box-shadow: 3px 3px 5px rgba(127,127,127,0.25);\n"
+	  "  margin: 1em 0;\n"
+	  "  padding: 10px;\n"
+	  "  page-break-inside: avoid;\n"
+          "}\n"
+          "blockquote :first-child {\n"
+          "  margin-top: 0;\n"
+          "}\n"
+          "blockquote :first-child {\n"
+          "  margin-bottom: 0;\n"
+          "}\n"
+	  "p code, li code, p.code, pre, ul.code li {\n"
+	  "  font-family: monospace;\n"
+	  "  hyphens: manual;\n"
+	  "  -webkit-hyphens: manual;\n"
+	  "}\n"
+	  "p.code, pre, ul.code li {\n"
+          "  background: rgba(127,127,127,0.25);\n"
+          "  border: thin dotted gray;\n"
+          "  padding: 10px;\n"
+	  "  page-break-inside: avoid;\n"
+	  "}\n"
+	  "pre {\n"
+	  "  white-space: pre-wrap;\n"
+	  "}\n"
+	  "a:link, a:visited {\n"
+	  "  text-decoration: none;\n"
+	  "}\n"
+	  "span.info {\n"
+	  "  background: black;\n"
+	  "  border: solid thin black;\n"
+	  "  color: white;\n"
+	  "  font-size: 80%;\n"
+	  "  font-style: italic;\n"
+	  "  font-weight: bold;\n"
+	  "  white-space: nowrap;\n"
+	  "}\n"
+	  "h1 span.info, h2 span.info, h3 span.info, h4 span.info {\n"
+	  "  border-top-left-radius: 10px;\n"
+	  "  border-top-right-radius: 10px;\n"
+	  "  float: right;\n"
+	  "  padding: 3px 6px;\n"
+	  "}\n"
+	  "ul.code, ul.contents, ul.subcontents {\n"
+	  "  list-style-type: none;\n"
+	  "  margin: 0;\n"
+	  "  padding-left: 0;\n"
+	  "}\n"
+	  "ul.code li {\n"
+	  "  margin: 0;\n"
+	  "}\n"
+	  "ul.contents > li {\n"
+	  "  margin-top: 1em;\n"
+	  "}\n"
 	  "ul.contents li ul.code, ul.contents li ul.subcontents {\n"
 	  "  padding-left: 2em;\n"
 	  "}\n"
@@ -7176,915 +11894,4235 @@ write_html_head(FILE       *out,	/* I - Output file */
 	  "  }\n"
 	  "}\n", out);
 
-    if (mode == OUTPUT_HTML)
-      fputs("/* Show contents on left side in web browser */\n"
-            "@media screen and (min-width: 800px) {\n"
-            "  div.contents {\n"
-            "    border-right: solid thin gray;\n"
-            "    bottom: 0px;\n"
-            "    box-shadow: 3px 3px 5px rgba(127,127,127,0.5);\n"
-            "    font-size: 10pt;\n"
-            "    left: 0px;\n"
-            "    overflow: scroll;\n"
-            "    padding: 1%;\n"
-            "    position: fixed;\n"
-            "    top: 0px;\n"
-            "    width: 18%;\n"
-            "  }\n"
-            "  div.contents h2.title {\n"
-            "    margin-top: 0px;\n"
-            "  }\n"
-            "  div.header, div.body, div.footer {\n"
-            "    margin-left: 20%;\n"
-            "    padding: 1% 2%;\n"
-            "  }\n"
-            "}\n"
-            "/* Center title page content vertically */\n"
-            "@media print {\n"
-            "  div.header {\n"
-            "    padding-top: 33%;\n"
-            "  }\n"
-            "}\n", out);
+    if (mode == OUTPUT_HTML)
+      fputs("/* Show contents on left side in web browser */\n"
+            "@media screen and (min-width: 800px) {\n"
+            "  div.contents {\n"
+            "    border-right: solid thin gray;\n"
+            "    bottom: 0px;\n"
+            "    box-shadow: 3px 3px 5px rgba(127,127,127,0.5);\n"
+            "    font-size: 10pt;\n"
+            "    left: 0px;\n"
+            "    overflow: scroll;\n"
+            "    padding: 1%;\n"
+            "    position: fixed;\n"
+            "    top: 0px;\n"
+            "    width: 18%;\n"
+            "  }\n"
+            "  div.contents h2.title {\n"
+            "    margin-top: 0px;\n"
+            "  }\n"
+            "  div.header, div.body, div.footer {\n"
+            "    margin-left: 20%;\n"
+            "    padding: 1% 2%;\n"
+            "  }\n"
+            "}\n"
+            "/* Center title page content vertically */\n"
+            "@media print {\n"
+            "  div.header {\n"
+            "    padding-top: 33%;\n"
+            "  }\n"
+            "}\n", out);
+  }
+}
+
+
+/*
+ * 'write_css_file()' - Write a shared stylesheet file with a content-hashed
+ *                      name.
+ *
+ * The stylesheet is named "codedoc-HASH.css" where HASH is the 64-bit FNV-1a
+ * hash of its contents, so that it is only written once and can be cached
+ * indefinitely by browsers and CDNs.
+ */
+
+static void
+write_css_file(const char *cssdir,	/* I - Output directory */
+               const char *docdir,	/* I - Directory containing the document */
+               int        mode,		/* I - HTML or EPUB/XHTML */
+               const char *cssfile,	/* I - Stylesheet file or `NULL` for default */
+               bool       minify,	/* I - Minify the stylesheet? */
+               char       *href,	/* I - Stylesheet URL buffer */
+               size_t     hrefsize)	/* I - Size of URL buffer */
+{
+  FILE		*fp;			/* Temporary/output file */
+  char		*css = NULL,		/* Stylesheet contents */
+		filename[1024],		/* Output filename */
+		tempname[1024],		/* Temporary filename */
+		relpath[1024];		/* Output directory relative to document */
+  size_t	csslen = 0;		/* Length of stylesheet */
+  long		length;			/* Length of temporary file */
+  unsigned long long hash = 0xcbf29ce484222325ULL;
+					/* FNV-1a hash */
+  const char	*cssptr;		/* Pointer into stylesheet */
+
+
+ /*
+  * Format the stylesheet...
+  */
+
+  if ((fp = tmpfile()) == NULL)
+  {
+    fprintf(stderr, "codedoc: Unable to create temporary file: %s\n", strerror(errno));
+    exit(1);
+  }
+
+  write_css(fp, mode, cssfile);
+
+  length = ftell(fp);
+
+  if ((css = malloc((size_t)length + 1)) == NULL)
+  {
+    fprintf(stderr, "codedoc: Unable to allocate memory for stylesheet.\n");
+    exit(1);
+  }
+
+  rewind(fp);
+  csslen      = fread(css, 1, (size_t)length, fp);
+  css[csslen] = '\0';
+
+  fclose(fp);
+
+  if (minify)
+    csslen = minify_css(css);
+
+ /*
+  * Compute the hash and filename...
+  */
+
+  for (cssptr = css; cssptr < (css + csslen); cssptr ++)
+  {
+    hash ^= (unsigned char)*cssptr;
+    hash *= 0x100000001b3ULL;
+  }
+
+  if (snprintf(filename, sizeof(filename), "%s/codedoc-%016llx.css", cssdir, hash) >= (int)sizeof(filename))
+  {
+    fprintf(stderr, "codedoc: Stylesheet directory \"%s\" is too long.\n", cssdir);
+    exit(1);
+  }
+
+  get_relative_path(docdir, cssdir, relpath, sizeof(relpath));
+
+  if (!strcmp(relpath, "."))
+    snprintf(href, hrefsize, "codedoc-%016llx.css", hash);
+  else
+    snprintf(href, hrefsize, "%s/codedoc-%016llx.css", relpath, hash);
+
+ /*
+  * Write the file if it doesn't already exist - the name depends only on the
+  * contents, so an existing file is already correct...
+  */
+
+  if (access(filename, R_OK))
+  {
+    if (snprintf(tempname, sizeof(tempname), "%s.%d", filename, (int)getpid()) >= (int)sizeof(tempname))
+    {
+      fprintf(stderr, "codedoc: Stylesheet directory \"%s\" is too long.\n", cssdir);
+      exit(1);
+    }
+
+    if ((fp = fopen(tempname, "w")) == NULL)
+    {
+      fprintf(stderr, "codedoc: Unable to create stylesheet \"%s\": %s\n", tempname, strerror(errno));
+      exit(1);
+    }
+
+    if (csslen > 0 && fwrite(css, csslen, 1, fp) != 1)
+    {
+      fprintf(stderr, "codedoc: Unable to write stylesheet \"%s\": %s\n", tempname, strerror(errno));
+      fclose(fp);
+      unlink(tempname);
+      exit(1);
+    }
+
+    fclose(fp);
+
+    if (rename(tempname, filename))
+    {
+      fprintf(stderr, "codedoc: Unable to create stylesheet \"%s\": %s\n", filename, strerror(errno));
+      unlink(tempname);
+      exit(1);
+    }
+  }
+
+  free(css);
+}
+
+
+/*
+ * 'write_description()' - Write the description text.
+ */
+
+static void
+write_description(
+    FILE        *out,			/* I - Output file */
+    int         mode,                   /* I - Output mode */
+    mxml_node_t *description,		/* I - Description node */
+    const char  *element,		/* I - HTML element, if any */
+    int         summary)		/* I - Show summary (-1 for all) */
+{
+  char	text[10240],			/* Text for description */
+        *start,				/* Start of code/link */
+	*ptr;				/* Pointer into text */
+  int	col,				/* Current column */
+	list = 0,			/* In a list? */
+	bq = 0;				/* In a block quote? */
+
+
+  if (!description)
+    return;
+
+  get_text(description, text, sizeof(text));
+
+  if (summary < 0)
+  {
+   /*
+    * When showing everything, point to the start of the description text...
+    */
+
+    ptr = text;
+  }
+  else
+  {
+    if ((ptr = strstr(text, "\n\n")) != NULL)
+      *ptr = '\0';
+
+    if (summary)
+      ptr = text;			/* Summary is the first paragraph */
+    else if (!ptr || !ptr[2])
+      return;				/* No long-form description */
+    else
+      ptr += 2;				/* Long-firm description after first */
+  }
+
+  if (element && *element)
+    fprintf(out, "<%s class=\"%s\">", element, summary ? "description" : "discussion");
+  else if (!summary)
+    fputs(".PP\n", out);
+
+  for (col = 0; *ptr; ptr ++)
+  {
+    if (col == 0 && !strncmp(ptr, "- ", 2))
+    {
+     /*
+      * Bullet list item...
+      */
+
+      ptr ++;
+
+      if (element)
+      {
+	if (!list)
+	{
+          if (!strcmp(element, "p"))
+	    fputs("</p>", out);
+
+	  fputs("<ul>\n", out);
+	  list = 1;
+	}
+	else
+	  fputs("</li>\n", out);
+
+	fputs("<li>", out);
+      }
+      else
+      {
+        list = 1;
+        fputs(".IP \\(bu 5\n", out);
+      }
+    }
+    else if (col == 0 && !strncmp(ptr, "> ", 2))
+    {
+     /*
+      * Block quote...
+      */
+
+      ptr ++;
+
+      if (element)
+      {
+	if (!bq)
+	{
+          if (!strcmp(element, "p"))
+	    fputs("</p>", out);
+
+	  fputs("<blockquote>\n", out);
+	  bq = 1;
+	}
+      }
+      else
+      {
+        bq = 1;
+        fputs(".IP 5\n", out);
+      }
+    }
+    else if (col == 0 && !strncmp(ptr, "```\n", 4))
+    {
+     /*
+      * Code fence...
+      */
+
+      ptr += 4;
+
+      if (element)
+        fputs("<pre>\n", out);
+      else
+        fputs(".nf\n", out);
+
+      while (*ptr && (col != 0 || (strncmp(ptr, "```\n", 4) && strcmp(ptr, "```"))))
+      {
+        if (col == 0 && !element)
+          fputs("    ", out);
+
+        if (col == 0 && *ptr == '|' && ptr[1])
+          ptr ++;
+
+	if (*ptr == '\n')
+	  col = 0;
+	else
+	  col ++;
+
+        if (*ptr == '\\' && ptr[1])
+          ptr ++;
+
+        if (element)
+        {
+	  if (*ptr == '&')
+	    fputs("&amp;", out);
+	  else if (*ptr == '<')
+	    fputs("&lt;", out);
+	  else if (*ptr == '>')
+	    fputs("&gt;", out);
+	  else if (*ptr == '\"')
+	    fputs("&quot;", out);
+	  else if (*ptr & 128)
+	  {
+	   /*
+	    * Convert utf-8 to Unicode constant...
+	    */
+
+	    int	ch;			/* Unicode character */
+
+
+	    ch = *ptr & 255;
+
+	    if ((ch & 0xe0) == 0xc0)
+	    {
+	      ch = ((ch & 0x1f) << 6) | (ptr[1] & 0x3f);
+	      ptr ++;
+	    }
+	    else if ((ch & 0xf0) == 0xe0)
+	    {
+	      ch = ((((ch * 0x0f) << 6) | (ptr[1] & 0x3f)) << 6) | (ptr[2] & 0x3f);
+	      ptr += 2;
+	    }
+
+	    fprintf(out, "&#%d;", ch);
+	  }
+	  else
+	    putc(*ptr, out);
+	}
+	else
+	{
+	  if (*ptr == '\\' || ((*ptr == '.' || *ptr == '\'') && col == 0))
+	    putc('\\', out);
+
+	  putc(*ptr, out);
+	}
+
+	ptr ++;
+      }
+
+      if (!strncmp(ptr, "```\n", 4))
+        ptr += 3;
+      else if (!strcmp(ptr, "```"))
+        ptr += 2;
+
+      col = 0;
+
+      if (element)
+        fputs("</pre>\n", out);
+      else
+        fputs("\n.fi\n", out);
+    }
+    else if (*ptr == '@' && (!strncmp(ptr + 1, "deprecated@", 11) || !strncmp(ptr + 1, "exclude ", 8) || !strncmp(ptr + 1, "since ", 6)))
+    {
+      ptr ++;
+      while (*ptr && *ptr != '@')
+        ptr ++;
+
+      if (!*ptr)
+        ptr --;
+    }
+    else if (!strncmp(ptr, "@code ", 6) || *ptr == '`')
+    {
+      char end = *ptr++;		/* Terminating character */
+
+      if (end != '`')
+      {
+        for (ptr += 5; isspace(*ptr & 255); ptr ++)
+          ;				// Skip whitespace after @code
+      }
+
+      for (start = ptr, ptr ++; *ptr && *ptr != end; ptr ++)
+        col ++;
+
+      if (*ptr)
+        *ptr = '\0';
+      else
+        ptr --;
+
+      if (element && *element)
+      {
+        fputs("<code>", out);
+        for (; *start; start ++)
+        {
+          if (*start == '<')
+            fputs("&lt;", out);
+          else if (*start == '>')
+            fputs("&gt;", out);
+          else if (*start == '&')
+            fputs("&amp;", out);
+          else
+            putc(*start, out);
+        }
+        fputs("</code>", out);
+      }
+      else if (element)
+        fputs(start, out);
+      else
+        fprintf(out, "\\fB%s\\fR", start);
+    }
+    else if (!strncmp(ptr, "@link ", 6))
+    {
+      for (ptr += 6; isspace(*ptr & 255); ptr ++)
+        ;				// Skip whitespace
+
+      for (start = ptr, ptr ++; *ptr && *ptr != '@'; ptr ++)
+        col ++;
+
+      if (*ptr)
+        *ptr = '\0';
+      else
+        ptr --;
+
+      if (element && *element)
+        fprintf(out, "<a href=\"#%s\"><code>%s</code></a>", start, start);
+      else if (element)
+        fputs(start, out);
+      else
+        fprintf(out, "\\fI%s\\fR", start);
+    }
+    else if (*ptr == '*' && strchr(ptr + 1, '*'))
+    {
+     /*
+      * Emphasized text...
+      */
+
+      int strong = (ptr[1] == '*' && strstr(ptr + 2, "**") != NULL);
+
+      while (*ptr == '*')
+        ptr ++;
+
+      for (start = ptr; *ptr && *ptr != '*'; ptr ++)
+        col ++;
+
+      if (*ptr)
+      {
+        *ptr = '\0';
+
+        while (ptr[1] == '*')
+          ptr ++;
+      }
+      else
+        ptr --;
+
+      if (element && *element)
+      {
+        if (strong)
+          fprintf(out, "<strong>%s</strong>", start);
+        else
+          fprintf(out, "<em>%s</em>", start);
+      }
+      else if (element)
+        fputs(start, out);
+      else if (strong)
+        fprintf(out, "\\fB%s\\fR", start);
+      else
+        fprintf(out, "\\fI%s\\fR", start);
+    }
+    else if (*ptr == '[' && strstr(ptr + 1, "](") != NULL)
+    {
+     /*
+      * Link...
+      */
+
+      char	*url = strstr(ptr + 1, "]("),
+					/* Pointer to URL */
+		*urlend = strchr(url + 1, ')');
+					/* Pointer to end of URL */
+      char	anchor[256];		/* Anchor for @ and @@ links */
+
+      if (!urlend)
+      {
+        putc('[', out);
+        continue;
+      }
+
+      start   = ptr + 1;
+      *url    = '\0';
+      url     += 2;
+      *urlend = '\0';
+
+      if (!strcmp(url, "@"))
+      {
+        // Support @ links to named headings...
+        const char *target = anchors_find(&Anchors, start);
+					// Heading anchor
+
+        anchor[0] = '#';
+        if (target)
+          strlcpy(anchor + 1, target, sizeof(anchor) - 1);
+        else
+          markdown_anchor(start, anchor + 1, sizeof(anchor) - 1);
+        url = anchor;
+      }
+      else if (!strcmp(url, "@@"))
+      {
+        // Support @@ links to named functions/types/etc...
+        snprintf(anchor, sizeof(anchor), "#%s", start);
+        url = anchor;
+      }
+
+      if (element)
+      {
+        fprintf(out, "<a href=\"%s\">", url);
+        write_string(out, start, mode, 0);
+        fputs("</a>", out);
+      }
+      else
+      {
+        fprintf(out, "\n.URL %s %s\n", url, start);
+      }
+
+      ptr = urlend;
+    }
+    else if (*ptr == '<' && strchr(ptr + 1, '>') != NULL)
+    {
+     /*
+      * Autolink...
+      */
+
+      char	*urlend = strchr(ptr + 1, '>');
+					/* Pointer to end of URL */
+
+      start   = ptr + 1;
+      *urlend = '\0';
+
+      if (element)
+      {
+        fprintf(out, "<a href=\"%s\">", start);
+        write_string(out, start, mode, 0);
+        fputs("</a>", out);
+      }
+      else
+      {
+        fprintf(out, "\n.URL %s %s\n", start, start);
+      }
+
+      ptr = urlend;
+    }
+    else if (element)
+    {
+      if (*ptr == '\n')
+      {
+        col = 0;
+        if (bq && strncmp(ptr + 1, "> ", 2))
+        {
+          bq = 0;
+          fputs("</blockquote>",out);
+        }
+      }
+      else
+        col ++;
+
+      if (*ptr == '\\' && ptr[1])
+        ptr ++;
+
+      if (*ptr == '&')
+        fputs("&amp;", out);
+      else if (*ptr == '<')
+        fputs("&lt;", out);
+      else if (*ptr == '>')
+        fputs("&gt;", out);
+      else if (*ptr == '\"')
+        fputs("&quot;", out);
+      else if (*ptr & 128)
+      {
+       /*
+        * Convert utf-8 to Unicode constant...
+        */
+
+        int	ch;			/* Unicode character */
+
+        ch = *ptr & 255;
+
+        if ((ch & 0xe0) == 0xc0)
+        {
+          ch = ((ch & 0x1f) << 6) | (ptr[1] & 0x3f);
+	  ptr ++;
+        }
+        else if ((ch & 0xf0) == 0xe0)
+        {
+          ch = ((((ch * 0x0f) << 6) | (ptr[1] & 0x3f)) << 6) | (ptr[2] & 0x3f);
+	  ptr += 2;
+        }
+
+        fprintf(out, "&#%d;", ch);
+      }
+      else if (*ptr == '\n' && ptr[1] == '\n' && ptr[2] && ptr[2] != '@' && strncmp(ptr + 2, "- ", 2) && strncmp(ptr + 2, "```\n", 4))
+      {
+        if (list)
+        {
+          list = 0;
+          fputs("</li>\n</ul>\n", out);
+          if (!strcmp(element, "p"))
+	    fprintf(out, "<%s class=\"%s\">", element, summary ? "description" : "discussion");
+        }
+        else
+          fprintf(out, "<br%s\n<br%s\n", renderers[mode].void_end, renderers[mode].void_end);
+        ptr ++;
+      }
+      else
+        putc(*ptr, out);
+    }
+    else if (*ptr == '\n' && ptr[1] == '\n' && ptr[2] && ptr[2] != '@')
+    {
+      list = 0;
+      fputs("\n.PP\n", out);
+      ptr ++;
+      col = 0;
+    }
+    else
+    {
+      if (*ptr == '\\' && ptr[1])
+        ptr ++;
+
+      if (*ptr == '\\' || ((*ptr == '.' || *ptr == '\'') && col == 0))
+        putc('\\', out);
+
+      putc(*ptr, out);
+
+      if (*ptr == '\n')
+      {
+        col = 0;
+        if (bq && strncmp(ptr + 1, "> ", 2))
+        {
+          bq = 0;
+          fputs(".PP\n", out);
+        }
+      }
+      else
+        col ++;
+    }
+  }
+
+  if (list)
+    fputs("</li>\n</ul>\n", out);
+  else if (bq && element)
+    fputs("</blockquote>\n", out);
+  else if (element && *element)
+  {
+    if (summary < 0)
+      fprintf(out, "</%s>", element);
+    else
+      fprintf(out, "</%s>\n", element);
+  }
+  else if (!element)
+    putc('\n', out);
+}
+
+
+/*
+ * 'write_details()' - Write a deferred detail chunk for progressive HTML.
+ *
+ * The HTML written to the detail file since @link start_details@ is
+ * compressed and written as Base64 in a placeholder "div" element that the
+ * script from @link write_html@ expands when the details are shown.  If the
+ * chunk cannot be compressed the details are written as-is.
+ */
+
+static void
+write_details(FILE       *out,		/* I - Output file */
+              FILE       *details,	/* I - Detail file or `NULL` */
+              const char *name)		/* I - Symbol name */
+{
+  long		length;			/* Length of details */
+  unsigned char	*html = NULL,		/* Detail HTML */
+		*data = NULL,		/* Compressed details */
+		*dataptr,		/* Pointer into compressed details */
+		*dataend;		/* End of compressed details */
+  uLongf	datalen;		/* Length of compressed details */
+  char		base64[5];		/* Base64 characters */
+  static const char *base64_chars =	/* Base64 alphabet */
+		"ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+
+  if (!details || (length = ftell(details)) <= 0)
+    return;
+
+  rewind(details);
+
+  if ((html = malloc((size_t)length)) == NULL)
+  {
+    fputs("codedoc: Unable to allocate memory for details.\n", stderr);
+    exit(1);
+  }
+
+  if (fread(html, 1, (size_t)length, details) != (size_t)length)
+  {
+    fprintf(stderr, "codedoc: Unable to read details: %s\n", strerror(errno));
+    exit(1);
+  }
+
+  datalen = compressBound((uLong)length);
+
+  if ((data = malloc(datalen)) == NULL || compress2(data, &datalen, html, (uLong)length, Z_BEST_COMPRESSION) != Z_OK)
+  {
+    fwrite(html, 1, (size_t)length, out);
+    free(html);
+    free(data);
+    return;
+  }
+
+  fputs("<div class=\"details\" data-for=\"", out);
+  write_string(out, name, OUTPUT_HTML, 0);
+  fputs("\" data-chunk=\"", out);
+
+  for (dataptr = data, dataend = data + datalen, base64[4] = '\0'; dataptr < dataend; dataptr += 3)
+  {
+    base64[0] = base64_chars[dataptr[0] >> 2];
+    base64[1] = base64_chars[((dataptr[0] & 3) << 4) | ((dataptr + 1) < dataend ? dataptr[1] >> 4 : 0)];
+    base64[2] = (dataptr + 1) < dataend ? base64_chars[((dataptr[1] & 15) << 2) | ((dataptr + 2) < dataend ? dataptr[2] >> 6 : 0)] : '=';
+    base64[3] = (dataptr + 2) < dataend ? base64_chars[dataptr[2] & 63] : '=';
+
+    fputs(base64, out);
+  }
+
+  fputs("\"></div>\n", out);
+
+  free(html);
+  free(data);
+}
+
+
+/*
+ * 'write_element()' - Write an element's text nodes.
+ */
+
+static void
+write_element(FILE        *out,		/* I - Output file */
+              mxml_node_t *doc,		/* I - Document tree */
+              mxml_node_t *element,	/* I - Element to write */
+              int         mode)		/* I - Output mode */
+{
+  mxml_node_t	*node;			/* Current node */
+  bool		whitespace;		/* Current whitespace value */
+  const char	*string;		/* Current string value */
+
+
+  if (!element)
+    return;
+
+  for (node = mxmlGetFirstChild(element); node; node = mxmlWalkNext(node, element, MXML_DESCEND_NONE))
+  {
+    if (mxmlGetType(node) == MXML_TYPE_TEXT)
+    {
+      string = mxmlGetText(node, &whitespace);
+
+      if (whitespace)
+	putc(' ', out);
+
+      if (renderers[mode].links && is_linked_type(doc, string, false, mode))
+      {
+        fputs("<a href=\"#", out);
+        write_string(out, string, mode, 0);
+	fputs("\">", out);
+        write_string(out, string, mode, 0);
+	fputs("</a>", out);
+      }
+      else if (renderers[mode].links && is_reserved(string))
+      {
+        fputs("<span class=\"reserved\">", out);
+        write_string(out, string, mode, 0);
+        fputs("</span>", out);
+      }
+      else
+      {
+        write_string(out, string, mode, 0);
+      }
+    }
+  }
+
+  if (!strcmp(mxmlGetElement(element), "type") && (string = mxmlGetText(mxmlGetLastChild(element), NULL)) != NULL && *string != '*')
+    putc(' ', out);
+}
+
+
+/*
+ * 'write_enumeration()' - Write an enumeration.
+ */
+
+static void
+write_enumeration(FILE        *out,	/* I - Output file */
+                  int         mode,	/* I - Output mode */
+                  mxml_node_t *doc,	/* I - Document */
+                  mxml_node_t *scut,	/* I - Enumeration */
+                  FILE        *details)	/* I - Detail file or `NULL` */
+{
+  FILE		*fp;			/* Output file for details */
+  mxml_node_t	*arg,			/* Current constant */
+		*description;		/* Description of enum/constant */
+  const char	*name;			/* Name of enumeration */
+
+
+  name        = mxmlElementGetAttr(scut, "name");
+  description = mxmlFindElement(scut, scut, "description", NULL, NULL, MXML_DESCEND_FIRST);
+  fprintf(out, "<h3 class=\"enumeration\"><a id=\"%s\">%s%s</a></h3>\n", name, get_comment_info(description), name);
+
+  if (description)
+    write_description(out, mode, description, "p", 1);
+
+  fp = start_details(out, details);
+
+  fputs("<h4 class=\"constants\">Constants</h4>\n"
+	"<table class=\"list\"><tbody>\n", fp);
+
+  for (arg = find_public(scut, scut, "constant", NULL, mode); arg; arg = find_public(arg, scut, "constant", NULL, mode))
+  {
+    description = mxmlFindElement(arg, arg, "description", NULL, NULL, MXML_DESCEND_FIRST);
+    fprintf(fp, "<tr><th>%s %s</th>", mxmlElementGetAttr(arg, "name"), get_comment_info(description));
+
+    write_description(fp, mode, description, "td", -1);
+    fputs("</tr>\n", fp);
+  }
+
+  fputs("</tbody></table>\n", fp);
+
+  write_details(out, details, name);
+}
+
+/*
+ * 'write_epub()' - Write documentation as an EPUB file.
+ */
+
+static void
+write_epub(const char  *epubfile,	/* I - EPUB file (output) */
+           const char  *section,	/* I - Section */
+           const char  *title,		/* I - Title */
+           const char  *author,		/* I - Author */
+           const char  *language,	/* I - Language */
+           const char  *copyright,	/* I - Copyright */
+           const char  *docversion,	/* I - Document version */
+           const char  *cssfile,	/* I - Stylesheet file */
+           const char  *coverimage,	/* I - Cover image file */
+           const char  *headerfile,	/* I - Header file */
+           const char  *bodyfile,	/* I - Body file */
+           mmd_t       *body,		/* I - Markdown body */
+           mxml_node_t *doc,		/* I - XML documentation */
+           const char  *footerfile,	/* I - Footer file */
+           bool        minify,		/* I - Minify XHTML? */
+           bool        rsyncable,	/* I - Use rsync-friendly compression? */
+           bool        release)		/* I - Use maximum compression? */
+{
+  int		status = 0;		/* Write status */
+  size_t	i;			/* Looping var */
+  FILE		*fp;			/* Output file */
+  char		epubbase[256],		/* Base name of EPUB file (identifier) */
+		*epubptr;		/* Pointer into base name */
+  zipc_t	*epub;			/* EPUB ZIP container */
+  zipc_file_t	*epubf;			/* File in EPUB ZIP container */
+  char		xhtmlfile[1024],	/* XHTML output filename */
+		*xhtmlptr;		/* Pointer into output filename */
+  mxml_node_t	*package_opf,		/* package_opf file */
+                *package,		/* package node */
+                *metadata,		/* metadata node */
+                *manifest,		/* manifest node */
+                *spine,			/* spine node */
+                *temp;			/* Other (leaf) node */
+  char		identifier[256],	/* dc:identifier string */
+		*package_opf_string;	/* package_opf file as a string */
+  mxml_options_t *options;		/* Save options */
+  toc_t		*toc;			/* Table of contents */
+  toc_entry_t	*tentry;		/* Current table of contents */
+  int		toc_level;		/* Current table-of-contents level */
+  mmd_t		*node;			/* Current markdown node */
+  mmd_walk_t	walk;			/* Walk event for current node */
+  mmd_t		*footer = NULL;		/* Markdown footer */
+  static const char *mimetype =		/* mimetype file as a string */
+		"application/epub+zip";
+  static const char *container_xml =	/* container.xml file as a string */
+		"<?xml version=\"1.0\" encoding=\"utf-8\"?>\n"
+                "<container xmlns=\"urn:oasis:names:tc:opendocument:xmlns:container\" version=\"1.0\">\n"
+                "  <rootfiles>\n"
+                "    <rootfile full-path=\"OEBPS/package.opf\" media-type=\"application/oebps-package+xml\"/>\n"
+                "  </rootfiles>\n"
+                "</container>\n";
+
+
+ /*
+  * Verify we have everything we need...
+  */
+
+  if (coverimage && access(coverimage, R_OK))
+  {
+    fprintf(stderr, "codedoc: Unable to open cover image \"%s\": %s\n", coverimage, strerror(errno));
+    exit(1);
+  }
+
+ /*
+  * Collect the names of linked types and the anchors for headings...
+  */
+
+  types_load(&Types, doc, OUTPUT_EPUB);
+
+  if (footerfile && is_markdown(footerfile) && (footer = markdown_load(NULL, footerfile)) == NULL)
+  {
+    fprintf(stderr, "codedoc: Unable to open \"%s\": %s\n", footerfile, strerror(errno));
+    exit(1);
+  }
+
+  anchors_load(&Anchors, body);
+  anchors_load(&Anchors, footer);
+
+ /*
+  * Write the XHTML content...
+  */
+
+  strlcpy(xhtmlfile, epubfile, sizeof(xhtmlfile));
+  if ((xhtmlptr = strstr(xhtmlfile, ".epub")) != NULL)
+    strlcpy(xhtmlptr, ".xhtml", sizeof(xhtmlfile) - (size_t)(xhtmlptr - xhtmlfile));
+  else
+    strlcat(xhtmlfile, ".xhtml", sizeof(xhtmlfile));
+
+  if ((fp = minify ? tmpfile() : fopen(xhtmlfile, "w")) == NULL)
+  {
+    fprintf(stderr, "codedoc: Unable to create temporary XHTML file \"%s\": %s\n", xhtmlfile, strerror(errno));
+    exit (1);
+  }
+
+ /*
+  * Standard header...
+  */
+
+  write_html_head(fp, OUTPUT_EPUB, section, title, author, language, copyright, docversion, cssfile, /*cssdir*/NULL, /*docdir*/NULL, minify);
+
+ /*
+  * Header...
+  */
+
+  if (headerfile)
+  {
+   /*
+    * Use custom header...
+    */
+
+    write_file(fp, headerfile, OUTPUT_EPUB);
+  }
+  else
+  {
+   /*
+    * Use standard header...
+    */
+
+    fputs("<h1 class=\"title\">", fp);
+    write_string(fp, title, OUTPUT_EPUB, 0);
+    fputs("</h1>\n", fp);
+
+    if (author)
+    {
+      fputs("<p>", fp);
+      write_string(fp, author, OUTPUT_EPUB, 0);
+      fputs("</p>\n", fp);
+    }
+
+    if (copyright)
+    {
+      fputs("<p>", fp);
+      write_string(fp, copyright, OUTPUT_EPUB, 0);
+      fputs("</p>\n", fp);
+    }
+  }
+
+ /*
+  * Body...
+  */
+
+  fputs("<div class=\"body\">\n", fp);
+
+  write_html_body(fp, OUTPUT_EPUB, bodyfile, body, doc, NULL, NULL);
+
+ /*
+  * Footer...
+  */
+
+  if (footerfile)
+  {
+   /*
+    * Use custom footer...
+    */
+
+    if (footer)
+      markdown_write_block(fp, footer, OUTPUT_EPUB);
+    else
+      write_file(fp, footerfile, OUTPUT_EPUB);
+  }
+
+  fputs("</div>\n"
+        "</body>\n"
+        "</html>\n", fp);
+
+ /*
+  * Close XHTML file...
+  */
+
+  if (minify)
+  {
+    FILE *mfp;				/* Minified XHTML file */
+
+    if ((mfp = fopen(xhtmlfile, "w")) == NULL)
+    {
+      fprintf(stderr, "codedoc: Unable to create temporary XHTML file \"%s\": %s\n", xhtmlfile, strerror(errno));
+      exit (1);
+    }
+
+    minify_html(fp, mfp);
+    fclose(mfp);
+  }
+
+  fclose(fp);
+
+ /*
+  * Make the EPUB archive...
+  */
+
+  if ((epub = zipcOpen(epubfile, "w")) == NULL)
+  {
+    fprintf(stderr, "codedoc: Unable to create \"%s\": %s\n", epubfile, strerror(errno));
+    unlink(xhtmlfile);
+    exit(1);
+  }
+
+  zipcSetMaxCompression(epub, release);
+  zipcSetRsyncable(epub, rsyncable);
+
+ /*
+  * Add the mimetype file...
+  */
+
+  status |= zipcCreateFileWithString(epub, "mimetype", mimetype);
+
+ /*
+  * The META-INF/ directory...
+  */
+
+  status |= zipcCreateDirectory(epub, "META-INF/");
+
+ /*
+  * The META-INF/container.xml file...
+  */
+
+  if ((epubf = zipcCreateFile(epub, "META-INF/container.xml", 1)) != NULL)
+  {
+    status |= zipcFilePuts(epubf, container_xml);
+    status |= zipcFileFinish(epubf);
+  }
+  else
+    status = -1;
+
+ /*
+  * The OEBPS/ directory...
+  */
+
+  status |= zipcCreateDirectory(epub, "OEBPS/");
+
+ /*
+  * Copy the OEBPS/body.xhtml file...
+  */
+
+  status |= zipcCopyFile(epub, "OEBPS/body.xhtml", xhtmlfile, 1, 1);
+
+  unlink(xhtmlfile);
+
+ /*
+  * Add images...
+  */
+
+  if (coverimage)
+    status |= zipcCopyFile(epub, "OEBPS/cover.png", coverimage, 0, 0);
+
+  for (node = body, walk = MMD_WALK_ENTER; node; node = mmdWalkNext(node, body, &walk))
+  {
+    const char	*url = mmdGetURL(node);	/* URL for node */
+
+    if (walk == MMD_WALK_ENTER && mmdGetType(node) == MMD_TYPE_IMAGE && url && strncmp(url, "http://", 7) && strncmp(url, "https://", 8))
+    {
+      // Image is a local file reference, strip any "#target" and copy it...
+      char	filename[1024],		/* Filename */
+		*sizespec,		/* Pointer to size specification, if any */
+		*name,			/* Base name of file */
+		oebpsname[1024];	/* Filename in EPUB file */
+
+      strncpy(filename, url, sizeof(filename) - 1);
+      filename[sizeof(filename) - 1] = '\0';
+
+      if ((sizespec = strstr(filename, " =")) != NULL)
+        *sizespec = '\0';
+
+      if ((name = strrchr(filename, '/')) != NULL)
+        name ++;
+      else
+        name = filename;
+
+      snprintf(oebpsname, sizeof(oebpsname), "OEBPS/%s", name);
+
+      status |= zipcCopyFile(epub, oebpsname, filename, 0, 0);
+    }
+  }
+
+ /*
+  * Now the OEBPS/package.opf file...
+  */
+
+  if ((epubptr = strrchr(epubfile, '/')) != NULL)
+    strlcpy(epubbase, epubptr + 1, sizeof(epubbase));
+  else
+    strlcpy(epubbase, epubfile, sizeof(epubbase));
+
+  if ((epubptr = strstr(epubbase, ".epub")) != NULL)
+    *epubptr = '\0';
+
+  package_opf = mxmlNewXML("1.0");
+
+  package = mxmlNewElement(package_opf, "package");
+  mxmlElementSetAttr(package, "xmlns", "http://www.idpf.org/2007/opf");
+  mxmlElementSetAttr(package, "unique-identifier", epubbase);
+  mxmlElementSetAttr(package, "version", "3.0");
+
+    metadata = mxmlNewElement(package, "metadata");
+    mxmlElementSetAttr(metadata, "xmlns:dc", "http://purl.org/dc/elements/1.1/");
+    mxmlElementSetAttr(metadata, "xmlns:opf", "http://www.idpf.org/2007/opf");
+
+      temp = mxmlNewElement(metadata, "dc:title");
+      mxmlNewOpaque(temp, title);
+
+      temp = mxmlNewElement(metadata, "dc:creator");
+      mxmlNewOpaque(temp, author);
+
+      temp = mxmlNewElement(metadata, "meta");
+      mxmlElementSetAttr(temp, "property", "dcterms:modified");
+      mxmlNewOpaque(temp, get_iso_date(time(NULL)));
+
+      temp = mxmlNewElement(metadata, "dc:language");
+      mxmlNewOpaque(temp, language);
+
+      temp = mxmlNewElement(metadata, "dc:rights");
+      mxmlNewOpaque(temp, copyright);
+
+      temp = mxmlNewElement(metadata, "dc:publisher");
+      mxmlNewOpaque(temp, "codedoc");
+
+      temp = mxmlNewElement(metadata, "dc:subject");
+      mxmlNewOpaque(temp, "Programming");
+
+      temp = mxmlNewElement(metadata, "dc:identifier");
+      mxmlElementSetAttr(temp, "id", epubbase);
+      snprintf(identifier, sizeof(identifier), "%s-%s", epubbase, docversion);
+      mxmlNewOpaque(temp, identifier);
+
+      if (coverimage)
+      {
+        temp = mxmlNewElement(metadata, "meta");
+        mxmlElementSetAttr(temp, "name", "cover");
+        mxmlElementSetAttr(temp, "content", "cover-image");
+      }
+
+    manifest = mxmlNewElement(package, "manifest");
+
+      temp = mxmlNewElement(manifest, "item");
+      mxmlElementSetAttr(temp, "id", "nav");
+      mxmlElementSetAttr(temp, "href", "nav.xhtml");
+      mxmlElementSetAttr(temp, "media-type", "application/xhtml+xml");
+      mxmlElementSetAttr(temp, "properties", "nav");
+
+      temp = mxmlNewElement(manifest, "item");
+      mxmlElementSetAttr(temp, "id", "body");
+      mxmlElementSetAttr(temp, "href", "body.xhtml");
+      mxmlElementSetAttr(temp, "media-type", "application/xhtml+xml");
+
+      if (coverimage)
+      {
+        temp = mxmlNewElement(manifest, "item");
+        mxmlElementSetAttr(temp, "id", "cover-image");
+        mxmlElementSetAttr(temp, "href", "cover.png");
+        mxmlElementSetAttr(temp, "media-type", "image/png");
+      }
+
+    spine = mxmlNewElement(package, "spine");
+
+      temp = mxmlNewElement(spine, "itemref");
+      mxmlElementSetAttr(temp, "idref", "body");
+
+  options = mxmlOptionsNew();
+  mxmlOptionsSetWhitespaceCallback(options, epub_ws_cb, /*cbdata*/NULL);
+
+  package_opf_string = mxmlSaveAllocString(package_opf, options);
+
+  mxmlOptionsDelete(options);
+
+  if ((epubf = zipcCreateFile(epub, "OEBPS/package.opf", 1)) != NULL)
+  {
+    status |= zipcFilePuts(epubf, package_opf_string);
+    status |= zipcFileFinish(epubf);
+  }
+  else
+    status = -1;
+
+  free(package_opf_string);
+
+ /*
+  * Then the OEBPS/nav.xhtml file...
+  */
+
+  if ((epubf = zipcCreateFile(epub, "OEBPS/nav.xhtml", 1)) != NULL)
+  {
+    toc = build_toc(doc, bodyfile, body, footerfile, footer, OUTPUT_EPUB);
+
+    zipcFilePrintf(epubf, "<?xml version=\"1.0\" encoding=\"utf-8\"?>\n"
+                          "<!DOCTYPE html>\n"
+                          "<html xmlns=\"http://www.w3.org/1999/xhtml\" xmlns:epub=\"http://www.idpf.org/2007/ops\">\n"
+                          "<head>\n"
+                          "<title>%s</title>\n"
+                          "<style>ol { list-style-type: none; }</style>\n"
+                          "</head>\n"
+                          "<body>\n"
+                          "<nav epub:type=\"toc\"><ol>\n", title);
+
+    for (i = 0, tentry = toc->entries, toc_level = 1; i < toc->num_entries; i ++, tentry ++)
+    {
+      if (tentry->level > toc_level)
+      {
+        toc_level = tentry->level;
+      }
+      else if (tentry->level < toc_level)
+      {
+        zipcFilePuts(epubf, "</ol></li>\n");
+        toc_level = tentry->level;
+      }
+
+      zipcFilePrintf(epubf, "<li><a href=\"body.xhtml#%s\">%s</a>", tentry->anchor, tentry->title);
+      if ((i + 1) < toc->num_entries && tentry[1].level > toc_level)
+        zipcFilePuts(epubf, "<ol>\n");
+      else
+        zipcFilePuts(epubf, "</li>\n");
+    }
+
+    if (toc_level == 2)
+      zipcFilePuts(epubf, "</ol></li>\n");
+
+    zipcFilePuts(epubf, "</ol></nav>\n"
+                        "</body>\n"
+                        "</html>\n");
+
+    zipcFileFinish(epubf);
+    free_toc(toc);
+  }
+  else
+    status = -1;
+
+  status |= zipcClose(epub);
+
+  types_free(&Types);
+  anchors_free(&Anchors);
+
+  if (footer)
+    mmdFree(footer);
+
+  if (status)
+  {
+    fprintf(stderr, "codedoc: Unable to write \"%s\": %s\n", epubfile, strerror(errno));
+    exit(1);
+  }
+}
+
+
+/*
+ * 'write_file()' - Copy a file to the output.
+ */
+
+static void
+write_file(FILE       *out,		/* I - Output file */
+           const char *file,		/* I - File to copy */
+           int        mode)		/* I - Output mode */
+{
+  if (is_markdown(file))
+  {
+   /*
+    * Convert markdown source to the output format...
+    */
+
+    mmd_t *mmd = markdown_load(NULL, file);	/* Markdown document */
+
+    if (mmd)
+    {
+      markdown_write_block(out, mmd, mode);
+      mmdFree(mmd);
+    }
+    else
+    {
+      fprintf(stderr, "codedoc: Unable to open \"%s\": %s\n", file, strerror(errno));
+      exit(1);
+    }
+  }
+  else
+  {
+   /*
+    * Copy non-markdown source...
+    */
+
+    FILE	*fp;			/* Copy file */
+    char	line[8192],		/* Line from file */
+		*ptr;			/* Pointer into line */
+
+    if ((fp = fopen(file, "r")) == NULL)
+    {
+      fprintf(stderr, "codedoc: Unable to open \"%s\": %s\n", file, strerror(errno));
+      exit(1);
+    }
+
+    while (fgets(line, sizeof(line), fp))
+    {
+      if (mode == OUTPUT_EPUB)
+      {
+       /*
+	* Convert common HTML named entities to XHTML numeric entities.
+	*/
+
+	for (ptr = line; *ptr; ptr ++)
+	{
+	  if (!strncmp(ptr, "&nbsp;", 6))
+	  {
+	    ptr += 5;
+	    fputs("&#160;", out);
+	  }
+	  else if (!strncmp(ptr, "&copy;", 6))
+	  {
+	    ptr += 5;
+	    fputs("&#169;", out);
+	  }
+	  else if (!strncmp(ptr, "&reg;", 5))
+	  {
+	    ptr += 4;
+	    fputs("&#174;", out);
+	  }
+	  else if (!strncmp(ptr, "&trade;", 7))
+	  {
+	    ptr += 6;
+	    fputs("&#8482;", out);
+	  }
+	  else
+	    fputc(*ptr, out);
+	}
+      }
+      else
+      {
+       /*
+	* Copy as-is...
+	*/
+
+	fputs(line, out);
+      }
+    }
+
+    fclose(fp);
+  }
+}
+
+
+/*
+ * 'write_function()' - Write documentation for a function.
+ */
+
+static void
+write_function(FILE        *out,	/* I - Output file */
+               int         mode,	/* I - Output mode */
+               mxml_node_t *doc,	/* I - Document */
+               mxml_node_t *function,	/* I - Function */
+	       int         level,	/* I - Base heading level */
+	       FILE        *details)	/* I - Detail file or `NULL` */
+{
+  FILE		*docout = out;		/* Document output file */
+  mxml_node_t	*arg,			/* Current argument */
+		*adesc,			/* Description of argument */
+		*description,		/* Description of function */
+		*type,			/* Type for argument */
+		*node;			/* Node in description */
+  const char	*name,			/* Name of function/type */
+		*defval;		/* Default value */
+  const char	*prefix;		/* Prefix string */
+  char		*sep;			/* Newline separator */
+
+
+  name        = mxmlElementGetAttr(function, "name");
+  description = mxmlFindElement(function, function, "description", NULL, NULL, MXML_DESCEND_FIRST);
+
+  fprintf(out, "<h%d class=\"%s\">%s<a id=\"%s\">%s</a></h%d>\n", level, level == 3 ? "function" : "method", get_comment_info(description), name, name, level);
+
+  if (description)
+    write_description(out, mode, description, "p", 1);
+
+  out = start_details(out, details);
+
+  fputs("<p class=\"code\">\n", out);
+
+  arg = mxmlFindElement(function, function, "returnvalue", NULL, NULL, MXML_DESCEND_FIRST);
+
+  if (arg)
+    write_element(out, doc, mxmlFindElement(arg, arg, "type", NULL, NULL, MXML_DESCEND_FIRST), OUTPUT_HTML);
+  else
+    fputs("<span class=\"reserved\">void</span> ", out);
+
+  fputs(name, out);
+  for (arg = mxmlFindElement(function, function, "argument", NULL, NULL, MXML_DESCEND_FIRST), prefix = "("; arg; arg = mxmlFindElement(arg, function, "argument", NULL, NULL, MXML_DESCEND_NONE), prefix = ", ")
+  {
+    type = mxmlFindElement(arg, arg, "type", NULL, NULL, MXML_DESCEND_FIRST);
+
+    fputs(prefix, out);
+    if (mxmlGetFirstChild(type))
+      write_element(out, doc, type, mode);
+
+    fputs(mxmlElementGetAttr(arg, "name"), out);
+    if ((defval = mxmlElementGetAttr(arg, "default")) != NULL)
+    {
+      if (!strncmp(defval, "= ", 2))
+        defval += 2;
+
+      if (isdigit(*defval) || *defval == '-' || *defval == '.')
+        fprintf(out, " = <span class=\"number\">%s</span>", defval);
+      else if (*defval == '\'' || *defval == '\"')
+        fprintf(out, " = <span class=\"string\">%s</span>", defval);
+      else
+	fprintf(out, " = %s", defval);
+    }
+  }
+
+  if (!strcmp(prefix, "("))
+    fputs("(<span class=\"reserved\">void</span>);</p>\n", out);
+  else
+  {
+    fprintf(out,
+            ");</p>\n"
+	    "<h%d class=\"parameters\">Parameters</h%d>\n"
+	    "<table class=\"list\"><tbody>\n", level + 1, level + 1);
+
+    for (arg = mxmlFindElement(function, function, "argument", NULL, NULL, MXML_DESCEND_FIRST); arg; arg = mxmlFindElement(arg, function, "argument", NULL, NULL, MXML_DESCEND_NONE))
+    {
+      fprintf(out, "<tr><th>%s</th>\n", mxmlElementGetAttr(arg, "name"));
+
+      adesc = mxmlFindElement(arg, arg, "description", NULL, NULL, MXML_DESCEND_FIRST);
+
+      write_description(out, mode, adesc, "td", -1);
+      fputs("</tr>\n", out);
+    }
+
+    fputs("</tbody></table>\n", out);
+  }
+
+  arg = mxmlFindElement(function, function, "returnvalue", NULL, NULL, MXML_DESCEND_FIRST);
+
+  if (arg)
+  {
+    fprintf(out, "<h%d class=\"returnvalue\">Return Value</h%d>\n", level + 1, level + 1);
+
+    adesc = mxmlFindElement(arg, arg, "description", NULL, NULL, MXML_DESCEND_FIRST);
+
+    write_description(out, mode, adesc, "p", 1);
+    write_description(out, mode, adesc, "p", 0);
+  }
+
+  if (description)
+  {
+    for (node = mxmlGetFirstChild(description); node; node = mxmlGetNextSibling(node))
+    {
+      const char *opaque = mxmlGetOpaque(node);
+
+      if (opaque && (sep = strstr(opaque, "\n\n")) != NULL)
+      {
+	sep += 2;
+	if (*sep && strncmp(sep, "@since ", 7) && strncmp(sep, "@deprecated@", 12))
+	  break;
+      }
+    }
+
+    if (node)
+    {
+      fprintf(out, "<h%d class=\"discussion\">Discussion</h%d>\n", level + 1, level + 1);
+      write_description(out, mode, description, "p", 0);
+    }
+  }
+
+  write_details(docout, details, name);
+}
+
+
+/*
+ * 'write_html()' - Write HTML documentation.
+ */
+
+static void
+write_html(const char  *section,	/* I - Section */
+	   const char  *title,		/* I - Title */
+           const char  *author,		/* I - Author's name */
+           const char  *language,	/* I - Language */
+           const char  *copyright,	/* I - Copyright string */
+	   const char  *docversion,	/* I - Documentation set version */
+	   const char  *cssfile,	/* I - Stylesheet file */
+	   const char  *cssdir,		/* I - Directory for shared stylesheet */
+	   const char  *docdir,		/* I - Directory containing the output */
+           const char  *coverimage,	/* I - Cover image file */
+	   const char  *headerfile,	/* I - Header file */
+	   const char  *bodyfile,	/* I - Body file */
+           mmd_t       *body,		/* I - Markdown body */
+	   mxml_node_t *doc,		/* I - XML documentation */
+           const char  *footerfile,	/* I - Footer file */
+           bool        minify,		/* I - Minify HTML? */
+           bool        progressive,	/* I - Defer symbol details? */
+           shard_t     *shard)		/* I - Symbols from other shards */
+{
+  FILE		*out,			/* Output file */
+		*details = NULL;	/* Deferred details file */
+  toc_t		*toc;			/* Table of contents */
+  mmd_t		*footer = NULL;		/* Markdown footer */
+
+
+ /*
+  * Minified output is written to a temporary file first...
+  */
+
+  if (!minify)
+  {
+    out = stdout;
+  }
+  else if ((out = tmpfile()) == NULL)
+  {
+    fprintf(stderr, "codedoc: Unable to create temporary file: %s\n", strerror(errno));
+    exit(1);
+  }
+
+  if (progressive && (details = tmpfile()) == NULL)
+  {
+    fprintf(stderr, "codedoc: Unable to create temporary file: %s\n", strerror(errno));
+    exit(1);
+  }
+
+ /*
+  * Collect the names of linked types and the anchors for headings, and create
+  * the table-of-contents entries...
+  */
+
+  types_load(&Types, doc, OUTPUT_HTML);
+
+  if (footerfile && is_markdown(footerfile) && (footer = markdown_load(NULL, footerfile)) == NULL)
+  {
+    fprintf(stderr, "codedoc: Unable to open \"%s\": %s\n", footerfile, strerror(errno));
+    exit(1);
+  }
+
+  anchors_load(&Anchors, body);
+  anchors_load(&Anchors, footer);
+
+  toc = build_toc(doc, bodyfile, body, footerfile, footer, OUTPUT_HTML);
+
+ /*
+  * Standard header...
+  */
+
+  write_html_head(out, OUTPUT_HTML, section, title, author, language, copyright, docversion, cssfile, cssdir, docdir, minify);
+
+  fputs("<div class=\"header\">\n", out);
+
+  if (coverimage)
+  {
+    const char	*coverbase;		/* Base name for cover image */
+
+    if ((coverbase = strrchr(coverimage, '/')) != NULL)
+      coverbase ++;
+    else
+      coverbase = coverimage;
+
+    fputs("<p><img class=\"title\" src=\"", out);
+    write_string(out, coverbase, OUTPUT_HTML, 0);
+    fputs("\"></p>\n", out);
+  }
+
+ /*
+  * Header...
+  */
+
+  if (headerfile)
+  {
+   /*
+    * Use custom header...
+    */
+
+    write_file(out, headerfile, OUTPUT_HTML);
+  }
+  else
+  {
+   /*
+    * Use standard header...
+    */
+
+    fputs("<h1 class=\"title\">", out);
+    write_string(out, title, OUTPUT_HTML, 0);
+    fputs("</h1>\n", out);
+
+    if (author)
+    {
+      fputs("<p>", out);
+      write_string(out, author, OUTPUT_HTML, 0);
+      fputs("</p>\n", out);
+    }
+
+    if (copyright)
+    {
+      fputs("<p>", out);
+      write_string(out, copyright, OUTPUT_HTML, 0);
+      fputs("</p>\n", out);
+    }
+  }
+
+  fputs("</div>\n", out);
+
+ /*
+  * Table of contents...
+  */
+
+  write_html_toc(out, title, toc, NULL, NULL);
+
+  free_toc(toc);
+
+ /*
+  * Body...
+  */
+
+  fputs("<div class=\"body\">\n", out);
+
+  write_html_body(out, OUTPUT_HTML, bodyfile, body, doc, details, shard);
+
+ /*
+  * Footer...
+  */
+
+  if (footerfile)
+  {
+   /*
+    * Use custom footer...
+    */
+
+    fputs("</div>\n"
+          "<div class=\"footer\">\n", out);
+
+    if (footer)
+      markdown_write_block(out, footer, OUTPUT_HTML);
+    else
+      write_file(out, footerfile, OUTPUT_HTML);
+  }
+
+  fputs("</div>\n", out);
+
+  if (details)
+  {
+   /*
+    * Script to expand deferred details as they scroll into view, when linked
+    * to, and before printing...
+    */
+
+    fputs("<script>\n"
+          "(function() {\n"
+          "  function expand(d) {\n"
+          "    if (!d.promise) {\n"
+          "      var s = atob(d.dataset.chunk), b = new Uint8Array(s.length), i;\n"
+          "      for (i = 0; i < s.length; i ++)\n"
+          "        b[i] = s.charCodeAt(i);\n"
+          "      d.promise = new Response(new Blob([b]).stream().pipeThrough(new DecompressionStream(\"deflate\"))).text().then(function(t) {\n"
+          "        d.insertAdjacentHTML(\"afterend\", t);\n"
+          "        d.remove();\n"
+          "      });\n"
+          "    }\n"
+          "    return (d.promise);\n"
+          "  }\n"
+          "  function show() {\n"
+          "    var id = decodeURIComponent(location.hash.substring(1)), d;\n"
+          "    if (id && (d = document.querySelector(\"div.details[data-for=\\\"\" + CSS.escape(id.split(\".\")[0]) + \"\\\"]\")) != null)\n"
+          "      expand(d).then(function() {\n"
+          "        var e = document.getElementById(id);\n"
+          "        if (e)\n"
+          "          e.scrollIntoView();\n"
+          "      });\n"
+          "  }\n"
+          "  var o = \"IntersectionObserver\" in window ? new IntersectionObserver(function(entries) {\n"
+          "    entries.forEach(function(e) {\n"
+          "      if (e.isIntersecting) {\n"
+          "        o.unobserve(e.target);\n"
+          "        expand(e.target);\n"
+          "      }\n"
+          "    });\n"
+          "  }, { rootMargin: \"100% 0px\" }) : null;\n"
+          "  document.querySelectorAll(\"div.details\").forEach(function(d) {\n"
+          "    if (o)\n"
+          "      o.observe(d);\n"
+          "    else\n"
+          "      expand(d);\n"
+          "  });\n"
+          "  addEventListener(\"hashchange\", show);\n"
+          "  addEventListener(\"beforeprint\", function() {\n"
+          "    document.querySelectorAll(\"div.details\").forEach(expand);\n"
+          "  });\n"
+          "  show();\n"
+          "})();\n"
+          "</script>\n", out);
+
+    fclose(details);
+  }
+
+  fputs("</body>\n"
+        "</html>\n", out);
+
+  if (minify)
+  {
+    minify_html(out, stdout);
+    fclose(out);
+  }
+
+  types_free(&Types);
+  anchors_free(&Anchors);
+
+  if (footer)
+    mmdFree(footer);
+}
+
+
+/*
+ * 'write_html_body()' - Write a HTML/XHTML body.
+ */
+
+static void
+write_html_body(
+    FILE        *out,			/* I - Output file */
+    int         mode,			/* I - HTML or EPUB/XHTML output */
+    const char  *bodyfile,		/* I - Body file */
+    mmd_t       *body,			/* I - Markdown body */
+    mxml_node_t *doc,			/* I - XML documentation */
+    FILE        *details,		/* I - Detail file or `NULL` */
+    shard_t     *shard)			/* I - Symbols from other shards or `NULL` */
+{
+  mxml_node_t	*function,		/* Current function */
+		*scut,			/* Struct/class/union/typedef */
+		*arg;			/* Current variable */
+
+
+ /*
+  * Body...
+  */
+
+  CODEDOC_PROBE2(render__start, "BODY", mode);
+
+  if (body)
+    markdown_write_block(out, body, mode);
+  else if (bodyfile)
+    write_file(out, bodyfile, mode);
+
+  CODEDOC_PROBE2(render__done, "BODY", mode);
+
+ /*
+  * List of classes...
+  */
+
+  if ((scut = find_public(doc, doc, "class", NULL, mode)) != NULL)
+  {
+    fputs("<h2 class=\"title\"><a id=\"CLASSES\">Classes</a></h2>\n", out);
+
+    CODEDOC_PROBE2(render__start, "CLASSES", mode);
+
+    while (scut)
+    {
+      write_symbol(out, mode, doc, scut, details, shard);
+
+      scut = find_public(scut, doc, "class", NULL, mode);
+    }
+
+    CODEDOC_PROBE2(render__done, "CLASSES", mode);
+  }
+
+ /*
+  * List of functions...
+  */
+
+  if ((function = find_public(doc, doc, "function", NULL, mode)) != NULL)
+  {
+    fputs("<h2 class=\"title\"><a id=\"FUNCTIONS\">Functions</a></h2>\n", out);
+
+    CODEDOC_PROBE2(render__start, "FUNCTIONS", mode);
+
+    while (function)
+    {
+      write_symbol(out, mode, doc, function, details, shard);
+
+      function = find_public(function, doc, "function", NULL, mode);
+    }
+
+    CODEDOC_PROBE2(render__done, "FUNCTIONS", mode);
+  }
+
+ /*
+  * List of types...
+  */
+
+  if ((scut = find_public(doc, doc, "typedef", NULL, mode)) != NULL)
+  {
+    fputs("<h2 class=\"title\"><a id=\"TYPES\">Data Types</a></h2>\n", out);
+
+    CODEDOC_PROBE2(render__start, "TYPES", mode);
+
+    while (scut)
+    {
+      write_symbol(out, mode, doc, scut, details, shard);
+
+      scut = find_public(scut, doc, "typedef", NULL, mode);
+    }
+
+    CODEDOC_PROBE2(render__done, "TYPES", mode);
+  }
+
+ /*
+  * List of structures...
+  */
+
+  if ((scut = find_public(doc, doc, "struct", NULL, mode)) != NULL)
+  {
+    fputs("<h2 class=\"title\"><a id=\"STRUCTURES\">Structures</a></h2>\n", out);
+
+    CODEDOC_PROBE2(render__start, "STRUCTURES", mode);
+
+    while (scut)
+    {
+      write_symbol(out, mode, doc, scut, details, shard);
+
+      scut = find_public(scut, doc, "struct", NULL, mode);
+    }
+
+    CODEDOC_PROBE2(render__done, "STRUCTURES", mode);
+  }
+
+ /*
+  * List of unions...
+  */
+
+  if ((scut = find_public(doc, doc, "union", NULL, mode)) != NULL)
+  {
+    fputs("<h2 class=\"title\"><a id=\"UNIONS\">Unions</a></h2>\n", out);
+
+    CODEDOC_PROBE2(render__start, "UNIONS", mode);
+
+    while (scut)
+    {
+      write_symbol(out, mode, doc, scut, details, shard);
+
+      scut = find_public(scut, doc, "union", NULL, mode);
+    }
+
+    CODEDOC_PROBE2(render__done, "UNIONS", mode);
+  }
+
+ /*
+  * Variables...
+  */
+
+  if ((arg = find_public(doc, doc, "variable", NULL, mode)) != NULL)
+  {
+    fputs("<h2 class=\"title\"><a id=\"VARIABLES\">Variables</a></h2>\n", out);
+
+    CODEDOC_PROBE2(render__start, "VARIABLES", mode);
+
+    while (arg)
+    {
+      write_symbol(out, mode, doc, arg, details, shard);
+
+      arg = find_public(arg, doc, "variable", NULL, mode);
+    }
+
+    CODEDOC_PROBE2(render__done, "VARIABLES", mode);
+  }
+
+ /*
+  * List of enumerations...
+  */
+
+  if ((scut = find_public(doc, doc, "enumeration", NULL, mode)) != NULL)
+  {
+    fputs("<h2 class=\"title\"><a id=\"ENUMERATIONS\">Constants</a></h2>\n", out);
+
+    CODEDOC_PROBE2(render__start, "ENUMERATIONS", mode);
+
+    while (scut)
+    {
+      write_symbol(out, mode, doc, scut, details, shard);
+
+      scut = find_public(scut, doc, "enumeration", NULL, mode);
+    }
+
+    CODEDOC_PROBE2(render__done, "ENUMERATIONS", mode);
+  }
+}
+
+
+/*
+ * 'write_html_head()' - Write the standard HTML header.
+ */
+
+static void
+write_html_head(FILE       *out,	/* I - Output file */
+                int        mode,	/* I - HTML or EPUB/XHTML */
+                const char *section,	/* I - Section */
+                const char *title,	/* I - Title */
+                const char *author,	/* I - Author's name */
+                const char *language,	/* I - Language */
+                const char *copyright,	/* I - Copyright string */
+                const char *docversion,	/* I - Document version string */
+		const char *cssfile,	/* I - Stylesheet */
+		const char *cssdir,	/* I - Directory for shared stylesheet or `NULL` */
+		const char *docdir,	/* I - Directory containing the output */
+		bool       minify)	/* I - Minify the shared stylesheet? */
+{
+  if (mode == OUTPUT_EPUB)
+    fprintf(out, "<?xml version=\"1.0\" encoding=\"utf-8\"?>\n"
+		 "<!DOCTYPE html>\n"
+		 "<html xmlns=\"http://www.w3.org/1999/xhtml\" xml:lang=\"%s\" "
+		 "lang=\"%s\">\n", language, language);
+  else
+    fprintf(out, "<!DOCTYPE html>\n"
+		 "<html lang=\"%s\">\n", language);
+
+  if (section)
+    fprintf(out, "<!-- SECTION: %s -->\n", section);
+
+  fputs("<head>\n"
+        "<title>", out);
+  write_string(out, title, mode, 0);
+  fputs("</title>\n", out);
+
+  if (mode == OUTPUT_EPUB)
+  {
+    if (section)
+      fprintf(out, "<meta name=\"keywords\" content=\"%s\" />\n", section);
+
+    fputs("<meta name=\"generator\" content=\"codedoc v" VERSION "\" />\n"
+          "<meta name=\"author\" content=\"", out);
+    write_string(out, author, mode, 0);
+    fprintf(out, "\" />\n"
+		 "<meta name=\"language\" content=\"%s\" />\n"
+		 "<meta name=\"copyright\" content=\"", language);
+    write_string(out, copyright, mode, 0);
+    fputs("\" />\n"
+          "<meta name=\"version\" content=\"", out);
+    write_string(out, docversion, mode, 0);
+    fputs("\" />\n", out);
+  }
+  else
+  {
+    if (section)
+      fprintf(out, "<meta name=\"keywords\" content=\"%s\">\n", section);
+
+    fputs("<meta http-equiv=\"Content-Type\" content=\"text/html;charset=utf-8\">\n"
+          "<meta name=\"generator\" content=\"codedoc v" VERSION "\">\n"
+          "<meta name=\"author\" content=\"", out);
+    write_string(out, author, mode, 0);
+    fprintf(out, "\">\n"
+		 "<meta name=\"language\" content=\"%s\">\n"
+		 "<meta name=\"copyright\" content=\"", language);
+    write_string(out, copyright, mode, 0);
+    fputs("\">\n"
+          "<meta name=\"version\" content=\"", out);
+    write_string(out, docversion, mode, 0);
+    fputs("\">\n", out);
+  }
+
+  if (cssdir)
+  {
+   /*
+    * Link to a shared, content-hashed copy of the stylesheet...
+    */
+
+    char	href[1024];		/* Stylesheet URL */
+
+    write_css_file(cssdir, docdir, mode, cssfile, minify, href, sizeof(href));
+
+    fputs("<link rel=\"stylesheet\" type=\"text/css\" href=\"", out);
+    write_string(out, href, mode, 0);
+    fputs(mode == OUTPUT_EPUB ? "\" />\n" : "\">\n", out);
+  }
+  else if (mode == OUTPUT_EPUB)
+  {
+    fputs("<style type=\"text/css\"><![CDATA[\n", out);
+    write_css(out, mode, cssfile);
+    fputs("]]></style>\n", out);
+  }
+  else
+  {
+    fputs("<style type=\"text/css\"><!--\n", out);
+    write_css(out, mode, cssfile);
+    fputs("--></style>\n", out);
+  }
+
+  fputs("</head>\n"
+        "<body>\n", out);
+}
+
+
+/*
+ * 'write_html_toc()' - Write a HTML table-of-contents.
+ */
+
+static void
+write_html_toc(FILE        *out,	/* I - Output file */
+               const char  *title,	/* I - Title */
+               toc_t       *toc,	/* I - Table of contents */
+               const char  *filename,	/* I - Target filename, if any */
+	       const char  *target)	/* I - Target frame name, if any */
+{
+  size_t	i;			/* Looping var */
+  toc_entry_t	*tentry;		/* Current table of contents */
+  int		toc_level;		/* Current table-of-contents level */
+  char		targetattr[1024];	/* Target attribute, if any */
+
+
+ /*
+  * If target is set, it is the frame file that contains the body.
+  * Otherwise, we are creating a single-file...
+  */
+
+  if (target)
+    snprintf(targetattr, sizeof(targetattr), " target=\"%s\"", target);
+  else
+    targetattr[0] = '\0';
+
+  fputs("<div class=\"contents\">\n", out);
+
+  if (filename)
+  {
+    fprintf(out, "<h1 class=\"title\"><a href=\"%s\"%s>", filename, targetattr);
+    write_string(out, title, OUTPUT_HTML, 0);
+    fputs("</a></h1>\n", out);
+  }
+
+  fputs("<h2 class=\"title\">Contents</h2>\n"
+        "<ul class=\"contents\">\n", out);
+
+  for (i = 0, tentry = toc->entries, toc_level = 1; i < toc->num_entries; i ++, tentry ++)
+  {
+    if (tentry->level > toc_level)
+    {
+      toc_level = tentry->level;
+    }
+    else if (tentry->level < toc_level)
+    {
+      fputs("</ul></li>\n", out);
+      toc_level = tentry->level;
+    }
+
+    fprintf(out, "<li><a href=\"%s#%s\"%s>", filename ? filename : "", tentry->anchor, targetattr);
+    write_string(out, tentry->title, OUTPUT_HTML, 0);
+
+    if ((i + 1) < toc->num_entries && tentry[1].level > toc_level)
+      fputs("</a><ul class=\"subcontents\">\n", out);
+    else
+      fputs("</a></li>\n", out);
+  }
+
+  if (toc_level == 2)
+    fputs("</ul></li>\n", out);
+
+  fputs("</ul>\n"
+        "</div>\n", out);
+}
+
+
+/*
+ * 'write_index()' - Write a symbol index for an XML documentation file.
+ *
+ * The index file ("FILENAME.idx") starts with the line
+ * "codedoc-index 1.0 SIZE", where SIZE is the length of the XML file, and is
+ * followed by a "NAME<tab>KIND<tab>OFFSET<tab>LENGTH" line for each symbol,
+ * sorted by name, giving the location of the symbol's record in the XML file.
+ * The index is used by @link lookup_symbol@.
+ */
+
+static bool				/* O - `true` on success, `false` on error */
+write_index(const char  *xmlfile,	/* I - XML documentation file */
+            mxml_node_t *codedoc)	/* I - codedoc node */
+{
+  char		*xml,			/* XML file contents */
+		*ptr,			/* Pointer into XML */
+		*end,			/* End of XML */
+		*tag,			/* Start of current tag */
+		*start = NULL,		/* Start of current record */
+		quote;			/* Quote character */
+  size_t	length,			/* Length of XML */
+		i,			/* Looping var */
+		num_entries = 0,	/* Number of index entries */
+		alloc_entries = 0;	/* Allocated index entries */
+  int		depth = 0,		/* Element depth */
+		error;			/* `errno` value */
+  mxml_node_t	*node;			/* Current symbol */
+  index_entry_t	*entries = NULL,	/* Index entries */
+		*entry;			/* Current entry */
+  char		filename[1024],		/* Index filename */
+		tempname[1024];		/* Temporary filename */
+  FILE		*fp;			/* Index file */
+
+
+  if ((error = filebuf_read(xmlfile, &xml, &length)) != 0)
+  {
+    fprintf(stderr, "codedoc: Unable to read the XML documentation file \"%s\": %s\n", xmlfile, filebuf_strerror(error));
+    return (false);
+  }
+
+ /*
+  * Find the records for the symbols in the codedoc node, in the same order as
+  * the tree...
+  */
+
+  node = mxmlGetFirstChild(codedoc);
+
+  for (ptr = xml, end = xml + length; ptr < end; ptr ++)
+  {
+    if (*ptr != '<')
+      continue;
+
+    if ((end - ptr) >= 4 && !memcmp(ptr, "<!--", 4))
+    {
+      for (ptr += 4; ptr < (end - 2) && memcmp(ptr, "-->", 3); ptr ++);
+      continue;
+    }
+    else if ((end - ptr) >= 9 && !memcmp(ptr, "<![CDATA[", 9))
+    {
+      for (ptr += 9; ptr < (end - 2) && memcmp(ptr, "]]>", 3); ptr ++);
+      continue;
+    }
+
+   /*
+    * Skip to the end of the tag, ignoring '>' in attribute values...
+    */
+
+    tag = ptr;
+
+    for (ptr ++, quote = '\0'; ptr < end && (quote || *ptr != '>'); ptr ++)
+    {
+      if (quote && *ptr == quote)
+        quote = '\0';
+      else if (!quote && (*ptr == '\"' || *ptr == '\''))
+        quote = *ptr;
+    }
+
+    if (ptr >= end || tag[1] == '?' || tag[1] == '!')
+      continue;
+
+    if (tag[1] == '/')
+    {
+      if (-- depth != 1 || !start)
+        continue;
+    }
+    else if (depth == 1)
+    {
+      start = tag;
+
+      if (ptr[-1] != '/')
+      {
+        depth ++;
+        continue;
+      }
+    }
+    else
+    {
+      if (ptr[-1] != '/')
+        depth ++;
+
+      continue;
+    }
+
+   /*
+    * End of a record - match it to the next symbol...
+    */
+
+    while (node && mxmlGetType(node) != MXML_TYPE_ELEMENT)
+      node = mxmlGetNextSibling(node);
+
+    if (!node)
+      break;
+
+    if (mxmlElementGetAttr(node, "name"))
+    {
+      if (num_entries >= alloc_entries)
+      {
+        alloc_entries += 1024;
+
+        if ((entry = realloc(entries, alloc_entries * sizeof(index_entry_t))) == NULL)
+        {
+	  fputs("codedoc: Unable to allocate memory for index.\n", stderr);
+	  exit(1);
+        }
+
+        entries = entry;
+      }
+
+      entry         = entries + num_entries;
+      entry->name   = mxmlElementGetAttr(node, "name");
+      entry->kind   = mxmlGetElement(node);
+      entry->offset = (size_t)(start - xml);
+      entry->length = (size_t)(ptr + 1 - start);
+
+      num_entries ++;
+    }
+
+    node  = mxmlGetNextSibling(node);
+    start = NULL;
+  }
+
+  free(xml);
+
+  while (node && mxmlGetType(node) != MXML_TYPE_ELEMENT)
+    node = mxmlGetNextSibling(node);
+
+  if (node || depth != 0)
+  {
+    fprintf(stderr, "codedoc: Unable to index the XML documentation file \"%s\".\n", xmlfile);
+    free(entries);
+    return (false);
+  }
+
+  if (num_entries > 1)
+    qsort(entries, num_entries, sizeof(index_entry_t), (int (*)(const void *, const void *))index_compare);
+
+ /*
+  * Write the index...
+  */
+
+  if (snprintf(filename, sizeof(filename), "%s.idx", xmlfile) >= (int)sizeof(filename) || snprintf(tempname, sizeof(tempname), "%s.%d", filename, (int)getpid()) >= (int)sizeof(tempname))
+  {
+    fprintf(stderr, "codedoc: XML documentation filename \"%s\" is too long.\n", xmlfile);
+    free(entries);
+    return (false);
+  }
+
+  if ((fp = fopen(tempname, "w")) == NULL)
+  {
+    fprintf(stderr, "codedoc: Unable to create index \"%s\": %s\n", tempname, strerror(errno));
+    free(entries);
+    return (false);
+  }
+
+  fprintf(fp, "codedoc-index 1.0 %lu\n", (unsigned long)length);
+
+  for (i = num_entries, entry = entries; i > 0; i --, entry ++)
+    fprintf(fp, "%s\t%s\t%lu\t%lu\n", entry->name, entry->kind, (unsigned long)entry->offset, (unsigned long)entry->length);
+
+  free(entries);
+
+  if (fclose(fp))
+  {
+    fprintf(stderr, "codedoc: Unable to write index \"%s\": %s\n", tempname, strerror(errno));
+    unlink(tempname);
+    return (false);
+  }
+
+  if (rename(tempname, filename))
+  {
+    fprintf(stderr, "codedoc: Unable to create index \"%s\": %s\n", filename, strerror(errno));
+    unlink(tempname);
+    return (false);
+  }
+
+  return (true);
+}
+
+
+/*
+ * 'write_man()' - Write manpage documentation.
+ */
+
+static void
+write_man(const char  *man_name,	/* I - Name of manpage */
+	  const char  *section,		/* I - Section */
+	  const char  *title,		/* I - Title */
+          const char  *author,		/* I - Author's name */
+          const char  *copyright,	/* I - Copyright string */
+	  const char  *headerfile,	/* I - Header file */
+	  const char  *bodyfile,	/* I - Body file */
+          mmd_t       *body,		/* I - Markdown body */
+	  mxml_node_t *doc,		/* I - XML documentation */
+	  const char  *footerfile)	/* I - Footer file */
+{
+  int		i;			/* Looping var */
+  mxml_node_t	*function,		/* Current function */
+		*scut,			/* Struct/class/union/typedef */
+		*arg,			/* Current argument */
+		*description,		/* Description of function/var */
+		*type;			/* Type for argument */
+  const char	*name,			/* Name of function/type */
+		*cname,			/* Class name */
+		*defval,		/* Default value */
+		*parent;		/* Parent class */
+  int		inscope;		/* Variable/method scope */
+  char		prefix;			/* Prefix character */
+  const char	*source_date_epoch;	/* SOURCE_DATE_EPOCH environment variable */
+  time_t	curtime;		/* Current time */
+  struct tm	curdate;		/* Current date */
+  char		buffer[1024];		/* String buffer */
+  bool		whitespace;		/* Current whitespace value */
+  const char	*string;		/* Current string value */
+  static const char * const scopes[] =	/* Scope strings */
+		{
+		  "private",
+		  "protected",
+		  "public"
+		};
+
+
+ /*
+  * Standard man page...
+  *
+  * Get the current date, using the SOURCE_DATE_EPOCH environment variable, if
+  * present, for the number of seconds since the epoch - this enables
+  * reproducible builds (Mini-XML Issue #193).
+  */
+
+  if ((source_date_epoch = getenv("SOURCE_DATE_EPOCH")) == NULL || (curtime = (time_t)strtol(source_date_epoch, NULL, 10)) <= 0)
+    curtime = time(NULL);
+
+  localtime_r(&curtime, &curdate);
+  snprintf(buffer, sizeof(buffer), "%04d-%02d-%02d", curdate.tm_year + 1900, curdate.tm_mon + 1, curdate.tm_mday);
+
+  printf(".TH %s %s \"%s\" \"%s\" \"%s\"\n", man_name, section ? section : "3",
+         title ? title : "", buffer, title ? title : "");
+
+ /*
+  * Header...
+  */
+
+  if (headerfile)
+  {
+   /*
+    * Use custom header...
+    */
+
+    write_file(stdout, headerfile, OUTPUT_MAN);
+  }
+  else
+  {
+   /*
+    * Use standard header...
+    */
+
+    puts(".SH NAME");
+    printf("%s \\- %s\n", man_name, title ? title : man_name);
+  }
+
+ /*
+  * Body...
+  */
+
+  CODEDOC_PROBE2(render__start, "BODY", OUTPUT_MAN);
+
+  if (body)
+    markdown_write_block(stdout, body, OUTPUT_MAN);
+  else if (bodyfile)
+    write_file(stdout, bodyfile, OUTPUT_MAN);
+
+  CODEDOC_PROBE2(render__done, "BODY", OUTPUT_MAN);
+
+ /*
+  * List of classes...
+  */
+
+  if (find_public(doc, doc, "class", NULL, OUTPUT_MAN))
+  {
+    puts(".SH CLASSES");
+
+    CODEDOC_PROBE2(render__start, "CLASSES", OUTPUT_MAN);
+
+    for (scut = find_public(doc, doc, "class", NULL, OUTPUT_MAN); scut; scut = find_public(scut, doc, "class", NULL, OUTPUT_MAN))
+    {
+      cname       = mxmlElementGetAttr(scut, "name");
+      description = mxmlFindElement(scut, scut, "description", NULL, NULL, MXML_DESCEND_FIRST);
+      printf(".SS %s\n", cname);
+
+      write_description(stdout, OUTPUT_MAN, description, NULL, 1);
+
+      printf(".PP\n"
+             ".nf\n"
+             "class %s", cname);
+      if ((parent = mxmlElementGetAttr(scut, "parent")) != NULL)
+        printf(" %s", parent);
+      puts("\n{");
+
+      for (i = 0; i < 3; i ++)
+      {
+        inscope = 0;
+
+	for (arg = mxmlFindElement(scut, scut, "variable", "scope", scopes[i], MXML_DESCEND_FIRST); arg; arg = mxmlFindElement(arg, scut, "variable", "scope", scopes[i], MXML_DESCEND_NONE))
+	{
+          if (!inscope)
+	  {
+	    inscope = 1;
+	    printf("  %s:\n", scopes[i]);
+	  }
+
+	  printf("    ");
+	  write_element(stdout, doc, mxmlFindElement(arg, arg, "type", NULL, NULL, MXML_DESCEND_FIRST), OUTPUT_MAN);
+	  printf("%s;\n", mxmlElementGetAttr(arg, "name"));
+	}
+
+	for (function = mxmlFindElement(scut, scut, "function", "scope", scopes[i], MXML_DESCEND_FIRST); function; function = mxmlFindElement(function, scut, "function", "scope", scopes[i], MXML_DESCEND_NONE))
+	{
+          if (!inscope)
+	  {
+	    inscope = 1;
+	    printf("  %s:\n", scopes[i]);
+	  }
+
+          name = mxmlElementGetAttr(function, "name");
+
+          printf("    ");
+
+	  arg = mxmlFindElement(function, function, "returnvalue", NULL, NULL, MXML_DESCEND_FIRST);
+
+	  if (arg)
+	    write_element(stdout, doc, mxmlFindElement(arg, arg, "type", NULL, NULL, MXML_DESCEND_FIRST), OUTPUT_MAN);
+	  else if (strcmp(cname, name) && strcmp(cname, name + 1))
+	    fputs("void ", stdout);
+
+	  printf("%s", name);
+
+	  for (arg = mxmlFindElement(function, function, "argument", NULL, NULL, MXML_DESCEND_FIRST), prefix = '('; arg; arg = mxmlFindElement(arg, function, "argument", NULL, NULL, MXML_DESCEND_NONE), prefix = ',')
+	  {
+	    type = mxmlFindElement(arg, arg, "type", NULL, NULL, MXML_DESCEND_FIRST);
+
+	    putchar(prefix);
+	    if (prefix == ',')
+	      putchar(' ');
+
+	    if (mxmlGetFirstChild(type))
+	      write_element(stdout, doc, type, OUTPUT_MAN);
+	    fputs(mxmlElementGetAttr(arg, "name"), stdout);
+            if ((defval = mxmlElementGetAttr(arg, "default")) != NULL)
+	      printf(" %s", defval);
+	  }
+
+	  if (prefix == '(')
+	    puts("(void);");
+	  else
+	    puts(");");
+	}
+      }
+
+      puts("};\n"
+           ".fi");
+
+      write_description(stdout, OUTPUT_MAN, description, NULL, 0);
+    }
+
+    CODEDOC_PROBE2(render__done, "CLASSES", OUTPUT_MAN);
+  }
+
+ /*
+  * List of enumerations...
+  */
+
+  if (find_public(doc, doc, "enumeration", NULL, OUTPUT_MAN))
+  {
+    puts(".SH ENUMERATIONS");
+
+    CODEDOC_PROBE2(render__start, "ENUMERATIONS", OUTPUT_MAN);
+
+    for (scut = find_public(doc, doc, "enumeration", NULL, OUTPUT_MAN); scut; scut = find_public(scut, doc, "enumeration", NULL, OUTPUT_MAN))
+    {
+      name        = mxmlElementGetAttr(scut, "name");
+      description = mxmlFindElement(scut, scut, "description", NULL, NULL, MXML_DESCEND_FIRST);
+      printf(".SS %s\n", name);
+
+      write_description(stdout, OUTPUT_MAN, description, NULL, 1);
+      write_description(stdout, OUTPUT_MAN, description, NULL, 0);
+
+      for (arg = mxmlFindElement(scut, scut, "constant", NULL, NULL, MXML_DESCEND_FIRST); arg; arg = mxmlFindElement(arg, scut, "constant", NULL, NULL, MXML_DESCEND_NONE))
+      {
+	description = mxmlFindElement(arg, arg, "description", NULL, NULL, MXML_DESCEND_FIRST);
+	printf(".TP 5\n%s\n.br\n", mxmlElementGetAttr(arg, "name"));
+	write_description(stdout, OUTPUT_MAN, description, NULL, 1);
+      }
+    }
+
+    CODEDOC_PROBE2(render__done, "ENUMERATIONS", OUTPUT_MAN);
+  }
+
+ /*
+  * List of functions...
+  */
+
+  if (find_public(doc, doc, "function", NULL, OUTPUT_MAN))
+  {
+    puts(".SH FUNCTIONS");
+
+    CODEDOC_PROBE2(render__start, "FUNCTIONS", OUTPUT_MAN);
+
+    for (function = find_public(doc, doc, "function", NULL, OUTPUT_MAN); function; function = find_public(function, doc, "function", NULL, OUTPUT_MAN))
+    {
+      name        = mxmlElementGetAttr(function, "name");
+      description = mxmlFindElement(function, function, "description", NULL, NULL, MXML_DESCEND_FIRST);
+      printf(".SS %s\n", name);
+
+      write_description(stdout, OUTPUT_MAN, description, NULL, 1);
+
+      puts(".PP\n"
+           ".nf");
+
+      arg = mxmlFindElement(function, function, "returnvalue", NULL, NULL, MXML_DESCEND_FIRST);
+
+      if (arg)
+	write_element(stdout, doc, mxmlFindElement(arg, arg, "type", NULL, NULL, MXML_DESCEND_FIRST), OUTPUT_MAN);
+      else
+	fputs("void", stdout);
+
+      printf(" %s ", name);
+      for (arg = mxmlFindElement(function, function, "argument", NULL, NULL, MXML_DESCEND_FIRST), prefix = '('; arg; arg = mxmlFindElement(arg, function, "argument", NULL, NULL, MXML_DESCEND_NONE), prefix = ',')
+      {
+        type = mxmlFindElement(arg, arg, "type", NULL, NULL, MXML_DESCEND_FIRST);
+
+	printf("%c\n    ", prefix);
+	if (mxmlGetFirstChild(type))
+	  write_element(stdout, doc, type, OUTPUT_MAN);
+	fputs(mxmlElementGetAttr(arg, "name"), stdout);
+        if ((defval = mxmlElementGetAttr(arg, "default")) != NULL)
+	  printf(" %s", defval);
+      }
+
+      if (prefix == '(')
+	puts("(void);");
+      else
+	puts("\n);");
+
+      puts(".fi");
+
+      write_description(stdout, OUTPUT_MAN, description, NULL, 0);
+    }
+
+    CODEDOC_PROBE2(render__done, "FUNCTIONS", OUTPUT_MAN);
+  }
+
+ /*
+  * List of structures...
+  */
+
+  if (find_public(doc, doc, "struct", NULL, OUTPUT_MAN))
+  {
+    puts(".SH STRUCTURES");
+
+    CODEDOC_PROBE2(render__start, "STRUCTURES", OUTPUT_MAN);
+
+    for (scut = find_public(doc, doc, "struct", NULL, OUTPUT_MAN); scut; scut = find_public(scut, doc, "struct", NULL, OUTPUT_MAN))
+    {
+      cname       = mxmlElementGetAttr(scut, "name");
+      description = mxmlFindElement(scut, scut, "description", NULL, NULL, MXML_DESCEND_FIRST);
+      printf(".SS %s\n", cname);
+
+      write_description(stdout, OUTPUT_MAN, description, NULL, 1);
+
+      printf(".PP\n"
+             ".nf\n"
+	     "struct %s\n{\n", cname);
+      for (arg = mxmlFindElement(scut, scut, "variable", NULL, NULL, MXML_DESCEND_FIRST); arg; arg = mxmlFindElement(arg, scut, "variable", NULL, NULL, MXML_DESCEND_NONE))
+      {
+	printf("  ");
+	write_element(stdout, doc, mxmlFindElement(arg, arg, "type", NULL, NULL, MXML_DESCEND_FIRST), OUTPUT_MAN);
+	printf("%s;\n", mxmlElementGetAttr(arg, "name"));
+      }
+
+      for (function = mxmlFindElement(scut, scut, "function", NULL, NULL, MXML_DESCEND_FIRST); function; function = mxmlFindElement(function, scut, "function", NULL, NULL, MXML_DESCEND_NONE))
+      {
+        name = mxmlElementGetAttr(function, "name");
+
+        printf("  ");
+
+	arg = mxmlFindElement(function, function, "returnvalue", NULL, NULL, MXML_DESCEND_FIRST);
+
+	if (arg)
+	  write_element(stdout, doc, mxmlFindElement(arg, arg, "type", NULL, NULL, MXML_DESCEND_FIRST), OUTPUT_MAN);
+	else if (strcmp(cname, name) && strcmp(cname, name + 1))
+	  fputs("void ", stdout);
+
+	fputs(name, stdout);
+
+	for (arg = mxmlFindElement(function, function, "argument", NULL, NULL, MXML_DESCEND_FIRST), prefix = '('; arg; arg = mxmlFindElement(arg, function, "argument", NULL, NULL, MXML_DESCEND_NONE), prefix = ',')
+	{
+	  type = mxmlFindElement(arg, arg, "type", NULL, NULL, MXML_DESCEND_FIRST);
+
+	  putchar(prefix);
+	  if (prefix == ',')
+	    putchar(' ');
+
+	  if (mxmlGetFirstChild(type))
+	    write_element(stdout, doc, type, OUTPUT_MAN);
+	  fputs(mxmlElementGetAttr(arg, "name"), stdout);
+          if ((defval = mxmlElementGetAttr(arg, "default")) != NULL)
+	    printf(" %s", defval);
+	}
+
+	if (prefix == '(')
+	  puts("(void);");
+	else
+	  puts(");");
+      }
+
+      puts("};\n"
+           ".fi");
+
+      write_description(stdout, OUTPUT_MAN, description, NULL, 0);
+    }
+
+    CODEDOC_PROBE2(render__done, "STRUCTURES", OUTPUT_MAN);
+  }
+
+ /*
+  * List of types...
+  */
+
+  if (find_public(doc, doc, "typedef", NULL, OUTPUT_MAN))
+  {
+    puts(".SH TYPES");
+
+    CODEDOC_PROBE2(render__start, "TYPES", OUTPUT_MAN);
+
+    for (scut = find_public(doc, doc, "typedef", NULL, OUTPUT_MAN); scut; scut = find_public(scut, doc, "typedef", NULL, OUTPUT_MAN))
+    {
+      name        = mxmlElementGetAttr(scut, "name");
+      description = mxmlFindElement(scut, scut, "description", NULL, NULL, MXML_DESCEND_FIRST);
+      printf(".SS %s\n", name);
+
+      write_description(stdout, OUTPUT_MAN, description, NULL, 1);
+
+      fputs(".PP\n"
+            ".nf\n"
+	    "typedef ", stdout);
+
+      type = mxmlFindElement(scut, scut, "type", NULL, NULL, MXML_DESCEND_FIRST);
+
+      for (type = mxmlGetFirstChild(type); type; type = mxmlGetNextSibling(type))
+      {
+        string = mxmlGetText(type, &whitespace);
+
+        if (!strcmp(string, "("))
+	  break;
+	else
+	{
+	  if (whitespace)
+	    putchar(' ');
+
+          write_string(stdout, string, OUTPUT_MAN, 0);
+        }
+      }
+
+      if (type)
+      {
+       /*
+        * Output function type...
+	*/
+
+        printf(" (*%s", name);
+
+	for (type = mxmlGetNextSibling(mxmlGetNextSibling(type)); type; type = mxmlGetNextSibling(type))
+	{
+	  string = mxmlGetText(type, &whitespace);
+
+	  if (whitespace)
+	    putchar(' ');
+
+          write_string(stdout, string, OUTPUT_MAN, 0);
+        }
+
+        puts(";");
+      }
+      else
+	printf(" %s;\n", name);
+
+      puts(".fi");
+
+      write_description(stdout, OUTPUT_MAN, description, NULL, 0);
+    }
+
+    CODEDOC_PROBE2(render__done, "TYPES", OUTPUT_MAN);
+  }
+
+ /*
+  * List of unions...
+  */
+
+  if (find_public(doc, doc, "union", NULL, OUTPUT_MAN))
+  {
+    puts(".SH UNIONS");
+
+    CODEDOC_PROBE2(render__start, "UNIONS", OUTPUT_MAN);
+
+    for (scut = find_public(doc, doc, "union", NULL, OUTPUT_MAN); scut; scut = find_public(scut, doc, "union", NULL, OUTPUT_MAN))
+    {
+      name        = mxmlElementGetAttr(scut, "name");
+      description = mxmlFindElement(scut, scut, "description", NULL, NULL, MXML_DESCEND_FIRST);
+      printf(".SS %s\n", name);
+
+      write_description(stdout, OUTPUT_MAN, description, NULL, 1);
+
+      printf(".PP\n"
+             ".nf\n"
+	     "union %s\n{\n", name);
+      for (arg = mxmlFindElement(scut, scut, "variable", NULL, NULL, MXML_DESCEND_FIRST); arg; arg = mxmlFindElement(arg, scut, "variable", NULL, NULL, MXML_DESCEND_NONE))
+      {
+	printf("  ");
+	write_element(stdout, doc, mxmlFindElement(arg, arg, "type", NULL, NULL, MXML_DESCEND_FIRST), OUTPUT_MAN);
+	printf("%s;\n", mxmlElementGetAttr(arg, "name"));
+      }
+
+      puts("};\n"
+           ".fi");
+
+      write_description(stdout, OUTPUT_MAN, description, NULL, 0);
+    }
+
+    CODEDOC_PROBE2(render__done, "UNIONS", OUTPUT_MAN);
+  }
+
+ /*
+  * Variables...
+  */
+
+  if (find_public(doc, doc, "variable", NULL, OUTPUT_MAN))
+  {
+    puts(".SH VARIABLES");
+
+    CODEDOC_PROBE2(render__start, "VARIABLES", OUTPUT_MAN);
+
+    for (arg = find_public(doc, doc, "variable", NULL, OUTPUT_MAN); arg; arg = find_public(arg, doc, "variable", NULL, OUTPUT_MAN))
+    {
+      name        = mxmlElementGetAttr(arg, "name");
+      description = mxmlFindElement(arg, arg, "description", NULL, NULL, MXML_DESCEND_FIRST);
+      printf(".SS %s\n", name);
+
+      write_description(stdout, OUTPUT_MAN, description, NULL, 1);
+
+      puts(".PP\n"
+           ".nf");
+
+      write_element(stdout, doc, mxmlFindElement(arg, arg, "type", NULL, NULL, MXML_DESCEND_FIRST), OUTPUT_MAN);
+      fputs(mxmlElementGetAttr(arg, "name"), stdout);
+      if ((defval = mxmlElementGetAttr(arg, "default")) != NULL)
+	printf(" %s", defval);
+      puts(";\n"
+           ".fi");
+
+      write_description(stdout, OUTPUT_MAN, description, NULL, 0);
+    }
+
+    CODEDOC_PROBE2(render__done, "VARIABLES", OUTPUT_MAN);
+  }
+
+  if (footerfile)
+  {
+   /*
+    * Use custom footer...
+    */
+
+    write_file(stdout, footerfile, OUTPUT_MAN);
+  }
+  else
+  {
+   /*
+    * Use standard footer...
+    */
+
+    puts(".SH AUTHOR");
+    puts(".PP");
+    puts(author);
+
+    puts(".SH COPYRIGHT");
+    puts(".PP");
+    puts(copyright);
+  }
+}
+
+
+/*
+ * 'write_matrix()' - Write a table showing when each symbol in a store was
+ *                    added, changed, and removed.
+ *
+ * Only the version manifests are read, so the matrix for any number of
+ * versions is written without loading or rendering the symbols.
+ */
+
+static void
+write_matrix(store_t    *store,		/* I - Store */
+             const char *section,	/* I - Section */
+             const char *title,		/* I - Title */
+             const char *author,	/* I - Author */
+             const char *language,	/* I - Language */
+             const char *copyright,	/* I - Copyright */
+             const char *docversion,	/* I - Document version */
+             const char *cssfile,	/* I - Stylesheet file */
+             const char *cssdir,	/* I - Directory for shared stylesheet */
+             const char *docdir,	/* I - Directory containing the output */
+             bool       minify)		/* I - Minify HTML? */
+{
+  FILE		*out;			/* Output file */
+  size_t	i,			/* Looping var */
+		num_symbols = 0,	/* Number of symbols */
+		alloc_symbols = 0,	/* Allocated symbols */
+		length,			/* Length of manifest */
+		prev;			/* Previous version with symbol */
+  char		**manifests,		/* Manifests for each version */
+		*line,			/* Current line */
+		*next,			/* Next line */
+		*ptr;			/* Pointer into line */
+  store_symbol_t *symbols = NULL,	/* Symbols in all versions */
+		*symbol,		/* Current symbol */
+		*end;			/* End of symbols with this kind/name */
+  unsigned long long hash,		/* Hash of symbol in version */
+		prev_hash;		/* Hash of symbol in previous version */
+  bool		changed;		/* Have we written a changed version? */
+
+
+ /*
+  * Load the manifests...
+  */
+
+  if ((manifests = calloc(store->num_versions + 1, sizeof(char *))) == NULL)
+  {
+    fputs("codedoc: Unable to allocate memory for store manifests.\n", stderr);
+    exit(1);
+  }
+
+  for (i = 0; i < store->num_versions; i ++)
+  {
+    if ((manifests[i] = store_get(store, "objects", store->versions[i].manifest, &length)) == NULL || strncmp(manifests[i], "codedoc-manifest 1.0\n", 21))
+    {
+      fprintf(stderr, "codedoc: Missing or bad manifest for version \"%s\" in store \"%s\".\n", store->versions[i].name, store->dir);
+      goto done;
+    }
+
+    for (line = manifests[i] + 21; *line; line = next)
+    {
+      if ((next = strchr(line, '\n')) != NULL)
+        *next++ = '\0';
+      else
+        next = line + strlen(line);
+
+      hash = strtoull(line, &ptr, 16);
+
+      if (*ptr != ' ' || (line = strchr(ptr + 1, ' ')) == NULL)
+      {
+        fprintf(stderr, "codedoc: Bad manifest for version \"%s\" in store \"%s\".\n", store->versions[i].name, store->dir);
+        goto done;
+      }
+
+      *line++ = '\0';
+
+      if (num_symbols >= alloc_symbols)
+      {
+        alloc_symbols += 1024;
+
+        if ((symbol = realloc(symbols, alloc_symbols * sizeof(store_symbol_t))) == NULL)
+        {
+	  fputs("codedoc: Unable to allocate memory for store manifests.\n", stderr);
+	  exit(1);
+        }
+
+        symbols = symbol;
+      }
+
+      symbol          = symbols + num_symbols;
+      symbol->kind    = ptr + 1;
+      symbol->name    = line;
+      symbol->version = i;
+      symbol->seq     = num_symbols;
+      symbol->hash    = hash;
+
+      num_symbols ++;
+    }
+  }
+
+  if (num_symbols > 1)
+    qsort(symbols, num_symbols, sizeof(store_symbol_t), (int (*)(const void *, const void *))store_compare);
+
+ /*
+  * Write the table...
+  */
+
+  if (!minify)
+  {
+    out = stdout;
+  }
+  else if ((out = tmpfile()) == NULL)
+  {
+    fprintf(stderr, "codedoc: Unable to create temporary file: %s\n", strerror(errno));
+    exit(1);
+  }
+
+  write_html_head(out, OUTPUT_HTML, section, title, author, language, copyright, docversion, cssfile, cssdir, docdir, minify);
+
+  fputs("<div class=\"body\">\n"
+        "<h1 class=\"title\">", out);
+  write_string(out, title, OUTPUT_HTML, 0);
+  fputs("</h1>\n"
+        "<table class=\"list\"><thead>\n"
+        "<tr><th>Kind</th><th>Name</th><th>Since</th><th>Removed In</th><th>Changed In</th></tr>\n"
+        "</thead><tbody>\n", out);
+
+  for (symbol = symbols; symbol < (symbols + num_symbols); symbol = end)
+  {
+    for (end = symbol + 1; end < (symbols + num_symbols) && !strcmp(end->kind, symbol->kind) && !strcmp(end->name, symbol->name); end ++);
+
+    fputs("<tr><td>", out);
+    write_string(out, symbol->kind, OUTPUT_HTML, 0);
+    fputs("</td><td>", out);
+    write_string(out, symbol->name, OUTPUT_HTML, 0);
+    fputs("</td><td>", out);
+    write_string(out, store->versions[symbol->version].name, OUTPUT_HTML, 0);
+    fputs("</td><td>", out);
+
+    if (end[-1].version < (store->num_versions - 1))
+      write_string(out, store->versions[end[-1].version + 1].name, OUTPUT_HTML, 0);
+
+    fputs("</td><td>", out);
+
+   /*
+    * Symbols with the same kind and name (overloads) are compared as a group...
+    */
+
+    for (prev = symbol->version, prev_hash = 0, changed = false; symbol < end;)
+    {
+      for (i = symbol->version, hash = 0xcbf29ce484222325ULL; symbol < end && symbol->version == i; symbol ++)
+        hash = store_hash(hash, &symbol->hash, sizeof(symbol->hash));
+
+      if (i != prev && hash != prev_hash)
+      {
+        if (changed)
+          fputs(", ", out);
+
+        write_string(out, store->versions[i].name, OUTPUT_HTML, 0);
+        changed = true;
+      }
+
+      prev      = i;
+      prev_hash = hash;
+    }
+
+    fputs("</td></tr>\n", out);
+  }
+
+  fputs("</tbody></table>\n"
+        "</div>\n"
+        "</body>\n"
+        "</html>\n", out);
+
+  if (minify)
+  {
+    minify_html(out, stdout);
+    fclose(out);
+  }
+
+  done:
+
+  for (i = 0; i < store->num_versions; i ++)
+    free(manifests[i]);
+
+  free(manifests);
+  free(symbols);
+}
+
+
+/*
+ * 'write_scu()' - Write a structure, class, or union.
+ */
+
+static void
+write_scu(FILE        *out,	/* I - Output file */
+          int         mode,	/* I - Output mode */
+          mxml_node_t *doc,	/* I - Document */
+          mxml_node_t *scut,	/* I - Structure, class, or union */
+          FILE        *details)	/* I - Detail file or `NULL` */
+{
+  FILE		*docout = out;		/* Document output file */
+  int		i;			/* Looping var */
+  mxml_node_t	*function,		/* Current function */
+		*arg,			/* Current argument */
+		*description,		/* Description of function/var */
+		*type;			/* Type for argument */
+  const char	*name,			/* Name of function/type */
+		*cname,			/* Class name */
+		*defval,		/* Default value */
+		*parent,		/* Parent class */
+		*scope;			/* Scope for variable/function */
+  int		inscope,		/* Variable/method scope */
+		maxscope;		/* Maximum scope */
+  char		prefix;			/* Prefix character */
+  const char	*br = mode == OUTPUT_EPUB ? "<br />" : "<br>";
+					/* Break sequence */
+  static const char * const scopes[] =	/* Scope strings */
+		{
+		  "private",
+		  "protected",
+		  "public"
+		};
+
+
+  cname       = mxmlElementGetAttr(scut, "name");
+  description = mxmlFindElement(scut, scut, "description", NULL, NULL, MXML_DESCEND_FIRST);
+
+  fprintf(out, "<h3 class=\"%s\">%s<a id=\"%s\">%s</a></h3>\n", mxmlGetElement(scut), get_comment_info(description), cname, cname);
+
+  if (description)
+    write_description(out, mode, description, "p", 1);
+
+  out = start_details(out, details);
+
+  fprintf(out, "<p class=\"code\"><span class=\"reserved\">%s</span> %s", mxmlGetElement(scut), cname);
+  if ((parent = mxmlElementGetAttr(scut, "parent")) != NULL)
+  {
+    if (!strncmp(parent, ": ", 2) && is_reserved(parent + 2))
+      fprintf(out, " : <span class=\"reserved\">%s</span>", parent + 2);
+    else
+      fprintf(out, " %s", parent);
+  }
+  fprintf(out, " {%s\n", br);
+
+  maxscope = !strcmp(mxmlGetElement(scut), "class") ? 3 : 1;
+
+  for (i = 0; i < maxscope; i ++)
+  {
+    inscope = maxscope == 1;
+
+    for (arg = mxmlFindElement(scut, scut, "variable", NULL, NULL, MXML_DESCEND_FIRST); arg; arg = mxmlFindElement(arg, scut, "variable", NULL, NULL, MXML_DESCEND_NONE))
+    {
+      if (maxscope > 1 && ((scope = mxmlElementGetAttr(arg, "scope")) == NULL || strcmp(scope, scopes[i])))
+	continue;
+
+      if (!inscope)
+      {
+	inscope = 1;
+	fprintf(out, "&#160;&#160;<span class=\"reserved\">%s</span>:%s\n", scopes[i], br);
+      }
+
+      fputs("&#160;&#160;&#160;&#160;", out);
+      write_element(out, doc, mxmlFindElement(arg, arg, "type", NULL, NULL, MXML_DESCEND_FIRST), OUTPUT_HTML);
+      fprintf(out, "%s;%s\n", mxmlElementGetAttr(arg, "name"), br);
+    }
+
+    for (function = mxmlFindElement(scut, scut, "function", NULL, NULL, MXML_DESCEND_FIRST); function; function = mxmlFindElement(function, scut, "function", NULL, NULL, MXML_DESCEND_NONE))
+    {
+      if (maxscope > 1 && ((scope = mxmlElementGetAttr(arg, "scope")) == NULL || strcmp(scope, scopes[i])))
+	continue;
+
+      if (!inscope)
+      {
+	inscope = 1;
+        fprintf(out, "&#160;&#160;<span class=\"reserved\">%s</span>:%s\n", scopes[i], br);
+      }
+
+      name = mxmlElementGetAttr(function, "name");
+
+      fputs("&#160;&#160;&#160;&#160;", out);
+
+      arg = mxmlFindElement(function, function, "returnvalue", NULL, NULL, MXML_DESCEND_FIRST);
+
+      if (arg)
+	write_element(out, doc, mxmlFindElement(arg, arg, "type", NULL, NULL, MXML_DESCEND_FIRST), OUTPUT_HTML);
+      else if (strcmp(cname, name) && strcmp(cname, name + 1))
+	fputs("<span class=\"reserved\">void</span> ", out);
+
+      fprintf(out, "<a href=\"#%s.%s\">%s</a>", cname, name, name);
+
+      for (arg = mxmlFindElement(function, function, "argument", NULL, NULL, MXML_DESCEND_FIRST), prefix = '('; arg; arg = mxmlFindElement(arg, function, "argument", NULL, NULL, MXML_DESCEND_NONE), prefix = ',')
+      {
+	type = mxmlFindElement(arg, arg, "type", NULL, NULL, MXML_DESCEND_FIRST);
+
+	putc(prefix, out);
+	if (prefix == ',')
+	  putc(' ', out);
+
+	if (mxmlGetFirstChild(type))
+	  write_element(out, doc, type, OUTPUT_HTML);
+
+	fputs(mxmlElementGetAttr(arg, "name"), out);
+	if ((defval = mxmlElementGetAttr(arg, "default")) != NULL)
+	  fprintf(out, " %s", defval);
+      }
+
+      if (prefix == '(')
+	fprintf(out, "(<span class=\"reserved\">void</span>);%s\n", br);
+      else
+	fprintf(out, ");%s\n", br);
+    }
   }
 
-  if (mode == OUTPUT_EPUB)
-    fputs("]]></style>\n"
-          "</head>\n"
-          "<body>\n", out);
-  else
-    fputs("--></style>\n"
-          "</head>\n"
-          "<body>\n", out);
+  fputs("};</p>\n"
+	"<h4 class=\"members\">Members</h4>\n"
+	"<table class=\"list\"><tbody>\n", out);
+
+  for (arg = mxmlFindElement(scut, scut, "variable", NULL, NULL, MXML_DESCEND_FIRST); arg; arg = mxmlFindElement(arg, scut, "variable", NULL, NULL, MXML_DESCEND_NONE))
+  {
+    description = mxmlFindElement(arg, arg, "description", NULL, NULL, MXML_DESCEND_FIRST);
+
+    fprintf(out, "<tr><th>%s %s</th>\n", mxmlElementGetAttr(arg, "name"), get_comment_info(description));
+
+    write_description(out, mode, description, "td", -1);
+    fputs("</tr>\n", out);
+  }
+
+  fputs("</tbody></table>\n", out);
+
+  for (function = mxmlFindElement(scut, scut, "function", NULL, NULL, MXML_DESCEND_FIRST); function; function = mxmlFindElement(function, scut, "function", NULL, NULL, MXML_DESCEND_NONE))
+  {
+    write_function(out, mode, doc, function, 4, NULL);
+  }
+
+  write_details(docout, details, cname);
 }
 
 
 /*
- * 'write_html_toc()' - Write a HTML table-of-contents.
+ * 'write_shard()' - Write the symbols assigned to one shard.
+ *
+ * Symbols are assigned to shards using a FNV-1a hash of their name so that
+ * each shard gets the same symbols on every run.  The rendered symbols are
+ * combined with @link shard_load@ and `--assemble`.
  */
 
 static void
-write_html_toc(FILE        *out,	/* I - Output file */
-               const char  *title,	/* I - Title */
-               toc_t       *toc,	/* I - Table of contents */
-               const char  *filename,	/* I - Target filename, if any */
-	       const char  *target)	/* I - Target frame name, if any */
+write_shard(mxml_node_t *doc,		/* I - XML documentation */
+            int         index,		/* I - Shard number (1-N) */
+            int         count,		/* I - Number of shards */
+            bool        progressive)	/* I - Defer symbol details? */
 {
-  size_t	i;			/* Looping var */
-  toc_entry_t	*tentry;		/* Current table of contents */
-  int		toc_level;		/* Current table-of-contents level */
-  char		targetattr[1024];	/* Target attribute, if any */
+  int		i;			/* Looping var */
+  FILE		*fp,			/* Rendered symbol */
+		*details = NULL;	/* Deferred details file */
+  mxml_node_t	*node;			/* Current symbol */
+  const char	*name,			/* Name of symbol */
+		*nameptr;		/* Pointer into name */
+  unsigned long long hash;		/* FNV-1a hash of name */
+  long		length;			/* Length of rendered symbol */
+  char		buffer[8192];		/* Copy buffer */
+  size_t	bytes;			/* Bytes in buffer */
+  static const char * const kinds[] =	/* Kinds of symbols */
+  {
+    "class",
+    "function",
+    "typedef",
+    "struct",
+    "union",
+    "variable",
+    "enumeration"
+  };
 
 
- /*
-  * If target is set, it is the frame file that contains the body.
-  * Otherwise, we are creating a single-file...
-  */
+  if ((fp = tmpfile()) == NULL || (progressive && (details = tmpfile()) == NULL))
+  {
+    fprintf(stderr, "codedoc: Unable to create temporary file: %s\n", strerror(errno));
+    exit(1);
+  }
 
-  if (target)
-    snprintf(targetattr, sizeof(targetattr), " target=\"%s\"", target);
-  else
-    targetattr[0] = '\0';
+  types_load(&Types, doc, OUTPUT_HTML);
 
-  fputs("<div class=\"contents\">\n", out);
+  fputs("codedoc-shard 1.0\n", stdout);
 
-  if (filename)
+  for (i = 0; i < (int)(sizeof(kinds) / sizeof(kinds[0])); i ++)
   {
-    fprintf(out, "<h1 class=\"title\"><a href=\"%s\"%s>", filename, targetattr);
-    write_string(out, title, OUTPUT_HTML, 0);
-    fputs("</a></h1>\n", out);
+    for (node = find_public(doc, doc, kinds[i], NULL, OUTPUT_HTML); node; node = find_public(node, doc, kinds[i], NULL, OUTPUT_HTML))
+    {
+      if ((name = mxmlElementGetAttr(node, "name")) == NULL)
+        continue;
+
+      for (hash = 0xcbf29ce484222325ULL, nameptr = name; *nameptr; nameptr ++)
+      {
+	hash ^= (unsigned char)*nameptr;
+	hash *= 0x100000001b3ULL;
+      }
+
+      if ((int)(hash % (unsigned)count) != (index - 1))
+        continue;
+
+     /*
+      * Render the symbol and copy it to the shard...
+      */
+
+      rewind(fp);
+
+      write_symbol(fp, OUTPUT_HTML, doc, node, details, NULL);
+
+      length = ftell(fp);
+
+      printf("%ld %s %s\n", length, kinds[i], name);
+
+      rewind(fp);
+
+      while (length > 0 && (bytes = fread(buffer, 1, length < (long)sizeof(buffer) ? (size_t)length : sizeof(buffer), fp)) > 0)
+      {
+        fwrite(buffer, 1, bytes, stdout);
+        length -= (long)bytes;
+      }
+    }
   }
 
-  fputs("<h2 class=\"title\">Contents</h2>\n"
-        "<ul class=\"contents\">\n", out);
+  types_free(&Types);
+  fclose(fp);
 
-  for (i = 0, tentry = toc->entries, toc_level = 1; i < toc->num_entries; i ++, tentry ++)
+  if (details)
+    fclose(details);
+}
+
+/*
+ * 'write_string()' - Write a string, quoting HTML special chars as needed.
+ */
+
+static void
+write_string(FILE       *out,		/* I - Output file */
+             const char *s,		/* I - String to write */
+             int        mode,		/* I - Output mode */
+             int        len)		/* I - Length or offset */
+{
+  const char	*end;			/* End of string */
+
+
+  if (!s || !renderers[mode].write_string)
+    return;
+
+  if (len <= 0)
+    end = s + strlen(s) - len;
+  else
+    end = s + len;
+
+  (renderers[mode].write_string)(out, s, end);
+}
+
+
+/*
+ * 'write_string_html()' - Write a string, quoting HTML special chars.
+ */
+
+static void
+write_string_html(FILE       *out,	/* I - Output file */
+                  const char *s,	/* I - String to write */
+                  const char *end)	/* I - End of string */
+{
+  const char	*start = s;		/* Start of string */
+
+
+  while (*s && s < end)
   {
-    if (tentry->level > toc_level)
+    if (*s == '&')
+      fputs("&amp;", out);
+    else if (*s == '<')
+      fputs("&lt;", out);
+    else if (*s == '>')
+      fputs("&gt;", out);
+    else if (*s == '\"')
+      fputs("&quot;", out);
+    else if (!strncasecmp(s, COPYRIGHT_ASCII, COPYRIGHT_ASCII_LEN) && (s == start || isspace(s[-1] & 255)) && (!s[COPYRIGHT_ASCII_LEN] || isspace(s[COPYRIGHT_ASCII_LEN] & 255)))
     {
-      toc_level = tentry->level;
+      fputs(COPYRIGHT_UTF8, out);
+      s += COPYRIGHT_ASCII_LEN - 1;
     }
-    else if (tentry->level < toc_level)
+    else if (!strncasecmp(s, REGISTERED_ASCII, REGISTERED_ASCII_LEN) && (s == start || isspace(s[-1] & 255)) && (!s[REGISTERED_ASCII_LEN] || isspace(s[REGISTERED_ASCII_LEN] & 255)))
     {
-      fputs("</ul></li>\n", out);
-      toc_level = tentry->level;
+      fputs(REGISTERED_UTF8, out);
+      s += REGISTERED_ASCII_LEN - 1;
+    }
+    else if (!strncasecmp(s, TRADEMARK_ASCII, TRADEMARK_ASCII_LEN) && (s == start || isspace(s[-1] & 255)) && (!s[TRADEMARK_ASCII_LEN] || isspace(s[TRADEMARK_ASCII_LEN] & 255)))
+    {
+      fputs(TRADEMARK_UTF8, out);
+      s += TRADEMARK_ASCII_LEN - 1;
     }
-
-    fprintf(out, "<li><a href=\"%s#%s\"%s>", filename ? filename : "", tentry->anchor, targetattr);
-    write_string(out, tentry->title, OUTPUT_HTML, 0);
-
-    if ((i + 1) < toc->num_entries && tentry[1].level > toc_level)
-      fputs("</a><ul class=\"subcontents\">\n", out);
     else
-      fputs("</a></li>\n", out);
+      putc(*s, out);
+
+    s ++;
   }
+}
 
-  if (toc_level == 2)
-    fputs("</ul></li>\n", out);
 
-  fputs("</ul>\n"
-        "</div>\n", out);
+/*
+ * 'write_string_man()' - Write a string, quoting man special chars.
+ */
+
+static void
+write_string_man(FILE       *out,	/* I - Output file */
+                 const char *s,		/* I - String to write */
+                 const char *end)	/* I - End of string */
+{
+  const char	*start = s;		/* Start of string */
+
+
+  if (*s == '\'' || *s == '.')
+    putc('\\', out);		// Escape leading "." or "'"
+
+  while (*s && s < end)
+  {
+    if (!strncasecmp(s, COPYRIGHT_ASCII, COPYRIGHT_ASCII_LEN) && (s == start || isspace(s[-1] & 255)) && (!s[COPYRIGHT_ASCII_LEN] || isspace(s[COPYRIGHT_ASCII_LEN] & 255)))
+    {
+      fputs("\\[co]", out);
+      s += COPYRIGHT_ASCII_LEN;
+    }
+    else if (!strncmp(s, COPYRIGHT_UTF8, COPYRIGHT_UTF8_LEN))
+    {
+      fputs("\\[co]", out);
+      s += COPYRIGHT_UTF8_LEN;
+    }
+    else if (!strncasecmp(s, REGISTERED_ASCII, REGISTERED_ASCII_LEN) && (s == start || isspace(s[-1] & 255)) && (!s[REGISTERED_ASCII_LEN] || isspace(s[REGISTERED_ASCII_LEN] & 255)))
+    {
+      fputs("\\*R", out);
+      s += REGISTERED_ASCII_LEN;
+    }
+    else if (!strncmp(s, REGISTERED_UTF8, REGISTERED_UTF8_LEN))
+    {
+      fputs("\\*R", out);
+      s += REGISTERED_UTF8_LEN;
+    }
+    else if (!strncasecmp(s, TRADEMARK_ASCII, TRADEMARK_ASCII_LEN) && (s == start || isspace(s[-1] & 255)) && (!s[TRADEMARK_ASCII_LEN] || isspace(s[TRADEMARK_ASCII_LEN] & 255)))
+    {
+      fputs("\\*(Tm", out);
+      s += TRADEMARK_ASCII_LEN;
+    }
+    else if (!strncmp(s, TRADEMARK_UTF8, TRADEMARK_UTF8_LEN))
+    {
+      fputs("\\*(Tm", out);
+      s += TRADEMARK_UTF8_LEN;
+    }
+    else
+    {
+      if (*s == '\\' || *s == '-')
+	putc('\\', out);
+
+      putc(*s++, out);
+    }
+  }
 }
 
 
 /*
- * 'write_man()' - Write manpage documentation.
+ * 'write_symbol()' - Write a class, function, type, variable, or enumeration.
+ *
+ * Symbols loaded with `--assemble` are copied as-is, in order for symbols with
+ * the same name.  Other symbols are rendered.
  */
 
 static void
-write_man(const char  *man_name,	/* I - Name of manpage */
-	  const char  *section,		/* I - Section */
-	  const char  *title,		/* I - Title */
-          const char  *author,		/* I - Author's name */
-          const char  *copyright,	/* I - Copyright string */
-	  const char  *headerfile,	/* I - Header file */
-	  const char  *bodyfile,	/* I - Body file */
-          mmd_t       *body,		/* I - Markdown body */
-	  mxml_node_t *doc,		/* I - XML documentation */
-	  const char  *footerfile)	/* I - Footer file */
+write_symbol(FILE        *out,		/* I - Output file */
+             int         mode,		/* I - Output mode */
+             mxml_node_t *doc,		/* I - Document */
+             mxml_node_t *node,		/* I - Symbol */
+             FILE        *details,	/* I - Detail file or `NULL` */
+             shard_t     *shard)	/* I - Symbols from other shards or `NULL` */
 {
-  int		i;			/* Looping var */
-  mxml_node_t	*function,		/* Current function */
-		*scut,			/* Struct/class/union/typedef */
-		*arg,			/* Current argument */
-		*description,		/* Description of function/var */
-		*type;			/* Type for argument */
-  const char	*name,			/* Name of function/type */
-		*cname,			/* Class name */
-		*defval,		/* Default value */
-		*parent;		/* Parent class */
-  int		inscope;		/* Variable/method scope */
-  char		prefix;			/* Prefix character */
-  const char	*source_date_epoch;	/* SOURCE_DATE_EPOCH environment variable */
-  time_t	curtime;		/* Current time */
-  struct tm	curdate;		/* Current date */
-  char		buffer[1024];		/* String buffer */
-  bool		whitespace;		/* Current whitespace value */
-  const char	*string;		/* Current string value */
-  static const char * const scopes[] =	/* Scope strings */
-		{
-		  "private",
-		  "protected",
-		  "public"
-		};
+  const char	*kind = mxmlGetElement(node);
+					/* Kind of symbol */
 
 
- /*
-  * Standard man page...
-  *
-  * Get the current date, using the SOURCE_DATE_EPOCH environment variable, if
-  * present, for the number of seconds since the epoch - this enables
-  * reproducible builds (Mini-XML Issue #193).
-  */
+  if (shard && shard->num_entries > 0 && mxmlElementGetAttr(node, "name"))
+  {
+   /*
+    * Look for the first unused entry with this kind and name...
+    */
+
+    shard_entry_t	key,		/* Search key */
+			*entry;		/* Current entry */
+    size_t		left,		/* Left side of search */
+			right,		/* Right side of search */
+			current;	/* Current entry */
+
+    key.kind = (char *)kind;
+    key.name = (char *)mxmlElementGetAttr(node, "name");
+    key.seq  = 0;
+
+    for (left = 0, right = shard->num_entries; left < right;)
+    {
+      current = (left + right) / 2;
+
+      if (shard_compare(shard->entries + current, &key) < 0)
+        left = current + 1;
+      else
+        right = current;
+    }
+
+    for (entry = shard->entries + left; left < shard->num_entries && !strcmp(entry->kind, key.kind) && !strcmp(entry->name, key.name); left ++, entry ++)
+    {
+      if (!entry->used)
+      {
+        fwrite(entry->data, 1, entry->length, out);
+        entry->used = true;
+        return;
+      }
+    }
+  }
+
+  if (!strcmp(kind, "function"))
+    write_function(out, mode, doc, node, 3, details);
+  else if (!strcmp(kind, "typedef"))
+    write_typedef(out, mode, doc, node, details);
+  else if (!strcmp(kind, "variable"))
+    write_variable(out, mode, doc, node, details);
+  else if (!strcmp(kind, "enumeration"))
+    write_enumeration(out, mode, doc, node, details);
+  else
+    write_scu(out, mode, doc, node, details);
+}
+
+/*
+ * 'write_typedef()' - Write a typedef.
+ */
+
+static void
+write_typedef(FILE        *out,	/* I - Output file */
+              int         mode,	/* I - Output mode */
+              mxml_node_t *doc,	/* I - Document */
+              mxml_node_t *scut,	/* I - Typedef */
+              FILE        *details)	/* I - Detail file or `NULL` */
+{
+  FILE		*fp;			/* Output file for details */
+  mxml_node_t	*description,		/* Description of typedef */
+		*type;			/* Type for typedef */
+  const char	*name;			/* Name of typedef */
+  bool		whitespace;		/* Current whitespace value */
+  const char	*string;		/* Current string value */
 
-  if ((source_date_epoch = getenv("SOURCE_DATE_EPOCH")) == NULL || (curtime = (time_t)strtol(source_date_epoch, NULL, 10)) <= 0)
-    curtime = time(NULL);
 
-  localtime_r(&curtime, &curdate);
-  snprintf(buffer, sizeof(buffer), "%04d-%02d-%02d", curdate.tm_year + 1900, curdate.tm_mon + 1, curdate.tm_mday);
+  name        = mxmlElementGetAttr(scut, "name");
+  description = mxmlFindElement(scut, scut, "description", NULL, NULL, MXML_DESCEND_FIRST);
+  fprintf(out, "<h3 class=\"typedef\"><a id=\"%s\">%s%s</a></h3>\n", name, get_comment_info(description), name);
 
-  printf(".TH %s %s \"%s\" \"%s\" \"%s\"\n", man_name, section ? section : "3",
-         title ? title : "", buffer, title ? title : "");
+  if (description)
+    write_description(out, mode, description, "p", 1);
 
- /*
-  * Header...
-  */
+  fp = start_details(out, details);
 
-  if (headerfile)
+  fputs("<p class=\"code\">\n"
+	"typedef ", fp);
+
+  type = mxmlFindElement(scut, scut, "type", NULL, NULL, MXML_DESCEND_FIRST);
+
+  for (type = mxmlGetFirstChild(type); type; type = mxmlGetNextSibling(type))
   {
-   /*
-    * Use custom header...
-    */
+    string = mxmlGetText(type, &whitespace);
 
-    write_file(stdout, headerfile, OUTPUT_MAN);
+    if (!strcmp(string, "("))
+    {
+      break;
+    }
+    else
+    {
+      if (whitespace)
+	putc(' ', fp);
+
+      if (is_linked_type(doc, string, true, mode))
+      {
+	fputs("<a href=\"#", fp);
+	write_string(fp, string, OUTPUT_HTML, 0);
+	fputs("\">", fp);
+	write_string(fp, string, OUTPUT_HTML, 0);
+	fputs("</a>", fp);
+      }
+      else
+	write_string(fp, string, OUTPUT_HTML, 0);
+    }
   }
-  else
+
+  if (type)
   {
    /*
-    * Use standard header...
+    * Output function type...
     */
 
-    puts(".SH NAME");
-    printf("%s \\- %s\n", man_name, title ? title : man_name);
-  }
+    string = mxmlGetText(mxmlGetPrevSibling(type), NULL);
 
- /*
-  * Body...
-  */
+    if (string && *string != '*')
+      putc(' ', fp);
 
-  if (body)
-    markdown_write_block(stdout, body, OUTPUT_MAN);
-  else if (bodyfile)
-    write_file(stdout, bodyfile, OUTPUT_MAN);
+    fprintf(fp, "(*%s", name);
 
- /*
-  * List of classes...
-  */
+    for (type = mxmlGetNextSibling(mxmlGetNextSibling(type)); type; type = mxmlGetNextSibling(type))
+    {
+      string = mxmlGetText(type, &whitespace);
 
-  if (find_public(doc, doc, "class", NULL, OUTPUT_MAN))
-  {
-    puts(".SH CLASSES");
+      if (whitespace)
+	putc(' ', fp);
 
-    for (scut = find_public(doc, doc, "class", NULL, OUTPUT_MAN); scut; scut = find_public(scut, doc, "class", NULL, OUTPUT_MAN))
-    {
-      cname       = mxmlElementGetAttr(scut, "name");
-      description = mxmlFindElement(scut, scut, "description", NULL, NULL, MXML_DESCEND_FIRST);
-      printf(".SS %s\n", cname);
+      if (is_linked_type(doc, string, true, mode))
+      {
+	fputs("<a href=\"#", fp);
+	write_string(fp, string, OUTPUT_HTML, 0);
+	fputs("\">", fp);
+	write_string(fp, string, OUTPUT_HTML, 0);
+	fputs("</a>", fp);
+      }
+      else
+	write_string(fp, string, OUTPUT_HTML, 0);
+    }
 
-      write_description(stdout, OUTPUT_MAN, description, NULL, 1);
+    fputs(";\n", fp);
+  }
+  else
+  {
+    type   = mxmlFindElement(scut, scut, "type", NULL, NULL, MXML_DESCEND_FIRST);
+    string = mxmlGetText(mxmlGetLastChild(type), NULL);
 
-      printf(".PP\n"
-             ".nf\n"
-             "class %s", cname);
-      if ((parent = mxmlElementGetAttr(scut, "parent")) != NULL)
-        printf(" %s", parent);
-      puts("\n{");
+    if (string && *string != '*')
+      putc(' ', fp);
 
-      for (i = 0; i < 3; i ++)
-      {
-        inscope = 0;
+    fprintf(fp, "%s;\n", name);
+  }
 
-	for (arg = mxmlFindElement(scut, scut, "variable", "scope", scopes[i], MXML_DESCEND_FIRST); arg; arg = mxmlFindElement(arg, scut, "variable", "scope", scopes[i], MXML_DESCEND_NONE))
-	{
-          if (!inscope)
-	  {
-	    inscope = 1;
-	    printf("  %s:\n", scopes[i]);
-	  }
+  fputs("</p>\n", fp);
 
-	  printf("    ");
-	  write_element(stdout, doc, mxmlFindElement(arg, arg, "type", NULL, NULL, MXML_DESCEND_FIRST), OUTPUT_MAN);
-	  printf("%s;\n", mxmlElementGetAttr(arg, "name"));
-	}
+  write_details(out, details, name);
+}
 
-	for (function = mxmlFindElement(scut, scut, "function", "scope", scopes[i], MXML_DESCEND_FIRST); function; function = mxmlFindElement(function, scut, "function", "scope", scopes[i], MXML_DESCEND_NONE))
-	{
-          if (!inscope)
-	  {
-	    inscope = 1;
-	    printf("  %s:\n", scopes[i]);
-	  }
 
-          name = mxmlElementGetAttr(function, "name");
+/*
+ * 'write_variable()' - Write a global variable.
+ */
 
-          printf("    ");
+static void
+write_variable(FILE        *out,	/* I - Output file */
+               int         mode,	/* I - Output mode */
+               mxml_node_t *doc,	/* I - Document */
+               mxml_node_t *arg,	/* I - Variable */
+               FILE        *details)	/* I - Detail file or `NULL` */
+{
+  FILE		*fp;			/* Output file for details */
+  mxml_node_t	*description;		/* Description of variable */
+  const char	*name,			/* Name of variable */
+		*defval;		/* Default value */
 
-	  arg = mxmlFindElement(function, function, "returnvalue", NULL, NULL, MXML_DESCEND_FIRST);
 
-	  if (arg)
-	    write_element(stdout, doc, mxmlFindElement(arg, arg, "type", NULL, NULL, MXML_DESCEND_FIRST), OUTPUT_MAN);
-	  else if (strcmp(cname, name) && strcmp(cname, name + 1))
-	    fputs("void ", stdout);
+  name        = mxmlElementGetAttr(arg, "name");
+  description = mxmlFindElement(arg, arg, "description", NULL, NULL, MXML_DESCEND_FIRST);
+  fprintf(out, "<h3 class=\"variable\"><a id=\"%s\">%s%s</a></h3>\n", name, get_comment_info(description), name);
 
-	  printf("%s", name);
+  if (description)
+    write_description(out, mode, description, "p", 1);
 
-	  for (arg = mxmlFindElement(function, function, "argument", NULL, NULL, MXML_DESCEND_FIRST), prefix = '('; arg; arg = mxmlFindElement(arg, function, "argument", NULL, NULL, MXML_DESCEND_NONE), prefix = ',')
-	  {
-	    type = mxmlFindElement(arg, arg, "type", NULL, NULL, MXML_DESCEND_FIRST);
+  fp = start_details(out, details);
 
-	    putchar(prefix);
-	    if (prefix == ',')
-	      putchar(' ');
+  fputs("<p class=\"code\">", fp);
 
-	    if (mxmlGetFirstChild(type))
-	      write_element(stdout, doc, type, OUTPUT_MAN);
-	    fputs(mxmlElementGetAttr(arg, "name"), stdout);
-            if ((defval = mxmlElementGetAttr(arg, "default")) != NULL)
-	      printf(" %s", defval);
-	  }
+  write_element(fp, doc, mxmlFindElement(arg, arg, "type", NULL, NULL, MXML_DESCEND_FIRST), OUTPUT_HTML);
+  fputs(mxmlElementGetAttr(arg, "name"), fp);
+  if ((defval = mxmlElementGetAttr(arg, "default")) != NULL)
+    fprintf(fp, " %s", defval);
+  fputs(";</p>\n", fp);
 
-	  if (prefix == '(')
-	    puts("(void);");
-	  else
-	    puts(");");
-	}
-      }
+  write_details(out, details, name);
+}
 
-      puts("};\n"
-           ".fi");
 
-      write_description(stdout, OUTPUT_MAN, description, NULL, 0);
-    }
-  }
+/*
+ * 'ws_cb()' - Whitespace callback for saving.
+ */
 
- /*
-  * List of enumerations...
-  */
+static const char *			/* O - Whitespace string or NULL for none */
+ws_cb(void        *cbdata,		/* I - Callback data (unused) */
+      mxml_node_t *node,		/* I - Element node */
+      mxml_ws_t   where)		/* I - Where value */
+{
+  const char *name;			/* Name of element */
+  int	depth;				/* Depth of node */
+  static const char *spaces = "                                        ";
+					/* Whitespace (40 spaces) for indent */
 
-  if (find_public(doc, doc, "enumeration", NULL, OUTPUT_MAN))
+
+  switch (mxmlGetType(node))
   {
-    puts(".SH ENUMERATIONS");
+    case MXML_TYPE_DECLARATION :
+        name = mxmlGetDeclaration(node);
+        break;
 
-    for (scut = find_public(doc, doc, "enumeration", NULL, OUTPUT_MAN); scut; scut = find_public(scut, doc, "enumeration", NULL, OUTPUT_MAN))
-    {
-      name        = mxmlElementGetAttr(scut, "name");
-      description = mxmlFindElement(scut, scut, "description", NULL, NULL, MXML_DESCEND_FIRST);
-      printf(".SS %s\n", name);
+    case MXML_TYPE_DIRECTIVE :
+        name = mxmlGetDirective(node);
+        break;
 
-      write_description(stdout, OUTPUT_MAN, description, NULL, 1);
-      write_description(stdout, OUTPUT_MAN, description, NULL, 0);
+    case MXML_TYPE_ELEMENT :
+        name = mxmlGetElement(node);
+        break;
 
-      for (arg = mxmlFindElement(scut, scut, "constant", NULL, NULL, MXML_DESCEND_FIRST); arg; arg = mxmlFindElement(arg, scut, "constant", NULL, NULL, MXML_DESCEND_NONE))
-      {
-	description = mxmlFindElement(arg, arg, "description", NULL, NULL, MXML_DESCEND_FIRST);
-	printf(".TP 5\n%s\n.br\n", mxmlElementGetAttr(arg, "name"));
-	write_description(stdout, OUTPUT_MAN, description, NULL, 1);
-      }
-    }
+    default :
+        name = "unknown";
+        break;
   }
 
- /*
-  * List of functions...
-  */
-
-  if (find_public(doc, doc, "function", NULL, OUTPUT_MAN))
+  switch (where)
   {
-    puts(".SH FUNCTIONS");
-
-    for (function = find_public(doc, doc, "function", NULL, OUTPUT_MAN); function; function = find_public(function, doc, "function", NULL, OUTPUT_MAN))
-    {
-      name        = mxmlElementGetAttr(function, "name");
-      description = mxmlFindElement(function, function, "description", NULL, NULL, MXML_DESCEND_FIRST);
-      printf(".SS %s\n", name);
+    case MXML_WS_BEFORE_CLOSE :
+        if (strcmp(name, "argument") && strcmp(name, "class") && strcmp(name, "constant") && strcmp(name, "enumeration") && strcmp(name, "function") && strcmp(name, "codedoc") && strcmp(name, "namespace") && strcmp(name, "returnvalue") && strcmp(name, "struct") && strcmp(name, "typedef") && strcmp(name, "union") && strcmp(name, "variable"))
+	  return (NULL);
 
-      write_description(stdout, OUTPUT_MAN, description, NULL, 1);
+	for (depth = -4; node; node = mxmlGetParent(node), depth += 2)
+	  ;				// Determine depth
 
-      puts(".PP\n"
-           ".nf");
+	if (depth > 40)
+	  return (spaces);
+	else if (depth < 2)
+	  return (NULL);
+	else
+	  return (spaces + 40 - depth);
 
-      arg = mxmlFindElement(function, function, "returnvalue", NULL, NULL, MXML_DESCEND_FIRST);
+    case MXML_WS_AFTER_CLOSE :
+	return ("\n");
 
-      if (arg)
-	write_element(stdout, doc, mxmlFindElement(arg, arg, "type", NULL, NULL, MXML_DESCEND_FIRST), OUTPUT_MAN);
-      else
-	fputs("void", stdout);
+    case MXML_WS_BEFORE_OPEN :
+	for (depth = -4; node; node = mxmlGetParent(node), depth += 2)
+	  ;				// Determine depth
 
-      printf(" %s ", name);
-      for (arg = mxmlFindElement(function, function, "argument", NULL, NULL, MXML_DESCEND_FIRST), prefix = '('; arg; arg = mxmlFindElement(arg, function, "argument", NULL, NULL, MXML_DESCEND_NONE), prefix = ',')
-      {
-        type = mxmlFindElement(arg, arg, "type", NULL, NULL, MXML_DESCEND_FIRST);
+	if (depth > 40)
+	  return (spaces);
+	else if (depth < 2)
+	  return (NULL);
+	else
+	  return (spaces + 40 - depth);
 
-	printf("%c\n    ", prefix);
-	if (mxmlGetFirstChild(type))
-	  write_element(stdout, doc, type, OUTPUT_MAN);
-	fputs(mxmlElementGetAttr(arg, "name"), stdout);
-        if ((defval = mxmlElementGetAttr(arg, "default")) != NULL)
-	  printf(" %s", defval);
-      }
+    default :
+    case MXML_WS_AFTER_OPEN :
+        if (strcmp(name, "argument") && strcmp(name, "class") && strcmp(name, "constant") && strcmp(name, "enumeration") && strcmp(name, "function") && strcmp(name, "codedoc") && strcmp(name, "namespace") && strcmp(name, "returnvalue") && strcmp(name, "struct") && strcmp(name, "typedef") && strcmp(name, "union") && strcmp(name, "variable") && strncmp(name, "?xml", 4))
+	  return (NULL);
+	else
+          return ("\n");
+  }
+}
 
-      if (prefix == '(')
-	puts("(void);");
-      else
-	puts("\n);");
 
-      puts(".fi");
+/*
+ * 'xmldoc_copy()' - Copy XML text to a buffer, decoding any entities.
+ *
+ * Only the predefined entities and numeric character references are decoded,
+ * which is all codedoc writes - the caller falls back to Mini-XML for
+ * anything else.
+ */
 
-      write_description(stdout, OUTPUT_MAN, description, NULL, 0);
-    }
-  }
+static const char *			/* O - End of text or `NULL` if not supported */
+xmldoc_copy(const char *ptr,		/* I  - Start of text */
+            const char *end,		/* I  - End of text */
+            char       **bufptr)	/* IO - Pointer into buffer */
+{
+  const char	*amp,			/* Next "&" */
+		*semi;			/* Semicolon after "&" */
+  char		*codeend,		/* End of character number */
+		*dst = *bufptr;		/* Pointer into buffer */
+  unsigned long	code;			/* Character code */
+  size_t	len;			/* Length of text or entity name */
 
- /*
-  * List of structures...
-  */
 
-  if (find_public(doc, doc, "struct", NULL, OUTPUT_MAN))
+  while (ptr < end)
   {
-    puts(".SH STRUCTURES");
+   /*
+    * Copy the text up to the next "&"...
+    */
 
-    for (scut = find_public(doc, doc, "struct", NULL, OUTPUT_MAN); scut; scut = find_public(scut, doc, "struct", NULL, OUTPUT_MAN))
-    {
-      cname       = mxmlElementGetAttr(scut, "name");
-      description = mxmlFindElement(scut, scut, "description", NULL, NULL, MXML_DESCEND_FIRST);
-      printf(".SS %s\n", cname);
+    if ((amp = memchr(ptr, '&', (size_t)(end - ptr))) == NULL)
+      amp = end;
 
-      write_description(stdout, OUTPUT_MAN, description, NULL, 1);
+    memcpy(dst, ptr, len = (size_t)(amp - ptr));
+    dst += len;
+    ptr = amp;
 
-      printf(".PP\n"
-             ".nf\n"
-	     "struct %s\n{\n", cname);
-      for (arg = mxmlFindElement(scut, scut, "variable", NULL, NULL, MXML_DESCEND_FIRST); arg; arg = mxmlFindElement(arg, scut, "variable", NULL, NULL, MXML_DESCEND_NONE))
-      {
-	printf("  ");
-	write_element(stdout, doc, mxmlFindElement(arg, arg, "type", NULL, NULL, MXML_DESCEND_FIRST), OUTPUT_MAN);
-	printf("%s;\n", mxmlElementGetAttr(arg, "name"));
-      }
+    if (ptr >= end)
+      break;
 
-      for (function = mxmlFindElement(scut, scut, "function", NULL, NULL, MXML_DESCEND_FIRST); function; function = mxmlFindElement(function, scut, "function", NULL, NULL, MXML_DESCEND_NONE))
-      {
-        name = mxmlElementGetAttr(function, "name");
+   /*
+    * Decode the entity...
+    */
 
-        printf("  ");
+    len = (size_t)(end - ptr);
 
-	arg = mxmlFindElement(function, function, "returnvalue", NULL, NULL, MXML_DESCEND_FIRST);
+    if ((semi = memchr(ptr, ';', len > 10 ? 10 : len)) == NULL)
+      return (NULL);
 
-	if (arg)
-	  write_element(stdout, doc, mxmlFindElement(arg, arg, "type", NULL, NULL, MXML_DESCEND_FIRST), OUTPUT_MAN);
-	else if (strcmp(cname, name) && strcmp(cname, name + 1))
-	  fputs("void ", stdout);
+    ptr ++;
+    len = (size_t)(semi - ptr);
 
-	fputs(name, stdout);
+    if (*ptr == '#')
+    {
+      if (ptr[1] == 'x' && isxdigit(ptr[2] & 255))
+        code = strtoul(ptr + 2, &codeend, 16);
+      else if (isdigit(ptr[1] & 255))
+        code = strtoul(ptr + 1, &codeend, 10);
+      else
+        return (NULL);
 
-	for (arg = mxmlFindElement(function, function, "argument", NULL, NULL, MXML_DESCEND_FIRST), prefix = '('; arg; arg = mxmlFindElement(arg, function, "argument", NULL, NULL, MXML_DESCEND_NONE), prefix = ',')
-	{
-	  type = mxmlFindElement(arg, arg, "type", NULL, NULL, MXML_DESCEND_FIRST);
+      if (codeend != semi || !code || code > 0x10ffff || (code < ' ' && code != '\t' && code != '\n' && code != '\r'))
+        return (NULL);
 
-	  putchar(prefix);
-	  if (prefix == ',')
-	    putchar(' ');
+      if (code < 0x80)
+      {
+        *dst++ = (char)code;
+      }
+      else if (code < 0x800)
+      {
+        *dst++ = (char)(0xc0 | (code >> 6));
+        *dst++ = (char)(0x80 | (code & 0x3f));
+      }
+      else if (code < 0x10000)
+      {
+        *dst++ = (char)(0xe0 | (code >> 12));
+        *dst++ = (char)(0x80 | ((code >> 6) & 0x3f));
+        *dst++ = (char)(0x80 | (code & 0x3f));
+      }
+      else
+      {
+        *dst++ = (char)(0xf0 | (code >> 18));
+        *dst++ = (char)(0x80 | ((code >> 12) & 0x3f));
+        *dst++ = (char)(0x80 | ((code >> 6) & 0x3f));
+        *dst++ = (char)(0x80 | (code & 0x3f));
+      }
+    }
+    else if (len == 3 && !memcmp(ptr, "amp", 3))
+      *dst++ = '&';
+    else if (len == 2 && !memcmp(ptr, "lt", 2))
+      *dst++ = '<';
+    else if (len == 2 && !memcmp(ptr, "gt", 2))
+      *dst++ = '>';
+    else if (len == 4 && !memcmp(ptr, "quot", 4))
+      *dst++ = '\"';
+    else if (len == 4 && !memcmp(ptr, "apos", 4))
+      *dst++ = '\'';
+    else
+      return (NULL);
 
-	  if (mxmlGetFirstChild(type))
-	    write_element(stdout, doc, type, OUTPUT_MAN);
-	  fputs(mxmlElementGetAttr(arg, "name"), stdout);
-          if ((defval = mxmlElementGetAttr(arg, "default")) != NULL)
-	    printf(" %s", defval);
-	}
+    ptr = semi + 1;
+  }
 
-	if (prefix == '(')
-	  puts("(void);");
-	else
-	  puts(");");
-      }
+  *bufptr = dst;
 
-      puts("};\n"
-           ".fi");
+  return (ptr);
+}
 
-      write_description(stdout, OUTPUT_MAN, description, NULL, 0);
-    }
-  }
 
- /*
-  * List of types...
-  */
+/*
+ * 'xmldoc_load()' - Load an XML documentation file.
+ *
+ * XML files written by codedoc are parsed directly into nodes, producing the
+ * same tree as `mxmlLoadIO` with `type_cb`.  Large files are split between
+ * the top-level symbols and parsed in parallel when POSIX threads are
+ * available.  Anything else is loaded with Mini-XML.
+ */
 
-  if (find_public(doc, doc, "typedef", NULL, OUTPUT_MAN))
+static mxml_node_t *			/* O - XML document or `NULL` on error */
+xmldoc_load(const char *filename)	/* I - XML file */
+{
+  char		*data,			/* File contents */
+		*temp,			/* New file contents */
+		directive[256];		/* XML declaration */
+  size_t	length,			/* Length of file */
+		i;			/* Looping var */
+  const char	*ptr,			/* Pointer into file */
+		*end,			/* End of file */
+		*content,		/* Start of <codedoc> content */
+		*close;			/* Start of </codedoc> */
+  mxml_node_t	*doc = NULL,		/* XML document */
+		*codedoc,		/* <codedoc> element */
+		*node;			/* Current node */
+  mxml_options_t *options;		/* Load options */
+  xmldoc_t	xmldoc;			/* Chunks of file */
+  xmldoc_chunk_t *chunk;		/* Current chunk */
+  bool		valid = false;		/* Was the file parsed? */
+  int		error;			/* Read error */
+
+
+  if ((error = filebuf_read(filename, &data, &length)) != 0)
   {
-    puts(".SH TYPES");
-
-    for (scut = find_public(doc, doc, "typedef", NULL, OUTPUT_MAN); scut; scut = find_public(scut, doc, "typedef", NULL, OUTPUT_MAN))
+    if (error == FILEBUF_EGZCORRUPT || error == FILEBUF_EGZTRUNC)
     {
-      name        = mxmlElementGetAttr(scut, "name");
-      description = mxmlFindElement(scut, scut, "description", NULL, NULL, MXML_DESCEND_FIRST);
-      printf(".SS %s\n", name);
+     /*
+      * Don't replace a damaged XML file with a new one...
+      */
 
-      write_description(stdout, OUTPUT_MAN, description, NULL, 1);
+      fprintf(stderr, "codedoc: Unable to read the XML documentation file \"%s\": %s\n", filename, filebuf_strerror(error));
+      exit(1);
+    }
 
-      fputs(".PP\n"
-            ".nf\n"
-	    "typedef ", stdout);
+    return (NULL);
+  }
 
-      type = mxmlFindElement(scut, scut, "type", NULL, NULL, MXML_DESCEND_FIRST);
+  if ((temp = realloc(data, length + 1)) == NULL)
+  {
+    free(data);
+    return (NULL);
+  }
 
-      for (type = mxmlGetFirstChild(type); type; type = mxmlGetNextSibling(type))
-      {
-        string = mxmlGetText(type, &whitespace);
+  data         = temp;
+  data[length] = '\0';
+  end          = data + length;
 
-        if (!strcmp(string, "("))
-	  break;
-	else
-	{
-	  if (whitespace)
-	    putchar(' ');
+  memset(&xmldoc, 0, sizeof(xmldoc));
 
-          write_string(stdout, string, OUTPUT_MAN, 0);
-        }
-      }
+ /*
+  * The file must start with the XML declaration and contain a single
+  * <codedoc> element...
+  */
 
-      if (type)
-      {
-       /*
-        * Output function type...
-	*/
+  if (strncmp(data, "<?xml ", 6) || (ptr = strstr(data, "?>")) == NULL || (size_t)(ptr - data) >= sizeof(directive))
+    goto fallback;
 
-        printf(" (*%s", name);
+  memcpy(directive, data + 1, (size_t)(ptr - data));
+  directive[ptr - data] = '\0';
 
-	for (type = mxmlGetNextSibling(mxmlGetNextSibling(type)); type; type = mxmlGetNextSibling(type))
-	{
-	  string = mxmlGetText(type, &whitespace);
+  doc = mxmlNewDirective(/*parent*/NULL, directive);
 
-	  if (whitespace)
-	    putchar(' ');
+  for (content = ptr + 2; content < end && isspace(*content & 255); content ++);
 
-          write_string(stdout, string, OUTPUT_MAN, 0);
-        }
+  if (strncmp(content, "<codedoc", 8) || (content = xmldoc_skip(content, end)) == NULL || content[-2] == '/')
+    goto fallback;
 
-        puts(";");
-      }
-      else
-	printf(" %s;\n", name);
+  if ((codedoc = xmldoc_parse(ptr + 2, content, doc)) == NULL || mxmlGetParent(codedoc) != doc)
+    goto fallback;
 
-      puts(".fi");
+  for (close = end; close > content && isspace(close[-1] & 255); close --);
 
-      write_description(stdout, OUTPUT_MAN, description, NULL, 0);
-    }
-  }
+  if ((close - content) < 10 || memcmp(close - 10, "</codedoc>", 10))
+    goto fallback;
+
+  end   = close;
+  close -= 10;
 
  /*
-  * List of unions...
+  * Split the content between top-level elements and parse each chunk...
   */
 
-  if (find_public(doc, doc, "union", NULL, OUTPUT_MAN))
-  {
-    puts(".SH UNIONS");
+  if (!xmldoc_split(&xmldoc, content, close))
+    goto fallback;
 
-    for (scut = find_public(doc, doc, "union", NULL, OUTPUT_MAN); scut; scut = find_public(scut, doc, "union", NULL, OUTPUT_MAN))
-    {
-      name        = mxmlElementGetAttr(scut, "name");
-      description = mxmlFindElement(scut, scut, "description", NULL, NULL, MXML_DESCEND_FIRST);
-      printf(".SS %s\n", name);
+  for (i = xmldoc.num_chunks, chunk = xmldoc.chunks; i > 0; i --, chunk ++)
+    chunk->task = jobsSubmit((jobs_task_cb_t)xmldoc_task, chunk, JOBS_PRIORITY_NORMAL, 0, NULL);
 
-      write_description(stdout, OUTPUT_MAN, description, NULL, 1);
+ /*
+  * Stitch the chunks together in order and close the <codedoc> element...
+  */
 
-      printf(".PP\n"
-             ".nf\n"
-	     "union %s\n{\n", name);
-      for (arg = mxmlFindElement(scut, scut, "variable", NULL, NULL, MXML_DESCEND_FIRST); arg; arg = mxmlFindElement(arg, scut, "variable", NULL, NULL, MXML_DESCEND_NONE))
-      {
-	printf("  ");
-	write_element(stdout, doc, mxmlFindElement(arg, arg, "type", NULL, NULL, MXML_DESCEND_FIRST), OUTPUT_MAN);
-	printf("%s;\n", mxmlElementGetAttr(arg, "name"));
-      }
+  for (valid = true, i = xmldoc.num_chunks, chunk = xmldoc.chunks; i > 0; i --, chunk ++)
+  {
+    jobsWait(chunk->task);
 
-      puts("};\n"
-           ".fi");
+    if (!chunk->valid)
+      valid = false;
 
-      write_description(stdout, OUTPUT_MAN, description, NULL, 0);
+    while (valid && (node = mxmlGetFirstChild(chunk->tree)) != NULL)
+    {
+      mxmlRemove(node);
+      mxmlAdd(codedoc, MXML_ADD_AFTER, /*child*/NULL, node);
     }
+
+    mxmlDelete(chunk->tree);
   }
 
+  if (valid && xmldoc_parse(close, end, codedoc) != doc)
+    valid = false;
+
  /*
-  * Variables...
+  * Use Mini-XML for anything we can't handle...
   */
 
-  if (find_public(doc, doc, "variable", NULL, OUTPUT_MAN))
-  {
-    puts(".SH VARIABLES");
-
-    for (arg = find_public(doc, doc, "variable", NULL, OUTPUT_MAN); arg; arg = find_public(arg, doc, "variable", NULL, OUTPUT_MAN))
-    {
-      name        = mxmlElementGetAttr(arg, "name");
-      description = mxmlFindElement(arg, arg, "description", NULL, NULL, MXML_DESCEND_FIRST);
-      printf(".SS %s\n", name);
-
-      write_description(stdout, OUTPUT_MAN, description, NULL, 1);
+  fallback:
 
-      puts(".PP\n"
-           ".nf");
+  free(xmldoc.chunks);
 
-      write_element(stdout, doc, mxmlFindElement(arg, arg, "type", NULL, NULL, MXML_DESCEND_FIRST), OUTPUT_MAN);
-      fputs(mxmlElementGetAttr(arg, "name"), stdout);
-      if ((defval = mxmlElementGetAttr(arg, "default")) != NULL)
-	printf(" %s", defval);
-      puts(";\n"
-           ".fi");
+  if (!valid)
+  {
+    mxmlDelete(doc);
 
-      write_description(stdout, OUTPUT_MAN, description, NULL, 0);
-    }
-  }
+    options = mxmlOptionsNew();
+    mxmlOptionsSetTypeCallback(options, type_cb, /*cbdata*/NULL);
 
-  if (footerfile)
-  {
-   /*
-    * Use custom footer...
-    */
+    doc = mxmlLoadString(/*top*/NULL, options, data);
 
-    write_file(stdout, footerfile, OUTPUT_MAN);
+    mxmlOptionsDelete(options);
   }
-  else
-  {
-   /*
-    * Use standard footer...
-    */
 
-    puts(".SH AUTHOR");
-    puts(".PP");
-    puts(author);
+  free(data);
 
-    puts(".SH COPYRIGHT");
-    puts(".PP");
-    puts(copyright);
-  }
+  return (doc);
 }
 
 
 /*
- * 'write_scu()' - Write a structure, class, or union.
+ * 'xmldoc_name()' - Find an element or attribute name.
  */
 
-static void
-write_scu(FILE        *out,	/* I - Output file */
-          int         mode,	/* I - Output mode */
-          mxml_node_t *doc,	/* I - Document */
-          mxml_node_t *scut)	/* I - Structure, class, or union */
+static const char *			/* O - Name or `NULL` if not found */
+xmldoc_name(const char         *name,	/* I - Name */
+            size_t             namelen,	/* I - Length of name */
+            const char * const *names,	/* I - Known names */
+            size_t             num_names)
+					/* I - Number of names */
 {
-  int		i;			/* Looping var */
-  mxml_node_t	*function,		/* Current function */
-		*arg,			/* Current argument */
-		*description,		/* Description of function/var */
-		*type;			/* Type for argument */
-  const char	*name,			/* Name of function/type */
-		*cname,			/* Class name */
-		*defval,		/* Default value */
-		*parent,		/* Parent class */
-		*scope;			/* Scope for variable/function */
-  int		inscope,		/* Variable/method scope */
-		maxscope;		/* Maximum scope */
-  char		prefix;			/* Prefix character */
-  const char	*br = mode == OUTPUT_EPUB ? "<br />" : "<br>";
-					/* Break sequence */
-  static const char * const scopes[] =	/* Scope strings */
-		{
-		  "private",
-		  "protected",
-		  "public"
-		};
-
+  for (; num_names > 0; num_names --, names ++)
+  {
+    if (**names == *name && !strncmp(*names, name, namelen) && !(*names)[namelen])
+      return (*names);
+  }
 
-  cname       = mxmlElementGetAttr(scut, "name");
-  description = mxmlFindElement(scut, scut, "description", NULL, NULL, MXML_DESCEND_FIRST);
+  return (NULL);
+}
 
-  fprintf(out, "<h3 class=\"%s\">%s<a id=\"%s\">%s</a></h3>\n", mxmlGetElement(scut), get_comment_info(description), cname, cname);
 
-  if (description)
-    write_description(out, mode, description, "p", 1);
+/*
+ * 'xmldoc_parse()' - Parse XML content into an element.
+ *
+ * Text is split into words and lone whitespace nodes like Mini-XML does, and
+ * the end of the content is treated as the start of the next tag.
+ */
 
-  fprintf(out, "<p class=\"code\"><span class=\"reserved\">%s</span> %s", mxmlGetElement(scut), cname);
-  if ((parent = mxmlElementGetAttr(scut, "parent")) != NULL)
-  {
-    if (!strncmp(parent, ": ", 2) && is_reserved(parent + 2))
-      fprintf(out, " : <span class=\"reserved\">%s</span>", parent + 2);
-    else
-      fprintf(out, " %s", parent);
-  }
-  fprintf(out, " {%s\n", br);
+static mxml_node_t *			/* O - Current element at end or `NULL` if not supported */
+xmldoc_parse(const char  *ptr,		/* I - Start of content */
+             const char  *end,		/* I - End of content */
+             mxml_node_t *parent)	/* I - Parent node */
+{
+  mxml_node_t	*node = parent,		/* Current node */
+		*element;		/* New element */
+  const char	*name,			/* Name of current element */
+		*next;			/* Next tag */
+  char		*buffer,		/* Text buffer */
+		*bufptr;		/* Pointer into buffer */
+  size_t	namelen;		/* Length of name */
+  bool		opaque,			/* Is the current element a <description>? */
+		whitespace = false;	/* Was there whitespace before the text? */
 
-  maxscope = !strcmp(mxmlGetElement(scut), "class") ? 3 : 1;
 
-  for (i = 0; i < maxscope; i ++)
-  {
-    inscope = maxscope == 1;
+ /*
+  * Decoded text is never longer than the XML...
+  */
 
-    for (arg = mxmlFindElement(scut, scut, "variable", NULL, NULL, MXML_DESCEND_FIRST); arg; arg = mxmlFindElement(arg, scut, "variable", NULL, NULL, MXML_DESCEND_NONE))
+  if ((buffer = malloc((size_t)(end - ptr) + 1)) == NULL)
+    return (NULL);
+
+  bufptr = buffer;
+  opaque = (name = mxmlGetElement(node)) != NULL && !strcmp(name, "description");
+
+  for (;;)
+  {
+    if (ptr >= end || *ptr == '<')
     {
-      if (maxscope > 1 && ((scope = mxmlElementGetAttr(arg, "scope")) == NULL || strcmp(scope, scopes[i])))
-	continue;
+     /*
+      * Add any pending text...
+      */
 
-      if (!inscope)
+      if (bufptr > buffer)
       {
-	inscope = 1;
-	fprintf(out, "&#160;&#160;<span class=\"reserved\">%s</span>:%s\n", scopes[i], br);
-      }
+        *bufptr = '\0';
 
-      fputs("&#160;&#160;&#160;&#160;", out);
-      write_element(out, doc, mxmlFindElement(arg, arg, "type", NULL, NULL, MXML_DESCEND_FIRST), OUTPUT_HTML);
-      fprintf(out, "%s;%s\n", mxmlElementGetAttr(arg, "name"), br);
-    }
+        if (opaque)
+          mxmlNewOpaque(node, buffer);
+        else
+          mxmlNewText(node, whitespace, buffer);
 
-    for (function = mxmlFindElement(scut, scut, "function", NULL, NULL, MXML_DESCEND_FIRST); function; function = mxmlFindElement(function, scut, "function", NULL, NULL, MXML_DESCEND_NONE))
-    {
-      if (maxscope > 1 && ((scope = mxmlElementGetAttr(arg, "scope")) == NULL || strcmp(scope, scopes[i])))
-	continue;
+        bufptr     = buffer;
+        whitespace = false;
+      }
 
-      if (!inscope)
+      if (whitespace)
       {
-	inscope = 1;
-        fprintf(out, "&#160;&#160;<span class=\"reserved\">%s</span>:%s\n", scopes[i], br);
+        mxmlNewText(node, true, "");
+        whitespace = false;
       }
 
-      name = mxmlElementGetAttr(function, "name");
+      if (ptr >= end)
+        break;
 
-      fputs("&#160;&#160;&#160;&#160;", out);
+      if (ptr[1] == '/')
+      {
+       /*
+        * Close the current element...
+        */
 
-      arg = mxmlFindElement(function, function, "returnvalue", NULL, NULL, MXML_DESCEND_FIRST);
+        if (!mxmlGetParent(node) || (name = mxmlGetElement(node)) == NULL)
+          goto error;
 
-      if (arg)
-	write_element(out, doc, mxmlFindElement(arg, arg, "type", NULL, NULL, MXML_DESCEND_FIRST), OUTPUT_HTML);
-      else if (strcmp(cname, name) && strcmp(cname, name + 1))
-	fputs("<span class=\"reserved\">void</span> ", out);
+        namelen = strlen(name);
 
-      fprintf(out, "<a href=\"#%s.%s\">%s</a>", cname, name, name);
+        if ((size_t)(end - ptr) < (namelen + 3) || strncmp(ptr + 2, name, namelen))
+          goto error;
 
-      for (arg = mxmlFindElement(function, function, "argument", NULL, NULL, MXML_DESCEND_FIRST), prefix = '('; arg; arg = mxmlFindElement(arg, function, "argument", NULL, NULL, MXML_DESCEND_NONE), prefix = ',')
+        for (ptr += namelen + 2; ptr < end && isspace(*ptr & 255); ptr ++);
+
+        if (ptr >= end || *ptr != '>')
+          goto error;
+
+        ptr ++;
+        node = mxmlGetParent(node);
+      }
+      else if ((ptr = xmldoc_tag(ptr, end, node, buffer, &element)) == NULL)
       {
-	type = mxmlFindElement(arg, arg, "type", NULL, NULL, MXML_DESCEND_FIRST);
+        goto error;
+      }
+      else if (element)
+      {
+        node = element;
+      }
 
-	putc(prefix, out);
-	if (prefix == ',')
-	  putc(' ', out);
+      opaque = (name = mxmlGetElement(node)) != NULL && !strcmp(name, "description");
+    }
+    else if (opaque)
+    {
+     /*
+      * Copy text up to the next tag...
+      */
 
-	if (mxmlGetFirstChild(type))
-	  write_element(out, doc, type, OUTPUT_HTML);
+      if ((next = memchr(ptr, '<', (size_t)(end - ptr))) == NULL)
+        next = end;
 
-	fputs(mxmlElementGetAttr(arg, "name"), out);
-	if ((defval = mxmlElementGetAttr(arg, "default")) != NULL)
-	  fprintf(out, " %s", defval);
+      if ((ptr = xmldoc_copy(ptr, next, &bufptr)) == NULL)
+        goto error;
+    }
+    else if (*ptr == ' ' || *ptr == '\t' || *ptr == '\n' || *ptr == '\r')
+    {
+     /*
+      * Whitespace ends the current word...
+      */
+
+      if (bufptr > buffer)
+      {
+        *bufptr = '\0';
+        mxmlNewText(node, whitespace, buffer);
+        bufptr = buffer;
       }
 
-      if (prefix == '(')
-	fprintf(out, "(<span class=\"reserved\">void</span>);%s\n", br);
-      else
-	fprintf(out, ");%s\n", br);
+      whitespace = true;
+      ptr ++;
+    }
+    else if (*ptr == '&')
+    {
+      if ((next = memchr(ptr, ';', (size_t)(end - ptr))) == NULL || (ptr = xmldoc_copy(ptr, next + 1, &bufptr)) == NULL)
+        goto error;
+    }
+    else
+    {
+      *bufptr++ = *ptr++;
     }
   }
 
-  fputs("};</p>\n"
-	"<h4 class=\"members\">Members</h4>\n"
-	"<table class=\"list\"><tbody>\n", out);
+  free(buffer);
 
-  for (arg = mxmlFindElement(scut, scut, "variable", NULL, NULL, MXML_DESCEND_FIRST); arg; arg = mxmlFindElement(arg, scut, "variable", NULL, NULL, MXML_DESCEND_NONE))
-  {
-    description = mxmlFindElement(arg, arg, "description", NULL, NULL, MXML_DESCEND_FIRST);
+  return (node);
 
-    fprintf(out, "<tr><th>%s %s</th>\n", mxmlElementGetAttr(arg, "name"), get_comment_info(description));
+ /*
+  * If we get here, the content is not supported...
+  */
 
-    write_description(out, mode, description, "td", -1);
-    fputs("</tr>\n", out);
-  }
+  error:
 
-  fputs("</tbody></table>\n", out);
+  free(buffer);
 
-  for (function = mxmlFindElement(scut, scut, "function", NULL, NULL, MXML_DESCEND_FIRST); function; function = mxmlFindElement(function, scut, "function", NULL, NULL, MXML_DESCEND_NONE))
-  {
-    write_function(out, mode, doc, function, 4);
-  }
+  return (NULL);
 }
 
 
 /*
- * 'write_string()' - Write a string, quoting HTML special chars as needed.
+ * 'xmldoc_skip()' - Skip an XML tag.
  */
 
-static void
-write_string(FILE       *out,		/* I - Output file */
-             const char *s,		/* I - String to write */
-             int        mode,		/* I - Output mode */
-             int        len)		/* I - Length or offset */
+static const char *			/* O - Pointer after tag or `NULL` on error */
+xmldoc_skip(const char *ptr,		/* I - Pointer to "<" */
+            const char *end)		/* I - End of buffer */
 {
-  const char	*start = s;		/* Start of string */
-  const char	*end;			/* End of string */
+  for (ptr ++; ptr < end; ptr ++)
+  {
+    if (*ptr == '>')
+      return (ptr + 1);
+    else if ((*ptr == '\"' || *ptr == '\'') && (ptr = memchr(ptr + 1, *ptr, (size_t)(end - ptr - 1))) == NULL)
+      break;
+  }
 
+  return (NULL);
+}
 
-  if (!s)
-    return;
 
-  if (len <= 0)
-    end = s + strlen(s) - len;
-  else
-    end = s + len;
+/*
+ * 'xmldoc_split()' - Split the content of the <codedoc> element into chunks.
+ *
+ * Chunks start with a top-level element so that each one can be parsed on its
+ * own.
+ */
 
-  switch (mode)
+static bool				/* O - `true` on success, `false` on error */
+xmldoc_split(xmldoc_t   *xmldoc,	/* I - Chunks */
+             const char *content,	/* I - Start of content */
+             const char *close)		/* I - Start of </codedoc> */
+{
+  const char	*ptr,			/* Pointer into content */
+		*start = content;	/* Start of current chunk */
+  int		depth = 0;		/* Element nesting */
+  xmldoc_chunk_t *chunk;		/* Current chunk */
+
+
+  for (ptr = content; (close - ptr) >= XMLDOC_CHUNK_SIZE && (ptr = memchr(ptr, '<', (size_t)(close - ptr))) != NULL;)
   {
-    case OUTPUT_EPUB :
-    case OUTPUT_HTML :
-    case OUTPUT_XML :
-        while (*s && s < end)
+    if (ptr[1] == '/')
+    {
+      if (-- depth < 0 || (ptr = memchr(ptr, '>', (size_t)(close - ptr))) == NULL)
+        return (false);
+    }
+    else if (ptr[1] == '!' || ptr[1] == '?')
+    {
+     /*
+      * Comments and processing instructions are left to Mini-XML...
+      */
+
+      return (false);
+    }
+    else
+    {
+      if (!depth && (ptr - start) >= XMLDOC_CHUNK_SIZE)
+      {
+        if (xmldoc->num_chunks >= xmldoc->alloc_chunks)
         {
-          if (*s == '&')
-            fputs("&amp;", out);
-          else if (*s == '<')
-            fputs("&lt;", out);
-          else if (*s == '>')
-            fputs("&gt;", out);
-          else if (*s == '\"')
-            fputs("&quot;", out);
-          else if (!strncasecmp(s, COPYRIGHT_ASCII, COPYRIGHT_ASCII_LEN) && (s == start || isspace(s[-1] & 255)) && (!s[COPYRIGHT_ASCII_LEN] || isspace(s[COPYRIGHT_ASCII_LEN] & 255)))
-          {
-            fputs(COPYRIGHT_UTF8, out);
-            s += COPYRIGHT_ASCII_LEN - 1;
-          }
-          else if (!strncasecmp(s, REGISTERED_ASCII, REGISTERED_ASCII_LEN) && (s == start || isspace(s[-1] & 255)) && (!s[REGISTERED_ASCII_LEN] || isspace(s[REGISTERED_ASCII_LEN] & 255)))
-          {
-            fputs(REGISTERED_UTF8, out);
-            s += REGISTERED_ASCII_LEN - 1;
-          }
-          else if (!strncasecmp(s, TRADEMARK_ASCII, TRADEMARK_ASCII_LEN) && (s == start || isspace(s[-1] & 255)) && (!s[TRADEMARK_ASCII_LEN] || isspace(s[TRADEMARK_ASCII_LEN] & 255)))
-          {
-	    fputs(TRADEMARK_UTF8, out);
-            s += TRADEMARK_ASCII_LEN - 1;
-          }
-          else
-            putc(*s, out);
+          if ((chunk = realloc(xmldoc->chunks, (xmldoc->alloc_chunks + 16) * sizeof(xmldoc_chunk_t))) == NULL)
+            return (false);
 
-          s ++;
+          xmldoc->chunks       = chunk;
+          xmldoc->alloc_chunks += 16;
         }
-        break;
 
-    case OUTPUT_MAN :
-        if (*s == '\'' || *s == '.')
-	  putc('\\', out);		// Escape leading "." or "'"
+        chunk        = xmldoc->chunks + xmldoc->num_chunks ++;
+        chunk->start = start;
+        chunk->end   = ptr;
+        chunk->tree  = NULL;
+        chunk->valid = false;
+        start        = ptr;
+      }
 
-        while (*s && s < end)
-        {
-          if (!strncasecmp(s, COPYRIGHT_ASCII, COPYRIGHT_ASCII_LEN) && (s == start || isspace(s[-1] & 255)) && (!s[COPYRIGHT_ASCII_LEN] || isspace(s[COPYRIGHT_ASCII_LEN] & 255)))
-          {
-            fputs("\\[co]", out);
-            s += COPYRIGHT_ASCII_LEN;
-          }
-          else if (!strncmp(s, COPYRIGHT_UTF8, COPYRIGHT_UTF8_LEN))
-          {
-            fputs("\\[co]", out);
-            s += COPYRIGHT_UTF8_LEN;
-          }
-          else if (!strncasecmp(s, REGISTERED_ASCII, REGISTERED_ASCII_LEN) && (s == start || isspace(s[-1] & 255)) && (!s[REGISTERED_ASCII_LEN] || isspace(s[REGISTERED_ASCII_LEN] & 255)))
-          {
-            fputs("\\*R", out);
-            s += REGISTERED_ASCII_LEN;
-          }
-          else if (!strncmp(s, REGISTERED_UTF8, REGISTERED_UTF8_LEN))
-          {
-            fputs("\\*R", out);
-            s += REGISTERED_UTF8_LEN;
-          }
-          else if (!strncasecmp(s, TRADEMARK_ASCII, TRADEMARK_ASCII_LEN) && (s == start || isspace(s[-1] & 255)) && (!s[TRADEMARK_ASCII_LEN] || isspace(s[TRADEMARK_ASCII_LEN] & 255)))
-          {
-	    fputs("\\*(Tm", out);
-            s += TRADEMARK_ASCII_LEN;
-          }
-          else if (!strncmp(s, TRADEMARK_UTF8, TRADEMARK_UTF8_LEN))
-          {
-            fputs("\\*(Tm", out);
-            s += TRADEMARK_UTF8_LEN;
-          }
-          else
-          {
-	    if (*s == '\\' || *s == '-')
-	      putc('\\', out);
+      if ((ptr = xmldoc_skip(ptr, close)) == NULL)
+        return (false);
 
-	    putc(*s++, out);
-	  }
-        }
-        break;
+      if (ptr[-2] != '/')
+        depth ++;
+    }
   }
+
+ /*
+  * Add the last chunk...
+  */
+
+  if ((chunk = realloc(xmldoc->chunks, (xmldoc->num_chunks + 1) * sizeof(xmldoc_chunk_t))) == NULL)
+    return (false);
+
+  xmldoc->chunks       = chunk;
+  xmldoc->alloc_chunks = xmldoc->num_chunks + 1;
+
+  chunk        = xmldoc->chunks + xmldoc->num_chunks ++;
+  chunk->start = start;
+  chunk->end   = close;
+  chunk->tree  = NULL;
+  chunk->valid = false;
+
+  return (true);
 }
 
 
 /*
- * 'ws_cb()' - Whitespace callback for saving.
+ * 'xmldoc_tag()' - Parse an element start tag.
  */
 
-static const char *			/* O - Whitespace string or NULL for none */
-ws_cb(void        *cbdata,		/* I - Callback data (unused) */
-      mxml_node_t *node,		/* I - Element node */
-      mxml_ws_t   where)		/* I - Where value */
+static const char *			/* O - Pointer after tag or `NULL` if not supported */
+xmldoc_tag(const char  *ptr,		/* I - Pointer to "<" */
+           const char  *end,		/* I - End of buffer */
+           mxml_node_t *parent,		/* I - Parent node */
+           char        *buffer,		/* I - Buffer for attribute values */
+           mxml_node_t **element)	/* O - New element or `NULL` if empty */
 {
-  const char *name;			/* Name of element */
-  int	depth;				/* Depth of node */
-  static const char *spaces = "                                        ";
-					/* Whitespace (40 spaces) for indent */
+  const char	*start,			/* Start of name or value */
+		*name;			/* Element or attribute name */
+  char		*bufptr;		/* Pointer into buffer */
 
 
-  switch (mxmlGetType(node))
-  {
-    case MXML_TYPE_DECLARATION :
-        name = mxmlGetDeclaration(node);
-        break;
+  *element = NULL;
 
-    case MXML_TYPE_DIRECTIVE :
-        name = mxmlGetDirective(node);
-        break;
+  for (start = ++ ptr; ptr < end && !isspace(*ptr & 255) && *ptr != '/' && *ptr != '>'; ptr ++);
 
-    case MXML_TYPE_ELEMENT :
-        name = mxmlGetElement(node);
-        break;
+  if ((name = xmldoc_name(start, (size_t)(ptr - start), xmldoc_elements, sizeof(xmldoc_elements) / sizeof(xmldoc_elements[0]))) == NULL)
+    return (NULL);
 
-    default :
-        name = "unknown";
-        break;
-  }
+  *element = mxmlNewElement(parent, name);
 
-  switch (where)
+  for (;;)
   {
-    case MXML_WS_BEFORE_CLOSE :
-        if (strcmp(name, "argument") && strcmp(name, "class") && strcmp(name, "constant") && strcmp(name, "enumeration") && strcmp(name, "function") && strcmp(name, "codedoc") && strcmp(name, "namespace") && strcmp(name, "returnvalue") && strcmp(name, "struct") && strcmp(name, "typedef") && strcmp(name, "union") && strcmp(name, "variable"))
-	  return (NULL);
+    while (ptr < end && isspace(*ptr & 255))
+      ptr ++;
 
-	for (depth = -4; node; node = mxmlGetParent(node), depth += 2)
-	  ;				// Determine depth
+    if (ptr >= end)
+      return (NULL);
+    else if (*ptr == '>')
+      return (ptr + 1);
+    else if (*ptr == '/')
+    {
+      *element = NULL;
 
-	if (depth > 40)
-	  return (spaces);
-	else if (depth < 2)
-	  return (NULL);
-	else
-	  return (spaces + 40 - depth);
+      return (ptr + 1 < end && ptr[1] == '>' ? ptr + 2 : NULL);
+    }
 
-    case MXML_WS_AFTER_CLOSE :
-	return ("\n");
+   /*
+    * Get the attribute name and quoted value...
+    */
 
-    case MXML_WS_BEFORE_OPEN :
-	for (depth = -4; node; node = mxmlGetParent(node), depth += 2)
-	  ;				// Determine depth
+    for (start = ptr; ptr < end && !isspace(*ptr & 255) && *ptr != '=' && *ptr != '/' && *ptr != '>'; ptr ++);
 
-	if (depth > 40)
-	  return (spaces);
-	else if (depth < 2)
-	  return (NULL);
-	else
-	  return (spaces + 40 - depth);
+    if ((name = xmldoc_name(start, (size_t)(ptr - start), xmldoc_attrs, sizeof(xmldoc_attrs) / sizeof(xmldoc_attrs[0]))) == NULL)
+      return (NULL);
 
-    default :
-    case MXML_WS_AFTER_OPEN :
-        if (strcmp(name, "argument") && strcmp(name, "class") && strcmp(name, "constant") && strcmp(name, "enumeration") && strcmp(name, "function") && strcmp(name, "codedoc") && strcmp(name, "namespace") && strcmp(name, "returnvalue") && strcmp(name, "struct") && strcmp(name, "typedef") && strcmp(name, "union") && strcmp(name, "variable") && strncmp(name, "?xml", 4))
-	  return (NULL);
-	else
-          return ("\n");
+    while (ptr < end && isspace(*ptr & 255))
+      ptr ++;
+
+    if (ptr >= end || *ptr++ != '=')
+      return (NULL);
+
+    while (ptr < end && isspace(*ptr & 255))
+      ptr ++;
+
+    if (ptr >= end || (*ptr != '\"' && *ptr != '\'') || (start = memchr(ptr + 1, *ptr, (size_t)(end - ptr - 1))) == NULL || memchr(ptr + 1, '<', (size_t)(start - ptr - 1)))
+      return (NULL);
+
+    bufptr = buffer;
+
+    if (!xmldoc_copy(ptr + 1, start, &bufptr))
+      return (NULL);
+
+    *bufptr = '\0';
+    ptr     = start + 1;
+
+    mxmlElementSetAttr(*element, name, buffer);
   }
 }
+
+
+/*
+ * 'xmldoc_task()' - Parse a chunk of an XML file.
+ */
+
+static void
+xmldoc_task(xmldoc_chunk_t *chunk)	/* I - Chunk to parse */
+{
+  chunk->tree  = mxmlNewElement(/*parent*/NULL, "codedoc");
+  chunk->valid = xmldoc_parse(chunk->start, chunk->end, chunk->tree) == chunk->tree;
+}
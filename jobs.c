@@ -0,0 +1,866 @@
+/*
+ * Job limits and task pool for codedoc.
+ *
+ *     https://www.msweet.org/codedoc
+ *
+ * The main thread always counts as one job.  Each additional worker thread
+ * needs a call to jobsAcquire before it starts and a call to jobsRelease when
+ * it finishes.  When codedoc is run from a GNU make recipe with a jobserver
+ * ("--jobserver-auth=R,W" or "--jobserver-auth=fifo:PATH" in MAKEFLAGS),
+ * every additional worker also holds a token from the jobserver so codedoc
+ * stays within the build's parallelism.  Otherwise the limit is the "--jobs"
+ * value or the number of CPUs.
+ *
+ * Work that can be split into independent pieces is submitted to a shared
+ * pool of worker threads with jobsSubmit, so the different parts of codedoc
+ * never start more threads than the job limit allows.  Each worker has its own
+ * queue of ready tasks, running the newest first, and steals the oldest task
+ * from the other queues when its own is empty.  Workers exit when there is no
+ * more work, and a thread waiting for a task with jobsWait runs ready tasks
+ * itself, so every task runs even when no workers can be started.
+ *
+ * Copyright © 2025 by Michael R Sweet.
+ *
+ * Licensed under Apache License v2.0.  See the file "LICENSE" for more
+ * information.
+ */
+
+#include "jobs.h"
+#include "stats.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <stdint.h>
+#include <time.h>
+#ifdef HAVE_PTHREAD_H
+#  include <pthread.h>
+#endif /* HAVE_PTHREAD_H */
+#ifndef _WIN32
+#  include <fcntl.h>
+#  include <unistd.h>
+#endif /* !_WIN32 */
+
+
+/*
+ * Local constants...
+ */
+
+#define JOBS_MAX_TOKENS	1024		/* Maximum jobserver tokens held */
+#define JOBS_NUM_PRIORITIES (JOBS_PRIORITY_HIGH + 1)
+					/* Number of task priorities */
+#define JOBS_STACK_SIZE	(4 * 1024 * 1024)
+					/* Stack size for worker threads */
+
+
+/*
+ * Local types...
+ */
+
+struct _jobs_task_s			/**** Task ****/
+{
+  jobs_task_cb_t	cb;		/* Task function */
+  void			*data;		/* Task data */
+  jobs_priority_t	priority;	/* Priority */
+  stats_phase_t		phase;		/* Processing phase when submitted */
+  size_t		num_pending,	/* Number of unfinished dependencies */
+			num_dependents,	/* Number of dependent tasks */
+			alloc_dependents;
+					/* Allocated dependent tasks */
+  jobs_task_t		**dependents,	/* Tasks that depend on this one */
+			*prev,		/* Previous task in queue */
+			*next;		/* Next task in queue */
+  bool			done;		/* Has the task finished? */
+};
+
+typedef struct _jobs_queue_s		/**** Queue of ready tasks ****/
+{
+  bool			active;		/* Is a worker using the queue? */
+  jobs_task_t		*first[JOBS_NUM_PRIORITIES],
+					/* Oldest task at each priority */
+			*last[JOBS_NUM_PRIORITIES];
+					/* Newest task at each priority */
+} _jobs_queue_t;
+
+
+/*
+ * Local globals...
+ */
+
+#ifdef HAVE_PTHREAD_H
+static pthread_mutex_t	jobs_mutex = PTHREAD_MUTEX_INITIALIZER;
+					/* Mutex for job state */
+#endif /* HAVE_PTHREAD_H */
+static int		jobs_active = 1,/* Active jobs, including main thread */
+			jobs_max = 1,	/* Maximum number of jobs */
+			jobs_rfd = -1,	/* Jobserver read descriptor */
+			jobs_wfd = -1;	/* Jobserver write descriptor */
+static bool		jobs_ropen = false,
+					/* Did we open the read descriptor? */
+			jobs_serial = false;
+					/* Is the jobserver unusable? */
+static char		jobs_tokens[JOBS_MAX_TOKENS];
+					/* Jobserver tokens held */
+static size_t		jobs_num_tokens = 0;
+					/* Number of jobserver tokens held */
+
+#ifdef HAVE_PTHREAD_H
+static pthread_mutex_t	jobs_task_mutex = PTHREAD_MUTEX_INITIALIZER;
+					/* Mutex for task pool */
+static pthread_cond_t	jobs_task_cond = PTHREAD_COND_INITIALIZER;
+					/* Condition for finished tasks */
+#endif /* HAVE_PTHREAD_H */
+static size_t		jobs_num_queues = 0;
+					/* Number of task queues */
+static _jobs_queue_t	*jobs_queues = NULL;
+					/* Task queues, the first is shared and
+					 * the rest belong to workers */
+
+
+/*
+ * Local functions...
+ */
+
+static void		jobs_exit_cb(void);
+static void		jobs_finish(jobs_task_t *task);
+static void		jobs_lock(void);
+static double		jobs_now(void);
+static bool		jobs_open_server(void);
+static void		jobs_ready(jobs_task_t *task, size_t queue);
+static void		jobs_run(jobs_task_t *task, size_t queue);
+static bool		jobs_start(void);
+static jobs_task_t	*jobs_take(size_t queue);
+static void		jobs_task_lock(void);
+static void		jobs_task_unlock(void);
+static void		jobs_unlock(void);
+#ifdef HAVE_PTHREAD_H
+static void		*jobs_worker(void *queue);
+#endif /* HAVE_PTHREAD_H */
+
+
+/*
+ * 'jobsAcquire()' - Reserve a job for a new worker thread.
+ *
+ * This function does not block - `false` is returned if the job limit has been
+ * reached or the jobserver has no tokens available, in which case the caller
+ * should do the work on the current thread.
+ */
+
+bool					/* O - `true` if the worker may start, `false` otherwise */
+jobsAcquire(void)
+{
+  bool	ret = false;			/* Return value */
+
+
+  jobs_lock();
+
+  if (jobs_active >= jobs_max)
+    goto done;
+
+#ifndef _WIN32
+  if (jobs_rfd >= 0)
+  {
+    char	token;			/* Jobserver token */
+    ssize_t	bytes;			/* Bytes read */
+
+    if (jobs_num_tokens >= JOBS_MAX_TOKENS)
+      goto done;
+
+   /*
+    * The read descriptor is non-blocking, so EAGAIN means another process
+    * took the last token...
+    */
+
+    while ((bytes = read(jobs_rfd, &token, 1)) < 0 && errno == EINTR);
+
+    if (bytes != 1)
+      goto done;
+
+    jobs_tokens[jobs_num_tokens ++] = token;
+  }
+#endif /* !_WIN32 */
+
+  jobs_active ++;
+  ret = true;
+
+  done:
+
+  jobs_unlock();
+
+  return (ret);
+}
+
+
+/*
+ * 'jobsChild()' - Reset the job state in a forked child process.
+ *
+ * The child runs as the job its parent reserved with @link jobsAcquire@, so it
+ * starts with no workers and none of the parent's jobserver tokens - otherwise
+ * the tokens would be returned twice when the child exits.
+ */
+
+void
+jobsChild(void)
+{
+  jobs_active     = 1;
+  jobs_num_tokens = 0;
+}
+
+
+/*
+ * 'jobsGetMax()' - Get the maximum number of jobs.
+ */
+
+int					/* O - Maximum number of jobs */
+jobsGetMax(void)
+{
+  return (jobs_max);
+}
+
+
+/*
+ * 'jobsInit()' - Initialize job limits from the environment.
+ *
+ * The default limit is the number of CPUs.  If MAKEFLAGS names a usable
+ * jobserver, tokens are also required for each additional worker.
+ */
+
+void
+jobsInit(void)
+{
+#if defined(_WIN32) || !defined(_SC_NPROCESSORS_ONLN)
+  jobs_max = 1;
+#else
+  long	ncpus = sysconf(_SC_NPROCESSORS_ONLN);
+					/* Number of CPUs */
+
+  jobs_max = ncpus > 1 ? (int)ncpus : 1;
+#endif /* _WIN32 || !_SC_NPROCESSORS_ONLN */
+
+  if (jobs_open_server())
+    atexit(jobs_exit_cb);
+}
+
+
+/*
+ * 'jobsRelease()' - Release a job reserved with @link jobsAcquire@.
+ */
+
+void
+jobsRelease(void)
+{
+  jobs_lock();
+
+  if (jobs_active > 1)
+  {
+    jobs_active --;
+
+#ifndef _WIN32
+    if (jobs_num_tokens > 0)
+    {
+     /*
+      * Return the same token we were given...
+      */
+
+      jobs_num_tokens --;
+
+      while (write(jobs_wfd, jobs_tokens + jobs_num_tokens, 1) < 0 && errno == EINTR);
+    }
+#endif /* !_WIN32 */
+  }
+
+  jobs_unlock();
+}
+
+
+/*
+ * 'jobsSetMax()' - Set the maximum number of jobs.
+ */
+
+void
+jobsSetMax(int max_jobs)		/* I - Maximum number of jobs */
+{
+  jobs_lock();
+  jobs_max = max_jobs > 1 && !jobs_serial ? max_jobs : 1;
+  jobs_unlock();
+}
+
+
+/*
+ * 'jobsSubmit()' - Submit a task to the pool.
+ *
+ * The task runs after the tasks it depends on have finished, ahead of any
+ * ready tasks with a lower priority.  Every task must be passed to
+ * @link jobsWait@ after any tasks that depend on it have been submitted.  If
+ * there is not enough memory for a new task, the task is run before this
+ * function returns and `NULL` is returned.
+ */
+
+jobs_task_t *				/* O - Task or `NULL` if run immediately */
+jobsSubmit(jobs_task_cb_t  cb,		/* I - Task function */
+           void            *data,	/* I - Task data */
+           jobs_priority_t priority,	/* I - Priority */
+           size_t          num_deps,	/* I - Number of dependencies */
+           jobs_task_t     **deps)	/* I - Tasks this one depends on */
+{
+  jobs_task_t	*task,			/* New task */
+		*dep,			/* Current dependency */
+		**dependents;		/* New dependent tasks */
+  bool		ready;			/* Is the task ready to run? */
+
+
+  jobs_task_lock();
+
+  if (!jobs_num_queues && (jobs_queues = calloc(1, sizeof(_jobs_queue_t))) != NULL)
+    jobs_num_queues = 1;
+
+  if (!jobs_num_queues || (task = calloc(1, sizeof(jobs_task_t))) == NULL)
+  {
+   /*
+    * Run the task now, after its dependencies...
+    */
+
+    for (; num_deps > 0; num_deps --, deps ++)
+    {
+      if (*deps)
+        jobs_finish(*deps);
+    }
+
+    jobs_task_unlock();
+
+    (cb)(data);
+
+    return (NULL);
+  }
+
+  task->cb       = cb;
+  task->data     = data;
+  task->priority = priority < JOBS_PRIORITY_LOW ? JOBS_PRIORITY_LOW : priority > JOBS_PRIORITY_HIGH ? JOBS_PRIORITY_HIGH : priority;
+  task->phase    = statsGetPhase();
+
+  for (; num_deps > 0; num_deps --, deps ++)
+  {
+    if ((dep = *deps) == NULL || dep->done)
+      continue;
+
+    if (dep->num_dependents >= dep->alloc_dependents)
+    {
+      if ((dependents = realloc(dep->dependents, (dep->alloc_dependents + 4) * sizeof(jobs_task_t *))) == NULL)
+      {
+       /*
+        * Can't record the dependency, so wait for it here...
+        */
+
+        jobs_finish(dep);
+        continue;
+      }
+
+      dep->dependents       = dependents;
+      dep->alloc_dependents += 4;
+    }
+
+    dep->dependents[dep->num_dependents ++] = task;
+    task->num_pending ++;
+  }
+
+  if ((ready = !task->num_pending) != false)
+    jobs_ready(task, 0);
+
+  jobs_task_unlock();
+
+  if (ready)
+    jobs_start();
+
+  return (task);
+}
+
+
+/*
+ * 'jobsWait()' - Wait for a task to finish and free it.
+ *
+ * Ready tasks are run on the calling thread while waiting.
+ */
+
+void
+jobsWait(jobs_task_t *task)		/* I - Task or `NULL` */
+{
+  if (!task)
+    return;
+
+  jobs_task_lock();
+  jobs_finish(task);
+  jobs_task_unlock();
+
+  free(task->dependents);
+  free(task);
+}
+
+
+/*
+ * 'jobs_exit_cb()' - Return any jobserver tokens still held at exit.
+ */
+
+static void
+jobs_exit_cb(void)
+{
+#ifndef _WIN32
+  jobs_lock();
+
+  while (jobs_num_tokens > 0)
+  {
+    jobs_num_tokens --;
+
+    if (write(jobs_wfd, jobs_tokens + jobs_num_tokens, 1) < 0 && errno != EINTR)
+      break;
+  }
+
+  jobs_active = 1;
+
+  if (jobs_ropen)
+  {
+    close(jobs_rfd);
+
+    if (jobs_wfd == jobs_rfd)
+      jobs_wfd = -1;
+
+    jobs_rfd = -1;
+  }
+
+  jobs_unlock();
+#endif /* !_WIN32 */
+}
+
+
+/*
+ * 'jobs_finish()' - Wait for a task to finish, running ready tasks.
+ *
+ * The task pool must be locked.
+ */
+
+static void
+jobs_finish(jobs_task_t *task)		/* I - Task */
+{
+  jobs_task_t	*ready;			/* Ready task */
+
+
+  while (!task->done)
+  {
+    if ((ready = jobs_take(0)) != NULL)
+      jobs_run(ready, 0);
+#ifdef HAVE_PTHREAD_H
+    else
+      pthread_cond_wait(&jobs_task_cond, &jobs_task_mutex);
+#else
+    else
+      break;
+#endif /* HAVE_PTHREAD_H */
+  }
+}
+
+
+/*
+ * 'jobs_lock()' - Lock the job state.
+ */
+
+static void
+jobs_lock(void)
+{
+#ifdef HAVE_PTHREAD_H
+  pthread_mutex_lock(&jobs_mutex);
+#endif /* HAVE_PTHREAD_H */
+}
+
+
+/*
+ * 'jobs_now()' - Get the current time in seconds.
+ */
+
+static double				/* O - Current time */
+jobs_now(void)
+{
+#ifdef _WIN32
+  return ((double)clock() / CLOCKS_PER_SEC);
+
+#else
+  struct timespec ts;			/* Current time */
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+
+  return ((double)ts.tv_sec + 0.000000001 * ts.tv_nsec);
+#endif /* _WIN32 */
+}
+
+
+/*
+ * 'jobs_open_server()' - Connect to the GNU make jobserver, if any.
+ */
+
+static bool				/* O - `true` if connected, `false` otherwise */
+jobs_open_server(void)
+{
+#ifdef _WIN32
+  return (false);
+
+#else
+  const char	*makeflags,		/* MAKEFLAGS environment variable */
+		*auth = NULL,		/* Jobserver authorization */
+		*ptr;			/* Pointer into MAKEFLAGS */
+  char		value[1024],		/* Authorization value */
+		*valptr,		/* Pointer into value */
+		path[256];		/* Path to inherited read descriptor */
+  int		rfd,			/* Read descriptor */
+		wfd;			/* Write descriptor */
+
+
+  if ((makeflags = getenv("MAKEFLAGS")) == NULL)
+    return (false);
+
+ /*
+  * Use the last jobserver option, as GNU make does; older versions of make use
+  * "--jobserver-fds"...
+  */
+
+  for (ptr = makeflags; (ptr = strstr(ptr, "--jobserver-")) != NULL; ptr ++)
+  {
+    if (!strncmp(ptr, "--jobserver-auth=", 17))
+      auth = ptr + 17;
+    else if (!strncmp(ptr, "--jobserver-fds=", 16))
+      auth = ptr + 16;
+  }
+
+  if (!auth)
+    return (false);
+
+  for (valptr = value; *auth && *auth != ' ' && valptr < (value + sizeof(value) - 1); *valptr++ = *auth++);
+  *valptr = '\0';
+
+  if (!strncmp(value, "fifo:", 5))
+  {
+   /*
+    * Named pipe (GNU make 4.4 and later) - open read/write so the open does
+    * not block, and non-blocking so reading a token never waits...
+    */
+
+    if ((rfd = open(value + 5, O_RDWR | O_NONBLOCK)) < 0)
+      return (false);
+
+    fcntl(rfd, F_SETFD, FD_CLOEXEC);
+
+    wfd = rfd;
+  }
+  else if (sscanf(value, "%d,%d", &rfd, &wfd) != 2 || rfd < 0 || wfd < 0 || fcntl(rfd, F_GETFD) < 0 || fcntl(wfd, F_GETFD) < 0)
+  {
+   /*
+    * Not a usable pipe, probably because the recipe was not marked with "+"
+    * so make closed the descriptors...
+    */
+
+    return (false);
+  }
+  else
+  {
+   /*
+    * Anonymous pipe - the inherited descriptor shares its blocking mode with
+    * make and every other job, so open a private non-blocking descriptor for
+    * the same pipe.  If that isn't possible, don't start any workers rather
+    * than risk blocking on an empty pipe...
+    */
+
+    snprintf(path, sizeof(path), "/proc/self/fd/%d", rfd);
+
+    if ((rfd = open(path, O_RDONLY | O_NONBLOCK)) < 0)
+    {
+      jobs_max    = 1;
+      jobs_serial = true;
+      return (false);
+    }
+
+    fcntl(rfd, F_SETFD, FD_CLOEXEC);
+  }
+
+  jobs_rfd   = rfd;
+  jobs_wfd   = wfd;
+  jobs_ropen = true;
+
+  return (true);
+#endif /* _WIN32 */
+}
+
+
+/*
+ * 'jobs_ready()' - Queue a task that is ready to run.
+ *
+ * The task pool must be locked.  The caller should call @link jobs_start@
+ * for the task after unlocking the task pool.
+ */
+
+static void
+jobs_ready(jobs_task_t *task,		/* I - Task */
+           size_t      queue)		/* I - Queue index */
+{
+  _jobs_queue_t	*q = jobs_queues + queue;
+					/* Queue */
+
+
+  task->next = NULL;
+
+  if ((task->prev = q->last[task->priority]) != NULL)
+    task->prev->next = task;
+  else
+    q->first[task->priority] = task;
+
+  q->last[task->priority] = task;
+}
+
+
+/*
+ * 'jobs_run()' - Run a task and queue any tasks that depend on it.
+ *
+ * The task pool must be locked, and is unlocked while the task runs.
+ */
+
+static void
+jobs_run(jobs_task_t *task,		/* I - Task */
+         size_t      queue)		/* I - Queue index for dependent tasks */
+{
+  size_t	i,			/* Looping var */
+		num_ready;		/* Number of newly ready tasks */
+  double	start;			/* Start time */
+
+
+  jobs_task_unlock();
+
+  start = jobs_now();
+
+  (task->cb)(task->data);
+
+  statsAddTask(task->phase, jobs_now() - start);
+
+  jobs_task_lock();
+
+  task->done = true;
+
+  for (i = 0, num_ready = 0; i < task->num_dependents; i ++)
+  {
+    if (-- task->dependents[i]->num_pending == 0)
+    {
+      jobs_ready(task->dependents[i], queue);
+      num_ready ++;
+    }
+  }
+
+#ifdef HAVE_PTHREAD_H
+  pthread_cond_broadcast(&jobs_task_cond);
+#endif /* HAVE_PTHREAD_H */
+
+  if (num_ready > 0)
+  {
+   /*
+    * Start workers for the newly ready tasks - the finished task may be freed
+    * as soon as the task pool is unlocked, so don't use it after this...
+    */
+
+    jobs_task_unlock();
+
+    while (num_ready > 0 && jobs_start())
+      num_ready --;
+
+    jobs_task_lock();
+  }
+}
+
+
+/*
+ * 'jobs_start()' - Start a worker for a ready task if the job limit allows it.
+ *
+ * The task pool must not be locked.
+ */
+
+static bool				/* O - `true` if a worker was started, `false` otherwise */
+jobs_start(void)
+{
+#ifdef HAVE_PTHREAD_H
+  size_t	i;			/* Looping var */
+  _jobs_queue_t	*q;			/* New queues */
+  pthread_t	tid;			/* Worker thread */
+  pthread_attr_t attr;			/* Worker thread attributes */
+  int		error;			/* Thread creation error */
+
+
+  if (!jobsAcquire())
+    return (false);
+
+ /*
+  * Find an unused queue for the new worker...
+  */
+
+  jobs_task_lock();
+
+  for (i = 1; i < jobs_num_queues; i ++)
+  {
+    if (!jobs_queues[i].active)
+      break;
+  }
+
+  if (i >= jobs_num_queues)
+  {
+    if ((q = realloc(jobs_queues, (jobs_num_queues + 1) * sizeof(_jobs_queue_t))) == NULL)
+    {
+      jobs_task_unlock();
+      jobsRelease();
+      return (false);
+    }
+
+    jobs_queues = q;
+    memset(jobs_queues + jobs_num_queues, 0, sizeof(_jobs_queue_t));
+    jobs_num_queues ++;
+  }
+
+  jobs_queues[i].active = true;
+
+  jobs_task_unlock();
+
+  pthread_attr_init(&attr);
+  pthread_attr_setstacksize(&attr, JOBS_STACK_SIZE);
+  pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+
+  error = pthread_create(&tid, &attr, jobs_worker, (void *)(uintptr_t)i);
+
+  pthread_attr_destroy(&attr);
+
+  if (error)
+  {
+    jobs_task_lock();
+    jobs_queues[i].active = false;
+    jobs_task_unlock();
+
+    jobsRelease();
+    return (false);
+  }
+
+  return (true);
+
+#else
+  return (false);
+#endif /* HAVE_PTHREAD_H */
+}
+
+
+/*
+ * 'jobs_take()' - Take the next ready task.
+ *
+ * The task pool must be locked.  Workers take the newest task from their own
+ * queue, then the oldest shared task, then steal the oldest task from another
+ * worker.
+ */
+
+static jobs_task_t *			/* O - Task or `NULL` if none are ready */
+jobs_take(size_t queue)			/* I - Queue index, 0 for a waiting thread */
+{
+  int		priority;		/* Current priority */
+  size_t	i;			/* Looping var */
+  _jobs_queue_t	*q;			/* Current queue */
+  jobs_task_t	*task;			/* Task */
+
+
+  for (priority = JOBS_PRIORITY_HIGH; priority >= JOBS_PRIORITY_LOW; priority --)
+  {
+    if (queue > 0 && (task = jobs_queues[queue].last[priority]) != NULL)
+    {
+      q = jobs_queues + queue;
+
+      if ((q->last[priority] = task->prev) != NULL)
+        task->prev->next = NULL;
+      else
+        q->first[priority] = NULL;
+
+      return (task);
+    }
+
+    for (i = 0, q = jobs_queues; i < jobs_num_queues; i ++, q ++)
+    {
+      if (i == queue && i > 0)
+        continue;
+
+      if ((task = q->first[priority]) != NULL)
+      {
+        if ((q->first[priority] = task->next) != NULL)
+          task->next->prev = NULL;
+        else
+          q->last[priority] = NULL;
+
+        return (task);
+      }
+    }
+  }
+
+  return (NULL);
+}
+
+
+/*
+ * 'jobs_task_lock()' - Lock the task pool.
+ */
+
+static void
+jobs_task_lock(void)
+{
+#ifdef HAVE_PTHREAD_H
+  pthread_mutex_lock(&jobs_task_mutex);
+#endif /* HAVE_PTHREAD_H */
+}
+
+
+/*
+ * 'jobs_task_unlock()' - Unlock the task pool.
+ */
+
+static void
+jobs_task_unlock(void)
+{
+#ifdef HAVE_PTHREAD_H
+  pthread_mutex_unlock(&jobs_task_mutex);
+#endif /* HAVE_PTHREAD_H */
+}
+
+
+/*
+ * 'jobs_unlock()' - Unlock the job state.
+ */
+
+static void
+jobs_unlock(void)
+{
+#ifdef HAVE_PTHREAD_H
+  pthread_mutex_unlock(&jobs_mutex);
+#endif /* HAVE_PTHREAD_H */
+}
+
+
+#ifdef HAVE_PTHREAD_H
+/*
+ * 'jobs_worker()' - Run tasks until there are none left.
+ */
+
+static void *				/* O - Thread exit status (unused) */
+jobs_worker(void *queue)		/* I - Queue index */
+{
+  size_t	i = (size_t)(uintptr_t)queue;
+					/* Queue index */
+  jobs_task_t	*task;			/* Current task */
+
+
+  jobs_task_lock();
+
+  while ((task = jobs_take(i)) != NULL)
+    jobs_run(task, i);
+
+  jobs_queues[i].active = false;
+
+  jobs_task_unlock();
+
+  jobsRelease();
+
+  return (NULL);
+}
+#endif /* HAVE_PTHREAD_H */
@@ -0,0 +1,60 @@
+/*
+ * Job limit and task pool header for codedoc.
+ *
+ *     https://www.msweet.org/codedoc
+ *
+ * Copyright © 2025 by Michael R Sweet.
+ *
+ * Licensed under Apache License v2.0.  See the file "LICENSE" for more
+ * information.
+ */
+
+#ifndef JOBS_H
+#  define JOBS_H
+#  include <stdbool.h>
+#  include <stddef.h>
+#  ifdef __cplusplus
+extern "C" {
+#  endif /* __cplusplus */
+
+
+/*
+ * Constants...
+ */
+
+typedef enum jobs_priority_e		/**** Task priorities ****/
+{
+  JOBS_PRIORITY_LOW,			/* Run after other tasks */
+  JOBS_PRIORITY_NORMAL,			/* Normal priority */
+  JOBS_PRIORITY_HIGH			/* Run before other tasks */
+} jobs_priority_t;
+
+
+/*
+ * Types...
+ */
+
+typedef struct _jobs_task_s jobs_task_t;/**** Task ****/
+
+typedef void (*jobs_task_cb_t)(void *data);
+					/**** Task function ****/
+
+
+/*
+ * Functions...
+ */
+
+extern bool		jobsAcquire(void);
+extern void		jobsChild(void);
+extern int		jobsGetMax(void);
+extern void		jobsInit(void);
+extern void		jobsRelease(void);
+extern void		jobsSetMax(int max_jobs);
+extern jobs_task_t	*jobsSubmit(jobs_task_cb_t cb, void *data, jobs_priority_t priority, size_t num_deps, jobs_task_t **deps);
+extern void		jobsWait(jobs_task_t *task);
+
+
+#  ifdef __cplusplus
+}
+#  endif /* __cplusplus */
+#endif /* !JOBS_H */
@@ -70,6 +70,22 @@
 #endif // _WIN32
 
 
+//
+// Route allocations through the codedoc statistics wrappers when enabled...
+//
+
+#ifdef CODEDOC_STATS
+#  include "stats.h"
+#endif // CODEDOC_STATS
+
+
+//
+// Static tracing probes when enabled...
+//
+
+#include "probes.h"
+
+
 //
 // Private structures...
 //
@@ -106,6 +122,12 @@ typedef struct _mmd_ref_s		// Reference link
   mmd_t		**pending;		// Pending nodes
 } _mmd_ref_t;
 
+typedef struct _mmd_delim_s		// Inline delimiter search
+{
+  const char	*delim;			// Delimiter string
+  char		*absent;		// Delimiter does not appear at or after here
+} _mmd_delim_t;
+
 typedef struct _mmd_doc_s		// Markdown document
 {
   mmd_t		*root;			// Root node
@@ -135,6 +157,7 @@ static mmd_option_t	mmd_options = MMD_OPTION_ALL;
 //
 
 static mmd_t	*mmd_add(mmd_t *parent, mmd_type_t type, int whitespace, char *text, char *url);
+static char	*mmd_find_delim(_mmd_delim_t *delims, char *s, const char *delim);
 static void	mmd_free(mmd_t *node);
 static int	mmd_has_continuation(const char *line, _mmd_filebuf_t *file, int indent);
 static size_t	mmd_iocb_file(FILE *fp, char *buffer, size_t bytes);
@@ -164,59 +187,37 @@ char *					// O - Copied string
 mmdCopyAllText(mmd_t *node)		// I - Parent node
 {
   char		*all = NULL,		// String buffer
-		*allptr = NULL,		// Pointer into string buffer
 		*temp;			// Temporary pointer
-  size_t	allsize = 0,		// Size of "all" buffer
+  size_t	alllen = 0,		// Length of "all" string
 		textlen;		// Length of "text" string
-  mmd_t		*current,		// Current node
-		*next;			// Next node
+  mmd_t		*current;		// Current node
+  mmd_walk_t	walk = MMD_WALK_ENTER;	// Walk event for current node
 
 
-  current = mmdGetFirstChild(node);
-
-  while (current != node)
+  for (current = mmdWalkNext(node, node, &walk); current && current != node; current = mmdWalkNext(current, node, &walk))
   {
-    if (current->text)
+    if (walk == MMD_WALK_ENTER && current->text)
     {
       // Append this node's text to the string...
       textlen = strlen(current->text);
-      allsize += textlen + (size_t)current->whitespace;
-      temp    = realloc(all, allsize);
 
-      if (!temp)
+      if ((temp = realloc(all, alllen + textlen + 2)) == NULL)
       {
 	free(all);
 	return (NULL);
       }
 
-      allptr = temp + (allptr - all);
-      all    = temp;
+      all = temp;
 
       if (current->whitespace)
-	*allptr++ = ' ';
-
-      memcpy(allptr, current->text, textlen);
-      allptr += textlen;
-    }
+	all[alllen ++] = ' ';
 
-    // Find the next logical node...
-    if ((next = mmdGetNextSibling(current)) == NULL)
-    {
-      next = mmdGetParent(current);
-
-      while (next && next != node && mmdGetNextSibling(next) == NULL)
-	next = mmdGetParent(next);
-
-      if (next != node)
-	next = mmdGetNextSibling(next);
+      memcpy(all + alllen, current->text, textlen);
+      alllen += textlen;
+      all[alllen] = '\0';
     }
-
-    current = next;
   }
 
-  if (allptr)
-    *allptr = '\0';
-
   return (all);
 }
 
@@ -445,8 +446,12 @@ mmdLoad(mmd_t      *root,		// I - Root node for document or `NULL` for a new doc
   if ((fp = fopen(filename, "r")) == NULL)
     return (NULL);
 
+  CODEDOC_PROBE1(markdown__load__start, filename);
+
   root = mmdLoadIO(root, (mmd_iocb_t)mmd_iocb_file, fp);
 
+  CODEDOC_PROBE2(markdown__load__done, filename, root);
+
   // Close and return...
   fclose(fp);
 
@@ -1128,6 +1133,47 @@ mmdSetOptions(mmd_option_t options)	// I - Options
 }
 
 
+//
+// 'mmdWalkNext()' - Return the next node in a walk of a markdown tree.
+//
+// The tree is walked without recursion, and each node is returned twice:
+// once with "walk" set to `MMD_WALK_ENTER` before its children (pre-order)
+// and once with `MMD_WALK_EXIT` after them (post-order).  Start with the top
+// node and `MMD_WALK_ENTER`.  Set "walk" to `MMD_WALK_EXIT` before calling
+// this function to skip the children of the current node.
+//
+
+mmd_t *					// O - Next node or `NULL` at the end
+mmdWalkNext(mmd_t      *node,		// I - Current node
+            mmd_t      *top,		// I - Top node
+            mmd_walk_t *walk)		// IO - Walk event for current/next node
+{
+  if (!node || !walk)
+    return (NULL);
+
+  if (*walk == MMD_WALK_ENTER)
+  {
+    // Descend into children, or leave a node without any...
+    if (node->first_child)
+      return (node->first_child);
+
+    *walk = MMD_WALK_EXIT;
+    return (node);
+  }
+
+  if (node == top)
+    return (NULL);
+
+  if (node->next_sibling)
+  {
+    *walk = MMD_WALK_ENTER;
+    return (node->next_sibling);
+  }
+
+  return (node->parent);
+}
+
+
 //
 // 'mmd_add()' - Add a new markdown node.
 //
@@ -1181,6 +1227,38 @@ mmd_add(mmd_t	   *parent,		// I - Parent node
 }
 
 
+//
+// 'mmd_find_delim()' - Find the next occurrence of an inline delimiter.
+//
+// The position after which each delimiter is known not to appear is remembered,
+// so a paragraph with many unmatched delimiters (e.g. "a < b" in prose) is only
+// scanned once for each kind of delimiter.
+//
+
+static char *				// O - Delimiter or `NULL` if not found
+mmd_find_delim(_mmd_delim_t *delims,	// I - Delimiter searches, terminated by an empty entry
+               char	    *s,		// I - Where to start
+               const char   *delim)	// I - Delimiter string
+{
+  char	*match;				// Matching delimiter
+
+
+  while (delims->delim && strcmp(delims->delim, delim))
+    delims ++;
+
+  if (delims->delim && s >= delims->absent)
+    return (NULL);
+
+  if ((match = strstr(s, delim)) == NULL)
+  {
+    delims->delim  = delim;
+    delims->absent = s;
+  }
+
+  return (match);
+}
+
+
 //
 // 'mmd_free()' - Free memory used by a node.
 //
@@ -1489,8 +1567,12 @@ mmd_parse_inline(_mmd_doc_t *doc,	// I - Document
 		*refname;		// Reference name
   const char	*delim = NULL;		// Delimiter
   size_t	delimlen = 0;		// Length of delimiter
+  char		*end;			// End delimiter
+  _mmd_delim_t	delims[9];		// Delimiter searches
 
 
+  memset(delims, 0, sizeof(delims));
+
   whitespace = parent->last_child != NULL;
 
   for (text = NULL, type = MMD_TYPE_NORMAL_TEXT; *lineptr; lineptr ++)
@@ -1634,7 +1716,7 @@ mmd_parse_inline(_mmd_doc_t *doc,	// I - Document
 	lineptr --;
       }
     }
-    else if (*lineptr == '<' && type != MMD_TYPE_CODE_TEXT && strchr(lineptr + 1, '>'))
+    else if (*lineptr == '<' && type != MMD_TYPE_CODE_TEXT && (end = mmd_find_delim(delims, lineptr + 1, ">")) != NULL)
     {
       // Autolink...
       *lineptr++ = '\0';
@@ -1648,7 +1730,7 @@ mmd_parse_inline(_mmd_doc_t *doc,	// I - Document
       }
 
       url      = lineptr;
-      lineptr  = strchr(lineptr, '>');
+      lineptr  = end;
       *lineptr = '\0';
 
       mmd_add(parent, MMD_TYPE_LINKED_TEXT, whitespace, url, url);
@@ -1658,8 +1740,6 @@ mmd_parse_inline(_mmd_doc_t *doc,	// I - Document
     }
     else if ((*lineptr == '*' || *lineptr == '_') && (!text || ispunct(lineptr[-1] & 255) || type != MMD_TYPE_NORMAL_TEXT) && type != MMD_TYPE_CODE_TEXT)
     {
-      const char *end;			// End delimiter
-
       if (type != MMD_TYPE_NORMAL_TEXT || !delim)
       {
 	if (!strncmp(lineptr, "**", 2))
@@ -1674,7 +1754,7 @@ mmd_parse_inline(_mmd_doc_t *doc,	// I - Document
 	delimlen = strlen(delim);
       }
 
-      if (type == MMD_TYPE_NORMAL_TEXT && delim && ((end = strstr(lineptr + delimlen, delim)) == NULL || end == (lineptr + delimlen) || isspace(end[-1] & 255)))
+      if (type == MMD_TYPE_NORMAL_TEXT && delim && ((end = mmd_find_delim(delims, lineptr + delimlen, delim)) == NULL || end == (lineptr + delimlen) || isspace(end[-1] & 255)))
       {
 	if (!text)
 	  text = lineptr;
@@ -1767,7 +1847,7 @@ mmd_parse_inline(_mmd_doc_t *doc,	// I - Document
 	}
       }
 
-      if (type != MMD_TYPE_CODE_TEXT && delim && !strstr(lineptr + delimlen, delim))
+      if (type != MMD_TYPE_CODE_TEXT && delim && !mmd_find_delim(delims, lineptr + delimlen, delim))
       {
 	if (!text)
 	  text = lineptr;
@@ -1853,8 +1933,11 @@ mmd_parse_inline(_mmd_doc_t *doc,	// I - Document
     }
     else if (*lineptr == '\\' && ispunct(lineptr[1] & 255) && type != MMD_TYPE_CODE_TEXT)
     {
-      // Escaped character...
-      memmove(lineptr, lineptr + 1, strlen(lineptr));
+      // Escaped character, remove the "\" by moving the text before it (not
+      // the rest of the line) over it...
+      memmove(text + 1, text, (size_t)(lineptr - text));
+      text ++;
+      lineptr ++;
     }
   }
 
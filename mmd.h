@@ -71,6 +71,12 @@ typedef enum mmd_type_e
   MMD_TYPE_CHECKBOX			// [ ] or [x]
 } mmd_type_t;
 
+typedef enum mmd_walk_e
+{
+  MMD_WALK_ENTER,			// Entering a node, before its children
+  MMD_WALK_EXIT				// Leaving a node, after its children
+} mmd_walk_t;
+
 
 //
 // Types...
@@ -104,6 +110,7 @@ extern mmd_t        *mmdLoadFile(mmd_t *root, FILE *fp);
 extern mmd_t        *mmdLoadIO(mmd_t *root, mmd_iocb_t cb, void *cbdata);
 extern mmd_t        *mmdLoadString(mmd_t *root, const char *s);
 extern void         mmdSetOptions(mmd_option_t options);
+extern mmd_t        *mmdWalkNext(mmd_t *node, mmd_t *top, mmd_walk_t *walk);
 
 
 #  ifdef __cplusplus
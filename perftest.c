@@ -0,0 +1,723 @@
+/*
+ * Adversarial-input performance tests for codedoc.
+ *
+ *     https://www.msweet.org/codedoc
+ *
+ * Each test generates a pathological input at two sizes, times codedoc (or
+ * the ZIP container code) on both, and fails if the time grows faster than
+ * the test's complexity budget, expressed as the maximum exponent "k" in
+ * O(n^k).  A quadratic regression in the scanner, markdown parser, writers,
+ * or ZIP code shows up as an exponent near 2 when the budget is 1.5.
+ *
+ * Usage:
+ *
+ *     ./perftest [--scale FACTOR] [--verbose] [path/to/codedoc]
+ *
+ * Copyright © 2025 by Michael R Sweet.
+ *
+ * Licensed under Apache License v2.0.  See the file "LICENSE" for more
+ * information.
+ */
+
+#include "zipc.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <math.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+
+/*
+ * Local constants...
+ */
+
+#define PERF_MAX_ARGS	8		/* Maximum codedoc arguments per test */
+#define PERF_MIN_TIME	0.02		/* Shortest time used for growth, in seconds */
+#define PERF_RATIO	4		/* Ratio of large to small input size */
+#define PERF_RUNS	3		/* Number of runs per size, best time wins */
+
+
+/*
+ * Local types...
+ */
+
+typedef struct perf_test_s		/**** Performance test ****/
+{
+  const char	*name;			/* Name of test */
+  size_t	size;			/* Small input size */
+  double	budget;			/* Maximum growth exponent */
+  int		(*generate)(const char *dir, size_t size);
+					/* Generate input files */
+  const char	*args[PERF_MAX_ARGS];	/* codedoc arguments, "@" prefix for files in the test directory */
+  int		(*run)(const char *dir, size_t size);
+					/* Run the test in-process or `NULL` for codedoc */
+} perf_test_t;
+
+
+/*
+ * Local functions...
+ */
+
+static int	gen_comment(const char *dir, size_t size);
+static int	gen_flat(const char *dir, size_t size);
+static int	gen_functions(const char *dir, size_t size);
+static int	gen_header(const char *dir, size_t size);
+static int	gen_nested(const char *dir, size_t size);
+static int	gen_stars(const char *dir, size_t size);
+static double	get_time(void);
+static FILE	*open_input(const char *dir, const char *name);
+static int	run_codedoc(const char *dir, const char * const *args);
+static int	run_graft(const char *dir, size_t size);
+static int	run_zipc(const char *dir, size_t size);
+static int	time_test(const perf_test_t *test, const char *dir, size_t size, double *secs);
+static void	usage(void);
+
+
+/*
+ * Local globals...
+ */
+
+static const char	*codedoc = "./codedoc";
+					/* codedoc program */
+static const perf_test_t tests[] =	/* Performance tests */
+{
+  { "scan-nested-braces", 200000, 1.5, gen_nested, { "@test.xml", "@input.c" }, NULL },
+  { "scan-flat-initializer", 50000, 1.5, gen_flat, { "@test.xml", "@input.c" }, NULL },
+  { "scan-long-comment", 1000000, 1.5, gen_comment, { "@test.xml", "@input.c" }, NULL },
+  { "scan-graft-header", 5000, 1.5, gen_header, { NULL }, run_graft },
+  { "markdown-stars", 250000, 1.5, gen_stars, { "--body", "@input.md" }, NULL },
+  { "write-html", 2000, 1.5, gen_functions, { "@functions.xml" }, NULL },
+  { "write-man", 2000, 1.5, gen_functions, { "--man", "functions", "@functions.xml" }, NULL },
+  { "write-epub", 2000, 1.5, gen_functions, { "--epub", "@test.epub", "@functions.xml" }, NULL },
+  { "zipc-entries", 5000, 1.5, NULL, { NULL }, run_zipc }
+};
+
+
+/*
+ * 'main()' - Run the performance tests.
+ */
+
+int					/* O - Exit status */
+main(int  argc,				/* I - Number of command-line args */
+     char *argv[])			/* I - Command-line args */
+{
+  int		i;			/* Looping var */
+  double	scale = 1.0;		/* Input size scaling */
+  int		verbose = 0;		/* Show progress? */
+  char		dir[] = "perftest-XXXXXX";
+					/* Test directory */
+  const perf_test_t *test;		/* Current test */
+  size_t	small,			/* Small input size */
+		large;			/* Large input size */
+  double	tsmall,			/* Time for small input */
+		tlarge,			/* Time for large input */
+		exponent;		/* Growth exponent */
+  int		failures = 0;		/* Number of failed tests */
+  char		filename[1024];		/* Test file */
+  static const char * const files[] =	/* Files created by the tests */
+  {
+    "functions.xml", "input.c", "input.h", "input.md", "stats.txt", "test.epub", "test.xml", "test.zip"
+  };
+
+
+  for (i = 1; i < argc; i ++)
+  {
+    if (!strcmp(argv[i], "--scale"))
+    {
+     /*
+      * --scale FACTOR
+      */
+
+      i ++;
+      if (i >= argc || (scale = strtod(argv[i], NULL)) <= 0.0)
+      {
+        fputs("perftest: Missing or bad scale factor after --scale.\n", stderr);
+        usage();
+      }
+    }
+    else if (!strcmp(argv[i], "--verbose"))
+    {
+     /*
+      * --verbose
+      */
+
+      verbose = 1;
+    }
+    else if (argv[i][0] == '-')
+    {
+      fprintf(stderr, "perftest: Unknown option \"%s\".\n", argv[i]);
+      usage();
+    }
+    else
+      codedoc = argv[i];
+  }
+
+  if (access(codedoc, X_OK))
+  {
+    fprintf(stderr, "perftest: Unable to run \"%s\": %s\n", codedoc, strerror(errno));
+    return (1);
+  }
+
+  if (!mkdtemp(dir))
+  {
+    fprintf(stderr, "perftest: Unable to create test directory: %s\n", strerror(errno));
+    return (1);
+  }
+
+  for (test = tests; test < (tests + sizeof(tests) / sizeof(tests[0])); test ++)
+  {
+    small = (size_t)(test->size * scale);
+    large = small * PERF_RATIO;
+
+    if (verbose)
+    {
+      printf("%s: running with %lu and %lu...\n", test->name, (unsigned long)small, (unsigned long)large);
+      fflush(stdout);
+    }
+
+    if (time_test(test, dir, small, &tsmall) || time_test(test, dir, large, &tlarge))
+    {
+      printf("%-24s FAIL (unable to run test)\n", test->name);
+      failures ++;
+      continue;
+    }
+
+   /*
+    * Very short runs are dominated by process startup and timer noise, so
+    * clamp both times before computing the growth exponent...
+    */
+
+    exponent = log((tlarge > PERF_MIN_TIME ? tlarge : PERF_MIN_TIME) / (tsmall > PERF_MIN_TIME ? tsmall : PERF_MIN_TIME)) / log((double)PERF_RATIO);
+
+    printf("%-24s %9lu %8.3fs %9lu %8.3fs  O(n^%.2f) <= O(n^%.1f) %s\n", test->name, (unsigned long)small, tsmall, (unsigned long)large, tlarge, exponent, test->budget, exponent <= test->budget ? "PASS" : "FAIL");
+
+    if (exponent > test->budget)
+      failures ++;
+  }
+
+  for (i = 0; i < (int)(sizeof(files) / sizeof(files[0])); i ++)
+  {
+    snprintf(filename, sizeof(filename), "%s/%s", dir, files[i]);
+    unlink(filename);
+  }
+
+  if (rmdir(dir))
+    fprintf(stderr, "perftest: Unable to remove \"%s\": %s\n", dir, strerror(errno));
+
+  if (failures)
+  {
+    printf("%d test(s) failed.\n", failures);
+    return (1);
+  }
+
+  puts("All tests passed.");
+
+  return (0);
+}
+
+
+/*
+ * 'gen_comment()' - Generate a function whose comment is one very long line.
+ */
+
+static int				/* O - 0 on success, -1 on error */
+gen_comment(const char *dir,		/* I - Test directory */
+            size_t     size)		/* I - Number of words */
+{
+  FILE		*fp;			/* Input file */
+  size_t	i;			/* Looping var */
+
+
+  if ((fp = open_input(dir, "input.c")) == NULL)
+    return (-1);
+
+  fputs("/*\n * 'longComment()' - ", fp);
+  for (i = 0; i < size; i ++)
+    fprintf(fp, "word%lu ", (unsigned long)(i % 100));
+  fputs("\n */\n\nint\nlongComment(void)\n{\n  return (0);\n}\n", fp);
+
+  return (fclose(fp) ? -1 : 0);
+}
+
+
+/*
+ * 'gen_flat()' - Generate a huge array initializer.
+ */
+
+static int				/* O - 0 on success, -1 on error */
+gen_flat(const char *dir,		/* I - Test directory */
+         size_t     size)		/* I - Number of elements */
+{
+  FILE		*fp;			/* Input file */
+  size_t	i;			/* Looping var */
+
+
+  if ((fp = open_input(dir, "input.c")) == NULL)
+    return (-1);
+
+  fputs("/* Flat table */\nconst int flat[][3] =\n{\n", fp);
+  for (i = 0; i < size; i ++)
+    fprintf(fp, "  { %lu, 0x%lx, -1 },\n", (unsigned long)i, (unsigned long)i);
+  fputs("};\n\n/*\n * 'flatFunction()' - Function after the table.\n */\n\nint\nflatFunction(void)\n{\n  return (flat[0][0]);\n}\n", fp);
+
+  return (fclose(fp) ? -1 : 0);
+}
+
+
+/*
+ * 'gen_functions()' - Generate an XML file with many documented functions.
+ */
+
+static int				/* O - 0 on success, -1 on error */
+gen_functions(const char *dir,		/* I - Test directory */
+              size_t     size)		/* I - Number of functions */
+{
+  FILE		*fp;			/* Input file */
+  size_t	i;			/* Looping var */
+  char		filename[1024];		/* XML filename */
+  const char	*args[3];		/* codedoc arguments */
+
+
+  if ((fp = open_input(dir, "input.c")) == NULL)
+    return (-1);
+
+  fputs("/* Test structure */\ntypedef struct test_s\n{\n  int value; /* Value */\n} test_t;\n\n", fp);
+  for (i = 0; i < size; i ++)
+    fprintf(fp, "/*\n * 'testFunction%lu()' - Do something with a `test_t` value.\n *\n * This function uses @link testFunction%lu@ and has a *short* description.\n */\n\nint\t\t\t\t/* O - Result */\ntestFunction%lu(test_t *t,\t/* I - Test value */\n  int count)\t\t\t/* I - Count */\n{\n  return (t->value + count);\n}\n\n", (unsigned long)i, (unsigned long)(i / 2), (unsigned long)i);
+
+  if (fclose(fp))
+    return (-1);
+
+  snprintf(filename, sizeof(filename), "%s/functions.xml", dir);
+  unlink(filename);
+
+  args[0] = "@functions.xml";
+  args[1] = "@input.c";
+  args[2] = NULL;
+
+  return (run_codedoc(dir, args));
+}
+
+
+/*
+ * 'gen_header()' - Generate a header with many documented prototypes.
+ */
+
+static int				/* O - 0 on success, -1 on error */
+gen_header(const char *dir,		/* I - Test directory */
+           size_t     size)		/* I - Number of prototypes */
+{
+  FILE		*fp;			/* Input file */
+  size_t	i;			/* Looping var */
+
+
+  if ((fp = open_input(dir, "input.h")) == NULL)
+    return (-1);
+
+  fputs("/*\n * Test header.\n */\n\n#ifndef TEST_H\n#  define TEST_H\n\n", fp);
+  for (i = 0; i < size; i ++)
+    fprintf(fp, "/*\n * 'testFunction%lu()' - Do something with a value.\n */\n\nextern int\t\t\t/* O - Result */\ntestFunction%lu(int value,\t/* I - Value */\n  int count);\t\t/* I - Count */\n\n", (unsigned long)i, (unsigned long)i);
+  fputs("#endif /* !TEST_H */\n", fp);
+
+  return (fclose(fp) ? -1 : 0);
+}
+
+
+/*
+ * 'gen_nested()' - Generate a deeply nested initializer.
+ */
+
+static int				/* O - 0 on success, -1 on error */
+gen_nested(const char *dir,		/* I - Test directory */
+           size_t     size)		/* I - Nesting depth */
+{
+  FILE		*fp;			/* Input file */
+  size_t	i;			/* Looping var */
+
+
+  if ((fp = open_input(dir, "input.c")) == NULL)
+    return (-1);
+
+  fputs("/* Nested table */\nconst struct nested_s nested =\n", fp);
+  for (i = 0; i < size; i ++)
+    fputs("{ 1, ", fp);
+  fputs("0", fp);
+  for (i = 0; i < size; i ++)
+    putc('}', fp);
+  fputs(";\n\n/*\n * 'nestedFunction()' - Function after the table.\n */\n\nint\nnestedFunction(void)\n{\n  return (0);\n}\n", fp);
+
+  return (fclose(fp) ? -1 : 0);
+}
+
+
+/*
+ * 'gen_stars()' - Generate markdown with lots of unbalanced emphasis.
+ */
+
+static int				/* O - 0 on success, -1 on error */
+gen_stars(const char *dir,		/* I - Test directory */
+          size_t     size)		/* I - Number of asterisks */
+{
+  FILE		*fp;			/* Input file */
+  size_t	i;			/* Looping var */
+  static const char * const runs[] =	/* Emphasis runs */
+  {
+    "*a ", "**b ", "* ", "***c ", "`d ", "<e ", "\\*f "
+  };
+
+
+  if ((fp = open_input(dir, "input.md")) == NULL)
+    return (-1);
+
+  fputs("Stars\n=====\n\n", fp);
+  for (i = 0; i < size; i ++)
+  {
+    fputs(runs[i % (sizeof(runs) / sizeof(runs[0]))], fp);
+
+    if ((i % 1000) == 999)
+      fputs((i % 10000) == 9999 ? "\n\n" : "\n", fp);
+  }
+  putc('\n', fp);
+
+  return (fclose(fp) ? -1 : 0);
+}
+
+
+/*
+ * 'get_time()' - Get the current monotonic time in seconds.
+ */
+
+static double				/* O - Time in seconds */
+get_time(void)
+{
+  struct timespec ts;			/* Current time */
+
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+
+  return ((double)ts.tv_sec + 0.000000001 * (double)ts.tv_nsec);
+}
+
+
+/*
+ * 'open_input()' - Create an input file in the test directory.
+ */
+
+static FILE *				/* O - File or `NULL` on error */
+open_input(const char *dir,		/* I - Test directory */
+           const char *name)		/* I - Filename */
+{
+  FILE	*fp;				/* Input file */
+  char	filename[1024];			/* Full filename */
+
+
+  snprintf(filename, sizeof(filename), "%s/%s", dir, name);
+
+  if ((fp = fopen(filename, "w")) == NULL)
+    fprintf(stderr, "perftest: Unable to create \"%s\": %s\n", filename, strerror(errno));
+
+  return (fp);
+}
+
+
+/*
+ * 'run_codedoc()' - Run codedoc with the named arguments.
+ *
+ * Arguments starting with "@" name files in the test directory.  The standard
+ * input and output are redirected to /dev/null.
+ */
+
+static int				/* O - 0 on success, -1 on error */
+run_codedoc(const char         *dir,	/* I - Test directory */
+            const char * const *args)	/* I - Arguments */
+{
+  int		i;			/* Looping var */
+  char		*argv[PERF_MAX_ARGS + 2],/* Command-line arguments */
+		files[PERF_MAX_ARGS][1024];
+					/* Filenames */
+  pid_t		pid;			/* Child process ID */
+  int		status;			/* Exit status */
+
+
+  argv[0] = (char *)codedoc;
+
+  for (i = 0; i < PERF_MAX_ARGS && args[i]; i ++)
+  {
+    if (args[i][0] == '@')
+    {
+      snprintf(files[i], sizeof(files[i]), "%s/%s", dir, args[i] + 1);
+      argv[i + 1] = files[i];
+    }
+    else
+      argv[i + 1] = (char *)args[i];
+  }
+
+  argv[i + 1] = NULL;
+
+  if ((pid = fork()) < 0)
+  {
+    fprintf(stderr, "perftest: Unable to run \"%s\": %s\n", codedoc, strerror(errno));
+    return (-1);
+  }
+  else if (pid == 0)
+  {
+    int fd = open("/dev/null", O_RDWR);	/* /dev/null */
+
+    if (fd >= 0)
+    {
+      dup2(fd, 0);
+      dup2(fd, 1);
+      close(fd);
+    }
+
+    execv(codedoc, argv);
+    _exit(127);
+  }
+
+  while (waitpid(pid, &status, 0) < 0)
+  {
+    if (errno != EINTR)
+      return (-1);
+  }
+
+  if (!WIFEXITED(status) || WEXITSTATUS(status))
+  {
+    fprintf(stderr, "perftest: \"%s\" failed with status %d.\n", codedoc, status);
+    return (-1);
+  }
+
+  return (0);
+}
+
+
+/*
+ * 'run_graft()' - Scan a large header in parallel and make sure the
+ *                 speculatively scanned chunks are used.
+ */
+
+static int				/* O - 0 on success, -1 on error */
+run_graft(const char *dir,		/* I - Test directory */
+          size_t     size)		/* I - Number of prototypes */
+{
+  int		fd,			/* Statistics file */
+		errfd,			/* Saved standard error */
+		ret;			/* Return value */
+  FILE		*fp;			/* Statistics file */
+  char		filename[1024],		/* Statistics filename */
+		line[256];		/* Line from statistics */
+  unsigned long	grafted = 0,		/* Grafted chunks */
+		chunks = 0;		/* Speculatively scanned chunks */
+  static const char * const args[] =	/* codedoc arguments */
+  {
+    "--jobs", "4", "--stats", "@test.xml", "@input.h", NULL
+  };
+
+
+  (void)size;
+
+ /*
+  * Run codedoc with the standard error redirected to the statistics file...
+  */
+
+  snprintf(filename, sizeof(filename), "%s/test.xml", dir);
+  unlink(filename);
+
+  snprintf(filename, sizeof(filename), "%s/stats.txt", dir);
+
+  if ((fd = open(filename, O_WRONLY | O_CREAT | O_TRUNC, 0644)) < 0)
+  {
+    fprintf(stderr, "perftest: Unable to create \"%s\": %s\n", filename, strerror(errno));
+    return (-1);
+  }
+
+  fflush(stderr);
+  errfd = dup(2);
+  dup2(fd, 2);
+  close(fd);
+
+  ret = run_codedoc(dir, args);
+
+  dup2(errfd, 2);
+  close(errfd);
+
+  if (ret)
+    return (-1);
+
+ /*
+  * Look for the speculative scan report...
+  */
+
+  if ((fp = fopen(filename, "r")) == NULL)
+  {
+    fprintf(stderr, "perftest: Unable to open \"%s\": %s\n", filename, strerror(errno));
+    return (-1);
+  }
+
+  while (fgets(line, sizeof(line), fp))
+  {
+    if (sscanf(line, "Speculative scan: %lu of %lu chunks grafted", &grafted, &chunks) == 2)
+      break;
+  }
+
+  fclose(fp);
+
+  if (!chunks)
+  {
+   /*
+    * Small --scale factors can make the header too small to split, so there
+    * is nothing to check...
+    */
+
+    return (0);
+  }
+  else if (!grafted)
+  {
+    fprintf(stderr, "perftest: None of the %lu speculatively scanned chunks were grafted.\n", chunks);
+    return (-1);
+  }
+
+  return (0);
+}
+
+
+/*
+ * 'run_zipc()' - Write and read back a ZIP container with many small entries.
+ */
+
+static int				/* O - 0 on success, -1 on error */
+run_zipc(const char *dir,		/* I - Test directory */
+         size_t     size)		/* I - Number of entries */
+{
+  zipc_t	*zc;			/* ZIP container */
+  zipc_file_t	*zf;			/* ZIP file */
+  size_t	i;			/* Looping var */
+  char		filename[1024],		/* Container filename */
+		name[256],		/* Entry name */
+		line[256];		/* Line from entry */
+
+
+  snprintf(filename, sizeof(filename), "%s/test.zip", dir);
+
+  if ((zc = zipcOpen(filename, "w")) == NULL)
+  {
+    fprintf(stderr, "perftest: Unable to create \"%s\": %s\n", filename, strerror(errno));
+    return (-1);
+  }
+
+  for (i = 0; i < size; i ++)
+  {
+    snprintf(name, sizeof(name), "OEBPS/chapter%lu.xhtml", (unsigned long)i);
+    if ((zf = zipcCreateFile(zc, name, (int)(i & 1))) == NULL)
+      break;
+
+    zipcFilePrintf(zf, "<p>Entry %lu of %lu.</p>\n", (unsigned long)i, (unsigned long)size);
+
+    if (zipcFileFinish(zf))
+      break;
+  }
+
+  if (zipcClose(zc) || i < size)
+  {
+    fprintf(stderr, "perftest: Unable to write \"%s\".\n", filename);
+    return (-1);
+  }
+
+ /*
+  * Read back the last few entries; looking up an entry is a linear search, so
+  * only a fixed number are opened...
+  */
+
+  if ((zc = zipcOpen(filename, "r")) == NULL)
+  {
+    fprintf(stderr, "perftest: Unable to open \"%s\": %s\n", filename, strerror(errno));
+    return (-1);
+  }
+
+  for (i = size > 10 ? size - 10 : 0; i < size; i ++)
+  {
+    snprintf(name, sizeof(name), "OEBPS/chapter%lu.xhtml", (unsigned long)i);
+    if ((zf = zipcOpenFile(zc, name)) == NULL || zipcFileGets(zf, line, sizeof(line)))
+      break;
+  }
+
+  zipcClose(zc);
+
+  if (i < size)
+  {
+    fprintf(stderr, "perftest: Unable to read \"%s\" from \"%s\".\n", name, filename);
+    return (-1);
+  }
+
+  return (0);
+}
+
+
+/*
+ * 'time_test()' - Generate the input for a test and time it.
+ */
+
+static int				/* O - 0 on success, -1 on error */
+time_test(const perf_test_t *test,	/* I - Test */
+          const char        *dir,	/* I - Test directory */
+          size_t            size,	/* I - Input size */
+          double            *secs)	/* O - Best time in seconds */
+{
+  int		run;			/* Current run */
+  double	start,			/* Start time */
+		elapsed;		/* Elapsed time */
+
+
+  *secs = 0.0;
+
+  if (test->generate && (test->generate)(dir, size))
+    return (-1);
+
+  for (run = 0; run < PERF_RUNS; run ++)
+  {
+    start = get_time();
+
+    if (test->run)
+    {
+      if ((test->run)(dir, size))
+        return (-1);
+    }
+    else
+    {
+      char filename[1024];		/* XML output file */
+
+     /*
+      * Always start from an empty XML file so runs don't merge...
+      */
+
+      snprintf(filename, sizeof(filename), "%s/test.xml", dir);
+      unlink(filename);
+      start = get_time();
+
+      if (run_codedoc(dir, test->args))
+        return (-1);
+    }
+
+    elapsed = get_time() - start;
+
+    if (run == 0 || elapsed < *secs)
+      *secs = elapsed;
+  }
+
+  return (0);
+}
+
+
+/*
+ * 'usage()' - Show program usage.
+ */
+
+static void
+usage(void)
+{
+  puts("Usage: ./perftest [--scale FACTOR] [--verbose] [path/to/codedoc]");
+  exit(1);
+}
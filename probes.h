@@ -0,0 +1,39 @@
+/*
+ * Static tracing probes header for codedoc.
+ *
+ *     https://www.msweet.org/codedoc
+ *
+ * Copyright © 2025 by Michael R Sweet.
+ *
+ * Licensed under Apache License v2.0.  See the file "LICENSE" for more
+ * information.
+ */
+
+#ifndef PROBES_H
+#  define PROBES_H
+
+
+/*
+ * When <sys/sdt.h> is available each probe compiles to a single "nop"
+ * instruction plus a note describing where its arguments are, which tools
+ * like bpftrace and "perf probe" patch at run-time.  Otherwise the probes
+ * (and their arguments) compile to nothing.  Probe arguments should be values
+ * that are already computed so that the probes cost nothing when they are not
+ * attached.
+ *
+ * Probes are named "codedoc:NAME", for example:
+ *
+ *     bpftrace -e 'usdt:./codedoc:codedoc:scan__done { printf("%s\n", str(arg0)); }'
+ */
+
+#  ifdef HAVE_SYS_SDT_H
+#    include <sys/sdt.h>
+#    define CODEDOC_PROBE1(name,a)	DTRACE_PROBE1(codedoc, name, a)
+#    define CODEDOC_PROBE2(name,a,b)	DTRACE_PROBE2(codedoc, name, a, b)
+#    define CODEDOC_PROBE3(name,a,b,c)	DTRACE_PROBE3(codedoc, name, a, b, c)
+#  else
+#    define CODEDOC_PROBE1(name,a)
+#    define CODEDOC_PROBE2(name,a,b)
+#    define CODEDOC_PROBE3(name,a,b,c)
+#  endif /* HAVE_SYS_SDT_H */
+#endif /* !PROBES_H */
@@ -0,0 +1,682 @@
+/*
+ * Run-time statistics for codedoc.
+ *
+ *     https://www.msweet.org/codedoc
+ *
+ * Phase timing and task pool utilization are always available.  Allocation
+ * accounting is only compiled in when CODEDOC_STATS is defined (configure
+ * --enable-stats), in which case the malloc, calloc, realloc, strdup, and free
+ * calls in codedoc.c, jobs.c, mmd.c, and zipc.c are routed through the
+ * functions below.  Allocations made inside
+ * Mini-XML are not seen by these wrappers.
+ *
+ * Copyright © 2025 by Michael R Sweet.
+ *
+ * Licensed under Apache License v2.0.  See the file "LICENSE" for more
+ * information.
+ */
+
+#define STATS_NO_WRAPPERS
+#include "stats.h"
+#include <stdint.h>
+#include <time.h>
+#ifdef HAVE_PTHREAD_H
+#  include <pthread.h>
+#endif /* HAVE_PTHREAD_H */
+
+
+/*
+ * Local constants...
+ */
+
+#define STATS_MAX_SITES	1024		/* Maximum number of call sites */
+#define STATS_TOP_SITES	10		/* Number of call sites to report */
+
+
+/*
+ * Locking for the current phase and the allocation tables, which are used
+ * from the input prefetch thread and task pool workers...
+ */
+
+#ifdef HAVE_PTHREAD_H
+static pthread_mutex_t	stats_mutex = PTHREAD_MUTEX_INITIALIZER;
+#  define stats_lock()		pthread_mutex_lock(&stats_mutex)
+#  define stats_unlock()	pthread_mutex_unlock(&stats_mutex)
+#else
+#  define stats_lock()
+#  define stats_unlock()
+#endif /* HAVE_PTHREAD_H */
+
+#ifdef HAVE_PTHREAD_H
+static pthread_mutex_t	stats_task_mutex = PTHREAD_MUTEX_INITIALIZER;
+#  define stats_task_lock()	pthread_mutex_lock(&stats_task_mutex)
+#  define stats_task_unlock()	pthread_mutex_unlock(&stats_task_mutex)
+#else
+#  define stats_task_lock()
+#  define stats_task_unlock()
+#endif /* HAVE_PTHREAD_H */
+
+
+/*
+ * Local types...
+ */
+
+typedef struct _stats_site_s		/* Allocation call site */
+{
+  const char	*file;			/* Source file */
+  int		line;			/* Source line */
+  size_t	count[STATS_PHASE_MAX],	/* Number of allocations */
+		bytes[STATS_PHASE_MAX];	/* Number of bytes allocated */
+} _stats_site_t;
+
+typedef struct _stats_ptr_s		/* Live allocation */
+{
+  void		*ptr;			/* Pointer */
+  size_t	size;			/* Size of allocation */
+} _stats_ptr_t;
+
+typedef struct _stats_sorted_s		/* Call site sorted for a report */
+{
+  size_t	bytes;			/* Bytes allocated in the phase */
+  _stats_site_t	*site;			/* Call site */
+} _stats_sorted_t;
+
+
+/*
+ * Local globals...
+ */
+
+static const char * const stats_phases[STATS_PHASE_MAX] =
+{					/* Phase names */
+  "startup",
+  "load",
+  "scan",
+  "save",
+  "render"
+};
+
+static stats_phase_t	stats_phase = STATS_PHASE_STARTUP;
+					/* Current phase */
+static double		stats_start = 0.0,
+					/* Start time of current phase */
+			stats_time[STATS_PHASE_MAX];
+					/* Time spent in each phase */
+static int		stats_started = 0;
+					/* Has statsStart been called? */
+static size_t		stats_tasks[STATS_PHASE_MAX];
+					/* Tasks run in each phase */
+static double		stats_task_time[STATS_PHASE_MAX];
+					/* Time spent running tasks in each phase */
+static size_t		stats_chunks = 0,
+					/* Speculatively scanned chunks */
+			stats_grafted = 0;
+					/* Chunks grafted into the serial scan */
+
+#ifdef CODEDOC_STATS
+static size_t		stats_count[STATS_PHASE_MAX],
+					/* Allocations per phase */
+			stats_bytes[STATS_PHASE_MAX],
+					/* Bytes allocated per phase */
+			stats_peak[STATS_PHASE_MAX],
+					/* Peak live bytes per phase */
+			stats_live = 0;	/* Current live bytes */
+static _stats_site_t	stats_sites[STATS_MAX_SITES];
+					/* Call sites (hashed) */
+static size_t		stats_num_sites = 0;
+					/* Number of call sites */
+static _stats_ptr_t	*stats_ptrs = NULL;
+					/* Live pointers (hashed) */
+static size_t		stats_alloc_ptrs = 0,
+					/* Allocated pointer slots */
+			stats_num_ptrs = 0;
+					/* Number of live pointers */
+#endif /* CODEDOC_STATS */
+
+
+/*
+ * Local functions...
+ */
+
+static double		stats_now(void);
+static void		stats_report_cb(void);
+static double		stats_workers(stats_phase_t phase);
+#ifdef CODEDOC_STATS
+static void		stats_add(void *ptr, size_t size, const char *file, int line);
+static size_t		stats_ptr_hash(void *ptr, size_t alloc_ptrs);
+static size_t		stats_remove(void *ptr);
+static int		stats_site_compare(_stats_sorted_t *a, _stats_sorted_t *b);
+#endif /* CODEDOC_STATS */
+
+
+/*
+ * 'statsAddChunks()' - Record the speculatively scanned chunks of a file.
+ */
+
+void
+statsAddChunks(size_t chunks,		/* I - Number of chunks scanned in parallel */
+               size_t grafted)		/* I - Number of chunks grafted */
+{
+  stats_task_lock();
+  stats_chunks  += chunks;
+  stats_grafted += grafted;
+  stats_task_unlock();
+}
+
+
+/*
+ * 'statsAddTask()' - Record the time spent running a task from the task pool.
+ */
+
+void
+statsAddTask(stats_phase_t phase,	/* I - Phase when the task was submitted */
+             double        seconds)	/* I - Time spent running the task */
+{
+  stats_task_lock();
+  stats_tasks[phase] ++;
+  stats_task_time[phase] += seconds;
+  stats_task_unlock();
+}
+
+
+/*
+ * 'statsChild()' - Disable the report at exit in a forked child process.
+ *
+ * The child inherits the exit handler from @link statsStart@, but only the
+ * parent should write the report.
+ */
+
+void
+statsChild(void)
+{
+  stats_started = 0;
+}
+
+
+#ifdef CODEDOC_STATS
+/*
+ * 'statsCalloc()' - Allocate and clear memory.
+ */
+
+void *					/* O - New memory or `NULL` */
+statsCalloc(size_t     num,		/* I - Number of elements */
+            size_t     size,		/* I - Size of each element */
+            const char *file,		/* I - Source file */
+            int        line)		/* I - Source line */
+{
+  void	*ptr = calloc(num, size);	/* New memory */
+
+
+  if (ptr)
+  {
+    stats_lock();
+    stats_add(ptr, num * size, file, line);
+    stats_unlock();
+  }
+
+  return (ptr);
+}
+
+
+/*
+ * 'statsFree()' - Free memory.
+ */
+
+void
+statsFree(void *ptr)			/* I - Memory to free */
+{
+  if (ptr)
+  {
+    stats_lock();
+    stats_remove(ptr);
+    stats_unlock();
+
+    free(ptr);
+  }
+}
+#endif /* CODEDOC_STATS */
+
+
+/*
+ * 'statsGetPhase()' - Get the current processing phase.
+ */
+
+stats_phase_t				/* O - Current phase */
+statsGetPhase(void)
+{
+  stats_phase_t	phase;			/* Current phase */
+
+
+  stats_lock();
+  phase = stats_phase;
+  stats_unlock();
+
+  return (phase);
+}
+
+
+#ifdef CODEDOC_STATS
+/*
+ * 'statsMalloc()' - Allocate memory.
+ */
+
+void *					/* O - New memory or `NULL` */
+statsMalloc(size_t     size,		/* I - Number of bytes */
+            const char *file,		/* I - Source file */
+            int        line)		/* I - Source line */
+{
+  void	*ptr = malloc(size);		/* New memory */
+
+
+  if (ptr)
+  {
+    stats_lock();
+    stats_add(ptr, size, file, line);
+    stats_unlock();
+  }
+
+  return (ptr);
+}
+
+
+/*
+ * 'statsRealloc()' - Reallocate memory.
+ *
+ * A reallocation counts as an allocation of the new size.
+ */
+
+void *					/* O - New memory or `NULL` */
+statsRealloc(void       *ptr,		/* I - Old memory or `NULL` */
+             size_t     size,		/* I - New number of bytes */
+             const char *file,		/* I - Source file */
+             int        line)		/* I - Source line */
+{
+  void		*newptr;		/* New memory */
+  size_t	oldsize;		/* Old size */
+
+
+  if (!ptr)
+    return (statsMalloc(size, file, line));
+
+  stats_lock();
+
+  oldsize = stats_remove(ptr);
+
+  if ((newptr = realloc(ptr, size)) != NULL)
+  {
+    stats_add(newptr, size, file, line);
+  }
+  else if (oldsize)
+  {
+   /*
+    * Old memory is still allocated...
+    */
+
+    stats_add(ptr, oldsize, NULL, 0);
+  }
+
+  stats_unlock();
+
+  return (newptr);
+}
+#endif /* CODEDOC_STATS */
+
+
+/*
+ * 'statsReport()' - Write a report of the collected statistics.
+ */
+
+void
+statsReport(FILE *fp)			/* I - Output file */
+{
+  stats_phase_t	phase;			/* Current phase */
+
+
+  statsSetPhase(statsGetPhase());
+
+#ifdef CODEDOC_STATS
+  fputs("Phase     Time (s)    Tasks  Workers     Allocs         Bytes     Peak Bytes\n", fp);
+  for (phase = STATS_PHASE_STARTUP; phase < STATS_PHASE_MAX; phase ++)
+    fprintf(fp, "%-8s %9.3f %8lu %8.2f %10lu %13lu %14lu\n", stats_phases[phase], stats_time[phase], (unsigned long)stats_tasks[phase], stats_workers(phase), (unsigned long)stats_count[phase], (unsigned long)stats_bytes[phase], (unsigned long)stats_peak[phase]);
+
+  for (phase = STATS_PHASE_STARTUP; phase < STATS_PHASE_MAX; phase ++)
+  {
+    size_t		i,		/* Looping var */
+			num_sorted;	/* Number of sorted sites */
+    _stats_sorted_t	sorted[STATS_MAX_SITES];
+					/* Sorted sites */
+
+    if (!stats_count[phase])
+      continue;
+
+    stats_lock();
+    for (i = 0, num_sorted = 0; i < STATS_MAX_SITES; i ++)
+    {
+      if (stats_sites[i].file && stats_sites[i].count[phase])
+      {
+        sorted[num_sorted].bytes  = stats_sites[i].bytes[phase];
+        sorted[num_sorted ++].site = stats_sites + i;
+      }
+    }
+    stats_unlock();
+
+    qsort(sorted, num_sorted, sizeof(_stats_sorted_t), (int (*)(const void *, const void *))stats_site_compare);
+
+    fprintf(fp, "\nTop allocation sites for %s:\n", stats_phases[phase]);
+    for (i = 0; i < num_sorted && i < STATS_TOP_SITES; i ++)
+      fprintf(fp, "%10lu %13lu  %s:%d\n", (unsigned long)sorted[i].site->count[phase], (unsigned long)sorted[i].bytes, sorted[i].site->file, sorted[i].site->line);
+  }
+
+#else
+  fputs("Phase     Time (s)    Tasks  Workers\n", fp);
+  for (phase = STATS_PHASE_STARTUP; phase < STATS_PHASE_MAX; phase ++)
+    fprintf(fp, "%-8s %9.3f %8lu %8.2f\n", stats_phases[phase], stats_time[phase], (unsigned long)stats_tasks[phase], stats_workers(phase));
+#endif /* CODEDOC_STATS */
+
+  if (stats_chunks)
+    fprintf(fp, "\nSpeculative scan: %lu of %lu chunks grafted\n", (unsigned long)stats_grafted, (unsigned long)stats_chunks);
+}
+
+
+/*
+ * 'statsSetPhase()' - Set the current processing phase.
+ */
+
+stats_phase_t				/* O - Previous phase */
+statsSetPhase(stats_phase_t phase)	/* I - New phase */
+{
+  stats_phase_t	prev;			/* Previous phase */
+
+
+  stats_lock();
+
+  prev = stats_phase;
+
+  if (stats_started)
+  {
+    double now = stats_now();		/* Current time */
+
+    stats_time[stats_phase] += now - stats_start;
+    stats_start             = now;
+  }
+
+  stats_phase = phase;
+
+#ifdef CODEDOC_STATS
+  if (stats_live > stats_peak[phase])
+    stats_peak[phase] = stats_live;
+#endif /* CODEDOC_STATS */
+
+  stats_unlock();
+
+  return (prev);
+}
+
+
+/*
+ * 'statsStart()' - Start collecting timing information and report at exit.
+ */
+
+void
+statsStart(void)
+{
+  if (stats_started)
+    return;
+
+  stats_started = 1;
+  stats_start   = stats_now();
+
+  atexit(stats_report_cb);
+}
+
+
+#ifdef CODEDOC_STATS
+/*
+ * 'statsStrdup()' - Duplicate a string.
+ */
+
+char *					/* O - New string or `NULL` */
+statsStrdup(const char *s,		/* I - String */
+            const char *file,		/* I - Source file */
+            int        line)		/* I - Source line */
+{
+  size_t	len = strlen(s) + 1;	/* Length of string */
+  char		*ptr = malloc(len);	/* New string */
+
+
+  if (ptr)
+  {
+    memcpy(ptr, s, len);
+
+    stats_lock();
+    stats_add(ptr, len, file, line);
+    stats_unlock();
+  }
+
+  return (ptr);
+}
+
+
+/*
+ * 'stats_add()' - Record a new allocation.
+ */
+
+static void
+stats_add(void       *ptr,		/* I - New memory */
+          size_t     size,		/* I - Size of memory */
+          const char *file,		/* I - Source file or `NULL` to not count */
+          int        line)		/* I - Source line */
+{
+  size_t	i;			/* Looping var */
+  _stats_ptr_t	*p;			/* Live pointer */
+
+
+  if (stats_num_ptrs >= (stats_alloc_ptrs / 2))
+  {
+   /*
+    * Grow the live pointer table...
+    */
+
+    size_t	alloc_ptrs = stats_alloc_ptrs ? 2 * stats_alloc_ptrs : 4096;
+    _stats_ptr_t *ptrs;			/* New pointer table */
+
+    if ((ptrs = calloc(alloc_ptrs, sizeof(_stats_ptr_t))) == NULL)
+      return;
+
+    for (i = 0; i < stats_alloc_ptrs; i ++)
+    {
+      size_t j;				/* New index */
+
+      if (!stats_ptrs[i].ptr)
+        continue;
+
+      for (j = stats_ptr_hash(stats_ptrs[i].ptr, alloc_ptrs); ptrs[j].ptr; j = (j + 1) & (alloc_ptrs - 1));
+
+      ptrs[j] = stats_ptrs[i];
+    }
+
+    free(stats_ptrs);
+
+    stats_ptrs       = ptrs;
+    stats_alloc_ptrs = alloc_ptrs;
+  }
+
+  for (i = stats_ptr_hash(ptr, stats_alloc_ptrs); stats_ptrs[i].ptr; i = (i + 1) & (stats_alloc_ptrs - 1));
+
+  p       = stats_ptrs + i;
+  p->ptr  = ptr;
+  p->size = size;
+
+  stats_num_ptrs ++;
+  stats_live += size;
+
+  if (stats_live > stats_peak[stats_phase])
+    stats_peak[stats_phase] = stats_live;
+
+  if (!file)
+    return;
+
+  stats_count[stats_phase] ++;
+  stats_bytes[stats_phase] += size;
+
+ /*
+  * Find the call site...
+  */
+
+  for (i = (((size_t)(uintptr_t)file >> 3) ^ ((size_t)line * 2654435761U)) & (STATS_MAX_SITES - 1); stats_sites[i].file; i = (i + 1) & (STATS_MAX_SITES - 1))
+  {
+    if (stats_sites[i].file == file && stats_sites[i].line == line)
+      break;
+  }
+
+  if (!stats_sites[i].file)
+  {
+    if (stats_num_sites >= (STATS_MAX_SITES - 1))
+      return;
+
+    stats_sites[i].file = file;
+    stats_sites[i].line = line;
+    stats_num_sites ++;
+  }
+
+  stats_sites[i].count[stats_phase] ++;
+  stats_sites[i].bytes[stats_phase] += size;
+}
+#endif /* CODEDOC_STATS */
+
+
+/*
+ * 'stats_now()' - Get the current time in seconds.
+ */
+
+static double				/* O - Current time */
+stats_now(void)
+{
+#ifdef _WIN32
+  return ((double)clock() / CLOCKS_PER_SEC);
+
+#else
+  struct timespec ts;			/* Current time */
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+
+  return ((double)ts.tv_sec + 0.000000001 * ts.tv_nsec);
+#endif /* _WIN32 */
+}
+
+
+#ifdef CODEDOC_STATS
+/*
+ * 'stats_ptr_hash()' - Compute the hash index for a pointer.
+ */
+
+static size_t				/* O - Hash index */
+stats_ptr_hash(void   *ptr,		/* I - Pointer */
+               size_t alloc_ptrs)	/* I - Size of table (power of 2) */
+{
+  uintptr_t	p = (uintptr_t)ptr >> 4;/* Pointer value */
+
+
+  return ((size_t)((p ^ (p >> 17)) * 2654435761U) & (alloc_ptrs - 1));
+}
+
+
+/*
+ * 'stats_remove()' - Forget about a pointer.
+ */
+
+static size_t				/* O - Size of allocation or 0 if unknown */
+stats_remove(void *ptr)			/* I - Pointer */
+{
+  size_t	i, j,			/* Looping vars */
+		size;			/* Size of allocation */
+
+
+  if (!stats_alloc_ptrs)
+    return (0);
+
+  for (i = stats_ptr_hash(ptr, stats_alloc_ptrs); stats_ptrs[i].ptr; i = (i + 1) & (stats_alloc_ptrs - 1))
+  {
+    if (stats_ptrs[i].ptr == ptr)
+      break;
+  }
+
+  if (!stats_ptrs[i].ptr)
+    return (0);			/* Not allocated by us */
+
+  size = stats_ptrs[i].size;
+
+  stats_num_ptrs --;
+  stats_live -= size;
+
+ /*
+  * Shift following entries back so lookups don't need tombstones...
+  */
+
+  for (j = (i + 1) & (stats_alloc_ptrs - 1); stats_ptrs[j].ptr; j = (j + 1) & (stats_alloc_ptrs - 1))
+  {
+    size_t k = stats_ptr_hash(stats_ptrs[j].ptr, stats_alloc_ptrs);
+					/* Home slot of entry */
+
+    if ((j > i && (k <= i || k > j)) || (j < i && (k <= i && k > j)))
+    {
+      stats_ptrs[i] = stats_ptrs[j];
+      i             = j;
+    }
+  }
+
+  stats_ptrs[i].ptr  = NULL;
+  stats_ptrs[i].size = 0;
+
+  return (size);
+}
+#endif /* CODEDOC_STATS */
+
+
+/*
+ * 'stats_report_cb()' - Write the statistics report to stderr at exit.
+ */
+
+static void
+stats_report_cb(void)
+{
+  if (stats_started)
+    statsReport(stderr);
+}
+
+
+#ifdef CODEDOC_STATS
+/*
+ * 'stats_site_compare()' - Compare two call sites by bytes allocated.
+ */
+
+static int				/* O - Result of comparison */
+stats_site_compare(_stats_sorted_t *a,	/* I - First site */
+                   _stats_sorted_t *b)	/* I - Second site */
+{
+  if (a->bytes > b->bytes)
+    return (-1);
+  else if (a->bytes < b->bytes)
+    return (1);
+  else
+    return (0);
+}
+#endif /* CODEDOC_STATS */
+
+
+/*
+ * 'stats_workers()' - Get the average number of threads running tasks in a
+ *                     phase.
+ */
+
+static double				/* O - Average number of busy workers */
+stats_workers(stats_phase_t phase)	/* I - Phase */
+{
+  double	workers;		/* Average number of busy workers */
+
+
+  stats_task_lock();
+  workers = stats_time[phase] > 0.0 ? stats_task_time[phase] / stats_time[phase] : 0.0;
+  stats_task_unlock();
+
+  return (workers);
+}
@@ -0,0 +1,80 @@
+/*
+ * Run-time statistics header for codedoc.
+ *
+ *     https://www.msweet.org/codedoc
+ *
+ * Copyright © 2025 by Michael R Sweet.
+ *
+ * Licensed under Apache License v2.0.  See the file "LICENSE" for more
+ * information.
+ */
+
+#ifndef STATS_H
+#  define STATS_H
+#  include <stdio.h>
+#  include <stdlib.h>
+#  include <string.h>
+#  ifdef __cplusplus
+extern "C" {
+#  endif /* __cplusplus */
+
+
+/*
+ * Constants...
+ */
+
+typedef enum stats_phase_e		/* Processing phases */
+{
+  STATS_PHASE_STARTUP,			/* Startup and argument parsing */
+  STATS_PHASE_LOAD,			/* Loading XML and markdown files */
+  STATS_PHASE_SCAN,			/* Scanning source files */
+  STATS_PHASE_SAVE,			/* Saving the XML file */
+  STATS_PHASE_RENDER,			/* Writing documentation */
+  STATS_PHASE_MAX			/* Number of phases */
+} stats_phase_t;
+
+
+/*
+ * Functions...
+ */
+
+extern void		statsAddChunks(size_t chunks, size_t grafted);
+extern void		statsAddTask(stats_phase_t phase, double seconds);
+extern void		statsChild(void);
+extern stats_phase_t	statsGetPhase(void);
+extern void		statsReport(FILE *fp);
+extern stats_phase_t	statsSetPhase(stats_phase_t phase);
+extern void		statsStart(void);
+
+#  ifdef CODEDOC_STATS
+extern void		*statsCalloc(size_t num, size_t size, const char *file, int line);
+extern void		statsFree(void *ptr);
+extern void		*statsMalloc(size_t size, const char *file, int line);
+extern void		*statsRealloc(void *ptr, size_t size, const char *file, int line);
+extern char		*statsStrdup(const char *s, const char *file, int line);
+
+
+/*
+ * Allocation wrappers - define STATS_NO_WRAPPERS before including this header
+ * to use the plain C library functions...
+ */
+
+#    ifndef STATS_NO_WRAPPERS
+#      undef calloc
+#      undef free
+#      undef malloc
+#      undef realloc
+#      undef strdup
+#      define calloc(num,size)	statsCalloc(num, size, __FILE__, __LINE__)
+#      define free(ptr)		statsFree(ptr)
+#      define malloc(size)	statsMalloc(size, __FILE__, __LINE__)
+#      define realloc(ptr,size)	statsRealloc(ptr, size, __FILE__, __LINE__)
+#      define strdup(s)		statsStrdup(s, __FILE__, __LINE__)
+#    endif /* !STATS_NO_WRAPPERS */
+#  endif /* CODEDOC_STATS */
+
+
+#  ifdef __cplusplus
+}
+#  endif /* __cplusplus */
+#endif /* !STATS_H */
@@ -48,6 +48,11 @@
 #include <errno.h>
 #include <time.h>
 #include <zlib.h>
+#include "zopt.h"
+#ifdef CODEDOC_STATS
+#  include "stats.h"			/* Allocation statistics wrappers */
+#endif /* CODEDOC_STATS */
+#include "probes.h"			/* Static tracing probes */
 
 
 /*
@@ -77,6 +82,11 @@
 
 #define ZIPC_READ_SIZE     8192         /* Size of buffered read buffer */
 
+#define ZIPC_RSYNC_MASK    0x0fff	/* Mask for rsyncable rolling hash */
+#define ZIPC_RSYNC_HIT     0x07ff	/* Rolling hash value for a boundary */
+
+#define ZIPC_OPT_ITERATIONS 15		/* Optimal parsing passes per block */
+
 
 /*
  * Local types...
@@ -92,6 +102,12 @@ struct _zipc_s
 		num_files;		/* Number of file entries in ZIP */
   zipc_file_t	*files;			/* File entries in ZIP */
   z_stream	stream;			/* Deflate stream for current file */
+  int		rsyncable;		/* Reset stream at content-defined boundaries? */
+  unsigned	rsync_hash;		/* Rolling hash of recent data */
+  int		max_compression;	/* Search for the smallest output? */
+  unsigned char	*max_data;		/* Uncompressed data for current file */
+  size_t	max_alloc,		/* Allocated size of data */
+		max_length;		/* Length of data */
   unsigned int	modtime;		/* MS-DOS modification date/time */
   char		buffer[16384];		/* Deflate buffer */
 #ifndef ZIPC_ONLY_WRITE
@@ -133,6 +149,8 @@ static void             zipc_xml_unescape(char *buffer);
 #endif /* !ZIPC_ONLY_WRITE */
 #ifndef ZIPC_ONLY_READ
 static zipc_file_t	*zipc_add_file(zipc_t *zc, const char *filename, int compression);
+static int		zipc_deflate(zipc_file_t *zf, const void *data, size_t bytes, int flush);
+static int		zipc_deflate_max(zipc_file_t *zf);
 static int		zipc_write(zipc_t *zc, const void *buffer, size_t bytes);
 static int		zipc_write_dir_header(zipc_t *zc, zipc_file_t *zf);
 static int		zipc_write_local_header(zipc_t *zc, zipc_file_t *zf);
@@ -198,6 +216,11 @@ zipcClose(zipc_t *zc)			/* I - ZIP container */
   if (zc->alloc_files)
     free(zc->files);
 
+#ifndef ZIPC_ONLY_READ
+  if (zc->max_data)
+    free(zc->max_data);
+#endif /* !ZIPC_ONLY_READ */
+
   free(zc);
 
   return (status);
@@ -318,6 +341,8 @@ zipcCreateDirectory(
     zf->external_attrs = ZIPC_EXTERNAL_DIR;
 
     status |= zipc_write_local_header(zc, zf);
+
+    CODEDOC_PROBE3(zipc__entry__done, zf->filename, zf->uncompressed_size, zf->compressed_size);
   }
   else
     status = -1;
@@ -402,6 +427,8 @@ zipcCreateFileWithString(
 
     status |= zipc_write_local_header(zc, zf);
     status |= zipc_write(zc, contents, len);
+
+    CODEDOC_PROBE3(zipc__entry__done, zf->filename, zf->uncompressed_size, zf->compressed_size);
   }
   else
     status = -1;
@@ -436,7 +463,11 @@ zipcFileFinish(zipc_file_t *zf)		/* I - ZIP container file */
 #ifndef ZIPC_ONLY_READ
   if (zc->mode == 'w')
   {
-    if (zf->method != ZIPC_COMP_STORE)
+    if (zf->method != ZIPC_COMP_STORE && zc->max_compression)
+    {
+      status |= zipc_deflate_max(zf);
+    }
+    else if (zf->method != ZIPC_COMP_STORE)
     {
       int zstatus;			/* Deflate status */
 
@@ -466,6 +497,8 @@ zipcFileFinish(zipc_file_t *zf)		/* I - ZIP container file */
     }
 
     status |= zipc_write_local_trailer(zc, zf);
+
+    CODEDOC_PROBE3(zipc__entry__done, zf->filename, zf->uncompressed_size, zf->compressed_size);
   }
 #endif /* !ZIPC_ONLY_READ */
 
@@ -680,37 +713,66 @@ zipcFileWrite(zipc_file_t *zf,		/* I - ZIP container file */
     status = zipc_write(zc, data, bytes);
     zf->compressed_size += bytes;
   }
-  else
+  else if (zc->max_compression)
   {
    /*
-    * Deflate (compress) the contents...
+    * Collect the contents to compress when the file is finished...
     */
 
-    int	zstatus;			/* Deflate status */
+    if (zc->max_length + bytes > zc->max_alloc)
+    {
+      size_t		max_alloc;	/* New allocation size */
+      unsigned char	*max_data;	/* New data buffer */
 
-    zc->stream.next_in  = (Bytef *)data;
-    zc->stream.avail_in = (unsigned)bytes;
+      for (max_alloc = zc->max_alloc ? zc->max_alloc : 65536; max_alloc < (zc->max_length + bytes); max_alloc *= 2);
 
-    while (zc->stream.avail_in > 0)
-    {
-      if (zc->stream.avail_out < (int)(sizeof(zc->buffer) / 8))
+      if ((max_data = realloc(zc->max_data, max_alloc)) == NULL)
       {
-	status |= zipc_write(zf->zc, zc->buffer, (size_t)((char *)zc->stream.next_out - zc->buffer));
-	zf->compressed_size += (size_t)((char *)zc->stream.next_out - zc->buffer);
-
-	zc->stream.next_out  = (Bytef *)zc->buffer;
-	zc->stream.avail_out = sizeof(zc->buffer);
+        zc->error = strerror(errno);
+        return (-1);
       }
 
-      zstatus = deflate(&zc->stream, Z_NO_FLUSH);
+      zc->max_data  = max_data;
+      zc->max_alloc = max_alloc;
+    }
 
-      if (zstatus < Z_OK && zstatus != Z_BUF_ERROR)
+    memcpy(zc->max_data + zc->max_length, data, bytes);
+    zc->max_length += bytes;
+  }
+  else if (zc->rsyncable)
+  {
+   /*
+    * Deflate the contents, flushing and resetting the compressor wherever a
+    * rolling hash of the last 12 bytes hits a fixed value.  The boundaries
+    * only depend on nearby content, so a local change in the input only
+    * changes the compressed data up to the next boundary...
+    */
+
+    const unsigned char	*start,		/* Start of current chunk */
+			*ptr,		/* Pointer into data */
+			*end;		/* End of data */
+
+    for (start = ptr = (const unsigned char *)data, end = ptr + bytes; ptr < end && !status; ptr ++)
+    {
+      zc->rsync_hash = ((zc->rsync_hash << 1) ^ *ptr) & ZIPC_RSYNC_MASK;
+
+      if (zc->rsync_hash == ZIPC_RSYNC_HIT)
       {
-        zc->error = zipc_zlib_status(zstatus);
-        status = -1;
-        break;
+        status = zipc_deflate(zf, start, (size_t)(ptr - start + 1), Z_FULL_FLUSH);
+        start  = ptr + 1;
       }
     }
+
+    if (!status && start < end)
+      status = zipc_deflate(zf, start, (size_t)(end - start), Z_NO_FLUSH);
+  }
+  else
+  {
+   /*
+    * Deflate (compress) the contents...
+    */
+
+    status = zipc_deflate(zf, data, bytes, Z_NO_FLUSH);
   }
 
   return (status);
@@ -1187,6 +1249,44 @@ zipcOpen(const char *filename,		/* I - Filename of container */
 }
 
 
+#ifndef ZIPC_ONLY_READ
+/*
+ * 'zipcSetMaxCompression()' - Set whether to search for the smallest output.
+ *
+ * When enabled, the contents of each compressed file are collected until
+ * @link zipcFileFinish@ is called and then compressed with several different
+ * deflate settings, keeping the smallest result.  This uses more memory and
+ * CPU time to produce smaller files.  The setting applies to files created
+ * afterwards.
+ */
+
+void
+zipcSetMaxCompression(
+    zipc_t *zc,				/* I - ZIP container */
+    int    max_compression)		/* I - 1 for maximum compression, 0 for normal */
+{
+  zc->max_compression = max_compression;
+}
+
+
+/*
+ * 'zipcSetRsyncable()' - Set whether compressed files are rsync-friendly.
+ *
+ * When enabled, the compressor is flushed and reset at boundaries determined
+ * by the file contents, as "gzip --rsyncable" does, so that small changes to
+ * a file produce small changes in the compressed data.  The compressed data
+ * is slightly larger.  The setting applies to files created afterwards.
+ */
+
+void
+zipcSetRsyncable(zipc_t *zc,		/* I - ZIP container */
+                 int    rsyncable)	/* I - 1 for rsync-friendly compression, 0 for normal */
+{
+  zc->rsyncable = rsyncable;
+}
+#endif /* !ZIPC_ONLY_READ */
+
+
 #ifndef ZIPC_ONLY_WRITE
 /*
  * 'zipcOpenFile()' - Open a file in a ZIP container.
@@ -1398,7 +1498,16 @@ zipc_add_file(zipc_t     *zc,		/* I - ZIP container */
   temp->crc32  = crc32(0, NULL, 0);
   temp->offset = (size_t)ftell(zc->fp);
 
-  if (compression)
+  CODEDOC_PROBE2(zipc__entry__start, temp->filename, compression);
+
+  if (compression && zc->max_compression)
+  {
+    temp->flags  = ZIPC_FLAG_CMAX;
+    temp->method = ZIPC_COMP_DEFLATE;
+
+    zc->max_length = 0;
+  }
+  else if (compression)
   {
     temp->flags  = ZIPC_FLAG_CMAX;
     temp->method = ZIPC_COMP_DEFLATE;
@@ -1411,10 +1520,231 @@ zipc_add_file(zipc_t     *zc,		/* I - ZIP container */
 
     zc->stream.next_out  = (Bytef *)zc->buffer;
     zc->stream.avail_out = sizeof(zc->buffer);
+    zc->rsync_hash       = 0;
   }
 
   return (temp);
 }
+
+
+/*
+ * 'zipc_deflate()' - Deflate (compress) data for a file.
+ *
+ * The "flush" value is `Z_NO_FLUSH` or `Z_FULL_FLUSH`.
+ */
+
+static int				/* O - 0 on success, -1 on error */
+zipc_deflate(zipc_file_t *zf,		/* I - ZIP container file */
+             const void  *data,		/* I - Data to compress */
+             size_t      bytes,		/* I - Number of bytes to compress */
+             int         flush)		/* I - Flush mode */
+{
+  int		status = 0;		/* Return status */
+  zipc_t	*zc = zf->zc;		/* ZIP container */
+  int		zstatus;		/* Deflate status */
+
+
+  zc->stream.next_in  = (Bytef *)data;
+  zc->stream.avail_in = (unsigned)bytes;
+
+  while (zc->stream.avail_in > 0 || flush != Z_NO_FLUSH)
+  {
+    if (zc->stream.avail_out < (int)(sizeof(zc->buffer) / 8))
+    {
+      status |= zipc_write(zf->zc, zc->buffer, (size_t)((char *)zc->stream.next_out - zc->buffer));
+      zf->compressed_size += (size_t)((char *)zc->stream.next_out - zc->buffer);
+
+      zc->stream.next_out  = (Bytef *)zc->buffer;
+      zc->stream.avail_out = sizeof(zc->buffer);
+    }
+
+    zstatus = deflate(&zc->stream, flush);
+
+    if (zstatus < Z_OK && zstatus != Z_BUF_ERROR)
+    {
+      zc->error = zipc_zlib_status(zstatus);
+      status = -1;
+      break;
+    }
+
+    if (zc->stream.avail_in == 0 && zc->stream.avail_out > 0)
+      break;
+  }
+
+  return (status);
+}
+
+
+/*
+ * 'zipc_deflate_max()' - Compress and write the collected data for a file
+ *                        using the settings that give the smallest output.
+ *
+ * The first trial uses the same settings as normal compression, so the result
+ * is never larger.  Content-defined boundaries are kept when the container is
+ * rsyncable.
+ */
+
+static int				/* O - 0 on success, -1 on error */
+zipc_deflate_max(zipc_file_t *zf)	/* I - ZIP container file */
+{
+  int		status = 0;		/* Return status */
+  zipc_t	*zc = zf->zc;		/* ZIP container */
+  size_t	i;			/* Looping var */
+  z_stream	stream;			/* Deflate stream */
+  int		zstatus;		/* Deflate status */
+  unsigned	hash;			/* Rolling hash of recent data */
+  const unsigned char *start,		/* Start of current chunk */
+		*ptr,			/* Pointer into data */
+		*end;			/* End of data */
+  unsigned char	*out = NULL,		/* Output buffer */
+		*best = NULL;		/* Smallest output */
+  size_t	outalloc = 0,		/* Allocated size of output buffer */
+		outlen,			/* Length of output */
+		bestalloc = 0,		/* Allocated size of smallest output */
+		bestlen = 0;		/* Length of smallest output */
+  static const struct			/* Deflate settings to try */
+  {
+    int		mem_level,		/* Memory level or 0 for optimal parsing */
+		strategy,		/* Compression strategy */
+		tune;			/* Search for the longest matches? */
+  }		trials[] =
+  {
+    { 8, Z_DEFAULT_STRATEGY, 0 },
+    { 9, Z_DEFAULT_STRATEGY, 1 },
+    { 9, Z_FILTERED, 1 },
+    { 0, 0, 0 }
+  };
+
+
+  for (i = 0; i < (sizeof(trials) / sizeof(trials[0])) && !status; i ++)
+  {
+    memset(&stream, 0, sizeof(stream));
+
+    if (trials[i].mem_level && (zstatus = deflateInit2(&stream, Z_BEST_COMPRESSION, Z_DEFLATED, -15, trials[i].mem_level, trials[i].strategy)) != Z_OK)
+    {
+      zc->error = zipc_zlib_status(zstatus);
+      status    = -1;
+      break;
+    }
+
+    if (trials[i].tune)
+      deflateTune(&stream, 258, 258, 258, 32768);
+
+    outlen = 0;
+    start  = zc->max_data;
+    end    = zc->max_data + zc->max_length;
+    hash   = 0;
+
+    do
+    {
+     /*
+      * Find the end of the next chunk...
+      */
+
+      int flush = Z_FINISH;		/* Flush mode for chunk */
+
+      for (ptr = start; zc->rsyncable && ptr < end; ptr ++)
+      {
+        hash = ((hash << 1) ^ *ptr) & ZIPC_RSYNC_MASK;
+
+        if (hash == ZIPC_RSYNC_HIT && (ptr + 1) < end)
+        {
+          flush = Z_FULL_FLUSH;
+          ptr ++;
+          break;
+        }
+      }
+
+      if (flush == Z_FINISH)
+        ptr = end;
+
+     /*
+      * Compress it...
+      */
+
+      if (!trials[i].mem_level)
+      {
+        if (zoptDeflate(start, (size_t)(ptr - start), flush == Z_FINISH, ZIPC_OPT_ITERATIONS, &out, &outalloc, &outlen))
+        {
+          zc->error = strerror(ENOMEM);
+          status    = -1;
+        }
+
+        start = ptr;
+        continue;
+      }
+
+      stream.next_in  = (Bytef *)start;
+      stream.avail_in = (uInt)(ptr - start);
+
+      do
+      {
+        if (outlen + 1024 > outalloc)
+        {
+          unsigned char *temp;		/* New output buffer */
+
+          outalloc = outalloc ? 2 * outalloc : deflateBound(&stream, (uLong)zc->max_length) + 1024;
+
+          if ((temp = realloc(out, outalloc)) == NULL)
+          {
+            zc->error = strerror(errno);
+            status    = -1;
+            break;
+          }
+
+          out = temp;
+        }
+
+        stream.next_out  = out + outlen;
+        stream.avail_out = (uInt)(outalloc - outlen);
+
+        zstatus = deflate(&stream, flush);
+        outlen  = (size_t)(stream.next_out - out);
+
+        if (zstatus < Z_OK && zstatus != Z_BUF_ERROR)
+        {
+          zc->error = zipc_zlib_status(zstatus);
+          status    = -1;
+          break;
+        }
+      }
+      while (flush == Z_FINISH ? zstatus != Z_STREAM_END : (stream.avail_in > 0 || stream.avail_out == 0));
+
+      start = ptr;
+    }
+    while (start < end && !status);
+
+    if (trials[i].mem_level)
+      deflateEnd(&stream);
+
+    if (!status && (!best || outlen < bestlen))
+    {
+     /*
+      * Keep the smallest output...
+      */
+
+      unsigned char	*temp = best;	/* Swap buffers */
+      size_t		tempalloc = bestalloc;
+
+      best      = out;
+      bestalloc = outalloc;
+      bestlen   = outlen;
+      out       = temp;
+      outalloc  = tempalloc;
+    }
+  }
+
+  if (!status)
+  {
+    status |= zipc_write(zc, best, bestlen);
+    zf->compressed_size += bestlen;
+  }
+
+  free(out);
+  free(best);
+
+  return (status);
+}
 #endif /* !ZIPC_ONLY_READ */
 
 
@@ -82,6 +82,8 @@ __attribute__ ((__format__ (__printf__, 2, 3)))
 ;
 extern zipc_t		*zipcOpen(const char *filename, const char *mode);
 extern zipc_file_t      *zipcOpenFile(zipc_t *zc, const char *filename);
+extern void		zipcSetMaxCompression(zipc_t *zc, int max_compression);
+extern void		zipcSetRsyncable(zipc_t *zc, int rsyncable);
 extern const char       *zipcXMLGetAttribute(const char *element, const char *attrname, char *buffer, size_t bufsize);
 
 #  ifdef __cplusplus
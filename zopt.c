@@ -0,0 +1,1141 @@
+/*
+ * Optimal-parsing deflate encoder for codedoc.
+ *
+ *     https://www.msweet.org/codedoc
+ *
+ * The encoder produces standard raw deflate (RFC 1951) data, but instead of
+ * zlib's greedy/lazy matching it finds the cheapest sequence of literals and
+ * matches through all of the matches available at each position, using the
+ * bit costs of the symbols chosen by the previous pass.  This is the same
+ * approach as Zopfli and gives output a few percent smaller than zlib's best
+ * compression at a much higher CPU cost.
+ *
+ * Copyright © 2025 by Michael R Sweet.
+ *
+ * Licensed under Apache License v2.0.  See the file "LICENSE" for more
+ * information.
+ */
+
+#include "zopt.h"
+#include <string.h>
+#ifdef CODEDOC_STATS
+#  include "stats.h"			/* Allocation statistics wrappers */
+#endif /* CODEDOC_STATS */
+
+
+/*
+ * Local constants...
+ */
+
+#define ZOPT_BLOCK_SIZE	32768		/* Maximum input bytes per block */
+#define ZOPT_HASH_SIZE	65536		/* Size of match hash table */
+#define ZOPT_MAX_CHAIN	1024		/* Maximum hash chain length to search */
+#define ZOPT_MAX_MATCH	258		/* Longest match */
+#define ZOPT_MIN_MATCH	3		/* Shortest match */
+#define ZOPT_WINDOW	32768		/* Size of sliding window */
+
+
+/*
+ * Local types...
+ */
+
+typedef struct zopt_sym_s		/* Literal or match */
+{
+  unsigned short	length,		/* Match length or literal byte */
+			distance;	/* Match distance or 0 for a literal */
+} zopt_sym_t;
+
+typedef struct zopt_costs_s		/* Symbol costs in bits */
+{
+  double		litlen[288],	/* Literal/length symbol costs */
+			dist[32];	/* Distance symbol costs */
+} zopt_costs_t;
+
+typedef struct zopt_stats_s		/* Symbol counts */
+{
+  size_t		litlen[288],	/* Literal/length symbol counts */
+			dist[32];	/* Distance symbol counts */
+} zopt_stats_t;
+
+typedef struct zopt_tree_s		/* Dynamic Huffman trees for a block */
+{
+  unsigned char		litlen[288],	/* Literal/length code lengths */
+			dist[32],	/* Distance code lengths */
+			codelen[19],	/* Code length code lengths */
+			rle[320],	/* Run-length encoded code lengths */
+			rle_extra[320];	/* Extra bits for code lengths */
+  size_t		num_rle;	/* Number of code lengths */
+  int			hlit,		/* Number of literal/length codes */
+			hdist,		/* Number of distance codes */
+			hclen;		/* Number of code length codes */
+} zopt_tree_t;
+
+typedef struct zopt_s			/* Encoder state */
+{
+  const unsigned char	*data;		/* Input data */
+  size_t		length;		/* Length of input data */
+  unsigned		*first;		/* First match for each position */
+  zopt_sym_t		*matches;	/* Longest match for each distance */
+  size_t		num_matches,	/* Number of matches */
+			alloc_matches;	/* Allocated matches */
+  unsigned char		**buffer;	/* Output buffer */
+  size_t		*bufsize,	/* Size of output buffer */
+			*buflen;	/* Length of output */
+  unsigned		bits;		/* Pending output bits */
+  int			num_bits;	/* Number of pending output bits */
+  int			error;		/* Unable to allocate memory? */
+  unsigned char		length_sym[ZOPT_MAX_MATCH + 1],
+					/* Length symbol for each match length */
+			fixed_litlen[288],
+					/* Fixed literal/length code lengths */
+			fixed_dist[32];	/* Fixed distance code lengths */
+} zopt_t;
+
+
+/*
+ * Local globals...
+ */
+
+static const unsigned short length_base[29] =
+{					/* Base match length for each symbol */
+  3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67,
+  83, 99, 115, 131, 163, 195, 227, 258
+};
+static const unsigned char length_extra[29] =
+{					/* Extra bits for each length symbol */
+  0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5,
+  5, 5, 5, 0
+};
+static const unsigned short dist_base[30] =
+{					/* Base distance for each symbol */
+  1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385, 513,
+  769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577
+};
+static const unsigned char dist_extra[30] =
+{					/* Extra bits for each distance symbol */
+  0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10,
+  11, 11, 12, 12, 13, 13
+};
+static const unsigned char codelen_order[19] =
+{					/* Order of code length code lengths */
+  16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15
+};
+
+
+/*
+ * Local functions...
+ */
+
+static void		zopt_add_bits(zopt_t *z, unsigned value, int num_bits);
+static void		zopt_align(zopt_t *z);
+static size_t		zopt_data_bits(const zopt_stats_t *stats, const unsigned char *litlen, const unsigned char *dist);
+static int		zopt_dist_sym(unsigned distance);
+static size_t		zopt_dynamic(const zopt_stats_t *stats, zopt_tree_t *tree);
+static int		zopt_find_matches(zopt_t *z);
+static void		zopt_get_codes(const unsigned char *lengths, int num_syms, unsigned *codes);
+static void		zopt_get_costs(const zopt_stats_t *stats, zopt_costs_t *costs);
+static void		zopt_get_stats(zopt_t *z, const zopt_sym_t *syms, size_t num_syms, zopt_stats_t *stats);
+static void		zopt_huffman(const size_t *freqs, int num_syms, int max_bits, unsigned char *lengths);
+static double		zopt_log2(double x);
+static size_t		zopt_parse(zopt_t *z, size_t start, size_t end, const zopt_costs_t *costs, double *cost, zopt_sym_t *path, zopt_sym_t *syms);
+static void		zopt_put_byte(zopt_t *z, int byte);
+static void		zopt_write_block(zopt_t *z, const unsigned char *data, size_t length, const zopt_sym_t *syms, size_t num_syms, int final);
+
+
+/*
+ * 'zoptDeflate()' - Compress data as raw deflate data.
+ *
+ * The compressed data is appended to the buffer pointed to by "buffer", which
+ * is reallocated as needed.  The "bufsize" and "buflen" arguments point to the
+ * allocated size and current length of the buffer.
+ *
+ * When "last" is 0 the data ends with an empty stored block, like zlib's
+ * `Z_FULL_FLUSH`, so that further data can be compressed and appended with
+ * another call.  Each call is independent - matches never refer to the data
+ * from an earlier call.  When "last" is 1 the final block is marked as such.
+ *
+ * The "iterations" argument specifies the number of parsing passes for each
+ * block.  More passes give slightly smaller output; 15 is a good default.
+ */
+
+int					/* O - 0 on success, -1 on error */
+zoptDeflate(const void    *data,	/* I - Data to compress */
+            size_t        length,	/* I - Length of data */
+            int           last,		/* I - 1 for the last data, 0 otherwise */
+            int           iterations,	/* I - Number of parsing passes */
+            unsigned char **buffer,	/* IO - Output buffer */
+            size_t        *bufsize,	/* IO - Size of output buffer */
+            size_t        *buflen)	/* IO - Length of output */
+{
+  zopt_t	z;			/* Encoder state */
+  int		i,			/* Looping var */
+		iter;			/* Current pass */
+  size_t	start,			/* Start of block */
+		end,			/* End of block */
+		num_syms,		/* Number of symbols */
+		num_best = 0,		/* Number of symbols in best parse */
+		bits,			/* Size of block */
+		best_bits;		/* Size of best parse */
+  double	*cost = NULL;		/* Cost to reach each position */
+  zopt_sym_t	*path = NULL,		/* Last symbol to reach each position */
+		*syms = NULL,		/* Symbols for block */
+		*best = NULL;		/* Symbols for best parse */
+  zopt_costs_t	costs,			/* Fixed symbol costs */
+		block_costs;		/* Symbol costs for block */
+  zopt_stats_t	stats;			/* Symbol counts */
+  zopt_tree_t	tree;			/* Huffman trees */
+
+
+ /*
+  * Initialize the encoder...
+  */
+
+  memset(&z, 0, sizeof(z));
+
+  z.data    = (const unsigned char *)data;
+  z.length  = length;
+  z.buffer  = buffer;
+  z.bufsize = bufsize;
+  z.buflen  = buflen;
+
+  for (i = 0; i < 28; i ++)
+    memset(z.length_sym + length_base[i], i, (size_t)1 << length_extra[i]);
+  z.length_sym[ZOPT_MAX_MATCH] = 28;
+
+  memset(z.fixed_litlen, 8, 144);
+  memset(z.fixed_litlen + 144, 9, 112);
+  memset(z.fixed_litlen + 256, 7, 24);
+  memset(z.fixed_litlen + 280, 8, 8);
+  memset(z.fixed_dist, 5, 32);
+
+  for (i = 0; i < 288; i ++)
+    costs.litlen[i] = z.fixed_litlen[i];
+  for (i = 0; i < 32; i ++)
+    costs.dist[i] = z.fixed_dist[i];
+
+  if (iterations < 1)
+    iterations = 1;
+
+ /*
+  * Find the matches at each position...
+  */
+
+  if (zopt_find_matches(&z))
+    goto done;
+
+  if (length > 0)
+  {
+    size_t block = length < ZOPT_BLOCK_SIZE ? length : ZOPT_BLOCK_SIZE;
+					/* Block size */
+
+    cost = malloc((block + 1) * sizeof(double));
+    path = malloc((block + 1) * sizeof(zopt_sym_t));
+    syms = malloc(block * sizeof(zopt_sym_t));
+    best = malloc(block * sizeof(zopt_sym_t));
+
+    if (!cost || !path || !syms || !best)
+    {
+      z.error = 1;
+      goto done;
+    }
+  }
+
+ /*
+  * Compress each block, keeping the smallest parse...
+  */
+
+  for (start = 0; start < length; start = end)
+  {
+    if ((end = start + ZOPT_BLOCK_SIZE) > length)
+      end = length;
+
+    block_costs = costs;
+
+    for (iter = 0, best_bits = (size_t)-1; iter < iterations; iter ++)
+    {
+      num_syms = zopt_parse(&z, start, end, &block_costs, cost, path, syms);
+
+      zopt_get_stats(&z, syms, num_syms, &stats);
+
+      if ((bits = zopt_dynamic(&stats, &tree)) < best_bits)
+      {
+        best_bits = bits;
+        num_best  = num_syms;
+        memcpy(best, syms, num_syms * sizeof(zopt_sym_t));
+      }
+
+      zopt_get_costs(&stats, &block_costs);
+    }
+
+    zopt_write_block(&z, z.data + start, end - start, best, num_best, last && end == length);
+  }
+
+  if (length == 0 && last)
+  {
+   /*
+    * Write an empty final block...
+    */
+
+    zopt_write_block(&z, z.data, 0, NULL, 0, 1);
+  }
+  else if (!last)
+  {
+   /*
+    * Write an empty stored block to byte-align the output...
+    */
+
+    zopt_add_bits(&z, 0, 3);
+    zopt_align(&z);
+    zopt_add_bits(&z, 0x0000, 16);
+    zopt_add_bits(&z, 0xffff, 16);
+  }
+
+  zopt_align(&z);
+
+ /*
+  * Free memory and return...
+  */
+
+  done:
+
+  free(z.first);
+  free(z.matches);
+  free(cost);
+  free(path);
+  free(syms);
+  free(best);
+
+  return (z.error ? -1 : 0);
+}
+
+
+/*
+ * 'zopt_add_bits()' - Add bits to the output.
+ */
+
+static void
+zopt_add_bits(zopt_t   *z,		/* I - Encoder state */
+              unsigned value,		/* I - Value */
+              int      num_bits)	/* I - Number of bits (0 to 16) */
+{
+  z->bits     |= value << z->num_bits;
+  z->num_bits += num_bits;
+
+  while (z->num_bits >= 8)
+  {
+    zopt_put_byte(z, (int)(z->bits & 255));
+
+    z->bits     >>= 8;
+    z->num_bits -= 8;
+  }
+}
+
+
+/*
+ * 'zopt_align()' - Write any pending bits to align the output to a byte.
+ */
+
+static void
+zopt_align(zopt_t *z)			/* I - Encoder state */
+{
+  if (z->num_bits > 0)
+    zopt_put_byte(z, (int)(z->bits & 255));
+
+  z->bits     = 0;
+  z->num_bits = 0;
+}
+
+
+/*
+ * 'zopt_data_bits()' - Return the size of the symbols in a block using the
+ *                      given code lengths.
+ */
+
+static size_t				/* O - Size in bits */
+zopt_data_bits(
+    const zopt_stats_t  *stats,		/* I - Symbol counts */
+    const unsigned char *litlen,	/* I - Literal/length code lengths */
+    const unsigned char *dist)		/* I - Distance code lengths */
+{
+  int		i;			/* Looping var */
+  size_t	bits = 0;		/* Size in bits */
+
+
+  for (i = 0; i < 286; i ++)
+    bits += stats->litlen[i] * (size_t)(litlen[i] + (i > 256 ? length_extra[i - 257] : 0));
+
+  for (i = 0; i < 30; i ++)
+    bits += stats->dist[i] * (size_t)(dist[i] + dist_extra[i]);
+
+  return (bits);
+}
+
+
+/*
+ * 'zopt_dist_sym()' - Return the symbol for a match distance.
+ */
+
+static int				/* O - Distance symbol */
+zopt_dist_sym(unsigned distance)	/* I - Distance (1 to 32768) */
+{
+  unsigned	d = distance - 1;	/* Zero-based distance */
+  int		bits;			/* Highest bit in distance */
+
+
+  if (d < 4)
+    return ((int)d);
+
+  for (bits = 2; (d >> (bits + 1)) != 0; bits ++);
+
+  return (2 * bits + (int)((d >> (bits - 1)) & 1));
+}
+
+
+/*
+ * 'zopt_dynamic()' - Build the dynamic Huffman trees for a block.
+ */
+
+static size_t				/* O - Size of block in bits */
+zopt_dynamic(const zopt_stats_t *stats,	/* I - Symbol counts */
+             zopt_tree_t        *tree)	/* O - Huffman trees */
+{
+  int		i,			/* Looping var */
+		count,			/* Number of codes */
+		num_lengths;		/* Number of code lengths */
+  unsigned char	lengths[320],		/* Code lengths */
+		value;			/* Current code length */
+  int		run,			/* Length of run */
+		rem,			/* Remaining run */
+		n;			/* Codes in current repeat */
+  size_t	freqs[19],		/* Code length code counts */
+		bits;			/* Size in bits */
+
+
+ /*
+  * Build the literal/length and distance trees.  Older versions of zlib need
+  * at least two distance codes...
+  */
+
+  zopt_huffman(stats->litlen, 286, 15, tree->litlen);
+  tree->litlen[286] = tree->litlen[287] = 0;
+
+  zopt_huffman(stats->dist, 30, 15, tree->dist);
+  tree->dist[30] = tree->dist[31] = 0;
+
+  for (i = 0, count = 0; i < 30; i ++)
+  {
+    if (tree->dist[i])
+      count ++;
+  }
+
+  if (count == 0)
+    tree->dist[0] = tree->dist[1] = 1;
+  else if (count == 1)
+    tree->dist[tree->dist[0] ? 1 : 0] = 1;
+
+  for (tree->hlit = 286; tree->hlit > 257 && !tree->litlen[tree->hlit - 1]; tree->hlit --);
+  for (tree->hdist = 30; tree->hdist > 1 && !tree->dist[tree->hdist - 1]; tree->hdist --);
+
+ /*
+  * Run-length encode the code lengths...
+  */
+
+  memcpy(lengths, tree->litlen, (size_t)tree->hlit);
+  memcpy(lengths + tree->hlit, tree->dist, (size_t)tree->hdist);
+
+  num_lengths   = tree->hlit + tree->hdist;
+  tree->num_rle = 0;
+
+  memset(freqs, 0, sizeof(freqs));
+
+  for (i = 0; i < num_lengths; i += run)
+  {
+    value = lengths[i];
+
+    for (run = 1; (i + run) < num_lengths && lengths[i + run] == value; run ++);
+
+    rem = run;
+
+    if (value == 0)
+    {
+      while (rem >= 11)
+      {
+        n = rem > 138 ? 138 : rem;
+        tree->rle[tree->num_rle]         = 18;
+        tree->rle_extra[tree->num_rle ++] = (unsigned char)(n - 11);
+        freqs[18] ++;
+        rem -= n;
+      }
+
+      if (rem >= 3)
+      {
+        tree->rle[tree->num_rle]         = 17;
+        tree->rle_extra[tree->num_rle ++] = (unsigned char)(rem - 3);
+        freqs[17] ++;
+        rem = 0;
+      }
+    }
+    else
+    {
+      tree->rle[tree->num_rle]         = value;
+      tree->rle_extra[tree->num_rle ++] = 0;
+      freqs[value] ++;
+      rem --;
+
+      while (rem >= 3)
+      {
+        n = rem > 6 ? 6 : rem;
+        tree->rle[tree->num_rle]         = 16;
+        tree->rle_extra[tree->num_rle ++] = (unsigned char)(n - 3);
+        freqs[16] ++;
+        rem -= n;
+      }
+    }
+
+    for (; rem > 0; rem --)
+    {
+      tree->rle[tree->num_rle]         = value;
+      tree->rle_extra[tree->num_rle ++] = 0;
+      freqs[value] ++;
+    }
+  }
+
+ /*
+  * Build the code length tree, which must be complete...
+  */
+
+  zopt_huffman(freqs, 19, 7, tree->codelen);
+
+  for (i = 0, count = 0; i < 19; i ++)
+  {
+    if (tree->codelen[i])
+      count ++;
+  }
+
+  if (count == 1)
+    tree->codelen[tree->codelen[0] ? 1 : 0] = 1;
+
+  for (tree->hclen = 19; tree->hclen > 4 && !tree->codelen[codelen_order[tree->hclen - 1]]; tree->hclen --);
+
+ /*
+  * Compute the size of the block...
+  */
+
+  bits = 3 + 5 + 5 + 4 + 3 * (size_t)tree->hclen;
+
+  for (i = 0; i < (int)tree->num_rle; i ++)
+    bits += tree->codelen[tree->rle[i]] + (tree->rle[i] == 16 ? 2 : tree->rle[i] == 17 ? 3 : tree->rle[i] == 18 ? 7 : 0);
+
+  return (bits + zopt_data_bits(stats, tree->litlen, tree->dist));
+}
+
+
+/*
+ * 'zopt_find_matches()' - Find the longest match for each distance at each
+ *                         position.
+ *
+ * Matches are found using hash chains and recorded in order of increasing
+ * distance, only when they are longer than the previous match, so the matches
+ * at a position give the shortest distance for every match length.
+ */
+
+static int				/* O - 0 on success, -1 on error */
+zopt_find_matches(zopt_t *z)		/* I - Encoder state */
+{
+  int		*head,			/* Last position for each hash */
+		*prev,			/* Previous position with the same hash */
+		j;			/* Earlier position */
+  size_t	i,			/* Current position */
+		len,			/* Length of match */
+		best,			/* Longest match so far */
+		max_len;		/* Maximum match length */
+  unsigned	hash;			/* Hash of next 3 bytes */
+  int		chain;			/* Hash chain length */
+  const unsigned char *data = z->data;	/* Input data */
+
+
+  head     = malloc(ZOPT_HASH_SIZE * sizeof(int));
+  prev     = malloc(ZOPT_WINDOW * sizeof(int));
+  z->first = malloc((z->length + 1) * sizeof(unsigned));
+
+  if (!head || !prev || !z->first)
+  {
+    z->error = 1;
+    free(head);
+    free(prev);
+    return (-1);
+  }
+
+  memset(head, 0xff, ZOPT_HASH_SIZE * sizeof(int));
+
+  for (i = 0; i < z->length; i ++)
+  {
+    z->first[i] = (unsigned)z->num_matches;
+
+    if ((i + ZOPT_MIN_MATCH) > z->length)
+      continue;
+
+    hash    = ((unsigned)data[i] << 8 ^ (unsigned)data[i + 1] << 4 ^ (unsigned)data[i + 2]) & (ZOPT_HASH_SIZE - 1);
+    max_len = z->length - i;
+    if (max_len > ZOPT_MAX_MATCH)
+      max_len = ZOPT_MAX_MATCH;
+
+    for (j = head[hash], best = ZOPT_MIN_MATCH - 1, chain = 0; j >= 0 && (i - (size_t)j) <= ZOPT_WINDOW && chain < ZOPT_MAX_CHAIN; j = prev[j & (ZOPT_WINDOW - 1)], chain ++)
+    {
+      if (data[j + best] != data[i + best])
+        continue;
+
+      for (len = 0; len < max_len && data[j + len] == data[i + len]; len ++);
+
+      if (len > best)
+      {
+        if (z->num_matches >= z->alloc_matches)
+        {
+          zopt_sym_t *temp;		/* New matches */
+
+          z->alloc_matches = z->alloc_matches ? 2 * z->alloc_matches : 4096;
+
+          if ((temp = realloc(z->matches, z->alloc_matches * sizeof(zopt_sym_t))) == NULL)
+          {
+            z->error = 1;
+            free(head);
+            free(prev);
+            return (-1);
+          }
+
+          z->matches = temp;
+        }
+
+        z->matches[z->num_matches].length     = (unsigned short)len;
+        z->matches[z->num_matches].distance   = (unsigned short)(i - (size_t)j);
+        z->num_matches ++;
+
+        if ((best = len) >= max_len)
+          break;
+      }
+    }
+
+    prev[i & (ZOPT_WINDOW - 1)] = head[hash];
+    head[hash]                  = (int)i;
+  }
+
+  z->first[z->length] = (unsigned)z->num_matches;
+
+  free(head);
+  free(prev);
+
+  return (0);
+}
+
+
+/*
+ * 'zopt_get_codes()' - Get the canonical Huffman codes for the code lengths.
+ *
+ * The codes are bit-reversed so they can be written least-significant bit
+ * first.
+ */
+
+static void
+zopt_get_codes(
+    const unsigned char *lengths,	/* I - Code lengths */
+    int                 num_syms,	/* I - Number of symbols */
+    unsigned            *codes)		/* O - Codes */
+{
+  int		i,			/* Looping var */
+		bits;			/* Current bit */
+  unsigned	counts[16],		/* Number of codes of each length */
+		next[16],		/* Next code of each length */
+		code;			/* Current code */
+
+
+  memset(counts, 0, sizeof(counts));
+
+  for (i = 0; i < num_syms; i ++)
+    counts[lengths[i]] ++;
+
+  counts[0] = 0;
+
+  for (bits = 1, code = 0; bits < 16; bits ++)
+  {
+    code       = (code + counts[bits - 1]) << 1;
+    next[bits] = code;
+  }
+
+  for (i = 0; i < num_syms; i ++)
+  {
+    codes[i] = 0;
+
+    if (lengths[i])
+    {
+      code = next[lengths[i]] ++;
+
+      for (bits = 0; bits < lengths[i]; bits ++, code >>= 1)
+        codes[i] = (codes[i] << 1) | (code & 1);
+    }
+  }
+}
+
+
+/*
+ * 'zopt_get_costs()' - Get the cost in bits of each symbol from its count.
+ */
+
+static void
+zopt_get_costs(
+    const zopt_stats_t *stats,		/* I - Symbol counts */
+    zopt_costs_t       *costs)		/* O - Symbol costs */
+{
+  int		i;			/* Looping var */
+  size_t	total;			/* Total count */
+  double	log2total;		/* Log2 of total count */
+
+
+  for (i = 0, total = 0; i < 288; i ++)
+    total += stats->litlen[i];
+
+  for (i = 0, log2total = zopt_log2((double)total); i < 288; i ++)
+    costs->litlen[i] = stats->litlen[i] ? log2total - zopt_log2((double)stats->litlen[i]) : log2total;
+
+  for (i = 0, total = 0; i < 32; i ++)
+    total += stats->dist[i];
+
+  for (i = 0, log2total = total ? zopt_log2((double)total) : 5.0; i < 32; i ++)
+    costs->dist[i] = stats->dist[i] ? log2total - zopt_log2((double)stats->dist[i]) : log2total;
+}
+
+
+/*
+ * 'zopt_get_stats()' - Count the symbols in a block.
+ */
+
+static void
+zopt_get_stats(zopt_t           *z,	/* I - Encoder state */
+               const zopt_sym_t *syms,	/* I - Symbols */
+               size_t           num_syms,
+					/* I - Number of symbols */
+               zopt_stats_t     *stats)	/* O - Symbol counts */
+{
+  size_t	i;			/* Looping var */
+
+
+  memset(stats, 0, sizeof(zopt_stats_t));
+
+  for (i = 0; i < num_syms; i ++)
+  {
+    if (syms[i].distance)
+    {
+      stats->litlen[257 + z->length_sym[syms[i].length]] ++;
+      stats->dist[zopt_dist_sym(syms[i].distance)] ++;
+    }
+    else
+      stats->litlen[syms[i].length] ++;
+  }
+
+  stats->litlen[256] = 1;
+}
+
+
+/*
+ * 'zopt_huffman()' - Compute length-limited Huffman code lengths.
+ *
+ * Counts are halved until the longest code fits in "max_bits".
+ */
+
+static void
+zopt_huffman(const size_t  *freqs,	/* I - Symbol counts */
+             int           num_syms,	/* I - Number of symbols (up to 288) */
+             int           max_bits,	/* I - Maximum code length */
+             unsigned char *lengths)	/* O - Code lengths */
+{
+  int		i, j,			/* Looping vars */
+		count,			/* Number of used symbols */
+		leaf,			/* Next leaf */
+		inner,			/* Next internal node */
+		next,			/* Next new node */
+		node,			/* Current node */
+		max_depth;		/* Deepest leaf */
+  int		syms[288],		/* Used symbols, sorted by weight */
+		parent[576],		/* Parent of each node */
+		depth[576];		/* Depth of each node */
+  size_t	weights[288],		/* Symbol weights */
+		nodes[576],		/* Node weights */
+		weight;			/* Current weight */
+
+
+  memset(lengths, 0, (size_t)num_syms);
+  memcpy(weights, freqs, (size_t)num_syms * sizeof(size_t));
+
+  for (;;)
+  {
+   /*
+    * Sort the used symbols by weight...
+    */
+
+    for (i = 0, count = 0; i < num_syms; i ++)
+    {
+      if (!weights[i])
+        continue;
+
+      for (j = count ++; j > 0 && weights[syms[j - 1]] > weights[i]; j --)
+        syms[j] = syms[j - 1];
+
+      syms[j] = i;
+    }
+
+    if (count == 0)
+      return;
+
+    if (count == 1)
+    {
+      lengths[syms[0]] = 1;
+      return;
+    }
+
+   /*
+    * Build the tree using a queue of leaves and a queue of internal nodes...
+    */
+
+    for (i = 0; i < count; i ++)
+      nodes[i] = weights[syms[i]];
+
+    for (leaf = 0, inner = count, next = count; next < (2 * count - 1); next ++)
+    {
+      for (j = 0, weight = 0; j < 2; j ++)
+      {
+        if (leaf < count && (inner >= next || nodes[leaf] <= nodes[inner]))
+          node = leaf ++;
+        else
+          node = inner ++;
+
+        parent[node] = next;
+        weight       += nodes[node];
+      }
+
+      nodes[next] = weight;
+    }
+
+   /*
+    * Compute the depth of each leaf, since parents always follow children...
+    */
+
+    depth[2 * count - 2] = 0;
+
+    for (node = 2 * count - 3, max_depth = 0; node >= 0; node --)
+    {
+      depth[node] = depth[parent[node]] + 1;
+
+      if (node < count && depth[node] > max_depth)
+        max_depth = depth[node];
+    }
+
+    if (max_depth <= max_bits)
+    {
+      for (i = 0; i < count; i ++)
+        lengths[syms[i]] = (unsigned char)depth[i];
+      return;
+    }
+
+   /*
+    * Flatten the distribution and try again...
+    */
+
+    for (i = 0; i < num_syms; i ++)
+    {
+      if (weights[i])
+        weights[i] = (weights[i] >> 1) | 1;
+    }
+  }
+}
+
+
+/*
+ * 'zopt_log2()' - Return the base-2 logarithm of a positive number.
+ */
+
+static double				/* O - log2(x) */
+zopt_log2(double x)			/* I - Number */
+{
+  double	e = 0.0,		/* Exponent */
+		t, t2;			/* Series terms */
+
+
+  while (x >= 2.0)
+  {
+    x *= 0.5;
+    e += 1.0;
+  }
+
+  while (x < 1.0)
+  {
+    x *= 2.0;
+    e -= 1.0;
+  }
+
+  t  = (x - 1.0) / (x + 1.0);
+  t2 = t * t;
+
+  return (e + 2.0 * t * (1.0 + t2 * (1.0 / 3.0 + t2 * (1.0 / 5.0 + t2 * (1.0 / 7.0 + t2 / 9.0)))) / 0.69314718055994531);
+}
+
+
+/*
+ * 'zopt_parse()' - Find the cheapest sequence of symbols for a block.
+ */
+
+static size_t				/* O - Number of symbols */
+zopt_parse(zopt_t             *z,	/* I - Encoder state */
+           size_t             start,	/* I - Start of block */
+           size_t             end,	/* I - End of block */
+           const zopt_costs_t *costs,	/* I - Symbol costs */
+           double             *cost,	/* I - Cost to reach each position */
+           zopt_sym_t         *path,	/* I - Last symbol to each position */
+           zopt_sym_t         *syms)	/* O - Symbols */
+{
+  size_t	i,			/* Current position */
+		k,			/* Position in block */
+		len,			/* Match length */
+		prev_len,		/* Previous match length */
+		max_len,		/* Maximum match length */
+		num_syms;		/* Number of symbols */
+  unsigned	m;			/* Current match */
+  int		dsym;			/* Distance symbol */
+  double	c,			/* Cost */
+		dcost,			/* Cost to here plus distance */
+		len_cost[ZOPT_MAX_MATCH + 1];
+					/* Cost of each match length */
+  zopt_sym_t	temp;			/* Temporary symbol */
+
+
+  for (len = ZOPT_MIN_MATCH; len <= ZOPT_MAX_MATCH; len ++)
+    len_cost[len] = costs->litlen[257 + z->length_sym[len]] + length_extra[z->length_sym[len]];
+
+  cost[0] = 0.0;
+  for (k = 1; k <= (end - start); k ++)
+    cost[k] = 1e30;
+
+  for (i = start; i < end; i ++)
+  {
+    k = i - start;
+
+   /*
+    * Literal...
+    */
+
+    if ((c = cost[k] + costs->litlen[z->data[i]]) < cost[k + 1])
+    {
+      cost[k + 1]          = c;
+      path[k + 1].length   = 1;
+      path[k + 1].distance = 0;
+    }
+
+   /*
+    * Matches...
+    */
+
+    max_len = end - i;
+    if (max_len > ZOPT_MAX_MATCH)
+      max_len = ZOPT_MAX_MATCH;
+
+    for (m = z->first[i], prev_len = ZOPT_MIN_MATCH - 1; m < z->first[i + 1] && prev_len < max_len; m ++)
+    {
+      dsym  = zopt_dist_sym(z->matches[m].distance);
+      dcost = cost[k] + costs->dist[dsym] + dist_extra[dsym];
+
+      for (len = prev_len + 1; len <= z->matches[m].length && len <= max_len; len ++)
+      {
+        if ((c = dcost + len_cost[len]) < cost[k + len])
+        {
+          cost[k + len]          = c;
+          path[k + len].length   = (unsigned short)len;
+          path[k + len].distance = z->matches[m].distance;
+        }
+      }
+
+      prev_len = len - 1;
+    }
+  }
+
+ /*
+  * Trace the cheapest path back from the end of the block...
+  */
+
+  for (k = end - start, num_syms = 0; k > 0; k -= path[k].length)
+  {
+    syms[num_syms] = path[k];
+
+    if (!path[k].distance)
+      syms[num_syms].length = z->data[start + k - 1];
+
+    num_syms ++;
+  }
+
+  for (i = 0; i < (num_syms / 2); i ++)
+  {
+    temp                     = syms[i];
+    syms[i]                  = syms[num_syms - 1 - i];
+    syms[num_syms - 1 - i]   = temp;
+  }
+
+  return (num_syms);
+}
+
+
+/*
+ * 'zopt_put_byte()' - Add a byte to the output buffer.
+ */
+
+static void
+zopt_put_byte(zopt_t *z,		/* I - Encoder state */
+              int    byte)		/* I - Byte */
+{
+  if (z->error)
+    return;
+
+  if (*(z->buflen) >= *(z->bufsize))
+  {
+    size_t		bufsize = *(z->bufsize) ? 2 * *(z->bufsize) : 65536;
+					/* New size */
+    unsigned char	*buffer;	/* New buffer */
+
+    if ((buffer = realloc(*(z->buffer), bufsize)) == NULL)
+    {
+      z->error = 1;
+      return;
+    }
+
+    *(z->buffer)  = buffer;
+    *(z->bufsize) = bufsize;
+  }
+
+  (*(z->buffer))[(*(z->buflen)) ++] = (unsigned char)byte;
+}
+
+
+/*
+ * 'zopt_write_block()' - Write a stored, fixed, or dynamic block, whichever
+ *                        is smallest.
+ */
+
+static void
+zopt_write_block(
+    zopt_t              *z,		/* I - Encoder state */
+    const unsigned char *data,		/* I - Block data */
+    size_t              length,		/* I - Length of block data */
+    const zopt_sym_t    *syms,		/* I - Symbols */
+    size_t              num_syms,	/* I - Number of symbols */
+    int                 final)		/* I - Final block? */
+{
+  size_t		i;		/* Looping var */
+  int			j;		/* Looping var */
+  zopt_stats_t		stats;		/* Symbol counts */
+  zopt_tree_t		tree;		/* Dynamic Huffman trees */
+  size_t		dynamic_bits,	/* Size of dynamic block */
+			fixed_bits,	/* Size of fixed block */
+			stored_bits;	/* Size of stored block */
+  const unsigned char	*litlen,	/* Literal/length code lengths */
+			*dist;		/* Distance code lengths */
+  unsigned		litlen_codes[288],
+					/* Literal/length codes */
+			dist_codes[32],	/* Distance codes */
+			codelen_codes[19];
+					/* Code length codes */
+  int			sym;		/* Current symbol */
+
+
+  zopt_get_stats(z, syms, num_syms, &stats);
+
+  dynamic_bits = zopt_dynamic(&stats, &tree);
+  fixed_bits   = 3 + zopt_data_bits(&stats, z->fixed_litlen, z->fixed_dist);
+  stored_bits  = 3 + 7 + 32 + 8 * length;
+
+  if (stored_bits < dynamic_bits && stored_bits < fixed_bits)
+  {
+   /*
+    * Stored block...
+    */
+
+    zopt_add_bits(z, (unsigned)final, 3);
+    zopt_align(z);
+    zopt_add_bits(z, (unsigned)length, 16);
+    zopt_add_bits(z, (unsigned)~length & 0xffff, 16);
+
+    for (i = 0; i < length; i ++)
+      zopt_put_byte(z, data[i]);
+
+    return;
+  }
+
+  if (fixed_bits <= dynamic_bits)
+  {
+   /*
+    * Fixed Huffman block...
+    */
+
+    zopt_add_bits(z, (unsigned)final | (1 << 1), 3);
+
+    litlen = z->fixed_litlen;
+    dist   = z->fixed_dist;
+  }
+  else
+  {
+   /*
+    * Dynamic Huffman block...
+    */
+
+    zopt_add_bits(z, (unsigned)final | (2 << 1), 3);
+    zopt_add_bits(z, (unsigned)(tree.hlit - 257), 5);
+    zopt_add_bits(z, (unsigned)(tree.hdist - 1), 5);
+    zopt_add_bits(z, (unsigned)(tree.hclen - 4), 4);
+
+    for (j = 0; j < tree.hclen; j ++)
+      zopt_add_bits(z, tree.codelen[codelen_order[j]], 3);
+
+    zopt_get_codes(tree.codelen, 19, codelen_codes);
+
+    for (i = 0; i < tree.num_rle; i ++)
+    {
+      sym = tree.rle[i];
+
+      zopt_add_bits(z, codelen_codes[sym], tree.codelen[sym]);
+
+      if (sym == 16)
+        zopt_add_bits(z, tree.rle_extra[i], 2);
+      else if (sym == 17)
+        zopt_add_bits(z, tree.rle_extra[i], 3);
+      else if (sym == 18)
+        zopt_add_bits(z, tree.rle_extra[i], 7);
+    }
+
+    litlen = tree.litlen;
+    dist   = tree.dist;
+  }
+
+ /*
+  * Write the symbols and end-of-block code...
+  */
+
+  zopt_get_codes(litlen, 288, litlen_codes);
+  zopt_get_codes(dist, 32, dist_codes);
+
+  for (i = 0; i < num_syms; i ++)
+  {
+    if (syms[i].distance)
+    {
+      sym = z->length_sym[syms[i].length];
+
+      zopt_add_bits(z, litlen_codes[257 + sym], litlen[257 + sym]);
+      zopt_add_bits(z, syms[i].length - length_base[sym], length_extra[sym]);
+
+      sym = zopt_dist_sym(syms[i].distance);
+
+      zopt_add_bits(z, dist_codes[sym], dist[sym]);
+      zopt_add_bits(z, syms[i].distance - dist_base[sym], dist_extra[sym]);
+    }
+    else
+    {
+      zopt_add_bits(z, litlen_codes[syms[i].length], litlen[syms[i].length]);
+    }
+  }
+
+  zopt_add_bits(z, litlen_codes[256], litlen[256]);
+}
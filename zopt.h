@@ -0,0 +1,30 @@
+/*
+ * Optimal-parsing deflate encoder header for codedoc.
+ *
+ *     https://www.msweet.org/codedoc
+ *
+ * Copyright © 2025 by Michael R Sweet.
+ *
+ * Licensed under Apache License v2.0.  See the file "LICENSE" for more
+ * information.
+ */
+
+#ifndef ZOPT_H
+#  define ZOPT_H
+#  include <stdlib.h>
+#  ifdef __cplusplus
+extern "C" {
+#  endif /* __cplusplus */
+
+
+/*
+ * Functions...
+ */
+
+extern int		zoptDeflate(const void *data, size_t length, int last, int iterations, unsigned char **buffer, size_t *bufsize, size_t *buflen);
+
+
+#  ifdef __cplusplus
+}
+#  endif /* __cplusplus */
+#endif /* !ZOPT_H */